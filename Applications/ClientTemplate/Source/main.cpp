@@ -3,10 +3,8 @@
 #include <boost/functional/factory.hpp>
 #include <boost/functional/value_factory.hpp>
 #include <tclap/CmdLine.h>
-#include "Beam/Codecs/SizeDeclarativeDecoder.hpp"
-#include "Beam/Codecs/SizeDeclarativeEncoder.hpp"
-#include "Beam/Codecs/ZLibDecoder.hpp"
-#include "Beam/Codecs/ZLibEncoder.hpp"
+#include "Beam/Codecs/ZLibStreamDecoder.hpp"
+#include "Beam/Codecs/ZLibStreamEncoder.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Network/TcpSocketChannel.hpp"
 #include "Beam/Serialization/BinaryReceiver.hpp"
@@ -34,7 +32,7 @@ using namespace TCLAP;
 namespace {
   using ApplicationClient = ServiceProtocolClient<
     MessageProtocol<TcpSocketChannel, BinarySender<SharedBuffer>,
-    SizeDeclarativeEncoder<ZLibEncoder>>, LiveTimer>;
+    ZLibStreamEncoder>, LiveTimer>;
 
   auto ParseAddress(const YAML::Node& config) {
     auto addresses = std::vector<IpAddress>();
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <string>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <Beam/Serialization/DataShuttle.hpp>
+#include <Beam/Serialization/ShuttleDateTime.hpp>
 
 namespace Beam {
 
@@ -57,4 +59,19 @@ namespace Beam {
         m_timestamp{timestamp} {}
 }
 
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Entry> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle, Entry& value, unsigned int version) {
+      shuttle.Shuttle("name", value.m_name);
+      shuttle.Shuttle("item_a", value.m_itemA);
+      shuttle.Shuttle("item_b", value.m_itemB);
+      shuttle.Shuttle("item_c", value.m_itemC);
+      shuttle.Shuttle("item_d", value.m_itemD);
+      shuttle.Shuttle("timestamp", value.m_timestamp);
+    }
+  };
+}
+
 #endif
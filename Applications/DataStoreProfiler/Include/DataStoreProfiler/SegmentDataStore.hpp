@@ -0,0 +1,106 @@
+#ifndef BEAM_DATA_STORE_PROFILER_SEGMENT_DATA_STORE_HPP
+#define BEAM_DATA_STORE_PROFILER_SEGMENT_DATA_STORE_HPP
+#include <filesystem>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Queries/EvaluatorTranslator.hpp>
+#include <Beam/Queries/SegmentDataStore.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include "DataStoreProfiler/EntryQuery.hpp"
+
+namespace Beam {
+
+  /** Stores data in memory mapped segment files. */
+  class SegmentDataStore : private boost::noncopyable {
+    public:
+
+      //! Constructs a SegmentDataStore.
+      /*!
+        \param root The directory to store the segments in.
+      */
+      explicit SegmentDataStore(std::filesystem::path root);
+
+      ~SegmentDataStore();
+
+      //! Deletes every segment.
+      void Clear();
+
+      std::vector<SequencedEntry> LoadEntries(const EntryQuery& query);
+
+      void Store(const SequencedIndexedEntry& entry);
+
+      void Store(const std::vector<SequencedIndexedEntry>& entries);
+
+      void Open();
+
+      void Close();
+
+    private:
+      using DataStore = Queries::SegmentDataStore<EntryQuery, Entry,
+        Queries::EvaluatorTranslator<Queries::QueryTypes>>;
+      std::filesystem::path m_root;
+      boost::optional<DataStore> m_dataStore;
+      IO::OpenState m_openState;
+
+      void Shutdown();
+  };
+
+  inline SegmentDataStore::SegmentDataStore(std::filesystem::path root)
+      : m_root(std::move(root)) {
+    m_dataStore.emplace(m_root);
+  }
+
+  inline SegmentDataStore::~SegmentDataStore() {
+    Close();
+  }
+
+  inline void SegmentDataStore::Clear() {
+    m_dataStore->Close();
+    m_dataStore = boost::none;
+    std::filesystem::remove_all(m_root);
+    m_dataStore.emplace(m_root);
+    m_dataStore->Open();
+  }
+
+  inline std::vector<SequencedEntry> SegmentDataStore::LoadEntries(
+      const EntryQuery& query) {
+    return m_dataStore->Load(query);
+  }
+
+  inline void SegmentDataStore::Store(const SequencedIndexedEntry& entry) {
+    m_dataStore->Store(entry);
+  }
+
+  inline void SegmentDataStore::Store(
+      const std::vector<SequencedIndexedEntry>& entries) {
+    m_dataStore->Store(entries);
+  }
+
+  inline void SegmentDataStore::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      m_dataStore.emplace(m_root);
+      m_dataStore->Open();
+    } catch(const std::exception&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    }
+    m_openState.SetOpen();
+  }
+
+  inline void SegmentDataStore::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  inline void SegmentDataStore::Shutdown() {
+    m_dataStore->Close();
+    m_openState.SetClosed();
+  }
+}
+
+#endif
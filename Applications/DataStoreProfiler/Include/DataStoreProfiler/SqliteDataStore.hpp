@@ -0,0 +1,138 @@
+#ifndef BEAM_DATA_STORE_PROFILER_SQLITE_DATA_STORE_HPP
+#define BEAM_DATA_STORE_PROFILER_SQLITE_DATA_STORE_HPP
+#include <string>
+#include <thread>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Queries/SqlDataStore.hpp>
+#include <Beam/Queries/SqlTranslator.hpp>
+#include <Beam/Sql/DatabaseConnectionPool.hpp>
+#include <Beam/Threading/ThreadPool.hpp>
+#include <boost/noncopyable.hpp>
+#include <Viper/Sqlite3/Connection.hpp>
+#include "DataStoreProfiler/EntryQuery.hpp"
+
+namespace Beam {
+
+  /** Stores data in an SQLite database. */
+  class SqliteDataStore : private boost::noncopyable {
+    public:
+
+      //! Constructs an SqliteDataStore.
+      /*!
+        \param path The path to the database file.
+      */
+      explicit SqliteDataStore(std::string path);
+
+      ~SqliteDataStore();
+
+      //! Clears the contents of the database.
+      void Clear();
+
+      std::vector<SequencedEntry> LoadEntries(const EntryQuery& query);
+
+      void Store(const SequencedIndexedEntry& entry);
+
+      void Store(const std::vector<SequencedIndexedEntry>& entries);
+
+      void Open();
+
+      void Close();
+
+    private:
+      template<typename V, typename I>
+      using DataStore = Queries::SqlDataStore<Viper::Sqlite3::Connection, V, I,
+        Queries::SqlTranslator>;
+      std::string m_path;
+      DatabaseConnectionPool<Viper::Sqlite3::Connection> m_readerPool;
+      DatabaseConnectionPool<Viper::Sqlite3::Connection> m_writerPool;
+      Threading::ThreadPool m_threadPool;
+      DataStore<Viper::Row<Entry>, Viper::Row<std::string>> m_dataStore;
+      IO::OpenState m_openState;
+
+      static Viper::Row<Entry> BuildValueRow();
+      static Viper::Row<std::string> BuildIndexRow();
+      void Shutdown();
+  };
+
+  inline SqliteDataStore::SqliteDataStore(std::string path)
+      : m_path(std::move(path)),
+        m_dataStore("entries", BuildValueRow(), BuildIndexRow(),
+          Ref(m_readerPool), Ref(m_writerPool), Ref(m_threadPool)) {}
+
+  inline SqliteDataStore::~SqliteDataStore() {
+    Close();
+  }
+
+  inline void SqliteDataStore::Clear() {
+    auto connection = m_writerPool.Acquire();
+    connection->execute("DELETE FROM entries;");
+  }
+
+  inline std::vector<SequencedEntry> SqliteDataStore::LoadEntries(
+      const EntryQuery& query) {
+    return m_dataStore.Load(query);
+  }
+
+  inline void SqliteDataStore::Store(const SequencedIndexedEntry& entry) {
+    return m_dataStore.Store(entry);
+  }
+
+  inline void SqliteDataStore::Store(
+      const std::vector<SequencedIndexedEntry>& entries) {
+    return m_dataStore.Store(entries);
+  }
+
+  inline void SqliteDataStore::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      for(auto i = std::size_t(0);
+          i <= std::thread::hardware_concurrency(); ++i) {
+        auto readerConnection = std::make_unique<Viper::Sqlite3::Connection>(
+          m_path);
+        readerConnection->open();
+        m_readerPool.Add(std::move(readerConnection));
+      }
+
+      // SQLite serializes writers, additional connections only contend.
+      auto writerConnection = std::make_unique<Viper::Sqlite3::Connection>(
+        m_path);
+      writerConnection->open();
+      m_writerPool.Add(std::move(writerConnection));
+      m_dataStore.Open();
+    } catch(const std::exception&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    }
+    m_openState.SetOpen();
+  }
+
+  inline void SqliteDataStore::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  inline void SqliteDataStore::Shutdown() {
+    m_writerPool.Close();
+    m_readerPool.Close();
+    m_openState.SetClosed();
+  }
+
+  inline Viper::Row<Entry> SqliteDataStore::BuildValueRow() {
+    return Viper::Row<Entry>().
+      add_column("item_a", &Entry::m_itemA).
+      add_column("item_b", &Entry::m_itemB).
+      add_column("item_c", &Entry::m_itemC).
+      add_column("item_d", &Entry::m_itemD);
+  }
+
+  inline Viper::Row<std::string> SqliteDataStore::BuildIndexRow() {
+    return Viper::Row<std::string>().add_column("name",
+      Viper::VarCharDataType(16));
+  }
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include "DataStoreProfiler/BufferedDataStore.hpp"
 #include "DataStoreProfiler/Entry.hpp"
 #include "DataStoreProfiler/MySqlDataStore.hpp"
+#include "DataStoreProfiler/SegmentDataStore.hpp"
+#include "DataStoreProfiler/SqliteDataStore.hpp"
 #include "Version.hpp"
 
 using namespace Beam;
@@ -138,6 +140,26 @@ namespace {
     ProfileWrites(dataStore, profileConfig);
     ProfileReads(dataStore, profileConfig);
   }
+
+  void ProfileSegmentDataStore(const std::string& path,
+      const ProfileConfig& profileConfig) {
+    auto segmentDataStore = Beam::SegmentDataStore(path);
+    auto dataStore = Beam::BufferedDataStore(&segmentDataStore,
+      profileConfig.m_bufferSize);
+    std::cout << "SegmentDataStore" << std::endl;
+    ProfileWrites(dataStore, profileConfig);
+    ProfileReads(dataStore, profileConfig);
+  }
+
+  void ProfileSqliteDataStore(const std::string& path,
+      const ProfileConfig& profileConfig) {
+    auto sqliteDataStore = SqliteDataStore(path);
+    auto dataStore = Beam::BufferedDataStore(&sqliteDataStore,
+      profileConfig.m_bufferSize);
+    std::cout << "SqliteDataStore" << std::endl;
+    ProfileWrites(dataStore, profileConfig);
+    ProfileReads(dataStore, profileConfig);
+  }
 }
 
 int main(int argc, const char** argv) {
@@ -172,7 +194,18 @@ int main(int argc, const char** argv) {
       std::endl;
     return -1;
   }
+  auto segmentPath = std::string();
+  auto sqlitePath = std::string();
+  try {
+    segmentPath = Extract<std::string>(config, "segment_path");
+    sqlitePath = Extract<std::string>(config, "sqlite_path");
+  } catch(const std::exception& e) {
+    std::cerr << "Unable to parse config: " << e.what() << std::endl;
+    return -1;
+  }
   ProfileBufferedDataStore(mySqlConfig, profileConfig);
   ProfileAsyncDataStore(mySqlConfig, profileConfig);
+  ProfileSegmentDataStore(segmentPath, profileConfig);
+  ProfileSqliteDataStore(sqlitePath, profileConfig);
   return 0;
 }
@@ -1,7 +1,7 @@
 #include "HttpFileServer/HttpFileServlet.hpp"
 #include <Beam/WebServices/HttpRequest.hpp>
 #include <Beam/WebServices/HttpResponse.hpp>
-#include <Beam/WebServices/HttpServerPredicates.hpp>
+#include <Beam/WebServices/HttpRoute.hpp>
 
 using namespace Beam;
 using namespace Beam::HttpFileServer;
@@ -18,7 +18,8 @@ HttpFileServlet::~HttpFileServlet() {
 std::vector<HttpRequestSlot> HttpFileServlet::GetSlots() {
   auto slots = std::vector<HttpRequestSlot>();
   slots.emplace_back(ServeIndex(m_fileStore));
-  slots.emplace_back(MatchAny(HttpMethod::GET),
+  slots.emplace_back(
+    HttpRoute(HttpMethod::GET, "/", HttpRoute::Match::PREFIX),
     std::bind(&HttpFileServlet::OnServeFile, this, std::placeholders::_1));
   return slots;
 }
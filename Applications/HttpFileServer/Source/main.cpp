@@ -6,6 +6,7 @@
 #include "Beam/Utilities/ApplicationInterrupt.hpp"
 #include "Beam/Utilities/Expect.hpp"
 #include "Beam/Utilities/YamlConfig.hpp"
+#include "Beam/WebServices/HttpServerOptions.hpp"
 #include "Beam/WebServices/HttpServletContainer.hpp"
 #include "HttpFileServer/HttpFileServlet.hpp"
 #include "Version.hpp"
@@ -27,6 +28,8 @@ namespace {
   struct ServerConnectionInitializer {
     IpAddress m_interface;
     std::vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
+    HttpServerOptions m_serverOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -37,6 +40,12 @@ namespace {
     addresses.push_back(m_interface);
     m_addresses = Extract<std::vector<IpAddress>>(config, "addresses",
       addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
+    auto serverOptionsNode = config["http_options"];
+    if(serverOptionsNode) {
+      m_serverOptions = HttpServerOptions::Parse(serverOptionsNode);
+    }
   }
 }
 
@@ -66,7 +75,9 @@ int main(int argc, const char** argv) {
     return -1;
   }
   auto server = HttpFileServletContainer(Initialize(),
-    Initialize(serverConnectionInitializer.m_interface, Ref(socketThreadPool)));
+    Initialize(serverConnectionInitializer.m_interface,
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
+    serverConnectionInitializer.m_serverOptions);
   try {
     server.Open();
   } catch(const std::exception& e) {
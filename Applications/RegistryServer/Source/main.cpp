@@ -45,6 +45,7 @@ namespace {
     std::string m_serviceName;
     IpAddress m_interface;
     std::vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -57,6 +58,8 @@ namespace {
     addresses.push_back(m_interface);
     m_addresses = Extract<std::vector<IpAddress>>(config, "addresses",
       addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
   }
 }
 
@@ -107,7 +110,8 @@ int main(int argc, const char** argv) {
   }
   auto server = RegistryServletContainer(Initialize(serviceLocatorClient.Get(),
     Initialize(Initialize(std::filesystem::current_path() / "records"))),
-    Initialize(serverConnectionInitializer.m_interface, Ref(socketThreadPool)),
+    Initialize(serverConnectionInitializer.m_interface,
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
     std::bind(factory<std::shared_ptr<LiveTimer>>(), seconds(10),
     Ref(timerThreadPool)));
   try {
@@ -43,6 +43,7 @@ namespace {
   struct ServerConnectionInitializer {
     IpAddress m_interface;
     vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -52,6 +53,8 @@ namespace {
     auto addresses = vector<IpAddress>();
     addresses.push_back(m_interface);
     m_addresses = Extract<vector<IpAddress>>(config, "addresses", addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
   }
 }
 
@@ -92,8 +95,9 @@ int main(int argc, const char** argv) {
   auto mysqlDataStore = SqlServiceLocatorDataStore(std::move(mySqlConnection));
   auto server = ServiceLocatorServletContainer(Initialize(Initialize(
     &mysqlDataStore)), Initialize(serverConnectionInitializer.m_interface,
-    Ref(socketThreadPool)), std::bind(factory<std::shared_ptr<LiveTimer>>(),
-    seconds{10}, Ref(timerThreadPool)));
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
+    std::bind(factory<std::shared_ptr<LiveTimer>>(), seconds{10},
+    Ref(timerThreadPool)));
   try {
     server.Open();
   } catch(const std::exception& e) {
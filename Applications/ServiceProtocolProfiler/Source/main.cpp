@@ -1,3 +1,5 @@
+#include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <boost/format.hpp>
@@ -10,10 +12,21 @@
 #include "Beam/Codecs/SizeDeclarativeEncoder.hpp"
 #include "Beam/Codecs/ZLibDecoder.hpp"
 #include "Beam/Codecs/ZLibEncoder.hpp"
+#include "Beam/Codecs/ZLibStreamDecoder.hpp"
+#include "Beam/Codecs/ZLibStreamEncoder.hpp"
+#include "Beam/IO/BufferPool.hpp"
 #include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalPipeReader.hpp"
+#include "Beam/IO/LocalPipeWriter.hpp"
 #include "Beam/IO/LocalServerConnection.hpp"
+#include "Beam/IO/PipedReader.hpp"
+#include "Beam/IO/PipedWriter.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
+#ifndef _WIN32
+  #include "Beam/IO/SharedMemoryServerConnection.hpp"
+#endif
 #include "Beam/Network/TcpServerSocket.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Routines/RoutineHandlerGroup.hpp"
 #include "Beam/Serialization/BinaryReceiver.hpp"
 #include "Beam/Serialization/BinarySender.hpp"
@@ -39,42 +52,181 @@ using namespace std;
 using namespace TCLAP;
 
 namespace {
-  using ServiceEncoder = SizeDeclarativeEncoder<ZLibEncoder>;
-  using ApplicationServerConnection = LocalServerConnection<SharedBuffer>;
-  using ServerChannel = ApplicationServerConnection::Channel;
-  using ApplicationServerServiceProtocolClient = ServiceProtocolClient<
-    MessageProtocol<std::shared_ptr<ServerChannel>, BinarySender<SharedBuffer>,
-    ServiceEncoder>, TriggerTimer>;
-  using ClientChannel = LocalClientChannel<SharedBuffer>;
-  using ApplicationClientServiceProtocolClient = ServiceProtocolClient<
-    MessageProtocol<ClientChannel*, BinarySender<SharedBuffer>,
-    ServiceEncoder>, TriggerTimer>;
-
-  string OnEchoRequest(ApplicationServerServiceProtocolClient& client,
-      string message) {
+  using ServiceEncoder = ZLibStreamEncoder;
+  template<typename Channel>
+  using ApplicationServiceProtocolClient = ServiceProtocolClient<
+    MessageProtocol<Channel, BinarySender<SharedBuffer>, ServiceEncoder>,
+    TriggerTimer>;
+  using LocalApplicationServerConnection = LocalServerConnection<SharedBuffer>;
+
+  std::atomic<std::uint64_t> receivedMessages{0};
+
+#ifndef _WIN32
+  const auto SHARED_MEMORY_NAME = string("service_protocol_profiler");
+#endif
+
+  string Describe(const TcpSocketOptions& options) {
+    return (boost::format("tcp no_delay: %1% write_buffer_size: %2% "
+      "read_buffer_size: %3% quick_ack: %4% busy_poll: %5%") %
+      options.m_noDelayEnabled % options.m_writeBufferSize %
+      options.m_readBufferSize % options.m_quickAckEnabled %
+      options.m_busyPollTimeout.total_microseconds()).str();
+  }
+
+  void Report(const string& label, time_duration elapsed) {
+    cout << boost::format("Profile: %1%\nMessages: %2%\nElapsed: %3%\n"
+      "Messages/s: %4%\n") % label % receivedMessages.load() % elapsed %
+      (1000000.0 * receivedMessages.load() / elapsed.total_microseconds()) <<
+      std::flush;
+  }
+
+  /** Returns the serialized messages the clients send. */
+  vector<SharedBuffer> RecordTraffic(int messageCount) {
+    using Client = ApplicationServiceProtocolClient<
+      LocalClientChannel<SharedBuffer>*>;
+    auto server = LocalApplicationServerConnection();
+    auto channel = LocalClientChannel<SharedBuffer>("recorder", Ref(server));
+    auto client = Client(&channel, Initialize());
+    RegisterServiceProtocolProfilerServices(Store(client.GetSlots()));
+    RegisterServiceProtocolProfilerMessages(Store(client.GetSlots()));
+    auto sender = BinarySender<SharedBuffer>(
+      Ref(client.GetSlots().GetRegistry()));
+    auto traffic = vector<SharedBuffer>(messageCount);
+    for(auto& buffer : traffic) {
+      auto message = RecordMessage<EchoMessage, Client>(
+        microsec_clock::universal_time(), "hello world");
+      sender.SetSink(Ref(buffer));
+      sender.Send(static_cast<const Message<Client>*>(&message));
+    }
+    return traffic;
+  }
+
+  /** Encodes and decodes the recorded traffic as a single connection. */
+  template<typename Encoder>
+  void ProfileCodec(const string& label, Encoder encoder,
+      const vector<SharedBuffer>& traffic) {
+    auto decoder = Codecs::GetInverse<Encoder>();
+    auto encodedTraffic = vector<SharedBuffer>(traffic.size());
+    auto size = std::size_t(0);
+    auto encodedSize = std::size_t(0);
+    auto encodeStart = microsec_clock::universal_time();
+    for(auto i = std::size_t(0); i < traffic.size(); ++i) {
+      size += traffic[i].GetSize();
+      encodedSize += encoder.Encode(traffic[i], Store(encodedTraffic[i]));
+    }
+    auto encodeTime = microsec_clock::universal_time() - encodeStart;
+    auto decodeStart = microsec_clock::universal_time();
+    for(auto i = std::size_t(0); i < traffic.size(); ++i) {
+      auto decodedBuffer = SharedBuffer();
+      decoder.Decode(encodedTraffic[i], Store(decodedBuffer));
+      if(decodedBuffer != traffic[i]) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Decoding mismatch."));
+      }
+    }
+    auto decodeTime = microsec_clock::universal_time() - decodeStart;
+    cout << boost::format("Codec: %1%\nRatio: %2%\nEncode ns/byte: %3%\n"
+      "Decode ns/byte: %4%\n") % label %
+      (static_cast<double>(size) / encodedSize) %
+      (1000.0 * encodeTime.total_microseconds() / size) %
+      (1000.0 * decodeTime.total_microseconds() / size) << std::flush;
+  }
+
+  void ProfileCodecs(int messageCount) {
+    auto traffic = RecordTraffic(messageCount);
+    ProfileCodec("null", NullEncoder(), traffic);
+    ProfileCodec("zlib", SizeDeclarativeEncoder<ZLibEncoder>(), traffic);
+    for(auto level : {Z_BEST_SPEED, Z_DEFAULT_COMPRESSION,
+        Z_BEST_COMPRESSION}) {
+      for(auto threshold : {ZLibStreamEncoder::DEFAULT_THRESHOLD,
+          std::size_t(1024)}) {
+        ProfileCodec((boost::format("zlib_stream level: %1% threshold: %2%") %
+          level % threshold).str(), ZLibStreamEncoder(level, threshold),
+          traffic);
+      }
+    }
+  }
+
+  /** Passes the recorded traffic from multiple writers to a single reader
+      through one kind of pipe. */
+  template<typename Reader, typename Writer>
+  void ProfilePipe(const string& label, const vector<SharedBuffer>& traffic,
+      int writerCount) {
+    auto reader = Reader();
+    auto writer = Writer(Ref(reader));
+    auto size = std::size_t(0);
+    for(auto& buffer : traffic) {
+      size += buffer.GetSize();
+    }
+    receivedMessages = 0;
+    auto startTime = microsec_clock::universal_time();
+    RoutineHandlerGroup routines;
+    for(auto i = 0; i < writerCount; ++i) {
+      routines.Spawn(
+        [&] {
+          for(auto& buffer : traffic) {
+            writer.Write(buffer);
+            Defer();
+          }
+        });
+    }
+    routines.Spawn(
+      [&] {
+        auto received = std::size_t(0);
+        auto buffer = SharedBuffer();
+        while(received < writerCount * size) {
+          buffer.Reset();
+          received += reader.Read(Store(buffer));
+        }
+        receivedMessages = writerCount * traffic.size();
+      });
+    routines.Wait();
+    Report(label, microsec_clock::universal_time() - startTime);
+  }
+
+  /** Compares the LocalPipe used by local Channels against the PipedReader
+      and PipedWriter they previously used. */
+  void ProfilePipes(int writerCount, int messageCount) {
+    auto traffic = RecordTraffic(messageCount);
+    ProfilePipe<PipedReader<SharedBuffer>, PipedWriter<SharedBuffer>>(
+      "pipe: piped", traffic, writerCount);
+    ProfilePipe<LocalPipeReader<SharedBuffer>, LocalPipeWriter<SharedBuffer>>(
+      "pipe: local_pipe", traffic, writerCount);
+  }
+
+  template<typename ServiceProtocolClient>
+  string OnEchoRequest(ServiceProtocolClient& client, string message) {
     return message;
   }
 
-  void ServerLoop(ApplicationServerConnection& server) {
-    server.Open();
+  template<typename ServerConnection>
+  void ServerLoop(ServerConnection& server) {
+    using ServerChannel = typename ServerConnection::Channel;
+    using ServerServiceProtocolClient =
+      ApplicationServiceProtocolClient<std::shared_ptr<ServerChannel>>;
     RoutineHandlerGroup routines;
     while(true) {
-      std::shared_ptr<ServerChannel> channel{server.Accept()};
+      std::shared_ptr<ServerChannel> channel;
+      try {
+        channel = server.Accept();
+      } catch(const std::exception&) {
+        break;
+      }
       routines.Spawn(
         [=] {
-          ApplicationServerServiceProtocolClient client(std::move(channel),
+          ServerServiceProtocolClient client(std::move(channel),
             Initialize());
           RegisterServiceProtocolProfilerServices(Store(client.GetSlots()));
           RegisterServiceProtocolProfilerMessages(Store(client.GetSlots()));
           EchoService::AddSlot(Store(client.GetSlots()),
-            std::bind(OnEchoRequest, std::placeholders::_1,
-            std::placeholders::_2));
+            std::bind(OnEchoRequest<ServerServiceProtocolClient>,
+            std::placeholders::_1, std::placeholders::_2));
           client.Open();
           try {
             auto counter = 0;
             while(true) {
               auto message = client.ReadMessage();
               auto timestamp = microsec_clock::universal_time();
+              ++receivedMessages;
               ++counter;
               if(counter % 100000 == 0) {
                 cout << boost::format("Server: %1% %2%\n") % &client %
@@ -83,30 +235,54 @@ namespace {
             }
           } catch(const ServiceRequestException&) {
           } catch(const NotConnectedException&) {
+          } catch(const EndOfFileException&) {
           }
         });
     }
   }
 
-  void ClientLoop(ApplicationServerConnection& server) {
-    ClientChannel channel(string("client"), Ref(server));
-    ApplicationClientServiceProtocolClient client(&channel, Initialize());
+  template<typename ChannelBuilder>
+  void ClientLoop(const ChannelBuilder& channelBuilder, int messageCount) {
+    auto channel = channelBuilder();
+    ApplicationServiceProtocolClient<decltype(channel.get())> client(
+      channel.get(), Initialize());
     RegisterServiceProtocolProfilerServices(Store(client.GetSlots()));
     RegisterServiceProtocolProfilerMessages(Store(client.GetSlots()));
     client.Open();
     auto counter = 0;
-    while(true) {
+    while(messageCount == 0 || counter < messageCount) {
       auto timestamp = microsec_clock::universal_time();
       SendRecordMessage<EchoMessage>(client, timestamp, "hello world");
       ++counter;
       if(counter % 100000 == 0) {
-        cout << boost::format("Client: %1% %2%\n") % &channel % timestamp <<
-          std::flush;
+        cout << boost::format("Client: %1% %2%\n") % channel.get() %
+          timestamp << std::flush;
       }
       Defer();
     }
     client.Close();
   }
+
+  template<typename ServerConnection, typename ChannelBuilder>
+  void Run(ServerConnection& server, const ChannelBuilder& channelBuilder,
+      int clientCount, int messageCount) {
+    server.Open();
+    RoutineHandlerGroup serverRoutines;
+    serverRoutines.Spawn(
+      [&] {
+        ServerLoop(server);
+      });
+    RoutineHandlerGroup clientRoutines;
+    for(auto i = 0; i < clientCount; ++i) {
+      clientRoutines.Spawn(
+        [&] {
+          ClientLoop(channelBuilder, messageCount);
+        });
+    }
+    clientRoutines.Wait();
+    server.Close();
+    serverRoutines.Wait();
+  }
 }
 
 int main(int argc, const char** argv) {
@@ -128,18 +304,73 @@ int main(int argc, const char** argv) {
   if(clientCount == 0) {
     clientCount = static_cast<int>(boost::thread::hardware_concurrency());
   }
-  ApplicationServerConnection server;
-  RoutineHandlerGroup routines;
-  routines.Spawn(
-    [&] {
-      ServerLoop(server);
-    });
-  for(auto i = 0; i < clientCount; ++i) {
-    routines.Spawn(
+  auto messageCount = Extract<int>(config, "messages", 0);
+  auto& bufferPool = BufferPool::GetInstance();
+  bufferPool.SetEnabled(Extract<bool>(config, "buffer_pool", true));
+  auto transport = Extract<string>(config, "transport", "local");
+  if(transport == "codec") {
+    if(messageCount == 0) {
+      messageCount = 100000;
+    }
+    ProfileCodecs(messageCount);
+  } else if(transport == "pipe") {
+    if(messageCount == 0) {
+      messageCount = 100000;
+    }
+    ProfilePipes(clientCount, messageCount);
+  } else if(transport == "local") {
+    auto startTime = microsec_clock::universal_time();
+    LocalApplicationServerConnection server;
+    Run(server,
       [&] {
-        ClientLoop(server);
-      });
+        return std::make_unique<LocalClientChannel<SharedBuffer>>(
+          string("client"), Ref(server));
+      }, clientCount, messageCount);
+    Report(transport, microsec_clock::universal_time() - startTime);
+#ifndef _WIN32
+  } else if(transport == "shared_memory") {
+    auto startTime = microsec_clock::universal_time();
+    SharedMemoryServerConnection server(SHARED_MEMORY_NAME);
+    Run(server,
+      [&] {
+        return std::make_unique<SharedMemoryChannel>(SHARED_MEMORY_NAME);
+      }, clientCount, messageCount);
+    Report(transport, microsec_clock::universal_time() - startTime);
+#endif
+  } else if(transport == "tcp") {
+    auto address = Extract<IpAddress>(GetNode(config, "server"), "interface");
+    SocketThreadPool socketThreadPool;
+
+    // A sequence of socket options runs the profile once for each entry, so
+    // that option sets can be compared side by side.
+    auto sweep = vector<TcpSocketOptions>();
+    auto optionsNode = config["socket_options"];
+    if(optionsNode && optionsNode.IsSequence()) {
+      sweep = Extract<vector<TcpSocketOptions>>(optionsNode);
+    } else {
+      sweep.push_back(Extract<TcpSocketOptions>(config, "socket_options",
+        TcpSocketOptions()));
+    }
+    for(auto& options : sweep) {
+      receivedMessages = 0;
+      auto startTime = microsec_clock::universal_time();
+      TcpServerSocket server(address, options, Ref(socketThreadPool));
+      Run(server,
+        [&] {
+          return std::make_unique<TcpSocketChannel>(address, options,
+            Ref(socketThreadPool));
+        }, clientCount, messageCount);
+      Report(Describe(options), microsec_clock::universal_time() - startTime);
+    }
+  } else {
+    cerr << "Unknown transport: " << transport << endl;
+    return -1;
   }
-  routines.Wait();
+  auto statistics = bufferPool.GetStatistics();
+  cout << boost::format("Buffer pool: %1%\nAllocations: %2%\n"
+    "Local hits: %3%\nGlobal hits: %4%\nMisses: %5%\n") %
+    (bufferPool.IsEnabled() ? "enabled" : "disabled") %
+    statistics.m_allocations % statistics.m_localHits %
+    statistics.m_globalHits % statistics.m_misses << std::flush;
   return 0;
 }
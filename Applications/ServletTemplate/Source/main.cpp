@@ -3,10 +3,8 @@
 #include <boost/functional/factory.hpp>
 #include <boost/functional/value_factory.hpp>
 #include <tclap/CmdLine.h>
-#include "Beam/Codecs/SizeDeclarativeDecoder.hpp"
-#include "Beam/Codecs/SizeDeclarativeEncoder.hpp"
-#include "Beam/Codecs/ZLibDecoder.hpp"
-#include "Beam/Codecs/ZLibEncoder.hpp"
+#include "Beam/Codecs/ZLibStreamDecoder.hpp"
+#include "Beam/Codecs/ZLibStreamEncoder.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Network/TcpServerSocket.hpp"
 #include "Beam/Serialization/BinaryReceiver.hpp"
@@ -34,8 +32,7 @@ using namespace TCLAP;
 namespace {
   using ServletTemplateServletContainer =
     ServiceProtocolServletContainer<MetaServletTemplateServlet, TcpServerSocket,
-    BinarySender<SharedBuffer>, SizeDeclarativeEncoder<ZLibEncoder>,
-    std::shared_ptr<LiveTimer>>;
+    BinarySender<SharedBuffer>, ZLibStreamEncoder, std::shared_ptr<LiveTimer>>;
   using ApplicationServletTemplateServlet = ServletTemplateServlet<
     ServletTemplateServletContainer>;
 
@@ -43,6 +40,7 @@ namespace {
     string m_serviceName;
     IpAddress m_interface;
     vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -53,6 +51,8 @@ namespace {
     vector<IpAddress> addresses;
     addresses.push_back(m_interface);
     m_addresses = Extract<vector<IpAddress>>(config, "addresses", addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
   }
 }
 
@@ -81,7 +81,8 @@ int main(int argc, const char** argv) {
   SocketThreadPool socketThreadPool;
   TimerThreadPool timerThreadPool;
   ServletTemplateServletContainer server(Initialize(), Initialize(
-    serverConnectionInitializer.m_interface, Ref(socketThreadPool)),
+    serverConnectionInitializer.m_interface,
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
     std::bind(factory<std::shared_ptr<LiveTimer>>{}, seconds{10},
     Ref(timerThreadPool)));
   try {
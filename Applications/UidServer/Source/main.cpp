@@ -47,6 +47,7 @@ namespace {
     string m_serviceName;
     IpAddress m_interface;
     vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -58,6 +59,8 @@ namespace {
     auto addresses = vector<IpAddress>();
     addresses.push_back(m_interface);
     m_addresses = Extract<vector<IpAddress>>(config, "addresses", addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
   }
 }
 
@@ -116,7 +119,8 @@ int main(int argc, const char** argv) {
     mySqlConfig.m_username, mySqlConfig.m_password, mySqlConfig.m_schema);
   auto server = UidServletContainer(Initialize(serviceLocatorClient.Get(),
     Initialize(std::move(mySqlConnection))), Initialize(
-    serverConnectionInitializer.m_interface, Ref(socketThreadPool)),
+    serverConnectionInitializer.m_interface,
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
     std::bind(factory<std::shared_ptr<LiveTimer>>(), seconds(10),
     Ref(timerThreadPool)));
   try {
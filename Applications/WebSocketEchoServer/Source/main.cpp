@@ -6,6 +6,7 @@
 #include "Beam/Utilities/ApplicationInterrupt.hpp"
 #include "Beam/Utilities/Expect.hpp"
 #include "Beam/Utilities/YamlConfig.hpp"
+#include "Beam/WebServices/HttpServerOptions.hpp"
 #include "Beam/WebServices/HttpServletContainer.hpp"
 #include "WebSocketEchoServer/WebSocketEchoServlet.hpp"
 #include "Version.hpp"
@@ -28,6 +29,8 @@ namespace {
   struct ServerConnectionInitializer {
     IpAddress m_interface;
     vector<IpAddress> m_addresses;
+    TcpSocketOptions m_socketOptions;
+    HttpServerOptions m_serverOptions;
 
     void Initialize(const YAML::Node& config);
   };
@@ -37,6 +40,12 @@ namespace {
     auto addresses = vector<IpAddress>();
     addresses.push_back(m_interface);
     m_addresses = Extract<vector<IpAddress>>(config, "addresses", addresses);
+    m_socketOptions = Extract<TcpSocketOptions>(config, "socket_options",
+      TcpSocketOptions());
+    auto serverOptionsNode = config["http_options"];
+    if(serverOptionsNode) {
+      m_serverOptions = HttpServerOptions::Parse(serverOptionsNode);
+    }
   }
 }
 
@@ -65,7 +74,9 @@ int main(int argc, const char** argv) {
     return -1;
   }
   auto server = WebSocketEchoServletContainer(Initialize(),
-    Initialize(serverConnectionInitializer.m_interface, Ref(socketThreadPool)));
+    Initialize(serverConnectionInitializer.m_interface,
+    serverConnectionInitializer.m_socketOptions, Ref(socketThreadPool)),
+    serverConnectionInitializer.m_serverOptions);
   try {
     server.Open();
   } catch(const std::exception& e) {
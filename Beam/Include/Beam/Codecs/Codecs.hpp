@@ -11,12 +11,16 @@ namespace Beam::Codecs {
   class DecoderException;
   struct Encoder;
   class EncoderException;
+  class GZipDecoder;
+  class GZipEncoder;
   class NullDecoder;
   class NullEncoder;
   template<typename DecoderType> class SizeDeclarativeDecoder;
   template<typename EncoderType> class SizeDeclarativeEncoder;
   class ZLibDecoder;
   class ZLibEncoder;
+  class ZLibStreamDecoder;
+  class ZLibStreamEncoder;
 }
 
 #endif
@@ -72,6 +72,16 @@ namespace Codecs {
     */
   template<typename T>
   struct InPlaceSupport : std::false_type {};
+
+  /*! \struct IsStateful
+      \brief Specifies whether an Encoder's output depends on the messages it
+             encoded before, in which case its messages must be decoded in the
+             order they were encoded and the Encoder provides an
+             EncodeStandalone method for messages sent over several
+             connections.
+    */
+  template<typename T>
+  struct IsStateful : std::false_type {};
 }
 }
 
@@ -0,0 +1,152 @@
+#ifndef BEAM_GZIPDECODER_HPP
+#define BEAM_GZIPDECODER_HPP
+#include <algorithm>
+#include <cstdint>
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/Codecs.hpp"
+#include "Beam/Codecs/Decoder.hpp"
+#include "Beam/Codecs/DecoderException.hpp"
+#include "Beam/Codecs/GZipDetails.hpp"
+#include "Beam/IO/Buffer.hpp"
+
+namespace Beam {
+namespace Codecs {
+
+  /*! \class GZipDecoder
+      \brief Decodes data in the gzip format.
+   */
+  class GZipDecoder {
+    public:
+      std::size_t Decode(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Decode(const Buffer& source, void* destination,
+        std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Decode(const void* source, std::size_t sourceSize,
+        Out<Buffer> destination);
+
+      template<typename SourceBuffer, typename DestinationBuffer>
+      std::size_t Decode(const SourceBuffer& source,
+        Out<DestinationBuffer> destination);
+
+    private:
+      static int Inflate(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize, std::size_t& size);
+  };
+
+  template<>
+  struct Inverse<GZipDecoder> {
+    using type = GZipEncoder;
+  };
+
+  inline std::size_t GZipDecoder::Decode(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize) {
+    auto size = std::size_t(0);
+    auto result = Inflate(source, sourceSize, destination, destinationSize,
+      size);
+    if(result == Z_BUF_ERROR) {
+      BOOST_THROW_EXCEPTION(DecoderException(
+        "The buffer was not large enough to hold the uncompressed data."));
+    } else if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(DecoderException("Insufficient memory."));
+    } else if(result != Z_STREAM_END) {
+      BOOST_THROW_EXCEPTION(DecoderException(
+        "The compressed data was corrupted."));
+    }
+    return size;
+  }
+
+  template<typename Buffer>
+  std::size_t GZipDecoder::Decode(const Buffer& source, void* destination,
+      std::size_t destinationSize) {
+    return Decode(source.GetData(), source.GetSize(), destination,
+      destinationSize);
+  }
+
+  template<typename Buffer>
+  std::size_t GZipDecoder::Decode(const void* source, std::size_t sourceSize,
+      Out<Buffer> destination) {
+
+    // The trailer stores the decoded size modulo 2^32, which is only a hint
+    // since a source may hold several gzip members or be corrupted, so it's
+    // capped at deflate's maximum compression ratio of 1032:1.
+    auto decodedSize = std::size_t(0);
+    if(sourceSize >= Details::GZIP_MINIMUM_SIZE) {
+      auto trailer = static_cast<const unsigned char*>(source) + sourceSize - 4;
+      decodedSize = std::min(static_cast<std::size_t>(trailer[0]) |
+        (static_cast<std::size_t>(trailer[1]) << 8) |
+        (static_cast<std::size_t>(trailer[2]) << 16) |
+        (static_cast<std::size_t>(trailer[3]) << 24), 1032 * sourceSize);
+    }
+    while(true) {
+      destination->Reserve(decodedSize);
+      auto size = std::size_t(0);
+      auto result = Inflate(source, sourceSize, destination->GetMutableData(),
+        destination->GetSize(), size);
+      if(result == Z_BUF_ERROR) {
+        decodedSize = 2 * decodedSize + 1024;
+        continue;
+      }
+      if(result == Z_MEM_ERROR) {
+        BOOST_THROW_EXCEPTION(DecoderException("Insufficient memory."));
+      } else if(result != Z_STREAM_END) {
+        BOOST_THROW_EXCEPTION(DecoderException(
+          "The compressed data was corrupted."));
+      }
+      destination->Shrink(destination->GetSize() - size);
+      return size;
+    }
+  }
+
+  template<typename SourceBuffer, typename DestinationBuffer>
+  std::size_t GZipDecoder::Decode(const SourceBuffer& source,
+      Out<DestinationBuffer> destination) {
+    return Decode(source.GetData(), source.GetSize(), Store(destination));
+  }
+
+  inline int GZipDecoder::Inflate(const void* source, std::size_t sourceSize,
+      void* destination, std::size_t destinationSize, std::size_t& size) {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.avail_in = static_cast<uInt>(sourceSize);
+    stream.next_in = static_cast<Bytef*>(const_cast<void*>(source));
+    auto result = inflateInit2(&stream, Details::GZIP_WINDOW_BITS);
+    if(result != Z_OK) {
+      return result;
+    }
+
+    // zlib rejects a null output buffer even when there's nothing to write.
+    auto empty = Bytef(0);
+    stream.next_out = destinationSize == 0 ? &empty :
+      static_cast<Bytef*>(destination);
+    stream.avail_out = static_cast<uInt>(destinationSize);
+    result = inflate(&stream, Z_FINISH);
+    while(result == Z_STREAM_END && stream.avail_in != 0) {
+
+      // Concatenated members decode to the concatenation of their contents.
+      inflateReset(&stream);
+      result = inflate(&stream, Z_FINISH);
+    }
+    size = destinationSize - stream.avail_out;
+    if((result == Z_BUF_ERROR || result == Z_OK) && stream.avail_out != 0) {
+
+      // The output wasn't exhausted so it's the source that was cut short.
+      result = Z_DATA_ERROR;
+    }
+    inflateEnd(&stream);
+    return result;
+  }
+}
+
+  template<>
+  struct ImplementsConcept<Codecs::GZipDecoder, Codecs::Decoder> :
+    std::true_type {};
+}
+
+#endif
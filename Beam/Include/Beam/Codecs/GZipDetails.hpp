@@ -0,0 +1,20 @@
+#ifndef BEAM_GZIPDETAILS_HPP
+#define BEAM_GZIPDETAILS_HPP
+#include <cstddef>
+
+namespace Beam {
+namespace Codecs {
+namespace Details {
+
+  //! The window bits passed to zlib to read and write the gzip format rather
+  //! than the zlib format.
+  constexpr auto GZIP_WINDOW_BITS = 15 + 16;
+
+  //! The size of the gzip header and trailer when no optional fields are
+  //! present.
+  constexpr auto GZIP_MINIMUM_SIZE = std::size_t(18);
+}
+}
+}
+
+#endif
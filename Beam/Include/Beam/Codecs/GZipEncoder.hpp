@@ -0,0 +1,141 @@
+#ifndef BEAM_GZIPENCODER_HPP
+#define BEAM_GZIPENCODER_HPP
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/Codecs.hpp"
+#include "Beam/Codecs/Encoder.hpp"
+#include "Beam/Codecs/EncoderException.hpp"
+#include "Beam/Codecs/GZipDetails.hpp"
+#include "Beam/IO/Buffer.hpp"
+
+namespace Beam {
+namespace Codecs {
+
+  /*! \class GZipEncoder
+      \brief Encodes using the gzip format, as used by the HTTP gzip content
+             coding.
+   */
+  class GZipEncoder {
+    public:
+
+      //! Constructs a GZipEncoder using zlib's default compression level.
+      GZipEncoder();
+
+      //! Constructs a GZipEncoder.
+      /*!
+        \param level The compression level, from Z_BEST_SPEED to
+               Z_BEST_COMPRESSION.
+      */
+      explicit GZipEncoder(int level);
+
+      //! Returns the compression level.
+      int GetLevel() const;
+
+      //! Returns the largest size a message can be encoded to.
+      /*!
+        \param sourceSize The size of the message.
+      */
+      static std::size_t GetEncodedSizeBound(std::size_t sourceSize);
+
+      std::size_t Encode(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Encode(const Buffer& source, void* destination,
+        std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Encode(const void* source, std::size_t sourceSize,
+        Out<Buffer> destination);
+
+      template<typename SourceBuffer, typename DestinationBuffer>
+      std::size_t Encode(const SourceBuffer& source,
+        Out<DestinationBuffer> destination);
+
+    private:
+      int m_level;
+  };
+
+  template<>
+  struct Inverse<GZipEncoder> {
+    using type = GZipDecoder;
+  };
+
+  inline GZipEncoder::GZipEncoder()
+    : GZipEncoder(Z_DEFAULT_COMPRESSION) {}
+
+  inline GZipEncoder::GZipEncoder(int level)
+    : m_level(level) {}
+
+  inline int GZipEncoder::GetLevel() const {
+    return m_level;
+  }
+
+  inline std::size_t GZipEncoder::GetEncodedSizeBound(std::size_t sourceSize) {
+
+    // compressBound accounts for the zlib wrapper, the gzip header and trailer
+    // are 12 bytes longer.
+    return static_cast<std::size_t>(
+      compressBound(static_cast<uLong>(sourceSize))) + 12;
+  }
+
+  inline std::size_t GZipEncoder::Encode(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize) {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    auto result = deflateInit2(&stream, m_level, Z_DEFLATED,
+      Details::GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(EncoderException("Insufficient memory."));
+    } else if(result != Z_OK) {
+      BOOST_THROW_EXCEPTION(EncoderException("Invalid compression level."));
+    }
+    stream.avail_in = static_cast<uInt>(sourceSize);
+    stream.next_in = static_cast<Bytef*>(const_cast<void*>(source));
+    stream.avail_out = static_cast<uInt>(destinationSize);
+    stream.next_out = static_cast<Bytef*>(destination);
+    result = deflate(&stream, Z_FINISH);
+    auto size = static_cast<std::size_t>(stream.total_out);
+    deflateEnd(&stream);
+    if(result != Z_STREAM_END) {
+      if(result == Z_OK || result == Z_BUF_ERROR) {
+        BOOST_THROW_EXCEPTION(EncoderException(
+          "The buffer was not large enough to hold the compressed data."));
+      }
+      BOOST_THROW_EXCEPTION(EncoderException("Unknown error."));
+    }
+    return size;
+  }
+
+  template<typename Buffer>
+  std::size_t GZipEncoder::Encode(const Buffer& source, void* destination,
+      std::size_t destinationSize) {
+    return Encode(source.GetData(), source.GetSize(), destination,
+      destinationSize);
+  }
+
+  template<typename Buffer>
+  std::size_t GZipEncoder::Encode(const void* source, std::size_t sourceSize,
+      Out<Buffer> destination) {
+    destination->Reserve(GetEncodedSizeBound(sourceSize));
+    auto size = Encode(source, sourceSize, destination->GetMutableData(),
+      destination->GetSize());
+    destination->Shrink(destination->GetSize() - size);
+    return size;
+  }
+
+  template<typename SourceBuffer, typename DestinationBuffer>
+  std::size_t GZipEncoder::Encode(const SourceBuffer& source,
+      Out<DestinationBuffer> destination) {
+    return Encode(source.GetData(), source.GetSize(), Store(destination));
+  }
+}
+
+  template<>
+  struct ImplementsConcept<Codecs::GZipEncoder, Codecs::Encoder> :
+    std::true_type {};
+}
+
+#endif
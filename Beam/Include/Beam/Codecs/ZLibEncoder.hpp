@@ -15,6 +15,20 @@ namespace Codecs {
    */
   class ZLibEncoder {
     public:
+
+      //! Constructs a ZLibEncoder using the best compression.
+      ZLibEncoder();
+
+      //! Constructs a ZLibEncoder.
+      /*!
+        \param level The compression level, from Z_BEST_SPEED to
+               Z_BEST_COMPRESSION.
+      */
+      explicit ZLibEncoder(int level);
+
+      //! Returns the compression level.
+      int GetLevel() const;
+
       std::size_t Encode(const void* source, std::size_t sourceSize,
         void* destination, std::size_t destinationSize);
 
@@ -29,6 +43,9 @@ namespace Codecs {
       template<typename SourceBuffer, typename DestinationBuffer>
       std::size_t Encode(const SourceBuffer& source,
         Out<DestinationBuffer> destination);
+
+    private:
+      int m_level;
   };
 
   template<>
@@ -36,6 +53,16 @@ namespace Codecs {
     using type = ZLibDecoder;
   };
 
+  inline ZLibEncoder::ZLibEncoder()
+    : ZLibEncoder(Z_BEST_COMPRESSION) {}
+
+  inline ZLibEncoder::ZLibEncoder(int level)
+    : m_level(level) {}
+
+  inline int ZLibEncoder::GetLevel() const {
+    return m_level;
+  }
+
   inline std::size_t ZLibEncoder::Encode(const void* source,
       std::size_t sourceSize, void* destination, std::size_t destinationSize) {
     z_stream stream;
@@ -46,7 +73,7 @@ namespace Codecs {
     stream.next_in = static_cast<Bytef*>(const_cast<void*>(source));
     stream.avail_out = static_cast<uInt>(destinationSize);
     stream.next_out = static_cast<Bytef*>(const_cast<void*>(destination));
-    auto result = deflateInit(&stream, Z_BEST_COMPRESSION);
+    auto result = deflateInit(&stream, m_level);
     if(result == Z_OK) {
       result = deflate(&stream, Z_FINISH);
       if(result == Z_STREAM_END) {
@@ -0,0 +1,198 @@
+#ifndef BEAM_ZLIBSTREAMDECODER_HPP
+#define BEAM_ZLIBSTREAMDECODER_HPP
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/Codecs.hpp"
+#include "Beam/Codecs/Decoder.hpp"
+#include "Beam/Codecs/DecoderException.hpp"
+#include "Beam/Codecs/ZLibStreamDetails.hpp"
+#include "Beam/IO/Buffer.hpp"
+
+namespace Beam {
+namespace Codecs {
+
+  /*! \class ZLibStreamDecoder
+      \brief Decodes messages encoded by a ZLibStreamEncoder, in the order
+             they were encoded.
+   */
+  class ZLibStreamDecoder {
+    public:
+
+      //! Constructs a ZLibStreamDecoder.
+      ZLibStreamDecoder() = default;
+
+      //! Constructs a ZLibStreamDecoder starting a new stream.
+      ZLibStreamDecoder(const ZLibStreamDecoder& decoder);
+
+      ZLibStreamDecoder(ZLibStreamDecoder&& decoder) = default;
+
+      std::size_t Decode(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Decode(const Buffer& source, void* destination,
+        std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Decode(const void* source, std::size_t sourceSize,
+        Out<Buffer> destination);
+
+      template<typename SourceBuffer, typename DestinationBuffer>
+      std::size_t Decode(const SourceBuffer& source,
+        Out<DestinationBuffer> destination);
+
+    private:
+      struct StreamDeleter {
+        void operator ()(z_stream* stream) const;
+      };
+      using Stream = std::unique_ptr<z_stream, StreamDeleter>;
+      Stream m_stream;
+
+      static std::size_t GetDecodedSize(const void* source,
+        std::size_t sourceSize);
+      static Stream MakeStream();
+  };
+
+  template<>
+  struct Inverse<ZLibStreamDecoder> {
+    using type = ZLibStreamEncoder;
+  };
+
+  inline ZLibStreamDecoder::ZLibStreamDecoder(const ZLibStreamDecoder&)
+    : ZLibStreamDecoder() {}
+
+  inline std::size_t ZLibStreamDecoder::Decode(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize) {
+    auto decodedSize = GetDecodedSize(source, sourceSize);
+    if(destinationSize < decodedSize) {
+      BOOST_THROW_EXCEPTION(DecoderException(
+        "The buffer was not large enough to hold the uncompressed data."));
+    }
+    auto frame = static_cast<Details::ZLibStreamFrame>(
+      *static_cast<const char*>(source));
+    if(frame == Details::ZLibStreamFrame::RAW) {
+      std::memcpy(destination, static_cast<const char*>(source) +
+        Details::ZLIB_STREAM_RAW_HEADER_SIZE, decodedSize);
+      return decodedSize;
+    }
+    auto standaloneStream = Stream();
+    auto stream = [&] {
+      if(frame == Details::ZLibStreamFrame::STANDALONE) {
+        standaloneStream = MakeStream();
+        return standaloneStream.get();
+      }
+      if(m_stream == nullptr) {
+        m_stream = MakeStream();
+      }
+      return m_stream.get();
+    }();
+
+    // zlib rejects a null output buffer even when there's nothing to write.
+    auto empty = Bytef(0);
+    stream->next_out = destinationSize == 0 ? &empty :
+      static_cast<Bytef*>(destination);
+    stream->avail_out = static_cast<uInt>(destinationSize);
+    stream->next_in = static_cast<Bytef*>(const_cast<void*>(source)) +
+      Details::ZLIB_STREAM_HEADER_SIZE;
+    stream->avail_in = static_cast<uInt>(
+      sourceSize - Details::ZLIB_STREAM_HEADER_SIZE);
+    auto isCorrupted = [&] {
+      if(frame == Details::ZLibStreamFrame::STANDALONE) {
+        return inflate(stream, Z_FINISH) != Z_STREAM_END;
+      }
+      auto result = inflate(stream, Z_SYNC_FLUSH);
+      if((result != Z_OK && result != Z_BUF_ERROR) || stream->avail_in != 0) {
+        return true;
+      }
+      stream->next_in = const_cast<Bytef*>(Details::ZLIB_STREAM_FLUSH_MARKER);
+      stream->avail_in = sizeof(Details::ZLIB_STREAM_FLUSH_MARKER);
+      result = inflate(stream, Z_SYNC_FLUSH);
+      return (result != Z_OK && result != Z_BUF_ERROR) ||
+        stream->avail_in != 0;
+    }();
+    auto size = destinationSize - stream->avail_out;
+    if(isCorrupted || size != decodedSize) {
+      if(frame == Details::ZLibStreamFrame::STREAM) {
+        m_stream.reset();
+      }
+      BOOST_THROW_EXCEPTION(DecoderException(
+        "The compressed data was corrupted."));
+    }
+    return size;
+  }
+
+  template<typename Buffer>
+  std::size_t ZLibStreamDecoder::Decode(const Buffer& source,
+      void* destination, std::size_t destinationSize) {
+    return Decode(source.GetData(), source.GetSize(), destination,
+      destinationSize);
+  }
+
+  template<typename Buffer>
+  std::size_t ZLibStreamDecoder::Decode(const void* source,
+      std::size_t sourceSize, Out<Buffer> destination) {
+    destination->Reserve(GetDecodedSize(source, sourceSize));
+    auto size = Decode(source, sourceSize, destination->GetMutableData(),
+      destination->GetSize());
+    destination->Shrink(destination->GetSize() - size);
+    return size;
+  }
+
+  template<typename SourceBuffer, typename DestinationBuffer>
+  std::size_t ZLibStreamDecoder::Decode(const SourceBuffer& source,
+      Out<DestinationBuffer> destination) {
+    return Decode(source.GetData(), source.GetSize(), Store(destination));
+  }
+
+  inline void ZLibStreamDecoder::StreamDeleter::operator ()(
+      z_stream* stream) const {
+    inflateEnd(stream);
+    delete stream;
+  }
+
+  inline std::size_t ZLibStreamDecoder::GetDecodedSize(const void* source,
+      std::size_t sourceSize) {
+    if(sourceSize < Details::ZLIB_STREAM_RAW_HEADER_SIZE) {
+      BOOST_THROW_EXCEPTION(DecoderException("Source size too small."));
+    }
+    auto frame = static_cast<Details::ZLibStreamFrame>(
+      *static_cast<const char*>(source));
+    if(frame == Details::ZLibStreamFrame::RAW) {
+      return sourceSize - Details::ZLIB_STREAM_RAW_HEADER_SIZE;
+    } else if(frame != Details::ZLibStreamFrame::STREAM &&
+        frame != Details::ZLibStreamFrame::STANDALONE) {
+      BOOST_THROW_EXCEPTION(DecoderException(
+        "The compressed data was corrupted."));
+    }
+    if(sourceSize < Details::ZLIB_STREAM_HEADER_SIZE) {
+      BOOST_THROW_EXCEPTION(DecoderException("Source size too small."));
+    }
+    auto size = std::uint32_t();
+    std::memcpy(&size, static_cast<const char*>(source) +
+      Details::ZLIB_STREAM_RAW_HEADER_SIZE, sizeof(size));
+    return FromBigEndian(size);
+  }
+
+  inline ZLibStreamDecoder::Stream ZLibStreamDecoder::MakeStream() {
+    auto stream = std::make_unique<z_stream>();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+    if(inflateInit2(stream.get(), Details::ZLIB_STREAM_WINDOW_BITS) != Z_OK) {
+      BOOST_THROW_EXCEPTION(DecoderException("Insufficient memory."));
+    }
+    return Stream(stream.release());
+  }
+}
+
+  template<>
+  struct ImplementsConcept<Codecs::ZLibStreamDecoder, Codecs::Decoder> :
+    std::true_type {};
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef BEAM_ZLIBSTREAMDETAILS_HPP
+#define BEAM_ZLIBSTREAMDETAILS_HPP
+#include <cstdint>
+#include <cstring>
+#include "Beam/Utilities/Endian.hpp"
+
+namespace Beam {
+namespace Codecs {
+namespace Details {
+
+  /** Identifies how a message encoded by a ZLibStreamEncoder is stored. */
+  enum class ZLibStreamFrame : std::uint8_t {
+
+    //! The message is stored as is.
+    RAW = 0,
+
+    //! The message is a segment of the connection's deflate stream ending in
+    //! a sync flush whose trailing 0x00 0x00 0xFF 0xFF marker is omitted.
+    STREAM = 1,
+
+    //! The message is a complete deflate stream independent of the
+    //! connection's stream.
+    STANDALONE = 2
+  };
+
+  //! The size of the header of a RAW frame.
+  constexpr auto ZLIB_STREAM_RAW_HEADER_SIZE = std::size_t(1);
+
+  //! The size of the header of a STREAM or STANDALONE frame, which stores the
+  //! size of the decoded message after the frame type.
+  constexpr auto ZLIB_STREAM_HEADER_SIZE =
+    ZLIB_STREAM_RAW_HEADER_SIZE + sizeof(std::uint32_t);
+
+  //! The marker ending a sync flush.
+  constexpr unsigned char ZLIB_STREAM_FLUSH_MARKER[] =
+    {0x00, 0x00, 0xFF, 0xFF};
+
+  //! The window size used by both ends of the stream, negative to select a
+  //! raw deflate stream without a zlib header or checksum.
+  constexpr auto ZLIB_STREAM_WINDOW_BITS = -15;
+
+  //! Writes the header of a compressed frame.
+  inline void WriteZLibStreamHeader(ZLibStreamFrame frame, std::size_t size,
+      void* destination) {
+    auto header = static_cast<char*>(destination);
+    header[0] = static_cast<char>(frame);
+    auto portableSize = ToBigEndian<std::uint32_t>(
+      static_cast<std::uint32_t>(size));
+    std::memcpy(header + ZLIB_STREAM_RAW_HEADER_SIZE, &portableSize,
+      sizeof(portableSize));
+  }
+}
+}
+}
+
+#endif
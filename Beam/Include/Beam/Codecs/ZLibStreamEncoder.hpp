@@ -0,0 +1,288 @@
+#ifndef BEAM_ZLIBSTREAMENCODER_HPP
+#define BEAM_ZLIBSTREAMENCODER_HPP
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/Codecs.hpp"
+#include "Beam/Codecs/Encoder.hpp"
+#include "Beam/Codecs/EncoderException.hpp"
+#include "Beam/Codecs/ZLibStreamDetails.hpp"
+#include "Beam/IO/Buffer.hpp"
+
+namespace Beam {
+namespace Codecs {
+
+  /*! \class ZLibStreamEncoder
+      \brief Encodes the messages sent over a connection as a single deflate
+             stream.
+      \details Every message is flushed using Z_SYNC_FLUSH so that it can be
+               decoded as soon as it's received, while the compression window
+               spans the messages encoded before it, so that similar messages
+               compress far better than when each is compressed on its own.
+               Messages smaller than a threshold are stored as is. As a
+               result, messages must be decoded by a single
+               ZLibStreamDecoder in the order they were encoded.
+   */
+  class ZLibStreamEncoder {
+    public:
+
+      //! The default compression level.
+      static constexpr auto DEFAULT_LEVEL = Z_BEST_SPEED;
+
+      //! The default size below which messages are stored as is.
+      static constexpr auto DEFAULT_THRESHOLD = std::size_t(64);
+
+      //! Constructs a ZLibStreamEncoder using the default level and threshold.
+      ZLibStreamEncoder();
+
+      //! Constructs a ZLibStreamEncoder.
+      /*!
+        \param level The compression level, from Z_BEST_SPEED to
+               Z_BEST_COMPRESSION.
+        \param threshold The size below which messages are stored as is.
+      */
+      ZLibStreamEncoder(int level, std::size_t threshold);
+
+      //! Constructs a ZLibStreamEncoder with the same level and threshold as
+      //! another, starting a new stream.
+      /*!
+        \param encoder The ZLibStreamEncoder to copy the settings of.
+      */
+      ZLibStreamEncoder(const ZLibStreamEncoder& encoder);
+
+      ZLibStreamEncoder(ZLibStreamEncoder&& encoder) = default;
+
+      //! Returns the compression level.
+      int GetLevel() const;
+
+      //! Returns the size below which messages are stored as is.
+      std::size_t GetThreshold() const;
+
+      //! Returns the largest size a message can be encoded to.
+      /*!
+        \param sourceSize The size of the message.
+      */
+      std::size_t GetEncodedSizeBound(std::size_t sourceSize) const;
+
+      std::size_t Encode(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Encode(const Buffer& source, void* destination,
+        std::size_t destinationSize);
+
+      template<typename Buffer>
+      std::size_t Encode(const void* source, std::size_t sourceSize,
+        Out<Buffer> destination);
+
+      template<typename SourceBuffer, typename DestinationBuffer>
+      std::size_t Encode(const SourceBuffer& source,
+        Out<DestinationBuffer> destination);
+
+      //! Encodes a message independently of the stream, used for a message
+      //! encoded once and sent over several connections.
+      /*!
+        \param source The source data to encode.
+        \param sourceSize The size of the <i>source</i>.
+        \param destination The destination of the encoded <i>source</i>.
+        \param destinationSize The size of the <i>destination</i>.
+      */
+      std::size_t EncodeStandalone(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize);
+
+      //! Encodes a message independently of the stream, used for a message
+      //! encoded once and sent over several connections.
+      /*!
+        \param source The source data to encode.
+        \param destination The destination of the encoded <i>source</i>.
+      */
+      template<typename SourceBuffer, typename DestinationBuffer>
+      std::size_t EncodeStandalone(const SourceBuffer& source,
+        Out<DestinationBuffer> destination);
+
+    private:
+      struct StreamDeleter {
+        void operator ()(z_stream* stream) const;
+      };
+      using Stream = std::unique_ptr<z_stream, StreamDeleter>;
+      int m_level;
+      std::size_t m_threshold;
+      Stream m_stream;
+
+      Stream MakeStream() const;
+      std::size_t Encode(const void* source, std::size_t sourceSize,
+        void* destination, std::size_t destinationSize,
+        Details::ZLibStreamFrame frame);
+  };
+
+  template<>
+  struct Inverse<ZLibStreamEncoder> {
+    using type = ZLibStreamDecoder;
+  };
+
+  template<>
+  struct IsStateful<ZLibStreamEncoder> : std::true_type {};
+
+  inline ZLibStreamEncoder::ZLibStreamEncoder()
+    : ZLibStreamEncoder(DEFAULT_LEVEL, DEFAULT_THRESHOLD) {}
+
+  inline ZLibStreamEncoder::ZLibStreamEncoder(int level, std::size_t threshold)
+    : m_level(level),
+      m_threshold(threshold) {}
+
+  inline ZLibStreamEncoder::ZLibStreamEncoder(const ZLibStreamEncoder& encoder)
+    : ZLibStreamEncoder(encoder.m_level, encoder.m_threshold) {}
+
+  inline int ZLibStreamEncoder::GetLevel() const {
+    return m_level;
+  }
+
+  inline std::size_t ZLibStreamEncoder::GetThreshold() const {
+    return m_threshold;
+  }
+
+  inline std::size_t ZLibStreamEncoder::GetEncodedSizeBound(
+      std::size_t sourceSize) const {
+    return Details::ZLIB_STREAM_HEADER_SIZE +
+      static_cast<std::size_t>(compressBound(static_cast<uLong>(sourceSize))) +
+      sizeof(Details::ZLIB_STREAM_FLUSH_MARKER);
+  }
+
+  inline std::size_t ZLibStreamEncoder::Encode(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize) {
+    return Encode(source, sourceSize, destination, destinationSize,
+      Details::ZLibStreamFrame::STREAM);
+  }
+
+  template<typename Buffer>
+  std::size_t ZLibStreamEncoder::Encode(const Buffer& source,
+      void* destination, std::size_t destinationSize) {
+    return Encode(source.GetData(), source.GetSize(), destination,
+      destinationSize);
+  }
+
+  template<typename Buffer>
+  std::size_t ZLibStreamEncoder::Encode(const void* source,
+      std::size_t sourceSize, Out<Buffer> destination) {
+    destination->Reserve(GetEncodedSizeBound(sourceSize));
+    auto size = Encode(source, sourceSize, destination->GetMutableData(),
+      destination->GetSize());
+    destination->Shrink(destination->GetSize() - size);
+    return size;
+  }
+
+  template<typename SourceBuffer, typename DestinationBuffer>
+  std::size_t ZLibStreamEncoder::Encode(const SourceBuffer& source,
+      Out<DestinationBuffer> destination) {
+    return Encode(source.GetData(), source.GetSize(), Store(destination));
+  }
+
+  inline std::size_t ZLibStreamEncoder::EncodeStandalone(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize) {
+    return Encode(source, sourceSize, destination, destinationSize,
+      Details::ZLibStreamFrame::STANDALONE);
+  }
+
+  template<typename SourceBuffer, typename DestinationBuffer>
+  std::size_t ZLibStreamEncoder::EncodeStandalone(const SourceBuffer& source,
+      Out<DestinationBuffer> destination) {
+    destination->Reserve(GetEncodedSizeBound(source.GetSize()));
+    auto size = EncodeStandalone(source.GetData(), source.GetSize(),
+      destination->GetMutableData(), destination->GetSize());
+    destination->Shrink(destination->GetSize() - size);
+    return size;
+  }
+
+  inline void ZLibStreamEncoder::StreamDeleter::operator ()(
+      z_stream* stream) const {
+    deflateEnd(stream);
+    delete stream;
+  }
+
+  inline ZLibStreamEncoder::Stream ZLibStreamEncoder::MakeStream() const {
+    auto stream = std::make_unique<z_stream>();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    auto result = deflateInit2(stream.get(), m_level, Z_DEFLATED,
+      Details::ZLIB_STREAM_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(EncoderException("Insufficient memory."));
+    } else if(result != Z_OK) {
+      BOOST_THROW_EXCEPTION(EncoderException("Invalid compression level."));
+    }
+    return Stream(stream.release());
+  }
+
+  inline std::size_t ZLibStreamEncoder::Encode(const void* source,
+      std::size_t sourceSize, void* destination, std::size_t destinationSize,
+      Details::ZLibStreamFrame frame) {
+    if(sourceSize < m_threshold) {
+      if(destinationSize < Details::ZLIB_STREAM_RAW_HEADER_SIZE + sourceSize) {
+        BOOST_THROW_EXCEPTION(EncoderException(
+          "The buffer was not large enough to hold the compressed data."));
+      }
+      *static_cast<char*>(destination) =
+        static_cast<char>(Details::ZLibStreamFrame::RAW);
+      std::memcpy(static_cast<char*>(destination) +
+        Details::ZLIB_STREAM_RAW_HEADER_SIZE, source, sourceSize);
+      return Details::ZLIB_STREAM_RAW_HEADER_SIZE + sourceSize;
+    }
+
+    // Data given to the stream can't be taken back, so the destination is
+    // checked before anything is written to the stream.
+    if(sourceSize > std::numeric_limits<std::uint32_t>::max()) {
+      BOOST_THROW_EXCEPTION(EncoderException("The message is too large."));
+    }
+    if(destinationSize < GetEncodedSizeBound(sourceSize)) {
+      BOOST_THROW_EXCEPTION(EncoderException(
+        "The buffer was not large enough to hold the compressed data."));
+    }
+    auto standaloneStream = Stream();
+    auto stream = [&] {
+      if(frame == Details::ZLibStreamFrame::STANDALONE) {
+        standaloneStream = MakeStream();
+        return standaloneStream.get();
+      }
+      if(m_stream == nullptr) {
+        m_stream = MakeStream();
+      }
+      return m_stream.get();
+    }();
+    Details::WriteZLibStreamHeader(frame, sourceSize, destination);
+    auto body = static_cast<Bytef*>(destination) +
+      Details::ZLIB_STREAM_HEADER_SIZE;
+    stream->next_in = static_cast<Bytef*>(const_cast<void*>(source));
+    stream->avail_in = static_cast<uInt>(sourceSize);
+    stream->next_out = body;
+    stream->avail_out = static_cast<uInt>(
+      destinationSize - Details::ZLIB_STREAM_HEADER_SIZE);
+    if(frame == Details::ZLibStreamFrame::STANDALONE) {
+      if(deflate(stream, Z_FINISH) != Z_STREAM_END) {
+        BOOST_THROW_EXCEPTION(EncoderException("Unknown error."));
+      }
+      return Details::ZLIB_STREAM_HEADER_SIZE +
+        static_cast<std::size_t>(stream->next_out - body);
+    }
+    auto result = deflate(stream, Z_SYNC_FLUSH);
+    if(result != Z_OK || stream->avail_in != 0 || stream->avail_out == 0) {
+
+      // The peer's stream can no longer be kept in step with this one.
+      m_stream.reset();
+      BOOST_THROW_EXCEPTION(EncoderException("Unknown error."));
+    }
+    return Details::ZLIB_STREAM_HEADER_SIZE +
+      static_cast<std::size_t>(stream->next_out - body) -
+      sizeof(Details::ZLIB_STREAM_FLUSH_MARKER);
+  }
+}
+
+  template<>
+  struct ImplementsConcept<Codecs::ZLibStreamEncoder, Codecs::Encoder> :
+    std::true_type {};
+}
+
+#endif
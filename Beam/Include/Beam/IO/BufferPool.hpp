@@ -0,0 +1,365 @@
+#ifndef BEAM_BUFFER_POOL_HPP
+#define BEAM_BUFFER_POOL_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/IO/IO.hpp"
+
+#ifndef BEAM_USE_BUFFER_POOL
+  #define BEAM_USE_BUFFER_POOL 1
+#endif
+
+namespace Beam {
+namespace IO {
+
+  /*! \class BufferPool
+      \brief Recycles the storage used by Buffers in power of two size classes.
+      \details Each thread keeps a small cache of free blocks per size class
+               that is refilled from and spilled to a shared free list, so
+               that the common allocate/release cycle of a message buffer
+               avoids both the global heap and any lock. Blocks larger than
+               MAXIMUM_BLOCK_SIZE are passed directly to the heap.
+   */
+  class BufferPool : private boost::noncopyable {
+    public:
+
+      /*! \struct Statistics
+          \brief Stores a snapshot of a BufferPool's counters.
+       */
+      struct Statistics {
+
+        //! The number of blocks allocated.
+        std::uint64_t m_allocations;
+
+        //! The number of blocks released.
+        std::uint64_t m_deallocations;
+
+        //! The number of allocations served from a thread's cache.
+        std::uint64_t m_localHits;
+
+        //! The number of allocations served from the shared free list.
+        std::uint64_t m_globalHits;
+
+        //! The number of allocations passed to the heap.
+        std::uint64_t m_misses;
+      };
+
+      //! The smallest block size allocated.
+      static constexpr std::size_t MINIMUM_BLOCK_SIZE = 64;
+
+      //! The largest block size that is pooled.
+      static constexpr std::size_t MAXIMUM_BLOCK_SIZE = 1 << 20;
+
+      //! Returns the global BufferPool.
+      static BufferPool& GetInstance();
+
+      //! Returns the size of the block used to store a given number of bytes.
+      /*!
+        \param size The number of bytes to store.
+        \return The smallest power of two at least as large as <i>size</i> and
+                MINIMUM_BLOCK_SIZE.
+      */
+      static std::size_t GetBlockSize(std::size_t size);
+
+      //! Returns <code>true</code> iff released blocks are recycled.
+      bool IsEnabled() const;
+
+      //! Sets whether released blocks are recycled, when disabled every
+      //! allocation is passed to the heap.
+      void SetEnabled(bool isEnabled);
+
+      //! Allocates a block.
+      /*!
+        \param size The size of the block, rounded up to GetBlockSize(size).
+        \return The allocated block.
+      */
+      char* Allocate(std::size_t size);
+
+      //! Releases a block.
+      /*!
+        \param block The block to release.
+        \param size The size the <i>block</i> was allocated with.
+      */
+      void Deallocate(char* block, std::size_t size);
+
+      //! Returns a snapshot of this pool's counters.
+      Statistics GetStatistics() const;
+
+    private:
+      static constexpr std::size_t CLASS_COUNT = 15;
+      static constexpr std::size_t LOCAL_CACHE_BYTES = 1 << 20;
+      static constexpr std::size_t LOCAL_CACHE_BLOCKS = 32;
+      static constexpr std::size_t GLOBAL_CACHE_BYTES = 1 << 24;
+      struct Counters {
+        std::atomic<std::uint64_t> m_allocations;
+        std::atomic<std::uint64_t> m_deallocations;
+        std::atomic<std::uint64_t> m_localHits;
+        std::atomic<std::uint64_t> m_globalHits;
+        std::atomic<std::uint64_t> m_misses;
+
+        Counters();
+        void Add(Statistics& statistics) const;
+      };
+      struct FreeList {
+        std::mutex m_mutex;
+        std::vector<char*> m_blocks;
+      };
+      struct LocalCache : private boost::noncopyable {
+        BufferPool* m_pool;
+        LocalCache** m_handle;
+        bool* m_isReleased;
+        std::array<std::vector<char*>, CLASS_COUNT> m_blocks;
+        Counters m_counters;
+
+        LocalCache(BufferPool& pool, LocalCache*& handle, bool& isReleased);
+        ~LocalCache();
+      };
+      std::atomic<bool> m_isEnabled;
+      std::array<FreeList, CLASS_COUNT> m_freeLists;
+      mutable std::mutex m_mutex;
+      std::vector<LocalCache*> m_caches;
+      Counters m_releasedCounters;
+
+      BufferPool();
+      static std::size_t GetSizeClass(std::size_t size);
+      static std::size_t GetLocalCapacity(std::size_t sizeClass);
+      static std::size_t GetGlobalCapacity(std::size_t sizeClass);
+      static void Increment(std::atomic<std::uint64_t>& counter);
+      static char* AllocateBlock(std::size_t size, std::size_t sizeClass);
+      LocalCache* FindLocalCache();
+      void Refill(LocalCache& cache, std::size_t sizeClass);
+      void Spill(std::vector<char*>& blocks, std::size_t sizeClass,
+        std::size_t count);
+  };
+
+  inline BufferPool::Counters::Counters()
+    : m_allocations(0),
+      m_deallocations(0),
+      m_localHits(0),
+      m_globalHits(0),
+      m_misses(0) {}
+
+  inline void BufferPool::Counters::Add(Statistics& statistics) const {
+    statistics.m_allocations += m_allocations.load(std::memory_order_relaxed);
+    statistics.m_deallocations +=
+      m_deallocations.load(std::memory_order_relaxed);
+    statistics.m_localHits += m_localHits.load(std::memory_order_relaxed);
+    statistics.m_globalHits += m_globalHits.load(std::memory_order_relaxed);
+    statistics.m_misses += m_misses.load(std::memory_order_relaxed);
+  }
+
+  inline BufferPool::LocalCache::LocalCache(BufferPool& pool,
+      LocalCache*& handle, bool& isReleased)
+      : m_pool(&pool),
+        m_handle(&handle),
+        m_isReleased(&isReleased) {
+    auto lock = std::lock_guard(m_pool->m_mutex);
+    m_pool->m_caches.push_back(this);
+  }
+
+  inline BufferPool::LocalCache::~LocalCache() {
+    *m_handle = nullptr;
+    *m_isReleased = true;
+    for(auto i = std::size_t(0); i < CLASS_COUNT; ++i) {
+      m_pool->Spill(m_blocks[i], i, m_blocks[i].size());
+    }
+    auto lock = std::lock_guard(m_pool->m_mutex);
+    m_pool->m_caches.erase(std::find(m_pool->m_caches.begin(),
+      m_pool->m_caches.end(), this));
+    auto statistics = Statistics();
+    m_counters.Add(statistics);
+    m_pool->m_releasedCounters.m_allocations += statistics.m_allocations;
+    m_pool->m_releasedCounters.m_deallocations += statistics.m_deallocations;
+    m_pool->m_releasedCounters.m_localHits += statistics.m_localHits;
+    m_pool->m_releasedCounters.m_globalHits += statistics.m_globalHits;
+    m_pool->m_releasedCounters.m_misses += statistics.m_misses;
+  }
+
+  inline BufferPool& BufferPool::GetInstance() {
+
+    // Never destroyed so that blocks can be released by threads and static
+    // objects that outlive it.
+    static auto pool = new BufferPool();
+    return *pool;
+  }
+
+  inline std::size_t BufferPool::GetBlockSize(std::size_t size) {
+    auto blockSize = MINIMUM_BLOCK_SIZE;
+    while(blockSize < size) {
+      if(blockSize > std::numeric_limits<std::size_t>::max() / 2) {
+        BOOST_THROW_EXCEPTION(std::bad_alloc());
+      }
+      blockSize *= 2;
+    }
+    return blockSize;
+  }
+
+  inline bool BufferPool::IsEnabled() const {
+    return m_isEnabled.load(std::memory_order_relaxed);
+  }
+
+  inline void BufferPool::SetEnabled(bool isEnabled) {
+    m_isEnabled.store(isEnabled, std::memory_order_relaxed);
+  }
+
+  inline char* BufferPool::Allocate(std::size_t size) {
+    auto sizeClass = GetSizeClass(size);
+    auto cache = FindLocalCache();
+    if(!cache) {
+      m_releasedCounters.m_allocations.fetch_add(1, std::memory_order_relaxed);
+      m_releasedCounters.m_misses.fetch_add(1, std::memory_order_relaxed);
+      return AllocateBlock(size, sizeClass);
+    }
+    Increment(cache->m_counters.m_allocations);
+    if(sizeClass < CLASS_COUNT && IsEnabled()) {
+      auto& blocks = cache->m_blocks[sizeClass];
+      if(!blocks.empty()) {
+        Increment(cache->m_counters.m_localHits);
+      } else {
+        Refill(*cache, sizeClass);
+      }
+      if(!blocks.empty()) {
+        auto block = blocks.back();
+        blocks.pop_back();
+        return block;
+      }
+    }
+    Increment(cache->m_counters.m_misses);
+    return AllocateBlock(size, sizeClass);
+  }
+
+  inline void BufferPool::Deallocate(char* block, std::size_t size) {
+    if(!block) {
+      return;
+    }
+    auto sizeClass = GetSizeClass(size);
+    auto cache = FindLocalCache();
+    if(!cache) {
+      m_releasedCounters.m_deallocations.fetch_add(1,
+        std::memory_order_relaxed);
+      ::operator delete(block);
+      return;
+    }
+    Increment(cache->m_counters.m_deallocations);
+    if(sizeClass >= CLASS_COUNT || !IsEnabled()) {
+      ::operator delete(block);
+      return;
+    }
+    auto& blocks = cache->m_blocks[sizeClass];
+    blocks.push_back(block);
+    auto capacity = GetLocalCapacity(sizeClass);
+    if(blocks.size() > capacity) {
+      Spill(blocks, sizeClass, blocks.size() - capacity / 2);
+    }
+  }
+
+  inline BufferPool::Statistics BufferPool::GetStatistics() const {
+    auto statistics = Statistics();
+    auto lock = std::lock_guard(m_mutex);
+    m_releasedCounters.Add(statistics);
+    for(auto& cache : m_caches) {
+      cache->m_counters.Add(statistics);
+    }
+    return statistics;
+  }
+
+  inline BufferPool::BufferPool()
+    : m_isEnabled(true) {}
+
+  inline std::size_t BufferPool::GetSizeClass(std::size_t size) {
+    auto sizeClass = std::size_t(0);
+    auto blockSize = MINIMUM_BLOCK_SIZE;
+    while(blockSize < size && sizeClass < CLASS_COUNT) {
+      blockSize *= 2;
+      ++sizeClass;
+    }
+    return sizeClass;
+  }
+
+  inline std::size_t BufferPool::GetLocalCapacity(std::size_t sizeClass) {
+    return std::max<std::size_t>(1, std::min(LOCAL_CACHE_BLOCKS,
+      (LOCAL_CACHE_BYTES / MINIMUM_BLOCK_SIZE) >> sizeClass));
+  }
+
+  inline std::size_t BufferPool::GetGlobalCapacity(std::size_t sizeClass) {
+    return (GLOBAL_CACHE_BYTES / MINIMUM_BLOCK_SIZE) >> sizeClass;
+  }
+
+  inline void BufferPool::Increment(std::atomic<std::uint64_t>& counter) {
+
+    // Only the owning thread writes to its counters, avoiding a locked
+    // read-modify-write.
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  }
+
+  inline char* BufferPool::AllocateBlock(std::size_t size,
+      std::size_t sizeClass) {
+    if(sizeClass < CLASS_COUNT) {
+      return static_cast<char*>(::operator new(
+        MINIMUM_BLOCK_SIZE << sizeClass));
+    }
+    return static_cast<char*>(::operator new(size));
+  }
+
+  inline BufferPool::LocalCache* BufferPool::FindLocalCache() {
+
+    // The handle is trivially constructed so that the common path avoids the
+    // initialization check of a thread_local object.
+    static thread_local LocalCache* handle = nullptr;
+    static thread_local auto isReleased = false;
+    if(handle || isReleased) {
+      return handle;
+    }
+    static thread_local auto cache = LocalCache(*this, handle, isReleased);
+    handle = &cache;
+    return handle;
+  }
+
+  inline void BufferPool::Refill(LocalCache& cache, std::size_t sizeClass) {
+    auto& freeList = m_freeLists[sizeClass];
+    auto& blocks = cache.m_blocks[sizeClass];
+    {
+      auto lock = std::lock_guard(freeList.m_mutex);
+      auto count = std::min(freeList.m_blocks.size(),
+        (GetLocalCapacity(sizeClass) + 1) / 2);
+      blocks.insert(blocks.end(), freeList.m_blocks.end() - count,
+        freeList.m_blocks.end());
+      freeList.m_blocks.resize(freeList.m_blocks.size() - count);
+    }
+    if(!blocks.empty()) {
+      Increment(cache.m_counters.m_globalHits);
+    }
+  }
+
+  inline void BufferPool::Spill(std::vector<char*>& blocks,
+      std::size_t sizeClass, std::size_t count) {
+    auto& freeList = m_freeLists[sizeClass];
+    auto released = std::vector<char*>();
+    {
+      auto lock = std::lock_guard(freeList.m_mutex);
+      auto capacity = GetGlobalCapacity(sizeClass);
+      for(auto i = std::size_t(0); i < count; ++i) {
+        if(freeList.m_blocks.size() < capacity) {
+          freeList.m_blocks.push_back(blocks.back());
+        } else {
+          released.push_back(blocks.back());
+        }
+        blocks.pop_back();
+      }
+    }
+    for(auto block : released) {
+      ::operator delete(block);
+    }
+  }
+}
+}
+
+#endif
@@ -0,0 +1,517 @@
+#ifndef BEAM_CHAINED_BUFFER_HPP
+#define BEAM_CHAINED_BUFFER_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <type_traits>
+#include <utility>
+#include "Beam/IO/Buffer.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class ChainedBuffer
+      \brief Implements the Buffer Concept as a chain of SharedBuffer segments.
+      \details Appending or prepending a large SharedBuffer shares its storage
+               rather than copying it, and Writers that support vectored I/O
+               can send each segment directly. The segments are only
+               coalesced into contiguous storage when GetData or
+               GetMutableData is called.
+   */
+  class ChainedBuffer {
+    public:
+
+      //! The smallest Buffer that is shared rather than copied.
+      static constexpr std::size_t MINIMUM_SHARE_SIZE = 512;
+
+      //! The capacity of the segments allocated to store copied data.
+      static constexpr std::size_t SEGMENT_SIZE = 4096;
+
+      //! Constructs an empty ChainedBuffer.
+      ChainedBuffer();
+
+      //! Constructs a ChainedBuffer sharing a SharedBuffer's storage.
+      /*!
+        \param buffer The SharedBuffer to share.
+      */
+      explicit ChainedBuffer(const SharedBuffer& buffer);
+
+      ChainedBuffer(const void* data, std::size_t size);
+
+      template<typename BufferType>
+      ChainedBuffer(const BufferType& buffer, typename std::enable_if<
+        ImplementsConcept<BufferType, Buffer>::value &&
+        !std::is_same<BufferType, ChainedBuffer>::value &&
+        !std::is_same<BufferType, SharedBuffer>::value>::type* = 0);
+
+      ChainedBuffer(const ChainedBuffer& buffer) = default;
+
+      ChainedBuffer(ChainedBuffer&& buffer);
+
+      ChainedBuffer& operator =(const ChainedBuffer& rhs) = default;
+
+      template<typename BufferType>
+      typename std::enable_if<ImplementsConcept<BufferType, Buffer>::value &&
+        !std::is_same<BufferType, ChainedBuffer>::value, ChainedBuffer&>::type
+        operator =(const BufferType& rhs);
+
+      ChainedBuffer& operator =(ChainedBuffer&& rhs);
+
+      bool IsEmpty() const;
+
+      void Grow(std::size_t size);
+
+      void Shrink(std::size_t size);
+
+      void ShrinkFront(std::size_t size);
+
+      void Reserve(std::size_t size);
+
+      void Write(std::size_t index, const void* source, std::size_t size);
+
+      template<typename T>
+      void Write(std::size_t index, T value);
+
+      //! Appends another ChainedBuffer, sharing its large segments.
+      /*!
+        \param buffer The ChainedBuffer to append.
+      */
+      void Append(const ChainedBuffer& buffer);
+
+      //! Appends a SharedBuffer, sharing its storage if it is large.
+      /*!
+        \param buffer The SharedBuffer to append.
+      */
+      void Append(const SharedBuffer& buffer);
+
+      template<typename BufferType>
+      typename std::enable_if<ImplementsConcept<BufferType,
+        IO::Buffer>::value>::type Append(const BufferType& buffer);
+
+      void Append(const void* data, std::size_t size);
+
+      template<typename T>
+      typename std::enable_if<!ImplementsConcept<T, IO::Buffer>::value>::type
+        Append(T value);
+
+      //! Inserts another ChainedBuffer at the front of this one.
+      /*!
+        \param buffer The ChainedBuffer to prepend.
+      */
+      void Prepend(const ChainedBuffer& buffer);
+
+      //! Inserts a SharedBuffer at the front of this one without copying it.
+      /*!
+        \param buffer The SharedBuffer to prepend.
+      */
+      void Prepend(const SharedBuffer& buffer);
+
+      //! Inserts raw data at the front of this Buffer.
+      /*!
+        \param data The data to prepend.
+        \param size The size of the data to prepend.
+      */
+      void Prepend(const void* data, std::size_t size);
+
+      //! Inserts a raw binary value at the front of this Buffer.
+      /*!
+        \param value The value to prepend.
+      */
+      template<typename T>
+      typename std::enable_if<!ImplementsConcept<T, IO::Buffer>::value>::type
+        Prepend(T value);
+
+      void Reset();
+
+      const char* GetData() const;
+
+      char* GetMutableData();
+
+      std::size_t GetSize() const;
+
+      template<typename T>
+      void Extract(std::size_t index, Out<T> value) const;
+
+      template<typename T>
+      T Extract(std::size_t index) const;
+
+      //! Returns the number of segments in this Buffer.
+      std::size_t GetSegmentCount() const;
+
+      //! Calls a function on each segment in order.
+      /*!
+        \param f The function to call with the data and size of each segment.
+      */
+      template<typename F>
+      void ForEachSegment(F&& f) const;
+
+      //! Copies a range of this Buffer into contiguous memory.
+      /*!
+        \param index The index of the first byte to copy.
+        \param destination Where to copy the bytes to.
+        \param size The number of bytes to copy.
+      */
+      void CopyTo(std::size_t index, void* destination, std::size_t size) const;
+
+    private:
+      struct Segment {
+        SharedBuffer m_buffer;
+        std::size_t m_offset;
+        std::size_t m_size;
+        bool m_isOwned;
+
+        Segment(SharedBuffer buffer, std::size_t offset, std::size_t size,
+          bool isOwned);
+        const char* GetData() const;
+        bool IsAppendable(std::size_t size) const;
+      };
+      mutable std::deque<Segment> m_segments;
+      std::size_t m_size;
+
+      void Coalesce() const;
+      Segment& AllocateSegment(std::size_t size);
+  };
+}
+
+  template<>
+  struct ImplementsConcept<IO::ChainedBuffer, IO::Buffer> : std::true_type {};
+
+namespace IO {
+
+  inline ChainedBuffer::Segment::Segment(SharedBuffer buffer,
+    std::size_t offset, std::size_t size, bool isOwned)
+    : m_buffer(std::move(buffer)),
+      m_offset(offset),
+      m_size(size),
+      m_isOwned(isOwned) {}
+
+  inline const char* ChainedBuffer::Segment::GetData() const {
+    return m_buffer.GetData() + m_offset;
+  }
+
+  inline bool ChainedBuffer::Segment::IsAppendable(std::size_t size) const {
+    return m_isOwned && m_offset + m_size == m_buffer.GetSize() &&
+      m_buffer.GetSize() + size <= std::max(SEGMENT_SIZE, m_size);
+  }
+
+  inline ChainedBuffer::ChainedBuffer()
+    : m_size(0) {}
+
+  inline ChainedBuffer::ChainedBuffer(const SharedBuffer& buffer)
+      : m_size(0) {
+    if(!buffer.IsEmpty()) {
+      m_segments.emplace_back(buffer, 0, buffer.GetSize(), false);
+      m_size = buffer.GetSize();
+    }
+  }
+
+  inline ChainedBuffer::ChainedBuffer(const void* data, std::size_t size)
+      : m_size(0) {
+    Append(data, size);
+  }
+
+  template<typename BufferType>
+  ChainedBuffer::ChainedBuffer(const BufferType& buffer, typename
+      std::enable_if<ImplementsConcept<BufferType, Buffer>::value &&
+      !std::is_same<BufferType, ChainedBuffer>::value &&
+      !std::is_same<BufferType, SharedBuffer>::value>::type*)
+      : m_size(0) {
+    Append(buffer);
+  }
+
+  inline ChainedBuffer::ChainedBuffer(ChainedBuffer&& buffer)
+      : m_segments(std::move(buffer.m_segments)),
+        m_size(std::exchange(buffer.m_size, 0)) {
+    buffer.m_segments.clear();
+  }
+
+  template<typename BufferType>
+  typename std::enable_if<ImplementsConcept<BufferType, Buffer>::value &&
+      !std::is_same<BufferType, ChainedBuffer>::value, ChainedBuffer&>::type
+      ChainedBuffer::operator =(const BufferType& rhs) {
+    Reset();
+    Append(rhs);
+    return *this;
+  }
+
+  inline ChainedBuffer& ChainedBuffer::operator =(ChainedBuffer&& rhs) {
+    m_segments = std::move(rhs.m_segments);
+    m_size = std::exchange(rhs.m_size, 0);
+    rhs.m_segments.clear();
+    return *this;
+  }
+
+  inline bool ChainedBuffer::IsEmpty() const {
+    return m_size == 0;
+  }
+
+  inline void ChainedBuffer::Grow(std::size_t size) {
+    if(size == 0) {
+      return;
+    }
+    if(!m_segments.empty() && m_segments.back().IsAppendable(size)) {
+      auto& tail = m_segments.back();
+      tail.m_buffer.Grow(size);
+      tail.m_size += size;
+    } else {
+      auto& tail = AllocateSegment(size);
+      tail.m_buffer.Grow(size);
+      tail.m_size = size;
+    }
+    m_size += size;
+  }
+
+  inline void ChainedBuffer::Shrink(std::size_t size) {
+    if(size >= m_size) {
+      Reset();
+      return;
+    }
+    m_size -= size;
+    while(size != 0) {
+      auto& tail = m_segments.back();
+      if(tail.m_size > size) {
+        tail.m_size -= size;
+        if(tail.m_isOwned) {
+          tail.m_buffer.Shrink(size);
+        }
+        return;
+      }
+      size -= tail.m_size;
+      m_segments.pop_back();
+    }
+  }
+
+  inline void ChainedBuffer::ShrinkFront(std::size_t size) {
+    if(size >= m_size) {
+      Reset();
+      return;
+    }
+    m_size -= size;
+    while(size != 0) {
+      auto& head = m_segments.front();
+      if(head.m_size > size) {
+        head.m_offset += size;
+        head.m_size -= size;
+        return;
+      }
+      size -= head.m_size;
+      m_segments.pop_front();
+    }
+  }
+
+  inline void ChainedBuffer::Reserve(std::size_t size) {
+    if(size > m_size) {
+      Grow(size - m_size);
+    }
+  }
+
+  inline void ChainedBuffer::Write(std::size_t index, const void* source,
+      std::size_t size) {
+    assert(index <= m_size);
+    if(index + size > m_size) {
+      Grow(index + size - m_size);
+    }
+    auto data = static_cast<const char*>(source);
+    for(auto& segment : m_segments) {
+      if(size == 0) {
+        break;
+      }
+      if(index >= segment.m_size) {
+        index -= segment.m_size;
+        continue;
+      }
+      auto count = std::min(size, segment.m_size - index);
+      std::memcpy(segment.m_buffer.GetMutableData() + segment.m_offset + index,
+        data, count);
+      data += count;
+      size -= count;
+      index = 0;
+    }
+  }
+
+  template<typename T>
+  void ChainedBuffer::Write(std::size_t index, T value) {
+    Write(index, &value, sizeof(T));
+  }
+
+  inline void ChainedBuffer::Append(const ChainedBuffer& buffer) {
+    if(&buffer == this) {
+      auto copy = buffer;
+      Append(copy);
+      return;
+    }
+    for(auto& segment : buffer.m_segments) {
+      if(segment.m_size < MINIMUM_SHARE_SIZE) {
+        Append(segment.GetData(), segment.m_size);
+      } else {
+        m_segments.emplace_back(segment.m_buffer, segment.m_offset,
+          segment.m_size, false);
+        m_size += segment.m_size;
+      }
+    }
+  }
+
+  inline void ChainedBuffer::Append(const SharedBuffer& buffer) {
+    if(buffer.GetSize() < MINIMUM_SHARE_SIZE) {
+      Append(buffer.GetData(), buffer.GetSize());
+      return;
+    }
+    m_segments.emplace_back(buffer, 0, buffer.GetSize(), false);
+    m_size += buffer.GetSize();
+  }
+
+  template<typename BufferType>
+  typename std::enable_if<ImplementsConcept<BufferType,
+      IO::Buffer>::value>::type ChainedBuffer::Append(
+      const BufferType& buffer) {
+    Append(buffer.GetData(), buffer.GetSize());
+  }
+
+  inline void ChainedBuffer::Append(const void* data, std::size_t size) {
+    if(size == 0) {
+      return;
+    }
+    auto tail = [&] () -> Segment* {
+      if(!m_segments.empty() && m_segments.back().IsAppendable(size)) {
+        return &m_segments.back();
+      }
+      return &AllocateSegment(size);
+    }();
+    tail->m_buffer.Append(data, size);
+    tail->m_size += size;
+    m_size += size;
+  }
+
+  template<typename T>
+  typename std::enable_if<!ImplementsConcept<T, IO::Buffer>::value>::type
+      ChainedBuffer::Append(T value) {
+    Append(&value, sizeof(T));
+  }
+
+  inline void ChainedBuffer::Prepend(const ChainedBuffer& buffer) {
+    if(&buffer == this) {
+      auto copy = buffer;
+      Prepend(copy);
+      return;
+    }
+    for(auto i = buffer.m_segments.rbegin(); i != buffer.m_segments.rend();
+        ++i) {
+      m_segments.emplace_front(i->m_buffer, i->m_offset, i->m_size, false);
+      m_size += i->m_size;
+    }
+  }
+
+  inline void ChainedBuffer::Prepend(const SharedBuffer& buffer) {
+    if(buffer.IsEmpty()) {
+      return;
+    }
+    m_segments.emplace_front(buffer, 0, buffer.GetSize(), false);
+    m_size += buffer.GetSize();
+  }
+
+  inline void ChainedBuffer::Prepend(const void* data, std::size_t size) {
+    if(size == 0) {
+      return;
+    }
+    m_segments.emplace_front(SharedBuffer(data, size), 0, size, true);
+    m_size += size;
+  }
+
+  template<typename T>
+  typename std::enable_if<!ImplementsConcept<T, IO::Buffer>::value>::type
+      ChainedBuffer::Prepend(T value) {
+    Prepend(&value, sizeof(T));
+  }
+
+  inline void ChainedBuffer::Reset() {
+    m_segments.clear();
+    m_size = 0;
+  }
+
+  inline const char* ChainedBuffer::GetData() const {
+    if(m_segments.empty()) {
+      return nullptr;
+    }
+    Coalesce();
+    return m_segments.front().GetData();
+  }
+
+  inline char* ChainedBuffer::GetMutableData() {
+    if(m_segments.empty()) {
+      return nullptr;
+    }
+    Coalesce();
+    auto& head = m_segments.front();
+    return head.m_buffer.GetMutableData() + head.m_offset;
+  }
+
+  inline std::size_t ChainedBuffer::GetSize() const {
+    return m_size;
+  }
+
+  template<typename T>
+  void ChainedBuffer::Extract(std::size_t index, Out<T> value) const {
+    CopyTo(index, &(*value), sizeof(T));
+  }
+
+  template<typename T>
+  T ChainedBuffer::Extract(std::size_t index) const {
+    T value;
+    CopyTo(index, &value, sizeof(T));
+    return value;
+  }
+
+  inline std::size_t ChainedBuffer::GetSegmentCount() const {
+    return m_segments.size();
+  }
+
+  template<typename F>
+  void ChainedBuffer::ForEachSegment(F&& f) const {
+    for(auto& segment : m_segments) {
+      f(segment.GetData(), segment.m_size);
+    }
+  }
+
+  inline void ChainedBuffer::CopyTo(std::size_t index, void* destination,
+      std::size_t size) const {
+    assert(index + size <= m_size);
+    auto data = static_cast<char*>(destination);
+    for(auto& segment : m_segments) {
+      if(size == 0) {
+        break;
+      }
+      if(index >= segment.m_size) {
+        index -= segment.m_size;
+        continue;
+      }
+      auto count = std::min(size, segment.m_size - index);
+      std::memcpy(data, segment.GetData() + index, count);
+      data += count;
+      size -= count;
+      index = 0;
+    }
+  }
+
+  inline void ChainedBuffer::Coalesce() const {
+    if(m_segments.size() <= 1) {
+      return;
+    }
+    auto buffer = SharedBuffer(m_size);
+    CopyTo(0, buffer.GetMutableData(), m_size);
+    m_segments.clear();
+    m_segments.emplace_back(std::move(buffer), 0, m_size, true);
+  }
+
+  inline ChainedBuffer::Segment& ChainedBuffer::AllocateSegment(
+      std::size_t size) {
+    auto buffer = SharedBuffer(std::max(size, SEGMENT_SIZE));
+    buffer.Reset();
+    return m_segments.emplace_back(std::move(buffer), 0, 0, true);
+  }
+}
+}
+
+#endif
@@ -5,6 +5,7 @@ namespace Beam {
 namespace IO {
   template<typename DestinationWriterType> class AsyncWriter;
   struct Buffer;
+  class BufferPool;
   template<typename BufferType> class BufferView;
   template<typename IStreamType> class BasicIStreamReader;
   template<typename OStreamType> class BasicOStreamWriter;
@@ -13,10 +14,14 @@ namespace IO {
   struct ChannelIdentifier;
   template<typename ServerConnectionType, typename ChannelType>
     class ChannelAdapterServerConnection;
+  class ChainedBuffer;
   class EndOfFileException;
   class IOException;
   template<typename BufferType> class LocalClientChannel;
   template<typename BufferType> class LocalConnection;
+  template<typename BufferType> class LocalPipe;
+  template<typename BufferType> class LocalPipeReader;
+  template<typename BufferType> class LocalPipeWriter;
   template<typename BufferType> class LocalServerChannel;
   template<typename BufferType> class LocalServerChannelConnection;
   template<typename BufferType> class LocalServerConnection;
@@ -31,6 +36,13 @@ namespace IO {
   template<typename BufferType, typename SourceReaderType> class QueuedReader;
   template<typename BufferType> struct Reader;
   class SharedBuffer;
+  class SharedMemoryChannel;
+  class SharedMemoryConnection;
+  class SharedMemoryReader;
+  class SharedMemoryRing;
+  class SharedMemorySegment;
+  class SharedMemoryServerConnection;
+  class SharedMemoryWriter;
   template<typename SourceReaderType> class SizeDeclarativeReader;
   template<typename DestinationWriterType> class SizeDeclarativeWriter;
   template<std::size_t> class StaticBuffer;
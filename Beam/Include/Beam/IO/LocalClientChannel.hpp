@@ -7,8 +7,8 @@
 #include "Beam/IO/LocalConnection.hpp"
 #include "Beam/IO/LocalServerChannel.hpp"
 #include "Beam/IO/NamedChannelIdentifier.hpp"
-#include "Beam/IO/PipedReader.hpp"
-#include "Beam/IO/PipedWriter.hpp"
+#include "Beam/IO/LocalPipeReader.hpp"
+#include "Beam/IO/LocalPipeWriter.hpp"
 #include "Beam/Pointers/Ref.hpp"
 
 namespace Beam {
@@ -30,8 +30,8 @@ namespace IO {
 
       using Identifier = NamedChannelIdentifier;
       using Connection = LocalConnection<Buffer>;
-      using Reader = PipedReader<Buffer>;
-      using Writer = PipedWriter<Buffer>;
+      using Reader = LocalPipeReader<Buffer>;
+      using Writer = LocalPipeWriter<Buffer>;
 
       //! Constructs a LocalClientChannel.
       /*!
@@ -5,6 +5,7 @@
 #include "Beam/IO/Connection.hpp"
 #include "Beam/IO/IO.hpp"
 #include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalPipeWriter.hpp"
 #include "Beam/IO/LocalServerConnection.hpp"
 #include "Beam/Pointers/Ref.hpp"
 #include "Beam/Queues/Queue.hpp"
@@ -33,7 +34,7 @@ namespace IO {
       */
       LocalConnection(const std::shared_ptr<Queue<
         typename LocalServerConnection::PendingChannelEntry*>>& pendingChannels,
-        const std::shared_ptr<PipedWriter<Buffer>>& writer);
+        const std::shared_ptr<LocalPipeWriter<Buffer>>& writer);
 
       ~LocalConnection();
 
@@ -49,15 +50,15 @@ namespace IO {
         typename LocalServerConnection::PendingChannelEntry;
       IO::LocalClientChannel<Buffer>* m_channel;
       std::shared_ptr<Queue<PendingChannelEntry*>> m_pendingChannels;
-      std::shared_ptr<PipedWriter<Buffer>> m_writer;
-      std::shared_ptr<PipedWriter<Buffer>> m_endpointWriter;
+      std::shared_ptr<LocalPipeWriter<Buffer>> m_writer;
+      std::shared_ptr<LocalPipeWriter<Buffer>> m_endpointWriter;
       bool m_isOpen;
   };
 
   template<typename BufferType>
   LocalConnection<BufferType>::LocalConnection(const std::shared_ptr<
       Queue<PendingChannelEntry*>>& pendingChannels,
-      const std::shared_ptr<PipedWriter<Buffer>>& writer)
+      const std::shared_ptr<LocalPipeWriter<Buffer>>& writer)
       : m_channel(nullptr),
         m_pendingChannels(pendingChannels),
         m_writer(writer),
@@ -0,0 +1,236 @@
+#ifndef BEAM_LOCAL_PIPE_HPP
+#define BEAM_LOCAL_PIPE_HPP
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include "Beam/IO/IO.hpp"
+#include "Beam/Pointers/Out.hpp"
+#include "Beam/Routines/Routine.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class LocalPipe
+      \brief Passes Buffers from the writers of a local Channel to its reader.
+      \details Buffers are stored in a linked list of fixed size blocks that
+               the writers append to and the reader consumes from without
+               taking a lock. A bounded single producer ring isn't used since
+               a Channel's Writer may be shared by several Routines and a
+               write must never block or fail on a full pipe. Instead writers
+               serialize among themselves on a flag held only while a slot is
+               filled, and only touch the reader when it is suspended, in
+               which case they resume it directly.
+      \tparam BufferType The type of Buffer passed through the pipe.
+   */
+  template<typename BufferType>
+  class LocalPipe : private boost::noncopyable {
+    public:
+
+      //! The type of Buffer passed through the pipe.
+      using Buffer = BufferType;
+
+      //! Constructs an empty LocalPipe.
+      LocalPipe();
+
+      ~LocalPipe();
+
+      //! Returns <code>true</code> iff a Buffer is available to pop.
+      bool IsAvailable() const;
+
+      //! Appends a Buffer to the pipe.
+      /*!
+        \param buffer The Buffer to append.
+      */
+      void Push(Buffer buffer);
+
+      //! Removes the next Buffer, suspending the current Routine until one is
+      //! available, only one Routine may pop at a time.
+      /*!
+        \param buffer Stores the Buffer removed.
+      */
+      void Pop(Out<Buffer> buffer);
+
+      //! Breaks the pipe, Buffers already pushed can still be popped.
+      /*!
+        \param e The exception thrown once the pipe is empty.
+      */
+      void Break(const std::exception_ptr& e);
+
+    private:
+      static constexpr auto BLOCK_SIZE = std::size_t(64);
+      struct Block {
+        Buffer m_buffers[BLOCK_SIZE];
+        Block* m_next;
+
+        Block();
+      };
+      alignas(64) std::atomic<std::uint64_t> m_pushCount;
+      std::atomic<bool> m_isPushing;
+      Block* m_tail;
+      std::size_t m_tailIndex;
+      std::exception_ptr m_breakException;
+      std::atomic<bool> m_isBroken;
+      alignas(64) std::uint64_t m_popCount;
+      Block* m_head;
+      std::size_t m_headIndex;
+      std::atomic<Block*> m_spare;
+      alignas(64) std::atomic<bool> m_isReaderWaiting;
+      boost::mutex m_mutex;
+      Routines::Routine* m_reader;
+
+      void Lock();
+      void Unlock();
+      bool TryPop(Out<Buffer> buffer);
+      void ResumeReader();
+  };
+
+  template<typename BufferType>
+  LocalPipe<BufferType>::Block::Block()
+    : m_next(nullptr) {}
+
+  template<typename BufferType>
+  LocalPipe<BufferType>::LocalPipe()
+      : m_pushCount(0),
+        m_isPushing(false),
+        m_tail(new Block()),
+        m_tailIndex(0),
+        m_isBroken(false),
+        m_popCount(0),
+        m_head(m_tail),
+        m_headIndex(0),
+        m_spare(nullptr),
+        m_isReaderWaiting(false),
+        m_reader(nullptr) {}
+
+  template<typename BufferType>
+  LocalPipe<BufferType>::~LocalPipe() {
+    while(m_head != nullptr) {
+      auto next = m_head->m_next;
+      delete m_head;
+      m_head = next;
+    }
+    delete m_spare.load();
+  }
+
+  template<typename BufferType>
+  bool LocalPipe<BufferType>::IsAvailable() const {
+    return m_popCount != m_pushCount.load(std::memory_order_acquire);
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::Push(Buffer buffer) {
+    Lock();
+    if(m_isBroken.load(std::memory_order_relaxed)) {
+      auto exception = m_breakException;
+      Unlock();
+      std::rethrow_exception(exception);
+    }
+    if(m_tailIndex == BLOCK_SIZE) {
+      auto block = m_spare.exchange(nullptr, std::memory_order_acquire);
+      if(block == nullptr) {
+        block = new Block();
+      } else {
+        block->m_next = nullptr;
+      }
+      m_tail->m_next = block;
+      m_tail = block;
+      m_tailIndex = 0;
+    }
+    m_tail->m_buffers[m_tailIndex] = std::move(buffer);
+    ++m_tailIndex;
+    m_pushCount.fetch_add(1, std::memory_order_release);
+    Unlock();
+
+    // Pairs with the fence in Pop, either the reader sees the new count or
+    // this writer sees that the reader is waiting.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_isReaderWaiting.load(std::memory_order_relaxed)) {
+      ResumeReader();
+    }
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::Pop(Out<Buffer> buffer) {
+    while(true) {
+      if(TryPop(Store(buffer))) {
+        return;
+      }
+      if(m_isBroken.load(std::memory_order_acquire)) {
+        if(TryPop(Store(buffer))) {
+          return;
+        }
+        std::rethrow_exception(m_breakException);
+      }
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      m_isReaderWaiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(IsAvailable() || m_isBroken.load(std::memory_order_acquire)) {
+        m_isReaderWaiting.store(false, std::memory_order_relaxed);
+        continue;
+      }
+      Routines::Suspend(Store(m_reader), lock);
+    }
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::Break(const std::exception_ptr& e) {
+    Lock();
+    if(m_isBroken.load(std::memory_order_relaxed)) {
+      Unlock();
+      return;
+    }
+    m_breakException = e;
+    m_isBroken.store(true, std::memory_order_release);
+    Unlock();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_isReaderWaiting.load(std::memory_order_relaxed)) {
+      ResumeReader();
+    }
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::Lock() {
+    while(m_isPushing.exchange(true, std::memory_order_acquire)) {
+      while(m_isPushing.load(std::memory_order_relaxed)) {
+        boost::this_thread::yield();
+      }
+    }
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::Unlock() {
+    m_isPushing.store(false, std::memory_order_release);
+  }
+
+  template<typename BufferType>
+  bool LocalPipe<BufferType>::TryPop(Out<Buffer> buffer) {
+    if(!IsAvailable()) {
+      return false;
+    }
+    if(m_headIndex == BLOCK_SIZE) {
+      auto block = m_head;
+      m_head = m_head->m_next;
+      m_headIndex = 0;
+      delete m_spare.exchange(block, std::memory_order_release);
+    }
+    auto& slot = m_head->m_buffers[m_headIndex];
+    *buffer = std::move(slot);
+    slot = Buffer();
+    ++m_headIndex;
+    ++m_popCount;
+    return true;
+  }
+
+  template<typename BufferType>
+  void LocalPipe<BufferType>::ResumeReader() {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_isReaderWaiting.store(false, std::memory_order_relaxed);
+    Routines::Resume(m_reader);
+  }
+}
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef BEAM_LOCAL_PIPE_READER_HPP
+#define BEAM_LOCAL_PIPE_READER_HPP
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/LocalPipe.hpp"
+#include "Beam/IO/Reader.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class LocalPipeReader
+      \brief Reads the Buffers written by a LocalPipeWriter.
+      \details A read into an empty Buffer that consumes a whole written
+               Buffer takes it over rather than copying it.
+      \tparam BufferType The type of Buffer to read to.
+   */
+  template<typename BufferType>
+  class LocalPipeReader : private boost::noncopyable {
+    public:
+      using Buffer = BufferType;
+
+      //! Constructs an empty LocalPipeReader.
+      LocalPipeReader();
+
+      ~LocalPipeReader();
+
+      bool IsDataAvailable() const;
+
+      std::size_t Read(Out<Buffer> destination);
+
+      std::size_t Read(char* destination, std::size_t size);
+
+      std::size_t Read(Out<Buffer> destination, std::size_t size);
+
+    private:
+      friend class LocalPipeWriter<Buffer>;
+      std::shared_ptr<LocalPipe<Buffer>> m_pipe;
+      Buffer m_message;
+      std::size_t m_offset;
+
+      void Load();
+  };
+
+  template<typename BufferType>
+  LocalPipeReader<BufferType>::LocalPipeReader()
+    : m_pipe(std::make_shared<LocalPipe<Buffer>>()),
+      m_offset(0) {}
+
+  template<typename BufferType>
+  LocalPipeReader<BufferType>::~LocalPipeReader() {
+    m_pipe->Break(std::make_exception_ptr(EndOfFileException("Pipe broken.")));
+  }
+
+  template<typename BufferType>
+  bool LocalPipeReader<BufferType>::IsDataAvailable() const {
+    return m_offset != m_message.GetSize() || m_pipe->IsAvailable();
+  }
+
+  template<typename BufferType>
+  std::size_t LocalPipeReader<BufferType>::Read(Out<Buffer> destination) {
+    return Read(Store(destination), INT_MAX);
+  }
+
+  template<typename BufferType>
+  std::size_t LocalPipeReader<BufferType>::Read(char* destination,
+      std::size_t size) {
+    Load();
+    auto readSize = std::min(size, m_message.GetSize() - m_offset);
+    std::copy(m_message.GetData() + m_offset,
+      m_message.GetData() + m_offset + readSize, destination);
+    m_offset += readSize;
+    return readSize;
+  }
+
+  template<typename BufferType>
+  std::size_t LocalPipeReader<BufferType>::Read(Out<Buffer> destination,
+      std::size_t size) {
+    Load();
+    auto readSize = std::min(size, m_message.GetSize() - m_offset);
+    if(m_offset == 0 && readSize == m_message.GetSize() &&
+        destination->IsEmpty()) {
+      *destination = std::move(m_message);
+      m_message = Buffer();
+    } else {
+      destination->Append(m_message.GetData() + m_offset, readSize);
+      m_offset += readSize;
+    }
+    return readSize;
+  }
+
+  template<typename BufferType>
+  void LocalPipeReader<BufferType>::Load() {
+    while(m_offset == m_message.GetSize()) {
+      m_offset = 0;
+      m_pipe->Pop(Store(m_message));
+    }
+  }
+}
+
+  template<typename BufferType>
+  struct ImplementsConcept<IO::LocalPipeReader<BufferType>,
+    IO::Reader<BufferType>> : std::true_type {};
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef BEAM_LOCAL_PIPE_WRITER_HPP
+#define BEAM_LOCAL_PIPE_WRITER_HPP
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/LocalPipe.hpp"
+#include "Beam/IO/LocalPipeReader.hpp"
+#include "Beam/IO/Writer.hpp"
+#include "Beam/Pointers/Ref.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class LocalPipeWriter
+      \brief Writes to a LocalPipeReader, passing Buffers to it without
+             copying them.
+      \tparam BufferType The type of Buffer to write.
+   */
+  template<typename BufferType>
+  class LocalPipeWriter : private boost::noncopyable {
+    public:
+      using Buffer = BufferType;
+
+      //! Constructs a LocalPipeWriter.
+      /*!
+        \param destination The LocalPipeReader to connect to.
+      */
+      LocalPipeWriter(Ref<LocalPipeReader<Buffer>> destination);
+
+      ~LocalPipeWriter();
+
+      //! Breaks the pipe.
+      /*!
+        \param e The cause of the break.
+      */
+      void Break(const std::exception_ptr& e);
+
+      //! Breaks the pipe.
+      /*!
+        \param e The cause of the break.
+      */
+      template<typename E>
+      void Break(const E& e);
+
+      //! Breaks the pipe.
+      void Break();
+
+      void Write(const void* data, std::size_t size);
+
+      void Write(const Buffer& data);
+
+    private:
+      std::shared_ptr<LocalPipe<Buffer>> m_pipe;
+  };
+
+  template<typename BufferType>
+  LocalPipeWriter<BufferType>::LocalPipeWriter(
+      Ref<LocalPipeReader<Buffer>> destination)
+      : m_pipe(destination->m_pipe) {}
+
+  template<typename BufferType>
+  LocalPipeWriter<BufferType>::~LocalPipeWriter() {
+    Break();
+  }
+
+  template<typename BufferType>
+  void LocalPipeWriter<BufferType>::Break(const std::exception_ptr& e) {
+    m_pipe->Break(e);
+  }
+
+  template<typename BufferType>
+  template<typename E>
+  void LocalPipeWriter<BufferType>::Break(const E& e) {
+    Break(std::make_exception_ptr(e));
+  }
+
+  template<typename BufferType>
+  void LocalPipeWriter<BufferType>::Break() {
+    Break(EndOfFileException("Pipe broken."));
+  }
+
+  template<typename BufferType>
+  void LocalPipeWriter<BufferType>::Write(const void* data, std::size_t size) {
+    if(size == 0) {
+      return;
+    }
+    m_pipe->Push(Buffer(data, size));
+  }
+
+  template<typename BufferType>
+  void LocalPipeWriter<BufferType>::Write(const Buffer& data) {
+    if(data.IsEmpty()) {
+      return;
+    }
+    m_pipe->Push(data);
+  }
+}
+
+  template<typename BufferType>
+  struct ImplementsConcept<IO::LocalPipeWriter<BufferType>,
+    IO::Writer<BufferType>> : std::true_type {};
+}
+
+#endif
@@ -6,8 +6,8 @@
 #include "Beam/IO/IO.hpp"
 #include "Beam/IO/LocalConnection.hpp"
 #include "Beam/IO/NamedChannelIdentifier.hpp"
-#include "Beam/IO/PipedReader.hpp"
-#include "Beam/IO/PipedWriter.hpp"
+#include "Beam/IO/LocalPipeReader.hpp"
+#include "Beam/IO/LocalPipeWriter.hpp"
 #include "Beam/Pointers/Ref.hpp"
 #include "Beam/Utilities/BeamWorkaround.hpp"
 
@@ -30,8 +30,8 @@ namespace IO {
 
       typedef NamedChannelIdentifier Identifier;
       typedef LocalConnection<Buffer> Connection;
-      typedef PipedReader<Buffer> Reader;
-      typedef PipedWriter<Buffer> Writer;
+      typedef LocalPipeReader<Buffer> Reader;
+      typedef LocalPipeWriter<Buffer> Writer;
 
       //! Constructs a LocalServerChannel.
       /*!
@@ -5,6 +5,7 @@
 #include <boost/shared_array.hpp>
 #include <boost/throw_exception.hpp>
 #include "Beam/IO/Buffer.hpp"
+#include "Beam/IO/BufferPool.hpp"
 #include "Beam/Utilities/BeamWorkaround.hpp"
 
 namespace Beam {
@@ -22,6 +23,66 @@ namespace Details {
     }
     return nextPowerOfTwo;
   }
+
+#if BEAM_USE_BUFFER_POOL
+  template<typename T>
+  struct BufferPoolAllocator {
+    using value_type = T;
+
+    BufferPoolAllocator() = default;
+
+    template<typename U>
+    BufferPoolAllocator(const BufferPoolAllocator<U>&) {}
+
+    T* allocate(std::size_t count) {
+      return reinterpret_cast<T*>(BufferPool::GetInstance().Allocate(
+        BufferPool::GetBlockSize(count * sizeof(T))));
+    }
+
+    void deallocate(T* block, std::size_t count) {
+      BufferPool::GetInstance().Deallocate(reinterpret_cast<char*>(block),
+        BufferPool::GetBlockSize(count * sizeof(T)));
+    }
+
+    template<typename U>
+    bool operator ==(const BufferPoolAllocator<U>&) const {
+      return true;
+    }
+
+    template<typename U>
+    bool operator !=(const BufferPoolAllocator<U>&) const {
+      return false;
+    }
+  };
+
+  struct BufferPoolDeleter {
+    std::size_t m_size;
+
+    void operator ()(char* block) const {
+      BufferPool::GetInstance().Deallocate(block, m_size);
+    }
+  };
+#endif
+
+  inline std::size_t GetSharedBufferCapacity(std::size_t size) {
+#if BEAM_USE_BUFFER_POOL
+    return BufferPool::GetBlockSize(size);
+#else
+    return FindNextPowerOfTwo(size);
+#endif
+  }
+
+  inline boost::shared_array<char> AllocateSharedBuffer(std::size_t size) {
+#if BEAM_USE_BUFFER_POOL
+
+    // The reference count is also taken from the pool so that a buffer costs
+    // no heap allocations once the pool is warm.
+    return boost::shared_array<char>(BufferPool::GetInstance().Allocate(size),
+      BufferPoolDeleter{size}, BufferPoolAllocator<char>());
+#else
+    return boost::shared_array<char>(new char[size]);
+#endif
+  }
 }
 
   /*! \class SharedBuffer
@@ -113,8 +174,8 @@ namespace Details {
 
   inline SharedBuffer::SharedBuffer(std::size_t initialSize)
       : m_size(initialSize),
-        m_availableSize(Details::FindNextPowerOfTwo(initialSize)),
-        m_data(new char[m_availableSize]),
+        m_availableSize(Details::GetSharedBufferCapacity(initialSize)),
+        m_data(Details::AllocateSharedBuffer(m_availableSize)),
         m_front(m_data.get()) {}
 
   inline SharedBuffer::SharedBuffer(const void* data, std::size_t size)
@@ -174,7 +235,7 @@ namespace Details {
 
   inline void SharedBuffer::Grow(std::size_t size) {
     if(m_size + size > m_availableSize) {
-      m_availableSize = Details::FindNextPowerOfTwo(m_size + size);
+      m_availableSize = Details::GetSharedBufferCapacity(m_size + size);
       Reallocate();
     }
     m_size += size;
@@ -191,7 +252,7 @@ namespace Details {
 
   inline void SharedBuffer::ShrinkFront(std::size_t size) {
     assert(size >= 0);
-    auto data = boost::shared_array<char>{new char[m_availableSize]};
+    auto data = Details::AllocateSharedBuffer(m_availableSize);
     std::memcpy(data.get(), m_data.get() + size, m_size - size);
     data.swap(m_data);
     m_size -= size;
@@ -206,7 +267,7 @@ namespace Details {
       std::size_t size) {
     assert(index <= m_size);
     if(m_availableSize < index + size) {
-      m_availableSize = Details::FindNextPowerOfTwo(index + size);
+      m_availableSize = Details::GetSharedBufferCapacity(index + size);
       Reallocate();
     } else if(!m_data.unique()) {
       Reallocate();
@@ -236,7 +297,7 @@ namespace Details {
 
   inline void SharedBuffer::Append(const void* data, std::size_t size) {
     if(m_availableSize < m_size + size) {
-      m_availableSize = Details::FindNextPowerOfTwo(m_size + size);
+      m_availableSize = Details::GetSharedBufferCapacity(m_size + size);
       Reallocate();
     } else if(!m_data.unique()) {
       Reallocate();
@@ -285,7 +346,7 @@ namespace Details {
 
   inline void SharedBuffer::Reallocate() {
     auto oldData = std::move(m_data);
-    m_data.reset(new char[m_availableSize]);
+    m_data = Details::AllocateSharedBuffer(m_availableSize);
     std::memcpy(m_data.get(), oldData.get(), m_size);
     m_front = m_data.get() + (m_front - oldData.get());
   }
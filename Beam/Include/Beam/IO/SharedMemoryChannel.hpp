@@ -0,0 +1,124 @@
+#ifndef BEAM_SHARED_MEMORY_CHANNEL_HPP
+#define BEAM_SHARED_MEMORY_CHANNEL_HPP
+#include <memory>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include "Beam/IO/Channel.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/NamedChannelIdentifier.hpp"
+#include "Beam/IO/SharedMemoryConnection.hpp"
+#include "Beam/IO/SharedMemoryDetails.hpp"
+#include "Beam/IO/SharedMemoryReader.hpp"
+#include "Beam/IO/SharedMemoryWriter.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemoryChannel
+      \brief Implements a Channel between two processes on the same host using
+             a shared memory ring in each direction.
+   */
+  class SharedMemoryChannel : private boost::noncopyable {
+    public:
+      using Identifier = NamedChannelIdentifier;
+      using Connection = SharedMemoryConnection;
+      using Reader = SharedMemoryReader;
+      using Writer = SharedMemoryWriter;
+
+      //! The default number of bytes each ring can hold.
+      static constexpr auto DEFAULT_CAPACITY = std::size_t(1024 * 1024);
+
+      //! The smallest number of bytes a ring can hold.
+      static constexpr auto MINIMUM_CAPACITY = std::size_t(4 * 1024);
+
+      //! Constructs a SharedMemoryChannel.
+      /*!
+        \param name The name of the SharedMemoryServerConnection to connect
+               to.
+      */
+      SharedMemoryChannel(std::string name);
+
+      //! Constructs a SharedMemoryChannel.
+      /*!
+        \param name The name of the SharedMemoryServerConnection to connect
+               to.
+        \param capacity The number of bytes each ring can hold, rounded up to
+               a power of two.
+      */
+      SharedMemoryChannel(std::string name, std::size_t capacity);
+
+      const Identifier& GetIdentifier() const;
+
+      Connection& GetConnection();
+
+      Reader& GetReader();
+
+      Writer& GetWriter();
+
+    private:
+      friend class SharedMemoryServerConnection;
+      std::shared_ptr<Details::SharedMemoryEntry> m_entry;
+      Identifier m_identifier;
+      Connection m_connection;
+      Reader m_reader;
+      Writer m_writer;
+
+      SharedMemoryChannel(const std::string& name,
+        const std::shared_ptr<Details::SharedMemoryEntry>& entry);
+      static std::size_t GetCapacity(std::size_t capacity);
+  };
+
+  inline SharedMemoryChannel::SharedMemoryChannel(std::string name)
+    : SharedMemoryChannel(std::move(name), DEFAULT_CAPACITY) {}
+
+  inline SharedMemoryChannel::SharedMemoryChannel(std::string name,
+      std::size_t capacity)
+      : m_entry(std::make_shared<Details::SharedMemoryEntry>()),
+        m_identifier("client@" + name),
+        m_connection(m_entry, std::move(name), GetCapacity(capacity)),
+        m_reader(m_entry),
+        m_writer(m_entry) {}
+
+  inline const SharedMemoryChannel::Identifier&
+      SharedMemoryChannel::GetIdentifier() const {
+    return m_identifier;
+  }
+
+  inline SharedMemoryChannel::Connection&
+      SharedMemoryChannel::GetConnection() {
+    return m_connection;
+  }
+
+  inline SharedMemoryChannel::Reader& SharedMemoryChannel::GetReader() {
+    return m_reader;
+  }
+
+  inline SharedMemoryChannel::Writer& SharedMemoryChannel::GetWriter() {
+    return m_writer;
+  }
+
+  inline SharedMemoryChannel::SharedMemoryChannel(const std::string& name,
+      const std::shared_ptr<Details::SharedMemoryEntry>& entry)
+      : m_entry(entry),
+        m_identifier(name),
+        m_connection(m_entry),
+        m_reader(m_entry),
+        m_writer(m_entry) {}
+
+  inline std::size_t SharedMemoryChannel::GetCapacity(std::size_t capacity) {
+    auto result = MINIMUM_CAPACITY;
+    while(result < capacity) {
+      result *= 2;
+    }
+    return result;
+  }
+}
+
+  template<>
+  struct ImplementsConcept<IO::SharedMemoryChannel,
+    IO::Channel<IO::SharedMemoryChannel::Identifier,
+    IO::SharedMemoryChannel::Connection, IO::SharedMemoryChannel::Reader,
+    IO::SharedMemoryChannel::Writer>> : std::true_type {};
+}
+
+#endif
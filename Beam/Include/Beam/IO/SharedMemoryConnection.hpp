@@ -0,0 +1,168 @@
+#ifndef BEAM_SHARED_MEMORY_CONNECTION_HPP
+#define BEAM_SHARED_MEMORY_CONNECTION_HPP
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include <unistd.h>
+#include "Beam/IO/ConnectException.hpp"
+#include "Beam/IO/Connection.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/OpenState.hpp"
+#include "Beam/IO/SharedMemoryDetails.hpp"
+#include "Beam/Utilities/ToString.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemoryConnection
+      \brief Implements a Connection to a SharedMemoryServerConnection.
+   */
+  class SharedMemoryConnection : private boost::noncopyable {
+    public:
+      ~SharedMemoryConnection();
+
+      void Open();
+
+      void Close();
+
+    private:
+      friend class SharedMemoryChannel;
+      std::shared_ptr<Details::SharedMemoryEntry> m_entry;
+      std::string m_name;
+      std::size_t m_capacity;
+      OpenState m_openState;
+
+      SharedMemoryConnection(
+        const std::shared_ptr<Details::SharedMemoryEntry>& entry);
+      SharedMemoryConnection(
+        const std::shared_ptr<Details::SharedMemoryEntry>& entry,
+        std::string name, std::size_t capacity);
+      void Connect();
+      void Shutdown();
+  };
+
+  inline SharedMemoryConnection::~SharedMemoryConnection() {
+    Close();
+  }
+
+  inline void SharedMemoryConnection::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      Connect();
+    } catch(const std::exception&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    }
+    m_entry->Open();
+    m_openState.SetOpen();
+  }
+
+  inline void SharedMemoryConnection::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  inline SharedMemoryConnection::SharedMemoryConnection(
+      const std::shared_ptr<Details::SharedMemoryEntry>& entry)
+      : m_entry(entry),
+        m_capacity(0),
+        m_openState(true) {}
+
+  inline SharedMemoryConnection::SharedMemoryConnection(
+      const std::shared_ptr<Details::SharedMemoryEntry>& entry,
+      std::string name, std::size_t capacity)
+      : m_entry(entry),
+        m_name(std::move(name)),
+        m_capacity(capacity) {}
+
+  inline void SharedMemoryConnection::Connect() {
+    auto server = std::unique_ptr<SharedMemorySegment>();
+    try {
+      server = std::make_unique<SharedMemorySegment>(
+        Details::GetSharedMemoryServerName(m_name));
+    } catch(const std::exception&) {
+      BOOST_THROW_EXCEPTION(ConnectException("Server unavailable."));
+    }
+    auto header = static_cast<Details::SharedMemoryServerHeader*>(
+      server->GetData());
+    if(server->GetSize() < sizeof(Details::SharedMemoryServerHeader) ||
+        header->m_magic != Details::SHARED_MEMORY_MAGIC ||
+        !header->m_isOpen) {
+      BOOST_THROW_EXCEPTION(ConnectException("Server unavailable."));
+    }
+    static auto nextId = std::atomic<std::uint64_t>(0);
+    auto name = Details::GetSharedMemoryServerName(m_name) + "." +
+      ToString(::getpid()) + "." + ToString(++nextId);
+    if(name.size() >= Details::SharedMemoryServerHeader::MAXIMUM_NAME_SIZE) {
+      BOOST_THROW_EXCEPTION(ConnectException("Name too long."));
+    }
+    m_entry->Initialize(std::make_unique<SharedMemorySegment>(name,
+      Details::SharedMemoryEntry::GetSegmentSize(m_capacity)), m_capacity);
+    auto isServerAvailable = [&] {
+      return header->m_isOpen && Details::IsProcessAlive(header->m_serverPid);
+    };
+    auto pid = static_cast<std::uint32_t>(::getpid());
+    auto isLocked = false;
+    Details::SharedMemorySpinWait(m_entry->m_writeWaiter,
+      [&] {
+        auto holder = std::uint32_t(0);
+        if(header->m_lock.compare_exchange_strong(holder, pid)) {
+          isLocked = true;
+        } else if(!Details::IsProcessAlive(holder)) {
+          isLocked = header->m_lock.compare_exchange_strong(holder, pid);
+        }
+        return isLocked || !isServerAvailable();
+      },
+      [&] {
+        auto holder = header->m_lock.load();
+        if(holder != 0) {
+          Details::FutexWait(header->m_lock, holder,
+            Details::GetSharedMemoryPollInterval());
+        }
+      });
+    if(!isLocked) {
+      m_entry->m_segment->Unlink();
+      BOOST_THROW_EXCEPTION(ConnectException("Server unavailable."));
+    }
+    std::strcpy(header->m_name, name.c_str());
+    header->m_request.store(Details::SharedMemoryRequest::PENDING);
+    Details::FutexWake(header->m_request);
+    Details::SharedMemorySpinWait(m_entry->m_writeWaiter,
+      [&] {
+        return header->m_request != Details::SharedMemoryRequest::PENDING ||
+          !isServerAvailable();
+      },
+      [&] {
+        Details::FutexWait(header->m_request,
+          Details::SharedMemoryRequest::PENDING,
+          Details::GetSharedMemoryPollInterval());
+      });
+    auto request = header->m_request.exchange(
+      Details::SharedMemoryRequest::NONE);
+    header->m_lock.store(0);
+    Details::FutexWake(header->m_lock);
+    m_entry->m_segment->Unlink();
+    if(request != Details::SharedMemoryRequest::ACCEPTED) {
+      BOOST_THROW_EXCEPTION(ConnectException("Server unavailable."));
+    }
+  }
+
+  inline void SharedMemoryConnection::Shutdown() {
+    m_entry->Close();
+    m_openState.SetClosed();
+  }
+}
+
+  template<>
+  struct ImplementsConcept<IO::SharedMemoryConnection, IO::Connection> :
+    std::true_type {};
+}
+
+#endif
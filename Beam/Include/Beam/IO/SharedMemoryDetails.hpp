@@ -0,0 +1,336 @@
+#ifndef BEAM_SHARED_MEMORY_DETAILS_HPP
+#define BEAM_SHARED_MEMORY_DETAILS_HPP
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <signal.h>
+#include <unistd.h>
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/SharedMemoryRing.hpp"
+#include "Beam/IO/SharedMemorySegment.hpp"
+#include "Beam/Routines/Async.hpp"
+#include "Beam/Routines/ExternalRoutine.hpp"
+#include "Beam/Threading/Mutex.hpp"
+
+namespace Beam {
+namespace IO {
+namespace Details {
+
+  //! Identifies an initialized shared memory segment.
+  constexpr auto SHARED_MEMORY_MAGIC = std::uint32_t(0x4245414D);
+
+  //! The number of times to poll before blocking.
+  constexpr auto SHARED_MEMORY_SPIN_COUNT = 256;
+
+  //! How often a blocked wait checks whether its peer is still running.
+  inline boost::posix_time::time_duration GetSharedMemoryPollInterval() {
+    return boost::posix_time::milliseconds(100);
+  }
+
+  //! Returns the name of the segment a server listens on.
+  inline std::string GetSharedMemoryServerName(const std::string& name) {
+    return "/beam." + name;
+  }
+
+  //! Returns <code>true</code> iff a process is running.
+  inline bool IsProcessAlive(std::int64_t pid) {
+    return pid != 0 &&
+      (::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH);
+  }
+
+  /** The state of a connection request. */
+  enum SharedMemoryRequest : std::uint32_t {
+
+    //! No request is pending.
+    NONE,
+
+    //! A client is waiting for the server to accept its segment.
+    PENDING,
+
+    //! The server accepted the segment.
+    ACCEPTED,
+
+    //! The server rejected the segment or closed.
+    REJECTED
+  };
+
+  /** The layout of the segment a server listens on. Clients take turns
+      holding the lock to post the name of their channel's segment. */
+  struct SharedMemoryServerHeader {
+    static constexpr auto MAXIMUM_NAME_SIZE = std::size_t(128);
+    std::uint32_t m_magic;
+    std::atomic<std::uint32_t> m_isOpen;
+    std::atomic<std::uint32_t> m_lock;
+    std::atomic<std::uint32_t> m_request;
+    std::int64_t m_serverPid;
+    char m_name[MAXIMUM_NAME_SIZE];
+  };
+
+  /** The layout of a channel's segment, followed by the client to server
+      ring and then the server to client ring. */
+  struct alignas(64) SharedMemoryChannelHeader {
+    std::uint32_t m_magic;
+    std::uint64_t m_capacity;
+    std::atomic<std::int64_t> m_clientPid;
+    std::atomic<std::int64_t> m_serverPid;
+  };
+
+  /** Runs blocking waits on a dedicated thread so that waiting suspends the
+      calling Routine rather than its scheduler's thread. */
+  class SharedMemoryWaiter : private boost::noncopyable {
+    public:
+
+      //! Constructs a SharedMemoryWaiter.
+      SharedMemoryWaiter();
+
+      ~SharedMemoryWaiter();
+
+      //! Runs a blocking function, the calling thread is blocked directly if
+      //! it isn't running a scheduled Routine.
+      /*!
+        \param f The function to run.
+      */
+      template<typename F>
+      void Wait(F&& f);
+
+    private:
+      boost::mutex m_mutex;
+      boost::condition_variable m_condition;
+      std::function<void ()> m_task;
+      std::optional<Routines::Eval<void>> m_result;
+      bool m_isStopped;
+      boost::thread m_thread;
+
+      void Run();
+  };
+
+  /** Polls for a condition, then blocks until it holds.
+      \param waiter The waiter used to block.
+      \param isReady Returns <code>true</code> once the wait is over.
+      \param wait Blocks until <i>isReady</i> may have changed.
+   */
+  template<typename F, typename G>
+  void SharedMemorySpinWait(SharedMemoryWaiter& waiter, F&& isReady,
+      G&& wait) {
+    for(auto i = 0; i < SHARED_MEMORY_SPIN_COUNT; ++i) {
+      if(isReady()) {
+        return;
+      }
+      Routines::Defer();
+      boost::this_thread::yield();
+    }
+    if(isReady()) {
+      return;
+    }
+    waiter.Wait(
+      [&] {
+        while(!isReady()) {
+          wait();
+        }
+      });
+  }
+
+  /** Stores the state shared by a SharedMemoryChannel's components. */
+  struct SharedMemoryEntry : private boost::noncopyable {
+    std::unique_ptr<SharedMemorySegment> m_segment;
+    SharedMemoryChannelHeader* m_header;
+    SharedMemoryRing m_readRing;
+    SharedMemoryRing m_writeRing;
+    std::int64_t m_peerPid;
+    std::atomic<bool> m_isOpen;
+    Threading::Mutex m_readMutex;
+    Threading::Mutex m_writeMutex;
+    SharedMemoryWaiter m_readWaiter;
+    SharedMemoryWaiter m_writeWaiter;
+
+    //! Returns the size of a channel's segment.
+    static std::size_t GetSegmentSize(std::size_t capacity);
+
+    //! Constructs a SharedMemoryEntry.
+    SharedMemoryEntry();
+
+    //! Initializes a newly created segment, called by the client.
+    void Initialize(std::unique_ptr<SharedMemorySegment> segment,
+      std::size_t capacity);
+
+    //! Attaches to an initialized segment.
+    void Attach(std::unique_ptr<SharedMemorySegment> segment, bool isClient);
+
+    //! Marks this entry as open.
+    void Open();
+
+    //! Closes both rings.
+    void Close();
+
+    //! Waits until data is available to read or the channel closes.
+    void WaitForData();
+
+    //! Waits until there is room to write or the channel closes.
+    void WaitForSpace();
+
+    //! Closes the channel if the peer process exited.
+    void CheckPeer();
+  };
+
+  inline SharedMemoryWaiter::SharedMemoryWaiter()
+    : m_isStopped(false) {}
+
+  inline SharedMemoryWaiter::~SharedMemoryWaiter() {
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_isStopped = true;
+      m_condition.notify_one();
+    }
+    if(m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  template<typename F>
+  void SharedMemoryWaiter::Wait(F&& f) {
+    if(dynamic_cast<Routines::ExternalRoutine*>(
+        &Routines::GetCurrentRoutine()) != nullptr) {
+      f();
+      return;
+    }
+    auto result = Routines::Async<void>();
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(!m_thread.joinable()) {
+        m_thread = boost::thread(std::bind(&SharedMemoryWaiter::Run, this));
+      }
+      m_task = std::forward<F>(f);
+      m_result.emplace(result.GetEval());
+      m_condition.notify_one();
+    }
+    result.Get();
+  }
+
+  inline void SharedMemoryWaiter::Run() {
+    while(true) {
+      auto task = std::function<void ()>();
+      auto result = std::optional<Routines::Eval<void>>();
+      {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        while(!m_task && !m_isStopped) {
+          m_condition.wait(lock);
+        }
+        if(!m_task) {
+          return;
+        }
+        task = std::move(m_task);
+        m_task = nullptr;
+        result = std::move(m_result);
+        m_result = std::nullopt;
+      }
+      try {
+        task();
+        result->SetResult();
+      } catch(const std::exception&) {
+        result->SetException(std::current_exception());
+      }
+    }
+  }
+
+  inline std::size_t SharedMemoryEntry::GetSegmentSize(std::size_t capacity) {
+    return sizeof(SharedMemoryChannelHeader) +
+      2 * SharedMemoryRing::GetSize(capacity);
+  }
+
+  inline SharedMemoryEntry::SharedMemoryEntry()
+    : m_header(nullptr),
+      m_peerPid(0),
+      m_isOpen(false) {}
+
+  inline void SharedMemoryEntry::Initialize(
+      std::unique_ptr<SharedMemorySegment> segment, std::size_t capacity) {
+    auto data = static_cast<char*>(segment->GetData());
+    auto header = reinterpret_cast<SharedMemoryChannelHeader*>(data);
+    header->m_capacity = capacity;
+    header->m_clientPid = ::getpid();
+    auto ring = data + sizeof(SharedMemoryChannelHeader);
+    SharedMemoryRing::Initialize(ring, capacity);
+    SharedMemoryRing::Initialize(ring + SharedMemoryRing::GetSize(capacity),
+      capacity);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->m_magic = SHARED_MEMORY_MAGIC;
+    Attach(std::move(segment), true);
+  }
+
+  inline void SharedMemoryEntry::Attach(
+      std::unique_ptr<SharedMemorySegment> segment, bool isClient) {
+    m_segment = std::move(segment);
+    auto data = static_cast<char*>(m_segment->GetData());
+    m_header = reinterpret_cast<SharedMemoryChannelHeader*>(data);
+    auto clientRing = data + sizeof(SharedMemoryChannelHeader);
+    auto serverRing = clientRing +
+      SharedMemoryRing::GetSize(m_header->m_capacity);
+    if(isClient) {
+      m_writeRing = SharedMemoryRing(clientRing);
+      m_readRing = SharedMemoryRing(serverRing);
+    } else {
+      m_header->m_serverPid = ::getpid();
+      m_readRing = SharedMemoryRing(clientRing);
+      m_writeRing = SharedMemoryRing(serverRing);
+    }
+  }
+
+  inline void SharedMemoryEntry::Open() {
+    m_peerPid = m_header->m_clientPid == ::getpid() ?
+      m_header->m_serverPid.load() : m_header->m_clientPid.load();
+    m_isOpen = true;
+  }
+
+  inline void SharedMemoryEntry::Close() {
+    m_isOpen = false;
+    if(m_segment != nullptr) {
+      m_readRing.Close();
+      m_writeRing.Close();
+    }
+  }
+
+  inline void SharedMemoryEntry::WaitForData() {
+    SharedMemorySpinWait(m_readWaiter,
+      [&] {
+        return m_readRing.GetAvailableSize() != 0 || m_readRing.IsClosed();
+      },
+      [&] {
+        if(!m_readRing.WaitForData(GetSharedMemoryPollInterval())) {
+          CheckPeer();
+        }
+      });
+  }
+
+  inline void SharedMemoryEntry::WaitForSpace() {
+    SharedMemorySpinWait(m_writeWaiter,
+      [&] {
+        return m_writeRing.GetAvailableSize() < m_writeRing.GetCapacity() ||
+          m_writeRing.IsClosed();
+      },
+      [&] {
+        if(!m_writeRing.WaitForSpace(GetSharedMemoryPollInterval())) {
+          CheckPeer();
+        }
+      });
+  }
+
+  inline void SharedMemoryEntry::CheckPeer() {
+    if(!IsProcessAlive(m_peerPid)) {
+      m_readRing.Close();
+      m_writeRing.Close();
+    }
+  }
+}
+}
+}
+
+#endif
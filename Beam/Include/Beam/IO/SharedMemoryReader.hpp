@@ -0,0 +1,98 @@
+#ifndef BEAM_SHARED_MEMORY_READER_HPP
+#define BEAM_SHARED_MEMORY_READER_HPP
+#include <algorithm>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/Reader.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/IO/SharedMemoryDetails.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemoryReader
+      \brief Reads from a SharedMemoryChannel's incoming ring.
+      \details Reads poll the ring for a short while before blocking, so a
+               peer that responds promptly is read without a system call.
+   */
+  class SharedMemoryReader : private boost::noncopyable {
+    public:
+      using Buffer = SharedBuffer;
+
+      bool IsDataAvailable() const;
+
+      template<typename BufferType>
+      std::size_t Read(Out<BufferType> destination);
+
+      std::size_t Read(char* destination, std::size_t size);
+
+      template<typename BufferType>
+      std::size_t Read(Out<BufferType> destination, std::size_t size);
+
+    private:
+      friend class SharedMemoryChannel;
+      static constexpr auto MAXIMUM_READ_SIZE = std::size_t(64 * 1024);
+      std::shared_ptr<Details::SharedMemoryEntry> m_entry;
+
+      SharedMemoryReader(
+        const std::shared_ptr<Details::SharedMemoryEntry>& entry);
+      std::size_t WaitForData();
+  };
+
+  inline bool SharedMemoryReader::IsDataAvailable() const {
+    return m_entry->m_isOpen && m_entry->m_readRing.GetAvailableSize() != 0;
+  }
+
+  template<typename BufferType>
+  std::size_t SharedMemoryReader::Read(Out<BufferType> destination) {
+    return Read(Store(destination), MAXIMUM_READ_SIZE);
+  }
+
+  inline std::size_t SharedMemoryReader::Read(char* destination,
+      std::size_t size) {
+    boost::lock_guard<Threading::Mutex> lock(m_entry->m_readMutex);
+    WaitForData();
+    return m_entry->m_readRing.Read(destination, size);
+  }
+
+  template<typename BufferType>
+  std::size_t SharedMemoryReader::Read(Out<BufferType> destination,
+      std::size_t size) {
+    boost::lock_guard<Threading::Mutex> lock(m_entry->m_readMutex);
+    auto readSize = std::min(size, WaitForData());
+    auto initialSize = destination->GetSize();
+    destination->Grow(readSize);
+    return m_entry->m_readRing.Read(
+      destination->GetMutableData() + initialSize, readSize);
+  }
+
+  inline SharedMemoryReader::SharedMemoryReader(
+      const std::shared_ptr<Details::SharedMemoryEntry>& entry)
+      : m_entry(entry) {}
+
+  inline std::size_t SharedMemoryReader::WaitForData() {
+    if(!m_entry->m_isOpen) {
+      BOOST_THROW_EXCEPTION(EndOfFileException());
+    }
+    auto size = m_entry->m_readRing.GetAvailableSize();
+    if(size != 0) {
+      return size;
+    }
+    m_entry->WaitForData();
+    size = m_entry->m_readRing.GetAvailableSize();
+    if(size == 0 || !m_entry->m_isOpen) {
+      BOOST_THROW_EXCEPTION(EndOfFileException());
+    }
+    return size;
+  }
+}
+
+  template<typename BufferType>
+  struct ImplementsConcept<IO::SharedMemoryReader, IO::Reader<BufferType>> :
+    std::true_type {};
+}
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef BEAM_SHARED_MEMORY_RING_HPP
+#define BEAM_SHARED_MEMORY_RING_HPP
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#ifdef __linux__
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+#include "Beam/IO/IO.hpp"
+
+namespace Beam {
+namespace IO {
+namespace Details {
+
+  //! Blocks while a word in shared memory holds an expected value.
+  /*!
+    \param word The word to wait on.
+    \param expected The value the word must hold for the wait to block.
+    \param timeout The maximum time to wait for.
+    \return <code>false</code> iff the wait timed out.
+  */
+  inline bool FutexWait(std::atomic<std::uint32_t>& word,
+      std::uint32_t expected, boost::posix_time::time_duration timeout) {
+#ifdef __linux__
+    auto microseconds = timeout.total_microseconds();
+    auto time = timespec();
+    time.tv_sec = static_cast<time_t>(microseconds / 1000000);
+    time.tv_nsec = static_cast<long>((microseconds % 1000000) * 1000);
+    auto result = ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word),
+      FUTEX_WAIT, expected, &time, nullptr, 0);
+    return result == 0 || errno != ETIMEDOUT;
+#else
+    if(word.load() != expected) {
+      return true;
+    }
+    boost::this_thread::sleep_for(boost::chrono::microseconds(100));
+    return true;
+#endif
+  }
+
+  //! Wakes processes waiting on a word in shared memory.
+  /*!
+    \param word The word being waited on.
+    \param count The maximum number of waiters to wake.
+  */
+  inline void FutexWake(std::atomic<std::uint32_t>& word, int count = 1) {
+#ifdef __linux__
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE,
+      count, nullptr, nullptr, 0);
+#endif
+  }
+}
+
+  /*! \class SharedMemoryRing
+      \brief A single producer, single consumer byte queue laid out in memory
+             shared between two processes.
+      \details The producer and consumer each only write their own index, the
+               data between the two is published through release/acquire
+               ordering. A side about to block on a futex raises a flag that
+               the other side checks after publishing, so the fast path makes
+               no system calls.
+   */
+  class SharedMemoryRing {
+    public:
+
+      //! Returns the number of bytes of shared memory a ring uses.
+      /*!
+        \param capacity The number of bytes the ring can hold, must be a power
+               of two.
+      */
+      static std::size_t GetSize(std::size_t capacity);
+
+      //! Initializes a ring in zero-filled shared memory.
+      /*!
+        \param address The address of the ring.
+        \param capacity The number of bytes the ring can hold, must be a power
+               of two.
+      */
+      static void Initialize(void* address, std::size_t capacity);
+
+      //! Constructs an unattached SharedMemoryRing.
+      SharedMemoryRing();
+
+      //! Attaches to an initialized ring.
+      /*!
+        \param address The address of the ring.
+      */
+      explicit SharedMemoryRing(void* address);
+
+      //! Returns the number of bytes the ring can hold.
+      std::size_t GetCapacity() const;
+
+      //! Returns the number of bytes available to read.
+      std::size_t GetAvailableSize() const;
+
+      //! Returns <code>true</code> iff either side closed the ring.
+      bool IsClosed() const;
+
+      //! Closes the ring and wakes both sides.
+      void Close();
+
+      //! Reads as much data as is available, only called by the consumer.
+      /*!
+        \param destination The destination to read into.
+        \param size The maximum number of bytes to read.
+        \return The number of bytes read.
+      */
+      std::size_t Read(void* destination, std::size_t size);
+
+      //! Writes as much data as there is room for, only called by the
+      //! producer.
+      /*!
+        \param data The data to write.
+        \param size The number of bytes to write.
+        \return The number of bytes written.
+      */
+      std::size_t Write(const void* data, std::size_t size);
+
+      //! Blocks the consumer until data may be available.
+      /*!
+        \param timeout The maximum time to wait for.
+        \return <code>false</code> iff the wait timed out.
+      */
+      bool WaitForData(boost::posix_time::time_duration timeout);
+
+      //! Blocks the producer until space may be available.
+      /*!
+        \param timeout The maximum time to wait for.
+        \return <code>false</code> iff the wait timed out.
+      */
+      bool WaitForSpace(boost::posix_time::time_duration timeout);
+
+    private:
+      struct alignas(64) Header {
+        alignas(64) std::atomic<std::uint64_t> m_tail;
+        std::atomic<std::uint32_t> m_dataSequence;
+        std::atomic<std::uint32_t> m_isConsumerWaiting;
+        alignas(64) std::atomic<std::uint64_t> m_head;
+        std::atomic<std::uint32_t> m_spaceSequence;
+        std::atomic<std::uint32_t> m_isProducerWaiting;
+        alignas(64) std::atomic<std::uint32_t> m_isClosed;
+        std::uint64_t m_capacity;
+      };
+      Header* m_header;
+      char* m_data;
+      std::uint64_t m_mask;
+      std::uint64_t m_cachedHead;
+      std::uint64_t m_cachedTail;
+
+      template<typename F>
+      bool Wait(std::atomic<std::uint32_t>& sequence,
+        std::atomic<std::uint32_t>& isWaiting, F&& isReady,
+        boost::posix_time::time_duration timeout);
+      static void Notify(std::atomic<std::uint32_t>& sequence,
+        std::atomic<std::uint32_t>& isWaiting);
+  };
+
+  inline std::size_t SharedMemoryRing::GetSize(std::size_t capacity) {
+    return sizeof(Header) + capacity;
+  }
+
+  inline void SharedMemoryRing::Initialize(void* address,
+      std::size_t capacity) {
+    auto header = static_cast<Header*>(address);
+    header->m_capacity = capacity;
+  }
+
+  inline SharedMemoryRing::SharedMemoryRing()
+    : m_header(nullptr),
+      m_data(nullptr),
+      m_mask(0),
+      m_cachedHead(0),
+      m_cachedTail(0) {}
+
+  inline SharedMemoryRing::SharedMemoryRing(void* address)
+      : m_header(static_cast<Header*>(address)),
+        m_data(static_cast<char*>(address) + sizeof(Header)),
+        m_mask(m_header->m_capacity - 1),
+        m_cachedHead(m_header->m_head.load(std::memory_order_acquire)),
+        m_cachedTail(m_header->m_tail.load(std::memory_order_acquire)) {}
+
+  inline std::size_t SharedMemoryRing::GetCapacity() const {
+    return static_cast<std::size_t>(m_mask + 1);
+  }
+
+  inline std::size_t SharedMemoryRing::GetAvailableSize() const {
+    return static_cast<std::size_t>(
+      m_header->m_tail.load(std::memory_order_acquire) -
+      m_header->m_head.load(std::memory_order_relaxed));
+  }
+
+  inline bool SharedMemoryRing::IsClosed() const {
+    return m_header->m_isClosed.load(std::memory_order_acquire) != 0;
+  }
+
+  inline void SharedMemoryRing::Close() {
+    m_header->m_isClosed.store(1, std::memory_order_release);
+    m_header->m_dataSequence.fetch_add(1, std::memory_order_acq_rel);
+    m_header->m_spaceSequence.fetch_add(1, std::memory_order_acq_rel);
+    Details::FutexWake(m_header->m_dataSequence, INT_MAX);
+    Details::FutexWake(m_header->m_spaceSequence, INT_MAX);
+  }
+
+  inline std::size_t SharedMemoryRing::Read(void* destination,
+      std::size_t size) {
+    auto head = m_header->m_head.load(std::memory_order_relaxed);
+    if(m_cachedTail - head < size) {
+      m_cachedTail = m_header->m_tail.load(std::memory_order_acquire);
+    }
+    auto readSize = static_cast<std::size_t>(
+      std::min<std::uint64_t>(size, m_cachedTail - head));
+    if(readSize == 0) {
+      return 0;
+    }
+    auto offset = static_cast<std::size_t>(head & m_mask);
+    auto firstSize = std::min(readSize, GetCapacity() - offset);
+    std::memcpy(destination, m_data + offset, firstSize);
+    std::memcpy(static_cast<char*>(destination) + firstSize, m_data,
+      readSize - firstSize);
+    m_header->m_head.store(head + readSize, std::memory_order_release);
+    Notify(m_header->m_spaceSequence, m_header->m_isProducerWaiting);
+    return readSize;
+  }
+
+  inline std::size_t SharedMemoryRing::Write(const void* data,
+      std::size_t size) {
+    auto tail = m_header->m_tail.load(std::memory_order_relaxed);
+    if(GetCapacity() - (tail - m_cachedHead) < size) {
+      m_cachedHead = m_header->m_head.load(std::memory_order_acquire);
+    }
+    auto writeSize = static_cast<std::size_t>(std::min<std::uint64_t>(size,
+      GetCapacity() - (tail - m_cachedHead)));
+    if(writeSize == 0) {
+      return 0;
+    }
+    auto offset = static_cast<std::size_t>(tail & m_mask);
+    auto firstSize = std::min(writeSize, GetCapacity() - offset);
+    std::memcpy(m_data + offset, data, firstSize);
+    std::memcpy(m_data, static_cast<const char*>(data) + firstSize,
+      writeSize - firstSize);
+    m_header->m_tail.store(tail + writeSize, std::memory_order_release);
+    Notify(m_header->m_dataSequence, m_header->m_isConsumerWaiting);
+    return writeSize;
+  }
+
+  inline bool SharedMemoryRing::WaitForData(
+      boost::posix_time::time_duration timeout) {
+    return Wait(m_header->m_dataSequence, m_header->m_isConsumerWaiting,
+      [&] {
+        return GetAvailableSize() != 0;
+      }, timeout);
+  }
+
+  inline bool SharedMemoryRing::WaitForSpace(
+      boost::posix_time::time_duration timeout) {
+    return Wait(m_header->m_spaceSequence, m_header->m_isProducerWaiting,
+      [&] {
+        return m_header->m_tail.load(std::memory_order_relaxed) -
+          m_header->m_head.load(std::memory_order_acquire) < GetCapacity();
+      }, timeout);
+  }
+
+  template<typename F>
+  bool SharedMemoryRing::Wait(std::atomic<std::uint32_t>& sequence,
+      std::atomic<std::uint32_t>& isWaiting, F&& isReady,
+      boost::posix_time::time_duration timeout) {
+    if(isReady() || IsClosed()) {
+      return true;
+    }
+    auto expected = sequence.load(std::memory_order_acquire);
+    isWaiting.store(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in Notify, either the other side sees the flag or
+    // this side sees the other side's index update in the check below.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto result = true;
+    if(!isReady() && !IsClosed()) {
+      result = Details::FutexWait(sequence, expected, timeout);
+    }
+    isWaiting.store(0, std::memory_order_relaxed);
+    return result;
+  }
+
+  inline void SharedMemoryRing::Notify(std::atomic<std::uint32_t>& sequence,
+      std::atomic<std::uint32_t>& isWaiting) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(isWaiting.load(std::memory_order_relaxed) != 0) {
+      isWaiting.store(0, std::memory_order_relaxed);
+      sequence.fetch_add(1, std::memory_order_acq_rel);
+      Details::FutexWake(sequence);
+    }
+  }
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef BEAM_SHARED_MEMORY_SEGMENT_HPP
+#define BEAM_SHARED_MEMORY_SEGMENT_HPP
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/IOException.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemorySegment
+      \brief Maps a named POSIX shared memory object into the address space.
+   */
+  class SharedMemorySegment : private boost::noncopyable {
+    public:
+
+      //! Creates a new zero-filled segment, replacing any existing segment
+      //! with the same name.
+      /*!
+        \param name The name of the segment, must begin with a '/'.
+        \param size The size of the segment in bytes.
+      */
+      SharedMemorySegment(std::string name, std::size_t size);
+
+      //! Maps an existing segment.
+      /*!
+        \param name The name of the segment, must begin with a '/'.
+      */
+      SharedMemorySegment(std::string name);
+
+      ~SharedMemorySegment();
+
+      //! Returns the name of the segment.
+      const std::string& GetName() const;
+
+      //! Returns the size of the segment.
+      std::size_t GetSize() const;
+
+      //! Returns the address the segment is mapped to.
+      void* GetData() const;
+
+      //! Removes the segment's name, the memory remains mapped until every
+      //! process has unmapped it.
+      void Unlink();
+
+    private:
+      std::string m_name;
+      std::size_t m_size;
+      void* m_data;
+
+      void Map(int descriptor);
+      [[noreturn]] static void Throw(const std::string& message);
+  };
+
+  inline SharedMemorySegment::SharedMemorySegment(std::string name,
+      std::size_t size)
+      : m_name(std::move(name)),
+        m_size(size),
+        m_data(nullptr) {
+    ::shm_unlink(m_name.c_str());
+    auto descriptor = ::shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR,
+      S_IRUSR | S_IWUSR);
+    if(descriptor == -1) {
+      Throw("Unable to create shared memory segment " + m_name);
+    }
+    if(::ftruncate(descriptor, static_cast<off_t>(m_size)) == -1) {
+      auto error = errno;
+      ::close(descriptor);
+      ::shm_unlink(m_name.c_str());
+      errno = error;
+      Throw("Unable to size shared memory segment " + m_name);
+    }
+    Map(descriptor);
+  }
+
+  inline SharedMemorySegment::SharedMemorySegment(std::string name)
+      : m_name(std::move(name)),
+        m_size(0),
+        m_data(nullptr) {
+    auto descriptor = ::shm_open(m_name.c_str(), O_RDWR, 0);
+    if(descriptor == -1) {
+      Throw("Unable to open shared memory segment " + m_name);
+    }
+    struct stat status;
+    if(::fstat(descriptor, &status) == -1) {
+      auto error = errno;
+      ::close(descriptor);
+      errno = error;
+      Throw("Unable to open shared memory segment " + m_name);
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    Map(descriptor);
+  }
+
+  inline SharedMemorySegment::~SharedMemorySegment() {
+    ::munmap(m_data, m_size);
+  }
+
+  inline const std::string& SharedMemorySegment::GetName() const {
+    return m_name;
+  }
+
+  inline std::size_t SharedMemorySegment::GetSize() const {
+    return m_size;
+  }
+
+  inline void* SharedMemorySegment::GetData() const {
+    return m_data;
+  }
+
+  inline void SharedMemorySegment::Unlink() {
+    ::shm_unlink(m_name.c_str());
+  }
+
+  inline void SharedMemorySegment::Map(int descriptor) {
+    m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+      descriptor, 0);
+    auto error = errno;
+    ::close(descriptor);
+    if(m_data == MAP_FAILED) {
+      errno = error;
+      Throw("Unable to map shared memory segment " + m_name);
+    }
+  }
+
+  inline void SharedMemorySegment::Throw(const std::string& message) {
+    BOOST_THROW_EXCEPTION(IOException(message + ": " + std::strerror(errno)));
+  }
+}
+}
+
+#endif
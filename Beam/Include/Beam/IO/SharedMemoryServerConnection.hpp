@@ -0,0 +1,162 @@
+#ifndef BEAM_SHARED_MEMORY_SERVER_CONNECTION_HPP
+#define BEAM_SHARED_MEMORY_SERVER_CONNECTION_HPP
+#include <climits>
+#include <memory>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include <unistd.h>
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/OpenState.hpp"
+#include "Beam/IO/ServerConnection.hpp"
+#include "Beam/IO/SharedMemoryChannel.hpp"
+#include "Beam/IO/SharedMemoryDetails.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemoryServerConnection
+      \brief Accepts SharedMemoryChannels from processes on the same host.
+      \details Each client creates the segment holding its channel's rings
+               and posts its name to a small segment named after the server,
+               so no data passes through the kernel once a channel is
+               accepted.
+   */
+  class SharedMemoryServerConnection : private boost::noncopyable {
+    public:
+      using Channel = SharedMemoryChannel;
+
+      //! Constructs a SharedMemoryServerConnection.
+      /*!
+        \param name The name clients use to connect to this server.
+      */
+      SharedMemoryServerConnection(std::string name);
+
+      ~SharedMemoryServerConnection();
+
+      std::unique_ptr<Channel> Accept();
+
+      void Open();
+
+      void Close();
+
+    private:
+      std::string m_name;
+      std::unique_ptr<SharedMemorySegment> m_segment;
+      Details::SharedMemoryServerHeader* m_header;
+      Details::SharedMemoryWaiter m_waiter;
+      std::uint64_t m_nextId;
+      OpenState m_openState;
+
+      void Shutdown();
+  };
+
+  inline SharedMemoryServerConnection::SharedMemoryServerConnection(
+      std::string name)
+      : m_name(std::move(name)),
+        m_header(nullptr),
+        m_nextId(0) {}
+
+  inline SharedMemoryServerConnection::~SharedMemoryServerConnection() {
+    Close();
+  }
+
+  inline std::unique_ptr<SharedMemoryServerConnection::Channel>
+      SharedMemoryServerConnection::Accept() {
+    if(!m_openState.IsOpen()) {
+      BOOST_THROW_EXCEPTION(EndOfFileException());
+    }
+    while(true) {
+      Details::SharedMemorySpinWait(m_waiter,
+        [&] {
+          return m_header->m_request ==
+            Details::SharedMemoryRequest::PENDING || !m_header->m_isOpen;
+        },
+        [&] {
+          auto request = m_header->m_request.load();
+          if(request != Details::SharedMemoryRequest::PENDING) {
+            Details::FutexWait(m_header->m_request, request,
+              Details::GetSharedMemoryPollInterval());
+          }
+        });
+      if(!m_header->m_isOpen) {
+        BOOST_THROW_EXCEPTION(EndOfFileException());
+      }
+      auto entry = std::make_shared<Details::SharedMemoryEntry>();
+      try {
+        auto segment = std::make_unique<SharedMemorySegment>(
+          std::string(m_header->m_name));
+        auto header = static_cast<Details::SharedMemoryChannelHeader*>(
+          segment->GetData());
+        if(segment->GetSize() < sizeof(Details::SharedMemoryChannelHeader) ||
+            header->m_magic != Details::SHARED_MEMORY_MAGIC ||
+            segment->GetSize() !=
+            Details::SharedMemoryEntry::GetSegmentSize(header->m_capacity)) {
+          BOOST_THROW_EXCEPTION(IOException("Invalid segment."));
+        }
+        entry->Attach(std::move(segment), false);
+      } catch(const std::exception&) {
+        m_header->m_request = Details::SharedMemoryRequest::REJECTED;
+        Details::FutexWake(m_header->m_request);
+        continue;
+      }
+      entry->Open();
+      ++m_nextId;
+      auto channel = std::unique_ptr<Channel>(new Channel(
+        m_name + "@" + std::to_string(m_nextId), entry));
+      m_header->m_request = Details::SharedMemoryRequest::ACCEPTED;
+      Details::FutexWake(m_header->m_request);
+      return channel;
+    }
+  }
+
+  inline void SharedMemoryServerConnection::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      m_segment = std::make_unique<SharedMemorySegment>(
+        Details::GetSharedMemoryServerName(m_name),
+        sizeof(Details::SharedMemoryServerHeader));
+      m_header = static_cast<Details::SharedMemoryServerHeader*>(
+        m_segment->GetData());
+      m_header->m_serverPid = ::getpid();
+      m_header->m_isOpen = 1;
+      std::atomic_thread_fence(std::memory_order_release);
+      m_header->m_magic = Details::SHARED_MEMORY_MAGIC;
+    } catch(const std::exception&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    }
+    m_openState.SetOpen();
+  }
+
+  inline void SharedMemoryServerConnection::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  inline void SharedMemoryServerConnection::Shutdown() {
+    if(m_header != nullptr) {
+      m_header->m_isOpen = 0;
+      auto request = std::uint32_t(Details::SharedMemoryRequest::PENDING);
+      m_header->m_request.compare_exchange_strong(request,
+        Details::SharedMemoryRequest::REJECTED);
+      Details::FutexWake(m_header->m_request, INT_MAX);
+      Details::FutexWake(m_header->m_lock, INT_MAX);
+      m_segment->Unlink();
+    }
+    m_openState.SetClosed();
+  }
+}
+
+  template<>
+  struct ImplementsConcept<IO::SharedMemoryServerConnection,
+    IO::ServerConnection<IO::SharedMemoryServerConnection::Channel>> :
+    std::true_type {};
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef BEAM_SHARED_MEMORY_WRITER_HPP
+#define BEAM_SHARED_MEMORY_WRITER_HPP
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#include "Beam/IO/ChainedBuffer.hpp"
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IO.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/IO/SharedMemoryDetails.hpp"
+#include "Beam/IO/Writer.hpp"
+
+namespace Beam {
+namespace IO {
+
+  /*! \class SharedMemoryWriter
+      \brief Writes to a SharedMemoryChannel's outgoing ring.
+      \details Writes larger than the free space in the ring are copied in
+               pieces as the peer drains it.
+   */
+  class SharedMemoryWriter : private boost::noncopyable {
+    public:
+      using Buffer = SharedBuffer;
+
+      void Write(const void* data, std::size_t size);
+
+      //! Writes every segment of a ChainedBuffer without coalescing it.
+      /*!
+        \param data The ChainedBuffer to write.
+      */
+      void Write(const ChainedBuffer& data);
+
+      template<typename BufferType>
+      void Write(const BufferType& data);
+
+    private:
+      friend class SharedMemoryChannel;
+      std::shared_ptr<Details::SharedMemoryEntry> m_entry;
+
+      SharedMemoryWriter(
+        const std::shared_ptr<Details::SharedMemoryEntry>& entry);
+      void LockedWrite(const char* data, std::size_t size);
+  };
+
+  inline void SharedMemoryWriter::Write(const void* data, std::size_t size) {
+    boost::lock_guard<Threading::Mutex> lock(m_entry->m_writeMutex);
+    LockedWrite(static_cast<const char*>(data), size);
+  }
+
+  inline void SharedMemoryWriter::Write(const ChainedBuffer& data) {
+    boost::lock_guard<Threading::Mutex> lock(m_entry->m_writeMutex);
+    data.ForEachSegment(
+      [&] (const char* segment, std::size_t size) {
+        LockedWrite(segment, size);
+      });
+  }
+
+  template<typename BufferType>
+  void SharedMemoryWriter::Write(const BufferType& data) {
+    Write(data.GetData(), data.GetSize());
+  }
+
+  inline SharedMemoryWriter::SharedMemoryWriter(
+      const std::shared_ptr<Details::SharedMemoryEntry>& entry)
+      : m_entry(entry) {}
+
+  inline void SharedMemoryWriter::LockedWrite(const char* data,
+      std::size_t size) {
+    while(true) {
+      if(!m_entry->m_isOpen || m_entry->m_writeRing.IsClosed()) {
+        BOOST_THROW_EXCEPTION(EndOfFileException());
+      }
+      auto writeSize = m_entry->m_writeRing.Write(data, size);
+      data += writeSize;
+      size -= writeSize;
+      if(size == 0) {
+        return;
+      }
+      m_entry->WaitForSpace();
+    }
+  }
+}
+
+  template<typename BufferType>
+  struct ImplementsConcept<IO::SharedMemoryWriter, IO::Writer<BufferType>> :
+    std::true_type {};
+}
+
+#endif
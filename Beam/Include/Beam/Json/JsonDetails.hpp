@@ -0,0 +1,59 @@
+#ifndef BEAM_JSONDETAILS_HPP
+#define BEAM_JSONDETAILS_HPP
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+  #define BEAM_JSON_SSE2
+  #include <emmintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+#include "Beam/Json/Json.hpp"
+
+namespace Beam {
+namespace Details {
+
+  /** Returns <code>true</code> iff a character can not appear unescaped
+      within a JSON string, that is a quote, a backslash or a control
+      character. */
+  inline bool IsJsonSpecialCharacter(char c) {
+    return c == '\"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+  }
+
+  /** Returns the first character in [first, last) that can not appear
+      unescaped within a JSON string, or <i>last</i> if there is none. Scans
+      16 bytes at a time where SSE2 is available. */
+  inline const char* FindJsonSpecialCharacter(const char* first,
+      const char* last) {
+#ifdef BEAM_JSON_SSE2
+    auto quotes = _mm_set1_epi8('\"');
+    auto backslashes = _mm_set1_epi8('\\');
+    auto controls = _mm_set1_epi8(0x1F);
+    while(last - first >= 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      auto matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, quotes),
+          _mm_cmpeq_epi8(block, backslashes)),
+        _mm_cmpeq_epi8(_mm_min_epu8(block, controls), block));
+      auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+      if(mask != 0) {
+#ifdef _MSC_VER
+        auto index = unsigned long();
+        _BitScanForward(&index, mask);
+        return first + index;
+#else
+        return first + __builtin_ctz(mask);
+#endif
+      }
+      first += 16;
+    }
+#endif
+    while(first != last && !IsJsonSpecialCharacter(*first)) {
+      ++first;
+    }
+    return first;
+  }
+}
+}
+
+#endif
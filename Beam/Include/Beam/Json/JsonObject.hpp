@@ -1,14 +1,24 @@
 #ifndef BEAM_JSONOBJECT_HPP
 #define BEAM_JSONOBJECT_HPP
+#include <ostream>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <vector>
 #include <boost/optional/optional.hpp>
+#include <boost/throw_exception.hpp>
 #include "Beam/Json/Json.hpp"
+#include "Beam/Json/JsonWriter.hpp"
+#include "Beam/Pointers/Out.hpp"
 
 namespace Beam {
 
   /*! \class JsonObject
       \brief Encapsulates an object represented using JSON.
+      \details Members are stored contiguously in insertion order and are
+               searched linearly, objects with many members additionally
+               keep an open addressing hash index of member positions.
    */
   class JsonObject {
     public:
@@ -17,7 +27,8 @@ namespace Beam {
       JsonObject();
 
       //! Returns a member of <code>this</code> JSON object, if the member has
-      //! not been initialized then it is added with a value of null.
+      //! not been initialized then it is added with a value of null. Adding
+      //! a member invalidates references to existing members.
       /*!
         \param name The name of the member to return.
         \return The member with the specified <i>name</i>.
@@ -60,7 +71,10 @@ namespace Beam {
         \param name The name of the member to set.
         \param value The value of the member.
       */
-      void Set(const std::string& name, const JsonValue& value);
+      void Set(std::string name, JsonValue value);
+
+      //! Returns the number of members.
+      std::size_t GetSize() const;
 
       //! Saves <code>this</code> object to an output stream.
       /*!
@@ -68,8 +82,25 @@ namespace Beam {
       */
       void Save(std::ostream& sink) const;
 
+      //! Appends the JSON representation of <code>this</code> object to a
+      //! Buffer.
+      /*!
+        \param sink The Buffer to append <code>this</code> object to.
+      */
+      template<typename Buffer>
+      void Save(Out<Buffer> sink) const;
+
     private:
-      std::unordered_map<std::string, std::shared_ptr<JsonValue>> m_members;
+      friend class JsonReader;
+      static const std::size_t INDEX_THRESHOLD = 16;
+      std::vector<std::string> m_names;
+      std::vector<JsonValue> m_values;
+      std::vector<std::size_t> m_index;
+
+      std::size_t Find(const std::string& name) const;
+      void Reserve(std::size_t size);
+      JsonValue& Add(std::string&& name, JsonValue&& value);
+      void Index(std::size_t position);
   };
 
   //! Saves a JSON object to an output stream.
@@ -91,21 +122,21 @@ namespace Beam {
   inline JsonObject::JsonObject() {}
 
   inline JsonValue& JsonObject::operator [](const std::string& name) {
-    auto memberIterator = m_members.find(name);
-    if(memberIterator == m_members.end()) {
-      memberIterator = m_members.insert(
-        std::make_pair(name, std::make_shared<JsonValue>())).first;
+    auto index = Find(name);
+    if(index == m_names.size()) {
+      return Add(std::string(name), JsonValue());
     }
-    return *memberIterator->second;
+    return m_values[index];
   }
 
   inline bool JsonObject::operator ==(const JsonObject& object) const {
-    if(m_members.size() != object.m_members.size()) {
+    if(m_names.size() != object.m_names.size()) {
       return false;
     }
-    for(const auto& member : m_members) {
-      boost::optional<const JsonValue&> value = object.Get(member.first);
-      if(!value.is_initialized() || !(*value == *member.second)) {
+    for(auto i = std::size_t(0); i != m_names.size(); ++i) {
+      auto index = object.Find(m_names[i]);
+      if(index == object.m_names.size() ||
+          !(object.m_values[index] == m_values[i])) {
         return false;
       }
     }
@@ -117,39 +148,109 @@ namespace Beam {
   }
 
   inline const JsonValue& JsonObject::At(const std::string& name) const {
-    return *m_members.at(name);
+    auto index = Find(name);
+    if(index == m_names.size()) {
+      BOOST_THROW_EXCEPTION(std::out_of_range("JSON member not found."));
+    }
+    return m_values[index];
   }
 
   inline boost::optional<const JsonValue&> JsonObject::Get(
       const std::string& name) const {
-    auto memberIterator = m_members.find(name);
-    if(memberIterator == m_members.end()) {
+    auto index = Find(name);
+    if(index == m_names.size()) {
       return boost::optional<const JsonValue&>();
     }
-    return *memberIterator->second;
+    return m_values[index];
   }
 
-  inline void JsonObject::Set(const std::string& name, const JsonValue& value) {
-    std::shared_ptr<JsonValue>& self = m_members[name];
-    if(self == nullptr) {
-      self = std::make_shared<JsonValue>(value);
+  inline void JsonObject::Set(std::string name, JsonValue value) {
+    auto index = Find(name);
+    if(index == m_names.size()) {
+      Add(std::move(name), std::move(value));
     } else {
-      *self = value;
+      m_values[index] = std::move(value);
     }
   }
 
+  inline std::size_t JsonObject::GetSize() const {
+    return m_names.size();
+  }
+
   inline void JsonObject::Save(std::ostream& sink) const {
-    sink << '{';
-    bool isFirstMember = true;
-    for(const auto& member : m_members) {
-      if(!isFirstMember) {
-        sink << ',';
+    auto buffer = IO::SharedBuffer();
+    Save(Store(buffer));
+    sink.write(buffer.GetData(), static_cast<std::streamsize>(
+      buffer.GetSize()));
+  }
+
+  template<typename Buffer>
+  void JsonObject::Save(Out<Buffer> sink) const {
+    sink->Append('{');
+    for(auto i = std::size_t(0); i != m_names.size(); ++i) {
+      if(i != 0) {
+        sink->Append(',');
       }
-      isFirstMember = false;
-      sink << '\"' << member.first << "\":";
-      member.second->Save(sink);
+      WriteJsonString(m_names[i], Store(sink));
+      sink->Append(':');
+      m_values[i].Save(Store(sink));
+    }
+    sink->Append('}');
+  }
+
+  inline std::size_t JsonObject::Find(const std::string& name) const {
+    if(m_index.empty()) {
+      for(auto i = std::size_t(0); i != m_names.size(); ++i) {
+        if(m_names[i] == name) {
+          return i;
+        }
+      }
+      return m_names.size();
+    }
+    auto mask = m_index.size() - 1;
+    auto slot = std::hash<std::string>()(name) & mask;
+    while(m_index[slot] != 0) {
+      auto position = m_index[slot] - 1;
+      if(m_names[position] == name) {
+        return position;
+      }
+      slot = (slot + 1) & mask;
+    }
+    return m_names.size();
+  }
+
+  inline void JsonObject::Reserve(std::size_t size) {
+    m_names.reserve(size);
+    m_values.reserve(size);
+  }
+
+  inline JsonValue& JsonObject::Add(std::string&& name, JsonValue&& value) {
+    m_names.push_back(std::move(name));
+    m_values.push_back(std::move(value));
+    if(m_names.size() > INDEX_THRESHOLD) {
+      if(2 * m_names.size() > m_index.size()) {
+        auto size = std::size_t(4 * INDEX_THRESHOLD);
+        while(size < 4 * m_names.size()) {
+          size *= 2;
+        }
+        m_index.assign(size, 0);
+        for(auto i = std::size_t(0); i != m_names.size(); ++i) {
+          Index(i);
+        }
+      } else {
+        Index(m_names.size() - 1);
+      }
+    }
+    return m_values.back();
+  }
+
+  inline void JsonObject::Index(std::size_t position) {
+    auto mask = m_index.size() - 1;
+    auto slot = std::hash<std::string>()(m_names[position]) & mask;
+    while(m_index[slot] != 0) {
+      slot = (slot + 1) & mask;
     }
-    sink << '}';
+    m_index[slot] = position + 1;
   }
 }
 
@@ -6,6 +6,8 @@
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Json/Json.hpp"
 #include "Beam/Json/JsonObject.hpp"
+#include "Beam/Json/JsonParserException.hpp"
+#include "Beam/Json/JsonReader.hpp"
 #include "Beam/Json/JsonValue.hpp"
 #include "Beam/Parsers/BasicParser.hpp"
 #include "Beam/Parsers/ForListParser.hpp"
@@ -74,9 +76,10 @@ namespace Serialization {
     template<typename Shuttler>
     void operator ()(Shuttler& shuttle, const char* name,
         const JsonObject& value) const {
-      std::stringstream destination;
-      value.Save(destination);
-      shuttle.Send(name, destination.str());
+      auto destination = IO::SharedBuffer();
+      value.Save(Store(destination));
+      shuttle.Send(name, std::string(destination.GetData(),
+        destination.GetSize()));
     }
   };
 
@@ -87,14 +90,17 @@ namespace Serialization {
         JsonObject& value) const {
       std::string data;
       shuttle.Shuttle(name, data);
-      Parsers::ReaderParserStream<IO::BufferReader<IO::SharedBuffer>> stream(
-        IO::BufferFromString<IO::SharedBuffer>(data));
-      JsonValue jsonValue;
-      if(!JsonParser::GetParser().Read(stream, jsonValue) ||
-          boost::get<JsonObject>(&jsonValue) == nullptr) {
+      auto jsonValue = JsonValue();
+      try {
+        jsonValue = ParseJson(data);
+      } catch(const JsonParserException&) {
         BOOST_THROW_EXCEPTION(SerializationException("Invalid JSON object."));
       }
-      value = boost::get<JsonObject>(jsonValue);
+      auto object = boost::get<JsonObject>(&jsonValue);
+      if(object == nullptr) {
+        BOOST_THROW_EXCEPTION(SerializationException("Invalid JSON object."));
+      }
+      value = std::move(*object);
     }
   };
 }
@@ -0,0 +1,42 @@
+#ifndef BEAM_JSONPARSEREXCEPTION_HPP
+#define BEAM_JSONPARSEREXCEPTION_HPP
+#include <cstddef>
+#include <string>
+#include "Beam/Json/Json.hpp"
+#include "Beam/Parsers/ParserException.hpp"
+
+namespace Beam {
+
+  /*! \class JsonParserException
+      \brief Signals that a JSON document is malformed.
+   */
+  class JsonParserException : public Parsers::ParserException {
+    public:
+
+      //! Constructs a JsonParserException.
+      /*!
+        \param message A message describing the error.
+        \param position The offset into the document where the error was
+               found.
+      */
+      JsonParserException(const std::string& message, std::size_t position);
+
+      //! Returns the offset into the document where the error was found.
+      std::size_t GetPosition() const;
+
+    private:
+      std::size_t m_position;
+  };
+
+  inline JsonParserException::JsonParserException(const std::string& message,
+      std::size_t position)
+      : Parsers::ParserException(message + " (offset " +
+          std::to_string(position) + ")"),
+        m_position(position) {}
+
+  inline std::size_t JsonParserException::GetPosition() const {
+    return m_position;
+  }
+}
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef BEAM_JSONREADER_HPP
+#define BEAM_JSONREADER_HPP
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/throw_exception.hpp>
+#include "Beam/Json/Json.hpp"
+#include "Beam/Json/JsonDetails.hpp"
+#include "Beam/Json/JsonObject.hpp"
+#include "Beam/Json/JsonParserException.hpp"
+#include "Beam/Json/JsonValue.hpp"
+#include "Beam/Pointers/Out.hpp"
+
+namespace Beam {
+
+  /*! \class JsonReader
+      \brief Parses JsonValues in a single pass over a contiguous block of
+             memory.
+      \details Nested values are parsed without recursion, the members of
+               objects and arrays being parsed are accumulated on scratch
+               stacks that are reused across values so that each object or
+               array is allocated once at its final size.
+   */
+  class JsonReader {
+    public:
+
+      //! Constructs a JsonReader with no source.
+      JsonReader();
+
+      //! Constructs a JsonReader.
+      /*!
+        \param data The JSON text to parse, it must remain valid while it is
+               being parsed.
+        \param size The size of the JSON text.
+      */
+      JsonReader(const char* data, std::size_t size);
+
+      //! Sets the JSON text to parse.
+      /*!
+        \param data The JSON text to parse, it must remain valid while it is
+               being parsed.
+        \param size The size of the JSON text.
+      */
+      void SetSource(const char* data, std::size_t size);
+
+      //! Returns the offset of the next character to parse.
+      std::size_t GetPosition() const;
+
+      //! Returns <code>true</code> iff only whitespace remains to be parsed.
+      bool IsEnd();
+
+      //! Parses the next value.
+      JsonValue Read();
+
+      //! Parses the next value.
+      /*!
+        \param value Stores the value that was parsed.
+      */
+      void Read(Out<JsonValue> value);
+
+      //! Begins reading the elements of an array one at a time, consuming
+      //! the array's opening bracket.
+      void ReadArrayStart();
+
+      //! Advances to the next element of an array begun with
+      //! ReadArrayStart, the element itself is then parsed with Read.
+      /*!
+        \return <code>true</code> iff an element follows, <code>false</code>
+                iff the array's closing bracket was consumed.
+      */
+      bool ReadArrayNext();
+
+    private:
+      struct Aggregate {
+        bool m_isObject;
+        std::size_t m_valueIndex;
+        std::size_t m_nameIndex;
+      };
+      const char* m_first;
+      const char* m_cursor;
+      const char* m_last;
+      bool m_isArrayStart;
+      std::vector<Aggregate> m_aggregates;
+      std::vector<std::string> m_names;
+      std::vector<JsonValue> m_values;
+
+      void SkipWhitespace();
+      void Expect(char c, const char* message);
+      void ReadLiteral(const char* literal, std::size_t size);
+      void ReadName();
+      std::string ReadString();
+      void ReadEscape(std::string& value);
+      std::uint32_t ReadCodeUnit();
+      double ReadNumber();
+      void BuildObject(const Aggregate& aggregate);
+      void BuildArray(const Aggregate& aggregate);
+  };
+
+  //! Parses a JSON document.
+  /*!
+    \param data The JSON text to parse.
+    \param size The size of the JSON text.
+    \return The value represented by the document.
+  */
+  inline JsonValue ParseJson(const char* data, std::size_t size) {
+    auto reader = JsonReader(data, size);
+    auto value = reader.Read();
+    if(!reader.IsEnd()) {
+      BOOST_THROW_EXCEPTION(JsonParserException("Unexpected trailing data.",
+        reader.GetPosition()));
+    }
+    return value;
+  }
+
+  //! Parses a JSON document.
+  /*!
+    \param source The JSON text to parse.
+    \return The value represented by the document.
+  */
+  inline JsonValue ParseJson(const std::string& source) {
+    return ParseJson(source.data(), source.size());
+  }
+
+  inline JsonReader::JsonReader()
+      : JsonReader(nullptr, 0) {}
+
+  inline JsonReader::JsonReader(const char* data, std::size_t size)
+      : m_first(data),
+        m_cursor(data),
+        m_last(data + size),
+        m_isArrayStart(false) {}
+
+  inline void JsonReader::SetSource(const char* data, std::size_t size) {
+    m_first = data;
+    m_cursor = data;
+    m_last = data + size;
+    m_isArrayStart = false;
+  }
+
+  inline std::size_t JsonReader::GetPosition() const {
+    return static_cast<std::size_t>(m_cursor - m_first);
+  }
+
+  inline bool JsonReader::IsEnd() {
+    SkipWhitespace();
+    return m_cursor == m_last;
+  }
+
+  inline JsonValue JsonReader::Read() {
+    auto value = JsonValue();
+    Read(Store(value));
+    return value;
+  }
+
+  inline void JsonReader::Read(Out<JsonValue> value) {
+    m_aggregates.clear();
+    m_names.clear();
+    m_values.clear();
+    while(true) {
+      SkipWhitespace();
+      if(m_cursor == m_last) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Unexpected end of JSON.",
+          GetPosition()));
+      }
+      auto c = *m_cursor;
+      if(c == '{') {
+        ++m_cursor;
+        SkipWhitespace();
+        if(m_cursor == m_last || *m_cursor != '}') {
+          m_aggregates.push_back({true, m_values.size(), m_names.size()});
+          ReadName();
+          continue;
+        }
+        ++m_cursor;
+        m_values.emplace_back(JsonObject());
+      } else if(c == '[') {
+        ++m_cursor;
+        SkipWhitespace();
+        if(m_cursor == m_last || *m_cursor != ']') {
+          m_aggregates.push_back({false, m_values.size(), m_names.size()});
+          continue;
+        }
+        ++m_cursor;
+        m_values.emplace_back(std::vector<JsonValue>());
+      } else if(c == '\"') {
+        m_values.emplace_back(ReadString());
+      } else if(c == '-' || (c >= '0' && c <= '9')) {
+        m_values.emplace_back(ReadNumber());
+      } else if(c == 't') {
+        ReadLiteral("true", 4);
+        m_values.emplace_back(true);
+      } else if(c == 'f') {
+        ReadLiteral("false", 5);
+        m_values.emplace_back(false);
+      } else if(c == 'n') {
+        ReadLiteral("null", 4);
+        m_values.emplace_back(JsonNull());
+      } else {
+        BOOST_THROW_EXCEPTION(JsonParserException("Invalid JSON value.",
+          GetPosition()));
+      }
+      while(true) {
+        if(m_aggregates.empty()) {
+          *value = std::move(m_values.back());
+          return;
+        }
+        auto& aggregate = m_aggregates.back();
+        SkipWhitespace();
+        if(m_cursor != m_last && *m_cursor == ',') {
+          ++m_cursor;
+          if(aggregate.m_isObject) {
+            ReadName();
+          }
+          break;
+        } else if(aggregate.m_isObject) {
+          Expect('}', "Expected ',' or '}'.");
+          BuildObject(aggregate);
+        } else {
+          Expect(']', "Expected ',' or ']'.");
+          BuildArray(aggregate);
+        }
+        m_aggregates.pop_back();
+      }
+    }
+  }
+
+  inline void JsonReader::ReadArrayStart() {
+    SkipWhitespace();
+    Expect('[', "Expected '['.");
+    m_isArrayStart = true;
+  }
+
+  inline bool JsonReader::ReadArrayNext() {
+    SkipWhitespace();
+    if(m_cursor != m_last && *m_cursor == ']') {
+      ++m_cursor;
+      m_isArrayStart = false;
+      return false;
+    }
+    if(m_isArrayStart) {
+      m_isArrayStart = false;
+    } else {
+      Expect(',', "Expected ',' or ']'.");
+    }
+    return true;
+  }
+
+  inline void JsonReader::SkipWhitespace() {
+    while(m_cursor != m_last && (*m_cursor == ' ' || *m_cursor == '\n' ||
+        *m_cursor == '\r' || *m_cursor == '\t')) {
+      ++m_cursor;
+    }
+  }
+
+  inline void JsonReader::Expect(char c, const char* message) {
+    if(m_cursor == m_last || *m_cursor != c) {
+      BOOST_THROW_EXCEPTION(JsonParserException(message, GetPosition()));
+    }
+    ++m_cursor;
+  }
+
+  inline void JsonReader::ReadLiteral(const char* literal, std::size_t size) {
+    if(static_cast<std::size_t>(m_last - m_cursor) < size ||
+        std::memcmp(m_cursor, literal, size) != 0) {
+      BOOST_THROW_EXCEPTION(JsonParserException("Invalid JSON value.",
+        GetPosition()));
+    }
+    m_cursor += size;
+  }
+
+  inline void JsonReader::ReadName() {
+    SkipWhitespace();
+    if(m_cursor == m_last || *m_cursor != '\"') {
+      BOOST_THROW_EXCEPTION(JsonParserException("Expected member name.",
+        GetPosition()));
+    }
+    m_names.push_back(ReadString());
+    SkipWhitespace();
+    Expect(':', "Expected ':'.");
+  }
+
+  inline std::string JsonReader::ReadString() {
+    ++m_cursor;
+    auto special = Details::FindJsonSpecialCharacter(m_cursor, m_last);
+    auto value = std::string(m_cursor, special);
+    m_cursor = special;
+    while(true) {
+      if(m_cursor == m_last) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Unterminated string.",
+          GetPosition()));
+      } else if(*m_cursor == '\"') {
+        ++m_cursor;
+        return value;
+      } else if(*m_cursor == '\\') {
+        ++m_cursor;
+        ReadEscape(value);
+      } else {
+        BOOST_THROW_EXCEPTION(JsonParserException(
+          "Invalid character in string.", GetPosition()));
+      }
+      special = Details::FindJsonSpecialCharacter(m_cursor, m_last);
+      value.append(m_cursor, special);
+      m_cursor = special;
+    }
+  }
+
+  inline void JsonReader::ReadEscape(std::string& value) {
+    if(m_cursor == m_last) {
+      BOOST_THROW_EXCEPTION(JsonParserException("Unterminated string.",
+        GetPosition()));
+    }
+    auto c = *m_cursor;
+    ++m_cursor;
+    if(c == '\"' || c == '\\' || c == '/') {
+      value += c;
+    } else if(c == 'b') {
+      value += '\b';
+    } else if(c == 'f') {
+      value += '\f';
+    } else if(c == 'n') {
+      value += '\n';
+    } else if(c == 'r') {
+      value += '\r';
+    } else if(c == 't') {
+      value += '\t';
+    } else if(c == 'u') {
+      auto codePoint = ReadCodeUnit();
+      if(codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+        if(m_last - m_cursor < 2 || m_cursor[0] != '\\' ||
+            m_cursor[1] != 'u') {
+          BOOST_THROW_EXCEPTION(JsonParserException("Unpaired surrogate.",
+            GetPosition()));
+        }
+        m_cursor += 2;
+        auto low = ReadCodeUnit();
+        if(low < 0xDC00 || low > 0xDFFF) {
+          BOOST_THROW_EXCEPTION(JsonParserException("Unpaired surrogate.",
+            GetPosition()));
+        }
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+      } else if(codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Unpaired surrogate.",
+          GetPosition()));
+      }
+      if(codePoint < 0x80) {
+        value += static_cast<char>(codePoint);
+      } else if(codePoint < 0x800) {
+        value += static_cast<char>(0xC0 | (codePoint >> 6));
+        value += static_cast<char>(0x80 | (codePoint & 0x3F));
+      } else if(codePoint < 0x10000) {
+        value += static_cast<char>(0xE0 | (codePoint >> 12));
+        value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        value += static_cast<char>(0x80 | (codePoint & 0x3F));
+      } else {
+        value += static_cast<char>(0xF0 | (codePoint >> 18));
+        value += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        value += static_cast<char>(0x80 | (codePoint & 0x3F));
+      }
+    } else {
+      BOOST_THROW_EXCEPTION(JsonParserException("Invalid escape sequence.",
+        GetPosition() - 1));
+    }
+  }
+
+  inline std::uint32_t JsonReader::ReadCodeUnit() {
+    if(m_last - m_cursor < 4) {
+      BOOST_THROW_EXCEPTION(JsonParserException("Invalid escape sequence.",
+        GetPosition()));
+    }
+    auto codeUnit = std::uint32_t(0);
+    for(auto i = 0; i < 4; ++i) {
+      auto c = m_cursor[i];
+      codeUnit <<= 4;
+      if(c >= '0' && c <= '9') {
+        codeUnit |= static_cast<std::uint32_t>(c - '0');
+      } else if(c >= 'a' && c <= 'f') {
+        codeUnit |= static_cast<std::uint32_t>(c - 'a' + 10);
+      } else if(c >= 'A' && c <= 'F') {
+        codeUnit |= static_cast<std::uint32_t>(c - 'A' + 10);
+      } else {
+        BOOST_THROW_EXCEPTION(JsonParserException("Invalid escape sequence.",
+          GetPosition() + i));
+      }
+    }
+    m_cursor += 4;
+    return codeUnit;
+  }
+
+  inline double JsonReader::ReadNumber() {
+    const auto MAX_EXACT_DIGITS = 15;
+    auto first = m_cursor;
+    auto isDigit = [&] {
+      return m_cursor != m_last && *m_cursor >= '0' && *m_cursor <= '9';
+    };
+    auto isNegative = *m_cursor == '-';
+    if(isNegative) {
+      ++m_cursor;
+    }
+    if(!isDigit()) {
+      BOOST_THROW_EXCEPTION(JsonParserException("Invalid number.",
+        GetPosition()));
+    }
+    auto mantissa = std::uint64_t(0);
+    auto digits = 0;
+    if(*m_cursor == '0') {
+      ++m_cursor;
+      digits = 1;
+    } else {
+      while(isDigit()) {
+        mantissa = 10 * mantissa + static_cast<std::uint64_t>(*m_cursor - '0');
+        ++digits;
+        ++m_cursor;
+      }
+    }
+    auto isInteger = true;
+    if(m_cursor != m_last && *m_cursor == '.') {
+      isInteger = false;
+      ++m_cursor;
+      if(!isDigit()) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Invalid number.",
+          GetPosition()));
+      }
+      while(isDigit()) {
+        ++m_cursor;
+      }
+    }
+    if(m_cursor != m_last && (*m_cursor == 'e' || *m_cursor == 'E')) {
+      isInteger = false;
+      ++m_cursor;
+      if(m_cursor != m_last && (*m_cursor == '+' || *m_cursor == '-')) {
+        ++m_cursor;
+      }
+      if(!isDigit()) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Invalid number.",
+          GetPosition()));
+      }
+      while(isDigit()) {
+        ++m_cursor;
+      }
+    }
+    if(isInteger && digits <= MAX_EXACT_DIGITS) {
+      auto value = static_cast<double>(mantissa);
+      if(isNegative) {
+        return -value;
+      }
+      return value;
+    }
+    auto value = double();
+    auto result = std::from_chars(first, m_cursor, value);
+    if(result.ec != std::errc()) {
+
+      // Values too small to represent round to zero, too large is an error.
+      value = std::strtod(std::string(first, m_cursor).c_str(), nullptr);
+      if(!std::isfinite(value)) {
+        BOOST_THROW_EXCEPTION(JsonParserException("Number out of range.",
+          static_cast<std::size_t>(first - m_first)));
+      }
+    }
+    return value;
+  }
+
+  inline void JsonReader::BuildObject(const Aggregate& aggregate) {
+    auto object = JsonObject();
+    object.Reserve(m_values.size() - aggregate.m_valueIndex);
+    for(auto i = aggregate.m_valueIndex, j = aggregate.m_nameIndex;
+        i != m_values.size(); ++i, ++j) {
+      auto index = object.Find(m_names[j]);
+      if(index == object.GetSize()) {
+        object.Add(std::move(m_names[j]), std::move(m_values[i]));
+      } else {
+        object.m_values[index] = std::move(m_values[i]);
+      }
+    }
+    m_names.resize(aggregate.m_nameIndex);
+    m_values.resize(aggregate.m_valueIndex);
+    m_values.emplace_back(std::move(object));
+  }
+
+  inline void JsonReader::BuildArray(const Aggregate& aggregate) {
+    auto array = std::vector<JsonValue>(
+      std::make_move_iterator(m_values.begin() + aggregate.m_valueIndex),
+      std::make_move_iterator(m_values.end()));
+    m_values.resize(aggregate.m_valueIndex);
+    m_values.emplace_back(std::move(array));
+  }
+}
+
+#endif
@@ -1,14 +1,17 @@
 #ifndef BEAM_JSONVALUE_HPP
 #define BEAM_JSONVALUE_HPP
-#include <cmath>
 #include <cstdint>
+#include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <boost/variant/apply_visitor.hpp>
 #include <boost/variant/get.hpp>
 #include <boost/variant/variant.hpp>
+#include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Json/Json.hpp"
-#include "Beam/Utilities/ToString.hpp"
+#include "Beam/Json/JsonWriter.hpp"
+#include "Beam/Pointers/Out.hpp"
 #include "Beam/Utilities/VariantLambdaVisitor.hpp"
 
 namespace Beam {
@@ -51,6 +54,12 @@ namespace Details {
       */
       JsonValue(const JsonValue& value);
 
+      //! Acquires a JsonValue.
+      /*!
+        \param value The value to acquire.
+      */
+      JsonValue(JsonValue&& value) noexcept;
+
       //! Constructs a null value.
       /*!
         \param value The value to represent.
@@ -87,6 +96,12 @@ namespace Details {
       */
       JsonValue(const std::string& value);
 
+      //! Constructs a string value.
+      /*!
+        \param value The value to acquire.
+      */
+      JsonValue(std::string&& value);
+
       //! Constructs a string value.
       /*!
         \param value The value to represent.
@@ -99,12 +114,24 @@ namespace Details {
       */
       JsonValue(const JsonObject& value);
 
+      //! Constructs an object value.
+      /*!
+        \param value The value to acquire.
+      */
+      JsonValue(JsonObject&& value);
+
       //! Constructs an array value.
       /*!
         \param value The value to represent.
       */
       JsonValue(const std::vector<JsonValue>& value);
 
+      //! Constructs an array value.
+      /*!
+        \param value The value to acquire.
+      */
+      JsonValue(std::vector<JsonValue>&& value);
+
       //! Tests if two JSON values are equal.
       /*!
         \param value The value to test for equality.
@@ -126,6 +153,13 @@ namespace Details {
       */
       JsonValue& operator =(const JsonValue& value);
 
+      //! Acquires a generic JSON value.
+      /*!
+        \param value The value to acquire.
+        \return <code>*this</code>
+      */
+      JsonValue& operator =(JsonValue&& value) noexcept;
+
       //! Assigns a null value.
       /*!
         \param value The value to represent.
@@ -168,6 +202,13 @@ namespace Details {
       */
       JsonValue& operator =(const std::string& value);
 
+      //! Assigns a string value.
+      /*!
+        \param value The value to represent.
+        \return <code>*this</code>
+      */
+      JsonValue& operator =(const char* value);
+
       //! Assigns an object value.
       /*!
         \param value The value to represent.
@@ -187,6 +228,14 @@ namespace Details {
         \param sink The stream to save <code>this</code> object to.
       */
       void Save(std::ostream& sink) const;
+
+      //! Appends the JSON representation of <code>this</code> object to a
+      //! Buffer.
+      /*!
+        \param sink The Buffer to append <code>this</code> object to.
+      */
+      template<typename Buffer>
+      void Save(Out<Buffer> sink) const;
   };
 
   //! Saves a JSON value to an output stream.
@@ -200,20 +249,6 @@ namespace Details {
     return sink;
   }
 
-namespace Details {
-  struct JsonAssignmentVisitor : public boost::static_visitor<> {
-    JsonValue* m_self;
-
-    JsonAssignmentVisitor(JsonValue* self)
-        : m_self(self) {}
-
-    template <typename T>
-    void operator()(const T& value) const {
-      *m_self = value;
-    }
-  };
-}
-
   inline JsonNull::JsonNull() {}
 
   inline bool JsonNull::operator ==(JsonNull rhs) const {
@@ -226,9 +261,11 @@ namespace Details {
   inline JsonValue::JsonValue(const Details::JsonVariant& variant)
       : Details::JsonVariant(variant) {}
 
-  inline JsonValue::JsonValue(const JsonValue& value) {
-    *this = value;
-  }
+  inline JsonValue::JsonValue(const JsonValue& value)
+      : Details::JsonVariant(static_cast<const Details::JsonVariant&>(value)) {}
+
+  inline JsonValue::JsonValue(JsonValue&& value) noexcept
+      : Details::JsonVariant(static_cast<Details::JsonVariant&&>(value)) {}
 
   inline JsonValue::JsonValue(JsonNull value)
       : Details::JsonVariant(value) {}
@@ -248,15 +285,24 @@ namespace Details {
   inline JsonValue::JsonValue(const std::string& value)
       : Details::JsonVariant(value) {}
 
+  inline JsonValue::JsonValue(std::string&& value)
+      : Details::JsonVariant(std::move(value)) {}
+
   inline JsonValue::JsonValue(const char* value)
       : JsonValue{std::string{value}} {}
 
   inline JsonValue::JsonValue(const JsonObject& value)
       : Details::JsonVariant(value) {}
 
+  inline JsonValue::JsonValue(JsonObject&& value)
+      : Details::JsonVariant(std::move(value)) {}
+
   inline JsonValue::JsonValue(const std::vector<JsonValue>& value)
       : Details::JsonVariant(value) {}
 
+  inline JsonValue::JsonValue(std::vector<JsonValue>&& value)
+      : Details::JsonVariant(std::move(value)) {}
+
   inline bool JsonValue::operator ==(const JsonValue& value) const {
     return Details::JsonVariant::operator ==(
       static_cast<const Details::JsonVariant&>(value));
@@ -270,11 +316,17 @@ namespace Details {
     if(this == &value) {
       return *this;
     }
-    boost::apply_visitor(Details::JsonAssignmentVisitor(this),
+    Details::JsonVariant::operator =(
       static_cast<const Details::JsonVariant&>(value));
     return *this;
   }
 
+  inline JsonValue& JsonValue::operator =(JsonValue&& value) noexcept {
+    Details::JsonVariant::operator =(
+      static_cast<Details::JsonVariant&&>(value));
+    return *this;
+  }
+
   inline JsonValue& JsonValue::operator =(JsonNull value) {
     Details::JsonVariant::operator =(value);
     return *this;
@@ -305,6 +357,11 @@ namespace Details {
     return *this;
   }
 
+  inline JsonValue& JsonValue::operator =(const char* value) {
+    Details::JsonVariant::operator =(std::string(value));
+    return *this;
+  }
+
   inline JsonValue& JsonValue::operator =(const JsonObject& value) {
     Details::JsonVariant::operator =(value);
     return *this;
@@ -316,40 +373,43 @@ namespace Details {
   }
 
   inline void JsonValue::Save(std::ostream& sink) const {
+    auto buffer = IO::SharedBuffer();
+    Save(Store(buffer));
+    sink.write(buffer.GetData(), static_cast<std::streamsize>(
+      buffer.GetSize()));
+  }
+
+  template<typename Buffer>
+  void JsonValue::Save(Out<Buffer> sink) const {
     auto visitor = MakeVariantLambdaVisitor<void>(
-      [&] (JsonNull value) {
-        sink << "null";
+      [&] (JsonNull) {
+        sink->Append("null", 4);
       },
       [&] (bool value) {
         if(value) {
-          sink << "true";
+          sink->Append("true", 4);
         } else {
-          sink << "false";
+          sink->Append("false", 5);
         }
       },
       [&] (double value) {
-        double temp;
-        if(std::modf(value, &temp) != 0) {
-          sink << ToString(value);
-        } else {
-          sink << static_cast<int>(value);
-        }
+        WriteJsonNumber(value, Store(sink));
       },
       [&] (const std::string& value) {
-        sink << '\"' << value + '\"';
+        WriteJsonString(value, Store(sink));
       },
       [&] (const JsonObject& value) {
-        value.Save(sink);
+        value.Save(Store(sink));
       },
       [&] (const std::vector<JsonValue>& value) {
-        sink << '[';
+        sink->Append('[');
         for(auto i = value.begin(); i != value.end(); ++i) {
-          i->Save(sink);
-          if(i != value.end() - 1) {
-            sink << ',';
+          if(i != value.begin()) {
+            sink->Append(',');
           }
+          i->Save(Store(sink));
         }
-        sink << ']';
+        sink->Append(']');
       }
     );
     boost::apply_visitor(visitor, *this);
@@ -0,0 +1,104 @@
+#ifndef BEAM_JSONWRITER_HPP
+#define BEAM_JSONWRITER_HPP
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include "Beam/Json/Json.hpp"
+#include "Beam/Json/JsonDetails.hpp"
+#include "Beam/Pointers/Out.hpp"
+
+namespace Beam {
+namespace Details {
+  inline char GetJsonEscape(char c) {
+    switch(c) {
+      case '\"':
+        return '\"';
+      case '\\':
+        return '\\';
+      case '\b':
+        return 'b';
+      case '\f':
+        return 'f';
+      case '\n':
+        return 'n';
+      case '\r':
+        return 'r';
+      case '\t':
+        return 't';
+      default:
+        return '\0';
+    }
+  }
+}
+
+  //! Appends a quoted and escaped JSON string to a Buffer.
+  /*!
+    \param value The characters to write.
+    \param size The number of characters to write.
+    \param sink The Buffer to append the string to.
+  */
+  template<typename Buffer>
+  void WriteJsonString(const char* value, std::size_t size, Out<Buffer> sink) {
+    sink->Append('\"');
+    auto last = value + size;
+    while(true) {
+      auto special = Details::FindJsonSpecialCharacter(value, last);
+      if(special != value) {
+        sink->Append(value, static_cast<std::size_t>(special - value));
+      }
+      if(special == last) {
+        break;
+      }
+      if(auto escape = Details::GetJsonEscape(*special)) {
+        char sequence[] = {'\\', escape};
+        sink->Append(sequence, sizeof(sequence));
+      } else {
+        const auto HEX_DIGITS = "0123456789abcdef";
+        auto code = static_cast<unsigned char>(*special);
+        char sequence[] = {'\\', 'u', '0', '0', HEX_DIGITS[code >> 4],
+          HEX_DIGITS[code & 0x0F]};
+        sink->Append(sequence, sizeof(sequence));
+      }
+      value = special + 1;
+    }
+    sink->Append('\"');
+  }
+
+  //! Appends a quoted and escaped JSON string to a Buffer.
+  /*!
+    \param value The string to write.
+    \param sink The Buffer to append the string to.
+  */
+  template<typename Buffer>
+  void WriteJsonString(const std::string& value, Out<Buffer> sink) {
+    WriteJsonString(value.data(), value.size(), Store(sink));
+  }
+
+  //! Appends a JSON number to a Buffer using the shortest representation
+  //! that reads back exactly, integers are written without a fraction and
+  //! non-finite values are written as null.
+  /*!
+    \param value The number to write.
+    \param sink The Buffer to append the number to.
+  */
+  template<typename Buffer>
+  void WriteJsonNumber(double value, Out<Buffer> sink) {
+    const auto MAX_EXACT_INTEGER = 9007199254740992.0;
+    if(!std::isfinite(value)) {
+      sink->Append("null", 4);
+      return;
+    }
+    char buffer[32];
+    auto result = [&] {
+      if(std::trunc(value) == value && std::abs(value) <= MAX_EXACT_INTEGER) {
+        return std::to_chars(buffer, buffer + sizeof(buffer),
+          static_cast<std::int64_t>(value));
+      }
+      return std::to_chars(buffer, buffer + sizeof(buffer), value);
+    }();
+    sink->Append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+  }
+}
+
+#endif
@@ -1,5 +1,6 @@
 #ifndef BEAM_DATAGRAMPACKET_HPP
 #define BEAM_DATAGRAMPACKET_HPP
+#include <boost/date_time/posix_time/ptime.hpp>
 #include "Beam/IO/Buffer.hpp"
 #include "Beam/Network/IpAddress.hpp"
 
@@ -27,6 +28,16 @@ namespace Network {
       template<typename BufferForward, typename IpAddressForward>
       DatagramPacket(BufferForward&& data, IpAddressForward&& address);
 
+      //! Constructs a DatagramPacket.
+      /*!
+        \param data The data stored by the packet.
+        \param address The address that this packet was received from.
+        \param timestamp The time the packet was received by the kernel.
+      */
+      template<typename BufferForward, typename IpAddressForward>
+      DatagramPacket(BufferForward&& data, IpAddressForward&& address,
+        boost::posix_time::ptime timestamp);
+
       //! Returns the data stored by this packet.
       const Buffer& GetData() const;
 
@@ -39,9 +50,17 @@ namespace Network {
       //! Returns the address that this packet was received from.
       IpAddress& GetAddress();
 
+      //! Returns the time the packet was received by the kernel, or
+      //! <code>not_a_date_time</code> if it was not recorded.
+      boost::posix_time::ptime GetTimestamp() const;
+
+      //! Sets the time the packet was received by the kernel.
+      void SetTimestamp(boost::posix_time::ptime timestamp);
+
     private:
       Buffer m_data;
       IpAddress m_address;
+      boost::posix_time::ptime m_timestamp;
   };
 
   template<typename BufferType>
@@ -51,6 +70,14 @@ namespace Network {
       : m_data(std::forward<BufferForward>(data)),
         m_address(std::forward<IpAddressForward>(address)) {}
 
+  template<typename BufferType>
+  template<typename BufferForward, typename IpAddressForward>
+  DatagramPacket<BufferType>::DatagramPacket(BufferForward&& data,
+      IpAddressForward&& address, boost::posix_time::ptime timestamp)
+      : m_data(std::forward<BufferForward>(data)),
+        m_address(std::forward<IpAddressForward>(address)),
+        m_timestamp(timestamp) {}
+
   template<typename BufferType>
   const BufferType& DatagramPacket<BufferType>::GetData() const {
     return m_data;
@@ -70,6 +97,17 @@ namespace Network {
   IpAddress& DatagramPacket<BufferType>::GetAddress() {
     return m_address;
   }
+
+  template<typename BufferType>
+  boost::posix_time::ptime DatagramPacket<BufferType>::GetTimestamp() const {
+    return m_timestamp;
+  }
+
+  template<typename BufferType>
+  void DatagramPacket<BufferType>::SetTimestamp(
+      boost::posix_time::ptime timestamp) {
+    m_timestamp = timestamp;
+  }
 }
 }
 
@@ -223,8 +223,8 @@ namespace Network {
     m_socket.reset();
     m_receiver = std::nullopt;
     m_sender = std::nullopt;
-    m_socket = std::make_shared<Details::UdpSocketEntry>(
-      m_socketThreadPool->GetService(), m_socketThreadPool->GetService(),
+    auto& service = m_socketThreadPool->GetService();
+    m_socket = std::make_shared<Details::UdpSocketEntry>(service, service,
       boost::asio::ip::udp::v4());
     m_receiver.emplace(m_socket);
     m_sender.emplace(m_socket);
@@ -10,8 +10,10 @@ namespace Network {
   class MulticastSocketConnection;
   class MulticastSocketReader;
   class MulticastSocketWriter;
+  class SecureServerSocket;
   class SecureSocketChannel;
   class SecureSocketConnection;
+  class SecureSocketContext;
   class SecureSocketReader;
   class SecureSocketWriter;
   class SocketException;
@@ -20,6 +22,7 @@ namespace Network {
   class TcpServerSocket;
   class TcpSocketChannel;
   class TcpSocketConnection;
+  struct TcpSocketOptions;
   class TcpSocketReader;
   class TcpSocketWriter;
   class UdpSocket;
@@ -8,6 +8,8 @@
 #include <boost/asio/ip/udp.hpp>
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/Network/Network.hpp"
+#include "Beam/Network/SecureSocketContext.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Threading/ConditionVariable.hpp"
 #include "Beam/Threading/Mutex.hpp"
 
@@ -25,6 +27,9 @@ namespace Details {
     int m_pendingWrites;
     Threading::ConditionVariable m_isPendingCondition;
 
+    explicit SocketEntry(boost::asio::io_service& ioService)
+      : SocketEntry(ioService, ioService) {}
+
     template<typename... Args>
     SocketEntry(boost::asio::io_service& ioService, Args&&... args)
         : m_ioService(&ioService),
@@ -77,21 +82,31 @@ namespace Details {
 
 
   struct SecureSocketEntry {
-    using Socket = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+    using Socket = SecureSocketContext::Socket;
     Threading::Mutex m_mutex;
     boost::asio::io_service* m_ioService;
-    boost::asio::ssl::context m_context;
+    std::unique_ptr<SecureSocketContext> m_defaultContext;
+    SecureSocketContext* m_context;
     Socket m_socket;
     bool m_isOpen;
     bool m_isReadPending;
     int m_pendingWrites;
     Threading::ConditionVariable m_isPendingCondition;
 
-    template<typename... Args>
-    SecureSocketEntry(boost::asio::io_service& ioService, Args&&... args)
+    explicit SecureSocketEntry(boost::asio::io_service& ioService)
+        : m_ioService(&ioService),
+          m_defaultContext(std::make_unique<SecureSocketContext>()),
+          m_context(m_defaultContext.get()),
+          m_socket{ioService, m_context->GetContext()},
+          m_isOpen{false},
+          m_isReadPending{false},
+          m_pendingWrites{0} {}
+
+    SecureSocketEntry(boost::asio::io_service& ioService,
+        SecureSocketContext& context)
         : m_ioService(&ioService),
-          m_context{boost::asio::ssl::context::sslv23},
-          m_socket{std::forward<Args>(args)..., m_context},
+          m_context(&context),
+          m_socket{ioService, m_context->GetContext()},
           m_isOpen{false},
           m_isReadPending{false},
           m_pendingWrites{0} {}
@@ -151,6 +166,62 @@ namespace Details {
       error == boost::asio::error::shut_down ||
       error == boost::asio::error::timed_out;
   }
+
+  inline void SetQuickAck(boost::asio::ip::tcp::socket& socket,
+      boost::system::error_code& error) {
+#ifdef TCP_QUICKACK
+    socket.set_option(boost::asio::detail::socket_option::boolean<
+      IPPROTO_TCP, TCP_QUICKACK>(true), error);
+#endif
+  }
+
+  inline void ApplyTcpSocketOptions(boost::asio::ip::tcp::socket& socket,
+      const TcpSocketOptions& options, boost::system::error_code& error) {
+    using boost::asio::detail::socket_option::integer;
+    socket.set_option(boost::asio::ip::tcp::no_delay(options.m_noDelayEnabled),
+      error);
+    if(!error && options.m_writeBufferSize != 0) {
+      socket.set_option(boost::asio::socket_base::send_buffer_size(
+        options.m_writeBufferSize), error);
+    }
+    if(!error && options.m_readBufferSize != 0) {
+      socket.set_option(boost::asio::socket_base::receive_buffer_size(
+        options.m_readBufferSize), error);
+    }
+    if(!error && options.m_quickAckEnabled) {
+      SetQuickAck(socket, error);
+    }
+#ifdef SO_BUSY_POLL
+    if(!error && options.m_busyPollTimeout.total_microseconds() != 0) {
+      socket.set_option(integer<SOL_SOCKET, SO_BUSY_POLL>(
+        static_cast<int>(options.m_busyPollTimeout.total_microseconds())),
+        error);
+    }
+#endif
+    if(error || !options.m_keepAliveEnabled) {
+      return;
+    }
+    socket.set_option(boost::asio::socket_base::keep_alive(true), error);
+#ifdef TCP_KEEPIDLE
+    if(!error && options.m_keepAliveIdle.total_seconds() != 0) {
+      socket.set_option(integer<IPPROTO_TCP, TCP_KEEPIDLE>(
+        static_cast<int>(options.m_keepAliveIdle.total_seconds())), error);
+    }
+#endif
+#ifdef TCP_KEEPINTVL
+    if(!error && options.m_keepAliveInterval.total_seconds() != 0) {
+      socket.set_option(integer<IPPROTO_TCP, TCP_KEEPINTVL>(
+        static_cast<int>(options.m_keepAliveInterval.total_seconds())),
+        error);
+    }
+#endif
+#ifdef TCP_KEEPCNT
+    if(!error && options.m_keepAliveCount != 0) {
+      socket.set_option(integer<IPPROTO_TCP, TCP_KEEPCNT>(
+        options.m_keepAliveCount), error);
+    }
+#endif
+  }
 }
 }
 }
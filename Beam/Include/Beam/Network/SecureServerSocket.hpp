@@ -0,0 +1,230 @@
+#ifndef BEAM_SECURE_SERVER_SOCKET_HPP
+#define BEAM_SECURE_SERVER_SOCKET_HPP
+#include <memory>
+#include <unordered_set>
+#include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/OpenState.hpp"
+#include "Beam/IO/ServerConnection.hpp"
+#include "Beam/Network/IpAddress.hpp"
+#include "Beam/Network/Network.hpp"
+#include "Beam/Network/SecureSocketChannel.hpp"
+#include "Beam/Network/SecureSocketContext.hpp"
+#include "Beam/Network/SocketException.hpp"
+#include "Beam/Network/SocketThreadPool.hpp"
+#include "Beam/Pointers/Ref.hpp"
+#include "Beam/Queues/Queue.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+#include "Beam/Threading/ConditionVariable.hpp"
+#include "Beam/Threading/Mutex.hpp"
+#include "Beam/Utilities/ToString.hpp"
+
+namespace Beam {
+namespace Network {
+
+  /*! \class SecureServerSocket
+      \brief Implements a server socket accepting SecureSocketChannels.
+      \details Connections are accepted continuously once opened and each
+               handshake runs in its own Routine through the
+               SecureSocketContext, so a slow or stalled handshake doesn't
+               hold up the connections behind it. Accept returns channels
+               whose handshake completed, connections whose handshake fails
+               are dropped.
+   */
+  class SecureServerSocket : private boost::noncopyable {
+    public:
+      using Channel = SecureSocketChannel;
+
+      //! Constructs a SecureServerSocket.
+      /*!
+        \param address The IP address to bind to.
+        \param context The server context holding the certificate and the
+               session cache.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      SecureServerSocket(const IpAddress& address,
+        Ref<SecureSocketContext> context,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      ~SecureServerSocket();
+
+      std::unique_ptr<Channel> Accept();
+
+      void Open();
+
+      void Close();
+
+    private:
+      IpAddress m_address;
+      SecureSocketContext* m_context;
+      SocketThreadPool* m_socketThreadPool;
+      boost::optional<boost::asio::ip::tcp::acceptor> m_acceptor;
+      Queue<Channel*> m_channels;
+      Threading::Mutex m_mutex;
+      std::unordered_set<Channel*> m_pendingChannels;
+      Threading::ConditionVariable m_pendingCondition;
+      Routines::RoutineHandler m_acceptRoutine;
+      IO::OpenState m_openState;
+
+      void Shutdown();
+      void AcceptLoop();
+      void Handshake(std::unique_ptr<Channel> channel);
+  };
+
+  inline SecureServerSocket::SecureServerSocket(const IpAddress& address,
+      Ref<SecureSocketContext> context, Ref<SocketThreadPool> socketThreadPool)
+      : m_address(address),
+        m_context(context.Get()),
+        m_socketThreadPool(socketThreadPool.Get()) {}
+
+  inline SecureServerSocket::~SecureServerSocket() {
+    Close();
+  }
+
+  inline std::unique_ptr<SecureServerSocket::Channel>
+      SecureServerSocket::Accept() {
+    auto channel = static_cast<Channel*>(nullptr);
+    m_channels.Emplace(Store(channel));
+    return std::unique_ptr<Channel>(channel);
+  }
+
+  inline void SecureServerSocket::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      auto& ioService = m_socketThreadPool->GetService();
+      boost::asio::ip::tcp::resolver resolver(ioService);
+      boost::asio::ip::tcp::resolver::query query(m_address.GetHost(),
+        ToString(m_address.GetPort()));
+      boost::system::error_code error;
+      auto endpointIterator = resolver.resolve(query, error);
+      if(error) {
+        BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
+      }
+      auto endpoint = boost::asio::ip::tcp::endpoint(*endpointIterator);
+      m_acceptor.emplace(ioService);
+      m_acceptor->open(endpoint.protocol());
+      m_acceptor->set_option(
+        boost::asio::ip::tcp::acceptor::reuse_address(true));
+      m_acceptor->bind(endpoint);
+      m_acceptor->listen();
+    } catch(const SocketException&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    } catch(const boost::system::system_error& e) {
+      m_openState.SetOpenFailure(
+        SocketException{e.code().value(), e.code().message()});
+      Shutdown();
+    } catch(const std::exception& e) {
+      m_openState.SetOpenFailure(IO::ConnectException{e.what()});
+      Shutdown();
+    }
+    m_acceptRoutine = Routines::Spawn(
+      [=] {
+        AcceptLoop();
+      });
+    m_openState.SetOpen();
+  }
+
+  inline void SecureServerSocket::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  inline void SecureServerSocket::Shutdown() {
+    if(m_acceptor.is_initialized()) {
+      auto error = boost::system::error_code();
+      m_acceptor->close(error);
+    }
+    m_acceptRoutine.Wait();
+    m_channels.Break(IO::EndOfFileException());
+    {
+      boost::unique_lock<Threading::Mutex> lock(m_mutex);
+      for(auto channel : m_pendingChannels) {
+        auto error = boost::system::error_code();
+        channel->m_socket->m_socket.lowest_layer().shutdown(
+          boost::asio::ip::tcp::socket::shutdown_both, error);
+      }
+      while(!m_pendingChannels.empty()) {
+        m_pendingCondition.wait(lock);
+      }
+    }
+    auto channel = static_cast<Channel*>(nullptr);
+    try {
+      while(m_channels.TryEmplace(Store(channel))) {
+        delete channel;
+      }
+    } catch(const std::exception&) {}
+    m_openState.SetClosed();
+  }
+
+  inline void SecureServerSocket::AcceptLoop() {
+    while(true) {
+      auto channel = std::unique_ptr<Channel>(new Channel(*m_context,
+        m_socketThreadPool->GetService()));
+      Routines::Async<void> acceptAsync;
+      auto acceptEval = acceptAsync.GetEval();
+      m_acceptor->async_accept(channel->m_socket->m_socket.lowest_layer(),
+        [&] (const boost::system::error_code& error) {
+          if(error) {
+            acceptEval.SetException(SocketException(error.value(),
+              error.message()));
+          } else {
+            acceptEval.SetResult();
+          }
+        });
+      try {
+        acceptAsync.Get();
+      } catch(const std::exception&) {
+        return;
+      }
+      try {
+        auto& endpoint = channel->m_socket->m_socket.lowest_layer();
+        channel->SetAddress(IpAddress(
+          endpoint.remote_endpoint().address().to_string(),
+          endpoint.remote_endpoint().port()));
+      } catch(const std::exception&) {
+        continue;
+      }
+      {
+        boost::lock_guard<Threading::Mutex> lock(m_mutex);
+        m_pendingChannels.insert(channel.get());
+      }
+      Routines::Spawn(
+        [this, channel = std::move(channel)] () mutable {
+          Handshake(std::move(channel));
+        });
+    }
+  }
+
+  inline void SecureServerSocket::Handshake(std::unique_ptr<Channel> channel) {
+    auto isAccepted = false;
+    try {
+      m_context->Handshake(channel->m_socket->m_socket,
+        boost::asio::ssl::stream_base::server, {});
+      channel->GetConnection().SetOpen();
+      m_channels.Push(channel.get());
+      isAccepted = true;
+    } catch(const std::exception&) {}
+    boost::lock_guard<Threading::Mutex> lock(m_mutex);
+    m_pendingChannels.erase(channel.get());
+    if(isAccepted) {
+      channel.release();
+    }
+    if(m_pendingChannels.empty()) {
+      m_pendingCondition.notify_all();
+    }
+  }
+}
+
+  template<>
+  struct ImplementsConcept<Network::SecureServerSocket,
+    IO::ServerConnection<Network::SecureServerSocket::Channel>> :
+    std::true_type {};
+}
+
+#endif
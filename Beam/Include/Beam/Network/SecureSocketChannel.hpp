@@ -6,6 +6,7 @@
 #include "Beam/Network/Network.hpp"
 #include "Beam/Network/NetworkDetails.hpp"
 #include "Beam/Network/SecureSocketConnection.hpp"
+#include "Beam/Network/SecureSocketContext.hpp"
 #include "Beam/Network/SecureSocketReader.hpp"
 #include "Beam/Network/SecureSocketWriter.hpp"
 #include "Beam/Network/SocketIdentifier.hpp"
@@ -33,13 +34,36 @@ namespace Network {
       SecureSocketChannel(const IpAddress& address,
         Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a SecureSocketChannel.
+      /*!
+        \param address The IP address to connect to.
+        \param context The context used to resume sessions and perform
+               handshakes.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      SecureSocketChannel(const IpAddress& address,
+        Ref<SecureSocketContext> context,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      //! Constructs a SecureSocketChannel.
+      /*!
+        \param address The IP address to connect to.
+        \param interface The interface to bind to.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      SecureSocketChannel(const IpAddress& address, const IpAddress& interface,
+        Ref<SocketThreadPool> socketThreadPool);
+
       //! Constructs a SecureSocketChannel.
       /*!
         \param address The IP address to connect to.
         \param interface The interface to bind to.
+        \param context The context used to resume sessions and perform
+               handshakes.
         \param socketThreadPool The thread pool used for the sockets.
       */
       SecureSocketChannel(const IpAddress& address, const IpAddress& interface,
+        Ref<SecureSocketContext> context,
         Ref<SocketThreadPool> socketThreadPool);
 
       //! Constructs a SecureSocketChannel.
@@ -50,6 +74,17 @@ namespace Network {
       SecureSocketChannel(const std::vector<IpAddress>& addresses,
         Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a SecureSocketChannel.
+      /*!
+        \param addresses The list of IP addresses to try to connect to.
+        \param context The context used to resume sessions and perform
+               handshakes.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      SecureSocketChannel(const std::vector<IpAddress>& addresses,
+        Ref<SecureSocketContext> context,
+        Ref<SocketThreadPool> socketThreadPool);
+
       //! Constructs a SecureSocketChannel.
       /*!
         \param addresses The list of IP addresses to try to connect to.
@@ -59,6 +94,18 @@ namespace Network {
       SecureSocketChannel(const std::vector<IpAddress>& addresses,
         const IpAddress& interface, Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a SecureSocketChannel.
+      /*!
+        \param addresses The list of IP addresses to try to connect to.
+        \param interface The interface to bind to.
+        \param context The context used to resume sessions and perform
+               handshakes.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      SecureSocketChannel(const std::vector<IpAddress>& addresses,
+        const IpAddress& interface, Ref<SecureSocketContext> context,
+        Ref<SocketThreadPool> socketThreadPool);
+
       const Identifier& GetIdentifier() const;
 
       Connection& GetConnection();
@@ -75,14 +122,15 @@ namespace Network {
       Reader m_reader;
       Writer m_writer;
 
-      SecureSocketChannel(Ref<SocketThreadPool> socketThreadPool);
+      SecureSocketChannel(SecureSocketContext& context,
+        boost::asio::io_service& ioService);
       void SetAddress(const IpAddress& address);
   };
 
   inline SecureSocketChannel::SecureSocketChannel(const IpAddress& address,
       Ref<SocketThreadPool> socketThreadPool)
       : m_socket(std::make_shared<Details::SecureSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
+          socketThreadPool->GetService())),
         m_identifier(address),
         m_connection(m_socket, address),
         m_reader(m_socket),
@@ -91,7 +139,47 @@ namespace Network {
   inline SecureSocketChannel::SecureSocketChannel(const IpAddress& address,
       const IpAddress& interface, Ref<SocketThreadPool> socketThreadPool)
       : m_socket(std::make_shared<Details::SecureSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
+          socketThreadPool->GetService())),
+        m_identifier(address),
+        m_connection(m_socket, address, interface),
+        m_reader(m_socket),
+        m_writer(m_socket) {}
+
+  inline SecureSocketChannel::SecureSocketChannel(
+      const std::vector<IpAddress>& addresses,
+      Ref<SocketThreadPool> socketThreadPool)
+      : m_socket(std::make_shared<Details::SecureSocketEntry>(
+          socketThreadPool->GetService())),
+        m_identifier(addresses.front()),
+        m_connection(m_socket, addresses),
+        m_reader(m_socket),
+        m_writer(m_socket) {}
+
+  inline SecureSocketChannel::SecureSocketChannel(
+      const std::vector<IpAddress>& addresses, const IpAddress& interface,
+      Ref<SocketThreadPool> socketThreadPool)
+      : m_socket(std::make_shared<Details::SecureSocketEntry>(
+          socketThreadPool->GetService())),
+        m_identifier(addresses.front()),
+        m_connection(m_socket, addresses, interface),
+        m_reader(m_socket),
+        m_writer(m_socket) {}
+
+  inline SecureSocketChannel::SecureSocketChannel(const IpAddress& address,
+      Ref<SecureSocketContext> context,
+      Ref<SocketThreadPool> socketThreadPool)
+      : m_socket(std::make_shared<Details::SecureSocketEntry>(
+          socketThreadPool->GetService(), *context)),
+        m_identifier(address),
+        m_connection(m_socket, address),
+        m_reader(m_socket),
+        m_writer(m_socket) {}
+
+  inline SecureSocketChannel::SecureSocketChannel(const IpAddress& address,
+      const IpAddress& interface, Ref<SecureSocketContext> context,
+      Ref<SocketThreadPool> socketThreadPool)
+      : m_socket(std::make_shared<Details::SecureSocketEntry>(
+          socketThreadPool->GetService(), *context)),
         m_identifier(address),
         m_connection(m_socket, address, interface),
         m_reader(m_socket),
@@ -99,9 +187,10 @@ namespace Network {
 
   inline SecureSocketChannel::SecureSocketChannel(
       const std::vector<IpAddress>& addresses,
+      Ref<SecureSocketContext> context,
       Ref<SocketThreadPool> socketThreadPool)
       : m_socket(std::make_shared<Details::SecureSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
+          socketThreadPool->GetService(), *context)),
         m_identifier(addresses.front()),
         m_connection(m_socket, addresses),
         m_reader(m_socket),
@@ -109,9 +198,10 @@ namespace Network {
 
   inline SecureSocketChannel::SecureSocketChannel(
       const std::vector<IpAddress>& addresses, const IpAddress& interface,
+      Ref<SecureSocketContext> context,
       Ref<SocketThreadPool> socketThreadPool)
       : m_socket(std::make_shared<Details::SecureSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
+          socketThreadPool->GetService(), *context)),
         m_identifier(addresses.front()),
         m_connection(m_socket, addresses, interface),
         m_reader(m_socket),
@@ -135,9 +225,9 @@ namespace Network {
   }
 
   inline SecureSocketChannel::SecureSocketChannel(
-      Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::SecureSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
+      SecureSocketContext& context, boost::asio::io_service& ioService)
+      : m_socket(std::make_shared<Details::SecureSocketEntry>(ioService,
+          context)),
         m_connection(m_socket),
         m_reader(m_socket),
         m_writer(m_socket) {}
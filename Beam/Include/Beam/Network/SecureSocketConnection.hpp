@@ -134,6 +134,7 @@ namespace Network {
       return;
     }
     boost::system::error_code errorCode;
+    auto peer = std::string();
     for(auto& address : m_addresses) {
       errorCode.clear();
       boost::asio::ip::tcp::resolver resolver{*m_socket->m_ioService};
@@ -176,6 +177,7 @@ namespace Network {
         ++endpointIterator;
       }
       if(!errorCode) {
+        peer = address.GetHost() + ":" + ToString(address.GetPort());
         break;
       }
     }
@@ -195,10 +197,11 @@ namespace Network {
       m_openState.SetOpenFailure(IO::ConnectException(errorCode.message()));
       Shutdown();
     }
-    m_socket->m_socket.handshake(boost::asio::ssl::stream_base::client,
-      errorCode);
-    if(errorCode) {
-      m_openState.SetOpenFailure(IO::ConnectException(errorCode.message()));
+    try {
+      m_socket->m_context->Handshake(m_socket->m_socket,
+        boost::asio::ssl::stream_base::client, peer);
+    } catch(const std::exception& e) {
+      m_openState.SetOpenFailure(IO::ConnectException(e.what()));
       Shutdown();
     }
     m_socket->m_isOpen = true;
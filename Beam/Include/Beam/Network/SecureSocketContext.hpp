@@ -0,0 +1,381 @@
+#ifndef BEAM_SECURE_SOCKET_CONTEXT_HPP
+#define BEAM_SECURE_SOCKET_CONTEXT_HPP
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/Network/Network.hpp"
+#include "Beam/Network/SocketException.hpp"
+#include "Beam/Pointers/Ref.hpp"
+#include "Beam/Routines/Async.hpp"
+#include "Beam/Threading/ThreadPool.hpp"
+
+namespace Beam {
+namespace Network {
+
+  /*! \class SecureSocketContext
+      \brief Stores the TLS state shared by a group of secure sockets.
+      \details Sessions are cached so that reconnecting sockets resume them
+               with an abbreviated handshake: clients keep the last session
+               received from each peer, including TLS 1.3 tickets, and
+               servers issue session tickets and keep a session cache.
+               Handshakes can be run on a dedicated ThreadPool so that a
+               burst of them doesn't compete with socket I/O.
+   */
+  class SecureSocketContext : private boost::noncopyable {
+    public:
+
+      //! The type of TLS stream using this context.
+      using Socket = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+
+      /*! \struct Statistics
+          \brief Stores a snapshot of the handshakes performed.
+       */
+      struct Statistics {
+
+        //! The number of handshakes completed.
+        std::uint64_t m_handshakes;
+
+        //! The number of completed handshakes that resumed a session.
+        std::uint64_t m_resumedHandshakes;
+
+        //! The number of handshakes that failed.
+        std::uint64_t m_failures;
+
+        //! The total time taken by completed handshakes, including the time
+        //! spent waiting for a thread.
+        boost::posix_time::time_duration m_totalLatency;
+
+        //! The longest time taken by a completed handshake.
+        boost::posix_time::time_duration m_maximumLatency;
+      };
+
+      //! The default amount of time a handshake may take.
+      static const boost::posix_time::time_duration DEFAULT_TIMEOUT;
+
+      //! Constructs a client SecureSocketContext whose handshakes run on the
+      //! socket's thread pool.
+      SecureSocketContext();
+
+      //! Constructs a client SecureSocketContext.
+      /*!
+        \param handshakePool The pool to run handshakes on.
+      */
+      explicit SecureSocketContext(Ref<Threading::ThreadPool> handshakePool);
+
+      //! Constructs a server SecureSocketContext whose handshakes run on the
+      //! socket's thread pool.
+      /*!
+        \param certificateChain The PEM encoded certificate chain.
+        \param privateKey The PEM encoded private key.
+      */
+      SecureSocketContext(const std::string& certificateChain,
+        const std::string& privateKey);
+
+      //! Constructs a server SecureSocketContext.
+      /*!
+        \param certificateChain The PEM encoded certificate chain.
+        \param privateKey The PEM encoded private key.
+        \param handshakePool The pool to run handshakes on.
+      */
+      SecureSocketContext(const std::string& certificateChain,
+        const std::string& privateKey,
+        Ref<Threading::ThreadPool> handshakePool);
+
+      ~SecureSocketContext();
+
+      //! Returns the underlying SSL context.
+      boost::asio::ssl::context& GetContext();
+
+      //! Sets the amount of time a handshake may take before the socket is
+      //! shut down.
+      void SetTimeout(boost::posix_time::time_duration timeout);
+
+      //! Returns a snapshot of the handshakes performed.
+      Statistics GetStatistics() const;
+
+      //! Performs a handshake, suspending the calling Routine until it
+      //! completes.
+      /*!
+        \param socket The socket to perform the handshake on.
+        \param type The side of the handshake to perform.
+        \param peer Identifies the peer whose session is resumed, only used
+               by clients.
+      */
+      void Handshake(Socket& socket,
+        boost::asio::ssl::stream_base::handshake_type type,
+        const std::string& peer);
+
+    private:
+      struct Deadline {
+        std::mutex m_mutex;
+        bool m_isComplete;
+        boost::asio::deadline_timer m_timer;
+
+        Deadline(Socket& socket);
+      };
+      boost::asio::ssl::context m_context;
+      Threading::ThreadPool* m_handshakePool;
+      boost::posix_time::time_duration m_timeout;
+      std::mutex m_mutex;
+      std::unordered_map<std::string, SSL_SESSION*> m_sessions;
+      std::atomic<std::uint64_t> m_handshakes;
+      std::atomic<std::uint64_t> m_resumedHandshakes;
+      std::atomic<std::uint64_t> m_failures;
+      std::atomic<std::uint64_t> m_totalLatency;
+      std::atomic<std::uint64_t> m_maximumLatency;
+
+      SecureSocketContext(Threading::ThreadPool* handshakePool);
+      SecureSocketContext(const std::string& certificateChain,
+        const std::string& privateKey, Threading::ThreadPool* handshakePool);
+      void Resume(Socket& socket, const std::string& peer);
+      void Record(Socket& socket, boost::posix_time::ptime start,
+        const boost::system::error_code& error);
+      static int GetContextIndex();
+      static int GetPeerIndex();
+      static int OnNewSession(SSL* ssl, SSL_SESSION* session);
+  };
+
+  inline const boost::posix_time::time_duration
+    SecureSocketContext::DEFAULT_TIMEOUT = boost::posix_time::seconds(10);
+
+  inline SecureSocketContext::Deadline::Deadline(Socket& socket)
+    : m_isComplete(false),
+      m_timer(socket.get_executor()) {}
+
+  inline SecureSocketContext::SecureSocketContext()
+    : SecureSocketContext(static_cast<Threading::ThreadPool*>(nullptr)) {}
+
+  inline SecureSocketContext::SecureSocketContext(
+    Ref<Threading::ThreadPool> handshakePool)
+    : SecureSocketContext(handshakePool.Get()) {}
+
+  inline SecureSocketContext::SecureSocketContext(
+    const std::string& certificateChain, const std::string& privateKey)
+    : SecureSocketContext(certificateChain, privateKey, nullptr) {}
+
+  inline SecureSocketContext::SecureSocketContext(
+    const std::string& certificateChain, const std::string& privateKey,
+    Ref<Threading::ThreadPool> handshakePool)
+    : SecureSocketContext(certificateChain, privateKey,
+        handshakePool.Get()) {}
+
+  inline SecureSocketContext::~SecureSocketContext() {
+    for(auto& session : m_sessions) {
+      SSL_SESSION_free(session.second);
+    }
+  }
+
+  inline boost::asio::ssl::context& SecureSocketContext::GetContext() {
+    return m_context;
+  }
+
+  inline void SecureSocketContext::SetTimeout(
+      boost::posix_time::time_duration timeout) {
+    m_timeout = timeout;
+  }
+
+  inline SecureSocketContext::Statistics
+      SecureSocketContext::GetStatistics() const {
+    auto statistics = Statistics();
+    statistics.m_handshakes = m_handshakes.load(std::memory_order_relaxed);
+    statistics.m_resumedHandshakes =
+      m_resumedHandshakes.load(std::memory_order_relaxed);
+    statistics.m_failures = m_failures.load(std::memory_order_relaxed);
+    statistics.m_totalLatency = boost::posix_time::microseconds(
+      m_totalLatency.load(std::memory_order_relaxed));
+    statistics.m_maximumLatency = boost::posix_time::microseconds(
+      m_maximumLatency.load(std::memory_order_relaxed));
+    return statistics;
+  }
+
+  inline void SecureSocketContext::Handshake(Socket& socket,
+      boost::asio::ssl::stream_base::handshake_type type,
+      const std::string& peer) {
+    auto start = boost::posix_time::microsec_clock::universal_time();
+    if(type == boost::asio::ssl::stream_base::client) {
+      Resume(socket, peer);
+    }
+
+    // A peer that stalls the handshake would otherwise hold on to a thread
+    // indefinitely, so the socket is shut down once the timeout expires,
+    // which fails the handshake.
+    auto deadline = std::make_shared<Deadline>(socket);
+    deadline->m_timer.expires_from_now(m_timeout);
+    deadline->m_timer.async_wait(
+      [deadline, &socket] (const boost::system::error_code& error) {
+        std::lock_guard<std::mutex> lock(deadline->m_mutex);
+        if(error || deadline->m_isComplete) {
+          return;
+        }
+        auto shutdownError = boost::system::error_code();
+        socket.lowest_layer().shutdown(
+          boost::asio::ip::tcp::socket::shutdown_both, shutdownError);
+      });
+    auto handshakeAsync = Routines::Async<boost::system::error_code>();
+    auto eval = std::make_shared<Routines::Eval<boost::system::error_code>>(
+      handshakeAsync.GetEval());
+    auto complete = [=, &socket] (const boost::system::error_code& error) {
+      {
+        std::lock_guard<std::mutex> lock(deadline->m_mutex);
+        deadline->m_isComplete = true;
+        auto cancelError = boost::system::error_code();
+        deadline->m_timer.cancel(cancelError);
+      }
+      Record(socket, start, error);
+      eval->SetResult(error);
+    };
+    if(m_handshakePool == nullptr) {
+      socket.async_handshake(type, complete);
+    } else {
+      m_handshakePool->Queue(
+        [=, &socket] {
+          auto error = boost::system::error_code();
+          socket.handshake(type, error);
+          complete(error);
+        }, Routines::Eval<void>());
+    }
+    auto error = handshakeAsync.Get();
+    if(error) {
+      BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
+    }
+  }
+
+  inline SecureSocketContext::SecureSocketContext(
+      Threading::ThreadPool* handshakePool)
+      : m_context(boost::asio::ssl::context::sslv23),
+        m_handshakePool(handshakePool),
+        m_timeout(DEFAULT_TIMEOUT),
+        m_handshakes(0),
+        m_resumedHandshakes(0),
+        m_failures(0),
+        m_totalLatency(0),
+        m_maximumLatency(0) {
+    auto context = m_context.native_handle();
+
+    // The context's application data is reserved by boost::asio for its
+    // verify callback, so this context is stored at its own index.
+    SSL_CTX_set_ex_data(context, GetContextIndex(), this);
+    SSL_CTX_set_session_cache_mode(context,
+      SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(context, &SecureSocketContext::OnNewSession);
+  }
+
+  inline SecureSocketContext::SecureSocketContext(
+      const std::string& certificateChain, const std::string& privateKey,
+      Threading::ThreadPool* handshakePool)
+      : m_context(boost::asio::ssl::context::sslv23),
+        m_handshakePool(handshakePool),
+        m_timeout(DEFAULT_TIMEOUT),
+        m_handshakes(0),
+        m_resumedHandshakes(0),
+        m_failures(0),
+        m_totalLatency(0),
+        m_maximumLatency(0) {
+    static const unsigned char SESSION_ID_CONTEXT[] = "Beam";
+    auto error = boost::system::error_code();
+    m_context.use_certificate_chain(boost::asio::buffer(certificateChain),
+      error);
+    if(!error) {
+      m_context.use_private_key(boost::asio::buffer(privateKey),
+        boost::asio::ssl::context::pem, error);
+    }
+    if(error) {
+      BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
+    }
+    auto context = m_context.native_handle();
+    SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_session_id_context(context, SESSION_ID_CONTEXT,
+      sizeof(SESSION_ID_CONTEXT) - 1);
+  }
+
+  inline void SecureSocketContext::Resume(Socket& socket,
+      const std::string& peer) {
+    auto ssl = socket.native_handle();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto session = m_sessions.find(peer);
+    if(session == m_sessions.end()) {
+      session = m_sessions.emplace(peer, nullptr).first;
+    } else if(session->second != nullptr) {
+      auto copy = SSL_SESSION_dup(session->second);
+      if(copy != nullptr) {
+        SSL_set_session(ssl, copy);
+        SSL_SESSION_free(copy);
+      }
+    }
+
+    // Sessions can arrive after the handshake completes, so the peer stored
+    // with the SSL object refers to the map's key, which lives as long as
+    // this context.
+    SSL_set_ex_data(ssl, GetPeerIndex(),
+      const_cast<std::string*>(&session->first));
+  }
+
+  inline void SecureSocketContext::Record(Socket& socket,
+      boost::posix_time::ptime start, const boost::system::error_code& error) {
+    if(error) {
+      m_failures.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    auto latency = static_cast<std::uint64_t>(
+      (boost::posix_time::microsec_clock::universal_time() -
+      start).total_microseconds());
+    m_handshakes.fetch_add(1, std::memory_order_relaxed);
+    if(SSL_session_reused(socket.native_handle())) {
+      m_resumedHandshakes.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_totalLatency.fetch_add(latency, std::memory_order_relaxed);
+    auto maximum = m_maximumLatency.load(std::memory_order_relaxed);
+    while(latency > maximum && !m_maximumLatency.compare_exchange_weak(
+      maximum, latency, std::memory_order_relaxed)) {}
+  }
+
+  inline int SecureSocketContext::GetContextIndex() {
+    static const auto index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr,
+      nullptr, nullptr);
+    return index;
+  }
+
+  inline int SecureSocketContext::GetPeerIndex() {
+    static const auto index = SSL_get_ex_new_index(0, nullptr, nullptr,
+      nullptr, nullptr);
+    return index;
+  }
+
+  inline int SecureSocketContext::OnNewSession(SSL* ssl,
+      SSL_SESSION* session) {
+    auto context = static_cast<SecureSocketContext*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), GetContextIndex()));
+    auto peer = static_cast<const std::string*>(
+      SSL_get_ex_data(ssl, GetPeerIndex()));
+    if(context == nullptr || peer == nullptr) {
+      return 0;
+    }
+
+    // OpenSSL invalidates a connection's session when the connection is
+    // closed without a close_notify, as sockets here are, so the cache only
+    // holds copies that are never attached to a connection.
+    auto copy = SSL_SESSION_dup(session);
+    if(copy == nullptr) {
+      return 0;
+    }
+    std::lock_guard<std::mutex> lock(context->m_mutex);
+    auto& cachedSession = context->m_sessions[*peer];
+    if(cachedSession != nullptr) {
+      SSL_SESSION_free(cachedSession);
+    }
+    cachedSession = copy;
+    return 0;
+  }
+}
+}
+
+#endif
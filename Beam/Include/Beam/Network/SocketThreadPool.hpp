@@ -1,10 +1,20 @@
 #ifndef BEAM_SOCKET_THREAD_POOL_HPP
 #define BEAM_SOCKET_THREAD_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <memory>
+#include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/throw_exception.hpp>
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
 #include "Beam/Network/Network.hpp"
+#include "Beam/Network/SocketException.hpp"
 
 namespace Beam {
 namespace Network {
@@ -15,6 +25,18 @@ namespace Network {
   class SocketThreadPool : private boost::noncopyable {
     public:
 
+      //! Specifies how sockets are assigned to threads.
+      enum class Mode {
+
+        //! Every thread runs the handlers of every socket.
+        SHARED,
+
+        //! Each thread runs its own io_service and sockets are assigned to
+        //! them in round-robin order, so that all of a socket's handlers run
+        //! on the same thread.
+        SHARDED
+      };
+
       //! Constructs a SocketThreadPool.
       SocketThreadPool();
 
@@ -24,46 +46,147 @@ namespace Network {
       */
       SocketThreadPool(std::size_t threadCount);
 
+      //! Constructs a SocketThreadPool.
+      /*!
+        \param threadCount The number of threads to use.
+        \param mode Specifies how sockets are assigned to threads.
+        \param isPinned Whether each thread is pinned to one of the CPUs the
+               process may run on, only supported on Linux. A SocketException
+               is thrown if a thread can not be pinned.
+      */
+      SocketThreadPool(std::size_t threadCount, Mode mode, bool isPinned);
+
       ~SocketThreadPool();
 
+      //! Returns how sockets are assigned to threads.
+      Mode GetMode() const;
+
+      //! Returns the number of threads used.
+      std::size_t GetThreadCount() const;
+
     private:
       friend class MulticastSocket;
+      friend class SecureServerSocket;
       friend class SecureSocketChannel;
       friend class TcpServerSocket;
       friend class TcpSocketChannel;
       friend class UdpSocket;
-      boost::asio::io_service m_service;
-      boost::asio::io_service::work m_work;
+      struct Shard {
+        boost::asio::io_service m_service;
+        boost::asio::io_service::work m_work;
+
+        Shard();
+      };
+      Mode m_mode;
       std::size_t m_threadCount;
+      std::vector<std::unique_ptr<Shard>> m_shards;
+      std::atomic<std::size_t> m_nextShard;
       std::unique_ptr<boost::thread[]> m_threads;
 
+      static void Pin(boost::thread& thread, std::size_t index);
+      void Stop();
       boost::asio::io_service& GetService();
   };
 
+  inline SocketThreadPool::Shard::Shard()
+    : m_work(m_service) {}
+
   inline SocketThreadPool::SocketThreadPool()
-      : SocketThreadPool(boost::thread::hardware_concurrency()) {}
+    : SocketThreadPool(boost::thread::hardware_concurrency()) {}
 
   inline SocketThreadPool::SocketThreadPool(std::size_t threadCount)
-      : m_work(m_service),
-        m_threadCount(threadCount),
+    : SocketThreadPool(threadCount, Mode::SHARED, false) {}
+
+  inline SocketThreadPool::SocketThreadPool(std::size_t threadCount,
+      Mode mode, bool isPinned)
+      : m_mode(mode),
+        m_threadCount(std::max<std::size_t>(1, threadCount)),
+        m_nextShard(0),
         m_threads(std::make_unique<boost::thread[]>(m_threadCount)) {
+    auto shardCount = [&] {
+      if(m_mode == Mode::SHARDED) {
+        return m_threadCount;
+      }
+      return std::size_t(1);
+    }();
+    for(std::size_t i = 0; i < shardCount; ++i) {
+      m_shards.push_back(std::make_unique<Shard>());
+    }
     for(std::size_t i = 0; i < m_threadCount; ++i) {
+      auto& service = m_shards[i % shardCount]->m_service;
       m_threads[i] = boost::thread(
-        [=] {
-          m_service.run();
+        [&service] {
+          service.run();
         });
     }
+    if(isPinned) {
+      try {
+        for(std::size_t i = 0; i < m_threadCount; ++i) {
+          Pin(m_threads[i], i);
+        }
+      } catch(const std::exception&) {
+        Stop();
+        throw;
+      }
+    }
   }
 
   inline SocketThreadPool::~SocketThreadPool() {
-    m_service.stop();
+    Stop();
+  }
+
+  inline SocketThreadPool::Mode SocketThreadPool::GetMode() const {
+    return m_mode;
+  }
+
+  inline std::size_t SocketThreadPool::GetThreadCount() const {
+    return m_threadCount;
+  }
+
+  inline void SocketThreadPool::Pin(boost::thread& thread,
+      std::size_t index) {
+#ifdef __linux__
+    auto availableCpus = cpu_set_t();
+    CPU_ZERO(&availableCpus);
+    if(sched_getaffinity(0, sizeof(availableCpus), &availableCpus) != 0) {
+      BOOST_THROW_EXCEPTION(SocketException(errno,
+        "Unable to retrieve the available CPUs."));
+    }
+    auto cpuCount = CPU_COUNT(&availableCpus);
+    if(cpuCount == 0) {
+      BOOST_THROW_EXCEPTION(SocketException(0, "No CPUs available."));
+    }
+    auto remaining = static_cast<int>(index % cpuCount);
+    auto cpu = 0;
+    while(!CPU_ISSET(cpu, &availableCpus) || remaining-- != 0) {
+      ++cpu;
+    }
+    auto cpuSet = cpu_set_t();
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    auto result = pthread_setaffinity_np(thread.native_handle(),
+      sizeof(cpuSet), &cpuSet);
+    if(result != 0) {
+      BOOST_THROW_EXCEPTION(SocketException(result,
+        "Unable to pin socket thread."));
+    }
+#endif
+  }
+
+  inline void SocketThreadPool::Stop() {
+    for(auto& shard : m_shards) {
+      shard->m_service.stop();
+    }
     for(std::size_t i = 0; i < m_threadCount; ++i) {
       m_threads[i].join();
     }
   }
 
   inline boost::asio::io_service& SocketThreadPool::GetService() {
-    return m_service;
+    if(m_shards.size() == 1) {
+      return m_shards.front()->m_service;
+    }
+    return m_shards[m_nextShard++ % m_shards.size()]->m_service;
   }
 }
 }
@@ -11,6 +11,7 @@
 #include "Beam/Network/SocketThreadPool.hpp"
 #include "Beam/Network/TcpSocketChannel.hpp"
 #include "Beam/Network/TcpSocketConnection.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Network/TcpSocketReader.hpp"
 #include "Beam/Network/TcpSocketWriter.hpp"
 #include "Beam/Pointers/Ref.hpp"
@@ -34,6 +35,39 @@ namespace Network {
       TcpServerSocket(const IpAddress& address,
         Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a TcpServerSocket.
+      /*!
+        \param address The IP address to bind to.
+        \param isReusePort Whether to set SO_REUSEPORT, allowing multiple
+               TcpServerSockets to bind to the same <i>address</i> with the
+               kernel balancing incoming connections among them. Accepted
+               sockets are serviced by the same thread as the acceptor.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpServerSocket(const IpAddress& address, bool isReusePort,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      //! Constructs a TcpServerSocket.
+      /*!
+        \param address The IP address to bind to.
+        \param options The options applied to every accepted socket.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpServerSocket(const IpAddress& address,
+        const TcpSocketOptions& options,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      //! Constructs a TcpServerSocket.
+      /*!
+        \param address The IP address to bind to.
+        \param isReusePort Whether to set SO_REUSEPORT.
+        \param options The options applied to every accepted socket.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpServerSocket(const IpAddress& address, bool isReusePort,
+        const TcpSocketOptions& options,
+        Ref<SocketThreadPool> socketThreadPool);
+
       ~TcpServerSocket();
 
       std::unique_ptr<Channel> Accept();
@@ -44,6 +78,8 @@ namespace Network {
 
     private:
       IpAddress m_address;
+      bool m_isReusePort;
+      TcpSocketOptions m_options;
       SocketThreadPool* m_socketThreadPool;
       boost::asio::io_service* m_ioService;
       boost::optional<boost::asio::ip::tcp::acceptor> m_acceptor;
@@ -53,8 +89,24 @@ namespace Network {
   };
 
   inline TcpServerSocket::TcpServerSocket(const IpAddress& address,
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpServerSocket(address, false, Ref(socketThreadPool)) {}
+
+  inline TcpServerSocket::TcpServerSocket(const IpAddress& address,
+    bool isReusePort, Ref<SocketThreadPool> socketThreadPool)
+    : TcpServerSocket(address, isReusePort, TcpSocketOptions(),
+        Ref(socketThreadPool)) {}
+
+  inline TcpServerSocket::TcpServerSocket(const IpAddress& address,
+    const TcpSocketOptions& options, Ref<SocketThreadPool> socketThreadPool)
+    : TcpServerSocket(address, false, options, Ref(socketThreadPool)) {}
+
+  inline TcpServerSocket::TcpServerSocket(const IpAddress& address,
+      bool isReusePort, const TcpSocketOptions& options,
       Ref<SocketThreadPool> socketThreadPool)
       : m_address(address),
+        m_isReusePort(isReusePort),
+        m_options(options),
         m_socketThreadPool(socketThreadPool.Get()),
         m_ioService(&m_socketThreadPool->GetService()) {}
 
@@ -75,7 +127,27 @@ namespace Network {
       if(error) {
         BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
       }
-      m_acceptor.emplace(*m_ioService, *endpointIterator);
+      auto endpoint = boost::asio::ip::tcp::endpoint(*endpointIterator);
+      m_acceptor.emplace(*m_ioService);
+      m_acceptor->open(endpoint.protocol());
+      m_acceptor->set_option(
+        boost::asio::ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+      if(m_isReusePort) {
+        m_acceptor->set_option(boost::asio::detail::socket_option::boolean<
+          SOL_SOCKET, SO_REUSEPORT>(true));
+      }
+#endif
+
+      // Accepted sockets inherit the listening socket's receive buffer, which
+      // must be set before the handshake for the window scale to account for
+      // it.
+      if(m_options.m_readBufferSize != 0) {
+        m_acceptor->set_option(boost::asio::socket_base::receive_buffer_size(
+          m_options.m_readBufferSize));
+      }
+      m_acceptor->bind(endpoint);
+      m_acceptor->listen();
     } catch(const SocketException&) {
       m_openState.SetOpenFailure();
       Shutdown();
@@ -94,8 +166,14 @@ namespace Network {
       TcpServerSocket::Accept() {
     Routines::Async<void> acceptAsync;
     Routines::Eval<void> acceptEval = acceptAsync.GetEval();
-    std::unique_ptr<Channel> channel(new TcpSocketChannel{
-      Ref(*m_socketThreadPool)});
+    auto channel = [&] {
+      if(m_isReusePort) {
+        return std::unique_ptr<Channel>(new TcpSocketChannel(m_options,
+          *m_ioService));
+      }
+      return std::unique_ptr<Channel>(new TcpSocketChannel(m_options,
+        m_socketThreadPool->GetService()));
+    }();
     m_acceptor->async_accept(channel->m_socket->m_socket,
       [&] (const boost::system::error_code& error) {
         if(error) {
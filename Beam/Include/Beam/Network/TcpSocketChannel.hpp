@@ -2,12 +2,14 @@
 #define BEAM_TCPSOCKETCHANNEL_HPP
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
 #include "Beam/IO/Channel.hpp"
 #include "Beam/Network/Network.hpp"
 #include "Beam/Network/NetworkDetails.hpp"
 #include "Beam/Network/SocketIdentifier.hpp"
 #include "Beam/Network/SocketThreadPool.hpp"
 #include "Beam/Network/TcpSocketConnection.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Network/TcpSocketReader.hpp"
 #include "Beam/Network/TcpSocketWriter.hpp"
 #include "Beam/Pointers/Ref.hpp"
@@ -33,21 +35,52 @@ namespace Network {
       TcpSocketChannel(const IpAddress& address,
         Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a TcpSocketChannel.
+      /*!
+        \param address The IP address to connect to.
+        \param options The options to apply to the socket.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpSocketChannel(const IpAddress& address,
+        const TcpSocketOptions& options,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      //! Constructs a TcpSocketChannel.
+      /*!
+        \param address The IP address to connect to.
+        \param interface The interface to bind to.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpSocketChannel(const IpAddress& address, const IpAddress& interface,
+        Ref<SocketThreadPool> socketThreadPool);
+
       //! Constructs a TcpSocketChannel.
       /*!
         \param address The IP address to connect to.
         \param interface The interface to bind to.
+        \param options The options to apply to the socket.
         \param socketThreadPool The thread pool used for the sockets.
       */
       TcpSocketChannel(const IpAddress& address, const IpAddress& interface,
+        const TcpSocketOptions& options,
+        Ref<SocketThreadPool> socketThreadPool);
+
+      //! Constructs a TcpSocketChannel.
+      /*!
+        \param addresses The list of IP addresses to try to connect to.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpSocketChannel(const std::vector<IpAddress>& addresses,
         Ref<SocketThreadPool> socketThreadPool);
 
       //! Constructs a TcpSocketChannel.
       /*!
         \param addresses The list of IP addresses to try to connect to.
+        \param options The options to apply to the socket.
         \param socketThreadPool The thread pool used for the sockets.
       */
       TcpSocketChannel(const std::vector<IpAddress>& addresses,
+        const TcpSocketOptions& options,
         Ref<SocketThreadPool> socketThreadPool);
 
       //! Constructs a TcpSocketChannel.
@@ -59,6 +92,17 @@ namespace Network {
       TcpSocketChannel(const std::vector<IpAddress>& addresses,
         const IpAddress& interface, Ref<SocketThreadPool> socketThreadPool);
 
+      //! Constructs a TcpSocketChannel.
+      /*!
+        \param addresses The list of IP addresses to try to connect to.
+        \param interface The interface to bind to.
+        \param options The options to apply to the socket.
+        \param socketThreadPool The thread pool used for the sockets.
+      */
+      TcpSocketChannel(const std::vector<IpAddress>& addresses,
+        const IpAddress& interface, const TcpSocketOptions& options,
+        Ref<SocketThreadPool> socketThreadPool);
+
       const Identifier& GetIdentifier() const;
 
       Connection& GetConnection();
@@ -75,47 +119,57 @@ namespace Network {
       Reader m_reader;
       Writer m_writer;
 
-      TcpSocketChannel(Ref<SocketThreadPool> socketThreadPool);
+      TcpSocketChannel(const std::vector<IpAddress>& addresses,
+        boost::optional<IpAddress> interface, const TcpSocketOptions& options,
+        boost::asio::io_service& ioService);
+      TcpSocketChannel(const TcpSocketOptions& options,
+        boost::asio::io_service& ioService);
+      static TcpSocketOptions GetDefaultOptions();
       void SetAddress(const IpAddress& address);
   };
 
   inline TcpSocketChannel::TcpSocketChannel(const IpAddress& address,
-      Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::TcpSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
-        m_identifier(address),
-        m_connection(m_socket, address),
-        m_reader(m_socket),
-        m_writer(m_socket) {}
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(address, GetDefaultOptions(), Ref(socketThreadPool)) {}
 
   inline TcpSocketChannel::TcpSocketChannel(const IpAddress& address,
-      const IpAddress& interface, Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::TcpSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
-        m_identifier(address),
-        m_connection(m_socket, address, interface),
-        m_reader(m_socket),
-        m_writer(m_socket) {}
+    const TcpSocketOptions& options, Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(std::vector<IpAddress>{address}, boost::none, options,
+        socketThreadPool->GetService()) {}
+
+  inline TcpSocketChannel::TcpSocketChannel(const IpAddress& address,
+    const IpAddress& interface, Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(address, interface, GetDefaultOptions(),
+        Ref(socketThreadPool)) {}
+
+  inline TcpSocketChannel::TcpSocketChannel(const IpAddress& address,
+    const IpAddress& interface, const TcpSocketOptions& options,
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(std::vector<IpAddress>{address}, interface, options,
+        socketThreadPool->GetService()) {}
 
   inline TcpSocketChannel::TcpSocketChannel(
-      const std::vector<IpAddress>& addresses,
-      Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::TcpSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
-        m_identifier(addresses.front()),
-        m_connection(m_socket, addresses),
-        m_reader(m_socket),
-        m_writer(m_socket) {}
+    const std::vector<IpAddress>& addresses,
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(addresses, GetDefaultOptions(), Ref(socketThreadPool)) {}
 
   inline TcpSocketChannel::TcpSocketChannel(
-      const std::vector<IpAddress>& addresses, const IpAddress& interface,
-      Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::TcpSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
-        m_identifier(addresses.front()),
-        m_connection(m_socket, addresses, interface),
-        m_reader(m_socket),
-        m_writer(m_socket) {}
+    const std::vector<IpAddress>& addresses, const TcpSocketOptions& options,
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(addresses, boost::none, options,
+        socketThreadPool->GetService()) {}
+
+  inline TcpSocketChannel::TcpSocketChannel(
+    const std::vector<IpAddress>& addresses, const IpAddress& interface,
+    Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(addresses, interface, GetDefaultOptions(),
+        Ref(socketThreadPool)) {}
+
+  inline TcpSocketChannel::TcpSocketChannel(
+    const std::vector<IpAddress>& addresses, const IpAddress& interface,
+    const TcpSocketOptions& options, Ref<SocketThreadPool> socketThreadPool)
+    : TcpSocketChannel(addresses, boost::optional<IpAddress>(interface),
+        options, socketThreadPool->GetService()) {}
 
   inline const TcpSocketChannel::Identifier&
       TcpSocketChannel::GetIdentifier() const {
@@ -135,13 +189,28 @@ namespace Network {
   }
 
   inline TcpSocketChannel::TcpSocketChannel(
-      Ref<SocketThreadPool> socketThreadPool)
-      : m_socket(std::make_shared<Details::TcpSocketEntry>(
-          socketThreadPool->GetService(), socketThreadPool->GetService())),
-        m_connection(m_socket),
-        m_reader(m_socket),
+      const std::vector<IpAddress>& addresses,
+      boost::optional<IpAddress> interface, const TcpSocketOptions& options,
+      boost::asio::io_service& ioService)
+      : m_socket(std::make_shared<Details::TcpSocketEntry>(ioService)),
+        m_identifier(addresses.front()),
+        m_connection(m_socket, addresses, std::move(interface), options),
+        m_reader(m_socket, options),
         m_writer(m_socket) {}
 
+  inline TcpSocketChannel::TcpSocketChannel(const TcpSocketOptions& options,
+      boost::asio::io_service& ioService)
+      : m_socket(std::make_shared<Details::TcpSocketEntry>(ioService)),
+        m_connection(m_socket, options),
+        m_reader(m_socket, options),
+        m_writer(m_socket) {}
+
+  inline TcpSocketOptions TcpSocketChannel::GetDefaultOptions() {
+    auto options = TcpSocketOptions();
+    options.m_writeBufferSize = TcpSocketOptions::DEFAULT_WRITE_BUFFER_SIZE;
+    return options;
+  }
+
   inline void TcpSocketChannel::SetAddress(const IpAddress& address) {
     m_identifier = SocketIdentifier(address);
     std::vector<IpAddress> addresses;
@@ -10,6 +10,7 @@
 #include "Beam/Network/IpAddress.hpp"
 #include "Beam/Network/NetworkDetails.hpp"
 #include "Beam/Network/SocketException.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Utilities/ToString.hpp"
 
 namespace Beam {
@@ -48,28 +49,20 @@ namespace Network {
     private:
       friend class TcpSocketChannel;
       friend class TcpServerSocket;
-      static const std::size_t DEFAULT_WRITE_BUFFER_SIZE = 8 * 1024;
       std::shared_ptr<Details::TcpSocketEntry> m_socket;
       std::vector<IpAddress> m_addresses;
       boost::optional<IpAddress> m_interface;
-      bool m_noDelayEnabled;
-      int m_writeBufferSize;
+      TcpSocketOptions m_options;
       IO::OpenState m_openState;
 
-      TcpSocketConnection(
-        const std::shared_ptr<Details::TcpSocketEntry>& socket);
-      TcpSocketConnection(
-        const std::shared_ptr<Details::TcpSocketEntry>& socket,
-        const IpAddress& address);
-      TcpSocketConnection(
-        const std::shared_ptr<Details::TcpSocketEntry>& socket,
-        const IpAddress& address, const IpAddress& interface);
       TcpSocketConnection(
         const std::shared_ptr<Details::TcpSocketEntry>& socket,
-        const std::vector<IpAddress>& addresses);
+        const TcpSocketOptions& options);
       TcpSocketConnection(
         const std::shared_ptr<Details::TcpSocketEntry>& socket,
-        const std::vector<IpAddress>& addresses, const IpAddress& interface);
+        const std::vector<IpAddress>& addresses,
+        boost::optional<IpAddress> interface,
+        const TcpSocketOptions& options);
       void Shutdown();
       void SetOpen();
   };
@@ -79,14 +72,14 @@ namespace Network {
   }
 
   inline int TcpSocketConnection::GetWriteBufferSize() const {
-    return m_writeBufferSize;
+    return m_options.m_writeBufferSize;
   }
 
   inline void TcpSocketConnection::SetWriteBufferSize(int size) {
-    m_writeBufferSize = size;
+    m_options.m_writeBufferSize = size;
     if(m_openState.IsOpen()) {
       boost::system::error_code errorCode;
-      boost::asio::socket_base::send_buffer_size bufferSize{m_writeBufferSize};
+      boost::asio::socket_base::send_buffer_size bufferSize{size};
       {
         boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
         m_socket->m_socket.set_option(bufferSize, errorCode);
@@ -99,7 +92,7 @@ namespace Network {
   }
 
   inline void TcpSocketConnection::SetNoDelay(bool noDelay) {
-    m_noDelayEnabled = noDelay;
+    m_options.m_noDelayEnabled = noDelay;
     if(m_openState.IsOpen()) {
       boost::system::error_code errorCode;
       boost::asio::ip::tcp::no_delay noDelayOption{noDelay};
@@ -148,6 +141,24 @@ namespace Network {
       while(errorCode && endpointIterator != end) {
         boost::system::error_code closeError;
         m_socket->m_socket.close(closeError);
+        boost::asio::ip::tcp::endpoint endpoint = *endpointIterator;
+        ++endpointIterator;
+        m_socket->m_socket.open(endpoint.protocol(), errorCode);
+        if(errorCode) {
+          m_openState.SetOpenFailure(
+            IO::ConnectException{errorCode.message()});
+          Shutdown();
+        }
+
+        // Options are applied before connecting so that the receive buffer
+        // size is taken into account when the window scale is negotiated.
+        Details::ApplyTcpSocketOptions(m_socket->m_socket, m_options,
+          errorCode);
+        if(errorCode) {
+          m_openState.SetOpenFailure(
+            IO::ConnectException{errorCode.message()});
+          Shutdown();
+        }
         if(m_interface.is_initialized()) {
           boost::asio::ip::tcp::endpoint localEndpoint{
             boost::asio::ip::address::from_string(m_interface->GetHost(),
@@ -157,12 +168,6 @@ namespace Network {
               IO::ConnectException{errorCode.message()});
             Shutdown();
           }
-          m_socket->m_socket.open(boost::asio::ip::tcp::v4(), errorCode);
-          if(errorCode) {
-            m_openState.SetOpenFailure(
-              IO::ConnectException{errorCode.message()});
-            Shutdown();
-          }
           m_socket->m_socket.bind(localEndpoint, errorCode);
           if(errorCode) {
             m_openState.SetOpenFailure(
@@ -170,8 +175,7 @@ namespace Network {
             Shutdown();
           }
         }
-        m_socket->m_socket.connect(*endpointIterator, errorCode);
-        ++endpointIterator;
+        m_socket->m_socket.connect(endpoint, errorCode);
       }
       if(!errorCode) {
         break;
@@ -181,18 +185,6 @@ namespace Network {
       m_openState.SetOpenFailure(IO::ConnectException{errorCode.message()});
       Shutdown();
     }
-    boost::asio::socket_base::send_buffer_size bufferSize{m_writeBufferSize};
-    m_socket->m_socket.set_option(bufferSize, errorCode);
-    if(errorCode) {
-      m_openState.SetOpenFailure(IO::ConnectException{errorCode.message()});
-      Shutdown();
-    }
-    boost::asio::ip::tcp::no_delay noDelay{m_noDelayEnabled};
-    m_socket->m_socket.set_option(noDelay, errorCode);
-    if(errorCode) {
-      m_openState.SetOpenFailure(IO::ConnectException{errorCode.message()});
-      Shutdown();
-    }
     m_socket->m_isOpen = true;
     m_openState.SetOpen();
   }
@@ -204,47 +196,20 @@ namespace Network {
     Shutdown();
   }
 
-  inline TcpSocketConnection::TcpSocketConnection(
-      const std::shared_ptr<Details::TcpSocketEntry>& socket)
-      : m_socket{socket},
-        m_noDelayEnabled{false},
-        m_writeBufferSize{DEFAULT_WRITE_BUFFER_SIZE} {}
-
   inline TcpSocketConnection::TcpSocketConnection(
       const std::shared_ptr<Details::TcpSocketEntry>& socket,
-      const IpAddress& address)
+      const TcpSocketOptions& options)
       : m_socket{socket},
-        m_noDelayEnabled{false},
-        m_writeBufferSize{DEFAULT_WRITE_BUFFER_SIZE} {
-    m_addresses.push_back(address);
-  }
+        m_options{options} {}
 
   inline TcpSocketConnection::TcpSocketConnection(
       const std::shared_ptr<Details::TcpSocketEntry>& socket,
-      const IpAddress& address, const IpAddress& interface)
-      : m_socket{socket},
-        m_interface{interface},
-        m_noDelayEnabled{false},
-        m_writeBufferSize{DEFAULT_WRITE_BUFFER_SIZE} {
-    m_addresses.push_back(address);
-  }
-
-  inline TcpSocketConnection::TcpSocketConnection(
-      const std::shared_ptr<Details::TcpSocketEntry>& socket,
-      const std::vector<IpAddress>& addresses)
+      const std::vector<IpAddress>& addresses,
+      boost::optional<IpAddress> interface, const TcpSocketOptions& options)
       : m_socket{socket},
         m_addresses{addresses},
-        m_noDelayEnabled{false},
-        m_writeBufferSize{DEFAULT_WRITE_BUFFER_SIZE} {}
-
-  inline TcpSocketConnection::TcpSocketConnection(
-      const std::shared_ptr<Details::TcpSocketEntry>& socket,
-      const std::vector<IpAddress>& addresses, const IpAddress& interface)
-      : m_socket{socket},
-        m_addresses{addresses},
-        m_interface{interface},
-        m_noDelayEnabled{false},
-        m_writeBufferSize{DEFAULT_WRITE_BUFFER_SIZE} {}
+        m_interface{std::move(interface)},
+        m_options{options} {}
 
   inline void TcpSocketConnection::Shutdown() {
     m_socket->Close();
@@ -253,6 +218,12 @@ namespace Network {
 
   inline void TcpSocketConnection::SetOpen() {
     assert(m_openState.IsClosed());
+
+    // The peer may already have reset an accepted socket, so failing to apply
+    // an option is left for the first read or write to report rather than
+    // failing the accept.
+    boost::system::error_code errorCode;
+    Details::ApplyTcpSocketOptions(m_socket->m_socket, m_options, errorCode);
     m_openState.SetOpen();
     m_socket->m_isOpen = true;
   }
@@ -0,0 +1,71 @@
+#ifndef BEAM_TCP_SOCKET_OPTIONS_HPP
+#define BEAM_TCP_SOCKET_OPTIONS_HPP
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "Beam/Network/Network.hpp"
+
+namespace Beam {
+namespace Network {
+
+  /*! \struct TcpSocketOptions
+      \brief Stores the options applied to a TCP socket when it's opened or
+             accepted.
+      \details Options that are zero or disabled are left at the operating
+               system's default, and options the platform doesn't support are
+               ignored.
+   */
+  struct TcpSocketOptions {
+
+    //! The size of the send buffer of a TcpSocketChannel constructed without
+    //! options.
+    static constexpr auto DEFAULT_WRITE_BUFFER_SIZE = 8 * 1024;
+
+    //! Whether Nagle's algorithm is disabled (TCP_NODELAY).
+    bool m_noDelayEnabled;
+
+    //! The size of the send buffer (SO_SNDBUF), or 0 for the default.
+    int m_writeBufferSize;
+
+    //! The size of the receive buffer (SO_RCVBUF), or 0 for the default.
+    int m_readBufferSize;
+
+    //! Whether acknowledgements are sent immediately rather than delayed
+    //! (TCP_QUICKACK), re-armed after every read since the kernel clears it.
+    bool m_quickAckEnabled;
+
+    //! How long to busy poll the device queue on a blocking receive
+    //! (SO_BUSY_POLL), or 0 to disable busy polling.
+    boost::posix_time::time_duration m_busyPollTimeout;
+
+    //! Whether keepalive probes are sent on an idle connection (SO_KEEPALIVE).
+    bool m_keepAliveEnabled;
+
+    //! How long a connection is idle before the first keepalive probe
+    //! (TCP_KEEPIDLE), or 0 for the default.
+    boost::posix_time::time_duration m_keepAliveIdle;
+
+    //! The time between keepalive probes (TCP_KEEPINTVL), or 0 for the
+    //! default.
+    boost::posix_time::time_duration m_keepAliveInterval;
+
+    //! The number of unanswered probes before the connection is dropped
+    //! (TCP_KEEPCNT), or 0 for the default.
+    int m_keepAliveCount;
+
+    //! Constructs TcpSocketOptions using the defaults.
+    TcpSocketOptions();
+  };
+
+  inline TcpSocketOptions::TcpSocketOptions()
+    : m_noDelayEnabled(false),
+      m_writeBufferSize(0),
+      m_readBufferSize(0),
+      m_quickAckEnabled(false),
+      m_busyPollTimeout(boost::posix_time::seconds(0)),
+      m_keepAliveEnabled(false),
+      m_keepAliveIdle(boost::posix_time::seconds(0)),
+      m_keepAliveInterval(boost::posix_time::seconds(0)),
+      m_keepAliveCount(0) {}
+}
+}
+
+#endif
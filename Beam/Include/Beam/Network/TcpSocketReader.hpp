@@ -1,5 +1,6 @@
 #ifndef BEAM_TCPSOCKETREADER_HPP
 #define BEAM_TCPSOCKETREADER_HPP
+#include <algorithm>
 #include <boost/noncopyable.hpp>
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/IO/IO.hpp"
@@ -8,6 +9,7 @@
 #include "Beam/Network/Network.hpp"
 #include "Beam/Network/NetworkDetails.hpp"
 #include "Beam/Network/SocketException.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Routines/Async.hpp"
 
 namespace Beam {
@@ -15,6 +17,10 @@ namespace Network {
 
   /*! \class TcpSocketReader
       \brief Reads from a TCP socket.
+      \details Reads first attempt a non-blocking read on the calling routine
+               and only suspend it waiting for the socket when no data is
+               available. Reads into a Buffer keep growing it in place while
+               data remains in the socket's receive buffer.
    */
   class TcpSocketReader : private boost::noncopyable {
     public:
@@ -32,10 +38,16 @@ namespace Network {
 
     private:
       friend class TcpSocketChannel;
-      static const std::size_t DEFAULT_READ_SIZE = 8 * 1024;
+      static constexpr auto DEFAULT_READ_SIZE = std::size_t(8 * 1024);
+      static constexpr auto MAXIMUM_READ_SIZE = std::size_t(64 * 1024);
       std::shared_ptr<Details::TcpSocketEntry> m_socket;
+      bool m_isQuickAckEnabled;
 
-      TcpSocketReader(const std::shared_ptr<Details::TcpSocketEntry>& socket);
+      TcpSocketReader(const std::shared_ptr<Details::TcpSocketEntry>& socket,
+        const TcpSocketOptions& options);
+      std::size_t TryRead(char* destination, std::size_t size,
+        boost::system::error_code& error);
+      static void Throw(const boost::system::error_code& error);
   };
 
   inline bool TcpSocketReader::IsDataAvailable() const {
@@ -49,7 +61,7 @@ namespace Network {
 
   template<typename BufferType>
   std::size_t TcpSocketReader::Read(Out<BufferType> destination) {
-    return Read(Store(destination), DEFAULT_READ_SIZE);
+    return Read(Store(destination), MAXIMUM_READ_SIZE);
   }
 
   inline std::size_t TcpSocketReader::Read(char* destination,
@@ -60,6 +72,13 @@ namespace Network {
       if(!m_socket->m_isOpen) {
         BOOST_THROW_EXCEPTION(IO::EndOfFileException{});
       }
+      auto error = boost::system::error_code();
+      auto readSize = TryRead(destination, size, error);
+      if(!error) {
+        return readSize;
+      } else if(error != boost::asio::error::would_block) {
+        Throw(error);
+      }
       m_socket->m_isReadPending = true;
       m_socket->m_socket.async_read_some(boost::asio::buffer(destination, size),
         [&] (const boost::system::error_code& error, std::size_t readSize) {
@@ -72,6 +91,10 @@ namespace Network {
                 error.message()));
             }
           } else {
+            if(m_isQuickAckEnabled) {
+              auto quickAckError = boost::system::error_code();
+              Details::SetQuickAck(m_socket->m_socket, quickAckError);
+            }
             readResult.GetEval().SetResult(readSize);
           }
         });
@@ -89,18 +112,69 @@ namespace Network {
   template<typename BufferType>
   std::size_t TcpSocketReader::Read(Out<BufferType> destination,
       std::size_t size) {
-    static const auto DEFAULT_READ_SIZE = std::size_t{8 * 1024};
     auto initialSize = destination->GetSize();
     auto readSize = std::min(DEFAULT_READ_SIZE, size);
     destination->Grow(readSize);
     auto result = Read(destination->GetMutableData() + initialSize, readSize);
     destination->Shrink(readSize - result);
-    return result;
+
+    // Once a chunk is filled, the socket likely has more data pending, so
+    // read it in place rather than returning to the caller for another read.
+    while(result == readSize && destination->GetSize() - initialSize < size) {
+      readSize = std::min(2 * readSize,
+        size - (destination->GetSize() - initialSize));
+      auto offset = destination->GetSize();
+      destination->Grow(readSize);
+      auto error = boost::system::error_code();
+      {
+        boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+        if(m_socket->m_isOpen) {
+          result = TryRead(destination->GetMutableData() + offset, readSize,
+            error);
+        } else {
+          result = 0;
+        }
+      }
+      if(error) {
+        result = 0;
+      }
+      destination->Shrink(readSize - result);
+    }
+    return destination->GetSize() - initialSize;
   }
 
   inline TcpSocketReader::TcpSocketReader(
-      const std::shared_ptr<Details::TcpSocketEntry>& socket)
-      : m_socket(socket) {}
+      const std::shared_ptr<Details::TcpSocketEntry>& socket,
+      const TcpSocketOptions& options)
+      : m_socket(socket),
+        m_isQuickAckEnabled(options.m_quickAckEnabled) {}
+
+  inline std::size_t TcpSocketReader::TryRead(char* destination,
+      std::size_t size, boost::system::error_code& error) {
+    if(!m_socket->m_socket.non_blocking()) {
+      m_socket->m_socket.non_blocking(true, error);
+      if(error) {
+        return 0;
+      }
+    }
+    auto readSize = m_socket->m_socket.read_some(
+      boost::asio::buffer(destination, size), error);
+
+    // The kernel falls back to delayed acknowledgements after a read, so
+    // quick acknowledgements have to be re-armed each time.
+    if(!error && m_isQuickAckEnabled) {
+      auto quickAckError = boost::system::error_code();
+      Details::SetQuickAck(m_socket->m_socket, quickAckError);
+    }
+    return readSize;
+  }
+
+  inline void TcpSocketReader::Throw(const boost::system::error_code& error) {
+    if(Details::IsEndOfFile(error)) {
+      BOOST_THROW_EXCEPTION(IO::EndOfFileException(error.message()));
+    }
+    BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
+  }
 }
 
   template<typename BufferType>
@@ -1,10 +1,24 @@
 #ifndef BEAM_TCPSOCKETWRITER_HPP
 #define BEAM_TCPSOCKETWRITER_HPP
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/noncopyable.hpp>
+#ifdef __linux__
+  #include <csignal>
+  #include <ctime>
+  #include <pthread.h>
+  #include <sys/sendfile.h>
+#endif
+#include "Beam/IO/ChainedBuffer.hpp"
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/IO/IO.hpp"
+#include "Beam/IO/IOException.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/IO/Writer.hpp"
 #include "Beam/Network/Network.hpp"
@@ -15,6 +29,34 @@
 
 namespace Beam {
 namespace Network {
+#ifdef __linux__
+namespace Details {
+
+  //! Calls sendfile, which unlike send has no MSG_NOSIGNAL, with SIGPIPE
+  //! blocked and discarding the SIGPIPE raised if the peer has closed.
+  inline ssize_t SendFileWithoutSigPipe(int socket, int descriptor,
+      off_t* offset, std::size_t size) {
+    auto pipeSignal = sigset_t();
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    auto pendingSignals = sigset_t();
+    sigpending(&pendingSignals);
+    auto isPipePending = sigismember(&pendingSignals, SIGPIPE) == 1;
+    auto previousMask = sigset_t();
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &previousMask);
+    auto result = ::sendfile(socket, descriptor, offset, size);
+    auto error = errno;
+    if(result == -1 && error == EPIPE && !isPipePending) {
+      auto timeout = timespec{0, 0};
+      while(sigtimedwait(&pipeSignal, nullptr, &timeout) == -1 &&
+        errno == EINTR) {}
+    }
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+    errno = error;
+    return result;
+  }
+}
+#endif
 
   /*! \class TcpSocketWriter
       \brief Writes to a TCP socket.
@@ -25,25 +67,103 @@ namespace Network {
 
       void Write(const void* data, std::size_t size);
 
+      //! Writes every segment of a ChainedBuffer in a single vectored write.
+      /*!
+        \param data The ChainedBuffer to write.
+      */
+      void Write(const IO::ChainedBuffer& data);
+
       template<typename BufferType>
       void Write(const BufferType& data);
 
+#ifdef __linux__
+      //! Writes a range of a file using sendfile, so that its contents are
+      //! never copied into user space.
+      /*!
+        \param descriptor The descriptor of the file to write.
+        \param offset The offset of the first byte to write.
+        \param size The number of bytes to write.
+      */
+      void SendFile(int descriptor, std::uint64_t offset, std::uint64_t size);
+#endif
+
     private:
       friend class TcpSocketChannel;
       std::shared_ptr<Details::TcpSocketEntry> m_socket;
       Threading::TaskRunner m_tasks;
 
       TcpSocketWriter(const std::shared_ptr<Details::TcpSocketEntry>& socket);
+      template<typename ConstBufferSequence>
+      void WriteBuffers(const ConstBufferSequence& buffers);
+#ifdef __linux__
+      void WaitForWrite();
+      std::size_t SendFileSegment(int descriptor, std::uint64_t offset,
+        std::uint64_t size);
+#endif
   };
 
   inline void TcpSocketWriter::Write(const void* data, std::size_t size) {
+    WriteBuffers(boost::asio::buffer(data, size));
+  }
+
+  inline void TcpSocketWriter::Write(const IO::ChainedBuffer& data) {
+    auto buffers = std::vector<boost::asio::const_buffer>();
+    buffers.reserve(data.GetSegmentCount());
+    data.ForEachSegment(
+      [&] (const char* segment, std::size_t size) {
+        buffers.emplace_back(segment, size);
+      });
+    WriteBuffers(buffers);
+  }
+
+  template<typename BufferType>
+  void TcpSocketWriter::Write(const BufferType& data) {
+    Write(data.GetData(), data.GetSize());
+  }
+
+#ifdef __linux__
+  inline void TcpSocketWriter::SendFile(int descriptor, std::uint64_t offset,
+      std::uint64_t size) {
+    while(size != 0) {
+      Routines::Async<std::size_t> sendResult;
+      m_socket->BeginWriteOperation();
+      m_tasks.Add(
+        [&] {
+          try {
+            sendResult.GetEval().SetResult(SendFileSegment(descriptor, offset,
+              size));
+          } catch(const std::exception&) {
+            sendResult.GetEval().SetException(std::current_exception());
+          }
+        });
+      try {
+        auto segmentSize = sendResult.Get();
+        m_socket->EndWriteOperation();
+        if(segmentSize == 0) {
+          WaitForWrite();
+        }
+        offset += segmentSize;
+        size -= segmentSize;
+      } catch(...) {
+        m_socket->EndWriteOperation();
+        BOOST_RETHROW;
+      }
+    }
+  }
+#endif
+
+  inline TcpSocketWriter::TcpSocketWriter(
+      const std::shared_ptr<Details::TcpSocketEntry>& socket)
+      : m_socket{socket} {}
+
+  template<typename ConstBufferSequence>
+  void TcpSocketWriter::WriteBuffers(const ConstBufferSequence& buffers) {
     Routines::Async<void> writeResult;
     m_socket->BeginWriteOperation();
     m_tasks.Add(
       [&] {
         boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
-        boost::asio::async_write(m_socket->m_socket,
-            boost::asio::buffer(data, size),
+        boost::asio::async_write(m_socket->m_socket, buffers,
           [&] (const boost::system::error_code& error, std::size_t writeSize) {
             if(error) {
               if(Details::IsEndOfFile(error)) {
@@ -66,14 +186,68 @@ namespace Network {
     }
   }
 
-  template<typename BufferType>
-  void TcpSocketWriter::Write(const BufferType& data) {
-    Write(data.GetData(), data.GetSize());
+#ifdef __linux__
+  inline void TcpSocketWriter::WaitForWrite() {
+    Routines::Async<void> waitResult;
+    m_socket->BeginWriteOperation();
+    m_tasks.Add(
+      [&] {
+        boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+        m_socket->m_socket.async_wait(boost::asio::socket_base::wait_write,
+          [&] (const boost::system::error_code& error) {
+            if(error) {
+              if(Details::IsEndOfFile(error)) {
+                waitResult.GetEval().SetException(IO::EndOfFileException());
+                return;
+              }
+              waitResult.GetEval().SetException(SocketException(error.value(),
+                error.message()));
+              return;
+            }
+            waitResult.GetEval().SetResult();
+          });
+      });
+    try {
+      waitResult.Get();
+      m_socket->EndWriteOperation();
+    } catch(...) {
+      m_socket->EndWriteOperation();
+      BOOST_RETHROW;
+    }
   }
 
-  inline TcpSocketWriter::TcpSocketWriter(
-      const std::shared_ptr<Details::TcpSocketEntry>& socket)
-      : m_socket{socket} {}
+  inline std::size_t TcpSocketWriter::SendFileSegment(int descriptor,
+      std::uint64_t offset, std::uint64_t size) {
+
+    // Linux transfers at most this many bytes per call.
+    const auto MAX_SEGMENT_SIZE = std::uint64_t(0x7FFFF000);
+    boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+    if(!m_socket->m_isOpen) {
+      BOOST_THROW_EXCEPTION(IO::EndOfFileException());
+    }
+    auto error = boost::system::error_code();
+    m_socket->m_socket.native_non_blocking(true, error);
+    if(error) {
+      BOOST_THROW_EXCEPTION(SocketException(error.value(), error.message()));
+    }
+    auto position = static_cast<off_t>(offset);
+    auto result = Details::SendFileWithoutSigPipe(
+      m_socket->m_socket.native_handle(), descriptor, &position,
+      static_cast<std::size_t>(std::min(size, MAX_SEGMENT_SIZE)));
+    if(result < 0) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+      } else if(errno == EPIPE || errno == ECONNRESET) {
+        BOOST_THROW_EXCEPTION(IO::EndOfFileException());
+      }
+      BOOST_THROW_EXCEPTION(SocketException(errno, std::strerror(errno)));
+    } else if(result == 0) {
+      BOOST_THROW_EXCEPTION(IO::IOException(
+        "The file ended before the range was written."));
+    }
+    return static_cast<std::size_t>(result);
+  }
+#endif
 }
 
   template<typename BufferType>
@@ -1,8 +1,17 @@
 #ifndef BEAM_UDPSOCKETRECEIVER_HPP
 #define BEAM_UDPSOCKETRECEIVER_HPP
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 #include <boost/asio/ip/udp.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/date_time/posix_time/conversion.hpp>
 #include <boost/noncopyable.hpp>
+#ifdef __linux__
+  #include <sys/socket.h>
+  #include <time.h>
+#endif
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/Network/DatagramPacket.hpp"
 #include "Beam/Network/Network.hpp"
@@ -43,6 +52,10 @@ namespace Network {
         //! The default size of the receive buffer.
         std::size_t m_receiveBufferSize;
 
+        //! Whether the kernel's receive time is recorded on DatagramPackets
+        //! received in batches, only supported on Linux.
+        bool m_isTimestamped;
+
         //! Constructs default settings.
         Settings();
       };
@@ -109,7 +122,31 @@ namespace Network {
       std::size_t Receive(Out<Buffer> destination, std::size_t size,
         Out<IpAddress> address);
 
+      //! Receives a batch of DatagramPackets, waiting for at least one and
+      //! then taking as many as are already queued, using a single system call
+      //! where supported.
+      /*!
+        \param packets The packets to receive into, their Buffers are reset and
+               reused.
+        \param count The maximum number of packets to receive.
+        \return The number of packets received.
+      */
+      template<typename Buffer>
+      std::size_t Receive(DatagramPacket<Buffer>* packets, std::size_t count);
+
     private:
+#ifdef __linux__
+      static constexpr std::size_t CONTROL_SIZE =
+        CMSG_SPACE(sizeof(timespec));
+      struct Batch {
+        std::vector<mmsghdr> m_headers;
+        std::vector<iovec> m_vectors;
+        std::vector<boost::asio::ip::udp::endpoint> m_endpoints;
+        std::vector<std::uint64_t> m_control;
+      };
+      Threading::Mutex m_batchMutex;
+      Batch m_batch;
+#endif
       mutable Threading::Mutex m_mutex;
       bool m_isOpen;
       bool m_isDeadlinePending;
@@ -118,13 +155,21 @@ namespace Network {
       boost::asio::basic_waitable_timer<boost::chrono::steady_clock> m_deadline;
       Settings m_settings;
 
+      bool StartDeadline();
+      void WaitForRead();
+#ifdef __linux__
+      template<typename Buffer>
+      std::size_t ReceiveBatch(DatagramPacket<Buffer>* packets,
+        std::size_t count);
+#endif
       void CheckDeadline(const boost::system::error_code& error);
   };
 
   inline UdpSocketReceiver::Settings::Settings()
       : m_timeout{boost::posix_time::pos_infin},
         m_maxDatagramSize{DEFAULT_DATAGRAM_SIZE},
-        m_receiveBufferSize{DEFAULT_RECEIVE_BUFFER_SIZE} {}
+        m_receiveBufferSize{DEFAULT_RECEIVE_BUFFER_SIZE},
+        m_isTimestamped{false} {}
 
   inline UdpSocketReceiver::UdpSocketReceiver(
       const std::shared_ptr<Details::UdpSocketEntry>& socket)
@@ -158,6 +203,16 @@ namespace Network {
       BOOST_THROW_EXCEPTION(SocketException(errorCode.value(),
         errorCode.message()));
     }
+#ifdef __linux__
+    if(m_settings.m_isTimestamped) {
+      auto isEnabled = 1;
+      boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+      if(::setsockopt(m_socket->m_socket.native_handle(), SOL_SOCKET,
+          SO_TIMESTAMPNS, &isEnabled, sizeof(isEnabled)) != 0) {
+        BOOST_THROW_EXCEPTION(SocketException(errno, std::strerror(errno)));
+      }
+    }
+#endif
     m_isOpen = true;
   }
 
@@ -193,15 +248,7 @@ namespace Network {
           readResult.GetEval().SetResult(readSize);
         });
     }
-    auto hasTimeout = m_settings.m_timeout != boost::posix_time::pos_infin;
-    if(hasTimeout) {
-      boost::lock_guard<Threading::Mutex> lock{m_mutex};
-      m_isDeadlinePending = true;
-      m_deadline.expires_from_now(boost::chrono::microseconds{
-        m_settings.m_timeout.total_microseconds()});
-      m_deadline.async_wait(std::bind(&UdpSocketReceiver::CheckDeadline, this,
-        std::placeholders::_1));
-    }
+    auto hasTimeout = StartDeadline();
     try {
       auto result = readResult.Get();
       if(hasTimeout) {
@@ -240,6 +287,157 @@ namespace Network {
     return result;
   }
 
+  template<typename Buffer>
+  std::size_t UdpSocketReceiver::Receive(DatagramPacket<Buffer>* packets,
+      std::size_t count) {
+    if(count == 0) {
+      return 0;
+    }
+#ifdef __linux__
+    while(true) {
+      auto received = ReceiveBatch(packets, count);
+      if(received != 0) {
+        return received;
+      }
+      WaitForRead();
+    }
+#else
+    Receive(Store(packets[0]));
+    return 1;
+#endif
+  }
+
+  inline bool UdpSocketReceiver::StartDeadline() {
+    if(m_settings.m_timeout == boost::posix_time::pos_infin) {
+      return false;
+    }
+    boost::lock_guard<Threading::Mutex> lock{m_mutex};
+    m_isDeadlinePending = true;
+    m_deadline.expires_from_now(boost::chrono::microseconds{
+      m_settings.m_timeout.total_microseconds()});
+    m_deadline.async_wait(std::bind(&UdpSocketReceiver::CheckDeadline, this,
+      std::placeholders::_1));
+    return true;
+  }
+
+  inline void UdpSocketReceiver::WaitForRead() {
+    Routines::Async<void> waitResult;
+    {
+      boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+      if(!m_socket->m_isOpen) {
+        BOOST_THROW_EXCEPTION(IO::EndOfFileException{});
+      }
+      m_socket->m_isReadPending = true;
+      m_socket->m_socket.async_wait(boost::asio::socket_base::wait_read,
+        [&] (const boost::system::error_code& error) {
+          if(error) {
+            if(Details::IsEndOfFile(error)) {
+              waitResult.GetEval().SetException(IO::EndOfFileException());
+              return;
+            }
+            waitResult.GetEval().SetException(SocketException(error.value(),
+              error.message()));
+            return;
+          }
+          waitResult.GetEval().SetResult();
+        });
+    }
+    auto hasTimeout = StartDeadline();
+    try {
+      waitResult.Get();
+      if(hasTimeout) {
+        m_deadline.cancel();
+      }
+      m_socket->EndReadOperation();
+    } catch(...) {
+      m_socket->EndReadOperation();
+      BOOST_RETHROW;
+    }
+  }
+
+#ifdef __linux__
+  template<typename Buffer>
+  std::size_t UdpSocketReceiver::ReceiveBatch(DatagramPacket<Buffer>* packets,
+      std::size_t count) {
+    boost::lock_guard<Threading::Mutex> batchLock{m_batchMutex};
+    auto controlWords = CONTROL_SIZE / sizeof(std::uint64_t);
+    m_batch.m_headers.resize(count);
+    m_batch.m_vectors.resize(count);
+    m_batch.m_endpoints.resize(count);
+    if(m_settings.m_isTimestamped) {
+      m_batch.m_control.resize(count * controlWords);
+    }
+    for(auto i = std::size_t(0); i < count; ++i) {
+      auto& data = packets[i].GetData();
+      data.Reset();
+      data.Grow(m_settings.m_maxDatagramSize);
+      m_batch.m_vectors[i].iov_base = data.GetMutableData();
+      m_batch.m_vectors[i].iov_len = m_settings.m_maxDatagramSize;
+      auto& header = m_batch.m_headers[i].msg_hdr;
+      std::memset(&header, 0, sizeof(header));
+      header.msg_name = m_batch.m_endpoints[i].data();
+      header.msg_namelen = static_cast<socklen_t>(
+        m_batch.m_endpoints[i].capacity());
+      header.msg_iov = &m_batch.m_vectors[i];
+      header.msg_iovlen = 1;
+      if(m_settings.m_isTimestamped) {
+        header.msg_control = &m_batch.m_control[i * controlWords];
+        header.msg_controllen = CONTROL_SIZE;
+      }
+    }
+    auto error = 0;
+    auto result = [&] {
+      boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+      if(!m_socket->m_isOpen) {
+        BOOST_THROW_EXCEPTION(IO::EndOfFileException{});
+      }
+      auto messages = ::recvmmsg(m_socket->m_socket.native_handle(),
+        m_batch.m_headers.data(), static_cast<unsigned int>(count),
+        MSG_DONTWAIT, nullptr);
+      error = errno;
+      return messages;
+    }();
+    if(result < 0) {
+      for(auto i = std::size_t(0); i < count; ++i) {
+        packets[i].GetData().Reset();
+      }
+      if(error == EAGAIN || error == EWOULDBLOCK || error == EINTR) {
+        return 0;
+      }
+      BOOST_THROW_EXCEPTION(SocketException(error, std::strerror(error)));
+    }
+    auto received = static_cast<std::size_t>(result);
+    for(auto i = std::size_t(0); i < count; ++i) {
+      auto& packet = packets[i];
+      if(i >= received) {
+        packet.GetData().Reset();
+        continue;
+      }
+      auto& header = m_batch.m_headers[i];
+      packet.GetData().Shrink(m_settings.m_maxDatagramSize - header.msg_len);
+      auto& endpoint = m_batch.m_endpoints[i];
+      endpoint.resize(header.msg_hdr.msg_namelen);
+      packet.GetAddress() = IpAddress(endpoint.address().to_string(),
+        endpoint.port());
+      packet.SetTimestamp(boost::posix_time::not_a_date_time);
+      if(!m_settings.m_isTimestamped) {
+        continue;
+      }
+      for(auto message = CMSG_FIRSTHDR(&header.msg_hdr); message != nullptr;
+          message = CMSG_NXTHDR(&header.msg_hdr, message)) {
+        if(message->cmsg_level == SOL_SOCKET &&
+            message->cmsg_type == SCM_TIMESTAMPNS) {
+          auto time = timespec();
+          std::memcpy(&time, CMSG_DATA(message), sizeof(time));
+          packet.SetTimestamp(boost::posix_time::from_time_t(time.tv_sec) +
+            boost::posix_time::microseconds(time.tv_nsec / 1000));
+        }
+      }
+    }
+    return received;
+  }
+#endif
+
   inline void UdpSocketReceiver::CheckDeadline(
       const boost::system::error_code& error) {
     {
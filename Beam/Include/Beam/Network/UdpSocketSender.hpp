@@ -1,7 +1,14 @@
 #ifndef BEAM_UDPSOCKETSENDER_HPP
 #define BEAM_UDPSOCKETSENDER_HPP
+#include <cerrno>
+#include <cstring>
+#include <vector>
 #include <boost/asio/ip/udp.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#ifdef __linux__
+  #include <sys/socket.h>
+#endif
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/Network/DatagramPacket.hpp"
 #include "Beam/Network/Network.hpp"
@@ -10,6 +17,7 @@
 #include "Beam/Network/SocketThreadPool.hpp"
 #include "Beam/Pointers/Out.hpp"
 #include "Beam/Routines/Async.hpp"
+#include "Beam/Threading/Mutex.hpp"
 #include "Beam/Threading/TaskRunner.hpp"
 
 namespace Beam {
@@ -43,9 +51,34 @@ namespace Network {
       void Send(const void* data, std::size_t size,
         const IpAddress& destination);
 
+      //! Sends a batch of DatagramPackets, using a single system call where
+      //! supported.
+      /*!
+        \param packets The DatagramPackets to send.
+        \param count The number of packets to send.
+      */
+      template<typename Buffer>
+      void Send(const DatagramPacket<Buffer>* packets, std::size_t count);
+
     private:
+#ifdef __linux__
+      struct Batch {
+        std::vector<mmsghdr> m_headers;
+        std::vector<iovec> m_vectors;
+        std::vector<boost::asio::ip::udp::endpoint> m_endpoints;
+      };
+      Threading::Mutex m_batchMutex;
+      Batch m_batch;
+#endif
       std::shared_ptr<Details::UdpSocketEntry> m_socket;
       Threading::TaskRunner m_tasks;
+
+      void WaitForWrite();
+#ifdef __linux__
+      template<typename Buffer>
+      std::size_t SendBatch(const DatagramPacket<Buffer>* packets,
+        std::size_t count);
+#endif
   };
 
   inline UdpSocketSender::UdpSocketSender(
@@ -90,6 +123,121 @@ namespace Network {
       BOOST_RETHROW;
     }
   }
+
+  template<typename Buffer>
+  void UdpSocketSender::Send(const DatagramPacket<Buffer>* packets,
+      std::size_t count) {
+#ifdef __linux__
+    auto sent = std::size_t(0);
+    while(sent < count) {
+      Routines::Async<std::size_t> sendResult;
+      m_socket->BeginWriteOperation();
+      m_tasks.Add(
+        [&] {
+          try {
+            sendResult.GetEval().SetResult(SendBatch(packets + sent,
+              count - sent));
+          } catch(const std::exception&) {
+            sendResult.GetEval().SetException(std::current_exception());
+          }
+        });
+      try {
+        auto batchSize = sendResult.Get();
+        m_socket->EndWriteOperation();
+        if(batchSize == 0) {
+          WaitForWrite();
+        }
+        sent += batchSize;
+      } catch(...) {
+        m_socket->EndWriteOperation();
+        BOOST_RETHROW;
+      }
+    }
+#else
+    for(auto i = std::size_t(0); i < count; ++i) {
+      Send(packets[i]);
+    }
+#endif
+  }
+
+  inline void UdpSocketSender::WaitForWrite() {
+    Routines::Async<void> waitResult;
+    m_socket->BeginWriteOperation();
+    {
+      boost::unique_lock<Threading::Mutex> lock{m_socket->m_mutex};
+      if(!m_socket->m_isOpen) {
+        lock.unlock();
+        m_socket->EndWriteOperation();
+        BOOST_THROW_EXCEPTION(IO::EndOfFileException{});
+      }
+      m_socket->m_socket.async_wait(boost::asio::socket_base::wait_write,
+        [&] (const boost::system::error_code& error) {
+          if(error) {
+            if(Details::IsEndOfFile(error)) {
+              waitResult.GetEval().SetException(IO::EndOfFileException());
+              return;
+            }
+            waitResult.GetEval().SetException(SocketException(error.value(),
+              error.message()));
+            return;
+          }
+          waitResult.GetEval().SetResult();
+        });
+    }
+    try {
+      waitResult.Get();
+      m_socket->EndWriteOperation();
+    } catch(...) {
+      m_socket->EndWriteOperation();
+      BOOST_RETHROW;
+    }
+  }
+
+#ifdef __linux__
+  template<typename Buffer>
+  std::size_t UdpSocketSender::SendBatch(const DatagramPacket<Buffer>* packets,
+      std::size_t count) {
+    boost::lock_guard<Threading::Mutex> batchLock{m_batchMutex};
+    m_batch.m_headers.resize(count);
+    m_batch.m_vectors.resize(count);
+    m_batch.m_endpoints.resize(count);
+    for(auto i = std::size_t(0); i < count; ++i) {
+      auto& packet = packets[i];
+      auto& endpoint = m_batch.m_endpoints[i];
+      endpoint = boost::asio::ip::udp::endpoint(
+        boost::asio::ip::address::from_string(packet.GetAddress().GetHost()),
+        packet.GetAddress().GetPort());
+      m_batch.m_vectors[i].iov_base =
+        const_cast<char*>(packet.GetData().GetData());
+      m_batch.m_vectors[i].iov_len = packet.GetData().GetSize();
+      auto& header = m_batch.m_headers[i].msg_hdr;
+      std::memset(&header, 0, sizeof(header));
+      header.msg_name = endpoint.data();
+      header.msg_namelen = static_cast<socklen_t>(endpoint.size());
+      header.msg_iov = &m_batch.m_vectors[i];
+      header.msg_iovlen = 1;
+    }
+    auto error = 0;
+    auto result = [&] {
+      boost::lock_guard<Threading::Mutex> lock{m_socket->m_mutex};
+      if(!m_socket->m_isOpen) {
+        BOOST_THROW_EXCEPTION(IO::EndOfFileException{});
+      }
+      auto messages = ::sendmmsg(m_socket->m_socket.native_handle(),
+        m_batch.m_headers.data(), static_cast<unsigned int>(count),
+        MSG_DONTWAIT);
+      error = errno;
+      return messages;
+    }();
+    if(result < 0) {
+      if(error == EAGAIN || error == EWOULDBLOCK || error == EINTR) {
+        return 0;
+      }
+      BOOST_THROW_EXCEPTION(SocketException(error, std::strerror(error)));
+    }
+    return static_cast<std::size_t>(result);
+  }
+#endif
 }
 }
 
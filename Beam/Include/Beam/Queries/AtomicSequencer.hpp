@@ -0,0 +1,123 @@
+#ifndef BEAM_ATOMICSEQUENCER_HPP
+#define BEAM_ATOMICSEQUENCER_HPP
+#include <atomic>
+#include <climits>
+#include <stdexcept>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/Queries/IndexedValue.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Queries/Range.hpp"
+#include "Beam/Queries/Sequence.hpp"
+#include "Beam/Queries/SequencedValue.hpp"
+#include "Beam/Queries/Sequencer.hpp"
+
+namespace Beam {
+namespace Queries {
+
+  /*! \class AtomicSequencer
+      \brief A Sequencer that can be shared among threads without external
+             synchronization.
+      \details The partition is recovered from the date bits encoded in the
+               next Sequence, allowing both to be updated with a single atomic
+               compare and exchange.
+   */
+  class AtomicSequencer : private boost::noncopyable {
+    public:
+
+      //! Constructs an AtomicSequencer.
+      /*!
+        \param initialSequence The Sequence to use on the first value.
+      */
+      explicit AtomicSequencer(Sequence initialSequence);
+
+      //! Makes a SequencedValue encoding the value's timestamp into the
+      //! Sequence.
+      /*!
+        \param value The SequencedValue's value.
+        \param index The SequencedValue's index.
+        \return A SequencedValue representing the <i>value</i> and <i>index</i>
+                with a Sequence encoding the <i>value</i>'s timestamp.
+      */
+      template<typename Value, typename Index>
+      SequencedValue<IndexedValue<Value, Index>> MakeSequencedValue(
+        Value value, Index index);
+
+      //! Returns the next Sequence that will be produced, ignoring partitions.
+      Sequence GetNextSequence() const;
+
+      //! Returns the next Sequence to use for a specified timestamp.
+      /*!
+        \param timestamp The timestamp to translate into a Sequence.
+        \return The next Sequence to use for the specified <i>timestamp</i>.
+      */
+      Sequence IncrementNextSequence(
+        const boost::posix_time::ptime& timestamp);
+
+      //! Reserves a contiguous block of Sequences for a specified timestamp.
+      /*!
+        \param timestamp The timestamp to translate into a Sequence.
+        \param count The number of Sequences to reserve, std::invalid_argument
+               is thrown if it isn't positive.
+        \return The first Sequence in the reserved block, the remaining
+                Sequences are obtained by incrementing it.
+      */
+      Sequence IncrementNextSequence(const boost::posix_time::ptime& timestamp,
+        int count);
+
+    private:
+      static constexpr auto PARTITION_MASK = ~Sequence::Ordinal(0) <<
+        (CHAR_BIT * sizeof(Sequence::Ordinal) - 23);
+      std::atomic<Sequence::Ordinal> m_nextSequence;
+  };
+
+  inline AtomicSequencer::AtomicSequencer(Sequence initialSequence)
+      : m_nextSequence(initialSequence.GetOrdinal()) {}
+
+  template<typename Value, typename Index>
+  SequencedValue<IndexedValue<Value, Index>> AtomicSequencer::
+      MakeSequencedValue(Value value, Index index) {
+    auto sequence = IncrementNextSequence(GetTimestamp(value));
+    return SequencedValue(IndexedValue(std::move(value), std::move(index)),
+      sequence);
+  }
+
+  inline Sequence AtomicSequencer::GetNextSequence() const {
+    return Sequence(m_nextSequence.load(std::memory_order_acquire));
+  }
+
+  inline Sequence AtomicSequencer::IncrementNextSequence(
+      const boost::posix_time::ptime& timestamp) {
+    return IncrementNextSequence(timestamp, 1);
+  }
+
+  inline Sequence AtomicSequencer::IncrementNextSequence(
+      const boost::posix_time::ptime& timestamp, int count) {
+    if(count <= 0) {
+      BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid count."));
+    }
+    auto partition = EncodeTimestamp(timestamp).GetOrdinal();
+    auto nextSequence = m_nextSequence.load(std::memory_order_relaxed);
+    while(true) {
+      auto sequence = [&] {
+        if(partition <= (nextSequence & PARTITION_MASK)) {
+          return nextSequence;
+        }
+        return partition;
+      }();
+      auto reservation = [&] {
+        if(sequence > Sequence::Last().GetOrdinal() - count) {
+          return Sequence::Last().GetOrdinal();
+        }
+        return sequence + count;
+      }();
+      if(m_nextSequence.compare_exchange_weak(nextSequence, reservation,
+          std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return Sequence(sequence);
+      }
+    }
+  }
+}
+}
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef BEAM_BUFFERED_DATA_STORE_HPP
 #define BEAM_BUFFERED_DATA_STORE_HPP
 #include <algorithm>
+#include <array>
+#include <filesystem>
 #include <memory>
 #include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
 #include "Beam/IO/OpenState.hpp"
@@ -13,13 +17,20 @@
 #include "Beam/Queries/LocalDataStore.hpp"
 #include "Beam/Queries/Queries.hpp"
 #include "Beam/Queries/Range.hpp"
+#include "Beam/Queries/WriteAheadLog.hpp"
 #include "Beam/Queues/RoutineTaskQueue.hpp"
+#include "Beam/Threading/LiveTimer.hpp"
+#include "Beam/Threading/TimerThreadPool.hpp"
 #include "Beam/Utilities/Algorithm.hpp"
 
 namespace Beam::Queries {
 
   /**
    * Buffers writes to a data store.
+   * Buffered values can optionally be appended to a WriteAheadLog, which is
+   * truncated once they are flushed and replayed into the data store upon
+   * being opened after a crash. The log is flushed to disk by a timer so that
+   * no value goes unsynced for longer than the sync interval.
    * @param <D> The type of data store to buffer writes to.
    * @param <E> The type of EvaluatorTranslator used for filtering values.
    */
@@ -58,6 +69,24 @@ namespace Beam::Queries {
       template<typename DS>
       BufferedDataStore(DS&& dataStore, std::size_t bufferSize);
 
+      /**
+       * Constructs a BufferedDataStore that logs buffered values.
+       * @param dataStore Initializes the data store to buffer data to.
+       * @param bufferSize The number of messages to buffer before committing to
+       *        to the <i>dataStore</i>.
+       * @param logPath The path used to name the WriteAheadLog files, two
+       *        files are used by appending the extensions .0 and .1.
+       * @param syncInterval The maximum amount of time a value stays in the
+       *        WriteAheadLog before being flushed to disk.
+       * @param timerThreadPool The TimerThreadPool used to flush the
+       *        WriteAheadLog once the <i>syncInterval</i> elapses.
+       */
+      template<typename DS>
+      BufferedDataStore(DS&& dataStore, std::size_t bufferSize,
+        const std::filesystem::path& logPath,
+        boost::posix_time::time_duration syncInterval,
+        Ref<Threading::TimerThreadPool> timerThreadPool);
+
       ~BufferedDataStore();
 
       std::vector<SequencedValue> Load(const Query& query);
@@ -79,12 +108,17 @@ namespace Beam::Queries {
       std::size_t m_bufferCount;
       std::shared_ptr<ReserveDataStore> m_dataStoreBuffer;
       std::shared_ptr<ReserveDataStore> m_flushedDataStore;
+      std::array<std::unique_ptr<WriteAheadLog<IndexedValue>>, 2> m_logs;
+      std::size_t m_activeLog;
+      boost::optional<Threading::LiveTimer> m_syncTimer;
       IO::OpenState m_openState;
       RoutineTaskQueue m_tasks;
 
       void Shutdown();
+      void Recover();
       void Flush();
       void TestFlush();
+      void OnSyncTimer(Threading::Timer::Result result);
   };
 
   template<typename D, typename E>
@@ -95,7 +129,31 @@ namespace Beam::Queries {
       m_bufferSize(bufferSize),
       m_bufferCount(0),
       m_dataStoreBuffer(std::make_shared<ReserveDataStore>()),
-      m_flushedDataStore(m_dataStoreBuffer) {}
+      m_flushedDataStore(m_dataStoreBuffer),
+      m_activeLog(0) {}
+
+  template<typename D, typename E>
+  template<typename DS>
+  BufferedDataStore<D, E>::BufferedDataStore(DS&& dataStore,
+      std::size_t bufferSize, const std::filesystem::path& logPath,
+      boost::posix_time::time_duration syncInterval,
+      Ref<Threading::TimerThreadPool> timerThreadPool)
+      : BufferedDataStore(std::forward<DS>(dataStore), bufferSize) {
+    for(auto i = std::size_t(0); i != m_logs.size(); ++i) {
+      auto path = logPath;
+      path += "." + std::to_string(i);
+      m_logs[i] = std::make_unique<WriteAheadLog<IndexedValue>>(
+        std::move(path), syncInterval);
+    }
+    if(syncInterval > boost::posix_time::seconds(0)) {
+      m_syncTimer.emplace(syncInterval, Ref(timerThreadPool));
+      m_syncTimer->GetPublisher().Monitor(
+        m_tasks.GetSlot<Threading::Timer::Result>(
+        [=] (Threading::Timer::Result result) {
+          OnSyncTimer(result);
+        }));
+    }
+  }
 
   template<typename D, typename E>
   BufferedDataStore<D, E>::~BufferedDataStore() {
@@ -146,6 +204,9 @@ namespace Beam::Queries {
   template<typename D, typename E>
   void BufferedDataStore<D, E>::Store(const IndexedValue& value) {
     auto lock = boost::lock_guard(m_mutex);
+    if(m_logs[m_activeLog]) {
+      m_logs[m_activeLog]->Append(value);
+    }
     ++m_bufferCount;
     m_dataStoreBuffer->Store(value);
     TestFlush();
@@ -154,6 +215,9 @@ namespace Beam::Queries {
   template<typename D, typename E>
   void BufferedDataStore<D, E>::Store(const std::vector<IndexedValue>& values) {
     auto lock = boost::lock_guard(m_mutex);
+    if(m_logs[m_activeLog]) {
+      m_logs[m_activeLog]->Append(values);
+    }
     m_bufferCount += values.size();
     m_dataStoreBuffer->Store(values);
     TestFlush();
@@ -167,6 +231,10 @@ namespace Beam::Queries {
     try {
       m_dataStoreBuffer->Open();
       m_dataStore->Open();
+      Recover();
+      if(m_syncTimer) {
+        m_syncTimer->Start();
+      }
     } catch(const std::exception&) {
       m_openState.SetOpenFailure();
       Shutdown();
@@ -191,9 +259,35 @@ namespace Beam::Queries {
         writeToken.GetEval().SetResult();
       });
     writeToken.Get();
+    if(m_syncTimer) {
+
+      // The tasks are stopped first since OnSyncTimer restarts the timer.
+      m_tasks.Break();
+      m_tasks.Wait();
+      m_syncTimer->Cancel();
+    }
     m_openState.SetClosed();
   }
 
+  template<typename D, typename E>
+  void BufferedDataStore<D, E>::Recover() {
+    auto values = std::vector<IndexedValue>();
+    for(auto& log : m_logs) {
+      if(log) {
+        auto loggedValues = log->Load();
+        values.insert(values.end(), loggedValues.begin(), loggedValues.end());
+      }
+    }
+    if(values.empty()) {
+      return;
+    }
+    std::stable_sort(values.begin(), values.end(), SequenceComparator());
+    m_dataStore->Store(values);
+    for(auto& log : m_logs) {
+      log->Truncate();
+    }
+  }
+
   template<typename D, typename E>
   void BufferedDataStore<D, E>::TestFlush() {
     if(m_bufferCount < m_bufferSize) {
@@ -209,16 +303,36 @@ namespace Beam::Queries {
   template<typename D, typename E>
   void BufferedDataStore<D, E>::Flush() {
     auto dataStore = std::make_shared<ReserveDataStore>();
+    auto flushedLog = std::size_t();
     {
       auto lock = boost::lock_guard(m_mutex);
       dataStore.swap(m_dataStoreBuffer);
+      flushedLog = m_activeLog;
+      m_activeLog = (m_activeLog + 1) % m_logs.size();
     }
     m_dataStore->Store(dataStore->LoadAll());
+    if(m_logs[flushedLog]) {
+      m_logs[flushedLog]->Truncate();
+    }
     {
       auto lock = boost::lock_guard(m_mutex);
       m_flushedDataStore = m_dataStoreBuffer;
     }
   }
+
+  template<typename D, typename E>
+  void BufferedDataStore<D, E>::OnSyncTimer(Threading::Timer::Result result) {
+    if(result != Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    {
+      auto lock = boost::lock_guard(m_mutex);
+      for(auto& log : m_logs) {
+        log->Sync();
+      }
+    }
+    m_syncTimer->Start();
+  }
 }
 
 #endif
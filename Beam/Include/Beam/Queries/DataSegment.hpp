@@ -0,0 +1,435 @@
+#ifndef BEAM_DATA_SEGMENT_HPP
+#define BEAM_DATA_SEGMENT_HPP
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/IO/IOException.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Queries/Evaluator.hpp"
+#include "Beam/Queries/FilteredQuery.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Queries/Range.hpp"
+#include "Beam/Queries/SequencedValue.hpp"
+#include "Beam/Queries/SnapshotLimit.hpp"
+#include "Beam/Serialization/BinaryReceiver.hpp"
+#include "Beam/Serialization/BinarySender.hpp"
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace Beam::Queries {
+
+  /**
+   * An immutable file of SequencedValues sorted by Sequence that is memory
+   * mapped for reading.
+   * Values are serialized using a BinarySender in blocks of INDEX_INTERVAL
+   * values. A sparse index of each block's first Sequence, timestamp and
+   * offset is written after the values followed by a fixed size footer, so
+   * that a range is located by binary searching the index and only the blocks
+   * overlapping it are deserialized.
+   * @param <V> The type of value stored.
+   */
+  template<typename V>
+  class DataSegment : private boost::noncopyable {
+    public:
+
+      /** The type of value stored. */
+      using Value = V;
+
+      /** The SequencedValue stored. */
+      using SequencedValue = ::Beam::Queries::SequencedValue<Value>;
+
+      /** The number of values in each block of the sparse index. */
+      static constexpr auto INDEX_INTERVAL = std::size_t(64);
+
+      /**
+       * Writes a DataSegment file, the file is first written under a
+       * temporary name, synced to disk and then renamed so that a partially
+       * written segment is never opened.
+       * @param path The path of the file to write.
+       * @param begin An iterator to the first value to write.
+       * @param end An iterator to one past the last value to write.
+       */
+      template<typename ForwardIterator>
+      static void Write(const std::filesystem::path& path,
+        ForwardIterator begin, ForwardIterator end);
+
+      /**
+       * Opens a DataSegment.
+       * @param path The path to the segment's file.
+       */
+      explicit DataSegment(std::filesystem::path path);
+
+      ~DataSegment();
+
+      /** Returns the path to the segment's file. */
+      const std::filesystem::path& GetPath() const;
+
+      /** Returns the number of values stored. */
+      std::size_t GetSize() const;
+
+      /** Returns the size of the segment's file. */
+      std::size_t GetFileSize() const;
+
+      /** Returns the Sequence of the first value stored. */
+      Sequence GetFirstSequence() const;
+
+      /** Returns the Sequence of the last value stored. */
+      Sequence GetLastSequence() const;
+
+      /** Returns all values stored. */
+      std::vector<SequencedValue> LoadAll() const;
+
+      /**
+       * Loads the values within a Range.
+       * @param range The Range of values to load.
+       * @param filter The filter to apply to each value.
+       * @param limit The SnapshotLimit to apply.
+       * @return The values satisfying the <i>range</i>, <i>filter</i> and
+       *         <i>limit</i> in order of their Sequence.
+       */
+      std::vector<SequencedValue> Load(const Range& range, Evaluator& filter,
+        const SnapshotLimit& limit) const;
+
+      /**
+       * Marks the segment as obsolete, deleting its file once it is no
+       * longer in use.
+       */
+      void MarkObsolete();
+
+    private:
+      struct IndexEntry {
+        std::uint64_t m_sequence;
+        std::int64_t m_timestamp;
+        std::uint64_t m_offset;
+      };
+      struct Footer {
+        std::uint64_t m_indexOffset;
+        std::uint64_t m_indexCount;
+        std::uint64_t m_count;
+        std::uint64_t m_firstSequence;
+        std::uint64_t m_lastSequence;
+        std::uint32_t m_isTimeOrdered;
+        std::uint32_t m_magic;
+      };
+      static constexpr auto MAGIC = std::uint32_t(0x5345474D);
+      std::filesystem::path m_path;
+      boost::interprocess::file_mapping m_file;
+      boost::interprocess::mapped_region m_region;
+      Footer m_footer;
+      std::vector<IndexEntry> m_index;
+      bool m_isObsolete;
+
+      static void Sync(const std::filesystem::path& path);
+      static std::int64_t ToTimestamp(const boost::posix_time::ptime& time);
+      std::size_t LowerBlock(const Range::Point& point) const;
+      std::size_t UpperBlock(const Range::Point& point) const;
+      void LoadBlock(std::size_t block,
+        std::vector<SequencedValue>& values) const;
+  };
+
+  template<typename V>
+  template<typename ForwardIterator>
+  void DataSegment<V>::Write(const std::filesystem::path& path,
+      ForwardIterator begin, ForwardIterator end) {
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    auto buffer = IO::SharedBuffer();
+    auto sender = Serialization::BinarySender<IO::SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    auto index = std::vector<IndexEntry>();
+    auto footer = Footer();
+    std::memset(&footer, 0, sizeof(footer));
+    footer.m_isTimeOrdered = 1;
+    auto lastTimestamp = std::int64_t(0);
+    for(auto i = begin; i != end; ++i) {
+      auto timestamp = ToTimestamp(GetTimestamp(*i));
+      if(footer.m_count == 0) {
+        footer.m_firstSequence = i->GetSequence().GetOrdinal();
+      } else if(timestamp < lastTimestamp) {
+        footer.m_isTimeOrdered = 0;
+      }
+      if(footer.m_count % INDEX_INTERVAL == 0) {
+        index.push_back(IndexEntry{i->GetSequence().GetOrdinal(), timestamp,
+          buffer.GetSize()});
+      }
+      sender.Shuttle(*i);
+      footer.m_lastSequence = i->GetSequence().GetOrdinal();
+      lastTimestamp = timestamp;
+      ++footer.m_count;
+    }
+    footer.m_indexOffset = buffer.GetSize();
+    footer.m_indexCount = index.size();
+    footer.m_magic = MAGIC;
+    {
+      auto file = std::ofstream(temporaryPath,
+        std::ios::binary | std::ios::trunc);
+      file.write(buffer.GetData(), buffer.GetSize());
+      file.write(reinterpret_cast<const char*>(index.data()),
+        index.size() * sizeof(IndexEntry));
+      file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+      file.flush();
+      if(!file) {
+        BOOST_THROW_EXCEPTION(IO::IOException("Unable to write segment."));
+      }
+    }
+    Sync(temporaryPath);
+    std::filesystem::rename(temporaryPath, path);
+#ifndef _WIN32
+    if(path.has_parent_path()) {
+      Sync(path.parent_path());
+    } else {
+      Sync(".");
+    }
+#endif
+  }
+
+  template<typename V>
+  DataSegment<V>::DataSegment(std::filesystem::path path)
+      : m_path(std::move(path)),
+        m_isObsolete(false) {
+    auto size = std::filesystem::file_size(m_path);
+    if(size < sizeof(Footer)) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Invalid segment."));
+    }
+    m_file = boost::interprocess::file_mapping(m_path.string().c_str(),
+      boost::interprocess::read_only);
+    m_region = boost::interprocess::mapped_region(m_file,
+      boost::interprocess::read_only);
+    auto data = static_cast<const char*>(m_region.get_address());
+    std::memcpy(&m_footer, data + size - sizeof(Footer), sizeof(Footer));
+    if(m_footer.m_magic != MAGIC || m_footer.m_indexOffset +
+        m_footer.m_indexCount * sizeof(IndexEntry) + sizeof(Footer) != size) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Invalid segment."));
+    }
+
+    // The index is copied out since its offset within the file is not
+    // aligned for an IndexEntry.
+    m_index.resize(static_cast<std::size_t>(m_footer.m_indexCount));
+    std::memcpy(m_index.data(), data + m_footer.m_indexOffset,
+      m_index.size() * sizeof(IndexEntry));
+  }
+
+  template<typename V>
+  DataSegment<V>::~DataSegment() {
+    if(m_isObsolete) {
+      m_region = boost::interprocess::mapped_region();
+      m_file = boost::interprocess::file_mapping();
+      auto error = std::error_code();
+      std::filesystem::remove(m_path, error);
+    }
+  }
+
+  template<typename V>
+  const std::filesystem::path& DataSegment<V>::GetPath() const {
+    return m_path;
+  }
+
+  template<typename V>
+  std::size_t DataSegment<V>::GetSize() const {
+    return static_cast<std::size_t>(m_footer.m_count);
+  }
+
+  template<typename V>
+  std::size_t DataSegment<V>::GetFileSize() const {
+    return m_region.get_size();
+  }
+
+  template<typename V>
+  Sequence DataSegment<V>::GetFirstSequence() const {
+    return Sequence(m_footer.m_firstSequence);
+  }
+
+  template<typename V>
+  Sequence DataSegment<V>::GetLastSequence() const {
+    return Sequence(m_footer.m_lastSequence);
+  }
+
+  template<typename V>
+  std::vector<typename DataSegment<V>::SequencedValue>
+      DataSegment<V>::LoadAll() const {
+    auto values = std::vector<SequencedValue>();
+    values.reserve(GetSize());
+    for(auto i = std::size_t(0); i != m_footer.m_indexCount; ++i) {
+      LoadBlock(i, values);
+    }
+    return values;
+  }
+
+  template<typename V>
+  std::vector<typename DataSegment<V>::SequencedValue> DataSegment<V>::Load(
+      const Range& range, Evaluator& filter, const SnapshotLimit& limit) const {
+    auto matches = std::vector<SequencedValue>();
+    if(limit.GetSize() == 0 || m_footer.m_indexCount == 0) {
+      return matches;
+    }
+    auto firstBlock = LowerBlock(range.GetStart());
+    auto lastBlock = UpperBlock(range.GetEnd());
+    if(firstBlock >= lastBlock) {
+      return matches;
+    }
+    auto size = static_cast<std::size_t>(limit.GetSize());
+    auto block = std::vector<SequencedValue>();
+    auto test = [&] (const SequencedValue& value) {
+      return RangePointGreaterOrEqual(value, range.GetStart()) &&
+        RangePointLesserOrEqual(value, range.GetEnd()) &&
+        TestFilter(filter, *value);
+    };
+    if(limit.GetType() == SnapshotLimit::Type::HEAD) {
+      for(auto i = firstBlock; i != lastBlock && matches.size() < size; ++i) {
+        block.clear();
+        LoadBlock(i, block);
+        for(auto& value : block) {
+          if(test(value)) {
+            matches.push_back(std::move(value));
+            if(matches.size() >= size) {
+              break;
+            }
+          }
+        }
+      }
+    } else {
+      for(auto i = lastBlock; i != firstBlock && matches.size() < size; --i) {
+        block.clear();
+        LoadBlock(i - 1, block);
+        for(auto j = block.rbegin(); j != block.rend(); ++j) {
+          if(test(*j)) {
+            matches.push_back(std::move(*j));
+            if(matches.size() >= size) {
+              break;
+            }
+          }
+        }
+      }
+      std::reverse(matches.begin(), matches.end());
+    }
+    return matches;
+  }
+
+  template<typename V>
+  void DataSegment<V>::MarkObsolete() {
+    m_isObsolete = true;
+  }
+
+  template<typename V>
+  void DataSegment<V>::Sync(const std::filesystem::path& path) {
+#ifdef _WIN32
+    auto handle = ::CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(handle == INVALID_HANDLE_VALUE) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Unable to sync segment."));
+    }
+    auto result = ::FlushFileBuffers(handle);
+    ::CloseHandle(handle);
+    if(!result) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Unable to sync segment."));
+    }
+#else
+    auto descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(descriptor == -1) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Unable to sync segment."));
+    }
+    auto result = ::fsync(descriptor);
+    ::close(descriptor);
+    if(result == -1) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Unable to sync segment."));
+    }
+#endif
+  }
+
+  template<typename V>
+  std::int64_t DataSegment<V>::ToTimestamp(
+      const boost::posix_time::ptime& time) {
+    if(time.is_special()) {
+      return 0;
+    }
+    static const auto EPOCH = boost::posix_time::ptime(
+      boost::gregorian::date(1970, 1, 1));
+    return (time - EPOCH).total_microseconds();
+  }
+
+  template<typename V>
+  std::size_t DataSegment<V>::LowerBlock(const Range::Point& point) const {
+    auto entry = [&] {
+      if(auto sequence = boost::get<Sequence>(&point)) {
+        return std::lower_bound(m_index.begin(), m_index.end(),
+          sequence->GetOrdinal(),
+          [] (const IndexEntry& entry, std::uint64_t sequence) {
+            return entry.m_sequence < sequence;
+          });
+      } else if(m_footer.m_isTimeOrdered == 0) {
+        return m_index.begin();
+      }
+      auto& timestamp = boost::get<boost::posix_time::ptime>(point);
+      return std::lower_bound(m_index.begin(), m_index.end(),
+        ToTimestamp(timestamp),
+        [] (const IndexEntry& entry, std::int64_t timestamp) {
+          return entry.m_timestamp < timestamp;
+        });
+    }();
+    if(entry == m_index.begin()) {
+      return 0;
+    }
+    return static_cast<std::size_t>(
+      std::distance(m_index.begin(), entry) - 1);
+  }
+
+  template<typename V>
+  std::size_t DataSegment<V>::UpperBlock(const Range::Point& point) const {
+    auto entry = [&] {
+      if(auto sequence = boost::get<Sequence>(&point)) {
+        return std::upper_bound(m_index.begin(), m_index.end(),
+          sequence->GetOrdinal(),
+          [] (std::uint64_t sequence, const IndexEntry& entry) {
+            return sequence < entry.m_sequence;
+          });
+      } else if(m_footer.m_isTimeOrdered == 0) {
+        return m_index.end();
+      }
+      auto& timestamp = boost::get<boost::posix_time::ptime>(point);
+      return std::upper_bound(m_index.begin(), m_index.end(),
+        ToTimestamp(timestamp),
+        [] (std::int64_t timestamp, const IndexEntry& entry) {
+          return timestamp < entry.m_timestamp;
+        });
+    }();
+    return static_cast<std::size_t>(std::distance(m_index.begin(), entry));
+  }
+
+  template<typename V>
+  void DataSegment<V>::LoadBlock(std::size_t block,
+      std::vector<SequencedValue>& values) const {
+    auto data = static_cast<const char*>(m_region.get_address());
+    auto begin = m_index[block].m_offset;
+    auto end = [&] {
+      if(block + 1 == m_footer.m_indexCount) {
+        return m_footer.m_indexOffset;
+      }
+      return m_index[block + 1].m_offset;
+    }();
+    auto count = std::min<std::size_t>(INDEX_INTERVAL,
+      GetSize() - block * INDEX_INTERVAL);
+    auto buffer = IO::SharedBuffer(data + begin, end - begin);
+    auto receiver = Serialization::BinaryReceiver<IO::SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    for(auto i = std::size_t(0); i != count; ++i) {
+      auto value = SequencedValue();
+      receiver.Shuttle(value);
+      values.push_back(std::move(value));
+    }
+  }
+}
+
+#endif
@@ -25,6 +25,8 @@
 #include "Beam/Queries/StandardDataTypes.hpp"
 #include "Beam/Queries/StandardFunctionExpressions.hpp"
 #include "Beam/Queries/VariableExpression.hpp"
+#include "Beam/Queries/WindowedReduceEvaluatorNode.hpp"
+#include "Beam/Queries/WindowedReduceExpression.hpp"
 #include "Beam/Queries/WriteEvaluatorNode.hpp"
 #include "Beam/Utilities/InstantiateTemplate.hpp"
 
@@ -83,6 +85,8 @@ namespace Queries {
 
       virtual void Visit(const VariableExpression& expression);
 
+      virtual void Visit(const WindowedReduceExpression& expression);
+
       virtual void Visit(const VirtualExpression& expression);
 
     protected:
@@ -325,6 +329,41 @@ namespace Queries {
     SetEvaluator(std::move(evaluator));
   }
 
+  template<typename QueryTypes>
+  void EvaluatorTranslator<QueryTypes>::Visit(
+      const WindowedReduceExpression& expression) {
+    const auto& seriesExpression = expression.GetSeriesExpression();
+    seriesExpression->Apply(*this);
+    auto series = std::move(GetEvaluator());
+    auto timestamp = std::unique_ptr<BaseEvaluatorNode>();
+    if(expression.GetPeriod() != boost::posix_time::pos_infin) {
+      expression.GetTimestampExpression()->Apply(*this);
+      timestamp = std::move(GetEvaluator());
+    }
+    const auto& type = seriesExpression->GetType()->GetNativeType();
+    auto operation = expression.GetOperation();
+    if(operation == WindowedReduceExpression::Operation::SUM) {
+      m_evaluator.reset(Instantiate<WindowedReduceEvaluatorNodeTranslator<
+        WindowSumTypes, WindowSum>>(type)(std::move(series),
+        std::move(timestamp), expression.GetSize(), expression.GetPeriod()));
+    } else if(operation == WindowedReduceExpression::Operation::COUNT) {
+      m_evaluator.reset(Instantiate<WindowedReduceEvaluatorNodeTranslator<
+        NativeTypes, WindowCount>>(type)(std::move(series),
+        std::move(timestamp), expression.GetSize(), expression.GetPeriod()));
+    } else if(operation == WindowedReduceExpression::Operation::MIN) {
+      m_evaluator.reset(Instantiate<WindowedReduceEvaluatorNodeTranslator<
+        ComparableTypes, WindowMin>>(type)(std::move(series),
+        std::move(timestamp), expression.GetSize(), expression.GetPeriod()));
+    } else if(operation == WindowedReduceExpression::Operation::MAX) {
+      m_evaluator.reset(Instantiate<WindowedReduceEvaluatorNodeTranslator<
+        ComparableTypes, WindowMax>>(type)(std::move(series),
+        std::move(timestamp), expression.GetSize(), expression.GetPeriod()));
+    } else {
+      BOOST_THROW_EXCEPTION(ExpressionTranslationException(
+        "Operation not supported."));
+    }
+  }
+
   template<typename QueryTypes>
   void EvaluatorTranslator<QueryTypes>::Visit(
       const VirtualExpression& expression) {
@@ -37,6 +37,9 @@ namespace Beam::Queries {
       //! Visits a VariableExpression.
       virtual void Visit(const VariableExpression& expression);
 
+      //! Visits a WindowedReduceExpression.
+      virtual void Visit(const WindowedReduceExpression& expression);
+
       //! Visits the base class VirtualExpression.
       virtual void Visit(const VirtualExpression& expression);
   };
@@ -0,0 +1,149 @@
+#ifndef BEAM_INDEXEDSEQUENCER_HPP
+#define BEAM_INDEXEDSEQUENCER_HPP
+#include <array>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Beam/Queries/AtomicSequencer.hpp"
+#include "Beam/Queries/IndexedValue.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Queries/Sequence.hpp"
+#include "Beam/Queries/SequencedValue.hpp"
+
+namespace Beam {
+namespace Queries {
+
+  /*! \class IndexedSequencer
+      \brief Sequences values across many indexes concurrently, keeping an
+             independent AtomicSequencer for each index.
+      \details Indexes are spread over lock striped shards so that looking up
+               an index only contends with indexes in the same shard, once
+               found Sequences are allocated without any lock.
+      \tparam I The type of index to sequence.
+   */
+  template<typename I>
+  class IndexedSequencer : private boost::noncopyable {
+    public:
+
+      //! The type of index to sequence.
+      using Index = I;
+
+      //! The type of function used to load the initial Sequence of an index.
+      using InitialSequenceLoader = std::function<Sequence (const Index&)>;
+
+      //! Constructs an IndexedSequencer starting every index at the first
+      //! Sequence.
+      IndexedSequencer();
+
+      //! Constructs an IndexedSequencer.
+      /*!
+        \param initialSequenceLoader Loads the Sequence to use on the first
+               value of an index, invoked at most once per index.
+      */
+      explicit IndexedSequencer(InitialSequenceLoader initialSequenceLoader);
+
+      //! Returns the AtomicSequencer for an index, the returned reference
+      //! remains valid for the lifetime of this object.
+      /*!
+        \param index The index whose AtomicSequencer is to be returned.
+        \return The AtomicSequencer used to sequence the <i>index</i>.
+      */
+      AtomicSequencer& Get(const Index& index);
+
+      //! Makes a SequencedValue encoding the value's timestamp into the
+      //! Sequence.
+      /*!
+        \param value The SequencedValue's value.
+        \param index The SequencedValue's index.
+        \return A SequencedValue representing the <i>value</i> and <i>index</i>
+                with a Sequence encoding the <i>value</i>'s timestamp.
+      */
+      template<typename Value>
+      SequencedValue<IndexedValue<Value, Index>> MakeSequencedValue(
+        Value value, Index index);
+
+      //! Returns the next Sequence to use for an index.
+      /*!
+        \param index The index to sequence.
+        \param timestamp The timestamp to translate into a Sequence.
+        \return The next Sequence to use for the specified <i>timestamp</i>.
+      */
+      Sequence IncrementNextSequence(const Index& index,
+        const boost::posix_time::ptime& timestamp);
+
+      //! Reserves a contiguous block of Sequences for an index.
+      /*!
+        \param index The index to sequence.
+        \param timestamp The timestamp to translate into a Sequence.
+        \param count The number of Sequences to reserve, std::invalid_argument
+               is thrown if it isn't positive.
+        \return The first Sequence in the reserved block.
+      */
+      Sequence IncrementNextSequence(const Index& index,
+        const boost::posix_time::ptime& timestamp, int count);
+
+    private:
+      struct Shard {
+        boost::mutex m_mutex;
+        std::unordered_map<Index, std::unique_ptr<AtomicSequencer>>
+          m_sequencers;
+      };
+      static constexpr auto SHARD_COUNT = std::size_t(64);
+      InitialSequenceLoader m_initialSequenceLoader;
+      std::array<Shard, SHARD_COUNT> m_shards;
+  };
+
+  template<typename I>
+  IndexedSequencer<I>::IndexedSequencer()
+    : IndexedSequencer([] (const Index&) {
+        return Sequence::First();
+      }) {}
+
+  template<typename I>
+  IndexedSequencer<I>::IndexedSequencer(
+    InitialSequenceLoader initialSequenceLoader)
+    : m_initialSequenceLoader(std::move(initialSequenceLoader)) {}
+
+  template<typename I>
+  AtomicSequencer& IndexedSequencer<I>::Get(const Index& index) {
+    auto& shard = m_shards[boost::hash<Index>()(index) % SHARD_COUNT];
+    boost::lock_guard<boost::mutex> lock(shard.m_mutex);
+    auto& sequencer = shard.m_sequencers[index];
+    if(sequencer == nullptr) {
+      sequencer = std::make_unique<AtomicSequencer>(
+        m_initialSequenceLoader(index));
+    }
+    return *sequencer;
+  }
+
+  template<typename I>
+  template<typename Value>
+  SequencedValue<IndexedValue<Value, typename IndexedSequencer<I>::Index>>
+      IndexedSequencer<I>::MakeSequencedValue(Value value, Index index) {
+    return Get(index).MakeSequencedValue(std::move(value), std::move(index));
+  }
+
+  template<typename I>
+  Sequence IndexedSequencer<I>::IncrementNextSequence(const Index& index,
+      const boost::posix_time::ptime& timestamp) {
+    return Get(index).IncrementNextSequence(timestamp);
+  }
+
+  template<typename I>
+  Sequence IndexedSequencer<I>::IncrementNextSequence(const Index& index,
+      const boost::posix_time::ptime& timestamp, int count) {
+    if(count <= 0) {
+      BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid count."));
+    }
+    return Get(index).IncrementNextSequence(timestamp, count);
+  }
+}
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 namespace Beam::Queries {
   template<typename D, typename E> class AsyncDataStore;
+  class AtomicSequencer;
   class BaseEvaluatorNode;
   class BaseParameterEvaluatorNode;
   template<typename T> class BasicQuery;
@@ -34,6 +35,7 @@ namespace Beam::Queries {
     typename ServiceProtocolClientType> class IndexedSubscriptions;
   template<typename ValueType, typename IndexType> class IndexedValue;
   template<typename T> class IndexedQuery;
+  template<typename I> class IndexedSequencer;
   class IndexListQuery;
   class InterruptableQuery;
   enum class InterruptionPolicy;
@@ -84,6 +86,11 @@ namespace Beam::Queries {
   typedef ClonePtr<VirtualExpression> Expression;
   class VirtualValue;
   typedef ClonePtr<VirtualValue> Value;
+  template<typename T, typename C> class WindowExtremum;
+  template<typename T> class WindowCount;
+  template<typename A> class WindowedReduceEvaluatorNode;
+  class WindowedReduceExpression;
+  template<typename T> class WindowSum;
   template<typename t> class WriteEvaluatorNode;
 }
 
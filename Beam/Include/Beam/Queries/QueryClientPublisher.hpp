@@ -1,24 +1,29 @@
 #ifndef BEAM_QUERYCLIENTPUBLISHER_HPP
 #define BEAM_QUERYCLIENTPUBLISHER_HPP
 #include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include "Beam/Pointers/Ref.hpp"
 #include "Beam/Queries/Evaluator.hpp"
 #include "Beam/Queries/IndexedValue.hpp"
+#include "Beam/Queries/InterruptionPolicy.hpp"
 #include "Beam/Queries/Queries.hpp"
 #include "Beam/Queries/SequencedValue.hpp"
 #include "Beam/Queries/SequencedValuePublisher.hpp"
 #include "Beam/Queues/ConverterWriterQueue.hpp"
 #include "Beam/Queues/QueueWriter.hpp"
 #include "Beam/Queues/WeakQueue.hpp"
+#include "Beam/Routines/Async.hpp"
 #include "Beam/Routines/RoutineHandlerGroup.hpp"
 #include "Beam/Services/RecordMessage.hpp"
 #include "Beam/Services/ServiceProtocolClient.hpp"
 #include "Beam/Services/ServiceProtocolClientHandler.hpp"
+#include "Beam/Utilities/Algorithm.hpp"
 #include "Beam/Utilities/Convert.hpp"
 #include "Beam/Utilities/SynchronizedList.hpp"
 #include "Beam/Utilities/SynchronizedMap.hpp"
@@ -28,6 +33,12 @@ namespace Queries {
 
   /*! \class QueryClientPublisher
       \brief Used by clients to submit and update queries.
+      \details Real-time queries on the same index with the same filter and
+               InterruptionPolicy share a single query on the server, whose
+               values are fanned out locally and which is only ended once its
+               last local subscriber is gone. Filters are compared by their
+               serialized form so that filters differing only in a type or in
+               a constant's precision are never shared.
       \tparam ValueType The type of value being queried.
       \tparam QueryType The type of query to submit.
       \tparam EvaluatorTranslatorType The type of EvaluatorTranslator used.
@@ -113,13 +124,49 @@ namespace Queries {
 
     private:
       using Publisher = SequencedValuePublisher<Query, Value>;
-      using PublisherList = SynchronizedVector<std::shared_ptr<Publisher>>;
-      using Publishers = std::unordered_map<Index, PublisherList>;
+      struct Subscription : private boost::noncopyable {
+        std::string m_filter;
+        InterruptionPolicy m_interruptionPolicy;
+        int m_queryId;
+        std::vector<std::shared_ptr<Publisher>> m_publishers;
+        Routines::Async<int> m_openResult;
+
+        Subscription(std::string filter,
+          InterruptionPolicy interruptionPolicy);
+      };
+      using SubscriptionList =
+        SynchronizedVector<std::shared_ptr<Subscription>>;
+      using Subscriptions = std::unordered_map<Index, SubscriptionList>;
       ServiceProtocolClientHandler* m_clientHandler;
-      SynchronizedMap<Publishers> m_publishers;
+      SynchronizedMap<Subscriptions> m_subscriptions;
       Routines::RoutineHandlerGroup m_queryRoutines;
+
+      void OpenSubscription(const Query& query,
+        SubscriptionList& subscriptions,
+        const std::shared_ptr<Subscription>& subscription,
+        const std::shared_ptr<Publisher>& publisher, Routines::Eval<int> eval);
+      void JoinSubscription(const Query& query,
+        SubscriptionList& subscriptions,
+        const std::shared_ptr<Subscription>& subscription,
+        const std::shared_ptr<Publisher>& publisher);
+      static void RemovePublisher(SubscriptionList& subscriptions,
+        Subscription& subscription,
+        const std::shared_ptr<Publisher>& publisher);
+      std::string MakeFilterKey(const Expression& filter);
+      static Query MakeSnapshotQuery(Query query);
   };
 
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
+      ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
+      Subscription::Subscription(std::string filter,
+      InterruptionPolicy interruptionPolicy)
+      : m_filter(std::move(filter)),
+        m_interruptionPolicy(interruptionPolicy),
+        m_queryId(-1) {}
+
   template<typename ValueType, typename QueryType,
     typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
     typename QueryServiceType, typename EndQueryMessageType>
@@ -141,19 +188,32 @@ namespace Queries {
           auto filter = Translate<EvaluatorTranslator>(query.GetFilter());
           auto publisher = std::make_shared<Publisher>(query, std::move(filter),
             queue);
-          auto& publisherList = m_publishers.Get(query.GetIndex());
-          try {
-            publisher->BeginSnapshot();
-            publisherList.PushBack(publisher);
-            auto client = m_clientHandler->GetClient();
-            auto queryResult = client->template SendRequest<QueryService>(
-              query);
-            publisher->PushSnapshot(queryResult.m_snapshot.begin(),
-              queryResult.m_snapshot.end());
-            publisher->EndSnapshot(queryResult.m_queryId);
-          } catch(const std::exception&) {
-            publisher->Break();
-            publisherList.Remove(publisher);
+          publisher->BeginSnapshot();
+          auto filterKey = MakeFilterKey(query.GetFilter());
+          auto& subscriptions = m_subscriptions.Get(query.GetIndex());
+          auto openEval = Routines::Eval<int>();
+          auto subscription = subscriptions.With(
+            [&] (std::vector<std::shared_ptr<Subscription>>& subscriptions) {
+              for(auto& subscription : subscriptions) {
+                if(subscription->m_filter == filterKey &&
+                    subscription->m_interruptionPolicy ==
+                    query.GetInterruptionPolicy()) {
+                  subscription->m_publishers.push_back(publisher);
+                  return subscription;
+                }
+              }
+              auto subscription = std::make_shared<Subscription>(
+                std::move(filterKey), query.GetInterruptionPolicy());
+              openEval = subscription->m_openResult.GetEval();
+              subscription->m_publishers.push_back(publisher);
+              subscriptions.push_back(subscription);
+              return subscription;
+            });
+          if(openEval.IsEmpty()) {
+            JoinSubscription(query, subscriptions, subscription, publisher);
+          } else {
+            OpenSubscription(query, subscriptions, subscription, publisher,
+              std::move(openEval));
           }
         });
     } else {
@@ -192,25 +252,34 @@ namespace Queries {
   void QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
       ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
       Publish(const SequencedValue<IndexedValue<Value, Index>>& value) {
-    auto& publishers = m_publishers.Get(value->GetIndex());
+    auto& subscriptions = m_subscriptions.Get(value->GetIndex());
     auto client = m_clientHandler->GetClient();
-    publishers.With(
-      [&] (std::vector<std::shared_ptr<Publisher>>& publishers) {
-        auto i = publishers.begin();
-        while(i != publishers.end()) {
-          const auto& publisher = *i;
-          try {
-            publisher->Push(value);
-            ++i;
-          } catch(const std::exception&) {
-            if(publisher->GetId() != -1) {
-              Services::SendRecordMessage<EndQueryMessage>(*client,
-                value->GetIndex(), publisher->GetId());
-              i = publishers.erase(i);
-            } else {
-              ++i;
+    subscriptions.With(
+      [&] (std::vector<std::shared_ptr<Subscription>>& subscriptions) {
+        auto i = subscriptions.begin();
+        while(i != subscriptions.end()) {
+          auto& publishers = (*i)->m_publishers;
+          auto j = publishers.begin();
+          while(j != publishers.end()) {
+            const auto& publisher = *j;
+            try {
+              publisher->Push(value);
+              ++j;
+            } catch(const std::exception&) {
+              if(publisher->GetId() != -1) {
+                j = publishers.erase(j);
+              } else {
+                ++j;
+              }
             }
           }
+          if(publishers.empty() && (*i)->m_queryId != -1) {
+            Services::SendRecordMessage<EndQueryMessage>(*client,
+              value->GetIndex(), (*i)->m_queryId);
+            i = subscriptions.erase(i);
+          } else {
+            ++i;
+          }
         }
       });
   }
@@ -221,32 +290,64 @@ namespace Queries {
   void QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
       ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
       Recover(ServiceProtocolClient& client) {
-    std::vector<std::tuple<PublisherList*, std::shared_ptr<Publisher>>>
-      disconnectedPublishers;
-    m_publishers.With(
-      [&] (Publishers& publishers) {
-        for(auto& publisherList : publishers | boost::adaptors::map_values) {
-          publisherList.ForEach(
-            [&] (const std::shared_ptr<Publisher>& publisher) {
-              if(publisher->GetId() != -1) {
-                disconnectedPublishers.push_back(
-                  std::make_tuple(&publisherList, publisher));
+    std::vector<std::tuple<SubscriptionList*, std::shared_ptr<Subscription>>>
+      disconnectedSubscriptions;
+    m_subscriptions.With(
+      [&] (Subscriptions& subscriptions) {
+        for(auto& subscriptionList :
+            subscriptions | boost::adaptors::map_values) {
+          subscriptionList.ForEach(
+            [&] (const std::shared_ptr<Subscription>& subscription) {
+              if(subscription->m_queryId != -1) {
+                disconnectedSubscriptions.push_back(
+                  std::make_tuple(&subscriptionList, subscription));
               }
             });
         }
       });
-    for(const auto& publisherEntry : disconnectedPublishers) {
-      auto& publisherList = *std::get<0>(publisherEntry);
-      auto& publisher = std::get<1>(publisherEntry);
-      try {
-        auto query = publisher->BeginRecovery();
-        auto queryResult = client.template SendRequest<QueryService>(query);
-        publisher->PushSnapshot(queryResult.m_snapshot.begin(),
-          queryResult.m_snapshot.end());
-        publisher->EndRecovery(queryResult.m_queryId);
-      } catch(const std::exception&) {
+    for(const auto& subscriptionEntry : disconnectedSubscriptions) {
+      auto& subscriptionList = *std::get<0>(subscriptionEntry);
+      auto& subscription = std::get<1>(subscriptionEntry);
+      auto publishers = subscriptionList.With(
+        [&] (std::vector<std::shared_ptr<Subscription>>&) {
+          return subscription->m_publishers;
+        });
+      auto queryId = -1;
+      for(const auto& publisher : publishers) {
+        if(publisher->GetId() == -1) {
+          continue;
+        }
+        try {
+          auto query = publisher->BeginRecovery();
+          if(queryId == -1) {
+            auto queryResult = client.template SendRequest<QueryService>(
+              query);
+            queryId = queryResult.m_queryId;
+            publisher->PushSnapshot(queryResult.m_snapshot.begin(),
+              queryResult.m_snapshot.end());
+          } else if(query.GetRange().GetStart() != Sequence::Present()) {
+            auto queryResult = client.template SendRequest<QueryService>(
+              MakeSnapshotQuery(std::move(query)));
+            publisher->PushSnapshot(queryResult.m_snapshot.begin(),
+              queryResult.m_snapshot.end());
+          }
+          publisher->EndRecovery(queryId);
+        } catch(const std::exception&) {
+          publisher->Break();
+          RemovePublisher(subscriptionList, *subscription, publisher);
+        }
+      }
+      auto remainingPublishers = subscriptionList.With(
+        [&] (std::vector<std::shared_ptr<Subscription>>& subscriptions) {
+          subscription->m_queryId = queryId;
+          if(queryId != -1) {
+            return std::vector<std::shared_ptr<Publisher>>();
+          }
+          RemoveAll(subscriptions, subscription);
+          return std::move(subscription->m_publishers);
+        });
+      for(const auto& publisher : remainingPublishers) {
         publisher->Break();
-        publisherList.Remove(publisher);
       }
     }
   }
@@ -264,6 +365,115 @@ namespace Queries {
         Publish(value);
       });
   }
+
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  void QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
+      ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
+      OpenSubscription(const Query& query, SubscriptionList& subscriptions,
+      const std::shared_ptr<Subscription>& subscription,
+      const std::shared_ptr<Publisher>& publisher, Routines::Eval<int> eval) {
+    auto queryResult = [&] {
+      try {
+        auto client = m_clientHandler->GetClient();
+        return boost::optional<typename QueryService::Return>(
+          client->template SendRequest<QueryService>(query));
+      } catch(const std::exception&) {
+        eval.SetException(std::current_exception());
+        return boost::optional<typename QueryService::Return>();
+      }
+    }();
+    if(!queryResult.is_initialized()) {
+      auto publishers = subscriptions.With(
+        [&] (std::vector<std::shared_ptr<Subscription>>& subscriptions) {
+          RemoveAll(subscriptions, subscription);
+          return std::move(subscription->m_publishers);
+        });
+      for(const auto& publisher : publishers) {
+        publisher->Break();
+      }
+      return;
+    }
+    subscriptions.With(
+      [&] (std::vector<std::shared_ptr<Subscription>>&) {
+        subscription->m_queryId = queryResult->m_queryId;
+      });
+    eval.SetResult(queryResult->m_queryId);
+    try {
+      publisher->PushSnapshot(queryResult->m_snapshot.begin(),
+        queryResult->m_snapshot.end());
+      publisher->EndSnapshot(queryResult->m_queryId);
+    } catch(const std::exception&) {
+      publisher->Break();
+      RemovePublisher(subscriptions, *subscription, publisher);
+    }
+  }
+
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  void QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
+      ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
+      JoinSubscription(const Query& query, SubscriptionList& subscriptions,
+      const std::shared_ptr<Subscription>& subscription,
+      const std::shared_ptr<Publisher>& publisher) {
+    try {
+      auto queryId = subscription->m_openResult.Get();
+      if(query.GetRange().GetStart() != Sequence::Present()) {
+        auto client = m_clientHandler->GetClient();
+        auto queryResult = client->template SendRequest<QueryService>(
+          MakeSnapshotQuery(query));
+        publisher->PushSnapshot(queryResult.m_snapshot.begin(),
+          queryResult.m_snapshot.end());
+      }
+      publisher->EndSnapshot(queryId);
+    } catch(const std::exception&) {
+      publisher->Break();
+      RemovePublisher(subscriptions, *subscription, publisher);
+    }
+  }
+
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  void QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
+      ServiceProtocolClientHandlerType, QueryServiceType, EndQueryMessageType>::
+      RemovePublisher(SubscriptionList& subscriptions,
+      Subscription& subscription, const std::shared_ptr<Publisher>& publisher) {
+    subscriptions.With(
+      [&] (std::vector<std::shared_ptr<Subscription>>&) {
+        RemoveAll(subscription.m_publishers, publisher);
+      });
+  }
+
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  std::string QueryClientPublisher<ValueType, QueryType,
+      EvaluatorTranslatorType, ServiceProtocolClientHandlerType,
+      QueryServiceType, EndQueryMessageType>::MakeFilterKey(
+      const Expression& filter) {
+    using Sender = typename ServiceProtocolClientHandler::Client::
+      MessageProtocol::Sender;
+    auto buffer = typename Sender::Sink();
+    auto sender = Sender(Ref(m_clientHandler->GetSlots().GetRegistry()));
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(filter);
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  template<typename ValueType, typename QueryType,
+    typename EvaluatorTranslatorType, typename ServiceProtocolClientHandlerType,
+    typename QueryServiceType, typename EndQueryMessageType>
+  typename QueryClientPublisher<ValueType, QueryType, EvaluatorTranslatorType,
+      ServiceProtocolClientHandlerType, QueryServiceType,
+      EndQueryMessageType>::Query QueryClientPublisher<ValueType, QueryType,
+      EvaluatorTranslatorType, ServiceProtocolClientHandlerType,
+      QueryServiceType, EndQueryMessageType>::MakeSnapshotQuery(Query query) {
+    query.SetRange(query.GetRange().GetStart(), Sequence::Present());
+    return query;
+  }
 }
 }
 
@@ -0,0 +1,628 @@
+#ifndef BEAM_SEGMENT_DATA_STORE_HPP
+#define BEAM_SEGMENT_DATA_STORE_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/IO/IOException.hpp"
+#include "Beam/IO/OpenState.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Queries/DataSegment.hpp"
+#include "Beam/Queries/Evaluator.hpp"
+#include "Beam/Queries/EvaluatorTranslator.hpp"
+#include "Beam/Queries/IndexedValue.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Queries/Range.hpp"
+#include "Beam/Queries/SequencedValue.hpp"
+#include "Beam/Queries/SnapshotLimit.hpp"
+#include "Beam/Queues/RoutineTaskQueue.hpp"
+#include "Beam/Routines/Async.hpp"
+#include "Beam/Serialization/BinaryReceiver.hpp"
+#include "Beam/Serialization/BinarySender.hpp"
+#include "Beam/Utilities/SynchronizedMap.hpp"
+
+namespace Beam::Queries {
+
+  /**
+   * Stores SequencedValues in immutable memory mapped DataSegment files.
+   * Each index is kept in its own directory, every call to Store writes a new
+   * segment per index which is suited for storing large batches such as those
+   * committed by a BufferedDataStore. Once enough segments of a similar size
+   * accumulate they are merged into a single segment in the background.
+   * @param <Q> The type of query used to load values.
+   * @param <V> The type of value to store.
+   * @param <E> The type of EvaluatorTranslator used for filtering values.
+   */
+  template<typename Q, typename V, typename E>
+  class SegmentDataStore : private boost::noncopyable {
+    public:
+
+      /** The type of query used to load values. */
+      using Query = Q;
+
+      /** The type of index used. */
+      using Index = typename Query::Index;
+
+      /** The type of value to store. */
+      using Value = V;
+
+      /** The SequencedValue to store. */
+      using SequencedValue = ::Beam::Queries::SequencedValue<Value>;
+
+      /** The IndexedValue to store. */
+      using IndexedValue = ::Beam::Queries::SequencedValue<
+        ::Beam::Queries::IndexedValue<Value, Index>>;
+
+      /** The type of EvaluatorTranslator used for filtering values. */
+      using EvaluatorTranslatorFilter = E;
+
+      /** The default number of similarly sized segments to merge. */
+      static constexpr auto DEFAULT_COMPACTION_THRESHOLD = std::size_t(8);
+
+      /**
+       * Constructs a SegmentDataStore.
+       * @param root The directory to store the segments in.
+       * @param compactionThreshold The number of consecutive segments of a
+       *        similar size that are merged into a single segment.
+       */
+      explicit SegmentDataStore(std::filesystem::path root,
+        std::size_t compactionThreshold = DEFAULT_COMPACTION_THRESHOLD);
+
+      ~SegmentDataStore();
+
+      /** Returns all the values stored by this data store. */
+      std::vector<IndexedValue> LoadAll() const;
+
+      /**
+       * Executes a search query.
+       * @param query The search query to execute.
+       * @return The list of the values that satisfy the search <i>query</i>.
+       */
+      std::vector<SequencedValue> Load(const Query& query) const;
+
+      /**
+       * Stores a Value.
+       * @param value The Value to store.
+       */
+      void Store(const IndexedValue& value);
+
+      /**
+       * Stores a list of Values, writing one segment for each index.
+       * @param values The Values to store.
+       */
+      void Store(const std::vector<IndexedValue>& values);
+
+      /** Returns the number of segments stored for an index. */
+      std::size_t GetSegmentCount(const Index& index) const;
+
+      void Open();
+
+      void Close();
+
+    private:
+      struct Segment {
+        std::shared_ptr<DataSegment<Value>> m_segment;
+        std::uint64_t m_minimumGeneration;
+        std::uint64_t m_maximumGeneration;
+      };
+      struct Entry {
+        boost::mutex m_mutex;
+        Index m_index;
+        std::filesystem::path m_directory;
+        std::vector<Segment> m_segments;
+        std::vector<std::uint64_t> m_pendingGenerations;
+        bool m_isCompacting;
+
+        Entry(Index index, std::filesystem::path directory);
+      };
+      std::filesystem::path m_root;
+      std::size_t m_compactionThreshold;
+      std::atomic<std::uint64_t> m_nextGeneration;
+      SynchronizedUnorderedMap<Index, std::shared_ptr<Entry>> m_entries;
+      IO::OpenState m_openState;
+      RoutineTaskQueue m_tasks;
+
+      static std::string ToDirectoryName(const Index& index);
+      static Index FromDirectoryName(const std::string& name);
+      static std::string ToFileName(std::uint64_t minimumGeneration,
+        std::uint64_t maximumGeneration);
+      static std::vector<SequencedValue> Merge(
+        const std::vector<Segment>& segments);
+      std::shared_ptr<Entry> LoadEntry(const Index& index);
+      std::size_t GetTier(std::size_t size) const;
+      void Write(Entry& entry, const std::vector<SequencedValue>& values,
+        std::uint64_t minimumGeneration, std::uint64_t maximumGeneration,
+        Segment& segment);
+      void TestCompaction(const std::shared_ptr<Entry>& entry);
+      void Compact(const std::shared_ptr<Entry>& entry);
+      void Scan(const std::filesystem::path& directory);
+      void Shutdown();
+  };
+
+  template<typename Q, typename V, typename E>
+  SegmentDataStore<Q, V, E>::Entry::Entry(Index index,
+    std::filesystem::path directory)
+    : m_index(std::move(index)),
+      m_directory(std::move(directory)),
+      m_isCompacting(false) {}
+
+  template<typename Q, typename V, typename E>
+  SegmentDataStore<Q, V, E>::SegmentDataStore(std::filesystem::path root,
+    std::size_t compactionThreshold)
+    : m_root(std::move(root)),
+      m_compactionThreshold(std::max<std::size_t>(2, compactionThreshold)),
+      m_nextGeneration(0) {}
+
+  template<typename Q, typename V, typename E>
+  SegmentDataStore<Q, V, E>::~SegmentDataStore() {
+    Close();
+  }
+
+  template<typename Q, typename V, typename E>
+  std::vector<typename SegmentDataStore<Q, V, E>::IndexedValue>
+      SegmentDataStore<Q, V, E>::LoadAll() const {
+    auto entries = std::vector<std::shared_ptr<Entry>>();
+    m_entries.With(
+      [&] (auto& map) {
+        for(auto& entry : map) {
+          entries.push_back(entry.second);
+        }
+      });
+    auto values = std::vector<IndexedValue>();
+    for(auto& entry : entries) {
+      auto segments = [&] {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        return entry->m_segments;
+      }();
+      for(auto& value : Merge(segments)) {
+        values.push_back(Queries::SequencedValue(
+          Queries::IndexedValue(std::move(*value), entry->m_index),
+          value.GetSequence()));
+      }
+    }
+    return values;
+  }
+
+  template<typename Q, typename V, typename E>
+  std::vector<typename SegmentDataStore<Q, V, E>::SequencedValue>
+      SegmentDataStore<Q, V, E>::Load(const Query& query) const {
+    auto& range = query.GetRange();
+    auto& limit = query.GetSnapshotLimit();
+    if(limit.GetSize() == 0 || range.GetStart() == Sequence::Present() ||
+        range.GetStart() == Sequence::Last()) {
+      return {};
+    }
+    auto entry = m_entries.FindValue(query.GetIndex());
+    if(!entry) {
+      return {};
+    }
+    auto segments = [&] {
+      auto lock = boost::lock_guard((*entry)->m_mutex);
+      return (*entry)->m_segments;
+    }();
+    std::sort(segments.begin(), segments.end(),
+      [] (const Segment& left, const Segment& right) {
+        return left.m_segment->GetFirstSequence() <
+          right.m_segment->GetFirstSequence();
+      });
+    auto filter = Translate<EvaluatorTranslatorFilter>(query.GetFilter());
+    auto isOverlapping = std::adjacent_find(segments.begin(), segments.end(),
+      [] (const Segment& left, const Segment& right) {
+        return left.m_segment->GetLastSequence() >=
+          right.m_segment->GetFirstSequence();
+      }) != segments.end();
+    auto size = static_cast<std::size_t>(limit.GetSize());
+    auto matches = std::vector<SequencedValue>();
+    if(isOverlapping) {
+
+      // Segments written out of order have not been compacted yet, merge them
+      // in full so that the newest copy of a value is the one filtered.
+      for(auto& value : Merge(segments)) {
+        if(RangePointGreaterOrEqual(value, range.GetStart()) &&
+            RangePointLesserOrEqual(value, range.GetEnd()) &&
+            TestFilter(*filter, *value)) {
+          matches.push_back(std::move(value));
+        }
+      }
+      if(matches.size() > size) {
+        if(limit.GetType() == SnapshotLimit::Type::HEAD) {
+          matches.erase(matches.begin() + size, matches.end());
+        } else {
+          matches.erase(matches.begin(), matches.end() - size);
+        }
+      }
+    } else if(limit.GetType() == SnapshotLimit::Type::HEAD) {
+      for(auto& segment : segments) {
+        auto segmentMatches = segment.m_segment->Load(range, *filter,
+          SnapshotLimit(SnapshotLimit::Type::HEAD,
+          static_cast<int>(size - matches.size())));
+        matches.insert(matches.end(),
+          std::make_move_iterator(segmentMatches.begin()),
+          std::make_move_iterator(segmentMatches.end()));
+        if(matches.size() >= size) {
+          break;
+        }
+      }
+    } else {
+      for(auto i = segments.rbegin(); i != segments.rend(); ++i) {
+        auto segmentMatches = i->m_segment->Load(range, *filter,
+          SnapshotLimit(SnapshotLimit::Type::TAIL,
+          static_cast<int>(size - matches.size())));
+        matches.insert(matches.end(),
+          std::make_move_iterator(segmentMatches.rbegin()),
+          std::make_move_iterator(segmentMatches.rend()));
+        if(matches.size() >= size) {
+          break;
+        }
+      }
+      std::reverse(matches.begin(), matches.end());
+    }
+    return matches;
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Store(const IndexedValue& value) {
+    Store(std::vector<IndexedValue>{value});
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Store(
+      const std::vector<IndexedValue>& values) {
+    auto batches = std::unordered_map<Index, std::vector<SequencedValue>>();
+    for(auto& value : values) {
+      batches[value->GetIndex()].push_back(
+        Queries::SequencedValue(value->GetValue(), value.GetSequence()));
+    }
+    for(auto& batch : batches) {
+      auto& batchValues = batch.second;
+      std::stable_sort(batchValues.begin(), batchValues.end(),
+        SequenceComparator());
+      auto last = std::unique(batchValues.rbegin(), batchValues.rend(),
+        [] (const SequencedValue& left, const SequencedValue& right) {
+          return left.GetSequence() == right.GetSequence();
+        });
+      batchValues.erase(batchValues.begin(), last.base());
+      auto entry = LoadEntry(batch.first);
+
+      // The generation is reserved under the entry's lock so that compaction
+      // never merges a run of segments spanning one still being written.
+      auto generation = [&] {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        auto generation = ++m_nextGeneration;
+        entry->m_pendingGenerations.push_back(generation);
+        return generation;
+      }();
+      auto releaseGeneration = [&] {
+        auto& pendingGenerations = entry->m_pendingGenerations;
+        pendingGenerations.erase(std::find(pendingGenerations.begin(),
+          pendingGenerations.end(), generation));
+      };
+      auto segment = Segment();
+      try {
+        Write(*entry, batchValues, generation, generation, segment);
+      } catch(const std::exception&) {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        releaseGeneration();
+        throw;
+      }
+      {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        releaseGeneration();
+        auto& segments = entry->m_segments;
+        segments.insert(std::upper_bound(segments.begin(), segments.end(),
+          generation,
+          [] (std::uint64_t generation, const Segment& segment) {
+            return generation < segment.m_minimumGeneration;
+          }), std::move(segment));
+      }
+      TestCompaction(entry);
+    }
+  }
+
+  template<typename Q, typename V, typename E>
+  std::size_t SegmentDataStore<Q, V, E>::GetSegmentCount(
+      const Index& index) const {
+    auto entry = m_entries.FindValue(index);
+    if(!entry) {
+      return 0;
+    }
+    auto lock = boost::lock_guard((*entry)->m_mutex);
+    return (*entry)->m_segments.size();
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Open() {
+    if(m_openState.SetOpening()) {
+      return;
+    }
+    try {
+      std::filesystem::create_directories(m_root);
+      for(auto& directory : std::filesystem::directory_iterator(m_root)) {
+        if(directory.is_directory()) {
+          Scan(directory.path());
+        }
+      }
+    } catch(const std::exception&) {
+      m_openState.SetOpenFailure();
+      Shutdown();
+    }
+    m_openState.SetOpen();
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    Shutdown();
+  }
+
+  template<typename Q, typename V, typename E>
+  std::string SegmentDataStore<Q, V, E>::ToDirectoryName(const Index& index) {
+    auto buffer = IO::SharedBuffer();
+    auto sender = Serialization::BinarySender<IO::SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(index);
+    static const auto DIGITS = "0123456789abcdef";
+    auto name = std::string();
+    name.reserve(2 * buffer.GetSize());
+    for(auto i = std::size_t(0); i != buffer.GetSize(); ++i) {
+      auto c = static_cast<unsigned char>(buffer.GetData()[i]);
+      name += DIGITS[c >> 4];
+      name += DIGITS[c & 0xF];
+    }
+    return name;
+  }
+
+  template<typename Q, typename V, typename E>
+  typename SegmentDataStore<Q, V, E>::Index
+      SegmentDataStore<Q, V, E>::FromDirectoryName(const std::string& name) {
+    auto toDigit = [] (char c) {
+      if(c >= '0' && c <= '9') {
+        return c - '0';
+      } else if(c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+      }
+      BOOST_THROW_EXCEPTION(IO::IOException("Invalid index directory."));
+    };
+    if(name.size() % 2 != 0) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Invalid index directory."));
+    }
+    auto bytes = std::string();
+    for(auto i = std::size_t(0); i < name.size(); i += 2) {
+      bytes += static_cast<char>(16 * toDigit(name[i]) + toDigit(name[i + 1]));
+    }
+    auto buffer = IO::SharedBuffer(bytes.data(), bytes.size());
+    auto receiver = Serialization::BinaryReceiver<IO::SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    auto index = Index();
+    receiver.Shuttle(index);
+    return index;
+  }
+
+  template<typename Q, typename V, typename E>
+  std::string SegmentDataStore<Q, V, E>::ToFileName(
+      std::uint64_t minimumGeneration, std::uint64_t maximumGeneration) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.seg",
+      static_cast<unsigned long long>(minimumGeneration),
+      static_cast<unsigned long long>(maximumGeneration));
+    return name;
+  }
+
+  template<typename Q, typename V, typename E>
+  std::vector<typename SegmentDataStore<Q, V, E>::SequencedValue>
+      SegmentDataStore<Q, V, E>::Merge(const std::vector<Segment>& segments) {
+    auto ordered = segments;
+    std::sort(ordered.begin(), ordered.end(),
+      [] (const Segment& left, const Segment& right) {
+        return left.m_minimumGeneration < right.m_minimumGeneration;
+      });
+    auto values = std::vector<SequencedValue>();
+    for(auto& segment : ordered) {
+      auto segmentValues = segment.m_segment->LoadAll();
+      values.insert(values.end(),
+        std::make_move_iterator(segmentValues.begin()),
+        std::make_move_iterator(segmentValues.end()));
+    }
+
+    // Keeps the value from the newest segment when Sequences collide.
+    std::stable_sort(values.begin(), values.end(), SequenceComparator());
+    auto last = std::unique(values.rbegin(), values.rend(),
+      [] (const SequencedValue& left, const SequencedValue& right) {
+        return left.GetSequence() == right.GetSequence();
+      });
+    values.erase(values.begin(), last.base());
+    return values;
+  }
+
+  template<typename Q, typename V, typename E>
+  std::shared_ptr<typename SegmentDataStore<Q, V, E>::Entry>
+      SegmentDataStore<Q, V, E>::LoadEntry(const Index& index) {
+    return m_entries.GetOrInsert(index,
+      [&] {
+        auto directory = m_root / ToDirectoryName(index);
+        std::filesystem::create_directories(directory);
+        return std::make_shared<Entry>(index, std::move(directory));
+      });
+  }
+
+  template<typename Q, typename V, typename E>
+  std::size_t SegmentDataStore<Q, V, E>::GetTier(std::size_t size) const {
+    auto tier = std::size_t(0);
+    while(size >= m_compactionThreshold) {
+      size /= m_compactionThreshold;
+      ++tier;
+    }
+    return tier;
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Write(Entry& entry,
+      const std::vector<SequencedValue>& values,
+      std::uint64_t minimumGeneration, std::uint64_t maximumGeneration,
+      Segment& segment) {
+    auto path = entry.m_directory /
+      ToFileName(minimumGeneration, maximumGeneration);
+    DataSegment<Value>::Write(path, values.begin(), values.end());
+    segment.m_segment = std::make_shared<DataSegment<Value>>(std::move(path));
+    segment.m_minimumGeneration = minimumGeneration;
+    segment.m_maximumGeneration = maximumGeneration;
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::TestCompaction(
+      const std::shared_ptr<Entry>& entry) {
+    {
+      auto lock = boost::lock_guard(entry->m_mutex);
+      if(entry->m_isCompacting ||
+          entry->m_segments.size() < m_compactionThreshold) {
+        return;
+      }
+      entry->m_isCompacting = true;
+    }
+    m_tasks.Push(
+      [=] {
+        try {
+          Compact(entry);
+        } catch(const std::exception&) {
+          auto lock = boost::lock_guard(entry->m_mutex);
+          entry->m_isCompacting = false;
+        }
+      });
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Compact(const std::shared_ptr<Entry>& entry) {
+    while(true) {
+      auto run = std::vector<Segment>();
+      {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        auto& segments = entry->m_segments;
+
+        // Only segments older than every pending write are eligible, so that
+        // each run covers a contiguous range of the entry's generations.
+        auto eligibleEnd = segments.end();
+        if(!entry->m_pendingGenerations.empty()) {
+          auto pendingGeneration = *std::min_element(
+            entry->m_pendingGenerations.begin(),
+            entry->m_pendingGenerations.end());
+          eligibleEnd = std::find_if(segments.begin(), segments.end(),
+            [&] (const Segment& segment) {
+              return segment.m_maximumGeneration > pendingGeneration;
+            });
+        }
+        auto begin = segments.begin();
+        while(begin != eligibleEnd) {
+          auto tier = GetTier(begin->m_segment->GetSize());
+          auto end = std::find_if(begin, eligibleEnd,
+            [&] (const Segment& segment) {
+              return GetTier(segment.m_segment->GetSize()) != tier;
+            });
+          if(static_cast<std::size_t>(end - begin) >= m_compactionThreshold) {
+            run.assign(begin, end);
+            break;
+          }
+          begin = end;
+        }
+        if(run.empty()) {
+          entry->m_isCompacting = false;
+          return;
+        }
+      }
+      auto merged = Segment();
+      Write(*entry, Merge(run), run.front().m_minimumGeneration,
+        run.back().m_maximumGeneration, merged);
+      {
+        auto lock = boost::lock_guard(entry->m_mutex);
+        auto& segments = entry->m_segments;
+        auto begin = std::find_if(segments.begin(), segments.end(),
+          [&] (const Segment& segment) {
+            return segment.m_segment == run.front().m_segment;
+          });
+        auto end = begin + run.size();
+        *begin = std::move(merged);
+        segments.erase(begin + 1, end);
+      }
+      for(auto& segment : run) {
+        segment.m_segment->MarkObsolete();
+      }
+    }
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Scan(
+      const std::filesystem::path& directory) {
+    auto entry = std::make_shared<Entry>(
+      FromDirectoryName(directory.filename().string()), directory);
+    auto segments = std::vector<Segment>();
+    for(auto& file : std::filesystem::directory_iterator(directory)) {
+      if(file.path().extension() == ".tmp") {
+        std::filesystem::remove(file.path());
+        continue;
+      } else if(file.path().extension() != ".seg") {
+        continue;
+      }
+      auto segment = Segment();
+      auto minimumGeneration = 0ULL;
+      auto maximumGeneration = 0ULL;
+      if(std::sscanf(file.path().filename().string().c_str(), "%llx-%llx.seg",
+          &minimumGeneration, &maximumGeneration) != 2) {
+        continue;
+      }
+      segment.m_segment = std::make_shared<DataSegment<Value>>(file.path());
+      segment.m_minimumGeneration = minimumGeneration;
+      segment.m_maximumGeneration = maximumGeneration;
+      segments.push_back(std::move(segment));
+    }
+
+    // Segments already merged into a larger one are the inputs of a
+    // compaction that was interrupted before they could be deleted.
+    for(auto& segment : segments) {
+      auto isMerged = std::any_of(segments.begin(), segments.end(),
+        [&] (const Segment& other) {
+          return &other != &segment &&
+            other.m_minimumGeneration <= segment.m_minimumGeneration &&
+            other.m_maximumGeneration >= segment.m_maximumGeneration;
+        });
+      if(isMerged) {
+        segment.m_segment->MarkObsolete();
+      } else {
+        entry->m_segments.push_back(segment);
+      }
+      auto generation = m_nextGeneration.load();
+      while(generation < segment.m_maximumGeneration &&
+          !m_nextGeneration.compare_exchange_weak(generation,
+            segment.m_maximumGeneration)) {}
+    }
+    std::sort(entry->m_segments.begin(), entry->m_segments.end(),
+      [] (const Segment& left, const Segment& right) {
+        return left.m_minimumGeneration < right.m_minimumGeneration;
+      });
+    m_entries.Update(entry->m_index, entry);
+    TestCompaction(entry);
+  }
+
+  template<typename Q, typename V, typename E>
+  void SegmentDataStore<Q, V, E>::Shutdown() {
+    auto token = Routines::Async<void>();
+    m_tasks.Push(
+      [&] {
+        token.GetEval().SetResult();
+      });
+    token.Get();
+    m_openState.SetClosed();
+  }
+}
+
+#endif
@@ -155,14 +155,15 @@ namespace Queries {
     } else if(timestamp.is_special()) {
       BOOST_THROW_EXCEPTION(std::out_of_range{"Invalid timestamp."});
     } else {
+      auto date = timestamp.date().year_month_day();
       auto yearComponent =
-        static_cast<Sequence::Ordinal>(timestamp.date().year()) <<
+        static_cast<Sequence::Ordinal>(date.year) <<
         (CHAR_BIT * sizeof(Sequence::Ordinal) - YEAR_SIZE);
       auto monthComponent =
-        static_cast<Sequence::Ordinal>(timestamp.date().month()) <<
+        static_cast<Sequence::Ordinal>(date.month) <<
         (CHAR_BIT * sizeof(Sequence::Ordinal) - (YEAR_SIZE + MONTH_SIZE));
       auto dayComponent =
-        static_cast<Sequence::Ordinal>(timestamp.date().day()) <<
+        static_cast<Sequence::Ordinal>(date.day) <<
         (CHAR_BIT * sizeof(Sequence::Ordinal) -
         (YEAR_SIZE + MONTH_SIZE + DAY_SIZE));
       Sequence sequence{yearComponent + monthComponent + dayComponent};
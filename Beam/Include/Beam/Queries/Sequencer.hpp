@@ -42,6 +42,16 @@ namespace Queries {
       Sequence IncrementNextSequence(
         const boost::posix_time::ptime& timestamp);
 
+      //! Reserves a contiguous block of Sequences for a specified timestamp.
+      /*!
+        \param timestamp The timestamp to translate into a Sequence.
+        \param count The number of Sequences to reserve.
+        \return The first Sequence in the reserved block, the remaining
+                Sequences are obtained by incrementing it.
+      */
+      Sequence IncrementNextSequence(const boost::posix_time::ptime& timestamp,
+        int count);
+
     private:
       Sequence m_nextSequence;
       boost::posix_time::ptime m_partition;
@@ -85,12 +95,17 @@ namespace Queries {
 
   inline Sequence Sequencer::IncrementNextSequence(
       const boost::posix_time::ptime& timestamp) {
+    return IncrementNextSequence(timestamp, 1);
+  }
+
+  inline Sequence Sequencer::IncrementNextSequence(
+      const boost::posix_time::ptime& timestamp, int count) {
     if(!IsSamePartition(timestamp, m_partition)) {
       m_partition = GetPartition(timestamp);
       m_nextSequence = EncodeTimestamp(timestamp);
     }
     auto sequence = m_nextSequence;
-    ++m_nextSequence;
+    m_nextSequence = Sequence(m_nextSequence.GetOrdinal() + count);
     return sequence;
   }
 }
@@ -11,6 +11,7 @@
 #include "Beam/Queries/StandardDataTypes.hpp"
 #include "Beam/Queries/StandardValues.hpp"
 #include "Beam/Queries/VariableExpression.hpp"
+#include "Beam/Queries/WindowedReduceExpression.hpp"
 #include "Beam/Serialization/TypeRegistry.hpp"
 
 namespace Beam {
@@ -43,7 +44,8 @@ namespace Queries {
     (ParameterExpression, "Beam.Queries.ParameterExpression"),
     (ReduceExpression, "Beam.Queries.ReduceExpression"),
     (SetVariableExpression, "Beam.Queries.SetVariableExpression"),
-    (VariableExpression, "Beam.Queries.VariableExpression"));
+    (VariableExpression, "Beam.Queries.VariableExpression"),
+    (WindowedReduceExpression, "Beam.Queries.WindowedReduceExpression"));
 
   template<typename SenderType>
   void RegisterQueryTypes(Out<
@@ -10,6 +10,7 @@
 #include "Beam/Queries/ReduceExpression.hpp"
 #include "Beam/Queries/SetVariableExpression.hpp"
 #include "Beam/Queries/VariableExpression.hpp"
+#include "Beam/Queries/WindowedReduceExpression.hpp"
 #include "Beam/Queries/Queries.hpp"
 
 namespace Beam {
@@ -39,6 +40,8 @@ namespace Queries {
 
       virtual void Visit(const VariableExpression& expression) override;
 
+      virtual void Visit(const WindowedReduceExpression& expression) override;
+
       virtual void Visit(const VirtualExpression& expression) override;
   };
 
@@ -86,6 +89,12 @@ namespace Queries {
   inline void TraversalExpressionVisitor::Visit(
       const VariableExpression& expression) {}
 
+  inline void TraversalExpressionVisitor::Visit(
+      const WindowedReduceExpression& expression) {
+    expression.GetSeriesExpression()->Apply(*this);
+    expression.GetTimestampExpression()->Apply(*this);
+  }
+
   inline void TraversalExpressionVisitor::Visit(
       const VirtualExpression& expression) {}
 }
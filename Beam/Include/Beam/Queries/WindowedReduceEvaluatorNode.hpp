@@ -0,0 +1,326 @@
+#ifndef BEAM_WINDOWEDREDUCEEVALUATORNODE_HPP
+#define BEAM_WINDOWEDREDUCEEVALUATORNODE_HPP
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/mpl/list.hpp>
+#include "Beam/Pointers/UniquePtr.hpp"
+#include "Beam/Queries/EvaluatorNode.hpp"
+#include "Beam/Queries/Queries.hpp"
+
+namespace Beam {
+namespace Queries {
+
+  /*! \class WindowSum
+      \brief Maintains the sum of the values in a window in constant time.
+      \details Values leaving the window are subtracted from the sum, so a sum
+               of doubles accumulates rounding error over the life of the
+               window rather than being exact for its current values.
+      \tparam T The type of value being summed.
+   */
+  template<typename T>
+  class WindowSum {
+    public:
+
+      //! The type of value being summed.
+      using Type = T;
+
+      //! The type of the aggregate.
+      using Result = T;
+
+      //! Constructs an empty WindowSum.
+      WindowSum();
+
+      //! Adds a value entering the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value entering the window.
+      */
+      void Push(std::uint64_t index, const Type& value);
+
+      //! Removes the oldest value from the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value leaving the window.
+      */
+      void Pop(std::uint64_t index, const Type& value);
+
+      //! Returns the sum of the values in the window.
+      const Result& Get() const;
+
+    private:
+      Result m_sum;
+  };
+
+  /*! \class WindowCount
+      \brief Maintains the number of values in a window.
+      \tparam T The type of value being counted.
+   */
+  template<typename T>
+  class WindowCount {
+    public:
+
+      //! The type of value being counted.
+      using Type = T;
+
+      //! The type of the aggregate.
+      using Result = int;
+
+      //! Constructs an empty WindowCount.
+      WindowCount();
+
+      //! Adds a value entering the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value entering the window.
+      */
+      void Push(std::uint64_t index, const Type& value);
+
+      //! Removes the oldest value from the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value leaving the window.
+      */
+      void Pop(std::uint64_t index, const Type& value);
+
+      //! Returns the number of values in the window.
+      const Result& Get() const;
+
+    private:
+      Result m_count;
+  };
+
+  /*! \class WindowExtremum
+      \brief Maintains the extreme value of a window using a monotonic queue,
+             giving amortized constant time updates.
+      \tparam T The type of value being compared.
+      \tparam C The comparator, the extremum is the value x for which C(x, y)
+                holds for every other value y in the window.
+   */
+  template<typename T, typename C>
+  class WindowExtremum {
+    public:
+
+      //! The type of value being compared.
+      using Type = T;
+
+      //! The type of the aggregate.
+      using Result = T;
+
+      //! The comparator used to order values.
+      using Comparator = C;
+
+      //! Adds a value entering the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value entering the window.
+      */
+      void Push(std::uint64_t index, const Type& value);
+
+      //! Removes the oldest value from the window.
+      /*!
+        \param index The value's position within the series.
+        \param value The value leaving the window.
+      */
+      void Pop(std::uint64_t index, const Type& value);
+
+      //! Returns the extreme value in the window.
+      const Result& Get() const;
+
+    private:
+      std::deque<std::pair<std::uint64_t, Type>> m_candidates;
+      Comparator m_comparator;
+  };
+
+  //! Maintains the smallest value in a window.
+  template<typename T>
+  using WindowMin = WindowExtremum<T, std::less<T>>;
+
+  //! Maintains the largest value in a window.
+  template<typename T>
+  using WindowMax = WindowExtremum<T, std::greater<T>>;
+
+  /*! \class WindowedReduceEvaluatorNode
+      \brief Evaluates a WindowedReduceExpression.
+      \tparam A The aggregate maintained over the window.
+   */
+  template<typename A>
+  class WindowedReduceEvaluatorNode :
+      public EvaluatorNode<typename A::Result> {
+    public:
+      using Result = typename EvaluatorNode<typename A::Result>::Result;
+
+      //! The aggregate maintained over the window.
+      using Aggregate = A;
+
+      //! The type of value in the series.
+      using Type = typename Aggregate::Type;
+
+      //! Constructs a WindowedReduceEvaluatorNode bounded by a count of
+      //! values.
+      /*!
+        \param series The series to reduce.
+        \param size The maximum number of values in the window.
+      */
+      WindowedReduceEvaluatorNode(std::unique_ptr<EvaluatorNode<Type>> series,
+        int size);
+
+      //! Constructs a WindowedReduceEvaluatorNode.
+      /*!
+        \param series The series to reduce.
+        \param timestamp Evaluates to the timestamp of each value in the
+               series, or nullptr if the window isn't bounded by time.
+        \param size The maximum number of values in the window.
+        \param period The length of time spanned by the window.
+      */
+      WindowedReduceEvaluatorNode(std::unique_ptr<EvaluatorNode<Type>> series,
+        std::unique_ptr<EvaluatorNode<boost::posix_time::ptime>> timestamp,
+        int size, boost::posix_time::time_duration period);
+
+      virtual Result Eval();
+
+    private:
+      struct Entry {
+        std::uint64_t m_index;
+        Type m_value;
+        boost::posix_time::ptime m_timestamp;
+      };
+      std::unique_ptr<EvaluatorNode<Type>> m_series;
+      std::unique_ptr<EvaluatorNode<boost::posix_time::ptime>> m_timestamp;
+      std::size_t m_size;
+      boost::posix_time::time_duration m_period;
+      std::uint64_t m_nextIndex;
+      std::deque<Entry> m_window;
+      Aggregate m_aggregate;
+  };
+
+  template<typename TypeList, template<typename> class Aggregate>
+  struct WindowedReduceEvaluatorNodeTranslator {
+    template<typename T>
+    static BaseEvaluatorNode* Template(
+        std::unique_ptr<BaseEvaluatorNode> series,
+        std::unique_ptr<BaseEvaluatorNode> timestamp, int size,
+        boost::posix_time::time_duration period) {
+      auto timestampNode =
+        std::unique_ptr<EvaluatorNode<boost::posix_time::ptime>>();
+      if(timestamp != nullptr) {
+        timestampNode = UniqueStaticCast<
+          EvaluatorNode<boost::posix_time::ptime>>(std::move(timestamp));
+      }
+      return new WindowedReduceEvaluatorNode<Aggregate<T>>(
+        UniqueStaticCast<EvaluatorNode<T>>(std::move(series)),
+        std::move(timestampNode), size, period);
+    }
+
+    typedef TypeList SupportedTypes;
+  };
+
+  //! Lists the types that can be summed over a window.
+  typedef boost::mpl::list<int, double, boost::posix_time::time_duration>
+    WindowSumTypes;
+
+  template<typename T>
+  WindowSum<T>::WindowSum()
+    : m_sum() {}
+
+  template<typename T>
+  void WindowSum<T>::Push(std::uint64_t index, const Type& value) {
+    m_sum += value;
+  }
+
+  template<typename T>
+  void WindowSum<T>::Pop(std::uint64_t index, const Type& value) {
+    m_sum -= value;
+  }
+
+  template<typename T>
+  const typename WindowSum<T>::Result& WindowSum<T>::Get() const {
+    return m_sum;
+  }
+
+  template<typename T>
+  WindowCount<T>::WindowCount()
+    : m_count(0) {}
+
+  template<typename T>
+  void WindowCount<T>::Push(std::uint64_t index, const Type& value) {
+    ++m_count;
+  }
+
+  template<typename T>
+  void WindowCount<T>::Pop(std::uint64_t index, const Type& value) {
+    --m_count;
+  }
+
+  template<typename T>
+  const typename WindowCount<T>::Result& WindowCount<T>::Get() const {
+    return m_count;
+  }
+
+  template<typename T, typename C>
+  void WindowExtremum<T, C>::Push(std::uint64_t index, const Type& value) {
+    while(!m_candidates.empty() &&
+        !m_comparator(m_candidates.back().second, value)) {
+      m_candidates.pop_back();
+    }
+    m_candidates.emplace_back(index, value);
+  }
+
+  template<typename T, typename C>
+  void WindowExtremum<T, C>::Pop(std::uint64_t index, const Type& value) {
+    if(!m_candidates.empty() && m_candidates.front().first == index) {
+      m_candidates.pop_front();
+    }
+  }
+
+  template<typename T, typename C>
+  const typename WindowExtremum<T, C>::Result&
+      WindowExtremum<T, C>::Get() const {
+    return m_candidates.front().second;
+  }
+
+  template<typename A>
+  WindowedReduceEvaluatorNode<A>::WindowedReduceEvaluatorNode(
+    std::unique_ptr<EvaluatorNode<Type>> series, int size)
+    : WindowedReduceEvaluatorNode(std::move(series), nullptr, size,
+        boost::posix_time::pos_infin) {}
+
+  template<typename A>
+  WindowedReduceEvaluatorNode<A>::WindowedReduceEvaluatorNode(
+    std::unique_ptr<EvaluatorNode<Type>> series,
+    std::unique_ptr<EvaluatorNode<boost::posix_time::ptime>> timestamp,
+    int size, boost::posix_time::time_duration period)
+    : m_series(std::move(series)),
+      m_timestamp(std::move(timestamp)),
+      m_size(static_cast<std::size_t>(size)),
+      m_period(period),
+      m_nextIndex(0) {}
+
+  template<typename A>
+  typename WindowedReduceEvaluatorNode<A>::Result
+      WindowedReduceEvaluatorNode<A>::Eval() {
+    auto value = m_series->Eval();
+    auto timestamp = [&] {
+      if(m_timestamp == nullptr) {
+        return boost::posix_time::ptime();
+      }
+      return m_timestamp->Eval();
+    }();
+    m_aggregate.Push(m_nextIndex, value);
+    m_window.push_back(Entry{m_nextIndex, std::move(value), timestamp});
+    ++m_nextIndex;
+    while(m_window.size() > m_size || (m_timestamp != nullptr &&
+        m_window.front().m_timestamp + m_period <= timestamp)) {
+      auto& front = m_window.front();
+      m_aggregate.Pop(front.m_index, front.m_value);
+      m_window.pop_front();
+    }
+    return m_aggregate.Get();
+  }
+}
+}
+
+#endif
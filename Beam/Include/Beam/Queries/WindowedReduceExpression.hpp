@@ -0,0 +1,259 @@
+#ifndef BEAM_WINDOWEDREDUCEEXPRESSION_HPP
+#define BEAM_WINDOWEDREDUCEEXPRESSION_HPP
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/Queries/ConstantExpression.hpp"
+#include "Beam/Queries/Expression.hpp"
+#include "Beam/Queries/ExpressionVisitor.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Queries/StandardDataTypes.hpp"
+#include "Beam/Queries/TypeCompatibilityException.hpp"
+#include "Beam/Serialization/DataShuttle.hpp"
+#include "Beam/Serialization/ShuttleDateTime.hpp"
+
+namespace Beam {
+namespace Queries {
+
+  /*! \class WindowedReduceExpression
+      \brief Incrementally reduces the most recent values of a series, bounded
+             either by a count of values or by a period of time.
+   */
+  class WindowedReduceExpression : public VirtualExpression,
+      public CloneableMixin<WindowedReduceExpression> {
+    public:
+
+      /*! \enum Operation
+          \brief Lists the supported reductions.
+       */
+      enum class Operation {
+
+        //! Sums the values in the window, floating point sums accumulate the
+        //! rounding error of every value that leaves the window.
+        SUM,
+
+        //! Counts the values in the window.
+        COUNT,
+
+        //! Evaluates to the smallest value in the window, the series must be
+        //! one of QueryTypes::ComparableTypes.
+        MIN,
+
+        //! Evaluates to the largest value in the window, the series must be
+        //! one of QueryTypes::ComparableTypes.
+        MAX
+      };
+
+      //! Constructs a WindowedReduceExpression over the last <i>size</i>
+      //! values of a series.
+      /*!
+        \param operation The reduction to perform.
+        \param seriesExpression The expression to apply the reduction to.
+        \param size The maximum number of values in the window.
+      */
+      WindowedReduceExpression(Operation operation,
+        const Expression& seriesExpression, int size);
+
+      //! Constructs a WindowedReduceExpression over the values of a series
+      //! whose timestamp is within a period of the most recent timestamp.
+      /*!
+        \param operation The reduction to perform.
+        \param seriesExpression The expression to apply the reduction to.
+        \param timestampExpression The expression evaluating to the timestamp
+               of each value in the series.
+        \param period The length of time spanned by the window.
+      */
+      WindowedReduceExpression(Operation operation,
+        const Expression& seriesExpression,
+        const Expression& timestampExpression,
+        boost::posix_time::time_duration period);
+
+      //! Returns the reduction performed.
+      Operation GetOperation() const;
+
+      //! Returns the series expression.
+      const Expression& GetSeriesExpression() const;
+
+      //! Returns the timestamp expression.
+      const Expression& GetTimestampExpression() const;
+
+      //! Returns the maximum number of values in the window.
+      int GetSize() const;
+
+      //! Returns the period spanned by the window, or pos_infin if the window
+      //! is bounded only by its size.
+      boost::posix_time::time_duration GetPeriod() const;
+
+      virtual const DataType& GetType() const;
+
+      virtual void Apply(ExpressionVisitor& visitor) const;
+
+    protected:
+      virtual std::ostream& ToStream(std::ostream& out) const;
+
+    private:
+      friend struct Serialization::DataShuttle;
+      Operation m_operation;
+      Expression m_seriesExpression;
+      Expression m_timestampExpression;
+      int m_size;
+      boost::posix_time::time_duration m_period;
+
+      WindowedReduceExpression();
+      bool IsValid() const;
+      template<typename Shuttler>
+      void Shuttle(Shuttler& shuttle, unsigned int version);
+  };
+
+  inline std::ostream& operator <<(std::ostream& out,
+      WindowedReduceExpression::Operation value) {
+    if(value == WindowedReduceExpression::Operation::SUM) {
+      return out << "sum";
+    } else if(value == WindowedReduceExpression::Operation::COUNT) {
+      return out << "count";
+    } else if(value == WindowedReduceExpression::Operation::MIN) {
+      return out << "min";
+    } else if(value == WindowedReduceExpression::Operation::MAX) {
+      return out << "max";
+    }
+    return out << "none";
+  }
+
+  inline WindowedReduceExpression::WindowedReduceExpression(
+      Operation operation, const Expression& seriesExpression, int size)
+      : m_operation(operation),
+        m_seriesExpression(seriesExpression),
+        m_timestampExpression(ConstantExpression(boost::posix_time::ptime())),
+        m_size(size),
+        m_period(boost::posix_time::pos_infin) {
+    if(m_size <= 0) {
+      BOOST_THROW_EXCEPTION(std::out_of_range("Invalid window size."));
+    }
+    if(!IsValid()) {
+      BOOST_THROW_EXCEPTION(TypeCompatibilityException());
+    }
+  }
+
+  inline WindowedReduceExpression::WindowedReduceExpression(
+      Operation operation, const Expression& seriesExpression,
+      const Expression& timestampExpression,
+      boost::posix_time::time_duration period)
+      : m_operation(operation),
+        m_seriesExpression(seriesExpression),
+        m_timestampExpression(timestampExpression),
+        m_size(std::numeric_limits<int>::max()),
+        m_period(period) {
+    if(m_period.is_special() || m_period <= boost::posix_time::seconds(0)) {
+      BOOST_THROW_EXCEPTION(std::out_of_range("Invalid window period."));
+    }
+    if(!IsValid()) {
+      BOOST_THROW_EXCEPTION(TypeCompatibilityException());
+    }
+  }
+
+  inline WindowedReduceExpression::Operation
+      WindowedReduceExpression::GetOperation() const {
+    return m_operation;
+  }
+
+  inline const Expression&
+      WindowedReduceExpression::GetSeriesExpression() const {
+    return m_seriesExpression;
+  }
+
+  inline const Expression&
+      WindowedReduceExpression::GetTimestampExpression() const {
+    return m_timestampExpression;
+  }
+
+  inline int WindowedReduceExpression::GetSize() const {
+    return m_size;
+  }
+
+  inline boost::posix_time::time_duration
+      WindowedReduceExpression::GetPeriod() const {
+    return m_period;
+  }
+
+  inline const DataType& WindowedReduceExpression::GetType() const {
+    if(m_operation == Operation::COUNT) {
+      static DataType value = IntType::GetInstance();
+      return value;
+    }
+    return m_seriesExpression->GetType();
+  }
+
+  inline void WindowedReduceExpression::Apply(
+      ExpressionVisitor& visitor) const {
+    visitor.Visit(*this);
+  }
+
+  inline std::ostream& WindowedReduceExpression::ToStream(
+      std::ostream& out) const {
+    out << "(window-" << m_operation << " " << *m_seriesExpression << " ";
+    if(m_period == boost::posix_time::pos_infin) {
+      return out << m_size << ")";
+    }
+    return out << *m_timestampExpression << " " << m_period << ")";
+  }
+
+  inline WindowedReduceExpression::WindowedReduceExpression()
+      : m_operation(Operation::COUNT),
+        m_seriesExpression(ConstantExpression(0)),
+        m_timestampExpression(ConstantExpression(boost::posix_time::ptime())),
+        m_size(1),
+        m_period(boost::posix_time::pos_infin) {}
+
+  inline bool WindowedReduceExpression::IsValid() const {
+    if(m_timestampExpression->GetType()->GetNativeType() !=
+        typeid(boost::posix_time::ptime)) {
+      return false;
+    }
+    const auto& type = m_seriesExpression->GetType()->GetNativeType();
+    if(m_operation == Operation::SUM) {
+      return type == typeid(int) || type == typeid(double) ||
+        type == typeid(boost::posix_time::time_duration);
+    } else if(m_operation == Operation::MIN || m_operation == Operation::MAX) {
+      auto isComparable = false;
+      boost::mpl::for_each<QueryTypes::ComparableTypes>(
+        [&] (const auto& value) {
+          isComparable = isComparable || type == typeid(value);
+        });
+      return isComparable;
+    }
+    return true;
+  }
+
+  template<typename Shuttler>
+  void WindowedReduceExpression::Shuttle(Shuttler& shuttle,
+      unsigned int version) {
+    VirtualExpression::Shuttle(shuttle, version);
+    shuttle.Shuttle("operation", m_operation);
+    shuttle.Shuttle("series_expression", m_seriesExpression);
+    shuttle.Shuttle("timestamp_expression", m_timestampExpression);
+    shuttle.Shuttle("size", m_size);
+    shuttle.Shuttle("period", m_period);
+    if(Serialization::IsReceiver<Shuttler>::value) {
+      if(m_size <= 0 || m_period.is_not_a_date_time() ||
+          m_period <= boost::posix_time::seconds(0)) {
+        BOOST_THROW_EXCEPTION(Serialization::SerializationException(
+          "Invalid window."));
+      }
+      if(!IsValid()) {
+        BOOST_THROW_EXCEPTION(Serialization::SerializationException(
+          "Incompatible types."));
+      }
+    }
+  }
+
+  inline void ExpressionVisitor::Visit(
+      const WindowedReduceExpression& expression) {
+    Visit(static_cast<const VirtualExpression&>(expression));
+  }
+}
+}
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef BEAM_WRITE_AHEAD_LOG_HPP
+#define BEAM_WRITE_AHEAD_LOG_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <boost/crc.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/IO/IOException.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Queries/Queries.hpp"
+#include "Beam/Serialization/BinaryReceiver.hpp"
+#include "Beam/Serialization/BinarySender.hpp"
+#include "Beam/Serialization/SerializationException.hpp"
+
+namespace Beam::Queries {
+
+  /**
+   * Appends values to a memory mapped file so that they can be recovered
+   * after a crash.
+   * Each record is serialized using a BinarySender and framed by its size and
+   * checksum, the size being written last so that a record interrupted by a
+   * crash is never replayed.
+   * @param <T> The type of value to log.
+   */
+  template<typename T>
+  class WriteAheadLog : private boost::noncopyable {
+    public:
+
+      /** The type of value to log. */
+      using Type = T;
+
+      /**
+       * Opens a WriteAheadLog, creating its file if it doesn't exist.
+       * @param path The path to the log's file.
+       * @param syncInterval The minimum amount of time between flushing
+       *        appended records to disk, records appended within the interval
+       *        are committed as a group by a later append. A zero interval
+       *        flushes every append. Records appended at the end of a group
+       *        stay unflushed until Sync is called, so the owner of the log
+       *        calls it once per interval to bound how long that can be.
+       */
+      WriteAheadLog(std::filesystem::path path,
+        boost::posix_time::time_duration syncInterval);
+
+      ~WriteAheadLog();
+
+      /** Returns the path to the log's file. */
+      const std::filesystem::path& GetPath() const;
+
+      /** Returns <code>true</code> iff no records are logged. */
+      bool IsEmpty() const;
+
+      /** Loads every record in the log in the order they were appended. */
+      std::vector<Type> Load() const;
+
+      /**
+       * Appends a record to the log.
+       * @param value The value to append.
+       */
+      void Append(const Type& value);
+
+      /**
+       * Appends a batch of records to the log.
+       * @param values The values to append.
+       */
+      void Append(const std::vector<Type>& values);
+
+      /** Flushes every appended record to disk. */
+      void Sync();
+
+      /** Discards every record in the log. */
+      void Truncate();
+
+    private:
+      using Clock = std::chrono::steady_clock;
+      struct Header {
+        std::uint32_t m_size;
+        std::uint32_t m_checksum;
+      };
+      static constexpr auto MINIMUM_CAPACITY = std::size_t(1) << 20;
+      std::filesystem::path m_path;
+      Clock::duration m_syncInterval;
+      boost::interprocess::file_mapping m_file;
+      boost::interprocess::mapped_region m_region;
+      std::size_t m_end;
+      std::size_t m_syncedEnd;
+      Clock::time_point m_lastSync;
+      IO::SharedBuffer m_buffer;
+      Serialization::BinarySender<IO::SharedBuffer> m_sender;
+
+      static std::uint32_t ComputeChecksum(const char* data, std::size_t size);
+      char* GetData() const;
+      std::size_t GetCapacity() const;
+      std::size_t Scan(std::vector<Type>* values) const;
+      void Map(std::size_t capacity);
+      void Write(const Type& value);
+      void TestSync();
+  };
+
+  template<typename T>
+  WriteAheadLog<T>::WriteAheadLog(std::filesystem::path path,
+      boost::posix_time::time_duration syncInterval)
+      : m_path(std::move(path)),
+        m_syncInterval(std::chrono::microseconds(
+          syncInterval.total_microseconds())),
+        m_lastSync(Clock::now()) {
+    if(!std::filesystem::exists(m_path)) {
+      auto file = std::ofstream(m_path, std::ios::binary);
+      if(!file) {
+        BOOST_THROW_EXCEPTION(IO::IOException("Unable to create log."));
+      }
+    }
+    auto capacity = std::max(MINIMUM_CAPACITY,
+      static_cast<std::size_t>(std::filesystem::file_size(m_path)));
+    Map(capacity);
+    m_end = Scan(nullptr);
+    m_syncedEnd = m_end;
+    auto remainder = GetData() + m_end;
+    if(std::any_of(remainder, GetData() + GetCapacity(),
+        [] (auto c) { return c != 0; })) {
+      std::memset(remainder, 0, GetCapacity() - m_end);
+      m_region.flush(m_end, GetCapacity() - m_end, false);
+    }
+  }
+
+  template<typename T>
+  WriteAheadLog<T>::~WriteAheadLog() {
+    Sync();
+  }
+
+  template<typename T>
+  const std::filesystem::path& WriteAheadLog<T>::GetPath() const {
+    return m_path;
+  }
+
+  template<typename T>
+  bool WriteAheadLog<T>::IsEmpty() const {
+    return m_end == 0;
+  }
+
+  template<typename T>
+  std::vector<typename WriteAheadLog<T>::Type> WriteAheadLog<T>::Load() const {
+    auto values = std::vector<Type>();
+    Scan(&values);
+    return values;
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Append(const Type& value) {
+    Write(value);
+    TestSync();
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Append(const std::vector<Type>& values) {
+    for(auto& value : values) {
+      Write(value);
+    }
+    TestSync();
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Sync() {
+    if(m_syncedEnd != m_end) {
+      m_region.flush(m_syncedEnd, m_end - m_syncedEnd, false);
+      m_syncedEnd = m_end;
+    }
+    m_lastSync = Clock::now();
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Truncate() {
+    if(m_end == 0) {
+      return;
+    }
+    std::memset(GetData(), 0, m_end);
+    m_region.flush(0, m_end, false);
+    m_end = 0;
+    m_syncedEnd = 0;
+  }
+
+  template<typename T>
+  std::uint32_t WriteAheadLog<T>::ComputeChecksum(const char* data,
+      std::size_t size) {
+    auto crc = boost::crc_32_type();
+    crc.process_bytes(data, size);
+    return crc.checksum();
+  }
+
+  template<typename T>
+  char* WriteAheadLog<T>::GetData() const {
+    return static_cast<char*>(m_region.get_address());
+  }
+
+  template<typename T>
+  std::size_t WriteAheadLog<T>::GetCapacity() const {
+    return m_region.get_size();
+  }
+
+  template<typename T>
+  std::size_t WriteAheadLog<T>::Scan(std::vector<Type>* values) const {
+    auto receiver = Serialization::BinaryReceiver<IO::SharedBuffer>();
+    auto offset = std::size_t(0);
+    while(offset + sizeof(Header) <= GetCapacity()) {
+      auto header = Header();
+      std::memcpy(&header, GetData() + offset, sizeof(Header));
+      auto payload = GetData() + offset + sizeof(Header);
+      if(header.m_size == 0 ||
+          header.m_size > GetCapacity() - offset - sizeof(Header) ||
+          ComputeChecksum(payload, header.m_size) != header.m_checksum) {
+        break;
+      }
+      if(values != nullptr) {
+        auto buffer = IO::SharedBuffer(payload, header.m_size);
+        receiver.SetSource(Ref(buffer));
+        auto value = Type();
+        try {
+          receiver.Shuttle(value);
+        } catch(const Serialization::SerializationException&) {
+          break;
+        }
+        values->push_back(std::move(value));
+      }
+      offset += sizeof(Header) + header.m_size;
+    }
+    return offset;
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Map(std::size_t capacity) {
+    m_region = boost::interprocess::mapped_region();
+    if(std::filesystem::file_size(m_path) < capacity) {
+      std::filesystem::resize_file(m_path, capacity);
+    }
+    m_file = boost::interprocess::file_mapping(m_path.string().c_str(),
+      boost::interprocess::read_write);
+    m_region = boost::interprocess::mapped_region(m_file,
+      boost::interprocess::read_write);
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::Write(const Type& value) {
+    m_buffer.Reset();
+    m_sender.SetSink(Ref(m_buffer));
+    m_sender.Shuttle(value);
+    auto size = m_buffer.GetSize();
+    auto required = m_end + 2 * sizeof(Header) + size;
+    if(required > GetCapacity()) {
+      Sync();
+      auto capacity = GetCapacity();
+      while(capacity < required) {
+        capacity *= 2;
+      }
+      Map(capacity);
+    }
+    auto record = GetData() + m_end;
+    std::memcpy(record + sizeof(Header), m_buffer.GetData(), size);
+    auto header = Header{static_cast<std::uint32_t>(size),
+      ComputeChecksum(m_buffer.GetData(), size)};
+    std::memcpy(record + sizeof(header.m_size), &header.m_checksum,
+      sizeof(header.m_checksum));
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(record, &header.m_size, sizeof(header.m_size));
+    m_end += sizeof(Header) + size;
+  }
+
+  template<typename T>
+  void WriteAheadLog<T>::TestSync() {
+    if(Clock::now() - m_lastSync >= m_syncInterval) {
+      Sync();
+    }
+  }
+}
+
+#endif
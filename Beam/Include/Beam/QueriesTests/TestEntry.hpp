@@ -9,6 +9,8 @@
 #include "Beam/Queries/IndexedValue.hpp"
 #include "Beam/Queries/SequencedValue.hpp"
 #include "Beam/QueriesTests/QueriesTests.hpp"
+#include "Beam/Serialization/DataShuttle.hpp"
+#include "Beam/Serialization/ShuttleDateTime.hpp"
 
 namespace Beam::Queries::Tests {
 
@@ -55,4 +57,16 @@ namespace Beam::Queries::Tests {
   }
 }
 
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Queries::Tests::TestEntry> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle, Queries::Tests::TestEntry& value,
+        unsigned int version) {
+      shuttle.Shuttle("value", value.m_value);
+      shuttle.Shuttle("timestamp", value.m_timestamp);
+    }
+  };
+}
+
 #endif
@@ -6,6 +6,7 @@
 #include <type_traits>
 #include "Beam/IO/Buffer.hpp"
 #include "Beam/Json/JsonParser.hpp"
+#include "Beam/Json/JsonReader.hpp"
 #include "Beam/Serialization/DataShuttle.hpp"
 #include "Beam/Serialization/ReceiverMixin.hpp"
 #include "Beam/Serialization/SerializationException.hpp"
@@ -74,13 +75,12 @@ namespace Serialization {
       using ReceiverMixin<JsonReceiver<SourceType>>::Shuttle;
 
     private:
+      template<typename, typename> friend class JsonSequenceReceiver;
       struct Sequence {
         std::vector<JsonValue> m_list;
         std::size_t m_index;
       };
-      boost::optional<Parsers::ReaderParserStream<IO::BufferReader<Source>>>
-        m_parserStream;
-      JsonParser m_parser;
+      JsonReader m_reader;
       using AggregateType = boost::variant<JsonObject, Sequence>;
       std::deque<AggregateType> m_aggregateQueue;
 
@@ -96,7 +96,7 @@ namespace Serialization {
   template<typename SourceType>
   void JsonReceiver<SourceType>::SetSource(Ref<const Source> source) {
     m_aggregateQueue.clear();
-    m_parserStream.emplace(*source);
+    m_reader.SetSource(source->GetData(), source->GetSize());
   }
 
   template<typename SourceType>
@@ -181,7 +181,7 @@ namespace Serialization {
     boost::optional<JsonValue> storage;
     auto& jsonValue = ExtractValue(name, storage);
     if(auto s = boost::get<std::string>(&jsonValue)) {
-      value = std::move(*s);
+      value = std::move(const_cast<std::string&>(*s));
     } else {
       BOOST_THROW_EXCEPTION(SerializationException{"JSON type mismatch."});
     }
@@ -208,10 +208,14 @@ namespace Serialization {
     boost::optional<JsonValue> storage;
     auto& jsonValue = ExtractValue(name, storage);
     if(auto s = boost::get<JsonObject>(&jsonValue)) {
-      if(!s->Get("__version").is_initialized()) {
-        const_cast<JsonObject&>(*s).Set("__version", 0.0);
+      auto& object = const_cast<JsonObject&>(*s);
+      if(!object.Get("__version").is_initialized()) {
+        object.Set("__version", 0.0);
       }
-      m_aggregateQueue.push_back(*s);
+
+      // Each value is extracted once, so its members are moved rather than
+      // copied into the aggregate.
+      m_aggregateQueue.push_back(std::move(object));
     } else {
       BOOST_THROW_EXCEPTION(SerializationException{"JSON type mismatch."});
     }
@@ -228,7 +232,7 @@ namespace Serialization {
     auto& jsonValue = ExtractValue(name, storage);
     if(auto s = boost::get<std::vector<JsonValue>>(&jsonValue)) {
       Sequence sequence;
-      sequence.m_list = std::move(*s);
+      sequence.m_list = std::move(const_cast<std::vector<JsonValue>&>(*s));
       sequence.m_index = 0;
       size = static_cast<int>(sequence.m_list.size());
       m_aggregateQueue.push_back(std::move(sequence));
@@ -253,7 +257,9 @@ namespace Serialization {
       boost::optional<JsonValue>& storage) {
     if(m_aggregateQueue.empty()) {
       storage.emplace();
-      if(!m_parser.Read(*m_parserStream, *storage)) {
+      try {
+        m_reader.Read(Store(*storage));
+      } catch(const JsonParserException&) {
         BOOST_THROW_EXCEPTION(SerializationException{"Invalid JSON format."});
       }
       return *storage;
@@ -1,39 +1,17 @@
 #ifndef BEAM_JSONSENDER_HPP
 #define BEAM_JSONSENDER_HPP
+#include <charconv>
 #include <cstring>
+#include <string>
 #include <type_traits>
 #include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Json/JsonWriter.hpp"
+#include "Beam/Pointers/Out.hpp"
 #include "Beam/Serialization/DataShuttle.hpp"
 #include "Beam/Serialization/SenderMixin.hpp"
-#include "Beam/Utilities/ToString.hpp"
 
 namespace Beam {
 namespace Serialization {
-namespace Details {
-  inline std::string JsonEscape(const std::string& source) {
-    std::string result;
-    for(auto c : source) {
-      if(c == '\\') {
-        result += "\\\\";
-      } else if(c == '\n') {
-        result += "\\n";
-      } else if(c == '\r') {
-        result += "\\r";
-      } else if(c == '\"') {
-        result += "\\\"";
-      } else if(c == '\b') {
-        result += "\\b";
-      } else if(c == '\f') {
-        result += "\\f";
-      } else if(c == '\t') {
-        result += "\\t";
-      } else {
-        result += c;
-      }
-    }
-    return result;
-  }
-}
 
   /*! \class JsonSender
       \brief Implements a Sender using JSON.
@@ -94,15 +72,23 @@ namespace Details {
     private:
       Sink* m_sink;
       bool m_appendComma;
+
+      void AppendName(const char* name);
   };
 
+  /** Appends the JSON representation of an object to a Buffer. */
+  template<typename T, typename Buffer>
+  void ToJson(const T& object, Out<Buffer> sink) {
+    auto sender = JsonSender<Buffer>();
+    sender.SetSink(Ref(*sink));
+    sender.Send(object);
+  }
+
   /** Converts an object to its JSON representation. */
   template<typename T>
   std::string ToJson(const T& object) {
-    auto sender = JsonSender<IO::SharedBuffer>();
     auto buffer = IO::SharedBuffer();
-    sender.SetSink(Ref(buffer));
-    sender.Send(object);
+    ToJson(object, Store(buffer));
     return std::string(buffer.GetData(), buffer.GetSize());
   }
 
@@ -138,38 +124,28 @@ namespace Details {
       Send(name, static_cast<int>(value));
       return;
     }
-    if(m_appendComma) {
-      m_sink->Append(',');
-    }
-    if(name != nullptr) {
-      m_sink->Append('\"');
-      m_sink->Append(name, std::strlen(name));
-      m_sink->Append('\"');
-      m_sink->Append(':');
-    }
-    auto v = ToString(value);
-    m_sink->Append('\"');
-    m_sink->Append(v.c_str(), v.size());
-    m_sink->Append('\"');
-    m_appendComma = true;
+    AppendName(name);
+    WriteJsonString(&value, 1, Store(*m_sink));
   }
 
   template<typename SinkType>
   template<typename T>
   typename std::enable_if<std::is_fundamental<T>::value>::type
       JsonSender<SinkType>::Send(const char* name, const T& value) {
-    if(m_appendComma) {
-      m_sink->Append(',');
-    }
-    if(name != nullptr) {
-      m_sink->Append('\"');
-      m_sink->Append(name, std::strlen(name));
-      m_sink->Append('\"');
-      m_sink->Append(':');
+    AppendName(name);
+    if constexpr(std::is_same_v<T, bool>) {
+      if(value) {
+        m_sink->Append("true", 4);
+      } else {
+        m_sink->Append("false", 5);
+      }
+    } else if constexpr(std::is_integral_v<T>) {
+      char buffer[24];
+      auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      m_sink->Append(buffer, static_cast<std::size_t>(result.ptr - buffer));
+    } else {
+      WriteJsonNumber(static_cast<double>(value), Store(*m_sink));
     }
-    auto v = ToString(value);
-    m_sink->Append(v.c_str(), v.size());
-    m_appendComma = true;
   }
 
   template<typename SinkType>
@@ -183,40 +159,22 @@ namespace Details {
   template<typename SinkType>
   void JsonSender<SinkType>::Send(const char* name, const std::string& value,
       unsigned int version) {
-    if(m_appendComma) {
-      m_sink->Append(',');
-    }
-    if(name != nullptr) {
-      m_sink->Append('\"');
-      m_sink->Append(name, std::strlen(name));
-      m_sink->Append('\"');
-      m_sink->Append(':');
-    }
-    m_sink->Append('\"');
-    auto escapedValue = Details::JsonEscape(value);
-    m_sink->Append(escapedValue.c_str(), escapedValue.size());
-    m_sink->Append('\"');
-    m_appendComma = true;
+    AppendName(name);
+    WriteJsonString(value, Store(*m_sink));
   }
 
   template<typename SinkType>
   template<std::size_t N>
   void JsonSender<SinkType>::Send(const char* name, const FixedString<N>& value,
       unsigned int version) {
-    Send(name, std::string{value.GetData()});
+    AppendName(name);
+    WriteJsonString(value.GetData(), std::strlen(value.GetData()),
+      Store(*m_sink));
   }
 
   template<typename SinkType>
   void JsonSender<SinkType>::StartStructure(const char* name) {
-    if(m_appendComma) {
-      m_sink->Append(',');
-    }
-    if(name != nullptr) {
-      m_sink->Append('\"');
-      m_sink->Append(name, std::strlen(name));
-      m_sink->Append('\"');
-      m_sink->Append(':');
-    }
+    AppendName(name);
     m_sink->Append('{');
     m_appendComma = false;
   }
@@ -234,15 +192,7 @@ namespace Details {
 
   template<typename SinkType>
   void JsonSender<SinkType>::StartSequence(const char* name) {
-    if(m_appendComma) {
-      m_sink->Append(',');
-    }
-    if(name != nullptr) {
-      m_sink->Append('\"');
-      m_sink->Append(name, std::strlen(name));
-      m_sink->Append('\"');
-      m_sink->Append(':');
-    }
+    AppendName(name);
     m_sink->Append('[');
     m_appendComma = false;
   }
@@ -253,6 +203,18 @@ namespace Details {
     m_appendComma = true;
   }
 
+  template<typename SinkType>
+  void JsonSender<SinkType>::AppendName(const char* name) {
+    if(m_appendComma) {
+      m_sink->Append(',');
+    }
+    m_appendComma = true;
+    if(name != nullptr) {
+      WriteJsonString(name, std::strlen(name), Store(*m_sink));
+      m_sink->Append(':');
+    }
+  }
+
   template<typename SinkType>
   struct Inverse<JsonSender<SinkType>> {
     using type = JsonReceiver<SinkType>;
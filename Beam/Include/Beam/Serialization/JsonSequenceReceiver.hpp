@@ -0,0 +1,109 @@
+#ifndef BEAM_JSONSEQUENCERECEIVER_HPP
+#define BEAM_JSONSEQUENCERECEIVER_HPP
+#include "Beam/IO/Buffer.hpp"
+#include "Beam/Json/JsonParserException.hpp"
+#include "Beam/Pointers/Out.hpp"
+#include "Beam/Pointers/Ref.hpp"
+#include "Beam/Serialization/JsonReceiver.hpp"
+#include "Beam/Serialization/SerializationException.hpp"
+
+namespace Beam {
+namespace Serialization {
+
+  /*! \class JsonSequenceReceiver
+      \brief Receives the elements of a JSON array one at a time.
+      \details Only the element being received is parsed into a JsonValue,
+               so large arrays are deserialized without first building the
+               entire array in memory.
+      \tparam T The type of element to receive.
+      \tparam SourceType The type of Buffer to receive the data from.
+   */
+  template<typename T, typename SourceType>
+  class JsonSequenceReceiver {
+    public:
+      static_assert(ImplementsConcept<SourceType, IO::Buffer>::value,
+        "SourceType must implement the Buffer Concept.");
+
+      using Type = T;
+
+      using Source = SourceType;
+
+      //! Constructs a JsonSequenceReceiver.
+      JsonSequenceReceiver();
+
+      //! Constructs a JsonSequenceReceiver.
+      /*!
+        \param registry The TypeRegistry used for receiving polymorphic types.
+      */
+      JsonSequenceReceiver(
+        Ref<TypeRegistry<JsonSender<SourceType>>> registry);
+
+      //! Sets the Buffer containing the JSON array to receive, the Buffer
+      //! must remain valid while its elements are being received.
+      /*!
+        \param source The Buffer containing the JSON array.
+      */
+      void SetSource(Ref<const Source> source);
+
+      //! Receives the next element of the array.
+      /*!
+        \param value Stores the element that was received.
+        \return <code>true</code> iff an element was received,
+                <code>false</code> iff the end of the array was reached.
+      */
+      bool Receive(Out<T> value);
+
+    private:
+      JsonReceiver<Source> m_receiver;
+      bool m_isEnd;
+  };
+
+  template<typename T, typename SourceType>
+  JsonSequenceReceiver<T, SourceType>::JsonSequenceReceiver()
+      : m_isEnd(true) {}
+
+  template<typename T, typename SourceType>
+  JsonSequenceReceiver<T, SourceType>::JsonSequenceReceiver(
+      Ref<TypeRegistry<JsonSender<SourceType>>> registry)
+      : m_receiver(Ref(registry)),
+        m_isEnd(true) {}
+
+  template<typename T, typename SourceType>
+  void JsonSequenceReceiver<T, SourceType>::SetSource(
+      Ref<const Source> source) {
+    m_receiver.SetSource(Ref(source));
+    try {
+      m_receiver.m_reader.ReadArrayStart();
+    } catch(const JsonParserException&) {
+      m_isEnd = true;
+      BOOST_THROW_EXCEPTION(SerializationException{"JSON type mismatch."});
+    }
+    m_isEnd = false;
+  }
+
+  template<typename T, typename SourceType>
+  bool JsonSequenceReceiver<T, SourceType>::Receive(Out<T> value) {
+    if(m_isEnd) {
+      return false;
+    }
+    try {
+      m_isEnd = !m_receiver.m_reader.ReadArrayNext();
+    } catch(const JsonParserException&) {
+      m_isEnd = true;
+      BOOST_THROW_EXCEPTION(SerializationException{"Invalid JSON format."});
+    }
+    if(m_isEnd) {
+      return false;
+    }
+    try {
+      m_receiver.Shuttle(*value);
+    } catch(const std::exception&) {
+      m_isEnd = true;
+      throw;
+    }
+    return true;
+  }
+}
+}
+
+#endif
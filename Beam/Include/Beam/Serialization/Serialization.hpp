@@ -13,6 +13,7 @@ namespace Serialization {
   template<typename T, typename Enabled> struct IsStructure;
   template<typename SourceType> class JsonReceiver;
   template<typename SinkType> class JsonSender;
+  template<typename T, typename SourceType> class JsonSequenceReceiver;
   template<typename SourceType> struct Receiver;
   template<typename ReceiverType> class ReceiverMixin;
   template<typename SinkType> struct Sender;
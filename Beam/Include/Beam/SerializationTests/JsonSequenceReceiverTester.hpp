@@ -0,0 +1,45 @@
+#ifndef BEAM_JSONSEQUENCERECEIVERTESTER_HPP
+#define BEAM_JSONSEQUENCERECEIVERTESTER_HPP
+#include <cppunit/extensions/HelperMacros.h>
+#include "Beam/SerializationTests/SerializationTests.hpp"
+#include "Beam/Utilities/BeamWorkaround.hpp"
+
+namespace Beam {
+namespace Serialization {
+namespace Tests {
+
+  /*! \class JsonSequenceReceiverTester
+      \brief Tests the JsonSequenceReceiver class.
+   */
+  class JsonSequenceReceiverTester : public CPPUNIT_NS::TestFixture {
+    public:
+
+      //! Tests receiving an empty array.
+      void TestEmptyArray();
+
+      //! Tests receiving the elements of an array sent by a JsonSender.
+      void TestSentArray();
+
+      //! Tests receiving an array of structures.
+      void TestStructures();
+
+      //! Tests receiving a malformed array.
+      void TestMalformedArray();
+
+      //! Tests receiving a value that is not an array.
+      void TestNonArray();
+
+    private:
+      CPPUNIT_TEST_SUITE(JsonSequenceReceiverTester);
+        CPPUNIT_TEST(TestEmptyArray);
+        CPPUNIT_TEST(TestSentArray);
+        CPPUNIT_TEST(TestStructures);
+        CPPUNIT_TEST(TestMalformedArray);
+        CPPUNIT_TEST(TestNonArray);
+      BEAM_CPPUNIT_TEST_SUITE_END();
+  };
+}
+}
+}
+
+#endif
@@ -10,6 +10,7 @@ namespace Tests {
   class ClassWithSendReceiveMethods;
   class ClassWithVersioning;
   template<typename SenderType, typename ReceiverType> class DataShuttleTester;
+  class JsonSequenceReceiverTester;
   class PolymorphicBaseClass;
   class ProxiedFunctionType;
   class ProxiedMethodType;
@@ -107,6 +107,7 @@ namespace Beam::Services {
 
     private:
       mutable boost::mutex m_mutex;
+      boost::mutex m_encoderMutex;
       GetOptionalLocalPtr<ChannelType> m_channel;
       IO::AsyncWriter<typename Channel::Writer*> m_writer;
       LocalPtr<Sender> m_sender;
@@ -165,8 +166,18 @@ namespace Beam::Services {
     }
     auto encoderViewBuffer = IO::BufferView<typename Channel::Writer::Buffer>(
       Ref(*buffer), sizeof(std::uint32_t));
-    auto size = m_encoder->Encode(serializationBuffer,
-      Store(encoderViewBuffer));
+
+    // The encoded message may be sent over other connections, so it can't
+    // depend on this connection's stream.
+    auto size = [&] {
+      if constexpr(Codecs::IsStateful<Encoder>::value) {
+        return m_encoder->EncodeStandalone(serializationBuffer,
+          Store(encoderViewBuffer));
+      } else {
+        return m_encoder->Encode(serializationBuffer,
+          Store(encoderViewBuffer));
+      }
+    }();
     buffer->Write(0, ToLittleEndian<std::uint32_t>(size));
   }
 
@@ -187,6 +198,13 @@ namespace Beam::Services {
       m_sender->SetSink(Ref(senderBuffer));
       m_sender->Send(message);
     }
+
+    // A stateful Encoder's messages must be written in the order they were
+    // encoded.
+    auto encoderLock = boost::unique_lock(m_encoderMutex, boost::defer_lock);
+    if(Codecs::IsStateful<Encoder>::value) {
+      encoderLock.lock();
+    }
     if(Codecs::InPlaceSupport<Encoder>::value) {
       auto senderViewBuffer = IO::BufferView<typename Channel::Writer::Buffer>(
         Ref(senderBuffer), sizeof(std::uint32_t));
@@ -13,6 +13,7 @@
 #include <boost/throw_exception.hpp>
 #include <yaml-cpp/yaml.h>
 #include "Beam/Network/IpAddress.hpp"
+#include "Beam/Network/TcpSocketOptions.hpp"
 #include "Beam/Parsers/DateTimeParser.hpp"
 #include "Beam/Parsers/RationalParser.hpp"
 #include "Beam/Parsers/ReaderParserStream.hpp"
@@ -245,6 +246,32 @@ namespace Beam {
       return Network::IpAddress(host, port);
     }
   };
+
+  template<>
+  struct YamlValueExtractor<Network::TcpSocketOptions> {
+    Network::TcpSocketOptions operator ()(const YAML::Node& node) const {
+      auto options = Network::TcpSocketOptions();
+      options.m_noDelayEnabled = Extract<bool>(node, "no_delay",
+        options.m_noDelayEnabled);
+      options.m_writeBufferSize = Extract<int>(node, "write_buffer_size",
+        options.m_writeBufferSize);
+      options.m_readBufferSize = Extract<int>(node, "read_buffer_size",
+        options.m_readBufferSize);
+      options.m_quickAckEnabled = Extract<bool>(node, "quick_ack",
+        options.m_quickAckEnabled);
+      options.m_busyPollTimeout = Extract<boost::posix_time::time_duration>(
+        node, "busy_poll", options.m_busyPollTimeout);
+      options.m_keepAliveEnabled = Extract<bool>(node, "keep_alive",
+        options.m_keepAliveEnabled);
+      options.m_keepAliveIdle = Extract<boost::posix_time::time_duration>(
+        node, "keep_alive_idle", options.m_keepAliveIdle);
+      options.m_keepAliveInterval = Extract<boost::posix_time::time_duration>(
+        node, "keep_alive_interval", options.m_keepAliveInterval);
+      options.m_keepAliveCount = Extract<int>(node, "keep_alive_count",
+        options.m_keepAliveCount);
+      return options;
+    }
+  };
 }
 
 #endif
@@ -1,10 +1,29 @@
 #ifndef BEAM_FILESTORE_HPP
 #define BEAM_FILESTORE_HPP
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Beam/Codecs/GZipEncoder.hpp"
+#include "Beam/IO/IOException.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Pointers/Out.hpp"
 #include "Beam/WebServices/ContentTypePatterns.hpp"
+#include "Beam/WebServices/HttpContentEncoding.hpp"
+#include "Beam/WebServices/HttpFileBody.hpp"
 #include "Beam/WebServices/HttpRequest.hpp"
 #include "Beam/WebServices/HttpRequestSlot.hpp"
 #include "Beam/WebServices/HttpResponse.hpp"
@@ -12,13 +31,155 @@
 
 namespace Beam {
 namespace WebServices {
+namespace Details {
+
+  /** Stores a byte range requested using the Range header. */
+  struct ByteRange {
+
+    //! The offset of the first byte.
+    std::uint64_t m_offset;
+
+    //! The number of bytes.
+    std::uint64_t m_size;
+  };
+
+  inline bool ParseByteOffset(std::string_view value, std::uint64_t& offset) {
+    if(value.empty() || value.size() > 19) {
+      return false;
+    }
+    offset = 0;
+    for(auto c : value) {
+      if(c < '0' || c > '9') {
+        return false;
+      }
+      offset = 10 * offset + static_cast<std::uint64_t>(c - '0');
+    }
+    return true;
+  }
+
+  //! Parses a Range header selecting a single byte range.
+  /*!
+    \param value The value of the Range header.
+    \param size The size of the representation.
+    \param range Stores the range selected.
+    \return <code>false</code> iff the Range header should be ignored, in
+            which case the entire representation is served. Otherwise
+            <i>range</i> is empty iff the range can't be satisfied.
+  */
+  inline bool ParseByteRange(std::string_view value, std::uint64_t size,
+      boost::optional<ByteRange>& range) {
+    static constexpr auto UNIT = std::string_view("bytes=");
+    if(value.substr(0, UNIT.size()) != UNIT) {
+      return false;
+    }
+    value.remove_prefix(UNIT.size());
+
+    // Requests for multiple ranges are answered with the whole representation
+    // rather than a multipart/byteranges response.
+    if(value.find(',') != std::string_view::npos) {
+      return false;
+    }
+    value = TrimHttpWhitespace(value);
+    auto dash = value.find('-');
+    if(dash == std::string_view::npos) {
+      return false;
+    }
+    auto first = std::uint64_t(0);
+    auto last = std::uint64_t(0);
+    if(dash == 0) {
+      if(!ParseByteOffset(value.substr(1), last)) {
+        return false;
+      }
+      if(last == 0 || size == 0) {
+        range = boost::none;
+      } else {
+        auto length = std::min(last, size);
+        range = ByteRange{size - length, length};
+      }
+      return true;
+    }
+    if(!ParseByteOffset(value.substr(0, dash), first)) {
+      return false;
+    }
+    if(dash == value.size() - 1) {
+      last = size == 0 ? 0 : size - 1;
+    } else if(!ParseByteOffset(value.substr(dash + 1), last)) {
+      return false;
+    } else if(last < first) {
+      return false;
+    }
+    if(first >= size) {
+      range = boost::none;
+    } else {
+      last = std::min(last, size - 1);
+      range = ByteRange{first, last - first + 1};
+    }
+    return true;
+  }
+
+  //! Returns <code>true</code> iff an If-None-Match header matches one of
+  //! two entity tags.
+  inline bool MatchesEntityTag(std::string_view value,
+      std::string_view entityTag, std::string_view alternateEntityTag) {
+    auto isMatch = false;
+    ForEachHttpListElement(value,
+      [&] (std::string_view element) {
+
+        // If-None-Match uses the weak comparison.
+        if(element.substr(0, 2) == "W/") {
+          element.remove_prefix(2);
+        }
+        if(element == "*" || element == entityTag ||
+            element == alternateEntityTag) {
+          isMatch = true;
+        }
+      });
+    return isMatch;
+  }
+
+  //! Formats a time as an HTTP-date, as used by the Last-Modified header.
+  inline std::string FormatHttpDate(std::time_t time) {
+    static const char* DAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri",
+      "Sat"};
+    static const char* MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+      "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    auto timestamp = boost::posix_time::from_time_t(time);
+    auto date = timestamp.date();
+    auto timeOfDay = timestamp.time_of_day();
+    char buffer[32];
+    auto length = std::snprintf(buffer, sizeof(buffer),
+      "%s, %02d %s %04d %02d:%02d:%02d GMT",
+      DAYS[date.day_of_week().as_number()],
+      static_cast<int>(date.day()), MONTHS[date.month() - 1],
+      static_cast<int>(date.year()), static_cast<int>(timeOfDay.hours()),
+      static_cast<int>(timeOfDay.minutes()),
+      static_cast<int>(timeOfDay.seconds()));
+    return std::string(buffer, length);
+  }
+}
 
   /*! \class FileStore
       \brief Handles an HTTP request to serve a file.
+      \details The contents of recently served files are kept in memory, along
+               with a gzip encoding of those whose content type compresses
+               well, and are reloaded whenever a file's modification time or
+               size changes. Files too large to be kept in memory are served
+               as an HttpFileBody, which an HttpServer sends using sendfile
+               where possible. Requests are answered using the ETag and
+               Last-Modified of the file, honouring If-None-Match,
+               If-Modified-Since, Range and Accept-Encoding.
    */
   class FileStore : private boost::noncopyable {
     public:
 
+      //! The default number of bytes of file contents kept in memory.
+      static constexpr auto DEFAULT_CACHE_SIZE =
+        std::size_t(64 * 1024 * 1024);
+
+      //! The default size of the largest file kept in memory.
+      static constexpr auto DEFAULT_MAX_CACHED_FILE_SIZE =
+        std::size_t(1024 * 1024);
+
       //! Constructs a FileStore with a specified path.
       /*!
         \param root The root of the file system.
@@ -33,6 +194,17 @@ namespace WebServices {
       FileStore(std::filesystem::path root,
         ContentTypePatterns contentTypePatterns);
 
+      //! Constructs a FileStore with a specified path.
+      /*!
+        \param root The root of the file system.
+        \param contentTypePatterns The set of patterns to use for content types.
+        \param cacheSize The number of bytes of file contents kept in memory.
+        \param maxCachedFileSize The size of the largest file kept in memory.
+      */
+      FileStore(std::filesystem::path root,
+        ContentTypePatterns contentTypePatterns, std::size_t cacheSize,
+        std::size_t maxCachedFileSize);
+
       //! Serves a file from a specified path.
       /*!
         \param path The path to the file to serve.
@@ -47,6 +219,15 @@ namespace WebServices {
       */
       HttpResponse Serve(const HttpRequest& request);
 
+      //! Serves a file from a specified path in response to an HTTP request.
+      /*!
+        \param path The path to the file to serve.
+        \param request The HTTP request whose headers are honoured.
+        \return The HTTP response containing the file contents.
+      */
+      HttpResponse Serve(const std::filesystem::path& path,
+        const HttpRequest& request);
+
       //! Serves a file from an HTTP request.
       /*!
         \param path The path to the file to serve.
@@ -61,9 +242,44 @@ namespace WebServices {
       */
       void Serve(const HttpRequest& request, Out<HttpResponse> response);
 
+      //! Serves a file from a specified path in response to an HTTP request.
+      /*!
+        \param path The path to the file to serve.
+        \param request The HTTP request whose headers are honoured.
+        \param response Stores the HTTP response containing the file contents.
+      */
+      void Serve(const std::filesystem::path& path, const HttpRequest& request,
+        Out<HttpResponse> response);
+
     private:
+      struct Entry {
+        std::filesystem::path m_path;
+        std::filesystem::file_time_type m_modifiedTime;
+        std::uint64_t m_size;
+        std::string m_contentType;
+        std::string m_entityTag;
+        std::string m_gzipEntityTag;
+        std::string m_lastModified;
+        bool m_isInMemory;
+        IO::SharedBuffer m_contents;
+        IO::SharedBuffer m_gzipContents;
+      };
+      using EntryList = std::list<std::shared_ptr<const Entry>>;
       std::filesystem::path m_root;
       ContentTypePatterns m_contentTypePatterns;
+      std::size_t m_cacheSize;
+      std::size_t m_maxCachedFileSize;
+      boost::mutex m_mutex;
+      std::size_t m_cachedSize;
+      EntryList m_entries;
+      std::unordered_map<std::string, EntryList::iterator> m_index;
+
+      std::shared_ptr<const Entry> Load(const std::filesystem::path& path);
+      std::shared_ptr<Entry> MakeEntry(std::filesystem::path path,
+        std::filesystem::file_time_type modifiedTime, std::uint64_t size);
+      void Insert(const std::string& key, std::shared_ptr<const Entry> entry);
+      void Serve(const std::filesystem::path& path, const HttpRequest* request,
+        Out<HttpResponse> response);
   };
 
   //! Returns an HttpRequestSlot to serve index.html.
@@ -79,19 +295,26 @@ namespace WebServices {
     },
     [&] (const HttpRequest& request) {
       HttpResponse response;
-      fileStore.Serve("index.html", Store(response));
+      fileStore.Serve("index.html", request, Store(response));
       return response;
     }};
   }
 
   inline FileStore::FileStore(std::filesystem::path root)
-      : m_contentTypePatterns{ContentTypePatterns::GetDefaultPatterns()} {
-    m_root = std::filesystem::canonical(std::filesystem::absolute(root));
-  }
+    : FileStore(std::move(root), ContentTypePatterns::GetDefaultPatterns()) {}
+
+  inline FileStore::FileStore(std::filesystem::path root,
+    ContentTypePatterns contentTypePatterns)
+    : FileStore(std::move(root), std::move(contentTypePatterns),
+        DEFAULT_CACHE_SIZE, DEFAULT_MAX_CACHED_FILE_SIZE) {}
 
   inline FileStore::FileStore(std::filesystem::path root,
-      ContentTypePatterns contentTypePatterns)
-      : m_contentTypePatterns{std::move(contentTypePatterns)} {
+      ContentTypePatterns contentTypePatterns, std::size_t cacheSize,
+      std::size_t maxCachedFileSize)
+      : m_contentTypePatterns{std::move(contentTypePatterns)},
+        m_cacheSize{cacheSize},
+        m_maxCachedFileSize{std::min(maxCachedFileSize, cacheSize)},
+        m_cachedSize{0} {
     m_root = std::filesystem::canonical(std::filesystem::absolute(root));
   }
 
@@ -102,36 +325,251 @@ namespace WebServices {
   }
 
   inline HttpResponse FileStore::Serve(const HttpRequest& request) {
-    if(!request.GetUri().GetPath().empty() &&
-        request.GetUri().GetPath()[0] == '/') {
-      return Serve(request.GetUri().GetPath().substr(1));
+    HttpResponse response;
+    Serve(request, Store(response));
+    return response;
+  }
+
+  inline HttpResponse FileStore::Serve(const std::filesystem::path& path,
+      const HttpRequest& request) {
+    HttpResponse response;
+    Serve(path, request, Store(response));
+    return response;
+  }
+
+  inline void FileStore::Serve(const std::filesystem::path& path,
+      Out<HttpResponse> response) {
+    Serve(path, nullptr, Store(response));
+  }
+
+  inline void FileStore::Serve(const HttpRequest& request,
+      Out<HttpResponse> response) {
+    auto& path = request.GetUri().GetPath();
+    if(!path.empty() && path[0] == '/') {
+      Serve(path.substr(1), &request, Store(response));
     } else {
-      return Serve(request.GetUri().GetPath());
+      Serve(path, &request, Store(response));
     }
   }
 
   inline void FileStore::Serve(const std::filesystem::path& path,
-      Out<HttpResponse> response) {
-    std::filesystem::path fullPath = m_root / path;
-    std::ifstream file{fullPath, std::ios::in | std::ios::binary};
+      const HttpRequest& request, Out<HttpResponse> response) {
+    Serve(path, &request, Store(response));
+  }
+
+  inline std::shared_ptr<const FileStore::Entry> FileStore::Load(
+      const std::filesystem::path& path) {
+    auto fullPath = (m_root / path).lexically_normal();
+    auto relativePath = fullPath.lexically_relative(m_root);
+    if(relativePath.empty() || *relativePath.begin() == "..") {
+      return nullptr;
+    }
+    auto error = std::error_code();
+    if(!std::filesystem::is_regular_file(fullPath, error)) {
+      return nullptr;
+    }
+    auto size = std::filesystem::file_size(fullPath, error);
+    if(error) {
+      return nullptr;
+    }
+    auto modifiedTime = std::filesystem::last_write_time(fullPath, error);
+    if(error) {
+      return nullptr;
+    }
+    auto key = fullPath.string();
+    {
+      auto lock = boost::lock_guard<boost::mutex>(m_mutex);
+      auto entry = m_index.find(key);
+      if(entry != m_index.end()) {
+        auto& cachedEntry = *entry->second;
+        if(cachedEntry->m_modifiedTime == modifiedTime &&
+            cachedEntry->m_size == size) {
+          m_entries.splice(m_entries.begin(), m_entries, entry->second);
+          return cachedEntry;
+        }
+        m_cachedSize -= cachedEntry->m_contents.GetSize() +
+          cachedEntry->m_gzipContents.GetSize();
+        m_entries.erase(entry->second);
+        m_index.erase(entry);
+      }
+    }
+    auto entry = MakeEntry(std::move(fullPath), modifiedTime, size);
+    if(entry == nullptr || !entry->m_isInMemory) {
+      return entry;
+    }
+    std::ifstream file{entry->m_path, std::ios::in | std::ios::binary};
     if(!file) {
-      response->SetStatusCode(HttpStatusCode::NOT_FOUND);
+      return nullptr;
+    }
+    entry->m_contents.Grow(static_cast<std::size_t>(size));
+    file.read(entry->m_contents.GetMutableData(),
+      static_cast<std::streamsize>(size));
+    if(static_cast<std::uint64_t>(file.gcount()) != size) {
+
+      // The file changed while being read, it's served as is without being
+      // cached so that the next request reloads it.
+      entry->m_contents.Shrink(static_cast<std::size_t>(size) -
+        static_cast<std::size_t>(file.gcount()));
+      entry->m_size = entry->m_contents.GetSize();
+      return entry;
+    }
+    if(IsCompressible(entry->m_contentType) && size >= 256) {
+      auto encoder = Codecs::GZipEncoder(Z_BEST_COMPRESSION);
+      auto gzipContents = IO::SharedBuffer();
+      encoder.Encode(entry->m_contents, Store(gzipContents));
+      if(gzipContents.GetSize() < size - size / 8) {
+        entry->m_gzipContents = std::move(gzipContents);
+      }
+    }
+    Insert(key, entry);
+    return entry;
+  }
+
+  inline std::shared_ptr<FileStore::Entry> FileStore::MakeEntry(
+      std::filesystem::path path, std::filesystem::file_time_type modifiedTime,
+      std::uint64_t size) {
+    auto entry = std::make_shared<Entry>();
+    entry->m_contentType = m_contentTypePatterns.GetContentType(path);
+    entry->m_path = std::move(path);
+    entry->m_modifiedTime = modifiedTime;
+    entry->m_size = size;
+    char entityTag[64];
+    auto entityTagLength = std::snprintf(entityTag, sizeof(entityTag),
+      "\"%llx-%llx", static_cast<unsigned long long>(size),
+      static_cast<unsigned long long>(modifiedTime.time_since_epoch().count()));
+    entry->m_entityTag.assign(entityTag, entityTagLength);
+    entry->m_gzipEntityTag = entry->m_entityTag + "-gzip\"";
+    entry->m_entityTag += '"';
+
+    // The file clock's epoch is unspecified, so the modification time is
+    // converted relative to the current time.
+    auto systemTime = std::chrono::system_clock::now() +
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+      modifiedTime - std::filesystem::file_time_type::clock::now());
+    entry->m_lastModified = Details::FormatHttpDate(
+      std::chrono::system_clock::to_time_t(systemTime));
+    entry->m_isInMemory = size <= m_maxCachedFileSize;
+    return entry;
+  }
+
+  inline void FileStore::Insert(const std::string& key,
+      std::shared_ptr<const Entry> entry) {
+    auto lock = boost::lock_guard<boost::mutex>(m_mutex);
+    auto existingEntry = m_index.find(key);
+    if(existingEntry != m_index.end()) {
+      m_cachedSize -= (*existingEntry->second)->m_contents.GetSize() +
+        (*existingEntry->second)->m_gzipContents.GetSize();
+      m_entries.erase(existingEntry->second);
+      m_index.erase(existingEntry);
+    }
+    auto size = entry->m_contents.GetSize() + entry->m_gzipContents.GetSize();
+    if(size > m_cacheSize) {
       return;
     }
-    IO::SharedBuffer buffer;
-    buffer.Grow(static_cast<std::size_t>(
-      std::filesystem::file_size(fullPath)));
-    file.read(buffer.GetMutableData(), buffer.GetSize());
-    auto& contentType = m_contentTypePatterns.GetContentType(fullPath);
-    if(!contentType.empty()) {
-      response->SetHeader({"Content-Type", contentType});
+    while(m_cachedSize + size > m_cacheSize) {
+      auto& leastRecentEntry = m_entries.back();
+      m_cachedSize -= leastRecentEntry->m_contents.GetSize() +
+        leastRecentEntry->m_gzipContents.GetSize();
+      m_index.erase(leastRecentEntry->m_path.string());
+      m_entries.pop_back();
     }
-    response->SetBody(std::move(buffer));
+    m_entries.push_front(std::move(entry));
+    m_index.emplace(key, m_entries.begin());
+    m_cachedSize += size;
   }
 
-  inline void FileStore::Serve(const HttpRequest& request,
-      Out<HttpResponse> response) {
-    Serve(request.GetUri().GetPath(), Store(response));
+  inline void FileStore::Serve(const std::filesystem::path& path,
+      const HttpRequest* request, Out<HttpResponse> response) {
+    auto entry = Load(path);
+    if(entry == nullptr) {
+      response->SetStatusCode(HttpStatusCode::NOT_FOUND);
+      return;
+    }
+    if(!entry->m_contentType.empty()) {
+      response->SetHeader({"Content-Type", entry->m_contentType});
+    }
+    auto isGZipAvailable = !entry->m_gzipContents.IsEmpty();
+    if(isGZipAvailable) {
+      response->SetHeader({"Vary", "Accept-Encoding"});
+    }
+    response->SetHeader({"Last-Modified", entry->m_lastModified});
+    response->SetHeader({"Accept-Ranges", "bytes"});
+    auto isGZipAccepted = false;
+    if(request != nullptr && isGZipAvailable) {
+      if(auto acceptEncoding = request->GetHeader("Accept-Encoding")) {
+        isGZipAccepted =
+          Details::GetCodingQuality(*acceptEncoding, "gzip") > 0;
+      }
+    }
+    response->SetHeader({"ETag",
+      isGZipAccepted ? entry->m_gzipEntityTag : entry->m_entityTag});
+    auto range = boost::optional<Details::ByteRange>();
+    auto isRange = false;
+    if(request != nullptr) {
+      if(auto ifNoneMatch = request->GetHeader("If-None-Match")) {
+        if(Details::MatchesEntityTag(*ifNoneMatch, entry->m_entityTag,
+            entry->m_gzipEntityTag)) {
+          response->SetStatusCode(HttpStatusCode::NOT_MODIFIED);
+          return;
+        }
+      } else if(auto ifModifiedSince = request->GetHeader(
+          "If-Modified-Since")) {
+
+        // Clients echo the Last-Modified value, so an exact match suffices.
+        if(*ifModifiedSince == entry->m_lastModified) {
+          response->SetStatusCode(HttpStatusCode::NOT_MODIFIED);
+          return;
+        }
+      }
+      if(auto rangeHeader = request->GetHeader("Range")) {
+        auto ifRange = request->GetHeader("If-Range");
+        if(!ifRange.is_initialized() || *ifRange == entry->m_entityTag ||
+            *ifRange == entry->m_lastModified) {
+          isRange = Details::ParseByteRange(*rangeHeader, entry->m_size,
+            range);
+        }
+      }
+    }
+    if(isRange) {
+
+      // Ranges are always served from the unencoded file.
+      response->SetHeader({"ETag", entry->m_entityTag});
+      if(!range.is_initialized()) {
+        response->SetStatusCode(
+          HttpStatusCode::REQUESTED_RANGE_NOT_SATISFIABLE);
+        response->SetHeader({"Content-Range",
+          "bytes */" + std::to_string(entry->m_size)});
+        return;
+      }
+      response->SetStatusCode(HttpStatusCode::PARTIAL_CONTENT);
+      response->SetHeader({"Content-Range", "bytes " +
+        std::to_string(range->m_offset) + "-" +
+        std::to_string(range->m_offset + range->m_size - 1) + "/" +
+        std::to_string(entry->m_size)});
+    } else {
+      if(isGZipAccepted) {
+        response->SetHeader({"Content-Encoding", "gzip"});
+        response->SetBody(entry->m_gzipContents);
+        return;
+      }
+      range = Details::ByteRange{0, entry->m_size};
+    }
+    if(entry->m_isInMemory) {
+      if(range->m_size == entry->m_size) {
+        response->SetBody(entry->m_contents);
+      } else {
+        response->SetBody(IO::SharedBuffer(entry->m_contents.GetData() +
+          range->m_offset, static_cast<std::size_t>(range->m_size)));
+      }
+    } else {
+      try {
+        response->SetFileBody(std::make_shared<HttpFileBody>(entry->m_path,
+          range->m_offset, range->m_size));
+      } catch(const IO::IOException&) {
+        response->SetStatusCode(HttpStatusCode::NOT_FOUND);
+        response->SetHeader({"Content-Length", "0"});
+      }
+    }
   }
 }
 }
@@ -0,0 +1,226 @@
+#ifndef BEAM_HTTPBODYWRITER_HPP
+#define BEAM_HTTPBODYWRITER_HPP
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/EncoderException.hpp"
+#include "Beam/Codecs/GZipDetails.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Pointers/Out.hpp"
+#include "Beam/WebServices/TransferEncoding.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+namespace Details {
+
+  //! Appends a chunk of a chunked transfer coding to a Buffer.
+  /*!
+    \param chunk The data in the chunk, must not be empty.
+    \param buffer The Buffer to append the chunk to.
+  */
+  template<typename Buffer>
+  void EncodeHttpChunk(const IO::SharedBuffer& chunk, Out<Buffer> buffer) {
+    char header[24];
+    auto length = std::snprintf(header, sizeof(header), "%zx\r\n",
+      chunk.GetSize());
+    buffer->Append(header, static_cast<std::size_t>(length));
+    buffer->Append(chunk);
+    buffer->Append("\r\n", 2);
+  }
+
+  //! Appends the last chunk of a chunked transfer coding to a Buffer.
+  template<typename Buffer>
+  void EncodeLastHttpChunk(Out<Buffer> buffer) {
+    buffer->Append("0\r\n\r\n", 5);
+  }
+}
+
+  /*! \class HttpBodyWriter
+      \brief Writes the body of a streamed HttpResponse as it's produced.
+      \details When the response is compressed, the body forms a single gzip
+               or deflate stream that's flushed on every Write so that each
+               piece reaches the client as soon as it's written.
+   */
+  class HttpBodyWriter : private boost::noncopyable {
+    public:
+
+      //! The function receiving the encoded body, called once per Write.
+      /*!
+        \param data The next part of the encoded body, never empty.
+      */
+      using Sink = std::function<void (const IO::SharedBuffer& data)>;
+
+      //! Constructs an HttpBodyWriter that writes the body as is.
+      /*!
+        \param sink Receives the body.
+      */
+      explicit HttpBodyWriter(Sink sink);
+
+      //! Constructs an HttpBodyWriter.
+      /*!
+        \param sink Receives the encoded body.
+        \param encoding The content coding, one of IDENTITY, GZIP or DEFLATE.
+        \param level The compression level, from Z_BEST_SPEED to
+               Z_BEST_COMPRESSION.
+      */
+      HttpBodyWriter(Sink sink, TransferEncoding encoding, int level);
+
+      //! Returns the content coding.
+      TransferEncoding GetEncoding() const;
+
+      //! Writes the next part of the body, empty parts are ignored.
+      /*!
+        \param data The part of the body to write.
+        \param size The size of the <i>data</i>.
+      */
+      void Write(const void* data, std::size_t size);
+
+      //! Writes the next part of the body, empty parts are ignored.
+      /*!
+        \param data The part of the body to write.
+      */
+      void Write(const IO::SharedBuffer& data);
+
+      //! Writes the next part of the body, empty parts are ignored.
+      /*!
+        \param data The part of the body to write.
+      */
+      void Write(const std::string& data);
+
+      //! Ends the body, writing out the end of the compressed stream.
+      void Close();
+
+    private:
+      struct StreamDeleter {
+        void operator ()(z_stream* stream) const;
+      };
+      Sink m_sink;
+      TransferEncoding m_encoding;
+      std::unique_ptr<z_stream, StreamDeleter> m_stream;
+      bool m_isClosed;
+
+      void Deflate(const void* data, std::size_t size, int flush);
+  };
+
+  inline HttpBodyWriter::HttpBodyWriter(Sink sink)
+    : HttpBodyWriter(std::move(sink), TransferEncoding::IDENTITY,
+        Z_DEFAULT_COMPRESSION) {}
+
+  inline HttpBodyWriter::HttpBodyWriter(Sink sink, TransferEncoding encoding,
+      int level)
+      : m_sink(std::move(sink)),
+        m_encoding(encoding),
+        m_isClosed(false) {
+    if(m_encoding == TransferEncoding::IDENTITY) {
+      return;
+    }
+    auto windowBits = [&] {
+      if(m_encoding == TransferEncoding::GZIP) {
+        return Codecs::Details::GZIP_WINDOW_BITS;
+      } else if(m_encoding == TransferEncoding::DEFLATE) {
+        return MAX_WBITS;
+      }
+      BOOST_THROW_EXCEPTION(Codecs::EncoderException(
+        "Unsupported content coding."));
+    }();
+    auto stream = std::make_unique<z_stream>();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    auto result = deflateInit2(stream.get(), level, Z_DEFLATED, windowBits, 8,
+      Z_DEFAULT_STRATEGY);
+    if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(Codecs::EncoderException("Insufficient memory."));
+    } else if(result != Z_OK) {
+      BOOST_THROW_EXCEPTION(Codecs::EncoderException(
+        "Invalid compression level."));
+    }
+    m_stream.reset(stream.release());
+  }
+
+  inline TransferEncoding HttpBodyWriter::GetEncoding() const {
+    return m_encoding;
+  }
+
+  inline void HttpBodyWriter::Write(const void* data, std::size_t size) {
+    if(size == 0 || m_isClosed) {
+      return;
+    }
+    if(m_stream == nullptr) {
+      auto chunk = IO::SharedBuffer(static_cast<const char*>(data), size);
+      m_sink(chunk);
+      return;
+    }
+    Deflate(data, size, Z_SYNC_FLUSH);
+  }
+
+  inline void HttpBodyWriter::Write(const IO::SharedBuffer& data) {
+    if(data.IsEmpty() || m_isClosed) {
+      return;
+    }
+    if(m_stream == nullptr) {
+      m_sink(data);
+      return;
+    }
+    Deflate(data.GetData(), data.GetSize(), Z_SYNC_FLUSH);
+  }
+
+  inline void HttpBodyWriter::Write(const std::string& data) {
+    Write(data.data(), data.size());
+  }
+
+  inline void HttpBodyWriter::Close() {
+    if(m_isClosed) {
+      return;
+    }
+    m_isClosed = true;
+    if(m_stream != nullptr) {
+      Deflate(nullptr, 0, Z_FINISH);
+    }
+  }
+
+  inline void HttpBodyWriter::StreamDeleter::operator ()(
+      z_stream* stream) const {
+    deflateEnd(stream);
+    delete stream;
+  }
+
+  inline void HttpBodyWriter::Deflate(const void* data, std::size_t size,
+      int flush) {
+    auto encoded = IO::SharedBuffer();
+    auto encodedSize = std::size_t(0);
+    m_stream->next_in = static_cast<Bytef*>(const_cast<void*>(data));
+    m_stream->avail_in = static_cast<uInt>(size);
+    while(true) {
+      encoded.Grow(std::max<std::size_t>(encodedSize,
+        deflateBound(m_stream.get(), static_cast<uLong>(size))));
+      m_stream->next_out =
+        reinterpret_cast<Bytef*>(encoded.GetMutableData() + encodedSize);
+      m_stream->avail_out = static_cast<uInt>(encoded.GetSize() - encodedSize);
+      auto result = deflate(m_stream.get(), flush);
+      encodedSize = encoded.GetSize() - m_stream->avail_out;
+      if(result == Z_STREAM_ERROR) {
+        m_isClosed = true;
+        BOOST_THROW_EXCEPTION(Codecs::EncoderException("Unknown error."));
+      }
+
+      // The output is complete once deflate leaves space unused, or for the
+      // end of the stream, once it reports the stream's end.
+      if(flush == Z_FINISH ? result == Z_STREAM_END :
+          m_stream->avail_out != 0) {
+        break;
+      }
+    }
+    encoded.Shrink(encoded.GetSize() - encodedSize);
+    m_sink(encoded);
+  }
+}
+}
+
+#endif
@@ -1,12 +1,26 @@
 #ifndef BEAM_HTTPCLIENT_HPP
 #define BEAM_HTTPCLIENT_HPP
+#include <algorithm>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
-#include "Beam/Network/IpAddress.hpp"
+#include <boost/optional/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/Pointers/Dereference.hpp"
+#include "Beam/Threading/ConditionVariable.hpp"
+#include "Beam/Threading/Mutex.hpp"
+#include "Beam/WebServices/HttpClientOptions.hpp"
 #include "Beam/WebServices/HttpRequest.hpp"
 #include "Beam/WebServices/HttpResponseParser.hpp"
+#include "Beam/WebServices/InvalidHttpResponseException.hpp"
 #include "Beam/WebServices/WebServices.hpp"
 #include "Beam/WebServices/Uri.hpp"
 
@@ -15,6 +29,14 @@ namespace WebServices {
 
   /*! \class HttpClient
       \brief A client that can submit HTTP requests to a server.
+      \details Requests can be sent concurrently from any number of Routines.
+               Each host is served by a pool of keep-alive connections, a
+               request goes to an idle connection, or a new one while the
+               host has fewer than the maximum, and otherwise is pipelined
+               behind the requests already sent on the least busy
+               connection. Requests using a method that isn't idempotent are
+               never pipelined. Idempotent requests are resent on another
+               connection if theirs closes before they're answered.
       \tparam ChannelType The type Channel used to connect to the server.
    */
   template<typename ChannelType>
@@ -37,6 +59,16 @@ namespace WebServices {
       */
       HttpClient(ChannelBuilder channelBuilder);
 
+      //! Constructs an HttpClient.
+      /*!
+        \param channelBuilder Builds the Channel used to connect to the server.
+        \param options The limits and settings of the client.
+      */
+      HttpClient(ChannelBuilder channelBuilder,
+        const HttpClientOptions& options);
+
+      ~HttpClient();
+
       //! Sends a request.
       /*!
         \param request The HttpRequest to send.
@@ -45,105 +77,335 @@ namespace WebServices {
       HttpResponse Send(const HttpRequest& request);
 
     private:
-      struct ChannelEntry {
-        Network::IpAddress m_endPoint;
+      enum class Outcome {
+        RESPONDED,
+        CLOSED,
+        WRITE_FAILED,
+        READ_FAILED
+      };
+      struct Connection : private boost::noncopyable {
         ChannelType m_channel;
+        HttpResponseParser m_parser;
+        Threading::Mutex m_writeMutex;
+        Threading::Mutex m_mutex;
+        Threading::ConditionVariable m_turnCondition;
+        std::uint64_t m_nextTicket;
+        std::uint64_t m_servingTicket;
+        bool m_isOpen;
+        std::size_t m_requestCount;
+        bool m_isExclusive;
+        bool m_isReusable;
+        boost::posix_time::ptime m_lastUseTime;
 
-        ChannelEntry(Network::IpAddress endPoint, ChannelType channel);
+        Connection(ChannelType channel);
       };
-      std::unordered_map<std::string, std::vector<Cookie>> m_cookies;
+      struct Host {
+        std::vector<std::shared_ptr<Connection>> m_connections;
+        std::size_t m_openingCount;
+
+        Host();
+      };
+      static constexpr auto MAX_RETRIES = 2;
       ChannelBuilder m_channelBuilder;
-      boost::optional<ChannelEntry> m_channel;
+      HttpClientOptions m_options;
+      Threading::Mutex m_mutex;
+      Threading::ConditionVariable m_connectionAvailableCondition;
+      std::unordered_map<std::string, std::vector<Cookie>> m_cookies;
+      std::unordered_map<std::string, Host> m_hosts;
+
+      std::shared_ptr<Connection> Acquire(const std::string& key,
+        const Uri& uri, bool isIdempotent, bool& isNew);
+      void Release(const std::string& key,
+        const std::shared_ptr<Connection>& connection, bool isReusable);
+      Outcome Exchange(Connection& connection, const HttpRequest& request,
+        boost::optional<HttpResponse>& response, std::uint64_t& ticket,
+        std::exception_ptr& error);
+      static bool IsKeepAlive(const HttpRequest& request,
+        const HttpResponse& response);
+      void Break(Connection& connection);
   };
 
   template<typename ChannelType>
-  HttpClient<ChannelType>::ChannelEntry::ChannelEntry(
-      Network::IpAddress endPoint, ChannelType channel)
-      : m_endPoint{std::move(endPoint)},
-        m_channel{std::move(channel)} {}
+  HttpClient<ChannelType>::Connection::Connection(ChannelType channel)
+      : m_channel{std::move(channel)},
+        m_nextTicket{0},
+        m_servingTicket{0},
+        m_isOpen{true},
+        m_requestCount{0},
+        m_isExclusive{false},
+        m_isReusable{true} {}
+
+  template<typename ChannelType>
+  HttpClient<ChannelType>::Host::Host()
+      : m_openingCount{0} {}
 
   template<typename ChannelType>
   HttpClient<ChannelType>::HttpClient(ChannelBuilder channelBuilder)
-      : m_channelBuilder{std::move(channelBuilder)} {}
+      : HttpClient{std::move(channelBuilder), HttpClientOptions()} {}
+
+  template<typename ChannelType>
+  HttpClient<ChannelType>::HttpClient(ChannelBuilder channelBuilder,
+      const HttpClientOptions& options)
+      : m_channelBuilder{std::move(channelBuilder)},
+        m_options{options} {
+    m_options.m_maxConnections = std::max<std::size_t>(
+      m_options.m_maxConnections, 1);
+    m_options.m_maxPipelinedRequests = std::max<std::size_t>(
+      m_options.m_maxPipelinedRequests, 1);
+  }
+
+  template<typename ChannelType>
+  HttpClient<ChannelType>::~HttpClient() {
+    for(auto& host : m_hosts) {
+      for(auto& connection : host.second.m_connections) {
+        connection->m_channel->GetConnection().Close();
+      }
+    }
+  }
 
   template<typename ChannelType>
   HttpResponse HttpClient<ChannelType>::Send(const HttpRequest& request) {
-    auto endPoint = Network::IpAddress{
-      request.GetUri().GetHostname(), request.GetUri().GetPort()};
-    auto isNewChannel = false;
-    auto& hostCookies = m_cookies[request.GetUri().GetHostname()];
+    auto& uri = request.GetUri();
+    auto key = uri.GetScheme() + "://" + uri.GetHostname() + ":" +
+      std::to_string(uri.GetPort());
     boost::optional<HttpRequest> cookieRequest;
-    auto& properRequest =
-      [&] () -> const HttpRequest& {
-        if(hostCookies.empty()) {
-          return request;
-        }
+    {
+      boost::lock_guard<Threading::Mutex> lock{m_mutex};
+      auto& hostCookies = m_cookies[uri.GetHostname()];
+      if(!hostCookies.empty()) {
         cookieRequest.emplace(request);
         for(auto& hostCookie : hostCookies) {
           cookieRequest->Add(hostCookie);
         }
-        return *cookieRequest;
-      }();
-    if(!m_channel.is_initialized() || m_channel->m_endPoint != endPoint) {
-      m_channel.reset();
-      auto channel = m_channelBuilder(request.GetUri());
-      channel->GetConnection().Open();
-      m_channel.emplace(endPoint, std::move(channel));
-      isNewChannel = true;
+      }
     }
-    {
-      typename Channel::Writer::Buffer writeBuffer;
-      properRequest.Encode(Store(writeBuffer));
+    auto& properRequest = cookieRequest.is_initialized() ? *cookieRequest :
+      request;
+    auto method = request.GetMethod();
+    auto isIdempotent = method != HttpMethod::POST &&
+      method != HttpMethod::PATCH && method != HttpMethod::CONNECT;
+    auto retries = 0;
+    while(true) {
+      auto isNew = false;
+      auto connection = Acquire(key, uri, isIdempotent, isNew);
+      auto response = boost::optional<HttpResponse>();
+      auto ticket = std::uint64_t(0);
+      auto error = std::exception_ptr();
+      auto outcome = Outcome::CLOSED;
       try {
-        m_channel->m_channel->GetWriter().Write(writeBuffer);
+        outcome = Exchange(*connection, properRequest, response, ticket,
+          error);
       } catch(const std::exception&) {
-        m_channel.reset();
-        if(isNewChannel) {
+        Release(key, connection, false);
+        throw;
+      }
+      if(outcome == Outcome::RESPONDED) {
+        Release(key, connection, IsKeepAlive(request, *response));
+        boost::lock_guard<Threading::Mutex> lock{m_mutex};
+        auto& hostCookies = m_cookies[uri.GetHostname()];
+        for(auto& cookie : response->GetCookies()) {
+          auto hostCookie = std::find_if(hostCookies.begin(),
+            hostCookies.end(),
+            [&] (const Cookie& value) {
+              return value.GetName() == cookie.GetName();
+            });
+          if(hostCookie == hostCookies.end()) {
+            hostCookies.push_back(cookie);
+          } else {
+            hostCookie->SetValue(cookie.GetValue());
+          }
+        }
+        return std::move(*response);
+      }
+      Release(key, connection, false);
+
+      // A request queued behind one that closed the connection was never
+      // looked at by the server, and is always resent.
+      if(outcome == Outcome::CLOSED) {
+        continue;
+      }
+
+      // A failure on the first request of a new connection is taken to be
+      // the server's, otherwise the connection most likely went stale.
+      auto isResendable = (outcome == Outcome::WRITE_FAILED ||
+        isIdempotent) && !(isNew && ticket == 0);
+      if(!isResendable || retries == MAX_RETRIES) {
+        if(error == nullptr) {
+          BOOST_THROW_EXCEPTION(IO::EndOfFileException());
+        }
+        std::rethrow_exception(error);
+      }
+      ++retries;
+    }
+  }
+
+  template<typename ChannelType>
+  std::shared_ptr<typename HttpClient<ChannelType>::Connection>
+      HttpClient<ChannelType>::Acquire(const std::string& key, const Uri& uri,
+      bool isIdempotent, bool& isNew) {
+    boost::unique_lock<Threading::Mutex> lock{m_mutex};
+    auto& host = m_hosts[key];
+    while(true) {
+      auto now = boost::posix_time::microsec_clock::universal_time();
+      host.m_connections.erase(std::remove_if(host.m_connections.begin(),
+        host.m_connections.end(),
+        [&] (const std::shared_ptr<Connection>& connection) {
+          if(connection->m_requestCount != 0 ||
+              now - connection->m_lastUseTime < m_options.m_idleTimeout) {
+            return false;
+          }
+          connection->m_channel->GetConnection().Close();
+          return true;
+        }), host.m_connections.end());
+      auto connection = std::shared_ptr<Connection>();
+      for(auto& candidate : host.m_connections) {
+        if(candidate->m_isReusable && candidate->m_requestCount == 0) {
+          connection = candidate;
+          break;
+        }
+      }
+      if(connection == nullptr && host.m_connections.size() +
+          host.m_openingCount < m_options.m_maxConnections) {
+        ++host.m_openingCount;
+        try {
+          auto release = Threading::Release(lock);
+          auto channel = m_channelBuilder(uri);
+          channel->GetConnection().Open();
+          connection = std::make_shared<Connection>(std::move(channel));
+        } catch(const std::exception&) {
+          --host.m_openingCount;
+          m_connectionAvailableCondition.notify_all();
           throw;
         }
-        Send(request);
+        --host.m_openingCount;
+        host.m_connections.push_back(connection);
+        isNew = true;
+      }
+      if(connection == nullptr && isIdempotent) {
+        for(auto& candidate : host.m_connections) {
+          if(candidate->m_isReusable && !candidate->m_isExclusive &&
+              candidate->m_requestCount < m_options.m_maxPipelinedRequests &&
+              (connection == nullptr ||
+              candidate->m_requestCount < connection->m_requestCount)) {
+            connection = candidate;
+          }
+        }
+      }
+      if(connection != nullptr) {
+        ++connection->m_requestCount;
+        connection->m_isExclusive = !isIdempotent;
+        return connection;
       }
+      m_connectionAvailableCondition.wait(lock);
     }
-    HttpResponseParser parser;
-    auto response = parser.GetNextResponse();
-    while(!response.is_initialized()) {
-      typename Channel::Reader::Buffer readBuffer;
+  }
+
+  template<typename ChannelType>
+  void HttpClient<ChannelType>::Release(const std::string& key,
+      const std::shared_ptr<Connection>& connection, bool isReusable) {
+    boost::lock_guard<Threading::Mutex> lock{m_mutex};
+    --connection->m_requestCount;
+    connection->m_isExclusive = false;
+    connection->m_lastUseTime =
+      boost::posix_time::microsec_clock::universal_time();
+    if(!isReusable && connection->m_isReusable) {
+      connection->m_isReusable = false;
+      auto& connections = m_hosts[key].m_connections;
+      connections.erase(std::remove(connections.begin(), connections.end(),
+        connection), connections.end());
+    }
+    m_connectionAvailableCondition.notify_all();
+  }
+
+  template<typename ChannelType>
+  typename HttpClient<ChannelType>::Outcome
+      HttpClient<ChannelType>::Exchange(
+      Connection& connection, const HttpRequest& request,
+      boost::optional<HttpResponse>& response, std::uint64_t& ticket,
+      std::exception_ptr& error) {
+    typename Channel::Writer::Buffer writeBuffer;
+    request.Encode(Store(writeBuffer));
+    {
+
+      // Tickets are handed out in the order requests are written so that
+      // responses are read in the same order.
+      boost::lock_guard<Threading::Mutex> writeLock{connection.m_writeMutex};
+      {
+        boost::lock_guard<Threading::Mutex> lock{connection.m_mutex};
+        if(!connection.m_isOpen) {
+          return Outcome::CLOSED;
+        }
+        ticket = connection.m_nextTicket;
+        ++connection.m_nextTicket;
+      }
       try {
-        m_channel->m_channel->GetReader().Read(Store(readBuffer));
+        connection.m_channel->GetWriter().Write(writeBuffer);
       } catch(const std::exception&) {
-        m_channel.reset();
-        throw;
+        error = std::current_exception();
+        Break(connection);
+        return Outcome::WRITE_FAILED;
       }
-      parser.Feed(readBuffer.GetData(), readBuffer.GetSize());
-      response = parser.GetNextResponse();
     }
-    auto connectionHeader = response->GetHeader("Connection");
-    if(!connectionHeader.is_initialized()) {
-      if(response->GetVersion() == HttpVersion::Version1_0()) {
-        m_channel->m_channel->GetConnection().Close();
-        m_channel.reset();
+    {
+      boost::unique_lock<Threading::Mutex> lock{connection.m_mutex};
+      while(connection.m_servingTicket != ticket && connection.m_isOpen) {
+        connection.m_turnCondition.wait(lock);
       }
-    } else {
-      if(!boost::iequals(*connectionHeader, "keep-alive")) {
-        m_channel->m_channel->GetConnection().Close();
-        m_channel.reset();
+      if(!connection.m_isOpen) {
+        return Outcome::CLOSED;
       }
     }
-    auto& cookies = response->GetCookies();
-    for(auto& cookie : cookies) {
-      auto isFound = false;
-      for(auto& hostCookie : hostCookies) {
-        if(hostCookie.GetName() == cookie.GetName()) {
-          hostCookie.SetValue(cookie.GetValue());
-          isFound = true;
-          break;
-        }
-      }
-      if(!isFound) {
-        hostCookies.push_back(cookie);
+    try {
+      response = connection.m_parser.GetNextResponse();
+      while(!response.is_initialized()) {
+        typename Channel::Reader::Buffer readBuffer;
+        connection.m_channel->GetReader().Read(Store(readBuffer));
+        connection.m_parser.Feed(readBuffer.GetData(), readBuffer.GetSize());
+        response = connection.m_parser.GetNextResponse();
       }
+    } catch(const InvalidHttpResponseException&) {
+      Break(connection);
+      throw;
+    } catch(const std::exception&) {
+      error = std::current_exception();
+      Break(connection);
+      return Outcome::READ_FAILED;
+    }
+
+    // The connection is broken before the turn is handed over so that the
+    // requests pipelined behind this one are resent rather than read from a
+    // connection the server is closing.
+    if(!IsKeepAlive(request, *response)) {
+      Break(connection);
+      return Outcome::RESPONDED;
+    }
+    boost::lock_guard<Threading::Mutex> lock{connection.m_mutex};
+    ++connection.m_servingTicket;
+    connection.m_turnCondition.notify_all();
+    return Outcome::RESPONDED;
+  }
+
+  template<typename ChannelType>
+  bool HttpClient<ChannelType>::IsKeepAlive(const HttpRequest& request,
+      const HttpResponse& response) {
+    if(request.GetSpecialHeaders().m_connection == ConnectionHeader::CLOSE) {
+      return false;
+    }
+    auto connectionHeader = response.GetHeader("Connection");
+    if(!connectionHeader.is_initialized()) {
+      return !(response.GetVersion() == HttpVersion::Version1_0());
+    }
+    return boost::iequals(*connectionHeader, "keep-alive");
+  }
+
+  template<typename ChannelType>
+  void HttpClient<ChannelType>::Break(Connection& connection) {
+    {
+      boost::lock_guard<Threading::Mutex> lock{connection.m_mutex};
+      connection.m_isOpen = false;
+      connection.m_turnCondition.notify_all();
     }
-    return *response;
+    connection.m_channel->GetConnection().Close();
   }
 }
 }
@@ -0,0 +1,45 @@
+#ifndef BEAM_HTTPCLIENTOPTIONS_HPP
+#define BEAM_HTTPCLIENTOPTIONS_HPP
+#include <cstddef>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \struct HttpClientOptions
+      \brief Stores the limits and settings of an HttpClient.
+   */
+  struct HttpClientOptions {
+
+    //! The default maximum number of connections to a single host.
+    static constexpr auto DEFAULT_MAX_CONNECTIONS = std::size_t(8);
+
+    //! The default maximum number of requests awaiting a response on a
+    //! single connection.
+    static constexpr auto DEFAULT_MAX_PIPELINED_REQUESTS = std::size_t(8);
+
+    //! The maximum number of connections to a single host, once reached
+    //! requests are pipelined onto the open connections.
+    std::size_t m_maxConnections;
+
+    //! The maximum number of requests awaiting a response on a single
+    //! connection, 1 disables pipelining.
+    std::size_t m_maxPipelinedRequests;
+
+    //! How long a connection can go unused before it's closed rather than
+    //! reused.
+    boost::posix_time::time_duration m_idleTimeout;
+
+    //! Constructs HttpClientOptions using the defaults.
+    HttpClientOptions();
+  };
+
+  inline HttpClientOptions::HttpClientOptions()
+    : m_maxConnections(DEFAULT_MAX_CONNECTIONS),
+      m_maxPipelinedRequests(DEFAULT_MAX_PIPELINED_REQUESTS),
+      m_idleTimeout(boost::posix_time::seconds(30)) {}
+}
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef BEAM_HTTPCONTENTENCODING_HPP
+#define BEAM_HTTPCONTENTENCODING_HPP
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include "Beam/WebServices/TransferEncoding.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+namespace Details {
+  inline std::string_view TrimHttpWhitespace(std::string_view value) {
+    while(!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+      value.remove_prefix(1);
+    }
+    while(!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+      value.remove_suffix(1);
+    }
+    return value;
+  }
+
+  //! Calls a function with every element of a comma separated header value.
+  template<typename F>
+  void ForEachHttpListElement(std::string_view value, F&& f) {
+    while(!value.empty()) {
+      auto delimiter = value.find(',');
+      auto element = TrimHttpWhitespace(value.substr(0, delimiter));
+      if(!element.empty()) {
+        f(element);
+      }
+      if(delimiter == std::string_view::npos) {
+        break;
+      }
+      value.remove_prefix(delimiter + 1);
+    }
+  }
+
+  //! Returns the quality an Accept-Encoding header assigns to a coding.
+  /*!
+    \param value The value of the Accept-Encoding header.
+    \param coding The lower case name of the coding.
+    \return The quality of the <i>coding</i>, falling back to the quality of
+            <code>*</code>, or 0 if neither is listed.
+  */
+  inline double GetCodingQuality(std::string_view value,
+      std::string_view coding) {
+    auto quality = -1.0;
+    auto wildcardQuality = 0.0;
+    ForEachHttpListElement(value,
+      [&] (std::string_view element) {
+        auto parameters = element.find(';');
+        auto name = TrimHttpWhitespace(element.substr(0, parameters));
+        auto isWildcard = name == "*";
+        if(!isWildcard && (name.size() != coding.size() ||
+            !std::equal(name.begin(), name.end(), coding.begin(),
+              [] (char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == b;
+              }))) {
+          return;
+        }
+        auto elementQuality = 1.0;
+        if(parameters != std::string_view::npos) {
+          auto parameter = TrimHttpWhitespace(element.substr(parameters + 1));
+          if(parameter.size() >= 2 && (parameter[0] == 'q' ||
+              parameter[0] == 'Q') && parameter[1] == '=') {
+            auto text = std::string(parameter.substr(2));
+            elementQuality = std::strtod(text.c_str(), nullptr);
+          }
+        }
+        if(isWildcard) {
+          wildcardQuality = elementQuality;
+        } else {
+          quality = elementQuality;
+        }
+      });
+    if(quality < 0) {
+      return wildcardQuality;
+    }
+    return quality;
+  }
+}
+
+  //! Selects the content coding to compress a response with.
+  /*!
+    \param acceptEncoding The value of the request's Accept-Encoding header.
+    \return GZIP or DEFLATE, whichever the client prefers with gzip winning
+            ties, or IDENTITY if the client accepts neither.
+  */
+  inline TransferEncoding SelectContentEncoding(
+      std::string_view acceptEncoding) {
+    auto gzipQuality = Details::GetCodingQuality(acceptEncoding, "gzip");
+    auto deflateQuality = Details::GetCodingQuality(acceptEncoding,
+      "deflate");
+    if(gzipQuality > 0 && gzipQuality >= deflateQuality) {
+      return TransferEncoding::GZIP;
+    } else if(deflateQuality > 0) {
+      return TransferEncoding::DEFLATE;
+    }
+    return TransferEncoding::IDENTITY;
+  }
+
+  //! Returns <code>true</code> iff a content type is worth compressing.
+  /*!
+    \param contentType The value of a Content-Type header.
+  */
+  inline bool IsCompressible(std::string_view contentType) {
+    return contentType.substr(0, 5) == "text/" ||
+      contentType.find("javascript") != std::string_view::npos ||
+      contentType.find("json") != std::string_view::npos ||
+      contentType.find("xml") != std::string_view::npos;
+  }
+}
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef BEAM_HTTPFILEBODY_HPP
+#define BEAM_HTTPFILEBODY_HPP
+#include <cstdint>
+#include <filesystem>
+#include <boost/noncopyable.hpp>
+#include <boost/throw_exception.hpp>
+#include "Beam/IO/IOException.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Pointers/Out.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+#ifdef _WIN32
+  #include <fstream>
+#else
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \class HttpFileBody
+      \brief A range of a file sent as the body of an HttpResponse without
+             being loaded into memory.
+      \details The file is opened on construction so that the range sent is
+               the one found when the response was made, even if the file is
+               replaced in the meantime.
+   */
+  class HttpFileBody : private boost::noncopyable {
+    public:
+
+      //! Constructs an HttpFileBody.
+      /*!
+        \param path The path to the file.
+        \param offset The offset of the first byte to send.
+        \param size The number of bytes to send.
+      */
+      HttpFileBody(const std::filesystem::path& path, std::uint64_t offset,
+        std::uint64_t size);
+
+      ~HttpFileBody();
+
+#ifndef _WIN32
+      //! Returns the file descriptor.
+      int GetDescriptor() const;
+#endif
+
+      //! Returns the offset of the first byte to send.
+      std::uint64_t GetOffset() const;
+
+      //! Returns the number of bytes to send.
+      std::uint64_t GetSize() const;
+
+      //! Appends part of the range to a Buffer.
+      /*!
+        \param offset The offset within the range of the first byte to read.
+        \param size The number of bytes to read.
+        \param buffer The Buffer to append to.
+      */
+      template<typename Buffer>
+      void Read(std::uint64_t offset, std::size_t size,
+        Out<Buffer> buffer) const;
+
+    private:
+#ifdef _WIN32
+      std::filesystem::path m_path;
+#else
+      int m_descriptor;
+#endif
+      std::uint64_t m_offset;
+      std::uint64_t m_size;
+  };
+
+  inline HttpFileBody::HttpFileBody(const std::filesystem::path& path,
+      std::uint64_t offset, std::uint64_t size)
+      : m_offset(offset),
+        m_size(size) {
+#ifdef _WIN32
+    m_path = path;
+#else
+    m_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(m_descriptor == -1) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Unable to open file."));
+    }
+#endif
+  }
+
+  inline HttpFileBody::~HttpFileBody() {
+#ifndef _WIN32
+    ::close(m_descriptor);
+#endif
+  }
+
+#ifndef _WIN32
+  inline int HttpFileBody::GetDescriptor() const {
+    return m_descriptor;
+  }
+#endif
+
+  inline std::uint64_t HttpFileBody::GetOffset() const {
+    return m_offset;
+  }
+
+  inline std::uint64_t HttpFileBody::GetSize() const {
+    return m_size;
+  }
+
+  template<typename Buffer>
+  void HttpFileBody::Read(std::uint64_t offset, std::size_t size,
+      Out<Buffer> buffer) const {
+    auto contents = IO::SharedBuffer(size);
+    auto data = contents.GetMutableData();
+#ifdef _WIN32
+    std::ifstream file(m_path, std::ios::in | std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(m_offset + offset));
+    file.read(data, static_cast<std::streamsize>(size));
+    if(static_cast<std::size_t>(file.gcount()) != size) {
+      BOOST_THROW_EXCEPTION(IO::IOException("File truncated."));
+    }
+#else
+    auto remaining = size;
+    while(remaining != 0) {
+      auto result = ::pread(m_descriptor, data, remaining,
+        static_cast<off_t>(m_offset + offset));
+      if(result == -1 && errno == EINTR) {
+        continue;
+      } else if(result <= 0) {
+        BOOST_THROW_EXCEPTION(IO::IOException("File truncated."));
+      }
+      data += result;
+      offset += result;
+      remaining -= static_cast<std::size_t>(result);
+    }
+#endif
+    buffer->Append(contents);
+  }
+}
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef BEAM_HTTPREQUESTPARSER_HPP
 #define BEAM_HTTPREQUESTPARSER_HPP
 #include <deque>
+#include <limits>
 #include <boost/algorithm/string.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/optional/optional.hpp>
@@ -23,7 +24,15 @@ namespace WebServices {
       //! Constructs an HttpRequestParser.
       HttpRequestParser();
 
-      //! Feeds the parser additional characters to parse.
+      //! Constructs an HttpRequestParser that rejects large headers.
+      /*!
+        \param maxHeaderSize The largest size of a request line and its
+               headers.
+      */
+      explicit HttpRequestParser(std::size_t maxHeaderSize);
+
+      //! Feeds the parser additional characters to parse, which may contain
+      //! any number of pipelined requests.
       /*!
         \param c The first character to feed.
         \param size The number of characters to feed.
@@ -41,6 +50,8 @@ namespace WebServices {
         ERR
       };
       ParserState m_parserState;
+      std::size_t m_maxHeaderSize;
+      std::size_t m_headerSize;
       HttpMethod m_method;
       boost::optional<Uri> m_uri;
       HttpVersion m_version;
@@ -59,60 +70,81 @@ namespace WebServices {
   };
 
   inline HttpRequestParser::HttpRequestParser()
-      : m_parserState{ParserState::METHOD} {}
+      : HttpRequestParser{std::numeric_limits<std::size_t>::max()} {}
+
+  inline HttpRequestParser::HttpRequestParser(std::size_t maxHeaderSize)
+      : m_parserState{ParserState::METHOD},
+        m_maxHeaderSize{maxHeaderSize},
+        m_headerSize{0} {}
 
   inline void HttpRequestParser::Feed(const char* c, std::size_t size) {
     const auto LINE_LENGTH = 2;
-    if(m_parserState == ParserState::METHOD) {
-      auto end = static_cast<const char*>(std::memchr(c, '\r', size));
-      if(end == nullptr) {
-        m_buffer.Append(c, size);
-        return;
-      }
-      if(m_buffer.IsEmpty()) {
-        ParseMethod(c, (end - c));
-      } else {
-        m_buffer.Append(c, end - c);
-        ParseMethod(m_buffer.GetData(), m_buffer.GetSize());
-        m_buffer.Reset();
-      }
-      if(m_parserState == ParserState::ERR) {
-        return;
-      }
-      size -= (end - c) + 1;
-      c = end + 1;
-      m_parserState = ParserState::HEADER;
-    }
-    while(m_parserState == ParserState::HEADER) {
-      if(size == 0) {
-        return;
-      }
-      auto end = static_cast<const char*>(std::memchr(c, '\r', size));
-      if(end == nullptr) {
-        m_buffer.Append(c, size);
-        return;
-      } else if(end == c + 1) {
-        ++c;
-        --size;
-        m_parserState = ParserState::BODY;
-        break;
-      }
-      if(m_buffer.IsEmpty()) {
-        ParseHeader(c, (end - c));
-      } else {
-        m_buffer.Append(c, end - c);
-        ParseHeader(m_buffer.GetData(), m_buffer.GetSize());
-        m_buffer.Reset();
+    while(true) {
+      if(m_parserState == ParserState::METHOD) {
+        auto end = static_cast<const char*>(std::memchr(c, '\r', size));
+        if(end == nullptr) {
+          m_buffer.Append(c, size);
+          if(m_buffer.GetSize() > m_maxHeaderSize) {
+            m_parserState = ParserState::ERR;
+          }
+          return;
+        }
+        m_headerSize = m_buffer.GetSize() + (end - c) + 1;
+        if(m_headerSize > m_maxHeaderSize) {
+          m_parserState = ParserState::ERR;
+          return;
+        }
+        if(m_buffer.IsEmpty()) {
+          ParseMethod(c, (end - c));
+        } else {
+          m_buffer.Append(c, end - c);
+          ParseMethod(m_buffer.GetData(), m_buffer.GetSize());
+          m_buffer.Reset();
+        }
+        if(m_parserState == ParserState::ERR) {
+          return;
+        }
+        size -= (end - c) + 1;
+        c = end + 1;
+        m_parserState = ParserState::HEADER;
       }
-      if(m_parserState == ParserState::ERR) {
-        return;
+      while(m_parserState == ParserState::HEADER) {
+        if(size == 0) {
+          return;
+        }
+        auto end = static_cast<const char*>(std::memchr(c, '\r', size));
+        if(end == nullptr) {
+          m_buffer.Append(c, size);
+          if(m_headerSize + m_buffer.GetSize() > m_maxHeaderSize) {
+            m_parserState = ParserState::ERR;
+          }
+          return;
+        } else if(end == c + 1) {
+          ++c;
+          --size;
+          m_parserState = ParserState::BODY;
+          break;
+        }
+        m_headerSize += m_buffer.GetSize() + (end - c) + 1;
+        if(m_headerSize > m_maxHeaderSize) {
+          m_parserState = ParserState::ERR;
+          return;
+        }
+        if(m_buffer.IsEmpty()) {
+          ParseHeader(c, (end - c));
+        } else {
+          m_buffer.Append(c, end - c);
+          ParseHeader(m_buffer.GetData(), m_buffer.GetSize());
+          m_buffer.Reset();
+        }
+        if(m_parserState == ParserState::ERR) {
+          return;
+        }
+        size -= (end - c) + 1;
+        c = end + 1;
+        m_parserState = ParserState::HEADER;
       }
-      size -= (end - c) + 1;
-      c = end + 1;
-      m_parserState = ParserState::HEADER;
-    }
-    if(m_parserState == ParserState::BODY) {
-      if(size == 0) {
+      if(m_parserState != ParserState::BODY || size == 0) {
         return;
       }
       if(m_buffer.GetSize() + size <
@@ -143,12 +175,12 @@ namespace WebServices {
       m_headers.clear();
       m_cookies.clear();
       m_body.Reset();
+      m_headerSize = 0;
       m_parserState = ParserState::METHOD;
-      if(size != 0) {
-        m_buffer.Append(c, size);
-        auto tempBuffer = std::move(m_buffer);
-        m_buffer = IO::SharedBuffer{};
-        Feed(tempBuffer.GetData(), tempBuffer.GetSize());
+
+      // Pipelined requests are parsed in place rather than copied.
+      if(size == 0) {
+        return;
       }
     }
   }
@@ -185,7 +217,7 @@ namespace WebServices {
       return;
     }
     try {
-      m_uri.emplace(c, uriEnd);
+      m_uri.emplace(c, uriEnd, Uri::Mode::LENIENT);
     } catch(const MalformedUriException&) {
       m_parserState = ParserState::ERR;
       return;
@@ -1,6 +1,8 @@
 #ifndef BEAM_HTTPREQUESTSLOT_HPP
 #define BEAM_HTTPREQUESTSLOT_HPP
 #include <functional>
+#include <boost/optional/optional.hpp>
+#include "Beam/WebServices/HttpRoute.hpp"
 #include "Beam/WebServices/WebServices.hpp"
 
 namespace Beam {
@@ -31,17 +33,34 @@ namespace WebServices {
     //! The slot to call if the predicate matches.
     Slot m_slot;
 
+    //! The route the predicate tests, if the slot was constructed from one.
+    boost::optional<HttpRoute> m_route;
+
     //! Constructs an HttpRequestSlot.
     /*!
       \param predicate The predicate that must be satisfied.
       \param slot The slot to call if the <i>predicate</i> is satisfied.
     */
     HttpRequestSlot(Predicate predicate, Slot slot);
+
+    //! Constructs an HttpRequestSlot from a route.
+    /*!
+      \param route The route handled by the <i>slot</i>.
+      \param slot The slot to call if the <i>route</i> matches.
+    */
+    HttpRequestSlot(HttpRoute route, Slot slot);
   };
 
   inline HttpRequestSlot::HttpRequestSlot(Predicate predicate, Slot slot)
       : m_predicate{std::move(predicate)},
         m_slot{std::move(slot)} {}
+
+  inline HttpRequestSlot::HttpRequestSlot(HttpRoute route, Slot slot)
+      : m_predicate{[=] (const HttpRequest& request) {
+          return route.Test(request);
+        }},
+        m_slot{std::move(slot)},
+        m_route{std::move(route)} {}
 }
 }
 
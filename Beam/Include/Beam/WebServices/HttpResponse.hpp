@@ -1,9 +1,15 @@
 #ifndef BEAM_HTTPRESPONSE_HPP
 #define BEAM_HTTPRESPONSE_HPP
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <vector>
+#include <boost/optional/optional.hpp>
 #include "Beam/IO/BufferOutputStream.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/WebServices/Cookie.hpp"
+#include "Beam/WebServices/HttpBodyWriter.hpp"
+#include "Beam/WebServices/HttpFileBody.hpp"
 #include "Beam/WebServices/HttpHeader.hpp"
 #include "Beam/WebServices/HttpStatusCode.hpp"
 #include "Beam/WebServices/HttpVersion.hpp"
@@ -18,6 +24,12 @@ namespace WebServices {
   class HttpResponse {
     public:
 
+      //! Produces the body of a streamed response.
+      /*!
+        \param writer The HttpBodyWriter to write the body to.
+      */
+      using BodyStream = std::function<void (HttpBodyWriter& writer)>;
+
       //! Constructs an HttpResponse with a status of OK.
       HttpResponse();
 
@@ -91,7 +103,35 @@ namespace WebServices {
       //! Sets the body.
       void SetBody(IO::SharedBuffer body);
 
-      //! Outputs this response into a Buffer.
+      //! Returns the file sent as the body, if any.
+      const std::shared_ptr<const HttpFileBody>& GetFileBody() const;
+
+      //! Sets the body to a range of a file, replacing any in-memory body.
+      /*!
+        \param body The range of the file to send.
+      */
+      void SetFileBody(std::shared_ptr<const HttpFileBody> body);
+
+      //! Returns the function producing a streamed body, if any.
+      const BodyStream& GetBodyStream() const;
+
+      //! Sets the body to one produced as it's sent using the chunked
+      //! transfer coding, replacing any other body.
+      /*!
+        \param stream The function producing the body, called once the
+               status line and headers have been sent.
+      */
+      void SetBodyStream(BodyStream stream);
+
+      //! Outputs this response's status line and headers into a Buffer.
+      /*!
+        \param buffer The Buffer to output the status line and headers to.
+      */
+      template<typename Buffer>
+      void EncodeHeader(Out<Buffer> buffer) const;
+
+      //! Outputs this response into a Buffer, producing the entire body of
+      //! a streamed response.
       /*!
         \param buffer The Buffer to output this response to.
       */
@@ -104,6 +144,10 @@ namespace WebServices {
       std::vector<HttpHeader> m_headers;
       std::vector<Cookie> m_cookies;
       IO::SharedBuffer m_body;
+      std::shared_ptr<const HttpFileBody> m_fileBody;
+      BodyStream m_bodyStream;
+
+      void RemoveHeader(const std::string& name);
   };
 
   inline std::ostream& operator <<(std::ostream& sink,
@@ -211,11 +255,40 @@ namespace WebServices {
 
   inline void HttpResponse::SetBody(IO::SharedBuffer body) {
     m_body = std::move(body);
+    m_fileBody.reset();
+    m_bodyStream = nullptr;
+    RemoveHeader("Transfer-Encoding");
     SetHeader({"Content-Length", std::to_string(m_body.GetSize())});
   }
 
+  inline const std::shared_ptr<const HttpFileBody>&
+      HttpResponse::GetFileBody() const {
+    return m_fileBody;
+  }
+
+  inline void HttpResponse::SetFileBody(
+      std::shared_ptr<const HttpFileBody> body) {
+    m_body = IO::SharedBuffer();
+    m_fileBody = std::move(body);
+    m_bodyStream = nullptr;
+    RemoveHeader("Transfer-Encoding");
+    SetHeader({"Content-Length", std::to_string(m_fileBody->GetSize())});
+  }
+
+  inline const HttpResponse::BodyStream& HttpResponse::GetBodyStream() const {
+    return m_bodyStream;
+  }
+
+  inline void HttpResponse::SetBodyStream(BodyStream stream) {
+    m_body = IO::SharedBuffer();
+    m_fileBody.reset();
+    m_bodyStream = std::move(stream);
+    RemoveHeader("Content-Length");
+    SetHeader({"Transfer-Encoding", "chunked"});
+  }
+
   template<typename Buffer>
-  void HttpResponse::Encode(Out<Buffer> buffer) const {
+  void HttpResponse::EncodeHeader(Out<Buffer> buffer) const {
     char conversionBuffer[64];
     IO::BufferOutputStream<Buffer> bufferOutputStream{Ref(*buffer)};
     bufferOutputStream << m_version;
@@ -236,7 +309,32 @@ namespace WebServices {
       buffer->Append("\r\n", 2);
     }
     buffer->Append("\r\n", 2);
-    buffer->Append(m_body);
+  }
+
+  template<typename Buffer>
+  void HttpResponse::Encode(Out<Buffer> buffer) const {
+    EncodeHeader(Store(buffer));
+    if(m_bodyStream) {
+      auto writer = HttpBodyWriter(
+        [&] (const IO::SharedBuffer& data) {
+          Details::EncodeHttpChunk(data, Store(buffer));
+        });
+      m_bodyStream(writer);
+      writer.Close();
+      Details::EncodeLastHttpChunk(Store(buffer));
+    } else if(m_fileBody != nullptr) {
+      m_fileBody->Read(0, static_cast<std::size_t>(m_fileBody->GetSize()),
+        Store(buffer));
+    } else {
+      buffer->Append(m_body);
+    }
+  }
+
+  inline void HttpResponse::RemoveHeader(const std::string& name) {
+    m_headers.erase(std::remove_if(m_headers.begin(), m_headers.end(),
+      [&] (const HttpHeader& header) {
+        return header.GetName() == name;
+      }), m_headers.end());
   }
 }
 }
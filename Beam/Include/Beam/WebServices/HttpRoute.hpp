@@ -0,0 +1,93 @@
+#ifndef BEAM_HTTPROUTE_HPP
+#define BEAM_HTTPROUTE_HPP
+#include <string>
+#include "Beam/WebServices/HttpMethod.hpp"
+#include "Beam/WebServices/HttpRequest.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \struct HttpRoute
+      \brief Specifies the method and URI path of the requests handled by an
+             HttpRequestSlot, allowing an HttpServer to look the slot up rather
+             than test its predicate.
+   */
+  struct HttpRoute {
+
+    /*! \enum Match
+        \brief Enumerates how a route's path is matched.
+     */
+    enum class Match {
+
+      //! The URI path must equal the route's path.
+      EXACT,
+
+      //! The route's path must be a prefix of the URI path made up of whole
+      //! segments, so that /static matches /static and /static/app.js but
+      //! not /statics, and / matches every path.
+      PREFIX
+    };
+
+    //! The HttpMethod to match.
+    HttpMethod m_method;
+
+    //! The path to match.
+    std::string m_path;
+
+    //! How the path is matched.
+    Match m_match;
+
+    //! Constructs an HttpRoute matching a path exactly.
+    /*!
+      \param method The HttpMethod to match.
+      \param path The URI path to match.
+    */
+    HttpRoute(HttpMethod method, std::string path);
+
+    //! Constructs an HttpRoute.
+    /*!
+      \param method The HttpMethod to match.
+      \param path The path to match.
+      \param match How the <i>path</i> is matched.
+    */
+    HttpRoute(HttpMethod method, std::string path, Match match);
+
+    //! Tests whether a request is handled by this route.
+    /*!
+      \param request The HttpRequest to test.
+      \return <code>true</code> iff the <i>request</i> matches this route.
+    */
+    bool Test(const HttpRequest& request) const;
+  };
+
+  inline HttpRoute::HttpRoute(HttpMethod method, std::string path)
+      : HttpRoute{method, std::move(path), Match::EXACT} {}
+
+  inline HttpRoute::HttpRoute(HttpMethod method, std::string path,
+      Match match)
+      : m_method{method},
+        m_path{std::move(path)},
+        m_match{match} {
+    if(m_match == Match::PREFIX) {
+      while(!m_path.empty() && m_path.back() == '/') {
+        m_path.pop_back();
+      }
+    }
+  }
+
+  inline bool HttpRoute::Test(const HttpRequest& request) const {
+    if(request.GetMethod() != m_method) {
+      return false;
+    }
+    auto& path = request.GetUri().GetPath();
+    if(m_match == Match::EXACT) {
+      return path == m_path;
+    }
+    return m_path.empty() || (path.compare(0, m_path.size(), m_path) == 0 &&
+      (path.size() == m_path.size() || path[m_path.size()] == '/'));
+  }
+}
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef BEAM_HTTPROUTER_HPP
+#define BEAM_HTTPROUTER_HPP
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "Beam/WebServices/HttpRequest.hpp"
+#include "Beam/WebServices/HttpRequestSlot.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \class HttpRouter
+      \brief Finds the HttpRequestSlot handling a request.
+      \details Slots constructed from an HttpRoute are indexed by their path,
+               exact paths in a hash table and prefixes in a trie of path
+               segments, so finding them doesn't depend on how many slots
+               there are. Slots with only a predicate are tested in order.
+               Either way the first slot in the list given to the router that
+               matches a request is the one returned, just as if every
+               predicate had been tested in order.
+   */
+  class HttpRouter : private boost::noncopyable {
+    public:
+
+      //! Constructs an HttpRouter.
+      /*!
+        \param slots The slots to route requests to, in order of precedence.
+      */
+      explicit HttpRouter(std::vector<HttpRequestSlot> slots);
+
+      //! Returns the slot handling a request, or <code>nullptr</code> if no
+      //! slot matches.
+      /*!
+        \param request The request to route.
+      */
+      const HttpRequestSlot* Find(const HttpRequest& request) const;
+
+    private:
+      struct PrefixNode {
+        std::vector<std::size_t> m_slots;
+        std::map<std::string, PrefixNode, std::less<>> m_children;
+      };
+      std::vector<HttpRequestSlot> m_slots;
+      std::unordered_map<std::string, std::vector<std::size_t>> m_exactSlots;
+      PrefixNode m_prefixSlots;
+      std::vector<std::size_t> m_predicateSlots;
+
+      void Find(const std::vector<std::size_t>& slots, HttpMethod method,
+        std::size_t& index) const;
+  };
+
+  inline HttpRouter::HttpRouter(std::vector<HttpRequestSlot> slots)
+      : m_slots{std::move(slots)} {
+    for(auto i = std::size_t(0); i != m_slots.size(); ++i) {
+      auto& route = m_slots[i].m_route;
+      if(!route.is_initialized() || (route->m_match ==
+          HttpRoute::Match::PREFIX && !route->m_path.empty() &&
+          route->m_path[0] != '/')) {
+        m_predicateSlots.push_back(i);
+      } else if(route->m_match == HttpRoute::Match::EXACT) {
+        m_exactSlots[route->m_path].push_back(i);
+      } else {
+        auto node = &m_prefixSlots;
+        auto segment = route->m_path.c_str();
+        auto end = segment + route->m_path.size();
+        while(segment != end) {
+          ++segment;
+          auto segmentEnd = static_cast<const char*>(
+            std::memchr(segment, '/', end - segment));
+          if(segmentEnd == nullptr) {
+            segmentEnd = end;
+          }
+          node = &node->m_children[std::string{segment, segmentEnd}];
+          segment = segmentEnd;
+        }
+        node->m_slots.push_back(i);
+      }
+    }
+  }
+
+  inline const HttpRequestSlot* HttpRouter::Find(
+      const HttpRequest& request) const {
+    auto index = m_slots.size();
+    auto method = request.GetMethod();
+    auto& path = request.GetUri().GetPath();
+    auto exactSlots = m_exactSlots.find(path);
+    if(exactSlots != m_exactSlots.end()) {
+      Find(exactSlots->second, method, index);
+    }
+    auto node = &m_prefixSlots;
+    Find(node->m_slots, method, index);
+    if(!path.empty() && path[0] == '/') {
+      auto segment = path.c_str();
+      auto end = segment + path.size();
+      while(segment != end) {
+        ++segment;
+        auto segmentEnd = static_cast<const char*>(
+          std::memchr(segment, '/', end - segment));
+        if(segmentEnd == nullptr) {
+          segmentEnd = end;
+        }
+        auto child = node->m_children.find(
+          std::string_view{segment, static_cast<std::size_t>(
+          segmentEnd - segment)});
+        if(child == node->m_children.end()) {
+          break;
+        }
+        node = &child->second;
+        Find(node->m_slots, method, index);
+        segment = segmentEnd;
+      }
+    }
+    for(auto slot : m_predicateSlots) {
+      if(slot >= index) {
+        break;
+      }
+      if(m_slots[slot].m_predicate(request)) {
+        index = slot;
+        break;
+      }
+    }
+    if(index == m_slots.size()) {
+      return nullptr;
+    }
+    return &m_slots[index];
+  }
+
+  inline void HttpRouter::Find(const std::vector<std::size_t>& slots,
+      HttpMethod method, std::size_t& index) const {
+    for(auto slot : slots) {
+      if(slot >= index) {
+        return;
+      }
+      if(m_slots[slot].m_route->m_method == method) {
+        index = slot;
+        return;
+      }
+    }
+  }
+}
+}
+
+#endif
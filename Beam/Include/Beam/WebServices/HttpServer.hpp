@@ -1,29 +1,64 @@
 #ifndef BEAM_HTTPSERVER_HPP
 #define BEAM_HTTPSERVER_HPP
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
 #include "Beam/IO/Buffer.hpp"
+#include "Beam/IO/ChainedBuffer.hpp"
 #include "Beam/IO/EndOfFileException.hpp"
 #include "Beam/IO/OpenState.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Pointers/Dereference.hpp"
 #include "Beam/Pointers/LocalPtr.hpp"
+#include "Beam/Queues/Queue.hpp"
 #include "Beam/Routines/RoutineHandler.hpp"
 #include "Beam/Routines/RoutineHandlerGroup.hpp"
+#include "Beam/Codecs/GZipEncoder.hpp"
+#include "Beam/Codecs/ZLibEncoder.hpp"
 #include "Beam/Serialization/JsonSender.hpp"
+#include "Beam/Threading/ConditionVariable.hpp"
+#include "Beam/Threading/Mutex.hpp"
 #include "Beam/Utilities/SynchronizedSet.hpp"
+#include "Beam/WebServices/HttpBodyWriter.hpp"
+#include "Beam/WebServices/HttpContentEncoding.hpp"
 #include "Beam/WebServices/HttpRequestParser.hpp"
 #include "Beam/WebServices/HttpRequestSlot.hpp"
 #include "Beam/WebServices/HttpResponse.hpp"
+#include "Beam/WebServices/HttpRouter.hpp"
+#include "Beam/WebServices/HttpServerOptions.hpp"
 #include "Beam/WebServices/HttpUpgradeSlot.hpp"
 #include "Beam/WebServices/WebSocketChannel.hpp"
 #include "Beam/WebServices/WebServices.hpp"
 
 namespace Beam {
 namespace WebServices {
+namespace Details {
+  template<typename Writer, typename = void>
+  struct HasSendFile : std::false_type {};
+
+  template<typename Writer>
+  struct HasSendFile<Writer, std::void_t<decltype(std::declval<Writer&>().
+    SendFile(0, std::uint64_t(0), std::uint64_t(0)))>> : std::true_type {};
+}
 
   /*! \class HttpServer
       \brief Implements an HTTP server.
+      \details Each connection is served by a Routine that, once the
+               connection closes, goes on to serve the next accepted
+               connection. Pipelined requests are handled in order and the
+               responses to all the requests received in a single read are
+               written together. Responses whose body is an HttpFileBody are
+               written using sendfile when the Channel's Writer supports it,
+               and otherwise in segments read from the file. Bodies whose
+               content type compresses well are compressed using gzip or
+               deflate when the client accepts it, and streamed bodies are
+               sent using the chunked transfer coding, or buffered for
+               HTTP/1.0 clients.
       \tparam ServerConnectionType The type of ServerConnection accepting
               Channels.
    */
@@ -69,6 +104,29 @@ namespace WebServices {
         std::vector<HttpRequestSlot> slots,
         std::vector<WebSocketSlot> webSocketSlots);
 
+      //! Constructs an HttpServer.
+      /*!
+        \param serverConnection Initializes the ServerConnection.
+        \param slots The slots handling the HttpServerRequests.
+        \param options The limits and settings of the server.
+      */
+      template<typename ServerConnectionForward>
+      HttpServer(ServerConnectionForward&& serverConnection,
+        std::vector<HttpRequestSlot> slots, const HttpServerOptions& options);
+
+      //! Constructs an HttpServer.
+      /*!
+        \param serverConnection Initializes the ServerConnection.
+        \param slots The slots handling the HttpServerRequests.
+        \param webSocketSlots The slots handling WebSocket upgrade requests.
+        \param options The limits and settings of the server.
+      */
+      template<typename ServerConnectionForward>
+      HttpServer(ServerConnectionForward&& serverConnection,
+        std::vector<HttpRequestSlot> slots,
+        std::vector<WebSocketSlot> webSocketSlots,
+        const HttpServerOptions& options);
+
       ~HttpServer();
 
       void Open();
@@ -76,21 +134,46 @@ namespace WebServices {
       void Close();
 
     private:
+
+      //! The size of the segments an HttpFileBody is read in when it can't be
+      //! sent using sendfile.
+      static constexpr auto FILE_SEGMENT_SIZE = std::size_t(256 * 1024);
       typename Channel::Writer::Buffer BAD_REQUEST_RESPONSE_BUFFER;
       typename Channel::Writer::Buffer NOT_FOUND_RESPONSE_BUFFER;
       GetOptionalLocalPtr<ServerConnectionType> m_serverConnection;
-      std::vector<HttpRequestSlot> m_slots;
+      HttpRouter m_router;
       std::vector<WebSocketSlot> m_webSocketSlots;
+      HttpServerOptions m_options;
+      SynchronizedUnorderedSet<std::shared_ptr<Channel>> m_clients;
+      Queue<std::shared_ptr<Channel>> m_connections;
+      Threading::Mutex m_mutex;
+      bool m_isClosing;
+      std::size_t m_connectionCount;
+      std::size_t m_idleRoutineCount;
+      Threading::ConditionVariable m_connectionClosedCondition;
+      Routines::RoutineHandlerGroup m_connectionRoutines;
       Routines::RoutineHandler m_acceptRoutine;
       IO::OpenState m_openState;
 
+      static HttpResponse MakeServerErrorResponse(const std::exception& e);
       void Shutdown();
       void AcceptLoop();
+      void ConnectionLoop();
+      void ServeConnection(const std::shared_ptr<Channel>& channel);
       bool UpgradeConnection(const HttpRequest& request,
         const std::shared_ptr<Channel>& channel,
-        typename Channel::Writer::Buffer& responseBuffer);
+        IO::ChainedBuffer& responseBuffer);
       bool HandleHttpRequest(const HttpRequest& request, Channel& channel,
-        typename Channel::Writer::Buffer& responseBuffer);
+        IO::ChainedBuffer& responseBuffer);
+      TransferEncoding NegotiateEncoding(const HttpRequest& request,
+        HttpResponse& response) const;
+      void CompressBody(TransferEncoding encoding,
+        HttpResponse& response) const;
+      void WriteFileResponse(const HttpResponse& response, Channel& channel,
+        IO::ChainedBuffer& responseBuffer);
+      void WriteStreamResponse(const HttpResponse& response,
+        TransferEncoding encoding, Channel& channel,
+        IO::ChainedBuffer& responseBuffer);
   };
 
   template<typename ServerConnectionType>
@@ -107,10 +190,42 @@ namespace WebServices {
       ServerConnectionForward&& serverConnection,
       std::vector<HttpRequestSlot> slots,
       std::vector<WebSocketSlot> webSocketSlots)
+      : HttpServer{std::forward<ServerConnectionForward>(serverConnection),
+          std::move(slots), std::move(webSocketSlots), HttpServerOptions()} {}
+
+  template<typename ServerConnectionType>
+  template<typename ServerConnectionForward>
+  HttpServer<ServerConnectionType>::HttpServer(
+      ServerConnectionForward&& serverConnection,
+      std::vector<HttpRequestSlot> slots, const HttpServerOptions& options)
+      : HttpServer{std::forward<ServerConnectionForward>(serverConnection),
+          std::move(slots), std::vector<WebSocketSlot>(), options} {}
+
+  template<typename ServerConnectionType>
+  template<typename ServerConnectionForward>
+  HttpServer<ServerConnectionType>::HttpServer(
+      ServerConnectionForward&& serverConnection,
+      std::vector<HttpRequestSlot> slots,
+      std::vector<WebSocketSlot> webSocketSlots,
+      const HttpServerOptions& options)
       : m_serverConnection{std::forward<ServerConnectionForward>(
           serverConnection)},
-        m_slots{std::move(slots)},
-        m_webSocketSlots{std::move(webSocketSlots)} {
+        m_router{std::move(slots)},
+        m_webSocketSlots{std::move(webSocketSlots)},
+        m_options{options},
+        m_isClosing{false},
+        m_connectionCount{0},
+        m_idleRoutineCount{0} {
+    m_options.m_compressionLevel = std::clamp(m_options.m_compressionLevel,
+      0, 9);
+    auto& deflate = m_options.m_webSocketDeflate;
+    deflate.m_compressionLevel = std::clamp(deflate.m_compressionLevel, 0, 9);
+    deflate.m_serverMaxWindowBits = std::clamp(deflate.m_serverMaxWindowBits,
+      WebSocketDeflateOptions::MIN_WINDOW_BITS,
+      WebSocketDeflateOptions::MAX_WINDOW_BITS);
+    deflate.m_clientMaxWindowBits = std::clamp(deflate.m_clientMaxWindowBits,
+      WebSocketDeflateOptions::MIN_WINDOW_BITS,
+      WebSocketDeflateOptions::MAX_WINDOW_BITS);
     HttpResponse badRequestResponse{HttpStatusCode::BAD_REQUEST};
     badRequestResponse.Encode(Store(BAD_REQUEST_RESPONSE_BUFFER));
     HttpResponse notFoundResponse{HttpStatusCode::NOT_FOUND};
@@ -146,18 +261,39 @@ namespace WebServices {
     Shutdown();
   }
 
+  template<typename ServerConnectionType>
+  HttpResponse HttpServer<ServerConnectionType>::MakeServerErrorResponse(
+      const std::exception& e) {
+    auto response = HttpResponse(HttpStatusCode::INTERNAL_SERVER_ERROR);
+    response.SetHeader({"Content-Type", "application/json"});
+    Serialization::JsonSender<IO::SharedBuffer> jsonSender;
+    response.SetBody(Serialization::Encode<IO::SharedBuffer>(jsonSender,
+      std::string{e.what()}));
+    return response;
+  }
+
   template<typename ServerConnectionType>
   void HttpServer<ServerConnectionType>::Shutdown() {
     m_serverConnection->Close();
+    {
+      boost::lock_guard<Threading::Mutex> lock{m_mutex};
+      m_isClosing = true;
+      m_connectionClosedCondition.notify_all();
+    }
     m_acceptRoutine.Wait();
     m_openState.SetClosed();
   }
 
   template<typename ServerConnectionType>
   void HttpServer<ServerConnectionType>::AcceptLoop() {
-    SynchronizedUnorderedSet<std::shared_ptr<Channel>> clients;
-    Routines::RoutineHandlerGroup clientRoutines;
     while(true) {
+      {
+        boost::unique_lock<Threading::Mutex> lock{m_mutex};
+        while(m_connectionCount >= m_options.m_maxConnections &&
+            !m_isClosing) {
+          m_connectionClosedCondition.wait(lock);
+        }
+      }
       std::shared_ptr<Channel> channel;
       try {
         channel = m_serverConnection->Accept();
@@ -167,63 +303,110 @@ namespace WebServices {
         std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
         continue;
       }
-      clients.Insert(channel);
-      clientRoutines.Spawn(
-        [=, &clients] {
-          try {
-            channel->GetConnection().Open();
-          } catch(const std::exception&) {
-            std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
-            clients.Erase(channel);
-            return;
-          }
-          HttpRequestParser parser;
-          typename Channel::Reader::Buffer requestBuffer;
-          typename Channel::Writer::Buffer responseBuffer;
-          try {
-            while(true) {
-              channel->GetReader().Read(Store(requestBuffer));
-              parser.Feed(requestBuffer.GetData(), requestBuffer.GetSize());
-              requestBuffer.Reset();
-              auto request = parser.GetNextRequest();
-              while(request.is_initialized()) {
-                std::cout << *request << "\n\n\n" << std::flush;
-                responseBuffer.Reset();
-                if(request->GetSpecialHeaders().m_connection ==
-                    ConnectionHeader::UPGRADE) {
-                  auto wasUpgraded = UpgradeConnection(*request, channel,
-                    responseBuffer);
-                  if(wasUpgraded) {
-                    clients.Erase(channel);
-                    return;
-                  }
-                } else {
-                  auto keepAlive = HandleHttpRequest(*request, *channel,
-                    responseBuffer);
-                  if(!keepAlive) {
-                    clients.Erase(channel);
-                    channel->GetConnection().Close();
-                    return;
-                  }
-                }
-                request = parser.GetNextRequest();
-              }
-            }
-          } catch(const std::exception&) {}
-          clients.Erase(channel);
-        });
+      m_clients.Insert(channel);
+      {
+        boost::lock_guard<Threading::Mutex> lock{m_mutex};
+        ++m_connectionCount;
+        if(m_idleRoutineCount == 0) {
+          m_connectionRoutines.Spawn(
+            std::bind(&HttpServer::ConnectionLoop, this));
+        } else {
+          --m_idleRoutineCount;
+        }
+      }
+      m_connections.Push(std::move(channel));
     }
+    m_connections.Break();
     std::unordered_set<std::shared_ptr<Channel>> pendingClients;
-    clients.Swap(pendingClients);
+    m_clients.Swap(pendingClients);
     for(auto& client : pendingClients) {
       client->GetConnection().Close();
     }
+    m_connectionRoutines.Wait();
+  }
+
+  template<typename ServerConnectionType>
+  void HttpServer<ServerConnectionType>::ConnectionLoop() {
+    while(true) {
+      std::shared_ptr<Channel> channel;
+      try {
+        m_connections.Emplace(Store(channel));
+      } catch(const std::exception&) {
+        return;
+      }
+      ServeConnection(channel);
+      m_clients.Erase(channel);
+      channel.reset();
+      boost::lock_guard<Threading::Mutex> lock{m_mutex};
+      --m_connectionCount;
+      ++m_idleRoutineCount;
+      m_connectionClosedCondition.notify_one();
+    }
+  }
+
+  template<typename ServerConnectionType>
+  void HttpServer<ServerConnectionType>::ServeConnection(
+      const std::shared_ptr<Channel>& channel) {
+    try {
+      channel->GetConnection().Open();
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+      return;
+    }
+    HttpRequestParser parser{m_options.m_maxHeaderSize};
+    typename Channel::Reader::Buffer requestBuffer;
+    auto responseBuffer = IO::ChainedBuffer();
+    try {
+      while(true) {
+        channel->GetReader().Read(Store(requestBuffer));
+        parser.Feed(requestBuffer.GetData(), requestBuffer.GetSize());
+        requestBuffer.Reset();
+        auto keepAlive = true;
+        while(keepAlive) {
+          auto request = boost::optional<HttpRequest>();
+          try {
+            request = parser.GetNextRequest();
+          } catch(const InvalidHttpRequestException&) {
+            responseBuffer.Append(BAD_REQUEST_RESPONSE_BUFFER);
+            keepAlive = false;
+            break;
+          }
+          if(!request.is_initialized()) {
+            break;
+          }
+          if(m_options.m_loggingEnabled) {
+            std::cout << *request << "\n\n\n" << std::flush;
+          }
+          if(request->GetSpecialHeaders().m_connection ==
+              ConnectionHeader::UPGRADE) {
+            if(!responseBuffer.IsEmpty()) {
+              channel->GetWriter().Write(responseBuffer);
+              responseBuffer.Reset();
+            }
+            if(UpgradeConnection(*request, channel, responseBuffer)) {
+              return;
+            }
+            responseBuffer.Reset();
+          } else {
+            keepAlive = HandleHttpRequest(*request, *channel, responseBuffer);
+          }
+        }
+        if(!responseBuffer.IsEmpty()) {
+          channel->GetWriter().Write(responseBuffer);
+          responseBuffer.Reset();
+        }
+        if(!keepAlive) {
+          channel->GetConnection().Close();
+          return;
+        }
+      }
+    } catch(const std::exception&) {}
   }
 
   template<typename ServerConnectionType>
   bool HttpServer<ServerConnectionType>::UpgradeConnection(
       const HttpRequest& request, const std::shared_ptr<Channel>& channel,
-      typename Channel::Writer::Buffer& responseBuffer) {
+      IO::ChainedBuffer& responseBuffer) {
     static auto MAGIC_TOKEN = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
     auto protocol = request.GetHeader("Upgrade");
     if(!protocol.is_initialized()) {
@@ -245,10 +428,19 @@ namespace WebServices {
           response.SetHeader({"Connection", "Upgrade"});
           response.SetHeader({"Upgrade", "websocket"});
           response.SetHeader({"Sec-WebSocket-Accept", acceptToken});
+          auto deflate = boost::optional<WebSocketDeflateOptions>();
+          if(auto extensions = request.GetHeader("Sec-WebSocket-Extensions")) {
+            deflate = NegotiateDeflate(*extensions,
+              m_options.m_webSocketDeflate);
+            if(deflate.is_initialized()) {
+              response.SetHeader({"Sec-WebSocket-Extensions",
+                MakeDeflateResponse(*deflate)});
+            }
+          }
           response.Encode(Store(responseBuffer));
           channel->GetWriter().Write(responseBuffer);
           auto webSocket = std::make_unique<WebSocket>(channel,
-            typename WebSocket::ServerTag{});
+            typename WebSocket::ServerTag{}, deflate);
           auto webSocketChannel = std::make_unique<WebSocketChannel>(
             std::move(webSocket));
           slot.m_slot(request, std::move(webSocketChannel));
@@ -263,31 +455,161 @@ namespace WebServices {
   template<typename ServerConnectionType>
   bool HttpServer<ServerConnectionType>::HandleHttpRequest(
       const HttpRequest& request, Channel& channel,
-      typename Channel::Writer::Buffer& responseBuffer) {
-    auto foundSlot = false;
-    for(auto& slot : m_slots) {
-      if(slot.m_predicate(request)) {
-        try {
-          auto response = slot.m_slot(request);
-          response.Encode(Store(responseBuffer));
-        } catch(const std::exception& e) {
-          responseBuffer.Reset();
-          HttpResponse response{HttpStatusCode::INTERNAL_SERVER_ERROR};
-          response.SetHeader({"Content-Type", "application/json"});
-          Serialization::JsonSender<IO::SharedBuffer> jsonSender;
-          response.SetBody(Serialization::Encode<IO::SharedBuffer>(jsonSender,
-            std::string{e.what()}));
-          response.Encode(Store(responseBuffer));
+      IO::ChainedBuffer& responseBuffer) {
+    auto slot = m_router.Find(request);
+    if(slot == nullptr) {
+      responseBuffer.Append(NOT_FOUND_RESPONSE_BUFFER);
+    } else {
+      auto response = boost::optional<HttpResponse>();
+      try {
+        response = slot->m_slot(request);
+        if(response->GetBodyStream() &&
+            request.GetVersion() == HttpVersion::Version1_0()) {
+          auto body = IO::SharedBuffer();
+          auto writer = HttpBodyWriter(
+            [&] (const IO::SharedBuffer& data) {
+              body.Append(data);
+            });
+          response->GetBodyStream()(writer);
+          writer.Close();
+          response->SetBody(std::move(body));
         }
+      } catch(const std::exception& e) {
+        response = MakeServerErrorResponse(e);
+      }
+      auto encoding = NegotiateEncoding(request, *response);
+      if(response->GetBodyStream()) {
+        WriteStreamResponse(*response, encoding, channel, responseBuffer);
+      } else if(response->GetFileBody() == nullptr) {
+        if(encoding != TransferEncoding::IDENTITY) {
+          CompressBody(encoding, *response);
+        }
+        response->Encode(Store(responseBuffer));
+      } else {
+        WriteFileResponse(*response, channel, responseBuffer);
+      }
+    }
+    return request.GetSpecialHeaders().m_connection != ConnectionHeader::CLOSE;
+  }
+
+  template<typename ServerConnectionType>
+  TransferEncoding HttpServer<ServerConnectionType>::NegotiateEncoding(
+      const HttpRequest& request, HttpResponse& response) const {
+    if(m_options.m_compressionLevel == 0 ||
+        response.GetFileBody() != nullptr ||
+        response.GetHeader("Content-Encoding").is_initialized() ||
+        response.GetHeader("Content-Range").is_initialized()) {
+      return TransferEncoding::IDENTITY;
+    }
+    auto contentType = response.GetHeader("Content-Type");
+    if(!contentType.is_initialized() || !IsCompressible(*contentType)) {
+      return TransferEncoding::IDENTITY;
+    }
+    if(!response.GetBodyStream() &&
+        response.GetBody().GetSize() < m_options.m_compressionThreshold) {
+      return TransferEncoding::IDENTITY;
+    }
+    if(auto vary = response.GetHeader("Vary")) {
+      if(vary->find("Accept-Encoding") == std::string::npos) {
+        response.SetHeader({"Vary", *vary + ", Accept-Encoding"});
+      }
+    } else {
+      response.SetHeader({"Vary", "Accept-Encoding"});
+    }
+    auto acceptEncoding = request.GetHeader("Accept-Encoding");
+    if(!acceptEncoding.is_initialized()) {
+      return TransferEncoding::IDENTITY;
+    }
+    auto encoding = SelectContentEncoding(*acceptEncoding);
+    if(encoding == TransferEncoding::GZIP) {
+      response.SetHeader({"Content-Encoding", "gzip"});
+    } else if(encoding == TransferEncoding::DEFLATE) {
+      response.SetHeader({"Content-Encoding", "deflate"});
+    } else {
+      return encoding;
+    }
+
+    // The compressed representation differs byte for byte from the one the
+    // entity tag was made for.
+    if(auto entityTag = response.GetHeader("ETag")) {
+      if(entityTag->compare(0, 2, "W/") != 0) {
+        response.SetHeader({"ETag", "W/" + *entityTag});
+      }
+    }
+    return encoding;
+  }
+
+  template<typename ServerConnectionType>
+  void HttpServer<ServerConnectionType>::CompressBody(
+      TransferEncoding encoding, HttpResponse& response) const {
+    auto body = IO::SharedBuffer();
+    if(encoding == TransferEncoding::GZIP) {
+      auto encoder = Codecs::GZipEncoder(m_options.m_compressionLevel);
+      encoder.Encode(response.GetBody(), Store(body));
+    } else {
+      auto encoder = Codecs::ZLibEncoder(m_options.m_compressionLevel);
+      encoder.Encode(response.GetBody(), Store(body));
+    }
+    response.SetBody(std::move(body));
+  }
+
+  template<typename ServerConnectionType>
+  void HttpServer<ServerConnectionType>::WriteFileResponse(
+      const HttpResponse& response, Channel& channel,
+      IO::ChainedBuffer& responseBuffer) {
+    response.EncodeHeader(Store(responseBuffer));
+    channel.GetWriter().Write(responseBuffer);
+    responseBuffer.Reset();
+    auto& body = *response.GetFileBody();
+    if constexpr(Details::HasSendFile<typename Channel::Writer>::value) {
+      channel.GetWriter().SendFile(body.GetDescriptor(), body.GetOffset(),
+        body.GetSize());
+    } else {
+      for(auto offset = std::uint64_t(0); offset < body.GetSize();
+          offset += FILE_SEGMENT_SIZE) {
+        auto segment = IO::SharedBuffer();
+        body.Read(offset, static_cast<std::size_t>(std::min<std::uint64_t>(
+          FILE_SEGMENT_SIZE, body.GetSize() - offset)), Store(segment));
+        channel.GetWriter().Write(segment);
+      }
+    }
+  }
+
+  template<typename ServerConnectionType>
+  void HttpServer<ServerConnectionType>::WriteStreamResponse(
+      const HttpResponse& response, TransferEncoding encoding,
+      Channel& channel, IO::ChainedBuffer& responseBuffer) {
+
+    // The headers are held back to be sent along with the first chunk, so a
+    // failure producing the body before then is answered with a 500. Once
+    // sent, the failure can only be reported by closing the connection
+    // before the last chunk, which is left to the exception reaching
+    // ServeConnection.
+    auto isHeaderEncoded = false;
+    auto writer = HttpBodyWriter(
+      [&] (const IO::SharedBuffer& data) {
+        if(!isHeaderEncoded) {
+          response.EncodeHeader(Store(responseBuffer));
+          isHeaderEncoded = true;
+        }
+        Details::EncodeHttpChunk(data, Store(responseBuffer));
         channel.GetWriter().Write(responseBuffer);
-        foundSlot = true;
-        break;
+        responseBuffer.Reset();
+      }, encoding, m_options.m_compressionLevel);
+    try {
+      response.GetBodyStream()(writer);
+      writer.Close();
+    } catch(const std::exception& e) {
+      if(isHeaderEncoded) {
+        throw;
       }
+      MakeServerErrorResponse(e).Encode(Store(responseBuffer));
+      return;
     }
-    if(!foundSlot) {
-      channel.GetWriter().Write(NOT_FOUND_RESPONSE_BUFFER);
+    if(!isHeaderEncoded) {
+      response.EncodeHeader(Store(responseBuffer));
     }
-    return request.GetSpecialHeaders().m_connection != ConnectionHeader::CLOSE;
+    Details::EncodeLastHttpChunk(Store(responseBuffer));
   }
 }
 }
@@ -0,0 +1,92 @@
+#ifndef BEAM_HTTPSERVEROPTIONS_HPP
+#define BEAM_HTTPSERVEROPTIONS_HPP
+#include <cstddef>
+#include "Beam/Utilities/YamlConfig.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+#include "Beam/WebServices/WebSocketDeflateOptions.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \struct HttpServerOptions
+      \brief Stores the limits and settings of an HttpServer.
+   */
+  struct HttpServerOptions {
+
+    //! The default maximum number of open connections.
+    static constexpr auto DEFAULT_MAX_CONNECTIONS = std::size_t(4096);
+
+    //! The default maximum size of a request line and its headers.
+    static constexpr auto DEFAULT_MAX_HEADER_SIZE = std::size_t(64 * 1024);
+
+    //! The default compression level.
+    static constexpr auto DEFAULT_COMPRESSION_LEVEL = 1;
+
+    //! The default size below which response bodies are sent uncompressed.
+    static constexpr auto DEFAULT_COMPRESSION_THRESHOLD = std::size_t(1024);
+
+    //! The maximum number of open connections, once reached no further
+    //! connections are accepted until one closes.
+    std::size_t m_maxConnections;
+
+    //! The maximum size of a request line and its headers, larger requests
+    //! are answered with a 400 and their connection closed.
+    std::size_t m_maxHeaderSize;
+
+    //! The zlib level responses are compressed at when the client accepts
+    //! gzip or deflate, from 1 (fastest) to 9 (smallest), or 0 to disable
+    //! compression.
+    int m_compressionLevel;
+
+    //! The size below which response bodies are sent uncompressed, streamed
+    //! bodies are compressed regardless of their size.
+    std::size_t m_compressionThreshold;
+
+    //! The permessage-deflate parameters WebSocket clients are offered,
+    //! a compression level of 0 disables the extension.
+    WebSocketDeflateOptions m_webSocketDeflate;
+
+    //! Whether every request is printed to stdout.
+    bool m_loggingEnabled;
+
+    //! Constructs HttpServerOptions using the defaults.
+    HttpServerOptions();
+
+    //! Parses HttpServerOptions from a YAML Node, using the defaults for any
+    //! missing setting.
+    /*!
+      \param node The YAML node to parse.
+    */
+    static HttpServerOptions Parse(const YAML::Node& node);
+  };
+
+  inline HttpServerOptions::HttpServerOptions()
+    : m_maxConnections(DEFAULT_MAX_CONNECTIONS),
+      m_maxHeaderSize(DEFAULT_MAX_HEADER_SIZE),
+      m_compressionLevel(DEFAULT_COMPRESSION_LEVEL),
+      m_compressionThreshold(DEFAULT_COMPRESSION_THRESHOLD),
+      m_loggingEnabled(true) {}
+
+  inline HttpServerOptions HttpServerOptions::Parse(const YAML::Node& node) {
+    auto options = HttpServerOptions();
+    options.m_maxConnections = Extract<std::size_t>(node, "max_connections",
+      options.m_maxConnections);
+    options.m_maxHeaderSize = Extract<std::size_t>(node, "max_header_size",
+      options.m_maxHeaderSize);
+    options.m_compressionLevel = Extract<int>(node, "compression_level",
+      options.m_compressionLevel);
+    options.m_compressionThreshold = Extract<std::size_t>(node,
+      "compression_threshold", options.m_compressionThreshold);
+    auto deflateNode = node["web_socket_deflate"];
+    if(deflateNode) {
+      options.m_webSocketDeflate = WebSocketDeflateOptions::Parse(
+        deflateNode);
+    }
+    options.m_loggingEnabled = Extract<bool>(node, "logging",
+      options.m_loggingEnabled);
+    return options;
+  }
+}
+}
+
+#endif
@@ -137,6 +137,17 @@ namespace Details {
       HttpServletContainer(ServletForward&& servlet,
         ServerConnectionForward&& serverConnection);
 
+      //! Constructs the HttpServletContainer.
+      /*!
+        \param servlet Initializes the Servlet.
+        \param serverConnection Accepts connections to the servlet.
+        \param options The limits and settings of the HttpServer.
+      */
+      template<typename ServletForward, typename ServerConnectionForward>
+      HttpServletContainer(ServletForward&& servlet,
+        ServerConnectionForward&& serverConnection,
+        const HttpServerOptions& options);
+
       ~HttpServletContainer();
 
       void Open();
@@ -152,10 +163,20 @@ namespace Details {
   template<typename ServletForward, typename ServerConnectionForward>
   HttpServletContainer<ServletType, ServerConnectionType>::HttpServletContainer(
       ServletForward&& servlet, ServerConnectionForward&& serverConnection)
+      : HttpServletContainer{std::forward<ServletForward>(servlet),
+          std::forward<ServerConnectionForward>(serverConnection),
+          HttpServerOptions()} {}
+
+  template<typename ServletType, typename ServerConnectionType>
+  template<typename ServletForward, typename ServerConnectionForward>
+  HttpServletContainer<ServletType, ServerConnectionType>::HttpServletContainer(
+      ServletForward&& servlet, ServerConnectionForward&& serverConnection,
+      const HttpServerOptions& options)
       : m_servlet{std::forward<ServletForward>(servlet)},
         m_server{std::forward<ServerConnectionForward>(serverConnection),
           Details::GetSlots(*m_servlet),
-          Details::GetWebSocketSlots<HttpServletContainer>(*m_servlet)} {}
+          Details::GetWebSocketSlots<HttpServletContainer>(*m_servlet),
+          options} {}
 
   template<typename ServletType, typename ServerConnectionType>
   HttpServletContainer<ServletType, ServerConnectionType>::
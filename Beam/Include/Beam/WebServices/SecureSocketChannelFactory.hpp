@@ -2,6 +2,7 @@
 #define BEAM_WEBSERVICES_SECURESOCKETCHANNELFACTORY_HPP
 #include <memory>
 #include "Beam/Network/SecureSocketChannel.hpp"
+#include "Beam/Network/SecureSocketContext.hpp"
 #include "Beam/Pointers/Ref.hpp"
 #include "Beam/WebServices/Uri.hpp"
 #include "Beam/WebServices/WebServices.hpp"
@@ -11,6 +12,9 @@ namespace WebServices {
 
   /*! \class SecureSocketChannelFactory
       \brief Implements a Channel factory for a SecureSocketChannel.
+      \details All Channels constructed by a factory, and its copies, share a
+               SecureSocketContext so that reconnections resume their
+               sessions.
    */
   class SecureSocketChannelFactory {
     public:
@@ -23,6 +27,15 @@ namespace WebServices {
       SecureSocketChannelFactory(
         Ref<Network::SocketThreadPool> socketThreadPool);
 
+      //! Constructs a SecureSocketChannelFactory.
+      /*!
+        \param context The context all constructed Channels should use.
+        \param socketThreadPool The SocketThreadPool all constructed Channels
+               should use.
+      */
+      SecureSocketChannelFactory(Ref<Network::SecureSocketContext> context,
+        Ref<Network::SocketThreadPool> socketThreadPool);
+
       //! Returns a new SecureSocketChannel.
       /*!
         \param uri The URI that the Channel should connect to.
@@ -31,18 +44,28 @@ namespace WebServices {
         const Uri& uri) const;
 
     private:
+      std::shared_ptr<Network::SecureSocketContext> m_defaultContext;
+      Network::SecureSocketContext* m_context;
       Network::SocketThreadPool* m_socketThreadPool;
   };
 
   inline SecureSocketChannelFactory::SecureSocketChannelFactory(
       Ref<Network::SocketThreadPool> socketThreadPool)
-      : m_socketThreadPool{socketThreadPool.Get()} {}
+      : m_defaultContext{std::make_shared<Network::SecureSocketContext>()},
+        m_context{m_defaultContext.get()},
+        m_socketThreadPool{socketThreadPool.Get()} {}
+
+  inline SecureSocketChannelFactory::SecureSocketChannelFactory(
+      Ref<Network::SecureSocketContext> context,
+      Ref<Network::SocketThreadPool> socketThreadPool)
+      : m_context{context.Get()},
+        m_socketThreadPool{socketThreadPool.Get()} {}
 
   inline std::unique_ptr<Network::SecureSocketChannel>
       SecureSocketChannelFactory::operator ()(const Uri& url) const {
     Network::IpAddress address{url.GetHostname(), url.GetPort()};
     return std::make_unique<Network::SecureSocketChannel>(std::move(address),
-      Ref(*m_socketThreadPool));
+      Ref(*m_context), Ref(*m_socketThreadPool));
   }
 }
 }
@@ -1,13 +1,36 @@
 #ifndef BEAM_WEBSERVICES_SESSIONSTORE_HPP
 #define BEAM_WEBSERVICES_SESSIONSTORE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Pointers/Dereference.hpp"
 #include "Beam/Pointers/LocalPtr.hpp"
 #include "Beam/Pointers/Out.hpp"
+#include "Beam/Pointers/Ref.hpp"
+#include "Beam/Queues/RoutineTaskQueue.hpp"
+#include "Beam/Serialization/BinaryReceiver.hpp"
+#include "Beam/Serialization/BinarySender.hpp"
 #include "Beam/ServiceLocator/SessionEncryption.hpp"
-#include "Beam/Utilities/SynchronizedMap.hpp"
-#include "Beam/Utilities/SynchronizedSet.hpp"
+#include "Beam/Threading/ConditionVariable.hpp"
+#include "Beam/Threading/LiveTimer.hpp"
+#include "Beam/Threading/LockRelease.hpp"
+#include "Beam/Threading/Mutex.hpp"
+#include "Beam/Threading/TimerThreadPool.hpp"
+#include "Beam/Utilities/ReportException.hpp"
 #include "Beam/WebServices/HttpRequest.hpp"
 #include "Beam/WebServices/HttpResponse.hpp"
 #include "Beam/WebServices/NullSessionDataStore.hpp"
@@ -23,6 +46,9 @@ namespace WebServices {
    */
   struct SessionStoreConfig {
 
+    //! The default number of shards sessions are partitioned into.
+    static constexpr auto DEFAULT_SHARD_COUNT = std::size_t(16);
+
     //! Returns the default name used for the session cookie.
     static const std::string& GetDefaultSessionName();
 
@@ -35,12 +61,44 @@ namespace WebServices {
     //! The path the session is valid in.
     std::string m_path;
 
+    //! The number of shards sessions are partitioned into, each shard is
+    //! guarded by its own lock.
+    std::size_t m_shardCount;
+
+    //! How long a session is kept in memory after it's created or loaded.
+    boost::posix_time::time_duration m_timeToLive;
+
+    //! How long a session can go unused before it's removed from memory.
+    boost::posix_time::time_duration m_idleTimeout;
+
+    //! How often expired sessions are evicted and pending writes are
+    //! flushed to the data store.
+    boost::posix_time::time_duration m_maintenanceInterval;
+
     //! Constructs a SessionStoreConfig with default values.
     SessionStoreConfig();
   };
 
   /*! \class SessionStore
       \brief Stores and manages HTTP sessions.
+      \details Sessions are kept in memory partitioned into shards by id. A
+               session is removed from memory once it outlives its time to
+               live or goes unused for longer than the idle timeout. A
+               session that was never persisted expires at that point, a
+               persistent session is reloaded from the data store when it's
+               next requested. With a NullSessionDataStore persistent
+               sessions can't be reloaded, so they're kept in memory until
+               they're ended or made non persistent. Concurrent requests for
+               a session that isn't in memory share a single load from the
+               data store.
+               When constructed with a TimerThreadPool, expired sessions are
+               evicted in the background and writes to the data store are
+               queued and flushed together in a single transaction,
+               otherwise each shard is swept as it's accessed and writes go
+               directly to the data store. A queued write holds a snapshot of
+               the session made through its serialization at the time of the
+               write, so the session can keep being modified while it's
+               flushed.
       \tparam SessionType The type of session to use.
       \tparam DataStoreType The type of data store used to persist sessions.
    */
@@ -55,7 +113,7 @@ namespace WebServices {
       using DataStore = GetTryDereferenceType<DataStoreType>;
 
       //! Constructs a SessionStore with default values.
-      SessionStore() = default;
+      SessionStore();
 
       //! Constructs a SessionStore.
       /*!
@@ -70,6 +128,28 @@ namespace WebServices {
       template<typename DataStoreForward>
       SessionStore(DataStoreForward&& dataStore);
 
+      //! Constructs a SessionStore.
+      /*!
+        \param config The config to use to manage sessions.
+        \param dataStore Initializes the DataStore.
+      */
+      template<typename DataStoreForward>
+      SessionStore(SessionStoreConfig config, DataStoreForward&& dataStore);
+
+      //! Constructs a SessionStore that evicts sessions and writes to its
+      //! DataStore in the background.
+      /*!
+        \param config The config to use to manage sessions.
+        \param dataStore Initializes the DataStore.
+        \param timerThreadPool The TimerThreadPool used to schedule the
+               eviction of sessions and the flushing of writes.
+      */
+      template<typename DataStoreForward>
+      SessionStore(SessionStoreConfig config, DataStoreForward&& dataStore,
+        Ref<Threading::TimerThreadPool> timerThreadPool);
+
+      ~SessionStore();
+
       //! Returns a Session associated with an HTTP request, creating it if it
       //! doesn't yet exist.
       /*!
@@ -122,12 +202,59 @@ namespace WebServices {
       */
       void NonPersist(const Session& session, Out<HttpResponse> response);
 
+      //! Removes all expired sessions from memory.
+      void EvictExpired();
+
+      //! Writes all queued changes to the DataStore.
+      void Flush();
+
     private:
+      struct Entry {
+        std::shared_ptr<Session> m_session;
+        boost::posix_time::ptime m_expiryTime;
+        boost::posix_time::ptime m_lastAccessTime;
+        bool m_isPersistent;
+      };
+      struct Load {
+        bool m_isComplete;
+        std::shared_ptr<Session> m_session;
+        std::exception_ptr m_exception;
+        Threading::ConditionVariable m_completeCondition;
+
+        Load();
+      };
+      struct Shard {
+        Threading::Mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        std::unordered_map<std::string, std::shared_ptr<Load>> m_loads;
+        boost::posix_time::ptime m_nextSweepTime;
+      };
+      struct PendingWrite {
+        std::shared_ptr<Session> m_session;
+        bool m_isDelete;
+        std::uint64_t m_sequence;
+      };
       SessionStoreConfig m_config;
       Beam::GetOptionalLocalPtr<DataStoreType> m_dataStore;
-      SynchronizedUnorderedSet<std::string> m_sessionIds;
-      SynchronizedUnorderedMap<std::string, std::shared_ptr<Session>>
-        m_sessions;
+      std::unique_ptr<Shard[]> m_shards;
+      Threading::Mutex m_idMutex;
+      mutable Threading::Mutex m_writesMutex;
+      mutable std::unordered_map<std::string, PendingWrite> m_writes;
+      std::uint64_t m_nextSequence;
+      boost::optional<Threading::LiveTimer> m_timer;
+      RoutineTaskQueue m_tasks;
+
+      Shard& GetShard(const std::string& id) const;
+      bool IsExpired(const Entry& entry, boost::posix_time::ptime now) const;
+      void Sweep(Shard& shard, boost::posix_time::ptime now) const;
+      std::shared_ptr<Session> Acquire(const std::string& id) const;
+      std::shared_ptr<Session> LoadSession(const std::string& id) const;
+      std::shared_ptr<Session> SetPersistent(const Session& session,
+        bool isPersistent);
+      void Write(const Session& session,
+        const std::shared_ptr<Session>& sharedSession, bool isDelete);
+      static std::shared_ptr<Session> MakeSnapshot(const Session& session);
+      void OnTimerExpired(Threading::Timer::Result result);
   };
 
   inline const std::string& SessionStoreConfig::GetDefaultSessionName() {
@@ -137,43 +264,86 @@ namespace WebServices {
 
   inline SessionStoreConfig::SessionStoreConfig()
       : m_sessionName{GetDefaultSessionName()},
-        m_path{"/"} {}
+        m_path{"/"},
+        m_shardCount{DEFAULT_SHARD_COUNT},
+        m_timeToLive{boost::posix_time::hours(24)},
+        m_idleTimeout{boost::posix_time::minutes(30)},
+        m_maintenanceInterval{boost::posix_time::seconds(30)} {}
+
+  template<typename SessionType, typename DataStoreType>
+  SessionStore<SessionType, DataStoreType>::Load::Load()
+      : m_isComplete{false} {}
+
+  template<typename SessionType, typename DataStoreType>
+  SessionStore<SessionType, DataStoreType>::SessionStore()
+      : SessionStore{SessionStoreConfig()} {}
 
   template<typename SessionType, typename DataStoreType>
   SessionStore<SessionType, DataStoreType>::SessionStore(
       SessionStoreConfig config)
-      : m_config{std::move(config)},
-        m_dataStore{Initialize()} {}
+      : SessionStore{std::move(config), Initialize()} {}
 
   template<typename SessionType, typename DataStoreType>
   template<typename DataStoreForward>
   SessionStore<SessionType, DataStoreType>::SessionStore(
       DataStoreForward&& dataStore)
-      : m_dataStore{std::forward<DataStoreForward>(dataStore)} {}
+      : SessionStore{SessionStoreConfig(),
+          std::forward<DataStoreForward>(dataStore)} {}
+
+  template<typename SessionType, typename DataStoreType>
+  template<typename DataStoreForward>
+  SessionStore<SessionType, DataStoreType>::SessionStore(
+      SessionStoreConfig config, DataStoreForward&& dataStore)
+      : m_config{std::move(config)},
+        m_dataStore{std::forward<DataStoreForward>(dataStore)},
+        m_nextSequence{0} {
+    m_config.m_shardCount = std::max<std::size_t>(m_config.m_shardCount, 1);
+    m_shards = std::make_unique<Shard[]>(m_config.m_shardCount);
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  template<typename DataStoreForward>
+  SessionStore<SessionType, DataStoreType>::SessionStore(
+      SessionStoreConfig config, DataStoreForward&& dataStore,
+      Ref<Threading::TimerThreadPool> timerThreadPool)
+      : SessionStore{std::move(config),
+          std::forward<DataStoreForward>(dataStore)} {
+    m_timer.emplace(m_config.m_maintenanceInterval, Ref(timerThreadPool));
+    m_timer->GetPublisher().Monitor(
+      m_tasks.GetSlot<Threading::Timer::Result>(
+      std::bind(&SessionStore::OnTimerExpired, this, std::placeholders::_1)));
+    m_timer->Start();
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  SessionStore<SessionType, DataStoreType>::~SessionStore() {
+    if(m_timer.is_initialized()) {
+
+      // The tasks are stopped first since OnTimerExpired restarts the timer.
+      m_tasks.Break();
+      m_tasks.Wait();
+      m_timer->Cancel();
+    }
+    try {
+      Flush();
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+    }
+  }
 
   template<typename SessionType, typename DataStoreType>
   std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
       SessionStore<SessionType, DataStoreType>::Get(const HttpRequest& request,
       Out<HttpResponse> response) {
     auto sessionCookie = request.GetCookie(m_config.m_sessionName);
-    if(!sessionCookie.is_initialized()) {
-      auto session = Create();
-      SetSessionIdCookie(*session, Store(response));
-      return session;
-    }
-    auto session = m_sessions.FindValue(sessionCookie->GetValue());
-    if(!session.is_initialized()) {
-      auto persistentSession = m_dataStore->template Load<Session>(
-        sessionCookie->GetValue());
-      if(persistentSession == nullptr) {
-        session = Create(); 
-      } else {
-        session = std::move(persistentSession);
+    if(sessionCookie.is_initialized()) {
+      if(auto session = Acquire(sessionCookie->GetValue())) {
+        return session;
       }
-      SetSessionIdCookie(**session, Store(response));
-      return *session;
     }
-    return *session;
+    auto session = Create();
+    SetSessionIdCookie(*session, Store(response));
+    return session;
   }
 
   template<typename SessionType, typename DataStoreType>
@@ -184,42 +354,46 @@ namespace WebServices {
     if(!sessionCookie.is_initialized()) {
       return nullptr;
     }
-    auto session = m_sessions.FindValue(sessionCookie->GetValue());
-    if(!session.is_initialized()) {
-      auto persistentSession = m_dataStore->template Load<Session>(
-        sessionCookie->GetValue());
-      if(persistentSession == nullptr) {
-        return nullptr;
-      } else {
-        session = std::move(persistentSession);
-      }
-      return *session;
-    }
-    return *session;
+    return Acquire(sessionCookie->GetValue());
   }
 
   template<typename SessionType, typename DataStoreType>
   std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
       SessionStore<SessionType, DataStoreType>::Create() {
-    std::string sessionId;
-    m_sessionIds.With(
-      [&] (auto& sessionIds) {
-        do {
-          sessionId = ServiceLocator::GenerateSessionId();
-        } while(sessionIds.find(sessionId) != sessionIds.end());
-        sessionIds.insert(sessionId);
-      });
-    auto session = std::make_shared<Session>(std::move(sessionId));
-    m_sessions.Insert(session->GetId(), session);
-    return session;
+    while(true) {
+      auto sessionId = std::string();
+      {
+        boost::lock_guard<Threading::Mutex> lock{m_idMutex};
+        sessionId = ServiceLocator::GenerateSessionId();
+      }
+      auto& shard = GetShard(sessionId);
+      boost::lock_guard<Threading::Mutex> lock{shard.m_mutex};
+      if(shard.m_entries.find(sessionId) != shard.m_entries.end() ||
+          shard.m_loads.find(sessionId) != shard.m_loads.end()) {
+        continue;
+      }
+      auto now = boost::posix_time::microsec_clock::universal_time();
+      auto session = std::make_shared<Session>(sessionId);
+      shard.m_entries.emplace(std::move(sessionId),
+        Entry{session, now + m_config.m_timeToLive, now, false});
+      return session;
+    }
   }
 
   template<typename SessionType, typename DataStoreType>
   void SessionStore<SessionType, DataStoreType>::End(Session& session) {
-    m_dataStore->Delete(session);
+    auto sharedSession = std::shared_ptr<Session>();
+    {
+      auto& shard = GetShard(session.GetId());
+      boost::lock_guard<Threading::Mutex> lock{shard.m_mutex};
+      auto entry = shard.m_entries.find(session.GetId());
+      if(entry != shard.m_entries.end()) {
+        sharedSession = std::move(entry->second.m_session);
+        shard.m_entries.erase(entry);
+      }
+    }
+    Write(session, sharedSession, true);
     session.SetExpired();
-    m_sessions.Erase(session.GetId());
-    m_sessionIds.Erase(session.GetId());
   }
 
   template<typename SessionType, typename DataStoreType>
@@ -234,7 +408,7 @@ namespace WebServices {
   template<typename SessionType, typename DataStoreType>
   void SessionStore<SessionType, DataStoreType>::Persist(
       const Session& session, Out<HttpResponse> response) {
-    m_dataStore->Store(session);
+    Write(session, SetPersistent(session, true), false);
     Cookie cookie{m_config.m_sessionName, session.GetId()};
     cookie.SetDomain(m_config.m_domain);
     cookie.SetPath(m_config.m_path);
@@ -246,13 +420,227 @@ namespace WebServices {
   template<typename SessionType, typename DataStoreType>
   void SessionStore<SessionType, DataStoreType>::NonPersist(
       const Session& session, Out<HttpResponse> response) {
-    m_dataStore->Delete(session);
+    Write(session, SetPersistent(session, false), true);
     Cookie cookie{m_config.m_sessionName, session.GetId()};
     cookie.SetDomain(m_config.m_domain);
     cookie.SetPath(m_config.m_path);
     cookie.SetExpiration(boost::posix_time::not_a_date_time);
     response->SetCookie(std::move(cookie));
   }
+
+  template<typename SessionType, typename DataStoreType>
+  void SessionStore<SessionType, DataStoreType>::EvictExpired() {
+    auto now = boost::posix_time::microsec_clock::universal_time();
+    for(auto i = std::size_t(0); i != m_config.m_shardCount; ++i) {
+      auto& shard = m_shards[i];
+      boost::lock_guard<Threading::Mutex> lock{shard.m_mutex};
+      Sweep(shard, now);
+    }
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  void SessionStore<SessionType, DataStoreType>::Flush() {
+    auto writes = std::vector<std::pair<std::string, PendingWrite>>();
+    {
+      boost::lock_guard<Threading::Mutex> lock{m_writesMutex};
+      writes.assign(m_writes.begin(), m_writes.end());
+    }
+    if(writes.empty()) {
+      return;
+    }
+    m_dataStore->WithTransaction(
+      [&] {
+        for(auto& write : writes) {
+          if(write.second.m_isDelete) {
+            m_dataStore->Delete(*write.second.m_session);
+          } else {
+            m_dataStore->Store(*write.second.m_session);
+          }
+        }
+      });
+
+    // Writes stay queued until they reach the data store so that loads in
+    // the meantime see them, those queued again since are kept.
+    boost::lock_guard<Threading::Mutex> lock{m_writesMutex};
+    for(auto& write : writes) {
+      auto pendingWrite = m_writes.find(write.first);
+      if(pendingWrite != m_writes.end() &&
+          pendingWrite->second.m_sequence == write.second.m_sequence) {
+        m_writes.erase(pendingWrite);
+      }
+    }
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  typename SessionStore<SessionType, DataStoreType>::Shard&
+      SessionStore<SessionType, DataStoreType>::GetShard(
+      const std::string& id) const {
+    return m_shards[std::hash<std::string>()(id) % m_config.m_shardCount];
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  bool SessionStore<SessionType, DataStoreType>::IsExpired(const Entry& entry,
+      boost::posix_time::ptime now) const {
+    if(entry.m_isPersistent &&
+        std::is_same_v<DataStore, NullSessionDataStore>) {
+      return false;
+    }
+    return now >= entry.m_expiryTime ||
+      now - entry.m_lastAccessTime >= m_config.m_idleTimeout;
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  void SessionStore<SessionType, DataStoreType>::Sweep(Shard& shard,
+      boost::posix_time::ptime now) const {
+    for(auto i = shard.m_entries.begin(); i != shard.m_entries.end();) {
+      if(IsExpired(i->second, now)) {
+        if(!i->second.m_isPersistent) {
+          i->second.m_session->SetExpired();
+        }
+        i = shard.m_entries.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    shard.m_nextSweepTime = now + m_config.m_maintenanceInterval;
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
+      SessionStore<SessionType, DataStoreType>::Acquire(
+      const std::string& id) const {
+    auto& shard = GetShard(id);
+    boost::unique_lock<Threading::Mutex> lock{shard.m_mutex};
+    auto now = boost::posix_time::microsec_clock::universal_time();
+    if(!m_timer.is_initialized() && now >= shard.m_nextSweepTime) {
+      Sweep(shard, now);
+    }
+    auto entry = shard.m_entries.find(id);
+    if(entry != shard.m_entries.end()) {
+      if(!IsExpired(entry->second, now)) {
+        entry->second.m_lastAccessTime = now;
+        return entry->second.m_session;
+      }
+      auto isPersistent = entry->second.m_isPersistent;
+      if(!isPersistent) {
+        entry->second.m_session->SetExpired();
+      }
+      shard.m_entries.erase(entry);
+      if(!isPersistent) {
+        return nullptr;
+      }
+    }
+    auto load = shard.m_loads.find(id);
+    if(load != shard.m_loads.end()) {
+      auto pendingLoad = load->second;
+      while(!pendingLoad->m_isComplete) {
+        pendingLoad->m_completeCondition.wait(lock);
+      }
+      if(pendingLoad->m_exception != nullptr) {
+        std::rethrow_exception(pendingLoad->m_exception);
+      }
+      return pendingLoad->m_session;
+    }
+    auto pendingLoad = std::make_shared<Load>();
+    shard.m_loads.emplace(id, pendingLoad);
+    {
+      auto release = Threading::Release(lock);
+      try {
+        pendingLoad->m_session = LoadSession(id);
+      } catch(const std::exception&) {
+        pendingLoad->m_exception = std::current_exception();
+      }
+    }
+    shard.m_loads.erase(id);
+    pendingLoad->m_isComplete = true;
+    pendingLoad->m_completeCondition.notify_all();
+    if(pendingLoad->m_exception != nullptr) {
+      std::rethrow_exception(pendingLoad->m_exception);
+    }
+    if(pendingLoad->m_session != nullptr) {
+      now = boost::posix_time::microsec_clock::universal_time();
+      shard.m_entries.emplace(id, Entry{pendingLoad->m_session,
+        now + m_config.m_timeToLive, now, true});
+    }
+    return pendingLoad->m_session;
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
+      SessionStore<SessionType, DataStoreType>::LoadSession(
+      const std::string& id) const {
+    {
+      boost::lock_guard<Threading::Mutex> lock{m_writesMutex};
+      auto write = m_writes.find(id);
+      if(write != m_writes.end()) {
+        if(write->second.m_isDelete) {
+          return nullptr;
+        }
+        return MakeSnapshot(*write->second.m_session);
+      }
+    }
+    return m_dataStore->template Load<Session>(id);
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
+      SessionStore<SessionType, DataStoreType>::SetPersistent(
+      const Session& session, bool isPersistent) {
+    auto& shard = GetShard(session.GetId());
+    boost::lock_guard<Threading::Mutex> lock{shard.m_mutex};
+    auto entry = shard.m_entries.find(session.GetId());
+    if(entry == shard.m_entries.end()) {
+      return nullptr;
+    }
+    entry->second.m_isPersistent = isPersistent;
+    return entry->second.m_session;
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  void SessionStore<SessionType, DataStoreType>::Write(const Session& session,
+      const std::shared_ptr<Session>& sharedSession, bool isDelete) {
+    if(m_timer.is_initialized() && sharedSession != nullptr) {
+      auto snapshot = MakeSnapshot(session);
+      boost::lock_guard<Threading::Mutex> lock{m_writesMutex};
+      m_writes[session.GetId()] = PendingWrite{std::move(snapshot), isDelete,
+        m_nextSequence};
+      ++m_nextSequence;
+    } else if(isDelete) {
+      m_dataStore->Delete(session);
+    } else {
+      m_dataStore->Store(session);
+    }
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  std::shared_ptr<typename SessionStore<SessionType, DataStoreType>::Session>
+      SessionStore<SessionType, DataStoreType>::MakeSnapshot(
+      const Session& session) {
+    auto buffer = IO::SharedBuffer();
+    auto sender = Serialization::BinarySender<IO::SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(session);
+    auto snapshot = std::make_shared<Session>(session.GetId());
+    auto receiver = Serialization::BinaryReceiver<IO::SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    receiver.Shuttle(*snapshot);
+    return snapshot;
+  }
+
+  template<typename SessionType, typename DataStoreType>
+  void SessionStore<SessionType, DataStoreType>::OnTimerExpired(
+      Threading::Timer::Result result) {
+    if(result != Threading::Timer::Result::EXPIRED) {
+      return;
+    }
+    EvictExpired();
+    try {
+      Flush();
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+    }
+    m_timer->Start();
+  }
 }
 }
 
@@ -45,7 +45,7 @@ namespace Beam::WebServices {
 
   template<typename Session, typename Sender>
   auto ToRow(const Session& session, Sender& sender) {
-    auto buffer = typename Sender::Buffer();
+    auto buffer = typename Sender::Sink();
     sender.SetSink(Ref(buffer));
     try {
       sender.Shuttle(session);
@@ -1,5 +1,6 @@
 #ifndef BEAM_SQL_SESSION_DATA_STORE_HPP
 #define BEAM_SQL_SESSION_DATA_STORE_HPP
+#include <optional>
 #include <boost/noncopyable.hpp>
 #include <boost/throw_exception.hpp>
 #include <Viper/Viper.hpp>
@@ -72,12 +73,15 @@ namespace Beam::WebServices {
   template<typename C>
   template<typename Session>
   std::unique_ptr<Session> SqlSessionDataStore<C>::Load(const std::string& id) {
-    auto sqlSession = SqlSession{};
+    auto sqlSession = std::optional<SqlSession>();
     auto lock = std::lock_guard(m_mutex);
     try {
       m_connection->execute(Viper::select(GetWebSessionsRow(), "web_sessions",
-        &sqlSession));
-      return FromRow<Session>(sqlSession, m_receiver);
+        Viper::sym("id") == id, &sqlSession));
+      if(!sqlSession) {
+        return nullptr;
+      }
+      return FromRow<Session>(*sqlSession, m_receiver);
     } catch(const std::exception& e) {
       BOOST_THROW_EXCEPTION(SessionDataStoreException(e.what()));
     }
@@ -1,9 +1,13 @@
 #ifndef BEAM_URI_HPP
 #define BEAM_URI_HPP
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <ostream>
-#include <regex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <boost/exception/exception.hpp>
 #include <boost/throw_exception.hpp>
 #include "Beam/WebServices/WebServices.hpp"
@@ -11,12 +15,215 @@
 namespace Beam {
 namespace WebServices {
 
+  /*! \class MalformedUriException
+      \brief Signals an invalid/malformed URI.
+   */
+  class MalformedUriException : public std::runtime_error,
+      public boost::exception {
+    public:
+
+      //! Constructs a MalformedUriException.
+      MalformedUriException();
+
+      //! Constructs a MalformedUriException.
+      /*!
+        \param message A message describing the error.
+      */
+      MalformedUriException(const std::string& message);
+
+      virtual ~MalformedUriException() throw();
+  };
+
+namespace Details {
+
+  //! Bits classifying the characters allowed in each URI component.
+  enum UriCharacter : std::uint16_t {
+    URI_SCHEME = 1 << 0,
+    URI_REG_NAME = 1 << 1,
+    URI_USERINFO = 1 << 2,
+    URI_PATH = 1 << 3,
+    URI_QUERY = 1 << 4,
+    URI_HEX = 1 << 5,
+    URI_DIGIT = 1 << 6,
+    URI_ALPHA = 1 << 7,
+    URI_LENIENT = 1 << 8
+  };
+
+  //! Maps each character to its UriCharacter bits, as given by RFC 3986.
+  //! URI_LENIENT marks the characters browsers send unencoded in a path or
+  //! query even though RFC 3986 doesn't allow them.
+  inline constexpr auto URI_CHARACTERS = [] {
+    auto table = std::array<std::uint16_t, 256>();
+    auto set = [&] (const char* characters, std::uint16_t bits) {
+      for(auto c = characters; *c != '\0'; ++c) {
+        table[static_cast<unsigned char>(*c)] |= bits;
+      }
+    };
+    auto pchar = URI_REG_NAME | URI_USERINFO | URI_PATH | URI_QUERY;
+    set("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ",
+      URI_ALPHA | URI_SCHEME | pchar);
+    set("0123456789", URI_DIGIT | URI_HEX | URI_SCHEME | pchar);
+    set("abcdefABCDEF", URI_HEX);
+    set("+.-", URI_SCHEME);
+    set("-._~!$&'()*+,;=", pchar);
+    set(":", URI_USERINFO | URI_PATH | URI_QUERY);
+    set("@", URI_PATH | URI_QUERY);
+    set("/", URI_PATH | URI_QUERY);
+    set("?", URI_QUERY);
+    set("[]{}|^`", URI_LENIENT);
+    return table;
+  }();
+
+  //! Tests whether a character has any of the given UriCharacter bits.
+  inline bool IsUriCharacter(char c, std::uint16_t bits) {
+    return (URI_CHARACTERS[static_cast<unsigned char>(c)] & bits) != 0;
+  }
+
+  //! Scans a component made of allowed characters and percent-encoded
+  //! octets.
+  /*!
+    \param first The first character of the component.
+    \param last One past the last character of the source.
+    \param bits The UriCharacter bits allowed in the component.
+    \return One past the last character of the component.
+  */
+  inline const char* ScanUriComponent(const char* first, const char* last,
+      std::uint16_t bits) {
+    while(first != last) {
+      if(*first == '%') {
+        if(last - first < 3 || !IsUriCharacter(first[1], URI_HEX) ||
+            !IsUriCharacter(first[2], URI_HEX)) {
+          BOOST_THROW_EXCEPTION(MalformedUriException(
+            "Invalid percent-encoding."));
+        }
+        first += 3;
+      } else if(IsUriCharacter(*first, bits)) {
+        ++first;
+      } else {
+        break;
+      }
+    }
+    return first;
+  }
+
+  //! Tests whether a sequence is a dotted-decimal IPv4 address.
+  inline bool IsIpv4Address(const char* first, const char* last) {
+    for(auto i = 0; i != 4; ++i) {
+      if(i != 0) {
+        if(first == last || *first != '.') {
+          return false;
+        }
+        ++first;
+      }
+      auto octet = 0;
+      auto digits = 0;
+      while(first != last && IsUriCharacter(*first, URI_DIGIT)) {
+        if(digits != 0 && octet == 0) {
+          return false;
+        }
+        octet = 10 * octet + (*first - '0');
+        ++digits;
+        ++first;
+        if(octet > 255) {
+          return false;
+        }
+      }
+      if(digits == 0) {
+        return false;
+      }
+    }
+    return first == last;
+  }
+
+  //! Tests whether a sequence is an IPv6 address.
+  inline bool IsIpv6Address(const char* first, const char* last) {
+    auto groups = 0;
+    auto isCompressed = false;
+    if(last - first >= 2 && first[0] == ':' && first[1] == ':') {
+      isCompressed = true;
+      first += 2;
+    }
+    while(first != last) {
+      auto groupEnd = first;
+      while(groupEnd != last && groupEnd - first < 5 &&
+          IsUriCharacter(*groupEnd, URI_HEX)) {
+        ++groupEnd;
+      }
+      if(groupEnd != last && *groupEnd == '.') {
+        if(groups > 6 || !IsIpv4Address(first, last)) {
+          return false;
+        }
+        groups += 2;
+        first = last;
+        break;
+      }
+      if(groupEnd == first || groupEnd - first > 4) {
+        return false;
+      }
+      ++groups;
+      first = groupEnd;
+      if(first == last) {
+        break;
+      }
+      if(*first != ':') {
+        return false;
+      }
+      ++first;
+      if(first != last && *first == ':') {
+        if(isCompressed) {
+          return false;
+        }
+        isCompressed = true;
+        ++first;
+      } else if(first == last) {
+        return false;
+      }
+    }
+    return isCompressed ? groups <= 7 : groups == 8;
+  }
+
+  //! Tests whether a sequence is the inside of an IP-literal, excluding its
+  //! brackets.
+  inline bool IsIpLiteral(const char* first, const char* last) {
+    if(first != last && (*first == 'v' || *first == 'V')) {
+      auto versionEnd = first + 1;
+      while(versionEnd != last && IsUriCharacter(*versionEnd, URI_HEX)) {
+        ++versionEnd;
+      }
+      if(versionEnd == first + 1 || versionEnd == last ||
+          *versionEnd != '.' || versionEnd + 1 == last) {
+        return false;
+      }
+      for(auto c = versionEnd + 1; c != last; ++c) {
+        if(*c == '%' || !IsUriCharacter(*c, URI_USERINFO)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return IsIpv6Address(first, last);
+  }
+}
+
   /*! \class Uri
       \brief Represents a uniform resource identifier.
+      \details URIs are parsed in a single pass according to RFC 3986,
+               leaving each component percent-encoded.
    */
   class Uri {
     public:
 
+      //! Specifies how strictly a URI is parsed.
+      enum class Mode {
+
+        //! Only the characters allowed by RFC 3986 are accepted.
+        STANDARD,
+
+        //! The path and query also accept the characters [ ] { } | ^ and `
+        //! unencoded, as sent by browsers in a request target.
+        LENIENT
+      };
+
       //! Constructs an empty URI.
       Uri();
 
@@ -33,6 +240,14 @@ namespace WebServices {
       */
       Uri(const char* first, const char* last);
 
+      //! Constructs a URI from a sequence.
+      /*!
+        \param first The character to parse.
+        \param last One past the last character to parse.
+        \param mode How strictly to parse the URI.
+      */
+      Uri(const char* first, const char* last, Mode mode);
+
       //! Returns the scheme.
       const std::string& GetScheme() const;
 
@@ -42,7 +257,7 @@ namespace WebServices {
       //! Returns the password.
       const std::string& GetPassword() const;
 
-      //! Returns the hostname.
+      //! Returns the hostname, without the brackets of an IP literal.
       const std::string& GetHostname() const;
 
       //! Returns the port.
@@ -71,25 +286,6 @@ namespace WebServices {
       std::string m_fragment;
   };
 
-  /*! \class MalformedUriException
-      \brief Signals an invalid/malformed URI.
-   */
-  class MalformedUriException : public std::runtime_error,
-      public boost::exception {
-    public:
-
-      //! Constructs a MalformedUriException.
-      MalformedUriException();
-
-      //! Constructs a MalformedUriException.
-      /*!
-        \param message A message describing the error.
-      */
-      MalformedUriException(const std::string& message);
-
-      virtual ~MalformedUriException() throw();
-  };
-
   inline std::ostream& operator <<(std::ostream& sink, const Uri& uri) {
     if(!uri.GetScheme().empty()) {
       sink << uri.GetScheme() << ':';
@@ -102,7 +298,11 @@ namespace WebServices {
     } else if(!uri.GetPassword().empty()) {
       sink << uri.GetUsername() << ':' << uri.GetPassword() << '@';
     }
-    sink << uri.GetHostname();
+    if(uri.GetHostname().find(':') != std::string::npos) {
+      sink << '[' << uri.GetHostname() << ']';
+    } else {
+      sink << uri.GetHostname();
+    }
     if(uri.GetPort() != 0) {
       sink << ':' << uri.GetPort();
     }
@@ -122,40 +322,117 @@ namespace WebServices {
   inline Uri::Uri(const std::string& source)
       : Uri{source.c_str(), source.c_str() + source.size()} {}
 
-  inline Uri::Uri(const char* first, const char* last) {
-    static const std::regex URI_PATTERN{
-      "^((\\w+):)?(\\/\\/(((\\w*):(\\w*)@)?"
-      "([^\\/\\?:]*)(:(\\d+))?))?(\\/?([^\\/\\?#][^\\?#]*)"
-      "?)?(\\?([^#]+))?(#(\\w*))?"};
-    const auto SCHEME_CAPTURE = 2;
-    const auto USERNAME_CAPTURE = 6;
-    const auto PASSWORD_CAPTURE = 7;
-    const auto HOSTNAME_CAPTURE = 8;
-    const auto PORT_CAPTURE = 10;
-    const auto PATHNAME_CAPTURE = 11;
-    const auto QUERY_CAPTURE = 14;
-    const auto FRAGMENT_CAPTURE = 16;
-    std::cmatch matcher;
-    if(!std::regex_match(first, last, matcher, URI_PATTERN)) {
-      BOOST_THROW_EXCEPTION(MalformedUriException{"URI is not well formed."});
-    }
-    if(matcher[PORT_CAPTURE].str().empty()) {
-      m_port = 0;
-    } else {
-      auto port = std::stoul(matcher[PORT_CAPTURE].str());
-      if(port > std::numeric_limits<unsigned short>::max()) {
-        BOOST_THROW_EXCEPTION(MalformedUriException{"URI is not well formed."});
+  inline Uri::Uri(const char* first, const char* last)
+      : Uri{first, last, Mode::STANDARD} {}
+
+  inline Uri::Uri(const char* first, const char* last, Mode mode)
+      : m_port{0} {
+    auto scheme = std::string_view();
+    auto username = std::string_view();
+    auto password = std::string_view();
+    auto hostname = std::string_view();
+    auto isRelativePath = false;
+    auto c = first;
+    if(c != last && Details::IsUriCharacter(*c, Details::URI_ALPHA)) {
+      auto schemeEnd = c + 1;
+      while(schemeEnd != last &&
+          Details::IsUriCharacter(*schemeEnd, Details::URI_SCHEME)) {
+        ++schemeEnd;
+      }
+      if(schemeEnd != last && *schemeEnd == ':') {
+        scheme = std::string_view(c, schemeEnd - c);
+        c = schemeEnd + 1;
+      }
+    }
+    if(last - c >= 2 && c[0] == '/' && c[1] == '/') {
+      c += 2;
+
+      // Only a userinfo can contain an '@', and every host and port
+      // character is also a userinfo character.
+      auto userinfoEnd = Details::ScanUriComponent(c, last,
+        Details::URI_USERINFO);
+      if(userinfoEnd != last && *userinfoEnd == '@') {
+        auto separator = static_cast<const char*>(
+          std::memchr(c, ':', userinfoEnd - c));
+        if(separator == nullptr) {
+          username = std::string_view(c, userinfoEnd - c);
+        } else {
+          username = std::string_view(c, separator - c);
+          password = std::string_view(separator + 1,
+            userinfoEnd - separator - 1);
+        }
+        c = userinfoEnd + 1;
+      }
+      if(c != last && *c == '[') {
+        auto literalEnd = static_cast<const char*>(
+          std::memchr(c, ']', last - c));
+        if(literalEnd == nullptr || !Details::IsIpLiteral(c + 1, literalEnd)) {
+          BOOST_THROW_EXCEPTION(MalformedUriException(
+            "Invalid IP literal."));
+        }
+        hostname = std::string_view(c + 1, literalEnd - c - 1);
+        c = literalEnd + 1;
       } else {
+        auto hostnameEnd = Details::ScanUriComponent(c, last,
+          Details::URI_REG_NAME);
+        hostname = std::string_view(c, hostnameEnd - c);
+        c = hostnameEnd;
+      }
+      if(c != last && *c == ':') {
+        ++c;
+        auto port = std::uint32_t(0);
+        while(c != last && Details::IsUriCharacter(*c, Details::URI_DIGIT)) {
+          port = 10 * port + static_cast<std::uint32_t>(*c - '0');
+          if(port > std::numeric_limits<unsigned short>::max()) {
+            BOOST_THROW_EXCEPTION(MalformedUriException(
+              "Port out of range."));
+          }
+          ++c;
+        }
         m_port = static_cast<unsigned short>(port);
       }
+      if(c != last && *c != '/' && *c != '?' && *c != '#') {
+        BOOST_THROW_EXCEPTION(MalformedUriException("Invalid authority."));
+      }
+    } else if(scheme.empty()) {
+      isRelativePath = true;
+    }
+    auto lenientBits = std::uint16_t(
+      mode == Mode::LENIENT ? Details::URI_LENIENT : 0);
+    auto pathEnd = Details::ScanUriComponent(c, last,
+      Details::URI_PATH | lenientBits);
+    if(isRelativePath) {
+
+      // The first segment of a relative path can't contain a ':', otherwise
+      // it would be mistaken for a scheme.
+      auto slash = static_cast<const char*>(std::memchr(c, '/', pathEnd - c));
+      if(std::memchr(c, ':', (slash == nullptr ? pathEnd : slash) - c) !=
+          nullptr) {
+        BOOST_THROW_EXCEPTION(MalformedUriException(
+          "Invalid relative path."));
+      }
+    }
+    m_path.assign(c, pathEnd - c);
+    c = pathEnd;
+    if(c != last && *c == '?') {
+      auto queryEnd = Details::ScanUriComponent(c + 1, last,
+        Details::URI_QUERY | lenientBits);
+      m_query.assign(c + 1, queryEnd - c - 1);
+      c = queryEnd;
+    }
+    if(c != last && *c == '#') {
+      auto fragmentEnd = Details::ScanUriComponent(c + 1, last,
+        Details::URI_QUERY);
+      m_fragment.assign(c + 1, fragmentEnd - c - 1);
+      c = fragmentEnd;
+    }
+    if(c != last) {
+      BOOST_THROW_EXCEPTION(MalformedUriException("URI is not well formed."));
     }
-    m_scheme = matcher[SCHEME_CAPTURE];
-    m_username = matcher[USERNAME_CAPTURE];
-    m_password = matcher[PASSWORD_CAPTURE];
-    m_hostname = matcher[HOSTNAME_CAPTURE];
-    m_path = matcher[PATHNAME_CAPTURE];
-    m_query = matcher[QUERY_CAPTURE];
-    m_fragment = matcher[FRAGMENT_CAPTURE];;
+    m_scheme = scheme;
+    m_username = username;
+    m_password = password;
+    m_hostname = hostname;
   }
 
   inline const std::string& Uri::GetScheme() const {
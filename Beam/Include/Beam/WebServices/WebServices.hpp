@@ -10,13 +10,19 @@ namespace WebServices {
   struct EmailClient;
   class EmailAddress;
   class FileStore;
+  class HttpBodyWriter;
   template<typename ChannelType> class HttpClient;
+  struct HttpClientOptions;
+  class HttpFileBody;
   class HttpHeader;
   enum class HttpMethod;
   class HttpRequest;
   struct HttpRequestSlot;
   class HttpResponse;
   class HttpResponseParser;
+  struct HttpRoute;
+  class HttpRouter;
+  struct HttpServerOptions;
   template<typename ServletType, typename ServerConnectionType>
     class HttpServletContainer;
   enum class HttpStatusCode;
@@ -42,6 +48,7 @@ namespace WebServices {
   template<typename ChannelType> class WebSocket;
   template<typename WebSocketType> class WebSocketChannel;
   template<typename WebSocketType> class WebSocketConnection;
+  struct WebSocketDeflateOptions;
   template<typename WebSocketType> class WebSocketReader;
   template<typename WebSocketType> class WebSocketWriter;
 }
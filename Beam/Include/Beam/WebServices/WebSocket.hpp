@@ -1,23 +1,32 @@
 #ifndef BEAM_WEB_SOCKET_HPP
 #define BEAM_WEB_SOCKET_HPP
+#include <algorithm>
+#include <cstring>
 #include <ctime>
 #include <functional>
+#include <limits>
 #include <random>
 #include <string>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
 #include <cryptopp/osrng.h>
 #include <cryptopp/sha.h>
 #include "Beam/IO/BufferOutputStream.hpp"
+#include "Beam/IO/EndOfFileException.hpp"
+#include "Beam/IO/IOException.hpp"
 #include "Beam/IO/OpenState.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/Pointers/Dereference.hpp"
 #include "Beam/Pointers/LocalPtr.hpp"
 #include "Beam/Pointers/Out.hpp"
+#include "Beam/Threading/Mutex.hpp"
+#include "Beam/Utilities/Endian.hpp"
 #include "Beam/WebServices/HttpRequest.hpp"
 #include "Beam/WebServices/HttpResponseParser.hpp"
 #include "Beam/WebServices/Uri.hpp"
 #include "Beam/WebServices/WebServices.hpp"
+#include "Beam/WebServices/WebSocketDeflate.hpp"
 
 namespace Beam {
 namespace WebServices {
@@ -39,6 +48,36 @@ namespace Details {
       KEY_LENGTH);
     return std::string(randomBytes, KEY_LENGTH);
   }
+
+  /*! Copies a run of a WebSocket frame's payload applying its masking key,
+      eight bytes at a time.
+      \param source The payload bytes to mask.
+      \param destination Where to store the masked bytes, may be the same as
+             the <i>source</i>.
+      \param size The number of bytes to mask.
+      \param maskingKey The frame's masking key in network byte order.
+      \param offset The position of <i>source</i> within the frame's payload.
+   */
+  inline void MaskWebSocketPayload(const char* source, char* destination,
+      std::size_t size, std::uint32_t maskingKey, std::size_t offset) {
+    unsigned char key[sizeof(std::uint64_t)];
+    for(auto i = std::size_t(0); i < sizeof(key); ++i) {
+      key[i] = reinterpret_cast<const unsigned char*>(&maskingKey)[
+        (offset + i) % sizeof(maskingKey)];
+    }
+    auto wideKey = std::uint64_t();
+    std::memcpy(&wideKey, key, sizeof(wideKey));
+    auto i = std::size_t(0);
+    for(; i + sizeof(wideKey) <= size; i += sizeof(wideKey)) {
+      auto word = std::uint64_t();
+      std::memcpy(&word, source + i, sizeof(word));
+      word ^= wideKey;
+      std::memcpy(destination + i, &word, sizeof(word));
+    }
+    for(; i < size; ++i) {
+      destination[i] = static_cast<char>(source[i] ^ key[i % sizeof(key)]);
+    }
+  }
 }
 
   /*! \class WebSocketConfig
@@ -62,12 +101,16 @@ namespace Details {
       //! Sets the list of extensions.
       WebSocketConfig& SetExtensions(std::vector<std::string> extensions);
 
+      //! Offers the permessage-deflate extension to the server.
+      WebSocketConfig& SetDeflate(WebSocketDeflateOptions options);
+
     private:
       template<typename> friend class WebSocket;
       Uri m_uri;
       std::string m_version;
       std::vector<std::string> m_protocols;
       std::vector<std::string> m_extensions;
+      boost::optional<WebSocketDeflateOptions> m_deflate;
   };
 
   /*! \class WebSocket
@@ -100,18 +143,47 @@ namespace Details {
       /*!
         \param channel The existing Channel to adapt.
         \param tag Internal use only.
+        \param deflate The permessage-deflate parameters agreed to with the
+               client.
       */
       template<typename ChannelForward>
-      WebSocket(ChannelForward&& channel, ServerTag tag);
+      WebSocket(ChannelForward&& channel, ServerTag tag,
+        const boost::optional<WebSocketDeflateOptions>& deflate = boost::none);
 
       ~WebSocket();
 
       //! Returns the Uri this socket connects to.
       const Uri& GetUri() const;
 
-      //! Reads the next frame from the web socket.
+      //! Returns <code>true</code> iff payload of the current message has
+      //! been received and can be read without blocking.
+      bool IsDataAvailable() const;
+
+      //! Reads the remainder of the current message, or the next message if
+      //! the current one has been read in full.
       IO::SharedBuffer Read();
 
+      //! Reads payload from the current message as it's received without
+      //! waiting for the rest of it.
+      /*!
+        \param destination Where to store the payload.
+        \param size The maximum number of bytes to read.
+        \return The number of bytes read, or 0 if a final frame with no
+                payload ended the message.
+      */
+      std::size_t Read(char* destination, std::size_t size);
+
+      //! Reads payload from the current message as it's received without
+      //! waiting for the rest of it.
+      /*!
+        \param destination The Buffer to append the payload to.
+        \param size The maximum number of bytes to read.
+        \return The number of bytes read, or 0 if a final frame with no
+                payload ended the message.
+      */
+      template<typename Buffer>
+      std::size_t Read(Out<Buffer> destination, std::size_t size);
+
       //! Writes to the web socket.
       /*!
         \param data The raw data to write.
@@ -136,15 +208,42 @@ namespace Details {
       Uri m_uri;
       std::vector<std::string> m_protocols;
       std::vector<std::string> m_extensions;
+      boost::optional<WebSocketDeflateOptions> m_deflate;
       std::string m_version;
       ChannelBuilder m_channelBuilder;
       HttpResponseParser m_parser;
       GetOptionalLocalPtr<ChannelType> m_channel;
       std::mt19937 m_randomEngine;
       typename Channel::Reader::Buffer m_frameBuffer;
+      std::size_t m_frameCursor;
+      std::uint64_t m_frameRemaining;
+      std::uint32_t m_maskingKey;
+      std::size_t m_maskOffset;
+      bool m_hasMask;
+      bool m_isFinalFragment;
+      bool m_isCompressedMessage;
+      boost::optional<WebSocketInflater> m_inflater;
+      typename Channel::Reader::Buffer m_compressedBuffer;
+      IO::SharedBuffer m_inflatedBuffer;
+      std::size_t m_inflatedCursor;
+      Threading::Mutex m_writeMutex;
+      boost::optional<WebSocketDeflater> m_deflater;
       IO::OpenState m_openState;
 
       void Shutdown();
+      void EnableDeflate(const WebSocketDeflateOptions& agreement);
+      bool IsMessageComplete() const;
+      void Fill(std::size_t size);
+      void Consume(std::size_t size);
+      void ConsumeInflated(std::size_t size);
+      void ReadFrameHeader();
+      void ReadControlFrame(std::uint8_t opCode, std::size_t payloadLength);
+      std::size_t ReadPayload(char* destination, std::size_t size);
+      template<typename Buffer>
+      std::size_t ReadPayload(Out<Buffer> destination, std::size_t size);
+      void InflatePayload();
+      std::size_t GetAvailablePayload() const;
+      void WriteFrame(std::uint8_t code, const void* data, std::size_t size);
   };
 
   inline WebSocketConfig::WebSocketConfig()
@@ -172,6 +271,12 @@ namespace Details {
     return *this;
   }
 
+  inline WebSocketConfig& WebSocketConfig::SetDeflate(
+      WebSocketDeflateOptions options) {
+    m_deflate = std::move(options);
+    return *this;
+  }
+
   template<typename ChannelType>
   WebSocket<ChannelType>::WebSocket(WebSocketConfig config,
       ChannelBuilder channelBuilder)
@@ -179,9 +284,18 @@ namespace Details {
         m_uri{std::move(config.m_uri)},
         m_protocols{std::move(config.m_protocols)},
         m_extensions{std::move(config.m_extensions)},
+        m_deflate{std::move(config.m_deflate)},
         m_version{std::move(config.m_version)},
         m_channelBuilder{std::move(channelBuilder)},
-        m_randomEngine{static_cast<unsigned int>(std::time(nullptr))} {
+        m_randomEngine{static_cast<unsigned int>(std::time(nullptr))},
+        m_frameCursor{0},
+        m_frameRemaining{0},
+        m_maskingKey{0},
+        m_maskOffset{0},
+        m_hasMask{false},
+        m_isFinalFragment{true},
+        m_isCompressedMessage{false},
+        m_inflatedCursor{0} {
     if(m_uri.GetPort() == 0) {
       if(m_uri.GetScheme() == "http" || m_uri.GetScheme() == "ws") {
         m_uri.SetPort(80);
@@ -193,10 +307,23 @@ namespace Details {
 
   template<typename ChannelType>
   template<typename ChannelForward>
-  WebSocket<ChannelType>::WebSocket(ChannelForward&& channel, ServerTag)
+  WebSocket<ChannelType>::WebSocket(ChannelForward&& channel, ServerTag,
+      const boost::optional<WebSocketDeflateOptions>& deflate)
       : m_isServerMode{true},
         m_channel{std::forward<ChannelForward>(channel)},
-        m_openState{true} {}
+        m_frameCursor{0},
+        m_frameRemaining{0},
+        m_maskingKey{0},
+        m_maskOffset{0},
+        m_hasMask{false},
+        m_isFinalFragment{true},
+        m_isCompressedMessage{false},
+        m_inflatedCursor{0},
+        m_openState{true} {
+    if(deflate.is_initialized()) {
+      EnableDeflate(*deflate);
+    }
+  }
 
   template <typename ChannelType>
   WebSocket<ChannelType>::~WebSocket() {
@@ -208,103 +335,86 @@ namespace Details {
     return m_uri;
   }
 
+  template<typename ChannelType>
+  bool WebSocket<ChannelType>::IsDataAvailable() const {
+    return m_inflatedCursor != m_inflatedBuffer.GetSize() ||
+      (!m_isCompressedMessage && GetAvailablePayload() != 0);
+  }
+
   template<typename ChannelType>
   IO::SharedBuffer WebSocket<ChannelType>::Read() {
     IO::SharedBuffer payload;
+    do {
+      Read(Store(payload), std::numeric_limits<std::size_t>::max());
+    } while(!IsMessageComplete());
+    return payload;
+  }
+
+  template<typename ChannelType>
+  std::size_t WebSocket<ChannelType>::Read(char* destination,
+      std::size_t size) {
+    if(size == 0) {
+      return 0;
+    }
     while(true) {
-      int isFinalFragment;
-      std::uint8_t opCode;
-      int hasMask;
-      std::uint32_t maskingKey;
-      std::uint64_t payloadLength;
-      unsigned char opCodeBuffer[2];
-      m_channel->GetReader().Read(reinterpret_cast<char*>(opCodeBuffer),
-        sizeof(opCodeBuffer));
-      isFinalFragment = opCodeBuffer[0] & (1 << 7);
-      opCode = opCodeBuffer[0] & 0x0F;
-      hasMask = opCodeBuffer[1] & (1 << 7);
-      payloadLength = opCodeBuffer[1] & ~(1 << 7);
-      if(payloadLength == 126) {
-        std::uint16_t revisedPayloadLength;
-        m_channel->GetReader().Read(
-          reinterpret_cast<char*>(&revisedPayloadLength),
-          sizeof(revisedPayloadLength));
-        payloadLength = FromBigEndian(revisedPayloadLength);
-      } else if(payloadLength == 127) {
-        std::uint64_t revisedPayloadLength;
-        m_channel->GetReader().Read(
-          reinterpret_cast<char*>(&revisedPayloadLength),
-          sizeof(revisedPayloadLength));
-        payloadLength = FromBigEndian(revisedPayloadLength);
-      }
-      if(hasMask) {
-        m_channel->GetReader().Read(reinterpret_cast<char*>(&maskingKey),
-          sizeof(maskingKey));
-      }
-      std::size_t cursor = payload.GetSize();
-      m_channel->GetReader().Read(Store(payload),
-        static_cast<std::size_t>(payloadLength));
-      if(hasMask) {
-        for(auto i = cursor; i < payloadLength; ++i) {
-          payload.GetMutableData()[i] = payload.GetMutableData()[i] ^
-            (reinterpret_cast<unsigned char*>(&maskingKey)[
-            (i - cursor) % sizeof(maskingKey)]);
+      if(m_inflatedCursor != m_inflatedBuffer.GetSize()) {
+        size = std::min(size, m_inflatedBuffer.GetSize() - m_inflatedCursor);
+        std::memcpy(destination, m_inflatedBuffer.GetData() + m_inflatedCursor,
+          size);
+        ConsumeInflated(size);
+        return size;
+      } else if(m_frameRemaining == 0) {
+        ReadFrameHeader();
+        if(IsMessageComplete()) {
+          return 0;
         }
-      }
-      if(isFinalFragment) {
-        break;
+      } else if(m_isCompressedMessage) {
+        InflatePayload();
+      } else {
+        return ReadPayload(destination, size);
       }
     }
-    return payload;
   }
 
   template<typename ChannelType>
-  void WebSocket<ChannelType>::Write(const void* data, std::size_t size) {
-    const std::size_t MAX_PAYLOAD_LENGTH = 125;
-    const std::size_t MAX_TWO_BYTE_PAYLOAD_LENGTH = (1 << 16);
-    typename Channel::Writer::Buffer frame;
-    std::uint8_t code = (1 << 7) | 1;
-    frame.Append(&code, sizeof(code));
-    auto payloadLength =
-      [&] {
-        if(size <= MAX_PAYLOAD_LENGTH) {
-          return static_cast<std::uint8_t>(size);
-        } else if(size <= MAX_TWO_BYTE_PAYLOAD_LENGTH) {
-          return std::uint8_t{126};
-        } else {
-          return std::uint8_t{127};
-        }
-      }();
-    if(!m_isServerMode) {
-      payloadLength |= (1 << 7);
+  template<typename Buffer>
+  std::size_t WebSocket<ChannelType>::Read(Out<Buffer> destination,
+      std::size_t size) {
+    if(size == 0) {
+      return 0;
     }
-    frame.Append(&payloadLength, sizeof(payloadLength));
-    if(size > MAX_PAYLOAD_LENGTH) {
-      if(size <= MAX_TWO_BYTE_PAYLOAD_LENGTH) {
-        auto extendedPayloadLength = ToBigEndian(
-          static_cast<std::uint16_t>(size));
-        frame.Append(&extendedPayloadLength, sizeof(extendedPayloadLength));
+    while(true) {
+      if(m_inflatedCursor != m_inflatedBuffer.GetSize()) {
+        size = std::min(size, m_inflatedBuffer.GetSize() - m_inflatedCursor);
+        destination->Append(m_inflatedBuffer.GetData() + m_inflatedCursor,
+          size);
+        ConsumeInflated(size);
+        return size;
+      } else if(m_frameRemaining == 0) {
+        ReadFrameHeader();
+        if(IsMessageComplete()) {
+          return 0;
+        }
+      } else if(m_isCompressedMessage) {
+        InflatePayload();
       } else {
-        auto extendedPayloadLength = ToBigEndian(
-          static_cast<std::uint64_t>(size));
-        frame.Append(&extendedPayloadLength, sizeof(extendedPayloadLength));
+        return ReadPayload(Store(destination), size);
       }
     }
-    if(m_isServerMode) {
-      frame.Append(data, size);
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::Write(const void* data, std::size_t size) {
+    const auto TEXT = std::uint8_t(0x01);
+    const auto COMPRESSED = std::uint8_t(0x40);
+    boost::lock_guard<Threading::Mutex> lock{m_writeMutex};
+    if(m_deflater.is_initialized()) {
+      auto payload = IO::SharedBuffer();
+      m_deflater->Deflate(data, size, Store(payload));
+      WriteFrame(COMPRESSED | TEXT, payload.GetData(), payload.GetSize());
     } else {
-      std::uint32_t maskingKey = m_randomEngine();
-      frame.Append(&maskingKey, sizeof(maskingKey));
-      auto frameSize = frame.GetSize();
-      frame.Append(data, size);
-      for(std::size_t i = 0; i < size; ++i) {
-        auto index = i + frameSize;
-        frame.GetMutableData()[index] = frame.GetMutableData()[index] ^
-          (reinterpret_cast<unsigned char*>(&maskingKey)[
-          i % sizeof(maskingKey)]);
-      }
+      WriteFrame(TEXT, data, size);
     }
-    m_channel->GetWriter().Write(frame);
   }
 
   template<typename ChannelType>
@@ -340,7 +450,7 @@ namespace Details {
         }
         request.Add(HttpHeader{"Sec-WebSocket-Protocol", protocols});
       }
-      if(!m_extensions.empty()) {
+      if(!m_extensions.empty() || m_deflate.is_initialized()) {
         std::string extensions;
         auto isFirst = true;
         for(auto& extension : m_extensions) {
@@ -351,6 +461,12 @@ namespace Details {
           }
           extensions += extension;
         }
+        if(m_deflate.is_initialized()) {
+          if(!isFirst) {
+            extensions += ", ";
+          }
+          extensions += MakeDeflateOffer(*m_deflate);
+        }
         request.Add(HttpHeader{"Sec-WebSocket-Extensions", extensions});
       }
       if(!m_version.empty()) {
@@ -385,6 +501,14 @@ namespace Details {
           if(acceptToken != *acceptHeader) {
             BOOST_THROW_EXCEPTION(IO::ConnectException{"Invalid accept key."});
           }
+          auto extensionsHeader = response->GetHeader(
+            "Sec-WebSocket-Extensions");
+          if(m_deflate.is_initialized() && extensionsHeader.is_initialized()) {
+            if(auto agreement = ParseDeflateResponse(*extensionsHeader,
+                *m_deflate)) {
+              EnableDeflate(*agreement);
+            }
+          }
           break;
         }
       }
@@ -393,6 +517,7 @@ namespace Details {
       Shutdown();
     }
     m_frameBuffer = m_parser.GetRemainingBuffer();
+    m_frameCursor = 0;
     m_openState.SetOpen();
   }
 
@@ -409,6 +534,305 @@ namespace Details {
     m_channel->GetConnection().Close();
     m_openState.SetClosed();
   }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::EnableDeflate(
+      const WebSocketDeflateOptions& agreement) {
+    if(m_isServerMode) {
+      m_deflater.emplace(agreement.m_compressionLevel,
+        agreement.m_serverMaxWindowBits, !agreement.m_serverNoContextTakeover);
+      m_inflater.emplace(!agreement.m_clientNoContextTakeover);
+    } else {
+      m_deflater.emplace(agreement.m_compressionLevel,
+        agreement.m_clientMaxWindowBits, !agreement.m_clientNoContextTakeover);
+      m_inflater.emplace(!agreement.m_serverNoContextTakeover);
+    }
+  }
+
+  template<typename ChannelType>
+  bool WebSocket<ChannelType>::IsMessageComplete() const {
+    return m_frameRemaining == 0 && m_isFinalFragment &&
+      !m_isCompressedMessage && m_inflatedCursor == m_inflatedBuffer.GetSize();
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::Fill(std::size_t size) {
+    if(m_frameBuffer.GetSize() - m_frameCursor >= size) {
+      return;
+    }
+    if(m_frameCursor != 0) {
+      auto remainder = typename Channel::Reader::Buffer();
+      remainder.Append(m_frameBuffer.GetData() + m_frameCursor,
+        m_frameBuffer.GetSize() - m_frameCursor);
+      m_frameBuffer = std::move(remainder);
+      m_frameCursor = 0;
+    }
+    while(m_frameBuffer.GetSize() < size) {
+      m_channel->GetReader().Read(Store(m_frameBuffer));
+    }
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::Consume(std::size_t size) {
+    m_frameCursor += size;
+    if(m_frameCursor == m_frameBuffer.GetSize()) {
+      m_frameBuffer.Reset();
+      m_frameCursor = 0;
+    }
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::ConsumeInflated(std::size_t size) {
+    m_inflatedCursor += size;
+    if(m_inflatedCursor == m_inflatedBuffer.GetSize()) {
+      m_inflatedBuffer.Reset();
+      m_inflatedCursor = 0;
+    }
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::ReadFrameHeader() {
+    const auto MIN_HEADER_LENGTH = std::size_t(2);
+    while(true) {
+      Fill(MIN_HEADER_LENGTH);
+      auto header = reinterpret_cast<const unsigned char*>(
+        m_frameBuffer.GetData() + m_frameCursor);
+      auto hasMask = (header[1] & (1 << 7)) != 0;
+      auto headerLength = MIN_HEADER_LENGTH;
+      auto payloadLength = std::uint64_t(header[1] & ~(1 << 7));
+      if(payloadLength == 126) {
+        headerLength += sizeof(std::uint16_t);
+      } else if(payloadLength == 127) {
+        headerLength += sizeof(std::uint64_t);
+      }
+      if(hasMask) {
+        headerLength += sizeof(m_maskingKey);
+      }
+      Fill(headerLength);
+      header = reinterpret_cast<const unsigned char*>(
+        m_frameBuffer.GetData() + m_frameCursor);
+      auto isFinalFragment = (header[0] & (1 << 7)) != 0;
+      auto isCompressed = (header[0] & (1 << 6)) != 0;
+      auto opCode = static_cast<std::uint8_t>(header[0] & 0x0F);
+      auto cursor = MIN_HEADER_LENGTH;
+      if(payloadLength == 126) {
+        std::uint16_t revisedPayloadLength;
+        std::memcpy(&revisedPayloadLength, header + cursor,
+          sizeof(revisedPayloadLength));
+        payloadLength = FromBigEndian(revisedPayloadLength);
+        cursor += sizeof(revisedPayloadLength);
+      } else if(payloadLength == 127) {
+        std::uint64_t revisedPayloadLength;
+        std::memcpy(&revisedPayloadLength, header + cursor,
+          sizeof(revisedPayloadLength));
+        payloadLength = FromBigEndian(revisedPayloadLength);
+        cursor += sizeof(revisedPayloadLength);
+      }
+      auto maskingKey = std::uint32_t(0);
+      if(hasMask) {
+        std::memcpy(&maskingKey, header + cursor, sizeof(maskingKey));
+      }
+      Consume(headerLength);
+      if((opCode & 0x08) != 0) {
+        m_hasMask = hasMask;
+        m_maskingKey = maskingKey;
+        ReadControlFrame(opCode, static_cast<std::size_t>(payloadLength));
+        continue;
+      }
+      if(isCompressed && (opCode == 0 || !m_inflater.is_initialized())) {
+        BOOST_THROW_EXCEPTION(IO::IOException("Invalid frame."));
+      }
+
+      // Only the first frame of a message marks it as compressed, the
+      // continuation frames that follow inherit it.
+      if(opCode != 0) {
+        m_isCompressedMessage = isCompressed;
+      }
+      m_hasMask = hasMask;
+      m_maskingKey = maskingKey;
+      m_maskOffset = 0;
+      m_frameRemaining = payloadLength;
+      m_isFinalFragment = isFinalFragment;
+      if(m_isCompressedMessage && m_isFinalFragment && m_frameRemaining == 0) {
+        m_inflater->Finish(Store(m_inflatedBuffer));
+        m_isCompressedMessage = false;
+      }
+      return;
+    }
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::ReadControlFrame(std::uint8_t opCode,
+      std::size_t payloadLength) {
+    const auto CLOSE = std::uint8_t(0x08);
+    const auto PING = std::uint8_t(0x09);
+    const auto PONG = std::uint8_t(0x0A);
+    const auto MAX_CONTROL_PAYLOAD_LENGTH = std::size_t(125);
+    if(payloadLength > MAX_CONTROL_PAYLOAD_LENGTH) {
+      BOOST_THROW_EXCEPTION(IO::IOException("Invalid control frame."));
+    }
+
+    // Control frames may arrive between the fragments of a message and are
+    // never fragmented themselves, so they're read whole from the frame
+    // buffer.
+    Fill(payloadLength);
+    auto payload = IO::SharedBuffer(payloadLength);
+    if(m_hasMask) {
+      Details::MaskWebSocketPayload(m_frameBuffer.GetData() + m_frameCursor,
+        payload.GetMutableData(), payloadLength, m_maskingKey, 0);
+    } else if(payloadLength != 0) {
+      std::memcpy(payload.GetMutableData(),
+        m_frameBuffer.GetData() + m_frameCursor, payloadLength);
+    }
+    Consume(payloadLength);
+    if(opCode == PING) {
+      boost::lock_guard<Threading::Mutex> lock{m_writeMutex};
+      WriteFrame(PONG, payload.GetData(), payload.GetSize());
+    } else if(opCode == CLOSE) {
+      try {
+        boost::lock_guard<Threading::Mutex> lock{m_writeMutex};
+        WriteFrame(CLOSE, payload.GetData(),
+          std::min<std::size_t>(payload.GetSize(), sizeof(std::uint16_t)));
+      } catch(const std::exception&) {}
+      BOOST_THROW_EXCEPTION(IO::EndOfFileException("WebSocket closed."));
+    }
+  }
+
+  template<typename ChannelType>
+  std::size_t WebSocket<ChannelType>::ReadPayload(char* destination,
+      std::size_t size) {
+    size = static_cast<std::size_t>(std::min<std::uint64_t>(size,
+      m_frameRemaining));
+    if(m_frameCursor == m_frameBuffer.GetSize()) {
+      size = m_channel->GetReader().Read(destination, size);
+      if(m_hasMask) {
+        Details::MaskWebSocketPayload(destination, destination, size,
+          m_maskingKey, m_maskOffset);
+      }
+    } else {
+      size = std::min(size, m_frameBuffer.GetSize() - m_frameCursor);
+      auto source = m_frameBuffer.GetData() + m_frameCursor;
+      if(m_hasMask) {
+        Details::MaskWebSocketPayload(source, destination, size, m_maskingKey,
+          m_maskOffset);
+      } else {
+        std::memcpy(destination, source, size);
+      }
+      Consume(size);
+    }
+    m_frameRemaining -= size;
+    m_maskOffset += size;
+    return size;
+  }
+
+  template<typename ChannelType>
+  template<typename Buffer>
+  std::size_t WebSocket<ChannelType>::ReadPayload(Out<Buffer> destination,
+      std::size_t size) {
+    size = static_cast<std::size_t>(std::min<std::uint64_t>(size,
+      m_frameRemaining));
+    auto cursor = destination->GetSize();
+
+    // Payload not yet received is read straight into the destination so
+    // that large frames never accumulate in the frame buffer.
+    if(m_frameCursor == m_frameBuffer.GetSize()) {
+      size = m_channel->GetReader().Read(Store(destination), size);
+      if(m_hasMask) {
+        auto data = destination->GetMutableData() + cursor;
+        Details::MaskWebSocketPayload(data, data, size, m_maskingKey,
+          m_maskOffset);
+      }
+    } else {
+      size = std::min(size, m_frameBuffer.GetSize() - m_frameCursor);
+      auto source = m_frameBuffer.GetData() + m_frameCursor;
+      if(m_hasMask) {
+        destination->Grow(size);
+        Details::MaskWebSocketPayload(source,
+          destination->GetMutableData() + cursor, size, m_maskingKey,
+          m_maskOffset);
+      } else {
+        destination->Append(source, size);
+      }
+      Consume(size);
+    }
+    m_frameRemaining -= size;
+    m_maskOffset += size;
+    return size;
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::InflatePayload() {
+
+    // Bounds how much a single read can decompress to, since a small
+    // compressed payload may expand a thousandfold.
+    const auto MAX_COMPRESSED_READ_SIZE = std::size_t(16 * 1024);
+    ReadPayload(Store(m_compressedBuffer), MAX_COMPRESSED_READ_SIZE);
+    m_inflater->Inflate(m_compressedBuffer.GetData(),
+      m_compressedBuffer.GetSize(), Store(m_inflatedBuffer));
+    m_compressedBuffer.Reset();
+    if(m_frameRemaining == 0 && m_isFinalFragment) {
+      m_inflater->Finish(Store(m_inflatedBuffer));
+      m_isCompressedMessage = false;
+    }
+  }
+
+  template<typename ChannelType>
+  std::size_t WebSocket<ChannelType>::GetAvailablePayload() const {
+    return static_cast<std::size_t>(std::min<std::uint64_t>(m_frameRemaining,
+      m_frameBuffer.GetSize() - m_frameCursor));
+  }
+
+  template<typename ChannelType>
+  void WebSocket<ChannelType>::WriteFrame(std::uint8_t code,
+      const void* data, std::size_t size) {
+    const std::size_t MAX_PAYLOAD_LENGTH = 125;
+    const std::size_t MAX_TWO_BYTE_PAYLOAD_LENGTH =
+      std::numeric_limits<std::uint16_t>::max();
+    auto headerLength = std::size_t(2);
+    if(size > MAX_TWO_BYTE_PAYLOAD_LENGTH) {
+      headerLength += sizeof(std::uint64_t);
+    } else if(size > MAX_PAYLOAD_LENGTH) {
+      headerLength += sizeof(std::uint16_t);
+    }
+    if(!m_isServerMode) {
+      headerLength += sizeof(std::uint32_t);
+    }
+    typename Channel::Writer::Buffer frame;
+    frame.Reserve(headerLength + size);
+    auto header = reinterpret_cast<unsigned char*>(frame.GetMutableData());
+    header[0] = static_cast<unsigned char>((1 << 7) | code);
+    auto cursor = std::size_t(2);
+    if(size > MAX_TWO_BYTE_PAYLOAD_LENGTH) {
+      header[1] = 127;
+      auto extendedPayloadLength = ToBigEndian(
+        static_cast<std::uint64_t>(size));
+      std::memcpy(header + cursor, &extendedPayloadLength,
+        sizeof(extendedPayloadLength));
+      cursor += sizeof(extendedPayloadLength);
+    } else if(size > MAX_PAYLOAD_LENGTH) {
+      header[1] = 126;
+      auto extendedPayloadLength = ToBigEndian(
+        static_cast<std::uint16_t>(size));
+      std::memcpy(header + cursor, &extendedPayloadLength,
+        sizeof(extendedPayloadLength));
+      cursor += sizeof(extendedPayloadLength);
+    } else {
+      header[1] = static_cast<unsigned char>(size);
+    }
+    auto payload = frame.GetMutableData() + headerLength;
+    if(m_isServerMode) {
+      if(size != 0) {
+        std::memcpy(payload, data, size);
+      }
+    } else {
+      header[1] |= (1 << 7);
+      auto maskingKey = static_cast<std::uint32_t>(m_randomEngine());
+      std::memcpy(header + cursor, &maskingKey, sizeof(maskingKey));
+      Details::MaskWebSocketPayload(static_cast<const char*>(data), payload,
+        size, maskingKey, 0);
+    }
+    m_channel->GetWriter().Write(frame);
+  }
 }
 }
 
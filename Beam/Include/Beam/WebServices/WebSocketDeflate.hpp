@@ -0,0 +1,453 @@
+#ifndef BEAM_WEBSOCKETDEFLATE_HPP
+#define BEAM_WEBSOCKETDEFLATE_HPP
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <boost/noncopyable.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/throw_exception.hpp>
+#include <zlib.h>
+#include "Beam/Codecs/DecoderException.hpp"
+#include "Beam/Codecs/EncoderException.hpp"
+#include "Beam/IO/ConnectException.hpp"
+#include "Beam/Pointers/Out.hpp"
+#include "Beam/WebServices/HttpContentEncoding.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+#include "Beam/WebServices/WebSocketDeflateOptions.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \class WebSocketDeflater
+      \brief Compresses the messages sent over a WebSocket, sharing a sliding
+             window across messages unless context takeover is disabled.
+   */
+  class WebSocketDeflater : private boost::noncopyable {
+    public:
+
+      //! Constructs a WebSocketDeflater.
+      /*!
+        \param level The compression level.
+        \param windowBits The base two logarithm of the sliding window size.
+        \param isContextTakeover Whether the sliding window is kept from one
+               message to the next.
+      */
+      WebSocketDeflater(int level, int windowBits, bool isContextTakeover);
+
+      //! Compresses a message.
+      /*!
+        \param data The message to compress.
+        \param size The size of the message.
+        \param destination The Buffer to append the compressed message to.
+      */
+      template<typename Buffer>
+      void Deflate(const void* data, std::size_t size, Out<Buffer> destination);
+
+    private:
+      struct StreamDeleter {
+        void operator ()(z_stream* stream) const;
+      };
+      std::unique_ptr<z_stream, StreamDeleter> m_stream;
+      bool m_isContextTakeover;
+  };
+
+  /*! \class WebSocketInflater
+      \brief Decompresses the messages received over a WebSocket a piece at a
+             time.
+   */
+  class WebSocketInflater : private boost::noncopyable {
+    public:
+
+      //! Constructs a WebSocketInflater.
+      /*!
+        \param isContextTakeover Whether the peer keeps its sliding window
+               from one message to the next.
+      */
+      explicit WebSocketInflater(bool isContextTakeover);
+
+      //! Decompresses the next piece of a message.
+      /*!
+        \param data The compressed piece.
+        \param size The size of the piece.
+        \param destination The Buffer to append the decompressed data to.
+      */
+      template<typename Buffer>
+      void Inflate(const void* data, std::size_t size, Out<Buffer> destination);
+
+      //! Ends the current message.
+      /*!
+        \param destination The Buffer to append any remaining decompressed
+               data to.
+      */
+      template<typename Buffer>
+      void Finish(Out<Buffer> destination);
+
+    private:
+      struct StreamDeleter {
+        void operator ()(z_stream* stream) const;
+      };
+      std::unique_ptr<z_stream, StreamDeleter> m_stream;
+      bool m_isContextTakeover;
+  };
+
+  //! Returns the Sec-WebSocket-Extensions value a client offers.
+  /*!
+    \param options The parameters the client would like to use.
+  */
+  std::string MakeDeflateOffer(const WebSocketDeflateOptions& options);
+
+  //! Accepts the first permessage-deflate offer a server is able to honour.
+  /*!
+    \param extensions The Sec-WebSocket-Extensions value sent by the client.
+    \param options The server's parameters.
+    \return The parameters agreed to, or <code>boost::none</code> if no offer
+            was acceptable or the extension is disabled.
+  */
+  boost::optional<WebSocketDeflateOptions> NegotiateDeflate(
+    std::string_view extensions, const WebSocketDeflateOptions& options);
+
+  //! Returns the Sec-WebSocket-Extensions value a server responds with.
+  /*!
+    \param agreement The parameters returned by NegotiateDeflate.
+  */
+  std::string MakeDeflateResponse(const WebSocketDeflateOptions& agreement);
+
+  //! Returns the parameters a server accepted in response to an offer.
+  /*!
+    \param extensions The Sec-WebSocket-Extensions value sent by the server.
+    \param offer The parameters the client offered.
+    \return The parameters agreed to, or <code>boost::none</code> if the
+            server declined the extension.
+  */
+  boost::optional<WebSocketDeflateOptions> ParseDeflateResponse(
+    std::string_view extensions, const WebSocketDeflateOptions& offer);
+
+namespace Details {
+
+  //! The empty block that ends every compressed message, omitted from the
+  //! frames sent.
+  constexpr unsigned char DEFLATE_MESSAGE_TRAILER[] =
+    {0x00, 0x00, 0xFF, 0xFF};
+
+  inline std::string_view GetExtensionName(std::string_view extension) {
+    return TrimHttpWhitespace(extension.substr(0, extension.find(';')));
+  }
+
+  //! Parses the parameters of a permessage-deflate extension.
+  /*!
+    \param extension The extension and its parameters.
+    \param options Stores the parameters, unlisted ones keep their values.
+    \param hasClientMaxWindowBits Set if client_max_window_bits is listed.
+    \return <code>false</code> iff a parameter is unknown, repeated or has
+            an invalid value.
+  */
+  inline bool ParseDeflateParameters(std::string_view extension,
+      WebSocketDeflateOptions& options, bool& hasClientMaxWindowBits) {
+    auto hasServerNoContextTakeover = false;
+    auto hasClientNoContextTakeover = false;
+    auto hasServerMaxWindowBits = false;
+    hasClientMaxWindowBits = false;
+    auto parseWindowBits = [] (std::string_view value, int& windowBits) {
+      if(value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+      }
+      if(value.empty() || value.size() > 2 || !std::all_of(value.begin(),
+          value.end(), [] (char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+      }
+      windowBits = std::atoi(std::string(value).c_str());
+      return windowBits >= 8 &&
+        windowBits <= WebSocketDeflateOptions::MAX_WINDOW_BITS;
+    };
+    auto delimiter = extension.find(';');
+    while(delimiter != std::string_view::npos) {
+      extension.remove_prefix(delimiter + 1);
+      delimiter = extension.find(';');
+      auto parameter = TrimHttpWhitespace(extension.substr(0, delimiter));
+      auto separator = parameter.find('=');
+      auto name = TrimHttpWhitespace(parameter.substr(0, separator));
+      auto value = separator == std::string_view::npos ? std::string_view() :
+        TrimHttpWhitespace(parameter.substr(separator + 1));
+      auto hasValue = separator != std::string_view::npos;
+      if(name == "server_no_context_takeover") {
+        if(hasServerNoContextTakeover || hasValue) {
+          return false;
+        }
+        hasServerNoContextTakeover = true;
+        options.m_serverNoContextTakeover = true;
+      } else if(name == "client_no_context_takeover") {
+        if(hasClientNoContextTakeover || hasValue) {
+          return false;
+        }
+        hasClientNoContextTakeover = true;
+        options.m_clientNoContextTakeover = true;
+      } else if(name == "server_max_window_bits") {
+        if(hasServerMaxWindowBits ||
+            !parseWindowBits(value, options.m_serverMaxWindowBits)) {
+          return false;
+        }
+        hasServerMaxWindowBits = true;
+      } else if(name == "client_max_window_bits") {
+        if(hasClientMaxWindowBits || (hasValue &&
+            !parseWindowBits(value, options.m_clientMaxWindowBits))) {
+          return false;
+        }
+        hasClientMaxWindowBits = true;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+  inline WebSocketDeflater::WebSocketDeflater(int level, int windowBits,
+      bool isContextTakeover)
+      : m_isContextTakeover(isContextTakeover) {
+    auto stream = std::make_unique<z_stream>();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+
+    // Negative window bits produce a raw deflate stream without the zlib
+    // header and checksum.
+    auto result = deflateInit2(stream.get(), level, Z_DEFLATED,
+      -std::max(windowBits, WebSocketDeflateOptions::MIN_WINDOW_BITS), 8,
+      Z_DEFAULT_STRATEGY);
+    if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(Codecs::EncoderException("Insufficient memory."));
+    } else if(result != Z_OK) {
+      BOOST_THROW_EXCEPTION(Codecs::EncoderException(
+        "Invalid compression parameters."));
+    }
+    m_stream.reset(stream.release());
+  }
+
+  template<typename Buffer>
+  void WebSocketDeflater::Deflate(const void* data, std::size_t size,
+      Out<Buffer> destination) {
+    auto cursor = destination->GetSize();
+    auto encodedSize = cursor;
+    m_stream->next_in = static_cast<Bytef*>(const_cast<void*>(data));
+    m_stream->avail_in = static_cast<uInt>(size);
+    while(true) {
+      destination->Grow(std::max<std::size_t>(encodedSize - cursor,
+        deflateBound(m_stream.get(), static_cast<uLong>(size))));
+      m_stream->next_out = reinterpret_cast<Bytef*>(
+        destination->GetMutableData() + encodedSize);
+      m_stream->avail_out = static_cast<uInt>(destination->GetSize() -
+        encodedSize);
+      auto result = deflate(m_stream.get(), Z_SYNC_FLUSH);
+      encodedSize = destination->GetSize() - m_stream->avail_out;
+      if(result == Z_STREAM_ERROR) {
+        BOOST_THROW_EXCEPTION(Codecs::EncoderException("Unknown error."));
+      }
+      if(m_stream->avail_out != 0) {
+        break;
+      }
+    }
+
+    // Every flushed message ends with the same empty block, which is left
+    // for the receiver to append.
+    encodedSize = std::max(cursor, encodedSize -
+      sizeof(Details::DEFLATE_MESSAGE_TRAILER));
+    destination->Shrink(destination->GetSize() - encodedSize);
+    if(!m_isContextTakeover) {
+      deflateReset(m_stream.get());
+    }
+  }
+
+  inline void WebSocketDeflater::StreamDeleter::operator ()(
+      z_stream* stream) const {
+    deflateEnd(stream);
+    delete stream;
+  }
+
+  inline WebSocketInflater::WebSocketInflater(bool isContextTakeover)
+      : m_isContextTakeover(isContextTakeover) {
+    auto stream = std::make_unique<z_stream>();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+
+    // The largest window decodes messages compressed with any smaller one.
+    auto result = inflateInit2(stream.get(),
+      -WebSocketDeflateOptions::MAX_WINDOW_BITS);
+    if(result == Z_MEM_ERROR) {
+      BOOST_THROW_EXCEPTION(Codecs::DecoderException("Insufficient memory."));
+    } else if(result != Z_OK) {
+      BOOST_THROW_EXCEPTION(Codecs::DecoderException("Unknown error."));
+    }
+    m_stream.reset(stream.release());
+  }
+
+  template<typename Buffer>
+  void WebSocketInflater::Inflate(const void* data, std::size_t size,
+      Out<Buffer> destination) {
+    const auto MIN_GROWTH = std::size_t(4096);
+    m_stream->next_in = static_cast<Bytef*>(const_cast<void*>(data));
+    m_stream->avail_in = static_cast<uInt>(size);
+    auto decodedSize = destination->GetSize();
+    while(true) {
+      destination->Grow(std::max(MIN_GROWTH, 4 * size));
+      m_stream->next_out = reinterpret_cast<Bytef*>(
+        destination->GetMutableData() + decodedSize);
+      m_stream->avail_out = static_cast<uInt>(destination->GetSize() -
+        decodedSize);
+      auto result = inflate(m_stream.get(), Z_SYNC_FLUSH);
+      decodedSize = destination->GetSize() - m_stream->avail_out;
+      if(result == Z_STREAM_END) {
+
+        // A final block ends the peer's stream, anything after it starts a
+        // new one.
+        inflateReset(m_stream.get());
+      } else if(result == Z_NEED_DICT || result == Z_DATA_ERROR) {
+        destination->Shrink(destination->GetSize() - decodedSize);
+        BOOST_THROW_EXCEPTION(Codecs::DecoderException("Invalid data."));
+      } else if(result == Z_MEM_ERROR) {
+        destination->Shrink(destination->GetSize() - decodedSize);
+        BOOST_THROW_EXCEPTION(Codecs::DecoderException(
+          "Insufficient memory."));
+      }
+      if(m_stream->avail_in == 0 && m_stream->avail_out != 0) {
+        break;
+      }
+    }
+    destination->Shrink(destination->GetSize() - decodedSize);
+  }
+
+  template<typename Buffer>
+  void WebSocketInflater::Finish(Out<Buffer> destination) {
+    Inflate(Details::DEFLATE_MESSAGE_TRAILER,
+      sizeof(Details::DEFLATE_MESSAGE_TRAILER), Store(destination));
+    if(!m_isContextTakeover) {
+      inflateReset(m_stream.get());
+    }
+  }
+
+  inline void WebSocketInflater::StreamDeleter::operator ()(
+      z_stream* stream) const {
+    inflateEnd(stream);
+    delete stream;
+  }
+
+  inline std::string MakeDeflateOffer(const WebSocketDeflateOptions& options) {
+    auto offer = std::string("permessage-deflate; client_max_window_bits");
+    if(options.m_clientMaxWindowBits <
+        WebSocketDeflateOptions::MAX_WINDOW_BITS) {
+      offer += "=" + std::to_string(options.m_clientMaxWindowBits);
+    }
+    if(options.m_serverNoContextTakeover) {
+      offer += "; server_no_context_takeover";
+    }
+    if(options.m_clientNoContextTakeover) {
+      offer += "; client_no_context_takeover";
+    }
+    if(options.m_serverMaxWindowBits <
+        WebSocketDeflateOptions::MAX_WINDOW_BITS) {
+      offer += "; server_max_window_bits=" +
+        std::to_string(options.m_serverMaxWindowBits);
+    }
+    return offer;
+  }
+
+  inline boost::optional<WebSocketDeflateOptions> NegotiateDeflate(
+      std::string_view extensions, const WebSocketDeflateOptions& options) {
+    auto agreement = boost::optional<WebSocketDeflateOptions>();
+    if(options.m_compressionLevel == 0) {
+      return agreement;
+    }
+    Details::ForEachHttpListElement(extensions,
+      [&] (std::string_view extension) {
+        if(agreement.is_initialized() ||
+            Details::GetExtensionName(extension) != "permessage-deflate") {
+          return;
+        }
+        auto offer = WebSocketDeflateOptions();
+        auto hasClientMaxWindowBits = false;
+        if(!Details::ParseDeflateParameters(extension, offer,
+            hasClientMaxWindowBits) || offer.m_serverMaxWindowBits <
+            WebSocketDeflateOptions::MIN_WINDOW_BITS) {
+          return;
+        }
+        agreement = options;
+        agreement->m_serverNoContextTakeover |=
+          offer.m_serverNoContextTakeover;
+        agreement->m_clientNoContextTakeover |=
+          offer.m_clientNoContextTakeover;
+        agreement->m_serverMaxWindowBits = std::max(
+          WebSocketDeflateOptions::MIN_WINDOW_BITS, std::min(
+          options.m_serverMaxWindowBits, offer.m_serverMaxWindowBits));
+
+        // The client's window can only be limited if it said it supports
+        // the parameter.
+        if(hasClientMaxWindowBits) {
+          agreement->m_clientMaxWindowBits = std::max(
+            WebSocketDeflateOptions::MIN_WINDOW_BITS, std::min(
+            options.m_clientMaxWindowBits, offer.m_clientMaxWindowBits));
+        } else {
+          agreement->m_clientMaxWindowBits =
+            WebSocketDeflateOptions::MAX_WINDOW_BITS;
+        }
+      });
+    return agreement;
+  }
+
+  inline std::string MakeDeflateResponse(
+      const WebSocketDeflateOptions& agreement) {
+    auto response = std::string("permessage-deflate");
+    if(agreement.m_serverNoContextTakeover) {
+      response += "; server_no_context_takeover";
+    }
+    if(agreement.m_clientNoContextTakeover) {
+      response += "; client_no_context_takeover";
+    }
+    if(agreement.m_serverMaxWindowBits <
+        WebSocketDeflateOptions::MAX_WINDOW_BITS) {
+      response += "; server_max_window_bits=" +
+        std::to_string(agreement.m_serverMaxWindowBits);
+    }
+    if(agreement.m_clientMaxWindowBits <
+        WebSocketDeflateOptions::MAX_WINDOW_BITS) {
+      response += "; client_max_window_bits=" +
+        std::to_string(agreement.m_clientMaxWindowBits);
+    }
+    return response;
+  }
+
+  inline boost::optional<WebSocketDeflateOptions> ParseDeflateResponse(
+      std::string_view extensions, const WebSocketDeflateOptions& offer) {
+    auto agreement = boost::optional<WebSocketDeflateOptions>();
+    Details::ForEachHttpListElement(extensions,
+      [&] (std::string_view extension) {
+        if(Details::GetExtensionName(extension) != "permessage-deflate") {
+          return;
+        }
+        auto response = WebSocketDeflateOptions();
+        auto hasClientMaxWindowBits = false;
+        if(agreement.is_initialized() || !Details::ParseDeflateParameters(
+            extension, response, hasClientMaxWindowBits) ||
+            response.m_clientMaxWindowBits <
+            WebSocketDeflateOptions::MIN_WINDOW_BITS) {
+          BOOST_THROW_EXCEPTION(IO::ConnectException(
+            "Invalid permessage-deflate response."));
+        }
+        agreement = offer;
+        agreement->m_serverNoContextTakeover =
+          response.m_serverNoContextTakeover;
+        agreement->m_clientNoContextTakeover |=
+          response.m_clientNoContextTakeover;
+        agreement->m_serverMaxWindowBits = response.m_serverMaxWindowBits;
+        agreement->m_clientMaxWindowBits = std::min(
+          offer.m_clientMaxWindowBits, response.m_clientMaxWindowBits);
+      });
+    return agreement;
+  }
+}
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef BEAM_WEBSOCKETDEFLATEOPTIONS_HPP
+#define BEAM_WEBSOCKETDEFLATEOPTIONS_HPP
+#include "Beam/Utilities/YamlConfig.hpp"
+#include "Beam/WebServices/WebServices.hpp"
+
+namespace Beam {
+namespace WebServices {
+
+  /*! \struct WebSocketDeflateOptions
+      \brief Stores the parameters of the permessage-deflate WebSocket
+             extension defined by RFC 7692.
+   */
+  struct WebSocketDeflateOptions {
+
+    //! The default compression level.
+    static constexpr auto DEFAULT_COMPRESSION_LEVEL = 1;
+
+    //! The smallest sliding window zlib is able to compress with.
+    static constexpr auto MIN_WINDOW_BITS = 9;
+
+    //! The largest sliding window.
+    static constexpr auto MAX_WINDOW_BITS = 15;
+
+    //! The zlib level messages are compressed at, from 1 (fastest) to 9
+    //! (smallest), or 0 to disable the extension.
+    int m_compressionLevel;
+
+    //! Whether the server starts every message with an empty sliding window
+    //! rather than the messages it previously sent.
+    bool m_serverNoContextTakeover;
+
+    //! Whether the client starts every message with an empty sliding window
+    //! rather than the messages it previously sent.
+    bool m_clientNoContextTakeover;
+
+    //! The base two logarithm of the server's sliding window size.
+    int m_serverMaxWindowBits;
+
+    //! The base two logarithm of the client's sliding window size.
+    int m_clientMaxWindowBits;
+
+    //! Constructs WebSocketDeflateOptions using the defaults.
+    WebSocketDeflateOptions();
+
+    //! Parses WebSocketDeflateOptions from a YAML Node, using the defaults
+    //! for any missing parameter.
+    /*!
+      \param node The YAML node to parse.
+    */
+    static WebSocketDeflateOptions Parse(const YAML::Node& node);
+  };
+
+  inline WebSocketDeflateOptions::WebSocketDeflateOptions()
+    : m_compressionLevel(DEFAULT_COMPRESSION_LEVEL),
+      m_serverNoContextTakeover(false),
+      m_clientNoContextTakeover(false),
+      m_serverMaxWindowBits(MAX_WINDOW_BITS),
+      m_clientMaxWindowBits(MAX_WINDOW_BITS) {}
+
+  inline WebSocketDeflateOptions WebSocketDeflateOptions::Parse(
+      const YAML::Node& node) {
+    auto options = WebSocketDeflateOptions();
+    options.m_compressionLevel = Extract<int>(node, "compression_level",
+      options.m_compressionLevel);
+    options.m_serverNoContextTakeover = Extract<bool>(node,
+      "server_no_context_takeover", options.m_serverNoContextTakeover);
+    options.m_clientNoContextTakeover = Extract<bool>(node,
+      "client_no_context_takeover", options.m_clientNoContextTakeover);
+    options.m_serverMaxWindowBits = Extract<int>(node,
+      "server_max_window_bits", options.m_serverMaxWindowBits);
+    options.m_clientMaxWindowBits = Extract<int>(node,
+      "client_max_window_bits", options.m_clientMaxWindowBits);
+    return options;
+  }
+}
+}
+
+#endif
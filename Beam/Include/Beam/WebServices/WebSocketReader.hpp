@@ -1,7 +1,7 @@
 #ifndef BEAM_WEBSOCKETREADER_HPP
 #define BEAM_WEBSOCKETREADER_HPP
+#include <limits>
 #include <boost/noncopyable.hpp>
-#include "Beam/IO/BufferReader.hpp"
 #include "Beam/IO/Reader.hpp"
 #include "Beam/IO/SharedBuffer.hpp"
 #include "Beam/WebServices/WebServices.hpp"
@@ -32,67 +32,37 @@ namespace WebServices {
     private:
       template<typename> friend class WebSocketChannel;
       std::shared_ptr<WebSocket> m_socket;
-      boost::optional<IO::BufferReader<IO::SharedBuffer>> m_reader;
 
       WebSocketReader(const std::shared_ptr<WebSocket>& socket);
-      void ReadFromWebSocket();
   };
 
   template<typename WebSocketType>
   bool WebSocketReader<WebSocketType>::IsDataAvailable() const {
-    return m_reader.is_initialized() && m_reader->IsDataAvailable();
+    return m_socket->IsDataAvailable();
   }
 
   template<typename WebSocketType>
   std::size_t WebSocketReader<WebSocketType>::Read(Out<Buffer> destination) {
-    if(!m_reader.is_initialized()) {
-      ReadFromWebSocket();
-    }
-    try {
-      return m_reader->Read(Store(destination));
-    } catch(const IO::EndOfFileException&) {
-      m_reader.reset();
-      return Read(Store(destination));
-    }
+    return m_socket->Read(Store(destination),
+      std::numeric_limits<std::size_t>::max());
   }
 
   template<typename WebSocketType>
   std::size_t WebSocketReader<WebSocketType>::Read(char* destination,
       std::size_t size) {
-    if(!m_reader.is_initialized()) {
-      ReadFromWebSocket();
-    }
-    try {
-      return m_reader->Read(destination, size);
-    } catch(const IO::EndOfFileException&) {
-      m_reader.reset();
-      return Read(destination, size);
-    }
+    return m_socket->Read(destination, size);
   }
 
   template<typename WebSocketType>
   std::size_t WebSocketReader<WebSocketType>::Read(Out<Buffer> destination,
       std::size_t size) {
-    if(!m_reader.is_initialized()) {
-      ReadFromWebSocket();
-    }
-    try {
-      return m_reader->Read(Store(destination), size);
-    } catch(const IO::EndOfFileException&) {
-      m_reader.reset();
-      return Read(Store(destination), size);
-    }
+    return m_socket->Read(Store(destination), size);
   }
 
   template<typename WebSocketType>
   WebSocketReader<WebSocketType>::WebSocketReader(
       const std::shared_ptr<WebSocket>& socket)
       : m_socket{socket} {}
-
-  template<typename WebSocketType>
-  void WebSocketReader<WebSocketType>::ReadFromWebSocket() {
-    m_reader.emplace(m_socket->Read());
-  }
 }
 
   template<typename WebSocketType>
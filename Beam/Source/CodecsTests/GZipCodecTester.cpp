@@ -0,0 +1,80 @@
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/Codecs/GZipDecoder.hpp"
+#include "Beam/Codecs/GZipEncoder.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+
+using namespace Beam;
+using namespace Beam::Codecs;
+using namespace Beam::IO;
+
+namespace {
+  std::string Decode(const SharedBuffer& buffer) {
+    auto decoder = GZipDecoder();
+    auto decodedBuffer = SharedBuffer();
+    decoder.Decode(buffer, Store(decodedBuffer));
+    return std::string(decodedBuffer.GetData(), decodedBuffer.GetSize());
+  }
+}
+
+TEST_SUITE("GZipCodec") {
+  TEST_CASE("empty_message") {
+    auto encoder = GZipEncoder();
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(SharedBuffer(), Store(encodedBuffer));
+    REQUIRE(Decode(encodedBuffer).empty());
+  }
+
+  TEST_CASE("simple_message") {
+    auto encoder = GZipEncoder(Z_BEST_COMPRESSION);
+    auto message = std::string();
+    for(auto i = 0; i < 1000; ++i) {
+      message += "{\"symbol\": \"ABC\", \"price\": " + std::to_string(i) + "}";
+    }
+    auto encodedBuffer = SharedBuffer();
+    auto encodedSize = encoder.Encode(BufferFromString<SharedBuffer>(message),
+      Store(encodedBuffer));
+    REQUIRE(encodedSize < message.size() / 4);
+    REQUIRE(static_cast<unsigned char>(encodedBuffer.GetData()[0]) == 0x1F);
+    REQUIRE(static_cast<unsigned char>(encodedBuffer.GetData()[1]) == 0x8B);
+    REQUIRE(Decode(encodedBuffer) == message);
+  }
+
+  TEST_CASE("concatenated_members") {
+    auto encoder = GZipEncoder();
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(BufferFromString<SharedBuffer>("hello "),
+      Store(encodedBuffer));
+    auto secondBuffer = SharedBuffer();
+    encoder.Encode(BufferFromString<SharedBuffer>("world"),
+      Store(secondBuffer));
+    encodedBuffer.Append(secondBuffer);
+    REQUIRE(Decode(encodedBuffer) == "hello world");
+  }
+
+  TEST_CASE("destination_too_small") {
+    auto encoder = GZipEncoder();
+    auto message = std::string(1000, 'a');
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(BufferFromString<SharedBuffer>(message),
+      Store(encodedBuffer));
+    auto decoder = GZipDecoder();
+    char destination[16];
+    REQUIRE_THROWS_AS(decoder.Decode(encodedBuffer, destination,
+      sizeof(destination)), DecoderException);
+    REQUIRE_THROWS_AS(encoder.Encode(message.data(), message.size(),
+      destination, 8), EncoderException);
+  }
+
+  TEST_CASE("corrupted") {
+    auto encoder = GZipEncoder();
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(BufferFromString<SharedBuffer>("hello world"),
+      Store(encodedBuffer));
+    auto truncatedBuffer = SharedBuffer(encodedBuffer.GetData(),
+      encodedBuffer.GetSize() - 6);
+    REQUIRE_THROWS_AS(Decode(truncatedBuffer), DecoderException);
+    REQUIRE_THROWS_AS(Decode(BufferFromString<SharedBuffer>("hello world")),
+      DecoderException);
+  }
+}
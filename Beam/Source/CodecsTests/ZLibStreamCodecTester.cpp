@@ -0,0 +1,115 @@
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/Codecs/ZLibStreamDecoder.hpp"
+#include "Beam/Codecs/ZLibStreamEncoder.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+
+using namespace Beam;
+using namespace Beam::Codecs;
+using namespace Beam::IO;
+
+namespace {
+  std::string Decode(ZLibStreamDecoder& decoder, const SharedBuffer& buffer) {
+    auto decodedBuffer = SharedBuffer();
+    decoder.Decode(buffer, Store(decodedBuffer));
+    return std::string(decodedBuffer.GetData(), decodedBuffer.GetSize());
+  }
+
+  std::string MakeMessage(int index) {
+    return "{\"account\": \"trader_" + std::to_string(index % 7) +
+      "\", \"symbol\": \"ABC\", \"side\": \"BID\", \"quantity\": " +
+      std::to_string(100 * index) + "}";
+  }
+}
+
+TEST_SUITE("ZLibStreamCodec") {
+  TEST_CASE("raw_below_threshold") {
+    auto encoder = ZLibStreamEncoder();
+    auto decoder = ZLibStreamDecoder();
+    auto message = BufferFromString<SharedBuffer>("hello world");
+    auto encodedBuffer = SharedBuffer();
+    auto encodedSize = encoder.Encode(message, Store(encodedBuffer));
+    REQUIRE(encodedSize == message.GetSize() + 1);
+    REQUIRE(Decode(decoder, encodedBuffer) == "hello world");
+  }
+
+  TEST_CASE("empty_message") {
+    auto encoder = ZLibStreamEncoder(Z_BEST_SPEED, 0);
+    auto decoder = ZLibStreamDecoder();
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(SharedBuffer(), Store(encodedBuffer));
+    REQUIRE(Decode(decoder, encodedBuffer).empty());
+  }
+
+  TEST_CASE("stream") {
+    auto encoder = ZLibStreamEncoder(Z_BEST_SPEED, 0);
+    auto decoder = ZLibStreamDecoder();
+    auto firstSize = std::size_t(0);
+    auto lastSize = std::size_t(0);
+    for(auto i = 0; i < 100; ++i) {
+      auto message = BufferFromString<SharedBuffer>(MakeMessage(i));
+      auto encodedBuffer = SharedBuffer();
+      auto encodedSize = encoder.Encode(message, Store(encodedBuffer));
+      if(i == 0) {
+        firstSize = encodedSize;
+      }
+      lastSize = encodedSize;
+      REQUIRE(Decode(decoder, encodedBuffer) == MakeMessage(i));
+    }
+    REQUIRE(lastSize < firstSize / 2);
+  }
+
+  TEST_CASE("standalone") {
+    auto encoder = ZLibStreamEncoder(Z_BEST_SPEED, 0);
+    auto decoder = ZLibStreamDecoder();
+    auto otherDecoder = ZLibStreamDecoder();
+    auto message = BufferFromString<SharedBuffer>(MakeMessage(0));
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(message, Store(encodedBuffer));
+    REQUIRE(Decode(decoder, encodedBuffer) == MakeMessage(0));
+    auto standaloneBuffer = SharedBuffer();
+    encoder.EncodeStandalone(BufferFromString<SharedBuffer>(MakeMessage(1)),
+      Store(standaloneBuffer));
+    REQUIRE(Decode(decoder, standaloneBuffer) == MakeMessage(1));
+    REQUIRE(Decode(otherDecoder, standaloneBuffer) == MakeMessage(1));
+    encodedBuffer.Reset();
+    encoder.Encode(BufferFromString<SharedBuffer>(MakeMessage(2)),
+      Store(encodedBuffer));
+    REQUIRE(Decode(decoder, encodedBuffer) == MakeMessage(2));
+  }
+
+  TEST_CASE("incompressible") {
+    auto encoder = ZLibStreamEncoder(Z_BEST_COMPRESSION, 0);
+    auto decoder = ZLibStreamDecoder();
+    auto data = std::string();
+    auto seed = std::uint32_t(1);
+    for(auto i = 0; i < 200000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      data += static_cast<char>(seed >> 16);
+    }
+    auto message = BufferFromString<SharedBuffer>(data);
+    auto encodedBuffer = SharedBuffer();
+    auto encodedSize = encoder.Encode(message, Store(encodedBuffer));
+    REQUIRE(encodedSize <= encoder.GetEncodedSizeBound(data.size()));
+    REQUIRE(Decode(decoder, encodedBuffer) == data);
+  }
+
+  TEST_CASE("destination_too_small") {
+    auto encoder = ZLibStreamEncoder(Z_BEST_SPEED, 0);
+    auto decoder = ZLibStreamDecoder();
+    auto message = MakeMessage(0);
+    char destination[16];
+    REQUIRE_THROWS_AS(encoder.Encode(message.data(), message.size(),
+      destination, sizeof(destination)), EncoderException);
+    auto encodedBuffer = SharedBuffer();
+    encoder.Encode(BufferFromString<SharedBuffer>(message),
+      Store(encodedBuffer));
+    REQUIRE(Decode(decoder, encodedBuffer) == message);
+  }
+
+  TEST_CASE("corrupted") {
+    auto decoder = ZLibStreamDecoder();
+    auto encodedBuffer = BufferFromString<SharedBuffer>("\x07" "abc");
+    REQUIRE_THROWS_AS(Decode(decoder, encodedBuffer), DecoderException);
+  }
+}
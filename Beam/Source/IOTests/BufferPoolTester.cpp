@@ -0,0 +1,109 @@
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/BufferPool.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+
+TEST_SUITE("BufferPool") {
+  TEST_CASE("block_size") {
+    REQUIRE(BufferPool::GetBlockSize(0) == BufferPool::MINIMUM_BLOCK_SIZE);
+    REQUIRE(BufferPool::GetBlockSize(1) == BufferPool::MINIMUM_BLOCK_SIZE);
+    REQUIRE(BufferPool::GetBlockSize(64) == 64);
+    REQUIRE(BufferPool::GetBlockSize(65) == 128);
+    REQUIRE(BufferPool::GetBlockSize(3000) == 4096);
+    REQUIRE(BufferPool::GetBlockSize(BufferPool::MAXIMUM_BLOCK_SIZE + 1) ==
+      2 * BufferPool::MAXIMUM_BLOCK_SIZE);
+  }
+
+  TEST_CASE("recycle") {
+    auto& pool = BufferPool::GetInstance();
+    auto size = BufferPool::GetBlockSize(256);
+    auto block = pool.Allocate(size);
+    std::memset(block, 0, size);
+    pool.Deallocate(block, size);
+    auto statistics = pool.GetStatistics();
+    auto recycledBlock = pool.Allocate(size);
+    REQUIRE(recycledBlock == block);
+    auto nextStatistics = pool.GetStatistics();
+    REQUIRE(nextStatistics.m_allocations == statistics.m_allocations + 1);
+    REQUIRE(nextStatistics.m_localHits == statistics.m_localHits + 1);
+    REQUIRE(nextStatistics.m_misses == statistics.m_misses);
+    pool.Deallocate(recycledBlock, size);
+    REQUIRE(pool.GetStatistics().m_deallocations ==
+      nextStatistics.m_deallocations + 1);
+  }
+
+  TEST_CASE("oversized") {
+    auto& pool = BufferPool::GetInstance();
+    auto size = BufferPool::GetBlockSize(BufferPool::MAXIMUM_BLOCK_SIZE + 1);
+    auto statistics = pool.GetStatistics();
+    auto block = pool.Allocate(size);
+    std::memset(block, 0, size);
+    pool.Deallocate(block, size);
+    auto nextStatistics = pool.GetStatistics();
+    REQUIRE(nextStatistics.m_misses == statistics.m_misses + 1);
+    REQUIRE(nextStatistics.m_deallocations == statistics.m_deallocations + 1);
+  }
+
+  TEST_CASE("disabled") {
+    auto& pool = BufferPool::GetInstance();
+    auto size = BufferPool::GetBlockSize(512);
+    pool.Deallocate(pool.Allocate(size), size);
+    pool.SetEnabled(false);
+    REQUIRE(!pool.IsEnabled());
+    auto statistics = pool.GetStatistics();
+    auto block = pool.Allocate(size);
+    pool.Deallocate(block, size);
+    auto nextStatistics = pool.GetStatistics();
+    REQUIRE(nextStatistics.m_misses == statistics.m_misses + 1);
+    REQUIRE(nextStatistics.m_localHits == statistics.m_localHits);
+    pool.SetEnabled(true);
+    REQUIRE(pool.IsEnabled());
+  }
+
+  TEST_CASE("cross_thread") {
+    auto& pool = BufferPool::GetInstance();
+    auto size = BufferPool::GetBlockSize(1024);
+    auto blocks = std::vector<char*>();
+    for(auto i = 0; i < 100; ++i) {
+      blocks.push_back(pool.Allocate(size));
+    }
+    auto statistics = pool.GetStatistics();
+    auto thread = std::thread(
+      [&] {
+        for(auto block : blocks) {
+          pool.Deallocate(block, size);
+        }
+      });
+    thread.join();
+    auto nextStatistics = pool.GetStatistics();
+    REQUIRE(nextStatistics.m_deallocations ==
+      statistics.m_deallocations + blocks.size());
+    auto block = pool.Allocate(size);
+    REQUIRE(pool.GetStatistics().m_misses == nextStatistics.m_misses);
+    pool.Deallocate(block, size);
+  }
+
+  TEST_CASE("shared_buffer") {
+    auto& pool = BufferPool::GetInstance();
+    auto statistics = pool.GetStatistics();
+    {
+      auto buffer = SharedBuffer();
+      buffer.Append("hello world", 11);
+      auto copy = buffer;
+      copy.Append('!');
+      REQUIRE(std::string(buffer.GetData(), buffer.GetSize()) ==
+        "hello world");
+      REQUIRE(std::string(copy.GetData(), copy.GetSize()) == "hello world!");
+    }
+    auto nextStatistics = pool.GetStatistics();
+    REQUIRE(nextStatistics.m_allocations > statistics.m_allocations);
+    REQUIRE(nextStatistics.m_allocations - statistics.m_allocations ==
+      nextStatistics.m_deallocations - statistics.m_deallocations);
+  }
+}
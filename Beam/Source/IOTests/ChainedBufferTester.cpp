@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/IO/ChainedBuffer.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+
+namespace {
+  auto MakeLargeBuffer(char value) {
+    auto buffer = SharedBuffer();
+    for(auto i = std::size_t(0); i < ChainedBuffer::MINIMUM_SHARE_SIZE; ++i) {
+      buffer.Append(value);
+    }
+    return buffer;
+  }
+
+  auto ToString(const ChainedBuffer& buffer) {
+    auto result = std::string();
+    buffer.ForEachSegment(
+      [&] (const char* data, std::size_t size) {
+        result.append(data, size);
+      });
+    return result;
+  }
+}
+
+TEST_SUITE("ChainedBuffer") {
+  TEST_CASE("create_empty") {
+    auto buffer = ChainedBuffer();
+    REQUIRE(buffer.IsEmpty());
+    REQUIRE(buffer.GetSize() == 0);
+    REQUIRE(buffer.GetData() == nullptr);
+    REQUIRE(buffer.GetSegmentCount() == 0);
+  }
+
+  TEST_CASE("append") {
+    auto buffer = ChainedBuffer();
+    buffer.Append("hello", 5);
+    buffer.Append(' ');
+    buffer.Append("world", 5);
+    REQUIRE(buffer.GetSegmentCount() == 1);
+    REQUIRE(buffer == std::string("hello world"));
+  }
+
+  TEST_CASE("share_large_buffer") {
+    auto body = MakeLargeBuffer('a');
+    auto buffer = ChainedBuffer();
+    buffer.Append("header", 6);
+    buffer.Append(body);
+    REQUIRE(buffer.GetSegmentCount() == 2);
+    REQUIRE(buffer.GetSize() == 6 + body.GetSize());
+    auto size = std::size_t(0);
+    auto isShared = false;
+    buffer.ForEachSegment(
+      [&] (const char* data, std::size_t segmentSize) {
+        if(data == body.GetData()) {
+          isShared = true;
+        }
+        size += segmentSize;
+      });
+    REQUIRE(isShared);
+    REQUIRE(size == buffer.GetSize());
+    REQUIRE(ToString(buffer) ==
+      "header" + std::string(body.GetData(), body.GetSize()));
+  }
+
+  TEST_CASE("copy_small_buffer") {
+    auto buffer = ChainedBuffer();
+    buffer.Append("abc", 3);
+    buffer.Append(BufferFromString<SharedBuffer>("def"));
+    REQUIRE(buffer.GetSegmentCount() == 1);
+    REQUIRE(buffer == std::string("abcdef"));
+  }
+
+  TEST_CASE("prepend") {
+    auto body = MakeLargeBuffer('b');
+    auto buffer = ChainedBuffer(body);
+    buffer.Prepend(std::uint32_t(body.GetSize()));
+    REQUIRE(buffer.GetSegmentCount() == 2);
+    REQUIRE(buffer.GetSize() == sizeof(std::uint32_t) + body.GetSize());
+    REQUIRE(buffer.Extract<std::uint32_t>(0) == body.GetSize());
+    REQUIRE(buffer.Extract<char>(sizeof(std::uint32_t)) == 'b');
+    auto header = ChainedBuffer("GET ", 4);
+    buffer.Prepend(header);
+    REQUIRE(buffer.GetSegmentCount() == 3);
+    REQUIRE(ToString(buffer).substr(0, 4) == "GET ");
+  }
+
+  TEST_CASE("write_across_segments") {
+    auto body = MakeLargeBuffer('c');
+    auto buffer = ChainedBuffer();
+    buffer.Append("12345", 5);
+    buffer.Append(body);
+    buffer.Write(3, "xyz", 3);
+    REQUIRE(ToString(buffer).substr(0, 7) == "123xyzc");
+    REQUIRE(body.GetData()[0] == 'c');
+    REQUIRE(buffer.Extract<char>(5) == 'z');
+  }
+
+  TEST_CASE("shrink") {
+    auto body = MakeLargeBuffer('d');
+    auto buffer = ChainedBuffer();
+    buffer.Append("front", 5);
+    buffer.Append(body);
+    buffer.Append("back", 4);
+    buffer.ShrinkFront(7);
+    REQUIRE(buffer.GetSize() == body.GetSize() + 2);
+    REQUIRE(buffer.GetSegmentCount() == 2);
+    buffer.Shrink(4);
+    REQUIRE(buffer.GetSize() == body.GetSize() - 2);
+    REQUIRE(buffer.GetSegmentCount() == 1);
+    buffer.Append("!", 1);
+    REQUIRE(buffer.GetSize() == body.GetSize() - 1);
+    REQUIRE(buffer.Extract<char>(buffer.GetSize() - 1) == '!');
+    buffer.Shrink(buffer.GetSize());
+    REQUIRE(buffer.IsEmpty());
+  }
+
+  TEST_CASE("coalesce") {
+    auto body = MakeLargeBuffer('e');
+    auto buffer = ChainedBuffer();
+    buffer.Append("head", 4);
+    buffer.Append(body);
+    auto expected = "head" + std::string(body.GetData(), body.GetSize());
+    REQUIRE(std::string(buffer.GetData(), buffer.GetSize()) == expected);
+    REQUIRE(buffer.GetSegmentCount() == 1);
+    buffer.GetMutableData()[0] = 'H';
+    REQUIRE(buffer.Extract<char>(0) == 'H');
+  }
+
+  TEST_CASE("copy_on_write") {
+    auto buffer = ChainedBuffer();
+    buffer.Append("hello", 5);
+    auto copy = buffer;
+    copy.Append(" world", 6);
+    buffer.Write(0, 'j');
+    REQUIRE(buffer == std::string("jello"));
+    REQUIRE(copy == std::string("hello world"));
+  }
+}
@@ -0,0 +1,107 @@
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/LocalPipeReader.hpp"
+#include "Beam/IO/LocalPipeWriter.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+
+TEST_SUITE("LocalPipe") {
+  TEST_CASE("write_then_read") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        writer.Write(BufferFromString<SharedBuffer>("hello world"));
+      }));
+    auto buffer = SharedBuffer();
+    reader.Read(Store(buffer));
+    REQUIRE(std::string(buffer.GetData(), buffer.GetSize()) == "hello world");
+    task.Wait();
+  }
+
+  TEST_CASE("hand_off") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    auto message = BufferFromString<SharedBuffer>("hello");
+    writer.Write(message);
+    auto buffer = SharedBuffer();
+    REQUIRE(reader.Read(Store(buffer)) == 5);
+    REQUIRE(buffer.GetData() == message.GetData());
+  }
+
+  TEST_CASE("partial_reads") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    writer.Write("abcdef", 6);
+    writer.Write("gh", 2);
+    auto buffer = SharedBuffer();
+    REQUIRE(reader.Read(Store(buffer), 4) == 4);
+    REQUIRE(reader.Read(Store(buffer), 4) == 2);
+    char tail[2];
+    REQUIRE(reader.Read(tail, 4) == 2);
+    REQUIRE(std::string(buffer.GetData(), buffer.GetSize()) == "abcdef");
+    REQUIRE(std::string(tail, 2) == "gh");
+    REQUIRE(!reader.IsDataAvailable());
+  }
+
+  TEST_CASE("order_across_blocks") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        for(auto i = 0; i < 1000; ++i) {
+          writer.Write(BufferFromString<SharedBuffer>(std::to_string(i)));
+          if(i % 100 == 0) {
+            Defer();
+          }
+        }
+      }));
+    for(auto i = 0; i < 1000; ++i) {
+      auto buffer = SharedBuffer();
+      reader.Read(Store(buffer));
+      REQUIRE(std::string(buffer.GetData(), buffer.GetSize()) ==
+        std::to_string(i));
+    }
+    task.Wait();
+  }
+
+  TEST_CASE("multiple_writers") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    auto tasks = std::vector<RoutineHandler>();
+    for(auto i = 0; i < 4; ++i) {
+      tasks.emplace_back(Spawn(
+        [&] {
+          for(auto j = 0; j < 500; ++j) {
+            writer.Write("x", 1);
+          }
+        }));
+    }
+    auto count = std::size_t(0);
+    while(count < 2000) {
+      auto buffer = SharedBuffer();
+      count += reader.Read(Store(buffer));
+    }
+    REQUIRE(count == 2000);
+  }
+
+  TEST_CASE("break") {
+    auto reader = LocalPipeReader<SharedBuffer>();
+    auto writer = LocalPipeWriter<SharedBuffer>(Ref(reader));
+    writer.Write("last", 4);
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        writer.Break();
+      }));
+    auto buffer = SharedBuffer();
+    REQUIRE(reader.Read(Store(buffer)) == 4);
+    REQUIRE_THROWS_AS(reader.Read(Store(buffer)), EndOfFileException);
+    REQUIRE_THROWS_AS(writer.Write("x", 1), EndOfFileException);
+    task.Wait();
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef _WIN32
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/IO/ConnectException.hpp"
+#include "Beam/IO/SharedMemoryServerConnection.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+
+namespace {
+  auto GetServerName() {
+    return "test." + std::to_string(::getpid());
+  }
+
+  auto ReadString(SharedMemoryChannel::Reader& reader, std::size_t size) {
+    auto buffer = SharedBuffer();
+    while(buffer.GetSize() < size) {
+      reader.Read(Store(buffer), size - buffer.GetSize());
+    }
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+}
+
+TEST_SUITE("SharedMemoryServerConnection") {
+  TEST_CASE("accept_then_close") {
+    auto server = SharedMemoryServerConnection(GetServerName());
+    server.Open();
+    auto handled = false;
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        try {
+          server.Accept();
+        } catch(const EndOfFileException&) {
+          handled = true;
+        }
+      }));
+    server.Close();
+    task.Wait();
+    REQUIRE(handled);
+  }
+
+  TEST_CASE("open_without_server") {
+    auto client = SharedMemoryChannel(GetServerName());
+    REQUIRE_THROWS_AS(client.GetConnection().Open(), ConnectException);
+  }
+
+  TEST_CASE("read_write") {
+    auto server = SharedMemoryServerConnection(GetServerName());
+    server.Open();
+    auto client = SharedMemoryChannel(GetServerName());
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        client.GetConnection().Open();
+        client.GetWriter().Write(BufferFromString<SharedBuffer>("hello"));
+        REQUIRE(ReadString(client.GetReader(), 5) == "world");
+      }));
+    auto channel = server.Accept();
+    REQUIRE(ReadString(channel->GetReader(), 5) == "hello");
+    channel->GetWriter().Write(BufferFromString<SharedBuffer>("world"));
+    task.Wait();
+  }
+
+  TEST_CASE("write_larger_than_ring") {
+    auto server = SharedMemoryServerConnection(GetServerName());
+    server.Open();
+    auto client = SharedMemoryChannel(GetServerName(),
+      SharedMemoryChannel::MINIMUM_CAPACITY);
+    auto message = std::string();
+    for(auto i = 0; i < 10000; ++i) {
+      message += std::to_string(i);
+    }
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        client.GetConnection().Open();
+        client.GetWriter().Write(message.data(), message.size());
+      }));
+    auto channel = server.Accept();
+    REQUIRE(ReadString(channel->GetReader(), message.size()) == message);
+    task.Wait();
+  }
+
+  TEST_CASE("close_client") {
+    auto server = SharedMemoryServerConnection(GetServerName());
+    server.Open();
+    auto client = SharedMemoryChannel(GetServerName());
+    auto task = RoutineHandler(Spawn(
+      [&] {
+        client.GetConnection().Open();
+        client.GetWriter().Write(BufferFromString<SharedBuffer>("bye"));
+        client.GetConnection().Close();
+      }));
+    auto channel = server.Accept();
+    task.Wait();
+    REQUIRE(ReadString(channel->GetReader(), 3) == "bye");
+    auto buffer = SharedBuffer();
+    REQUIRE_THROWS_AS(channel->GetReader().Read(Store(buffer)),
+      EndOfFileException);
+    REQUIRE_THROWS_AS(
+      channel->GetWriter().Write(BufferFromString<SharedBuffer>("x")),
+      EndOfFileException);
+  }
+}
+#endif
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Json/JsonParser.hpp"
+#include "Beam/Json/JsonReader.hpp"
+#include "Beam/Serialization/JsonReceiver.hpp"
+#include "Beam/Serialization/JsonSender.hpp"
+#include "Beam/Serialization/JsonSequenceReceiver.hpp"
+#include "Beam/Serialization/ShuttleVector.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+
+namespace {
+  const auto ITERATIONS = 2000;
+
+  /** A record of the kind returned by a query, shuttled as JSON. */
+  struct Record {
+    int m_id;
+    std::string m_symbol;
+    std::string m_description;
+    double m_price;
+    int m_quantity;
+    bool m_isLive;
+  };
+
+  /** Builds a payload typical of a web API, an array of records mixing
+      strings, numbers, booleans and nested objects. */
+  std::string MakePayload(int records) {
+    auto payload = std::string("[");
+    for(auto i = 0; i < records; ++i) {
+      if(i != 0) {
+        payload += ",";
+      }
+      payload += "{\"id\": " + std::to_string(1000 + i) +
+        ", \"symbol\": \"SYM" + std::to_string(i % 97) + ".TSX\", "
+        "\"description\": \"Order placed by \\\"desk " + std::to_string(i % 7) +
+        "\\\" on the primary venue\", \"price\": " +
+        std::to_string(10 + (i % 100) / 8.0) + ", \"quantity\": " +
+        std::to_string(100 * (i % 13 + 1)) + ", \"is_live\": " +
+        (i % 2 == 0 ? "true" : "false") + ", \"account\": {\"name\": "
+        "\"trader" + std::to_string(i % 11) + "\", \"tags\": [\"equity\", "
+        "\"north_america\"], \"limit\": null}}";
+    }
+    payload += "]";
+    return payload;
+  }
+
+  template<typename F>
+  void Profile(const std::string& name, const std::string& payload, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for(auto i = 0; i < ITERATIONS; ++i) {
+      f();
+    }
+    auto elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed << "s " <<
+      static_cast<int>(ITERATIONS * payload.size() / elapsed / 1000000) <<
+      " MB/s" << std::endl;
+  }
+
+  std::vector<Record> MakeRecords(int records) {
+    auto result = std::vector<Record>();
+    for(auto i = 0; i < records; ++i) {
+      result.push_back({1000 + i, "SYM" + std::to_string(i % 97) + ".TSX",
+        "Order placed by \"desk " + std::to_string(i % 7) +
+        "\" on the primary venue", 10 + (i % 100) / 8.0, 100 * (i % 13 + 1),
+        i % 2 == 0});
+    }
+    return result;
+  }
+}
+
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Record> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle, Record& value,
+        unsigned int version) const {
+      shuttle.Shuttle("id", value.m_id);
+      shuttle.Shuttle("symbol", value.m_symbol);
+      shuttle.Shuttle("description", value.m_description);
+      shuttle.Shuttle("price", value.m_price);
+      shuttle.Shuttle("quantity", value.m_quantity);
+      shuttle.Shuttle("is_live", value.m_isLive);
+    }
+  };
+}
+
+namespace {
+  void ProfileShuttling() {
+    auto records = MakeRecords(1000);
+    auto sink = SharedBuffer();
+    auto sender = JsonSender<SharedBuffer>();
+    sender.SetSink(Ref(sink));
+    sender.Shuttle(records);
+    auto payload = std::string(sink.GetData(), sink.GetSize());
+    Profile("JsonSender", payload, [&] {
+      auto sink = SharedBuffer();
+      sender.SetSink(Ref(sink));
+      sender.Shuttle(records);
+    });
+    auto receiver = JsonReceiver<SharedBuffer>();
+    Profile("JsonReceiver", payload, [&] {
+      auto result = std::vector<Record>();
+      receiver.SetSource(Ref(sink));
+      receiver.Shuttle(result);
+    });
+    auto sequenceReceiver = JsonSequenceReceiver<Record, SharedBuffer>();
+    Profile("JsonSequenceReceiver", payload, [&] {
+      auto record = Record();
+      sequenceReceiver.SetSource(Ref(sink));
+      while(sequenceReceiver.Receive(Store(record))) {}
+    });
+  }
+}
+
+int main() {
+  auto payload = MakePayload(100);
+  auto source = BufferFromString<SharedBuffer>(payload);
+  auto value = ParseJson(payload);
+  auto stream = Parsers::ReaderParserStream<BufferReader<SharedBuffer>>(
+    source);
+  auto expected = JsonValue();
+  if(!JsonParser::GetParser().Read(stream, expected) || expected != value) {
+    std::cerr << "Parsers disagree." << std::endl;
+    return 1;
+  }
+  Profile("JsonParser", payload, [&] {
+    auto stream = Parsers::ReaderParserStream<BufferReader<SharedBuffer>>(
+      source);
+    auto result = JsonValue();
+    JsonParser::GetParser().Read(stream, result);
+  });
+  auto reader = JsonReader();
+  Profile("JsonReader", payload, [&] {
+    reader.SetSource(source.GetData(), source.GetSize());
+    reader.Read();
+  });
+  Profile("SaveToStream", payload, [&] {
+    auto sink = std::stringstream();
+    value.Save(sink);
+  });
+  Profile("SaveToBuffer", payload, [&] {
+    auto sink = SharedBuffer();
+    value.Save(Store(sink));
+  });
+  ProfileShuttling();
+}
@@ -0,0 +1,63 @@
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/Json/JsonObject.hpp"
+
+using namespace Beam;
+
+TEST_SUITE("JsonObject") {
+  TEST_CASE("members") {
+    auto object = JsonObject();
+    REQUIRE(object.GetSize() == 0);
+    REQUIRE(!object.Get("a").is_initialized());
+    REQUIRE_THROWS_AS(object.At("a"), std::out_of_range);
+    object["a"] = 1;
+    object.Set("b", "two");
+    object.Set("a", 3);
+    REQUIRE(object.GetSize() == 2);
+    REQUIRE(object.At("a") == JsonValue(3));
+    REQUIRE(*object.Get("b") == JsonValue("two"));
+    REQUIRE(object["c"] == JsonValue());
+    REQUIRE(object.GetSize() == 3);
+  }
+
+  TEST_CASE("many_members") {
+    const auto MEMBERS = 100;
+    auto object = JsonObject();
+    for(auto i = 0; i < MEMBERS; ++i) {
+      object.Set("member" + std::to_string(i), i);
+    }
+    for(auto i = 0; i < MEMBERS; i += 2) {
+      object["member" + std::to_string(i)] = -i;
+    }
+    REQUIRE(object.GetSize() == MEMBERS);
+    for(auto i = 0; i < MEMBERS; ++i) {
+      auto expected = i % 2 == 0 ? -i : i;
+      REQUIRE(object.At("member" + std::to_string(i)) == JsonValue(expected));
+    }
+    REQUIRE(!object.Get("member" + std::to_string(MEMBERS)).is_initialized());
+  }
+
+  TEST_CASE("equality") {
+    auto a = JsonObject();
+    a.Set("x", 1);
+    a.Set("y", "z");
+    auto b = JsonObject();
+    b.Set("y", "z");
+    b.Set("x", 1);
+    REQUIRE(a == b);
+    b.Set("x", 2);
+    REQUIRE(a != b);
+    b.Set("x", 1);
+    b.Set("w", JsonNull());
+    REQUIRE(a != b);
+  }
+
+  TEST_CASE("copies_are_independent") {
+    auto a = JsonObject();
+    a.Set("x", 1);
+    auto b = a;
+    b.Set("x", 2);
+    REQUIRE(a.At("x") == JsonValue(1));
+    REQUIRE(b.At("x") == JsonValue(2));
+  }
+}
@@ -0,0 +1,167 @@
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/Json/JsonParser.hpp"
+#include "Beam/Json/JsonReader.hpp"
+
+using namespace Beam;
+
+namespace {
+  JsonValue ParseWithJsonParser(const std::string& source) {
+    auto stream = Parsers::ReaderParserStream<IO::BufferReader<
+      IO::SharedBuffer>>(IO::BufferFromString<IO::SharedBuffer>(source));
+    auto value = JsonValue();
+    REQUIRE(JsonParser::GetParser().Read(stream, value));
+    return value;
+  }
+
+  void RequireInvalid(const std::string& source) {
+    REQUIRE_THROWS_AS(ParseJson(source), JsonParserException);
+  }
+}
+
+TEST_SUITE("JsonReader") {
+  TEST_CASE("literals") {
+    REQUIRE(ParseJson("null") == JsonValue());
+    REQUIRE(ParseJson("true") == JsonValue(true));
+    REQUIRE(ParseJson(" \t\r\nfalse \n") == JsonValue(false));
+    RequireInvalid("nul");
+    RequireInvalid("True");
+    RequireInvalid("");
+    RequireInvalid("   ");
+  }
+
+  TEST_CASE("numbers") {
+    REQUIRE(ParseJson("0") == JsonValue(0));
+    REQUIRE(ParseJson("-0") == JsonValue(0));
+    REQUIRE(ParseJson("123") == JsonValue(123));
+    REQUIRE(ParseJson("-9007199254740992") ==
+      JsonValue(-9007199254740992.0));
+    REQUIRE(ParseJson("3.25") == JsonValue(3.25));
+    REQUIRE(ParseJson("-0.1") == JsonValue(-0.1));
+    REQUIRE(ParseJson("1e3") == JsonValue(1000));
+    REQUIRE(ParseJson("2.5E-3") == JsonValue(0.0025));
+    REQUIRE(ParseJson("1e-400") == JsonValue(0));
+    RequireInvalid("1e400");
+    RequireInvalid("01");
+    RequireInvalid("+1");
+    RequireInvalid("1.");
+    RequireInvalid(".5");
+    RequireInvalid("1e");
+    RequireInvalid("-");
+  }
+
+  TEST_CASE("strings") {
+    REQUIRE(ParseJson("\"\"") == JsonValue(""));
+    REQUIRE(ParseJson("\"hello world\"") == JsonValue("hello world"));
+    REQUIRE(ParseJson("\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\"") ==
+      JsonValue("a\"b\\c/d\b\f\n\r\t"));
+    REQUIRE(ParseJson("\"\\u0041\\u00e9\\u20AC\\ud83d\\ude00\"") ==
+      JsonValue("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"));
+    REQUIRE(ParseJson("\"\xC3\xA9t\xC3\xA9\"") ==
+      JsonValue("\xC3\xA9t\xC3\xA9"));
+
+    // Strings long enough to be scanned in blocks, with the special
+    // character at every offset of a block.
+    for(auto i = 0; i < 40; ++i) {
+      auto prefix = std::string(static_cast<std::size_t>(i), 'x');
+      REQUIRE(ParseJson("\"" + prefix + "\\n" + prefix + "\"") ==
+        JsonValue(prefix + "\n" + prefix));
+      RequireInvalid("\"" + prefix + "\x01\"");
+      RequireInvalid("\"" + prefix);
+    }
+    RequireInvalid("\"\\x\"");
+    RequireInvalid("\"\\u12\"");
+    RequireInvalid("\"\\ud83d\"");
+    RequireInvalid("\"\\ude00\"");
+    RequireInvalid("\"\\ud83d\\u0041\"");
+  }
+
+  TEST_CASE("aggregates") {
+    auto value = ParseJson(
+      "{\"a\": [1, 2, {\"b\": []}], \"c\": {}, \"d\": \"e\", \"a\": null}");
+    auto object = boost::get<JsonObject>(&value);
+    REQUIRE(object != nullptr);
+    REQUIRE(object->GetSize() == 3);
+    REQUIRE(object->At("a") == JsonValue());
+    REQUIRE(object->At("c") == JsonValue(JsonObject()));
+    REQUIRE(object->At("d") == JsonValue("e"));
+    auto array = ParseJson("[[1, [2, [3]]], \"x\", true]");
+    auto expected = std::vector<JsonValue>();
+    expected.push_back(std::vector<JsonValue>{1,
+      std::vector<JsonValue>{2, std::vector<JsonValue>{3}}});
+    expected.push_back("x");
+    expected.push_back(true);
+    REQUIRE(array == JsonValue(expected));
+    RequireInvalid("[1, 2");
+    RequireInvalid("[1 2]");
+    RequireInvalid("[1, ]");
+    RequireInvalid("{\"a\" 1}");
+    RequireInvalid("{\"a\": 1,}");
+    RequireInvalid("{a: 1}");
+    RequireInvalid("{\"a\": 1]");
+    RequireInvalid("[1] 2");
+  }
+
+  TEST_CASE("deep_nesting") {
+    const auto DEPTH = 100000;
+    auto source = std::string(DEPTH, '[') + std::string(DEPTH, ']');
+    auto value = ParseJson(source);
+    auto depth = 0;
+    auto array = boost::get<std::vector<JsonValue>>(&value);
+    while(array != nullptr && !array->empty()) {
+      ++depth;
+      array = boost::get<std::vector<JsonValue>>(&array->front());
+    }
+    REQUIRE(depth == DEPTH - 1);
+  }
+
+  TEST_CASE("sequential_values") {
+    auto source = std::string("{\"a\": 1} [2] \"three\" ");
+    auto reader = JsonReader(source.data(), source.size());
+    auto object = JsonObject();
+    object.Set("a", 1);
+    REQUIRE(reader.Read() == JsonValue(object));
+    REQUIRE(reader.Read() == JsonValue(std::vector<JsonValue>{2}));
+    REQUIRE(!reader.IsEnd());
+    REQUIRE(reader.Read() == JsonValue("three"));
+    REQUIRE(reader.IsEnd());
+  }
+
+  TEST_CASE("array_elements") {
+    auto source = std::string(" [ {\"a\": [1]}, 2 ,\"three\" ] ");
+    auto reader = JsonReader(source.data(), source.size());
+    reader.ReadArrayStart();
+    REQUIRE(reader.ReadArrayNext());
+    auto object = JsonObject();
+    object.Set("a", std::vector<JsonValue>{1});
+    REQUIRE(reader.Read() == JsonValue(object));
+    REQUIRE(reader.ReadArrayNext());
+    REQUIRE(reader.Read() == JsonValue(2));
+    REQUIRE(reader.ReadArrayNext());
+    REQUIRE(reader.Read() == JsonValue("three"));
+    REQUIRE(!reader.ReadArrayNext());
+    REQUIRE(reader.IsEnd());
+    auto empty = std::string("[]");
+    reader.SetSource(empty.data(), empty.size());
+    reader.ReadArrayStart();
+    REQUIRE(!reader.ReadArrayNext());
+    auto missingComma = std::string("[1 2]");
+    reader.SetSource(missingComma.data(), missingComma.size());
+    reader.ReadArrayStart();
+    REQUIRE(reader.ReadArrayNext());
+    reader.Read();
+    REQUIRE_THROWS_AS(reader.ReadArrayNext(), JsonParserException);
+    auto notArray = std::string("{}");
+    reader.SetSource(notArray.data(), notArray.size());
+    REQUIRE_THROWS_AS(reader.ReadArrayStart(), JsonParserException);
+  }
+
+  TEST_CASE("matches_json_parser") {
+    auto source = std::string("{\"symbol\": \"ABX.TSX\", \"price\": 12.5, "
+      "\"sizes\": [100, 200, 300], \"halted\": false, \"venue\": null, "
+      "\"book\": {\"bid\": 12.25, \"ask\": 12.75, \"quotes\": [{\"mpid\": "
+      "\"NSDQ\", \"size\": 1}]}}");
+    REQUIRE(ParseJson(source) == ParseWithJsonParser(source));
+  }
+}
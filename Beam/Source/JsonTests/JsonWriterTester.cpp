@@ -0,0 +1,80 @@
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Json/JsonReader.hpp"
+#include "Beam/Json/JsonWriter.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+
+namespace {
+  std::string WriteString(const std::string& value) {
+    auto buffer = SharedBuffer();
+    WriteJsonString(value, Store(buffer));
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string WriteNumber(double value) {
+    auto buffer = SharedBuffer();
+    WriteJsonNumber(value, Store(buffer));
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string Save(const JsonValue& value) {
+    auto buffer = SharedBuffer();
+    value.Save(Store(buffer));
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+}
+
+TEST_SUITE("JsonWriter") {
+  TEST_CASE("strings") {
+    REQUIRE(WriteString("") == "\"\"");
+    REQUIRE(WriteString("hello") == "\"hello\"");
+    REQUIRE(WriteString("a\"b\\c\n\r\t\b\f") ==
+      "\"a\\\"b\\\\c\\n\\r\\t\\b\\f\"");
+    REQUIRE(WriteString(std::string("\x01\x1F\x7F", 3)) ==
+      "\"\\u0001\\u001f\x7F\"");
+    REQUIRE(WriteString("\xC3\xA9/") == "\"\xC3\xA9/\"");
+    for(auto i = 0; i < 40; ++i) {
+      auto prefix = std::string(static_cast<std::size_t>(i), 'x');
+      REQUIRE(WriteString(prefix + "\"" + prefix) ==
+        "\"" + prefix + "\\\"" + prefix + "\"");
+    }
+  }
+
+  TEST_CASE("numbers") {
+    REQUIRE(WriteNumber(0) == "0");
+    REQUIRE(WriteNumber(-0.0) == "0");
+    REQUIRE(WriteNumber(42) == "42");
+    REQUIRE(WriteNumber(-3000000000.0) == "-3000000000");
+    REQUIRE(WriteNumber(0.1) == "0.1");
+    REQUIRE(WriteNumber(-2.5) == "-2.5");
+    REQUIRE(WriteNumber(1e-7) == "1e-07");
+    REQUIRE(WriteNumber(1e300) == "1e+300");
+    REQUIRE(WriteNumber(std::numeric_limits<double>::quiet_NaN()) == "null");
+    REQUIRE(WriteNumber(std::numeric_limits<double>::infinity()) == "null");
+    for(auto value : {0.1, 1.0 / 3, 123456.789, 2.2250738585072014e-308,
+        1.7976931348623157e308}) {
+      REQUIRE(ParseJson(WriteNumber(value)) == JsonValue(value));
+    }
+  }
+
+  TEST_CASE("values") {
+    auto object = JsonObject();
+    object["name"] = "quote \"a\"";
+    object["size"] = 100;
+    object["price"] = 12.25;
+    object["flags"] = std::vector<JsonValue>{true, false, JsonNull()};
+    object["empty"] = JsonObject();
+    REQUIRE(Save(object) == "{\"name\":\"quote \\\"a\\\"\",\"size\":100,"
+      "\"price\":12.25,\"flags\":[true,false,null],\"empty\":{}}");
+    auto stream = std::stringstream();
+    stream << JsonValue(object);
+    REQUIRE(stream.str() == Save(object));
+    REQUIRE(ParseJson(Save(object)) == JsonValue(object));
+  }
+}
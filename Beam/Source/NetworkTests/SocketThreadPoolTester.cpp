@@ -0,0 +1,77 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Network/SocketThreadPool.hpp"
+#include "Beam/Network/TcpServerSocket.hpp"
+#include "Beam/Routines/RoutineHandlerGroup.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Network;
+using namespace Beam::Routines;
+
+namespace {
+  const auto ADDRESS = IpAddress("127.0.0.1", 20201);
+
+  void TestEcho(SocketThreadPool& pool, int channelCount) {
+    auto server = TcpServerSocket(ADDRESS, Ref(pool));
+    server.Open();
+    auto clients = RoutineHandlerGroup();
+    auto replies = std::vector<std::string>(channelCount);
+    for(auto i = 0; i < channelCount; ++i) {
+      clients.Spawn(
+        [&, i] {
+          auto client = TcpSocketChannel(ADDRESS, Ref(pool));
+          client.GetConnection().Open();
+          client.GetWriter().Write(BufferFromString<SharedBuffer>(
+            std::to_string(i % 10)));
+          auto reply = SharedBuffer();
+          ReadExactSize(client.GetReader(), Store(reply), 1);
+          replies[i] = std::string(reply.GetData(), reply.GetSize());
+        });
+    }
+    auto channels = std::vector<std::unique_ptr<TcpSocketChannel>>();
+    for(auto i = 0; i < channelCount; ++i) {
+      channels.push_back(server.Accept());
+    }
+    for(auto& channel : channels) {
+      auto message = SharedBuffer();
+      ReadExactSize(channel->GetReader(), Store(message), 1);
+      channel->GetWriter().Write(message);
+    }
+    clients.Wait();
+    for(auto i = 0; i < channelCount; ++i) {
+      REQUIRE(replies[i] == std::to_string(i % 10));
+    }
+  }
+}
+
+TEST_SUITE("SocketThreadPool") {
+  TEST_CASE("shared") {
+    auto pool = SocketThreadPool(2);
+    REQUIRE(pool.GetMode() == SocketThreadPool::Mode::SHARED);
+    REQUIRE(pool.GetThreadCount() == 2);
+    TestEcho(pool, 4);
+  }
+
+  TEST_CASE("empty_thread_count") {
+    auto pool = SocketThreadPool(0, SocketThreadPool::Mode::SHARDED, false);
+    REQUIRE(pool.GetMode() == SocketThreadPool::Mode::SHARDED);
+    REQUIRE(pool.GetThreadCount() == 1);
+    TestEcho(pool, 2);
+  }
+
+  TEST_CASE("sharded_sockets") {
+    auto pool = SocketThreadPool(3, SocketThreadPool::Mode::SHARDED, false);
+    REQUIRE(pool.GetMode() == SocketThreadPool::Mode::SHARDED);
+    REQUIRE(pool.GetThreadCount() == 3);
+    TestEcho(pool, 9);
+  }
+
+  TEST_CASE("pinned_sharded_sockets") {
+    auto pool = SocketThreadPool(2, SocketThreadPool::Mode::SHARDED, true);
+    TestEcho(pool, 4);
+  }
+}
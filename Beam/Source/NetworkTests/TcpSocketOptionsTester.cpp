@@ -0,0 +1,154 @@
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <doctest/doctest.h>
+#include "Beam/Network/NetworkDetails.hpp"
+#include "Beam/Network/SocketThreadPool.hpp"
+#include "Beam/Network/TcpServerSocket.hpp"
+#include "Beam/Network/TcpSocketChannel.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+#include "Beam/Utilities/YamlConfig.hpp"
+
+using namespace Beam;
+using namespace Beam::Network;
+using namespace Beam::Routines;
+using namespace boost::posix_time;
+
+namespace {
+  const auto ADDRESS = IpAddress("127.0.0.1", 20204);
+
+  int GetSendBufferSize(boost::asio::ip::tcp::socket& socket) {
+    auto option = boost::asio::socket_base::send_buffer_size();
+    socket.get_option(option);
+    return option.value();
+  }
+}
+
+TEST_SUITE("TcpSocketOptions") {
+  TEST_CASE("defaults") {
+    auto options = TcpSocketOptions();
+    REQUIRE(!options.m_noDelayEnabled);
+    REQUIRE(options.m_writeBufferSize == 0);
+    REQUIRE(options.m_readBufferSize == 0);
+    REQUIRE(!options.m_quickAckEnabled);
+    REQUIRE(options.m_busyPollTimeout == seconds(0));
+    REQUIRE(!options.m_keepAliveEnabled);
+    REQUIRE(options.m_keepAliveIdle == seconds(0));
+    REQUIRE(options.m_keepAliveInterval == seconds(0));
+    REQUIRE(options.m_keepAliveCount == 0);
+  }
+
+  TEST_CASE("apply") {
+    auto service = boost::asio::io_service();
+    auto socket = boost::asio::ip::tcp::socket(service);
+    socket.open(boost::asio::ip::tcp::v4());
+    auto options = TcpSocketOptions();
+    options.m_noDelayEnabled = true;
+    options.m_writeBufferSize = 64 * 1024;
+    options.m_readBufferSize = 128 * 1024;
+    options.m_keepAliveEnabled = true;
+    options.m_keepAliveIdle = seconds(30);
+    options.m_keepAliveInterval = seconds(5);
+    options.m_keepAliveCount = 3;
+    auto error = boost::system::error_code();
+    Network::Details::ApplyTcpSocketOptions(socket, options, error);
+    REQUIRE(!error);
+    auto noDelay = boost::asio::ip::tcp::no_delay();
+    socket.get_option(noDelay);
+    REQUIRE(noDelay.value());
+    REQUIRE(GetSendBufferSize(socket) >= options.m_writeBufferSize);
+    auto readBufferSize = boost::asio::socket_base::receive_buffer_size();
+    socket.get_option(readBufferSize);
+    REQUIRE(readBufferSize.value() >= options.m_readBufferSize);
+    auto keepAlive = boost::asio::socket_base::keep_alive();
+    socket.get_option(keepAlive);
+    REQUIRE(keepAlive.value());
+    using boost::asio::detail::socket_option::integer;
+#ifdef TCP_KEEPIDLE
+    auto keepAliveIdle = integer<IPPROTO_TCP, TCP_KEEPIDLE>();
+    socket.get_option(keepAliveIdle);
+    REQUIRE(keepAliveIdle.value() == 30);
+#endif
+#ifdef TCP_KEEPINTVL
+    auto keepAliveInterval = integer<IPPROTO_TCP, TCP_KEEPINTVL>();
+    socket.get_option(keepAliveInterval);
+    REQUIRE(keepAliveInterval.value() == 5);
+#endif
+#ifdef TCP_KEEPCNT
+    auto keepAliveCount = integer<IPPROTO_TCP, TCP_KEEPCNT>();
+    socket.get_option(keepAliveCount);
+    REQUIRE(keepAliveCount.value() == 3);
+#endif
+  }
+
+  TEST_CASE("apply_defaults") {
+    auto service = boost::asio::io_service();
+    auto socket = boost::asio::ip::tcp::socket(service);
+    socket.open(boost::asio::ip::tcp::v4());
+    auto writeBufferSize = GetSendBufferSize(socket);
+    auto error = boost::system::error_code();
+    Network::Details::ApplyTcpSocketOptions(socket, TcpSocketOptions(),
+      error);
+    REQUIRE(!error);
+    REQUIRE(GetSendBufferSize(socket) == writeBufferSize);
+    auto keepAlive = boost::asio::socket_base::keep_alive();
+    socket.get_option(keepAlive);
+    REQUIRE(!keepAlive.value());
+  }
+
+  TEST_CASE("channel_defaults") {
+    auto pool = SocketThreadPool(1);
+    auto server = TcpServerSocket(ADDRESS, Ref(pool));
+    server.Open();
+    auto accepted = std::unique_ptr<TcpServerSocket::Channel>();
+    auto acceptRoutine = RoutineHandler(Spawn(
+      [&] {
+        accepted = server.Accept();
+      }));
+    auto client = TcpSocketChannel(ADDRESS, Ref(pool));
+    client.GetConnection().Open();
+    acceptRoutine.Wait();
+    REQUIRE(accepted != nullptr);
+    REQUIRE(accepted->GetConnection().GetWriteBufferSize() == 0);
+    REQUIRE(client.GetConnection().GetWriteBufferSize() ==
+      TcpSocketOptions::DEFAULT_WRITE_BUFFER_SIZE);
+  }
+
+  TEST_CASE("yaml") {
+    auto config = YAML::Load(
+      "socket_options:\n"
+      "  no_delay: true\n"
+      "  write_buffer_size: 65536\n"
+      "  read_buffer_size: 131072\n"
+      "  quick_ack: true\n"
+      "  busy_poll: 50us\n"
+      "  keep_alive: true\n"
+      "  keep_alive_idle: 30s\n"
+      "  keep_alive_interval: 5s\n"
+      "  keep_alive_count: 3\n");
+    auto options = Extract<TcpSocketOptions>(config, "socket_options");
+    REQUIRE(options.m_noDelayEnabled);
+    REQUIRE(options.m_writeBufferSize == 65536);
+    REQUIRE(options.m_readBufferSize == 131072);
+    REQUIRE(options.m_quickAckEnabled);
+    REQUIRE(options.m_busyPollTimeout == microseconds(50));
+    REQUIRE(options.m_keepAliveEnabled);
+    REQUIRE(options.m_keepAliveIdle == seconds(30));
+    REQUIRE(options.m_keepAliveInterval == seconds(5));
+    REQUIRE(options.m_keepAliveCount == 3);
+  }
+
+  TEST_CASE("yaml_partial") {
+    auto config = YAML::Load(
+      "socket_options:\n"
+      "  no_delay: true\n");
+    auto options = Extract<TcpSocketOptions>(config, "socket_options");
+    REQUIRE(options.m_noDelayEnabled);
+    REQUIRE(options.m_writeBufferSize == 0);
+    REQUIRE(!options.m_keepAliveEnabled);
+    auto defaults = TcpSocketOptions();
+    defaults.m_readBufferSize = 4096;
+    auto missing = Extract<TcpSocketOptions>(config, "missing", defaults);
+    REQUIRE(!missing.m_noDelayEnabled);
+    REQUIRE(missing.m_readBufferSize == 4096);
+  }
+}
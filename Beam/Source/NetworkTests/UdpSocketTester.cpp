@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <doctest/doctest.h>
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Network/UdpSocket.hpp"
+#include "Beam/Routines/RoutineHandlerGroup.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Network;
+using namespace Beam::Routines;
+using namespace boost::posix_time;
+
+namespace {
+  const auto ADDRESS = IpAddress("127.0.0.1", 20202);
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::vector<DatagramPacket<SharedBuffer>> MakePackets(int count,
+      const std::string& prefix = "packet") {
+    auto packets = std::vector<DatagramPacket<SharedBuffer>>();
+    for(auto i = 0; i < count; ++i) {
+      packets.emplace_back(BufferFromString<SharedBuffer>(
+        prefix + std::to_string(i)), ADDRESS);
+    }
+    return packets;
+  }
+
+  struct Fixture {
+    SocketThreadPool m_socketThreadPool;
+    UdpSocket m_receiver;
+    UdpSocket m_sender;
+
+    Fixture()
+        : m_socketThreadPool(1),
+          m_receiver(ADDRESS, ADDRESS, Ref(m_socketThreadPool)),
+          m_sender(ADDRESS, Ref(m_socketThreadPool)) {}
+
+    void Open(bool isTimestamped) {
+      auto settings = UdpSocketReceiver::Settings();
+      settings.m_timeout = seconds(5);
+      settings.m_receiveBufferSize = 1024 * 1024;
+      settings.m_isTimestamped = isTimestamped;
+      m_receiver.SetReceiverSettings(settings);
+      m_receiver.Open();
+      m_sender.Open();
+    }
+  };
+}
+
+TEST_SUITE("UdpSocket") {
+  TEST_CASE_FIXTURE(Fixture, "partial_batch") {
+    Open(false);
+    auto sent = MakePackets(3);
+    m_sender.GetSender().Send(sent.data(), sent.size());
+    auto packets = MakePackets(8);
+    auto received = std::vector<std::string>();
+    while(received.size() < sent.size()) {
+      auto count = m_receiver.GetReceiver().Receive(packets.data(),
+        packets.size());
+      REQUIRE(count >= 1);
+      REQUIRE(received.size() + count <= sent.size());
+      for(auto i = std::size_t(0); i != packets.size(); ++i) {
+        if(i < count) {
+          received.push_back(ToString(packets[i].GetData()));
+          REQUIRE(packets[i].GetAddress().GetHost() == ADDRESS.GetHost());
+          REQUIRE(packets[i].GetTimestamp().is_not_a_date_time());
+        } else {
+          REQUIRE(packets[i].GetData().GetSize() == 0);
+        }
+      }
+    }
+    for(auto i = std::size_t(0); i != sent.size(); ++i) {
+      REQUIRE(received[i] == ToString(sent[i].GetData()));
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "batch_after_single_sends") {
+    Open(false);
+    auto sent = MakePackets(2);
+    for(auto& packet : sent) {
+      m_sender.GetSender().Send(packet);
+    }
+    auto packets = std::vector<DatagramPacket<SharedBuffer>>(1);
+    for(auto& packet : sent) {
+      REQUIRE(m_receiver.GetReceiver().Receive(packets.data(), 1) == 1);
+      REQUIRE(ToString(packets.front().GetData()) ==
+        ToString(packet.GetData()));
+    }
+  }
+
+#ifdef __linux__
+  TEST_CASE_FIXTURE(Fixture, "timestamps") {
+    Open(true);
+    auto start = microsec_clock::universal_time();
+    auto sent = MakePackets(2);
+    m_sender.GetSender().Send(sent.data(), sent.size());
+    auto packets = std::vector<DatagramPacket<SharedBuffer>>(2);
+    auto received = std::size_t(0);
+    while(received < sent.size()) {
+      auto count = m_receiver.GetReceiver().Receive(packets.data() + received,
+        packets.size() - received);
+      received += count;
+    }
+    auto end = microsec_clock::universal_time();
+    for(auto& packet : packets) {
+      REQUIRE(!packet.GetTimestamp().is_special());
+      REQUIRE(packet.GetTimestamp() >= start - milliseconds(1));
+      REQUIRE(packet.GetTimestamp() <= end + milliseconds(1));
+    }
+    REQUIRE(packets[0].GetTimestamp() <= packets[1].GetTimestamp());
+  }
+#endif
+
+  TEST_CASE_FIXTURE(Fixture, "concurrent_batches") {
+    Open(false);
+    const auto SENDER_COUNT = 4;
+    const auto BATCH_SIZE = 8;
+    auto expected = std::vector<std::string>();
+    auto batches = std::vector<std::vector<DatagramPacket<SharedBuffer>>>();
+    for(auto i = 0; i < SENDER_COUNT; ++i) {
+      batches.push_back(MakePackets(BATCH_SIZE, std::to_string(i) + ":"));
+      for(auto& packet : batches.back()) {
+        expected.push_back(ToString(packet.GetData()));
+      }
+    }
+    auto senders = RoutineHandlerGroup();
+    for(auto& batch : batches) {
+      senders.Spawn(
+        [&] {
+          m_sender.GetSender().Send(batch.data(), batch.size());
+        });
+    }
+    auto receivers = RoutineHandlerGroup();
+    auto received = std::vector<std::vector<std::string>>(2);
+    for(auto& packets : received) {
+      receivers.Spawn(
+        [&] {
+          auto batch = std::vector<DatagramPacket<SharedBuffer>>(BATCH_SIZE);
+          while(packets.size() < expected.size() / received.size()) {
+            auto count = m_receiver.GetReceiver().Receive(batch.data(),
+              std::min(batch.size(),
+              expected.size() / received.size() - packets.size()));
+            for(auto i = std::size_t(0); i != count; ++i) {
+              packets.push_back(ToString(batch[i].GetData()));
+            }
+          }
+        });
+    }
+    senders.Wait();
+    receivers.Wait();
+    auto all = received[0];
+    all.insert(all.end(), received[1].begin(), received[1].end());
+    std::sort(all.begin(), all.end());
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(all == expected);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "batch_timeout") {
+    auto settings = UdpSocketReceiver::Settings();
+    settings.m_timeout = milliseconds(100);
+    m_receiver.SetReceiverSettings(settings);
+    m_receiver.Open();
+    auto packets = std::vector<DatagramPacket<SharedBuffer>>(4);
+    auto start = microsec_clock::universal_time();
+    REQUIRE_THROWS(m_receiver.GetReceiver().Receive(packets.data(),
+      packets.size()));
+    REQUIRE(microsec_clock::universal_time() - start < seconds(5));
+  }
+}
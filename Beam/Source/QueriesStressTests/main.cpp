@@ -0,0 +1,80 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include "Beam/Queries/IndexedSequencer.hpp"
+#include "Beam/Queries/Sequencer.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+
+namespace {
+  const auto INDEX_COUNT = 64;
+  const auto ITERATIONS = 1000000;
+
+  /** The baseline, a single lock guarding a map of Sequencers. */
+  class LockedSequencers {
+    public:
+      Beam::Queries::Sequence IncrementNextSequence(const std::string& index,
+          const ptime& timestamp) {
+        auto lock = boost::lock_guard<boost::mutex>(m_mutex);
+        auto sequencerIterator = m_sequencers.find(index);
+        if(sequencerIterator == m_sequencers.end()) {
+          sequencerIterator = m_sequencers.emplace(index,
+            std::make_unique<Sequencer>(
+            Beam::Queries::Sequence::First())).first;
+        }
+        return sequencerIterator->second->IncrementNextSequence(timestamp);
+      }
+
+    private:
+      boost::mutex m_mutex;
+      std::unordered_map<std::string, std::unique_ptr<Sequencer>> m_sequencers;
+  };
+
+  template<typename S>
+  void Profile(const std::string& name, S& sequencer, int threadCount) {
+    auto indexes = std::vector<std::string>();
+    for(auto i = 0; i < INDEX_COUNT; ++i) {
+      indexes.push_back("I" + std::to_string(i));
+    }
+    auto timestamp = ptime(gregorian::date(2020, 1, 1), hours(10));
+    auto threads = std::vector<std::thread>();
+    auto start = microsec_clock::universal_time();
+    for(auto i = 0; i < threadCount; ++i) {
+      threads.emplace_back(
+        [&, i] {
+          for(auto j = 0; j < ITERATIONS; ++j) {
+            sequencer.IncrementNextSequence(
+              indexes[(i + j) % INDEX_COUNT], timestamp);
+          }
+        });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    auto elapsed = microsec_clock::universal_time() - start;
+    auto rate = static_cast<double>(threadCount) * ITERATIONS /
+      (elapsed.total_microseconds() / 1000000.0);
+    std::cout << name << " threads: " << threadCount << " " << elapsed <<
+      " " << static_cast<std::uint64_t>(rate) << "/s" << std::endl;
+  }
+}
+
+int main() {
+  for(auto threadCount = 1; threadCount <= 32; threadCount *= 2) {
+    {
+      auto sequencer = LockedSequencers();
+      Profile("LockedSequencers", sequencer, threadCount);
+    }
+    {
+      auto sequencer = IndexedSequencer<std::string>();
+      Profile("IndexedSequencer", sequencer, threadCount);
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Beam/Queries/BasicQuery.hpp"
+#include "Beam/Queries/BufferedDataStore.hpp"
+#include "Beam/Queries/EvaluatorTranslator.hpp"
+#include "Beam/Queries/LocalDataStore.hpp"
+#include "Beam/QueriesTests/TestEntry.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::Queries::Tests;
+using namespace Beam::Threading;
+using namespace boost::posix_time;
+
+namespace {
+  using TestLocalDataStore = LocalDataStore<BasicQuery<std::string>, TestEntry,
+    EvaluatorTranslator<QueryTypes>>;
+  const auto BATCH_SIZE = 10;
+  const auto READY_COUNT = 1000;
+}
+
+/**
+ * Stores batches of values into a BufferedDataStore logging them to the
+ * path given as its argument, without ever flushing them. A line is written
+ * to stdout once READY_COUNT values are stored, after which values keep being
+ * stored until the process is killed.
+ */
+int main(int argc, const char** argv) {
+  if(argc != 2) {
+    std::cerr << "Usage: QueriesTestWriter <log path>" << std::endl;
+    return -1;
+  }
+  auto timerThreadPool = TimerThreadPool();
+  auto localDataStore = TestLocalDataStore();
+  auto dataStore = BufferedDataStore<TestLocalDataStore*>(&localDataStore,
+    std::numeric_limits<std::size_t>::max(), argv[1], milliseconds(10),
+    Ref(timerThreadPool));
+  dataStore.Open();
+  auto timestamp = ptime(boost::gregorian::date(2020, 1, 1));
+  auto count = 0;
+  while(true) {
+    auto batch = std::vector<SequencedIndexedTestEntry>();
+    for(auto i = 0; i < BATCH_SIZE; ++i) {
+      batch.push_back(SequencedValue(IndexedValue(
+        TestEntry{count, timestamp + seconds(count)}, std::string("hello")),
+        Beam::Queries::Sequence(count + 1)));
+      ++count;
+    }
+    dataStore.Store(batch);
+    if(count == READY_COUNT) {
+      std::cout << count << std::endl;
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/Queries/AtomicSequencer.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+
+TEST_SUITE("AtomicSequencer") {
+  TEST_CASE("first_sequence") {
+    auto sequencer = AtomicSequencer(Beam::Queries::Sequence::First());
+    auto timestampA = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequenceA = sequencer.IncrementNextSequence(timestampA);
+    REQUIRE(sequenceA == EncodeTimestamp(timestampA,
+      Beam::Queries::Sequence::First()));
+    auto sequenceB = sequencer.IncrementNextSequence(timestampA);
+    REQUIRE(sequenceB == Increment(sequenceA));
+    auto timestampB = timestampA + days(1);
+    auto sequenceC = sequencer.IncrementNextSequence(timestampB);
+    REQUIRE(sequenceC == EncodeTimestamp(timestampB,
+      Beam::Queries::Sequence::First()));
+    auto sequenceD = sequencer.IncrementNextSequence(timestampA);
+    REQUIRE(sequenceD == Increment(sequenceC));
+  }
+
+  TEST_CASE("reserve_sequences") {
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequencer = AtomicSequencer(EncodeTimestamp(timestamp));
+    auto sequenceA = sequencer.IncrementNextSequence(timestamp, 100);
+    REQUIRE(sequenceA == EncodeTimestamp(timestamp));
+    auto sequenceB = sequencer.IncrementNextSequence(timestamp, 5);
+    REQUIRE(sequenceB == EncodeTimestamp(timestamp,
+      Beam::Queries::Sequence(100)));
+    REQUIRE(sequencer.GetNextSequence() == EncodeTimestamp(timestamp,
+      Beam::Queries::Sequence(105)));
+  }
+
+  TEST_CASE("invalid_count") {
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequencer = AtomicSequencer(EncodeTimestamp(timestamp));
+    REQUIRE_THROWS_AS(sequencer.IncrementNextSequence(timestamp, 0),
+      std::invalid_argument);
+    REQUIRE_THROWS_AS(sequencer.IncrementNextSequence(timestamp, -1),
+      std::invalid_argument);
+    REQUIRE(sequencer.GetNextSequence() == EncodeTimestamp(timestamp));
+  }
+
+  TEST_CASE("concurrent_sequences") {
+    const auto THREAD_COUNT = 8;
+    const auto ITERATIONS = 10000;
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequencer = AtomicSequencer(EncodeTimestamp(timestamp));
+    auto threads = std::vector<std::thread>();
+    for(auto i = 0; i < THREAD_COUNT; ++i) {
+      threads.emplace_back(
+        [&] {
+          for(auto j = 0; j < ITERATIONS; ++j) {
+            sequencer.IncrementNextSequence(timestamp);
+          }
+        });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(sequencer.GetNextSequence() == EncodeTimestamp(timestamp,
+      Beam::Queries::Sequence(THREAD_COUNT * ITERATIONS)));
+  }
+}
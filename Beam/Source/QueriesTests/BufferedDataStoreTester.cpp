@@ -1,10 +1,20 @@
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <string>
 #include <vector>
+#ifndef _WIN32
+  #include <signal.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
 #include <doctest/doctest.h>
 #include "Beam/Queries/BasicQuery.hpp"
 #include "Beam/Queries/BufferedDataStore.hpp"
 #include "Beam/Queries/EvaluatorTranslator.hpp"
 #include "Beam/Queries/LocalDataStore.hpp"
 #include "Beam/QueriesTests/TestEntry.hpp"
+#include "Beam/Threading/TimerThreadPool.hpp"
 #include "Beam/TimeService/IncrementalTimeClient.hpp"
 
 using namespace Beam;
@@ -12,6 +22,7 @@ using namespace Beam::Queries;
 using namespace Beam::Queries::Tests;
 using namespace Beam::Threading;
 using namespace Beam::TimeService;
+using namespace boost::posix_time;
 
 namespace {
   using TestLocalDataStore = LocalDataStore<BasicQuery<std::string>, TestEntry,
@@ -117,4 +128,100 @@ TEST_SUITE("BufferedDataStore") {
       SnapshotLimit(SnapshotLimit::Type::TAIL, 4),
       {entryA, entryB, entryC, entryD});
   }
+
+  TEST_CASE("truncate_write_ahead_log") {
+    auto logPath = std::filesystem::temp_directory_path() /
+      ("beam_buffered_data_store_" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    auto getLogPath = [&] (auto index) {
+      auto path = logPath;
+      path += "." + std::to_string(index);
+      return path;
+    };
+    auto timerThreadPool = TimerThreadPool();
+    auto timeClient = IncrementalTimeClient();
+    auto entries = std::vector<SequencedIndexedTestEntry>();
+    for(auto i = 0; i < 5; ++i) {
+      entries.push_back(SequencedValue(IndexedValue(
+        TestEntry{100 + i, timeClient.GetTime()}, std::string("hello")),
+        Beam::Queries::Sequence(5 + i)));
+    }
+    auto localDataStore = TestLocalDataStore();
+    {
+      auto dataStore = BufferedDataStore<TestLocalDataStore*>(&localDataStore,
+        100, logPath, milliseconds(10), Ref(timerThreadPool));
+      dataStore.Open();
+      dataStore.Store(std::vector(entries.begin(), entries.begin() + 3));
+      dataStore.Store(entries[3]);
+      dataStore.Store(entries[4]);
+      REQUIRE(localDataStore.LoadAll().empty());
+    }
+    REQUIRE(localDataStore.LoadAll() == entries);
+    for(auto i = 0; i < 2; ++i) {
+      REQUIRE(WriteAheadLog<SequencedIndexedTestEntry>(getLogPath(i),
+        seconds(0)).IsEmpty());
+      std::filesystem::remove(getLogPath(i));
+    }
+  }
+
+#ifndef _WIN32
+  TEST_CASE("recover_from_killed_writer") {
+    auto logPath = std::filesystem::temp_directory_path() /
+      ("beam_buffered_data_store_" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    auto getLogPath = [&] (auto index) {
+      auto path = logPath;
+      path += "." + std::to_string(index);
+      return path;
+    };
+
+    // The writer is a separate process so that it can be killed in the midst
+    // of appending a batch, leaving a torn record at the end of its log.
+    auto output = std::array<int, 2>();
+    REQUIRE(::pipe(output.data()) == 0);
+    auto writer = ::fork();
+    REQUIRE(writer != -1);
+    if(writer == 0) {
+      ::dup2(output[1], STDOUT_FILENO);
+      ::close(output[0]);
+      ::close(output[1]);
+      ::execl(QUERIES_TEST_WRITER_PATH, QUERIES_TEST_WRITER_PATH,
+        logPath.c_str(), static_cast<char*>(nullptr));
+      ::_exit(127);
+    }
+    ::close(output[1]);
+    auto line = std::string();
+    auto c = char();
+    while(::read(output[0], &c, 1) == 1 && c != '\n') {
+      line += c;
+    }
+    ::kill(writer, SIGKILL);
+    auto status = 0;
+    ::waitpid(writer, &status, 0);
+    ::close(output[0]);
+    REQUIRE(WIFSIGNALED(status));
+    REQUIRE(!line.empty());
+    auto storedCount = std::stoi(line);
+    auto timerThreadPool = TimerThreadPool();
+    auto localDataStore = TestLocalDataStore();
+    {
+      auto dataStore = BufferedDataStore<TestLocalDataStore*>(&localDataStore,
+        100, logPath, seconds(0), Ref(timerThreadPool));
+      dataStore.Open();
+    }
+    auto recovered = localDataStore.LoadAll();
+    REQUIRE(static_cast<int>(recovered.size()) >= storedCount);
+    auto timestamp = ptime(boost::gregorian::date(2020, 1, 1));
+    for(auto i = 0; i != static_cast<int>(recovered.size()); ++i) {
+      REQUIRE(recovered[i] == SequencedValue(IndexedValue(
+        TestEntry{i, timestamp + seconds(i)}, std::string("hello")),
+        Beam::Queries::Sequence(i + 1)));
+    }
+    for(auto i = 0; i < 2; ++i) {
+      REQUIRE(WriteAheadLog<SequencedIndexedTestEntry>(getLogPath(i),
+        seconds(0)).IsEmpty());
+      std::filesystem::remove(getLogPath(i));
+    }
+  }
+#endif
 }
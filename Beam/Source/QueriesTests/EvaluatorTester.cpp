@@ -43,6 +43,27 @@ TEST_SUITE("Evaluator") {
     REQUIRE(evaluator->Eval<int>(5) == 9);
   }
 
+  TEST_CASE("windowed_reduce_expression") {
+    auto sumExpression = WindowedReduceExpression(
+      WindowedReduceExpression::Operation::SUM,
+      ParameterExpression(0, IntType()), 2);
+    auto sumEvaluator = Translate(sumExpression);
+    REQUIRE(sumEvaluator->Eval<int>(1) == 1);
+    REQUIRE(sumEvaluator->Eval<int>(2) == 3);
+    REQUIRE(sumEvaluator->Eval<int>(4) == 6);
+    auto maxExpression = WindowedReduceExpression(
+      WindowedReduceExpression::Operation::MAX,
+      ParameterExpression(0, StringType()), ParameterExpression(1,
+      DateTimeType()), boost::posix_time::minutes(1));
+    auto maxEvaluator = Translate(maxExpression);
+    auto start = boost::posix_time::time_from_string("2020-01-01 10:00:00");
+    REQUIRE(maxEvaluator->Eval<std::string>(std::string("b"), start) == "b");
+    REQUIRE(maxEvaluator->Eval<std::string>(std::string("a"),
+      start + boost::posix_time::seconds(30)) == "b");
+    REQUIRE(maxEvaluator->Eval<std::string>(std::string("a"),
+      start + boost::posix_time::seconds(60)) == "a");
+  }
+
   TEST_CASE("out_of_range_parameter_expression") {
     {
       auto parameter = ParameterExpression(MAX_EVALUATOR_PARAMETERS, BoolType());
@@ -0,0 +1,50 @@
+#include <stdexcept>
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/Queries/IndexedSequencer.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+
+TEST_SUITE("IndexedSequencer") {
+  TEST_CASE("independent_indexes") {
+    auto sequencer = IndexedSequencer<std::string>();
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequenceA = sequencer.IncrementNextSequence("A", timestamp);
+    auto sequenceB = sequencer.IncrementNextSequence("B", timestamp, 10);
+    REQUIRE(sequenceA == EncodeTimestamp(timestamp));
+    REQUIRE(sequenceB == EncodeTimestamp(timestamp));
+    REQUIRE(sequencer.IncrementNextSequence("A", timestamp) ==
+      Increment(sequenceA));
+    REQUIRE(sequencer.IncrementNextSequence("B", timestamp) ==
+      EncodeTimestamp(timestamp, Beam::Queries::Sequence(10)));
+    REQUIRE(&sequencer.Get("A") == &sequencer.Get("A"));
+  }
+
+  TEST_CASE("initial_sequence_loader") {
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto loads = 0;
+    auto sequencer = IndexedSequencer<std::string>(
+      [&] (const std::string& index) {
+        ++loads;
+        return EncodeTimestamp(timestamp, Beam::Queries::Sequence(50));
+      });
+    REQUIRE(sequencer.IncrementNextSequence("A", timestamp) ==
+      EncodeTimestamp(timestamp, Beam::Queries::Sequence(50)));
+    REQUIRE(sequencer.IncrementNextSequence("A", timestamp) ==
+      EncodeTimestamp(timestamp, Beam::Queries::Sequence(51)));
+    REQUIRE(loads == 1);
+  }
+
+  TEST_CASE("invalid_count") {
+    auto sequencer = IndexedSequencer<std::string>();
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    REQUIRE_THROWS_AS(sequencer.IncrementNextSequence("A", timestamp, 0),
+      std::invalid_argument);
+    REQUIRE(sequencer.IncrementNextSequence("A", timestamp, 2) ==
+      EncodeTimestamp(timestamp));
+  }
+}
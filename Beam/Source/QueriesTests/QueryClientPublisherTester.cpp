@@ -0,0 +1,205 @@
+#include <boost/functional/factory.hpp>
+#include <boost/optional/optional.hpp>
+#include <doctest/doctest.h>
+#include "Beam/Queries/BasicQuery.hpp"
+#include "Beam/Queries/EvaluatorTranslator.hpp"
+#include "Beam/Queries/OrExpression.hpp"
+#include "Beam/Queries/ParameterExpression.hpp"
+#include "Beam/Queries/QueryClientPublisher.hpp"
+#include "Beam/Queries/QueryResult.hpp"
+#include "Beam/Queries/StandardFunctionExpressions.hpp"
+#include "Beam/Queries/StandardValues.hpp"
+#include "Beam/Queries/ShuttleQueryTypes.hpp"
+#include "Beam/Queues/Queue.hpp"
+#include "Beam/Services/RecordMessage.hpp"
+#include "Beam/Services/Service.hpp"
+#include "Beam/ServicesTests/ServicesTests.hpp"
+#include "Beam/SignalHandling/NullSlot.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::Services;
+using namespace Beam::Services::Tests;
+using namespace Beam::SignalHandling;
+using namespace Beam::Threading;
+
+namespace {
+  using TestQuery = BasicQuery<std::string>;
+  using TestQueryResult = QueryResult<SequencedValue<int>>;
+  using TestSequencedIndexedValue =
+    SequencedValue<IndexedValue<int, std::string>>;
+
+  BEAM_DEFINE_SERVICES(TestQueryServices,
+    (QueryTestService, "Beam.Queries.Tests.QueryTestService", TestQueryResult,
+      TestQuery, query));
+
+  BEAM_DEFINE_MESSAGES(TestQueryMessages,
+    (TestQueryMessage, "Beam.Queries.Tests.TestQueryMessage",
+      TestSequencedIndexedValue, value),
+    (EndTestQueryMessage, "Beam.Queries.Tests.EndTestQueryMessage",
+      std::string, index, int, id));
+
+  struct Fixture {
+    using ClientHandler =
+      ServiceProtocolClientHandler<TestServiceProtocolClientBuilder>;
+    using Publisher = QueryClientPublisher<int, TestQuery,
+      EvaluatorTranslator<QueryTypes>, ClientHandler, QueryTestService,
+      EndTestQueryMessage>;
+
+    boost::optional<TestServiceProtocolServer> m_protocolServer;
+    boost::optional<ClientHandler> m_clientHandler;
+    boost::optional<Publisher> m_publisher;
+    int m_realTimeQueries;
+    int m_snapshotQueries;
+    std::shared_ptr<Queue<int>> m_endedQueries;
+
+    Fixture()
+        : m_realTimeQueries(0),
+          m_snapshotQueries(0),
+          m_endedQueries(std::make_shared<Queue<int>>()) {
+      auto serverConnection = std::make_shared<TestServerConnection>();
+      m_protocolServer.emplace(serverConnection,
+        boost::factory<std::unique_ptr<TriggerTimer>>(), NullSlot(),
+        NullSlot());
+      RegisterQueryTypes(Store(m_protocolServer->GetSlots().GetRegistry()));
+      RegisterTestQueryServices(Store(m_protocolServer->GetSlots()));
+      RegisterTestQueryMessages(Store(m_protocolServer->GetSlots()));
+      QueryTestService::AddSlot(Store(m_protocolServer->GetSlots()),
+        [=] (auto& client, const TestQuery& query) {
+          auto result = TestQueryResult();
+          result.m_snapshot.push_back(SequencedValue(1, Sequence(1)));
+          if(query.GetRange().GetEnd() == Sequence::Last()) {
+            ++m_realTimeQueries;
+            result.m_queryId = m_realTimeQueries;
+          } else {
+            ++m_snapshotQueries;
+          }
+          return result;
+        });
+      AddMessageSlot<EndTestQueryMessage>(
+        Store(m_protocolServer->GetSlots()),
+        [=] (auto& client, const std::string& index, int id) {
+          m_endedQueries->Push(id);
+        });
+      m_protocolServer->Open();
+      auto builder = TestServiceProtocolClientBuilder(
+        [=] {
+          return std::make_unique<TestServiceProtocolClientBuilder::Channel>(
+            "test", Ref(*serverConnection));
+        }, boost::factory<std::unique_ptr<TriggerTimer>>());
+      m_clientHandler.emplace(builder);
+      RegisterQueryTypes(Store(m_clientHandler->GetSlots().GetRegistry()));
+      RegisterTestQueryServices(Store(m_clientHandler->GetSlots()));
+      RegisterTestQueryMessages(Store(m_clientHandler->GetSlots()));
+      m_publisher.emplace(Ref(*m_clientHandler));
+      m_clientHandler->Open();
+    }
+
+    void Publish(int value, int sequence) {
+      m_publisher->Publish(SequencedValue(IndexedValue(value,
+        std::string("A")), Sequence(sequence)));
+    }
+  };
+
+  TestQuery MakeQuery(const Range& range) {
+    auto query = TestQuery();
+    query.SetIndex("A");
+    query.SetRange(range);
+    return query;
+  }
+
+  TestQuery MakeQuery(const Range& range, const Expression& filter) {
+    auto query = MakeQuery(range);
+    query.SetFilter(filter);
+    return query;
+  }
+
+  Expression MakeFilter(const Expression& condition) {
+    return OrExpression(condition, MakeEqualsExpression(
+      ParameterExpression(0, IntType()), ConstantExpression(IntValue(1))));
+  }
+}
+
+TEST_SUITE("QueryClientPublisher") {
+  TEST_CASE_FIXTURE(Fixture, "shared_subscription") {
+    auto queueA = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total()), queueA);
+    REQUIRE(queueA->Top() == SequencedValue(1, Sequence(1)));
+    queueA->Pop();
+    auto queueB = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total()), queueB);
+    REQUIRE(queueB->Top() == SequencedValue(1, Sequence(1)));
+    queueB->Pop();
+    REQUIRE(m_realTimeQueries == 1);
+    REQUIRE(m_snapshotQueries == 1);
+    Publish(2, 2);
+    REQUIRE(queueA->Top() == SequencedValue(2, Sequence(2)));
+    REQUIRE(queueB->Top() == SequencedValue(2, Sequence(2)));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "end_query_after_last_subscriber") {
+    auto queueA = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total()), queueA);
+    queueA->Top();
+    queueA->Pop();
+    auto queueB = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total()), queueB);
+    queueB->Top();
+    queueB->Pop();
+    queueA->Break();
+    Publish(2, 2);
+    REQUIRE(m_endedQueries->IsEmpty());
+    REQUIRE(queueB->Top() == SequencedValue(2, Sequence(2)));
+    queueB->Pop();
+    queueB->Break();
+    Publish(3, 3);
+    REQUIRE(m_endedQueries->Top() == 1);
+    REQUIRE(m_realTimeQueries == 1);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "distinct_filter_precision") {
+    auto queueA = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total(),
+      MakeFilter(MakeEqualsExpression(
+        ConstantExpression(DecimalValue(1.0000001)),
+        ConstantExpression(DecimalValue(1.0000002))))), queueA);
+    REQUIRE(queueA->Top() == SequencedValue(1, Sequence(1)));
+    queueA->Pop();
+    auto queueB = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total(),
+      MakeFilter(MakeEqualsExpression(
+        ConstantExpression(DecimalValue(1.0000001)),
+        ConstantExpression(DecimalValue(1.0000001))))), queueB);
+    REQUIRE(queueB->Top() == SequencedValue(1, Sequence(1)));
+    queueB->Pop();
+    REQUIRE(m_realTimeQueries == 2);
+    Publish(2, 2);
+    Publish(1, 3);
+    REQUIRE(queueA->Top() == SequencedValue(1, Sequence(3)));
+    REQUIRE(queueB->Top() == SequencedValue(2, Sequence(2)));
+    queueB->Pop();
+    REQUIRE(queueB->Top() == SequencedValue(1, Sequence(3)));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "distinct_filter_type") {
+    auto queueA = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total(),
+      MakeFilter(MakeEqualsExpression(ConstantExpression(DecimalValue(1)),
+        ConstantExpression(DecimalValue(1.0000001))))), queueA);
+    REQUIRE(queueA->Top() == SequencedValue(1, Sequence(1)));
+    queueA->Pop();
+    auto queueB = std::make_shared<Queue<SequencedValue<int>>>();
+    m_publisher->SubmitQuery(MakeQuery(Range::Total(),
+      MakeFilter(MakeEqualsExpression(ConstantExpression(IntValue(1)),
+        ConstantExpression(IntValue(1))))), queueB);
+    REQUIRE(queueB->Top() == SequencedValue(1, Sequence(1)));
+    queueB->Pop();
+    REQUIRE(m_realTimeQueries == 2);
+    Publish(2, 2);
+    Publish(1, 3);
+    REQUIRE(queueA->Top() == SequencedValue(1, Sequence(3)));
+    REQUIRE(queueB->Top() == SequencedValue(2, Sequence(2)));
+    queueB->Pop();
+    REQUIRE(queueB->Top() == SequencedValue(1, Sequence(3)));
+  }
+}
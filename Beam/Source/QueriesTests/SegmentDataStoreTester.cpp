@@ -0,0 +1,215 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <boost/thread/thread.hpp>
+#include <doctest/doctest.h>
+#include "Beam/Queries/BasicQuery.hpp"
+#include "Beam/Queries/BufferedDataStore.hpp"
+#include "Beam/Queries/EvaluatorTranslator.hpp"
+#include "Beam/Queries/SegmentDataStore.hpp"
+#include "Beam/QueriesTests/TestEntry.hpp"
+#include "Beam/TimeService/IncrementalTimeClient.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::Queries::Tests;
+using namespace Beam::TimeService;
+
+namespace {
+  using DataStore = SegmentDataStore<BasicQuery<std::string>, TestEntry,
+    EvaluatorTranslator<QueryTypes>>;
+
+  struct Fixture {
+    std::filesystem::path m_path;
+
+    Fixture()
+        : m_path(std::filesystem::temp_directory_path() /
+            ("beam_segment_data_store_" + std::to_string(
+            reinterpret_cast<std::uintptr_t>(this)))) {
+      std::filesystem::remove_all(m_path);
+    }
+
+    ~Fixture() {
+      std::filesystem::remove_all(m_path);
+    }
+  };
+}
+
+TEST_SUITE("SegmentDataStore") {
+  TEST_CASE_FIXTURE(Fixture, "store_and_load") {
+    auto dataStore = DataStore(m_path);
+    dataStore.Open();
+    auto timeClient = IncrementalTimeClient();
+    auto sequence = Beam::Queries::Sequence(5);
+    auto entryA = StoreValue(dataStore, "hello", 100, timeClient.GetTime(),
+      sequence);
+    sequence = Increment(sequence);
+    auto entryB = StoreValue(dataStore, "hello", 200, timeClient.GetTime(),
+      sequence);
+    sequence = Increment(sequence);
+    auto entryC = StoreValue(dataStore, "hello", 300, timeClient.GetTime(),
+      sequence);
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {entryA, entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::HEAD, 0), {});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::HEAD, 2), {entryA, entryB});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::HEAD, 4), {entryA, entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 1), {entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 2), {entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 4), {entryA, entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range(
+      entryB.GetSequence(), entryC.GetSequence()), SnapshotLimit::Unlimited(),
+      {entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range(
+      entryA->GetValue().m_timestamp, entryB->GetValue().m_timestamp),
+      SnapshotLimit::Unlimited(), {entryA, entryB});
+    TestQuery(dataStore, "goodbye", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "range_scan") {
+    auto dataStore = DataStore(m_path);
+    dataStore.Open();
+    auto timeClient = IncrementalTimeClient();
+    auto values = std::vector<DataStore::IndexedValue>();
+    for(auto i = 1; i <= 1000; ++i) {
+      values.push_back(SequencedValue(IndexedValue(
+        TestEntry{i, timeClient.GetTime()}, std::string("hello")),
+        Beam::Queries::Sequence(i)));
+    }
+    dataStore.Store(values);
+    auto query = BasicQuery<std::string>();
+    query.SetIndex("hello");
+    query.SetRange(Beam::Queries::Sequence(100), Beam::Queries::Sequence(299));
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    auto result = dataStore.Load(query);
+    REQUIRE(result.size() == 200);
+    REQUIRE(result.front()->m_value == 100);
+    REQUIRE(result.back()->m_value == 299);
+    query.SetSnapshotLimit(SnapshotLimit(SnapshotLimit::Type::TAIL, 70));
+    result = dataStore.Load(query);
+    REQUIRE(result.size() == 70);
+    REQUIRE(result.front()->m_value == 230);
+    REQUIRE(result.back()->m_value == 299);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "overwrite") {
+    auto dataStore = DataStore(m_path);
+    dataStore.Open();
+    auto timeClient = IncrementalTimeClient();
+    auto entryA = StoreValue(dataStore, "hello", 100, timeClient.GetTime(),
+      Beam::Queries::Sequence(1));
+    auto entryB = StoreValue(dataStore, "hello", 200, timeClient.GetTime(),
+      Beam::Queries::Sequence(3));
+    auto entryC = StoreValue(dataStore, "hello", 300, timeClient.GetTime(),
+      Beam::Queries::Sequence(2));
+    auto entryD = StoreValue(dataStore, "hello", 400, timeClient.GetTime(),
+      Beam::Queries::Sequence(1));
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {entryD, entryC, entryB});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 2), {entryC, entryB});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "reopen") {
+    auto timeClient = IncrementalTimeClient();
+    auto entryA = SequencedIndexedTestEntry();
+    auto entryB = SequencedIndexedTestEntry();
+    {
+      auto dataStore = DataStore(m_path);
+      dataStore.Open();
+      entryA = StoreValue(dataStore, "hello", 100, timeClient.GetTime(),
+        Beam::Queries::Sequence(1));
+      entryB = StoreValue(dataStore, "hello", 200, timeClient.GetTime(),
+        Beam::Queries::Sequence(2));
+    }
+    auto dataStore = DataStore(m_path);
+    dataStore.Open();
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {entryA, entryB});
+    auto entryC = StoreValue(dataStore, "hello", 300, timeClient.GetTime(),
+      Beam::Queries::Sequence(3));
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {entryA, entryB, entryC});
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "compaction") {
+    auto timeClient = IncrementalTimeClient();
+    auto entries = std::vector<SequencedTestEntry>();
+    auto segmentCount = std::size_t(0);
+    {
+      auto dataStore = DataStore(m_path, 4);
+      dataStore.Open();
+      for(auto i = 1; i <= 16; ++i) {
+        entries.push_back(StoreValue(dataStore, "hello", i,
+          timeClient.GetTime(), Beam::Queries::Sequence(i)));
+      }
+      dataStore.Close();
+      segmentCount = dataStore.GetSegmentCount("hello");
+      REQUIRE(segmentCount < entries.size());
+      TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+        SnapshotLimit::Unlimited(), entries);
+    }
+    auto files = std::distance(std::filesystem::recursive_directory_iterator(
+      m_path), std::filesystem::recursive_directory_iterator());
+    REQUIRE(static_cast<std::size_t>(files) == segmentCount + 1);
+    auto dataStore = DataStore(m_path, 4);
+    dataStore.Open();
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), entries);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "concurrent_compaction") {
+    auto timeClient = IncrementalTimeClient();
+    auto entries = std::vector<SequencedTestEntry>();
+    for(auto i = 1; i <= 400; ++i) {
+      entries.push_back(SequencedValue(TestEntry{i, timeClient.GetTime()},
+        Beam::Queries::Sequence(i)));
+    }
+    {
+      auto dataStore = DataStore(m_path, 2);
+      dataStore.Open();
+      auto writers = boost::thread_group();
+      for(auto i = 0; i < 4; ++i) {
+        writers.create_thread(
+          [&, i] {
+            for(auto j = i; j < static_cast<int>(entries.size()); j += 4) {
+              dataStore.Store(SequencedValue(IndexedValue(*entries[j],
+                std::string("hello")), entries[j].GetSequence()));
+            }
+          });
+      }
+      writers.join_all();
+      dataStore.Close();
+      TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+        SnapshotLimit::Unlimited(), entries);
+    }
+    auto dataStore = DataStore(m_path, 2);
+    dataStore.Open();
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), entries);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "buffered") {
+    auto dataStore = BufferedDataStore<DataStore>(Initialize(m_path), 3);
+    dataStore.Open();
+    auto timeClient = IncrementalTimeClient();
+    auto entryA = StoreValue(dataStore, "hello", 100, timeClient.GetTime(),
+      Beam::Queries::Sequence(1));
+    auto entryB = StoreValue(dataStore, "hello", 200, timeClient.GetTime(),
+      Beam::Queries::Sequence(2));
+    auto entryC = StoreValue(dataStore, "hello", 300, timeClient.GetTime(),
+      Beam::Queries::Sequence(3));
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {entryA, entryB, entryC});
+    TestQuery(dataStore, "hello", Beam::Queries::Range::Total(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 2), {entryB, entryC});
+  }
+}
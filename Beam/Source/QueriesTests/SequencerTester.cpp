@@ -19,4 +19,14 @@ TEST_SUITE("Sequencer") {
     REQUIRE(sequenceB == EncodeTimestamp(timestampB,
       Beam::Queries::Sequence::First()));
   }
+
+  TEST_CASE("reserve_sequences") {
+    auto timestamp = ptime(date(2016, 7, 31), hours(17) + minutes(30));
+    auto sequencer = Sequencer(EncodeTimestamp(timestamp));
+    auto sequenceA = sequencer.IncrementNextSequence(timestamp, 10);
+    REQUIRE(sequenceA == EncodeTimestamp(timestamp));
+    auto sequenceB = sequencer.IncrementNextSequence(timestamp);
+    REQUIRE(sequenceB == EncodeTimestamp(timestamp,
+      Beam::Queries::Sequence(10)));
+  }
 }
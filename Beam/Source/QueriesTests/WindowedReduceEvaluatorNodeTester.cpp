@@ -0,0 +1,68 @@
+#include <doctest/doctest.h>
+#include "Beam/Queries/ParameterEvaluatorNode.hpp"
+#include "Beam/Queries/StandardDataTypes.hpp"
+#include "Beam/Queries/WindowedReduceEvaluatorNode.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost::posix_time;
+
+namespace {
+  template<typename T>
+  auto MakeParameter(int index, const void*& parameter) {
+    auto node = std::make_unique<ParameterEvaluatorNode<T>>(index);
+    node->SetParameter(&parameter);
+    return node;
+  }
+}
+
+TEST_SUITE("WindowedReduceEvaluatorNode") {
+  TEST_CASE("count_window_sum") {
+    auto parameter = static_cast<const void*>(nullptr);
+    auto evaluator = WindowedReduceEvaluatorNode<WindowSum<int>>(
+      MakeParameter<int>(0, parameter), 3);
+    auto values = std::vector<int>{1, 2, 3, 4, 5, -10};
+    auto expected = std::vector<int>{1, 3, 6, 9, 12, -1};
+    for(auto i = std::size_t(0); i != values.size(); ++i) {
+      parameter = &values[i];
+      REQUIRE(evaluator.Eval() == expected[i]);
+    }
+  }
+
+  TEST_CASE("count_window_min_max") {
+    auto parameter = static_cast<const void*>(nullptr);
+    auto minEvaluator = WindowedReduceEvaluatorNode<WindowMin<int>>(
+      MakeParameter<int>(0, parameter), 3);
+    auto maxEvaluator = WindowedReduceEvaluatorNode<WindowMax<int>>(
+      MakeParameter<int>(0, parameter), 3);
+    auto values = std::vector<int>{5, 3, 4, 4, 8, 1, 2, 2, 7};
+    auto expectedMin = std::vector<int>{5, 3, 3, 3, 4, 1, 1, 1, 2};
+    auto expectedMax = std::vector<int>{5, 5, 5, 4, 8, 8, 8, 2, 7};
+    for(auto i = std::size_t(0); i != values.size(); ++i) {
+      parameter = &values[i];
+      REQUIRE(minEvaluator.Eval() == expectedMin[i]);
+      REQUIRE(maxEvaluator.Eval() == expectedMax[i]);
+    }
+  }
+
+  TEST_CASE("time_window_count") {
+    auto value = std::string();
+    auto timestamp = ptime();
+    auto parameter = static_cast<const void*>(&value);
+    auto timeParameter = static_cast<const void*>(&timestamp);
+    auto evaluator = WindowedReduceEvaluatorNode<WindowCount<std::string>>(
+      MakeParameter<std::string>(0, parameter),
+      MakeParameter<ptime>(1, timeParameter), 100, seconds(10));
+    auto start = time_from_string("2020-01-01 10:00:00");
+    timestamp = start;
+    REQUIRE(evaluator.Eval() == 1);
+    timestamp = start + seconds(5);
+    REQUIRE(evaluator.Eval() == 2);
+    timestamp = start + seconds(9);
+    REQUIRE(evaluator.Eval() == 3);
+    timestamp = start + seconds(10);
+    REQUIRE(evaluator.Eval() == 3);
+    timestamp = start + seconds(30);
+    REQUIRE(evaluator.Eval() == 1);
+  }
+}
@@ -0,0 +1,55 @@
+#include <doctest/doctest.h>
+#include "Beam/Queries/ConstantExpression.hpp"
+#include "Beam/Queries/NativeDataType.hpp"
+#include "Beam/Queries/ParameterExpression.hpp"
+#include "Beam/Queries/Sequence.hpp"
+#include "Beam/Queries/StandardDataTypes.hpp"
+#include "Beam/Queries/WindowedReduceExpression.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost::posix_time;
+
+TEST_SUITE("WindowedReduceExpression") {
+  TEST_CASE("count_window_constructor") {
+    auto expression = WindowedReduceExpression(
+      WindowedReduceExpression::Operation::MIN, ConstantExpression(1.5), 10);
+    REQUIRE(expression.GetType() == DecimalType());
+    REQUIRE(expression.GetOperation() ==
+      WindowedReduceExpression::Operation::MIN);
+    REQUIRE(expression.GetSize() == 10);
+    REQUIRE(expression.GetPeriod() == pos_infin);
+    REQUIRE_THROWS_AS(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::MIN, ConstantExpression(1.5), 0),
+      std::out_of_range);
+  }
+
+  TEST_CASE("time_window_constructor") {
+    auto expression = WindowedReduceExpression(
+      WindowedReduceExpression::Operation::COUNT,
+      ConstantExpression(std::string("a")),
+      ParameterExpression(0, DateTimeType()), seconds(5));
+    REQUIRE(expression.GetType() == IntType());
+    REQUIRE(expression.GetPeriod() == seconds(5));
+    REQUIRE_THROWS_AS(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::COUNT, ConstantExpression(1),
+      ParameterExpression(0, DateTimeType()), seconds(0)), std::out_of_range);
+  }
+
+  TEST_CASE("incompatible_type_constructor") {
+    REQUIRE_THROWS_AS(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::SUM,
+      ConstantExpression(std::string("a")), 5), TypeCompatibilityException);
+    REQUIRE_THROWS_AS(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::MAX, ConstantExpression(1),
+      ParameterExpression(0, IntType()), seconds(5)),
+      TypeCompatibilityException);
+    REQUIRE_THROWS_AS(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::MIN,
+      ParameterExpression(0, NativeDataType<Beam::Queries::Sequence>()), 5),
+      TypeCompatibilityException);
+    REQUIRE_NOTHROW(WindowedReduceExpression(
+      WindowedReduceExpression::Operation::COUNT,
+      ParameterExpression(0, NativeDataType<Beam::Queries::Sequence>()), 5));
+  }
+}
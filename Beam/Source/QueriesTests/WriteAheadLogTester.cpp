@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <doctest/doctest.h>
+#include "Beam/Queries/WriteAheadLog.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+
+namespace {
+  using TestWriteAheadLog = WriteAheadLog<std::string>;
+
+  template<typename... T>
+  std::vector<std::string> ToVector(T... values) {
+    return std::vector<std::string>{values...};
+  }
+
+  struct Fixture {
+    std::filesystem::path m_path;
+
+    Fixture()
+        : m_path(std::filesystem::temp_directory_path() /
+            ("beam_write_ahead_log_" + std::to_string(
+            reinterpret_cast<std::uintptr_t>(this)))) {
+      std::filesystem::remove(m_path);
+    }
+
+    ~Fixture() {
+      std::filesystem::remove(m_path);
+    }
+  };
+}
+
+TEST_SUITE("WriteAheadLog") {
+  TEST_CASE_FIXTURE(Fixture, "append_and_load") {
+    {
+      auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(0));
+      REQUIRE(log.IsEmpty());
+      log.Append("hello");
+      log.Append(ToVector("goodbye", "world"));
+      REQUIRE(log.Load() == ToVector("hello", "goodbye", "world"));
+    }
+    auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(0));
+    REQUIRE(!log.IsEmpty());
+    REQUIRE(log.Load() == ToVector("hello", "goodbye", "world"));
+    log.Append("again");
+    REQUIRE(log.Load() == ToVector("hello", "goodbye", "world", "again"));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "truncate") {
+    {
+      auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(1));
+      log.Append(ToVector("a", "b", "c"));
+      log.Truncate();
+      REQUIRE(log.IsEmpty());
+      log.Append("d");
+    }
+    auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(1));
+    REQUIRE(log.Load() == ToVector("d"));
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "grow") {
+    auto values = std::vector<std::string>();
+    for(auto i = 0; i < 1000; ++i) {
+      values.push_back(std::string(4096, static_cast<char>('a' + i % 26)));
+    }
+    {
+      auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(1));
+      log.Append(values);
+    }
+    auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(1));
+    REQUIRE(log.Load() == values);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "torn_record") {
+    {
+      auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(0));
+      log.Append(ToVector("a", "b", "c"));
+    }
+
+    // Simulates a crash that tore the last record's payload.
+    {
+      auto file = std::fstream(m_path,
+        std::ios::binary | std::ios::in | std::ios::out);
+      auto contents = std::string(std::istreambuf_iterator<char>(file), {});
+      auto position = contents.rfind('c');
+      REQUIRE(position != std::string::npos);
+      file.seekp(static_cast<std::streamoff>(position));
+      file.put('x');
+    }
+    auto log = TestWriteAheadLog(m_path, boost::posix_time::seconds(0));
+    REQUIRE(log.Load() == ToVector("a", "b"));
+    log.Append("d");
+    REQUIRE(log.Load() == ToVector("a", "b", "d"));
+  }
+}
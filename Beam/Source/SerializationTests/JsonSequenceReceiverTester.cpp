@@ -0,0 +1,81 @@
+#include "Beam/SerializationTests/JsonSequenceReceiverTester.hpp"
+#include <string>
+#include <vector>
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Serialization/JsonSender.hpp"
+#include "Beam/Serialization/JsonSequenceReceiver.hpp"
+#include "Beam/Serialization/ShuttleVector.hpp"
+#include "Beam/SerializationTests/ShuttleTestTypes.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+using namespace Beam::Serialization::Tests;
+
+void JsonSequenceReceiverTester::TestEmptyArray() {
+  auto buffer = BufferFromString<SharedBuffer>(" [ ] ");
+  auto receiver = JsonSequenceReceiver<int, SharedBuffer>();
+  receiver.SetSource(Ref(buffer));
+  auto value = 0;
+  CPPUNIT_ASSERT(!receiver.Receive(Store(value)));
+  CPPUNIT_ASSERT(!receiver.Receive(Store(value)));
+}
+
+void JsonSequenceReceiverTester::TestSentArray() {
+  auto out = std::vector<std::string>{"a", "b \"quoted\"", "", "line\nbreak"};
+  auto buffer = SharedBuffer();
+  auto sender = JsonSender<SharedBuffer>();
+  sender.SetSink(Ref(buffer));
+  sender.Shuttle(out);
+  auto receiver = JsonSequenceReceiver<std::string, SharedBuffer>();
+  receiver.SetSource(Ref(buffer));
+  auto in = std::vector<std::string>();
+  auto value = std::string();
+  while(receiver.Receive(Store(value))) {
+    in.push_back(value);
+  }
+  CPPUNIT_ASSERT(in == out);
+}
+
+void JsonSequenceReceiverTester::TestStructures() {
+  auto out = std::vector<ClassWithShuttleMethod>();
+  for(auto i = 0; i < 100; ++i) {
+    out.emplace_back(static_cast<char>('a' + i % 26), i, i / 4.0);
+  }
+  auto buffer = SharedBuffer();
+  auto sender = JsonSender<SharedBuffer>();
+  sender.SetSink(Ref(buffer));
+  sender.Shuttle(out);
+  auto receiver = JsonSequenceReceiver<ClassWithShuttleMethod,
+    SharedBuffer>();
+  receiver.SetSource(Ref(buffer));
+  auto in = std::vector<ClassWithShuttleMethod>();
+  auto value = ClassWithShuttleMethod();
+  while(receiver.Receive(Store(value))) {
+    in.push_back(value);
+  }
+  CPPUNIT_ASSERT(in == out);
+}
+
+void JsonSequenceReceiverTester::TestMalformedArray() {
+  auto buffer = BufferFromString<SharedBuffer>("[1, 2 3]");
+  auto receiver = JsonSequenceReceiver<int, SharedBuffer>();
+  receiver.SetSource(Ref(buffer));
+  auto value = 0;
+  CPPUNIT_ASSERT(receiver.Receive(Store(value)));
+  CPPUNIT_ASSERT(value == 1);
+  CPPUNIT_ASSERT(receiver.Receive(Store(value)));
+  CPPUNIT_ASSERT(value == 2);
+  CPPUNIT_ASSERT_THROW(receiver.Receive(Store(value)),
+    SerializationException);
+  CPPUNIT_ASSERT(!receiver.Receive(Store(value)));
+}
+
+void JsonSequenceReceiverTester::TestNonArray() {
+  auto buffer = BufferFromString<SharedBuffer>("{\"a\": 1}");
+  auto receiver = JsonSequenceReceiver<int, SharedBuffer>();
+  CPPUNIT_ASSERT_THROW(receiver.SetSource(Ref(buffer)),
+    SerializationException);
+  auto value = 0;
+  CPPUNIT_ASSERT(!receiver.Receive(Store(value)));
+}
@@ -4,6 +4,7 @@
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include "Beam/SerializationTests/BinaryShuttleTester.hpp"
+#include "Beam/SerializationTests/JsonSequenceReceiverTester.hpp"
 #include "Beam/SerializationTests/JsonShuttleTester.hpp"
 #include "Beam/SerializationTests/ShuttleVariantTester.hpp"
 
@@ -14,6 +15,7 @@ int main() {
   CppUnit::BriefTestProgressListener listener;
   runner.eventManager().addListener(&listener);
   runner.addTest(BinaryShuttleTester::suite());
+  runner.addTest(JsonSequenceReceiverTester::suite());
   runner.addTest(JsonShuttleTester::suite());
   runner.addTest(ShuttleVariantTester::suite());
   runner.setOutputter(new CPPUNIT_NS::CompilerOutputter(&runner.result(),
@@ -0,0 +1,195 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <doctest/doctest.h>
+#include "Beam/Codecs/GZipDecoder.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/WebServices/FileStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Codecs;
+using namespace Beam::IO;
+using namespace Beam::WebServices;
+
+namespace {
+  struct Fixture {
+    std::filesystem::path m_root;
+
+    Fixture()
+        : m_root(std::filesystem::temp_directory_path() /
+            "beam_file_store_tester") {
+      std::filesystem::remove_all(m_root);
+      std::filesystem::create_directories(m_root / "site");
+      Write("site/index.html", "<html>hello world</html>");
+      Write("secret.txt", "secret");
+    }
+
+    ~Fixture() {
+      std::filesystem::remove_all(m_root);
+    }
+
+    void Write(const std::string& path, const std::string& contents) {
+      std::ofstream file(m_root / path, std::ios::out | std::ios::binary |
+        std::ios::trunc);
+      file << contents;
+    }
+  };
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string GetBody(const HttpResponse& response) {
+    if(response.GetFileBody() == nullptr) {
+      return ToString(response.GetBody());
+    }
+    auto body = SharedBuffer();
+    response.GetFileBody()->Read(0,
+      static_cast<std::size_t>(response.GetFileBody()->GetSize()),
+      Store(body));
+    return ToString(body);
+  }
+
+  HttpRequest MakeRequest(const std::string& path,
+      const std::string& header = {}, const std::string& value = {}) {
+    auto request = HttpRequest(HttpMethod::GET,
+      Uri{"http://localhost" + path});
+    if(!header.empty()) {
+      request.Add(HttpHeader(header, value));
+    }
+    return request;
+  }
+
+  std::string MakeText() {
+    auto text = std::string();
+    for(auto i = 0; i < 200; ++i) {
+      text += "<p>paragraph " + std::to_string(i) + "</p>\n";
+    }
+    return text;
+  }
+}
+
+TEST_SUITE("FileStore") {
+  TEST_CASE_FIXTURE(Fixture, "serve") {
+    auto fileStore = FileStore(m_root / "site");
+    auto response = fileStore.Serve(MakeRequest("/index.html"));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::OK);
+    REQUIRE(GetBody(response) == "<html>hello world</html>");
+    REQUIRE(*response.GetHeader("Content-Type") == "text/html");
+    REQUIRE(*response.GetHeader("Content-Length") == "24");
+    REQUIRE(response.GetHeader("ETag").is_initialized());
+    REQUIRE(response.GetHeader("Last-Modified")->size() == 29);
+    REQUIRE(fileStore.Serve("missing.html").GetStatusCode() ==
+      HttpStatusCode::NOT_FOUND);
+    REQUIRE(fileStore.Serve(MakeRequest("/")).GetStatusCode() ==
+      HttpStatusCode::NOT_FOUND);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "outside_root") {
+    auto fileStore = FileStore(m_root / "site");
+    REQUIRE(fileStore.Serve("../secret.txt").GetStatusCode() ==
+      HttpStatusCode::NOT_FOUND);
+    REQUIRE(fileStore.Serve("a/../../secret.txt").GetStatusCode() ==
+      HttpStatusCode::NOT_FOUND);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "modified_file") {
+    auto fileStore = FileStore(m_root / "site");
+    auto response = fileStore.Serve("index.html");
+    auto entityTag = *response.GetHeader("ETag");
+    Write("site/index.html", "<html>goodbye</html>");
+    std::filesystem::last_write_time(m_root / "site/index.html",
+      std::filesystem::last_write_time(m_root / "site/index.html") +
+      std::chrono::seconds(10));
+    response = fileStore.Serve("index.html");
+    REQUIRE(GetBody(response) == "<html>goodbye</html>");
+    REQUIRE(*response.GetHeader("ETag") != entityTag);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "not_modified") {
+    auto fileStore = FileStore(m_root / "site");
+    auto response = fileStore.Serve(MakeRequest("/index.html"));
+    auto entityTag = *response.GetHeader("ETag");
+    response = fileStore.Serve(MakeRequest("/index.html", "If-None-Match",
+      "\"other\", " + entityTag));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::NOT_MODIFIED);
+    REQUIRE(response.GetBody().IsEmpty());
+    REQUIRE(*response.GetHeader("ETag") == entityTag);
+    response = fileStore.Serve(MakeRequest("/index.html", "If-None-Match",
+      "\"other\""));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::OK);
+    auto lastModified = *response.GetHeader("Last-Modified");
+    response = fileStore.Serve(MakeRequest("/index.html", "If-Modified-Since",
+      lastModified));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::NOT_MODIFIED);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "range") {
+    auto fileStore = FileStore(m_root / "site");
+    auto response = fileStore.Serve(MakeRequest("/index.html", "Range",
+      "bytes=6-10"));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::PARTIAL_CONTENT);
+    REQUIRE(GetBody(response) == "hello");
+    REQUIRE(*response.GetHeader("Content-Range") == "bytes 6-10/24");
+    response = fileStore.Serve(MakeRequest("/index.html", "Range",
+      "bytes=-7"));
+    REQUIRE(GetBody(response) == "</html>");
+    response = fileStore.Serve(MakeRequest("/index.html", "Range",
+      "bytes=17-100"));
+    REQUIRE(GetBody(response) == "</html>");
+    response = fileStore.Serve(MakeRequest("/index.html", "Range",
+      "bytes=24-"));
+    REQUIRE(response.GetStatusCode() ==
+      HttpStatusCode::REQUESTED_RANGE_NOT_SATISFIABLE);
+    REQUIRE(*response.GetHeader("Content-Range") == "bytes */24");
+    response = fileStore.Serve(MakeRequest("/index.html", "Range",
+      "bytes=0-1,4-5"));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::OK);
+    REQUIRE(GetBody(response) == "<html>hello world</html>");
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "gzip") {
+    auto text = MakeText();
+    Write("site/text.html", text);
+    auto fileStore = FileStore(m_root / "site");
+    auto response = fileStore.Serve(MakeRequest("/text.html",
+      "Accept-Encoding", "deflate, gzip;q=0.5"));
+    REQUIRE(*response.GetHeader("Content-Encoding") == "gzip");
+    REQUIRE(*response.GetHeader("Vary") == "Accept-Encoding");
+    REQUIRE(response.GetBody().GetSize() < text.size() / 2);
+    auto decoder = GZipDecoder();
+    auto decodedBody = SharedBuffer();
+    decoder.Decode(response.GetBody(), Store(decodedBody));
+    REQUIRE(ToString(decodedBody) == text);
+    auto gzipEntityTag = *response.GetHeader("ETag");
+    response = fileStore.Serve(MakeRequest("/text.html", "Accept-Encoding",
+      "gzip;q=0"));
+    REQUIRE(!response.GetHeader("Content-Encoding").is_initialized());
+    REQUIRE(GetBody(response) == text);
+    REQUIRE(*response.GetHeader("ETag") != gzipEntityTag);
+    response = fileStore.Serve(MakeRequest("/text.html", "If-None-Match",
+      gzipEntityTag));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::NOT_MODIFIED);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "large_file") {
+    auto text = MakeText();
+    Write("site/text.html", text);
+    auto fileStore = FileStore(m_root / "site",
+      ContentTypePatterns::GetDefaultPatterns(), 1024 * 1024, 1024);
+    auto response = fileStore.Serve(MakeRequest("/text.html",
+      "Accept-Encoding", "gzip"));
+    REQUIRE(response.GetFileBody() != nullptr);
+    REQUIRE(!response.GetHeader("Content-Encoding").is_initialized());
+    REQUIRE(*response.GetHeader("Content-Length") ==
+      std::to_string(text.size()));
+    REQUIRE(GetBody(response) == text);
+    response = fileStore.Serve(MakeRequest("/text.html", "Range",
+      "bytes=3-9"));
+    REQUIRE(response.GetStatusCode() == HttpStatusCode::PARTIAL_CONTENT);
+    REQUIRE(GetBody(response) == text.substr(3, 7));
+    auto buffer = SharedBuffer();
+    response.Encode(Store(buffer));
+    REQUIRE(ToString(buffer).substr(buffer.GetSize() - 7) == text.substr(3, 7));
+  }
+}
@@ -0,0 +1,117 @@
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/Codecs/GZipDecoder.hpp"
+#include "Beam/Codecs/ZLibDecoder.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/WebServices/HttpBodyWriter.hpp"
+#include "Beam/WebServices/HttpResponse.hpp"
+#include "Beam/WebServices/HttpResponseParser.hpp"
+
+using namespace Beam;
+using namespace Beam::Codecs;
+using namespace Beam::IO;
+using namespace Beam::WebServices;
+
+namespace {
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::vector<std::string> MakeRows() {
+    auto rows = std::vector<std::string>();
+    for(auto i = 0; i < 100; ++i) {
+      rows.push_back("{\"id\": " + std::to_string(i) +
+        ", \"name\": \"row\"}\n");
+    }
+    return rows;
+  }
+}
+
+TEST_SUITE("HttpBodyWriter") {
+  TEST_CASE("identity") {
+    auto parts = std::vector<std::string>();
+    auto writer = HttpBodyWriter(
+      [&] (const SharedBuffer& data) {
+        parts.push_back(ToString(data));
+      });
+    writer.Write(std::string("hello "));
+    writer.Write(std::string());
+    writer.Write(BufferFromString<SharedBuffer>("world"));
+    writer.Close();
+    REQUIRE(parts.size() == 2);
+    REQUIRE(parts[0] == "hello ");
+    REQUIRE(parts[1] == "world");
+  }
+
+  TEST_CASE("gzip") {
+    auto rows = MakeRows();
+    auto encoded = SharedBuffer();
+    auto writes = 0;
+    auto writer = HttpBodyWriter(
+      [&] (const SharedBuffer& data) {
+        REQUIRE(!data.IsEmpty());
+        encoded.Append(data);
+        ++writes;
+      }, TransferEncoding::GZIP, 6);
+    auto expected = std::string();
+    for(auto& row : rows) {
+      writer.Write(row);
+      expected += row;
+    }
+    REQUIRE(writes == static_cast<int>(rows.size()));
+    writer.Close();
+    writer.Close();
+    REQUIRE(writes == static_cast<int>(rows.size()) + 1);
+    REQUIRE(encoded.GetSize() < expected.size());
+    auto decoder = GZipDecoder();
+    auto decoded = SharedBuffer();
+    decoder.Decode(encoded, Store(decoded));
+    REQUIRE(ToString(decoded) == expected);
+  }
+
+  TEST_CASE("deflate") {
+    auto rows = MakeRows();
+    auto encoded = SharedBuffer();
+    auto writer = HttpBodyWriter(
+      [&] (const SharedBuffer& data) {
+        encoded.Append(data);
+      }, TransferEncoding::DEFLATE, 1);
+    auto expected = std::string();
+    for(auto& row : rows) {
+      writer.Write(row.data(), row.size());
+      expected += row;
+    }
+    writer.Close();
+    auto decoder = ZLibDecoder();
+    auto decoded = SharedBuffer();
+    decoder.Decode(encoded, Store(decoded));
+    REQUIRE(ToString(decoded) == expected);
+  }
+
+  TEST_CASE("chunked_response") {
+    auto response = HttpResponse();
+    response.SetHeader({"Content-Type", "application/json"});
+    response.SetBodyStream(
+      [] (HttpBodyWriter& writer) {
+        writer.Write(std::string("[1, "));
+        writer.Write(std::string("2, 3]"));
+      });
+    REQUIRE(!response.GetHeader("Content-Length").is_initialized());
+    REQUIRE(*response.GetHeader("Transfer-Encoding") == "chunked");
+    auto buffer = SharedBuffer();
+    response.Encode(Store(buffer));
+    auto encoded = ToString(buffer);
+    REQUIRE(encoded.substr(encoded.find("\r\n\r\n") + 4) ==
+      "4\r\n[1, \r\n5\r\n2, 3]\r\n0\r\n\r\n");
+    auto parser = HttpResponseParser();
+    parser.Feed(buffer.GetData(), buffer.GetSize());
+    auto parsedResponse = parser.GetNextResponse();
+    REQUIRE(parsedResponse.is_initialized());
+    REQUIRE(ToString(parsedResponse->GetBody()) == "[1, 2, 3]");
+    response.SetBody(BufferFromString<SharedBuffer>("[]"));
+    REQUIRE(!response.GetBodyStream());
+    REQUIRE(!response.GetHeader("Transfer-Encoding").is_initialized());
+    REQUIRE(*response.GetHeader("Content-Length") == "2");
+  }
+}
@@ -0,0 +1,261 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalServerConnection.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+#include "Beam/Routines/RoutineHandlerGroup.hpp"
+#include "Beam/Threading/LiveTimer.hpp"
+#include "Beam/Threading/TimerThreadPool.hpp"
+#include "Beam/WebServices/HttpClient.hpp"
+#include "Beam/WebServices/HttpRequestParser.hpp"
+#include "Beam/WebServices/HttpServer.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+using namespace Beam::Threading;
+using namespace Beam::WebServices;
+using namespace boost::posix_time;
+
+namespace {
+  using TestServerConnection = LocalServerConnection<SharedBuffer>;
+  using TestClientChannel = LocalClientChannel<SharedBuffer>;
+  using TestHttpClient = HttpClient<std::unique_ptr<TestClientChannel>>;
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  struct Fixture {
+    TestServerConnection m_serverConnection;
+    std::atomic_int m_channelCount;
+    HttpServer<TestServerConnection*> m_server;
+
+    Fixture()
+        : m_channelCount(0),
+          m_server(&m_serverConnection, MakeSlots(), MakeOptions()) {
+      m_server.Open();
+    }
+
+    static std::vector<HttpRequestSlot> MakeSlots() {
+      auto slots = std::vector<HttpRequestSlot>();
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/echo"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetBody(BufferFromString<SharedBuffer>(
+            request.GetUri().GetQuery()));
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::POST, "/echo"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetBody(request.GetBody());
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/close"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Connection", "close"});
+          return response;
+        });
+      return slots;
+    }
+
+    static HttpServerOptions MakeOptions() {
+      auto options = HttpServerOptions();
+      options.m_loggingEnabled = false;
+      return options;
+    }
+
+    std::unique_ptr<TestHttpClient> MakeClient(
+        const HttpClientOptions& options = HttpClientOptions()) {
+      return std::make_unique<TestHttpClient>(
+        [=] (const Uri& uri) {
+          ++m_channelCount;
+          return std::make_unique<TestClientChannel>("client",
+            Ref(m_serverConnection));
+        }, options);
+    }
+
+    static HttpRequest MakeRequest(const std::string& target) {
+      return HttpRequest(HttpMethod::GET, Uri("http://localhost" + target));
+    }
+  };
+}
+
+TEST_SUITE("HttpClient") {
+  TEST_CASE_FIXTURE(Fixture, "keep_alive") {
+    auto client = MakeClient();
+    for(auto i = 0; i < 10; ++i) {
+      auto response = client->Send(MakeRequest("/echo?" + std::to_string(i)));
+      REQUIRE(response.GetStatusCode() == HttpStatusCode::OK);
+      REQUIRE(ToString(response.GetBody()) == std::to_string(i));
+    }
+    REQUIRE(m_channelCount == 1);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "connection_close") {
+    auto client = MakeClient();
+    for(auto i = 0; i < 3; ++i) {
+      REQUIRE(client->Send(MakeRequest("/close")).GetStatusCode() ==
+        HttpStatusCode::OK);
+    }
+    REQUIRE(m_channelCount == 3);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "idle_timeout") {
+    auto options = HttpClientOptions();
+    options.m_idleTimeout = seconds(0);
+    auto client = MakeClient(options);
+    for(auto i = 0; i < 3; ++i) {
+      REQUIRE(client->Send(MakeRequest("/echo?a")).GetStatusCode() ==
+        HttpStatusCode::OK);
+    }
+    REQUIRE(m_channelCount == 3);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "concurrent_sends") {
+    auto options = HttpClientOptions();
+    options.m_maxConnections = 2;
+    options.m_maxPipelinedRequests = 4;
+    auto client = MakeClient(options);
+    auto mismatches = std::atomic_int(0);
+    auto routines = RoutineHandlerGroup();
+    for(auto i = 0; i < 64; ++i) {
+      routines.Spawn([&, i] {
+        if(i % 8 == 0) {
+          auto request = HttpRequest(HttpMethod::POST,
+            Uri("http://localhost/echo"),
+            BufferFromString<SharedBuffer>(std::to_string(i)));
+          if(ToString(client->Send(request).GetBody()) != std::to_string(i)) {
+            ++mismatches;
+          }
+        } else if(ToString(client->Send(MakeRequest("/echo?" +
+            std::to_string(i))).GetBody()) != std::to_string(i)) {
+          ++mismatches;
+        }
+      });
+    }
+    routines.Wait();
+    REQUIRE(mismatches == 0);
+    REQUIRE(m_channelCount <= 2);
+  }
+
+  TEST_CASE("stale_connection") {
+    auto serverConnection = TestServerConnection();
+    serverConnection.Open();
+
+    // Stands in for a server that closes keep-alive connections as soon as
+    // it answers them.
+    auto server = RoutineHandler(Spawn([&] {
+      while(true) {
+        auto serverChannel = [&] {
+          try {
+            return serverConnection.Accept();
+          } catch(const std::exception&) {
+            return std::unique_ptr<TestServerConnection::Channel>();
+          }
+        }();
+        if(serverChannel == nullptr) {
+          return;
+        }
+        auto parser = HttpRequestParser();
+        auto buffer = SharedBuffer();
+        try {
+          while(!parser.GetNextRequest().is_initialized()) {
+            serverChannel->GetReader().Read(Store(buffer));
+            parser.Feed(buffer.GetData(), buffer.GetSize());
+            buffer.Reset();
+          }
+          serverChannel->GetWriter().Write(BufferFromString<SharedBuffer>(
+            "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok"));
+        } catch(const std::exception&) {}
+        serverChannel->GetConnection().Close();
+      }
+    }));
+    auto channelCount = 0;
+    auto client = TestHttpClient(
+      [&] (const Uri& uri) {
+        ++channelCount;
+        return std::make_unique<TestClientChannel>("client",
+          Ref(serverConnection));
+      });
+    for(auto i = 0; i < 3; ++i) {
+      REQUIRE(ToString(client.Send(Fixture::MakeRequest("/")).GetBody()) ==
+        "ok");
+    }
+    REQUIRE(channelCount == 3);
+    serverConnection.Close();
+  }
+
+  TEST_CASE("pipelined_connection_close") {
+    auto timerThreadPool = TimerThreadPool(1);
+    auto serverConnection = TestServerConnection();
+    serverConnection.Open();
+
+    // Answers only the first request on each connection, after the rest
+    // have been pipelined behind it, and closes the connection.
+    auto server = RoutineHandler(Spawn([&] {
+      while(true) {
+        auto serverChannel = [&] {
+          try {
+            return serverConnection.Accept();
+          } catch(const std::exception&) {
+            return std::unique_ptr<TestServerConnection::Channel>();
+          }
+        }();
+        if(serverChannel == nullptr) {
+          return;
+        }
+        auto parser = HttpRequestParser();
+        auto buffer = SharedBuffer();
+        try {
+          while(!parser.GetNextRequest().is_initialized()) {
+            serverChannel->GetReader().Read(Store(buffer));
+            parser.Feed(buffer.GetData(), buffer.GetSize());
+            buffer.Reset();
+          }
+          auto timer = LiveTimer(milliseconds(20), Ref(timerThreadPool));
+          timer.Start();
+          timer.Wait();
+          serverChannel->GetWriter().Write(BufferFromString<SharedBuffer>(
+            "HTTP/1.1 200 OK\r\nConnection: close\r\n"
+            "Content-Length: 2\r\n\r\nok"));
+        } catch(const std::exception&) {}
+        serverChannel->GetConnection().Close();
+      }
+    }));
+    auto channelCount = std::atomic_int(0);
+    auto options = HttpClientOptions();
+    options.m_maxConnections = 1;
+    options.m_maxPipelinedRequests = 8;
+    auto client = TestHttpClient(
+      [&] (const Uri& uri) {
+        ++channelCount;
+        return std::make_unique<TestClientChannel>("client",
+          Ref(serverConnection));
+      }, options);
+    auto failures = std::atomic_int(0);
+    auto routines = RoutineHandlerGroup();
+    for(auto i = 0; i < 8; ++i) {
+      routines.Spawn([&] {
+        try {
+          if(ToString(client.Send(Fixture::MakeRequest("/")).GetBody()) !=
+              "ok") {
+            ++failures;
+          }
+        } catch(const std::exception&) {
+          ++failures;
+        }
+      });
+    }
+    routines.Wait();
+    REQUIRE(failures == 0);
+    REQUIRE(channelCount == 8);
+    serverConnection.Close();
+  }
+}
@@ -0,0 +1,32 @@
+#include <doctest/doctest.h>
+#include "Beam/WebServices/HttpContentEncoding.hpp"
+
+using namespace Beam;
+using namespace Beam::WebServices;
+
+TEST_SUITE("HttpContentEncoding") {
+  TEST_CASE("select_content_encoding") {
+    REQUIRE(SelectContentEncoding("") == TransferEncoding::IDENTITY);
+    REQUIRE(SelectContentEncoding("gzip, deflate, br") ==
+      TransferEncoding::GZIP);
+    REQUIRE(SelectContentEncoding("deflate") == TransferEncoding::DEFLATE);
+    REQUIRE(SelectContentEncoding("GZip;q=0.5, deflate") ==
+      TransferEncoding::DEFLATE);
+    REQUIRE(SelectContentEncoding("gzip;q=0, deflate;q=0") ==
+      TransferEncoding::IDENTITY);
+    REQUIRE(SelectContentEncoding("*") == TransferEncoding::GZIP);
+    REQUIRE(SelectContentEncoding("gzip;q=0, *;q=0.1") ==
+      TransferEncoding::DEFLATE);
+    REQUIRE(SelectContentEncoding("br, identity") ==
+      TransferEncoding::IDENTITY);
+  }
+
+  TEST_CASE("is_compressible") {
+    REQUIRE(IsCompressible("text/html; charset=utf-8"));
+    REQUIRE(IsCompressible("application/json"));
+    REQUIRE(IsCompressible("application/javascript"));
+    REQUIRE(IsCompressible("image/svg+xml"));
+    REQUIRE(!IsCompressible("image/png"));
+    REQUIRE(!IsCompressible("application/octet-stream"));
+  }
+}
@@ -22,4 +22,69 @@ TEST_SUITE("HttpRequestParser") {
     REQUIRE(request->GetCookie("theme")->GetValue() == "light");
     REQUIRE(request->GetCookie("sessionToken")->GetValue() == "abc123");
   }
+
+  TEST_CASE("unencoded_request_target") {
+    auto parser = HttpRequestParser();
+    auto requestString =
+      "GET /items/[0]?ids[]=1&ids[]=2&q={a|b^c`d} HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "\r\n";
+    parser.Feed(requestString, std::strlen(requestString));
+    auto request = parser.GetNextRequest();
+    REQUIRE(request.is_initialized());
+    REQUIRE(request->GetUri().GetPath() == "/items/[0]");
+    REQUIRE(request->GetUri().GetQuery() == "ids[]=1&ids[]=2&q={a|b^c`d}");
+  }
+
+  TEST_CASE("pipelined_requests") {
+    auto parser = HttpRequestParser();
+    auto requestString =
+      "GET /a HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "\r\n"
+      "POST /b HTTP/1.1\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "hello"
+      "GET /c HTTP/1.1\r\n"
+      "Host: local";
+    parser.Feed(requestString, std::strlen(requestString));
+    auto first = parser.GetNextRequest();
+    REQUIRE(first.is_initialized());
+    REQUIRE(first->GetUri().GetPath() == "/a");
+    auto second = parser.GetNextRequest();
+    REQUIRE(second.is_initialized());
+    REQUIRE(second->GetMethod() == HttpMethod::POST);
+    REQUIRE(second->GetUri().GetPath() == "/b");
+    REQUIRE(std::string(second->GetBody().GetData(),
+      second->GetBody().GetSize()) == "hello");
+    REQUIRE(!parser.GetNextRequest().is_initialized());
+    auto remainder = "host\r\n\r\n";
+    parser.Feed(remainder, std::strlen(remainder));
+    auto third = parser.GetNextRequest();
+    REQUIRE(third.is_initialized());
+    REQUIRE(third->GetUri().GetPath() == "/c");
+  }
+
+  TEST_CASE("max_header_size") {
+    auto requestString = std::string(
+      "GET /path HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "\r\n");
+    auto parser = HttpRequestParser(requestString.size());
+    parser.Feed(requestString.c_str(), requestString.size());
+    REQUIRE(parser.GetNextRequest().is_initialized());
+    auto largeRequest = std::string(
+      "GET /path HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "Accept: */*\r\n"
+      "\r\n");
+    parser.Feed(largeRequest.c_str(), largeRequest.size());
+    REQUIRE_THROWS_AS(parser.GetNextRequest(), InvalidHttpRequestException);
+    auto unterminatedParser = HttpRequestParser(16);
+    auto header = std::string(32, 'a');
+    unterminatedParser.Feed(header.c_str(), header.size());
+    REQUIRE_THROWS_AS(unterminatedParser.GetNextRequest(),
+      InvalidHttpRequestException);
+  }
 }
@@ -0,0 +1,86 @@
+#include <doctest/doctest.h>
+#include "Beam/WebServices/HttpResponse.hpp"
+#include "Beam/WebServices/HttpRouter.hpp"
+#include "Beam/WebServices/HttpServerPredicates.hpp"
+
+using namespace Beam;
+using namespace Beam::WebServices;
+
+namespace {
+  HttpRequestSlot::Slot MakeSlot(int id) {
+    return [=] (const HttpRequest& request) {
+      return HttpResponse(static_cast<HttpStatusCode>(id));
+    };
+  }
+
+  int Route(const HttpRouter& router, HttpMethod method,
+      const std::string& uri) {
+    auto slot = router.Find(HttpRequest(method, Uri(uri)));
+    if(slot == nullptr) {
+      return 0;
+    }
+    return static_cast<int>(
+      slot->m_slot(HttpRequest(method, Uri(uri))).GetStatusCode());
+  }
+}
+
+TEST_SUITE("HttpRouter") {
+  TEST_CASE("exact") {
+    auto slots = std::vector<HttpRequestSlot>();
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/a"), MakeSlot(200));
+    slots.emplace_back(HttpRoute(HttpMethod::POST, "/a"), MakeSlot(201));
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/b"), MakeSlot(202));
+    auto router = HttpRouter(std::move(slots));
+    REQUIRE(Route(router, HttpMethod::GET, "/a") == 200);
+    REQUIRE(Route(router, HttpMethod::POST, "/a") == 201);
+    REQUIRE(Route(router, HttpMethod::GET, "/b?c=d") == 202);
+    REQUIRE(Route(router, HttpMethod::POST, "/b") == 0);
+    REQUIRE(Route(router, HttpMethod::GET, "/a/b") == 0);
+  }
+
+  TEST_CASE("prefix") {
+    auto slots = std::vector<HttpRequestSlot>();
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/static/js/",
+      HttpRoute::Match::PREFIX), MakeSlot(200));
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/static",
+      HttpRoute::Match::PREFIX), MakeSlot(201));
+    auto router = HttpRouter(std::move(slots));
+    REQUIRE(Route(router, HttpMethod::GET, "/static/js/app.js") == 200);
+    REQUIRE(Route(router, HttpMethod::GET, "/static/js") == 200);
+    REQUIRE(Route(router, HttpMethod::GET, "/static/css/app.css") == 201);
+    REQUIRE(Route(router, HttpMethod::GET, "/static") == 201);
+    REQUIRE(Route(router, HttpMethod::GET, "/statics") == 0);
+    REQUIRE(Route(router, HttpMethod::GET, "/") == 0);
+    REQUIRE(Route(router, HttpMethod::POST, "/static/js/app.js") == 0);
+  }
+
+  TEST_CASE("precedence") {
+    auto slots = std::vector<HttpRequestSlot>();
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/api",
+      HttpRoute::Match::PREFIX), MakeSlot(200));
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/api/status"),
+      MakeSlot(201));
+    slots.emplace_back(MatchesPath(HttpMethod::GET, "/index.html"),
+      MakeSlot(202));
+    slots.emplace_back(HttpRoute(HttpMethod::GET, "/",
+      HttpRoute::Match::PREFIX), MakeSlot(203));
+    slots.emplace_back(MatchAny(HttpMethod::POST), MakeSlot(204));
+    auto router = HttpRouter(std::move(slots));
+    REQUIRE(Route(router, HttpMethod::GET, "/api/status") == 200);
+    REQUIRE(Route(router, HttpMethod::GET, "/index.html") == 202);
+    REQUIRE(Route(router, HttpMethod::GET, "/other") == 203);
+    REQUIRE(Route(router, HttpMethod::GET, "") == 203);
+    REQUIRE(Route(router, HttpMethod::POST, "/api/status") == 204);
+  }
+
+  TEST_CASE("route_predicate") {
+    auto slot = HttpRequestSlot(HttpRoute(HttpMethod::GET, "/static",
+      HttpRoute::Match::PREFIX), MakeSlot(200));
+    REQUIRE(slot.m_predicate(HttpRequest(HttpMethod::GET,
+      Uri("/static/a.js"))));
+    REQUIRE(!slot.m_predicate(HttpRequest(HttpMethod::GET,
+      Uri("/statics"))));
+    REQUIRE(!slot.m_predicate(HttpRequest(HttpMethod::POST,
+      Uri("/static"))));
+  }
+}
@@ -0,0 +1,215 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/Codecs/GZipDecoder.hpp"
+#include "Beam/Codecs/ZLibDecoder.hpp"
+#include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalServerConnection.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/WebServices/HttpResponseParser.hpp"
+#include "Beam/WebServices/HttpServer.hpp"
+
+using namespace Beam;
+using namespace Beam::Codecs;
+using namespace Beam::IO;
+using namespace Beam::WebServices;
+
+namespace {
+  using TestServerConnection = LocalServerConnection<SharedBuffer>;
+  using TestClientChannel = LocalClientChannel<SharedBuffer>;
+
+  const auto TEXT = std::string(4096, 'a');
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string GetHeader(const HttpResponse& response,
+      const std::string& name) {
+    if(auto header = response.GetHeader(name)) {
+      return *header;
+    }
+    return std::string();
+  }
+
+  struct Fixture {
+    TestServerConnection m_serverConnection;
+    HttpServer<TestServerConnection*> m_server;
+
+    Fixture()
+        : m_server(&m_serverConnection, MakeSlots(), MakeOptions()) {
+      m_server.Open();
+    }
+
+    static std::vector<HttpRequestSlot> MakeSlots() {
+      auto slots = std::vector<HttpRequestSlot>();
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/text"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "text/plain"});
+          response.SetHeader({"ETag", "\"v1\""});
+          response.SetHeader({"Vary", "Origin"});
+          response.SetBody(BufferFromString<SharedBuffer>(TEXT));
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/small"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "text/plain"});
+          response.SetBody(BufferFromString<SharedBuffer>("small"));
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/image"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "image/png"});
+          response.SetBody(BufferFromString<SharedBuffer>(TEXT));
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/stream"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "text/plain"});
+          response.SetBodyStream(
+            [] (HttpBodyWriter& writer) {
+              for(auto i = 0; i < 4; ++i) {
+                writer.Write(TEXT);
+              }
+            });
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/early_failure"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "text/plain"});
+          response.SetBodyStream(
+            [] (HttpBodyWriter& writer) {
+              throw std::runtime_error("early");
+            });
+          return response;
+        });
+      slots.emplace_back(HttpRoute(HttpMethod::GET, "/late_failure"),
+        [] (const HttpRequest& request) {
+          auto response = HttpResponse();
+          response.SetHeader({"Content-Type", "text/plain"});
+          response.SetBodyStream(
+            [] (HttpBodyWriter& writer) {
+              writer.Write(TEXT);
+              throw std::runtime_error("late");
+            });
+          return response;
+        });
+      return slots;
+    }
+
+    static HttpServerOptions MakeOptions() {
+      auto options = HttpServerOptions();
+      options.m_compressionThreshold = 1024;
+      options.m_loggingEnabled = false;
+      return options;
+    }
+
+    std::unique_ptr<TestClientChannel> Connect() {
+      auto channel = std::make_unique<TestClientChannel>("client",
+        Ref(m_serverConnection));
+      channel->GetConnection().Open();
+      return channel;
+    }
+
+    static boost::optional<HttpResponse> Exchange(TestClientChannel& channel,
+        const std::string& target,
+        const std::string& headers = std::string()) {
+      channel.GetWriter().Write(BufferFromString<SharedBuffer>(
+        "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n" + headers +
+        "\r\n"));
+      auto parser = HttpResponseParser();
+      auto buffer = SharedBuffer();
+      try {
+        while(true) {
+          if(auto response = parser.GetNextResponse()) {
+            return response;
+          }
+          channel.GetReader().Read(Store(buffer));
+          parser.Feed(buffer.GetData(), buffer.GetSize());
+          buffer.Reset();
+        }
+      } catch(const std::exception&) {
+        return boost::none;
+      }
+    }
+  };
+}
+
+TEST_SUITE("HttpServer") {
+  TEST_CASE_FIXTURE(Fixture, "compression") {
+    auto channel = Connect();
+    auto response = Exchange(*channel, "/text",
+      "Accept-Encoding: gzip\r\n");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding") == "gzip");
+    REQUIRE(GetHeader(*response, "Vary") == "Origin, Accept-Encoding");
+    REQUIRE(GetHeader(*response, "ETag") == "W/\"v1\"");
+    REQUIRE(response->GetBody().GetSize() < TEXT.size());
+    auto decoded = SharedBuffer();
+    GZipDecoder().Decode(response->GetBody(), Store(decoded));
+    REQUIRE(ToString(decoded) == TEXT);
+    response = Exchange(*channel, "/text", "Accept-Encoding: deflate\r\n");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding") == "deflate");
+    decoded.Reset();
+    ZLibDecoder().Decode(response->GetBody(), Store(decoded));
+    REQUIRE(ToString(decoded) == TEXT);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "identity") {
+    auto channel = Connect();
+    auto response = Exchange(*channel, "/text");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding").empty());
+    REQUIRE(GetHeader(*response, "Vary") == "Origin, Accept-Encoding");
+    REQUIRE(GetHeader(*response, "ETag") == "\"v1\"");
+    REQUIRE(ToString(response->GetBody()) == TEXT);
+    response = Exchange(*channel, "/small", "Accept-Encoding: gzip\r\n");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding").empty());
+    REQUIRE(GetHeader(*response, "Vary").empty());
+    REQUIRE(ToString(response->GetBody()) == "small");
+    response = Exchange(*channel, "/image", "Accept-Encoding: gzip\r\n");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding").empty());
+    REQUIRE(ToString(response->GetBody()) == TEXT);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "chunked_stream") {
+    auto channel = Connect();
+    auto response = Exchange(*channel, "/stream");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Transfer-Encoding") == "chunked");
+    REQUIRE(ToString(response->GetBody()) ==
+      TEXT + TEXT + TEXT + TEXT);
+    response = Exchange(*channel, "/stream", "Accept-Encoding: gzip\r\n");
+    REQUIRE(response.is_initialized());
+    REQUIRE(GetHeader(*response, "Content-Encoding") == "gzip");
+    auto decoded = SharedBuffer();
+    GZipDecoder().Decode(response->GetBody(), Store(decoded));
+    REQUIRE(ToString(decoded) == TEXT + TEXT + TEXT + TEXT);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "stream_early_failure") {
+    auto channel = Connect();
+    auto response = Exchange(*channel, "/early_failure");
+    REQUIRE(response.is_initialized());
+    REQUIRE(response->GetStatusCode() ==
+      HttpStatusCode::INTERNAL_SERVER_ERROR);
+    response = Exchange(*channel, "/small");
+    REQUIRE(response.is_initialized());
+    REQUIRE(ToString(response->GetBody()) == "small");
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "stream_late_failure") {
+    auto channel = Connect();
+    REQUIRE(!Exchange(*channel, "/late_failure").is_initialized());
+  }
+}
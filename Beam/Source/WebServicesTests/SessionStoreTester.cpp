@@ -0,0 +1,308 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <doctest/doctest.h>
+#include "Beam/Routines/RoutineHandlerGroup.hpp"
+#include "Beam/Threading/TimerThreadPool.hpp"
+#include "Beam/WebServices/SessionStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Routines;
+using namespace Beam::Threading;
+using namespace Beam::WebServices;
+using namespace boost::posix_time;
+
+namespace {
+
+  /** A session storing a single value, guarded by its own lock. */
+  class TestSession : public Session {
+    public:
+      TestSession(std::string id)
+        : Session(std::move(id)),
+          m_value(0) {}
+
+      int GetValue() const {
+        boost::lock_guard<boost::mutex> lock{m_mutex};
+        return m_value;
+      }
+
+      void SetValue(int value) {
+        boost::lock_guard<boost::mutex> lock{m_mutex};
+        m_value = value;
+      }
+
+    private:
+      friend struct Serialization::DataShuttle;
+      mutable boost::mutex m_mutex;
+      int m_value;
+
+      template<typename Shuttler>
+      void Shuttle(Shuttler& shuttle, unsigned int version) {
+        boost::lock_guard<boost::mutex> lock{m_mutex};
+        Session::Shuttle(shuttle, version);
+        shuttle.Shuttle("value", m_value);
+      }
+  };
+
+  /** Records the operations performed on it, loads yield before completing
+      so that concurrent requests for the same session overlap. */
+  struct TestDataStore {
+    std::atomic_int m_loadCount;
+    std::atomic_int m_transactionCount;
+    std::unordered_map<std::string, int> m_stores;
+    std::unordered_map<std::string, int> m_deletes;
+
+    TestDataStore()
+        : m_loadCount(0),
+          m_transactionCount(0) {}
+
+    template<typename SessionType>
+    std::unique_ptr<SessionType> Load(const std::string& id) {
+      ++m_loadCount;
+      for(auto i = 0; i < 10; ++i) {
+        Defer();
+      }
+      if(m_stores.find(id) == m_stores.end()) {
+        return nullptr;
+      }
+      return std::make_unique<SessionType>(id);
+    }
+
+    template<typename SessionType>
+    void Store(const SessionType& session) {
+      ++m_stores[session.GetId()];
+    }
+
+    template<typename SessionType>
+    void Delete(const SessionType& session) {
+      ++m_deletes[session.GetId()];
+      m_stores.erase(session.GetId());
+    }
+
+    template<typename F>
+    void WithTransaction(F&& transaction) {
+      ++m_transactionCount;
+      transaction();
+    }
+
+    void Open() {}
+
+    void Close() {}
+  };
+
+  /** Records the value of each TestSession stored. */
+  struct TestValueDataStore : TestDataStore {
+    std::unordered_map<std::string, int> m_values;
+
+    void Store(const TestSession& session) {
+      TestDataStore::Store(session);
+      m_values[session.GetId()] = session.GetValue();
+    }
+  };
+
+  HttpRequest MakeRequest(const std::string& sessionId) {
+    auto request = HttpRequest(Uri("http://localhost/"));
+    request.Add(Cookie(SessionStoreConfig::GetDefaultSessionName(),
+      sessionId));
+    return request;
+  }
+}
+
+TEST_SUITE("SessionStore") {
+  TEST_CASE("create_and_find") {
+    auto store = SessionStore<Session>();
+    auto response = HttpResponse();
+    auto session = store.Get(HttpRequest(Uri("http://localhost/")),
+      Store(response));
+    auto cookie = response.GetCookie(
+      SessionStoreConfig::GetDefaultSessionName());
+    REQUIRE(cookie.is_initialized());
+    REQUIRE(cookie->GetValue() == session->GetId());
+    auto request = MakeRequest(session->GetId());
+    REQUIRE(store.Find(request) == session);
+    auto nextResponse = HttpResponse();
+    REQUIRE(store.Get(request, Store(nextResponse)) == session);
+    REQUIRE(nextResponse.GetCookies().empty());
+    REQUIRE(store.Find(MakeRequest("unknown")) == nullptr);
+    store.End(*session);
+    REQUIRE(session->IsExpired());
+    REQUIRE(store.Find(request) == nullptr);
+  }
+
+  TEST_CASE("many_sessions") {
+    auto config = SessionStoreConfig();
+    config.m_shardCount = 4;
+    auto store = SessionStore<Session>(config);
+    auto sessions = std::vector<std::shared_ptr<Session>>();
+    for(auto i = 0; i < 1000; ++i) {
+      sessions.push_back(store.Create());
+    }
+    for(auto& session : sessions) {
+      REQUIRE(store.Find(MakeRequest(session->GetId())) == session);
+    }
+  }
+
+  TEST_CASE("idle_expiry") {
+    auto config = SessionStoreConfig();
+    config.m_idleTimeout = milliseconds(50);
+    auto store = SessionStore<Session>(config);
+    auto session = store.Create();
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == session);
+    boost::this_thread::sleep(milliseconds(100));
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == nullptr);
+    REQUIRE(session->IsExpired());
+  }
+
+  TEST_CASE("time_to_live") {
+    auto config = SessionStoreConfig();
+    config.m_timeToLive = milliseconds(100);
+    auto store = SessionStore<Session>(config);
+    auto session = store.Create();
+    for(auto i = 0; i < 4; ++i) {
+      REQUIRE(store.Find(MakeRequest(session->GetId())) == session);
+      boost::this_thread::sleep(milliseconds(10));
+    }
+    boost::this_thread::sleep(milliseconds(100));
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == nullptr);
+    REQUIRE(session->IsExpired());
+  }
+
+  TEST_CASE("background_eviction") {
+    auto timerThreadPool = TimerThreadPool(1);
+    auto config = SessionStoreConfig();
+    config.m_idleTimeout = milliseconds(20);
+    config.m_maintenanceInterval = milliseconds(10);
+    auto store = SessionStore<Session>(config, Initialize(),
+      Ref(timerThreadPool));
+    auto session = store.Create();
+    for(auto i = 0; i < 100 && !session->IsExpired(); ++i) {
+      boost::this_thread::sleep(milliseconds(10));
+    }
+    REQUIRE(session->IsExpired());
+  }
+
+  TEST_CASE("persistent_without_data_store") {
+    auto config = SessionStoreConfig();
+    config.m_idleTimeout = milliseconds(50);
+    auto store = SessionStore<Session>(config);
+    auto session = store.Create();
+    auto response = HttpResponse();
+    store.Persist(*session, Store(response));
+    boost::this_thread::sleep(milliseconds(100));
+    store.EvictExpired();
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == session);
+    REQUIRE(!session->IsExpired());
+    store.NonPersist(*session, Store(response));
+    boost::this_thread::sleep(milliseconds(100));
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == nullptr);
+    REQUIRE(session->IsExpired());
+  }
+
+  TEST_CASE("destroy_during_maintenance") {
+    auto timerThreadPool = TimerThreadPool(1);
+    auto config = SessionStoreConfig();
+    config.m_idleTimeout = milliseconds(1);
+    config.m_maintenanceInterval = milliseconds(1);
+    for(auto i = 0; i < 50; ++i) {
+      auto store = SessionStore<Session>(config, Initialize(),
+        Ref(timerThreadPool));
+      store.Create();
+      boost::this_thread::sleep(milliseconds(i % 3));
+    }
+  }
+
+  TEST_CASE("persistent_reload") {
+    auto dataStore = TestDataStore();
+    auto config = SessionStoreConfig();
+    config.m_idleTimeout = milliseconds(50);
+    auto store = SessionStore<Session, TestDataStore*>(config, &dataStore);
+    auto session = store.Create();
+    auto response = HttpResponse();
+    store.Persist(*session, Store(response));
+    REQUIRE(dataStore.m_stores[session->GetId()] == 1);
+    boost::this_thread::sleep(milliseconds(100));
+    auto reloaded = store.Find(MakeRequest(session->GetId()));
+    REQUIRE(reloaded != nullptr);
+    REQUIRE(reloaded != session);
+    REQUIRE(reloaded->GetId() == session->GetId());
+    REQUIRE(!session->IsExpired());
+    REQUIRE(dataStore.m_loadCount == 1);
+    REQUIRE(store.Find(MakeRequest(session->GetId())) == reloaded);
+    REQUIRE(dataStore.m_loadCount == 1);
+  }
+
+  TEST_CASE("coalesced_loads") {
+    auto dataStore = TestDataStore();
+    dataStore.m_stores["stored"] = 1;
+    auto store = SessionStore<Session, TestDataStore*>(SessionStoreConfig(),
+      &dataStore);
+    auto sessions = std::vector<std::shared_ptr<Session>>(20);
+    auto routines = RoutineHandlerGroup();
+    for(auto i = 0; i < static_cast<int>(sessions.size()); ++i) {
+      routines.Spawn([&, i] {
+        sessions[i] = store.Find(MakeRequest("stored"));
+      });
+    }
+    routines.Wait();
+    REQUIRE(dataStore.m_loadCount == 1);
+    REQUIRE(sessions.front() != nullptr);
+    for(auto& session : sessions) {
+      REQUIRE(session == sessions.front());
+    }
+  }
+
+  TEST_CASE("write_behind") {
+    auto timerThreadPool = TimerThreadPool(1);
+    auto dataStore = TestDataStore();
+    auto config = SessionStoreConfig();
+    config.m_maintenanceInterval = hours(1);
+    auto session = std::shared_ptr<Session>();
+    {
+      auto store = SessionStore<Session, TestDataStore*>(config, &dataStore,
+        Ref(timerThreadPool));
+      session = store.Create();
+      auto response = HttpResponse();
+      store.Persist(*session, Store(response));
+      store.Persist(*session, Store(response));
+      auto other = store.Create();
+      store.Persist(*other, Store(response));
+      REQUIRE(dataStore.m_stores.empty());
+      store.Flush();
+      REQUIRE(dataStore.m_transactionCount == 1);
+      REQUIRE(dataStore.m_stores[session->GetId()] == 1);
+      REQUIRE(dataStore.m_stores[other->GetId()] == 1);
+      store.End(*other);
+      REQUIRE(dataStore.m_deletes.empty());
+      REQUIRE(store.Find(MakeRequest(other->GetId())) == nullptr);
+      REQUIRE(dataStore.m_loadCount == 0);
+      store.Persist(*session, Store(response));
+    }
+    REQUIRE(dataStore.m_transactionCount == 2);
+    REQUIRE(dataStore.m_stores[session->GetId()] == 2);
+    REQUIRE(dataStore.m_deletes.size() == 1);
+  }
+
+  TEST_CASE("write_behind_snapshot") {
+    auto timerThreadPool = TimerThreadPool(1);
+    auto dataStore = TestValueDataStore();
+    auto config = SessionStoreConfig();
+    config.m_maintenanceInterval = hours(1);
+    auto store = SessionStore<TestSession, TestValueDataStore*>(config,
+      &dataStore, Ref(timerThreadPool));
+    auto session = store.Create();
+    auto response = HttpResponse();
+    session->SetValue(1);
+    store.Persist(*session, Store(response));
+    session->SetValue(2);
+    store.Flush();
+    REQUIRE(dataStore.m_values[session->GetId()] == 1);
+    store.Persist(*session, Store(response));
+    session->SetValue(3);
+    store.Flush();
+    REQUIRE(dataStore.m_values[session->GetId()] == 2);
+  }
+}
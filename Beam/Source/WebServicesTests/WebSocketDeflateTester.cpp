@@ -0,0 +1,270 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalServerConnection.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+#include "Beam/WebServices/HttpResponseParser.hpp"
+#include "Beam/WebServices/HttpServer.hpp"
+#include "Beam/WebServices/HttpServerPredicates.hpp"
+#include "Beam/WebServices/WebSocketChannel.hpp"
+#include "Beam/WebServices/WebSocketDeflate.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+using namespace Beam::WebServices;
+
+namespace {
+  using TestServerConnection = LocalServerConnection<SharedBuffer>;
+  using TestClientChannel = LocalClientChannel<SharedBuffer>;
+  using TestServer = HttpServer<TestServerConnection*>;
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string MakeUpdate(int sequence) {
+    return "{\"type\": \"book_quote\", \"symbol\": \"ABX.TSX\", "
+      "\"side\": \"BID\", \"price\": 12.3" + std::to_string(sequence % 10) +
+      ", \"size\": 100, \"mpid\": \"NSDQ\", \"sequence\": " +
+      std::to_string(sequence) + "}";
+  }
+
+  /** Reads a single frame sent by a server from a raw Channel. */
+  std::string ReadServerFrame(TestClientChannel& channel,
+      SharedBuffer& pending, std::uint8_t& code) {
+    while(true) {
+      auto header = reinterpret_cast<const unsigned char*>(pending.GetData());
+      if(pending.GetSize() >= 4 || (pending.GetSize() >= 2 &&
+          (header[1] & 0x7F) < 126)) {
+        auto headerLength = std::size_t(2);
+        auto payloadLength = std::size_t(header[1] & 0x7F);
+        if(payloadLength == 126) {
+          auto length = std::uint16_t();
+          std::memcpy(&length, header + 2, sizeof(length));
+          payloadLength = FromBigEndian(length);
+          headerLength += sizeof(length);
+        }
+        if(pending.GetSize() >= headerLength + payloadLength) {
+          code = header[0];
+          auto payload = std::string(pending.GetData() + headerLength,
+            payloadLength);
+          pending.ShrinkFront(headerLength + payloadLength);
+          return payload;
+        }
+      }
+      channel.GetReader().Read(Store(pending));
+    }
+  }
+
+  struct EchoFixture {
+    TestServerConnection m_serverConnection;
+    TestServer m_server;
+    std::vector<std::unique_ptr<RoutineHandler>> m_routines;
+
+    EchoFixture()
+        : m_server(&m_serverConnection, std::vector<HttpRequestSlot>(),
+            MakeWebSocketSlots(), MakeOptions()) {
+      m_server.Open();
+    }
+
+    ~EchoFixture() {
+      m_server.Close();
+    }
+
+    std::vector<TestServer::WebSocketSlot> MakeWebSocketSlots() {
+      auto slots = std::vector<TestServer::WebSocketSlot>();
+      slots.emplace_back(MatchAny(HttpMethod::GET),
+        [this] (const HttpRequest& request,
+            std::unique_ptr<TestServer::WebSocketChannel> channel) {
+          auto echo = std::shared_ptr<TestServer::WebSocketChannel>(
+            std::move(channel));
+          m_routines.push_back(std::make_unique<RoutineHandler>(Spawn(
+            [=] {
+              try {
+                while(true) {
+                  echo->GetWriter().Write(echo->GetSocket().Read());
+                }
+              } catch(const std::exception&) {}
+            })));
+        });
+      return slots;
+    }
+
+    static HttpServerOptions MakeOptions() {
+      auto options = HttpServerOptions();
+      options.m_loggingEnabled = false;
+      return options;
+    }
+  };
+}
+
+TEST_SUITE("WebSocketDeflate") {
+  TEST_CASE("negotiate") {
+    auto options = WebSocketDeflateOptions();
+    auto agreement = NegotiateDeflate(
+      "permessage-deflate; client_max_window_bits", options);
+    REQUIRE(agreement.is_initialized());
+    REQUIRE(MakeDeflateResponse(*agreement) == "permessage-deflate");
+    agreement = NegotiateDeflate("x-webkit-deflate-frame, "
+      "permessage-deflate; server_max_window_bits=8, "
+      "permessage-deflate; server_max_window_bits=\"10\"; "
+      "client_max_window_bits=12", options);
+    REQUIRE(agreement.is_initialized());
+    REQUIRE(agreement->m_serverMaxWindowBits == 10);
+    REQUIRE(agreement->m_clientMaxWindowBits == 12);
+    REQUIRE(MakeDeflateResponse(*agreement) == "permessage-deflate; "
+      "server_max_window_bits=10; client_max_window_bits=12");
+    agreement = NegotiateDeflate("permessage-deflate; "
+      "client_no_context_takeover", options);
+    REQUIRE(agreement.is_initialized());
+    REQUIRE(MakeDeflateResponse(*agreement) ==
+      "permessage-deflate; client_no_context_takeover");
+    REQUIRE(!NegotiateDeflate("permessage-deflate; level=9", options));
+    REQUIRE(!NegotiateDeflate("permessage-deflate; "
+      "server_no_context_takeover; server_no_context_takeover", options));
+    REQUIRE(!NegotiateDeflate("permessage-deflate; client_max_window_bits=16",
+      options));
+    REQUIRE(!NegotiateDeflate("x-webkit-deflate-frame", options));
+    options.m_compressionLevel = 0;
+    REQUIRE(!NegotiateDeflate("permessage-deflate", options));
+  }
+
+  TEST_CASE("parse_response") {
+    auto offer = WebSocketDeflateOptions();
+    REQUIRE(MakeDeflateOffer(offer) ==
+      "permessage-deflate; client_max_window_bits");
+    auto agreement = ParseDeflateResponse("permessage-deflate; "
+      "server_no_context_takeover; client_max_window_bits=10", offer);
+    REQUIRE(agreement.is_initialized());
+    REQUIRE(agreement->m_serverNoContextTakeover);
+    REQUIRE(!agreement->m_clientNoContextTakeover);
+    REQUIRE(agreement->m_clientMaxWindowBits == 10);
+    REQUIRE(!ParseDeflateResponse("x-custom", offer));
+    REQUIRE_THROWS_AS(ParseDeflateResponse("permessage-deflate; level=9",
+      offer), ConnectException);
+  }
+
+  TEST_CASE("context_takeover") {
+    auto deflater = WebSocketDeflater(1, 15, true);
+    auto inflater = WebSocketInflater(true);
+    auto previousSize = std::size_t(0);
+    for(auto i = 0; i < 10; ++i) {
+      auto message = MakeUpdate(i);
+      auto compressed = SharedBuffer();
+      deflater.Deflate(message.data(), message.size(), Store(compressed));
+      if(i == 0) {
+        previousSize = compressed.GetSize();
+      } else {
+        REQUIRE(compressed.GetSize() < previousSize / 2);
+      }
+
+      // Decompressing a byte at a time exercises messages split across
+      // frames and reads.
+      auto decompressed = SharedBuffer();
+      for(auto j = std::size_t(0); j < compressed.GetSize(); ++j) {
+        inflater.Inflate(compressed.GetData() + j, 1, Store(decompressed));
+      }
+      inflater.Finish(Store(decompressed));
+      REQUIRE(ToString(decompressed) == message);
+    }
+  }
+
+  TEST_CASE("no_context_takeover") {
+    auto deflater = WebSocketDeflater(1, 9, false);
+    auto inflater = WebSocketInflater(false);
+    auto sizes = std::vector<std::size_t>();
+    for(auto i = 0; i < 3; ++i) {
+      auto message = MakeUpdate(10);
+      auto compressed = SharedBuffer();
+      deflater.Deflate(message.data(), message.size(), Store(compressed));
+      sizes.push_back(compressed.GetSize());
+      auto decompressed = SharedBuffer();
+      inflater.Inflate(compressed.GetData(), compressed.GetSize(),
+        Store(decompressed));
+      inflater.Finish(Store(decompressed));
+      REQUIRE(ToString(decompressed) == message);
+    }
+    REQUIRE(sizes[0] == sizes[1]);
+    REQUIRE(sizes[1] == sizes[2]);
+  }
+
+  TEST_CASE_FIXTURE(EchoFixture, "server_upgrade") {
+    auto channel = TestClientChannel("client", Ref(m_serverConnection));
+    channel.GetConnection().Open();
+    channel.GetWriter().Write(BufferFromString<SharedBuffer>(
+      "GET / HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+      "Sec-WebSocket-Version: 13\r\n"
+      "Sec-WebSocket-Extensions: permessage-deflate; "
+      "client_max_window_bits\r\n\r\n"));
+    auto parser = HttpResponseParser();
+    auto buffer = SharedBuffer();
+    auto response = parser.GetNextResponse();
+    while(!response.is_initialized()) {
+      channel.GetReader().Read(Store(buffer));
+      parser.Feed(buffer.GetData(), buffer.GetSize());
+      buffer.Reset();
+      response = parser.GetNextResponse();
+    }
+    REQUIRE(response->GetStatusCode() == HttpStatusCode::SWITCHING_PROTOCOLS);
+    REQUIRE(*response->GetHeader("Sec-WebSocket-Extensions") ==
+      "permessage-deflate");
+    auto pending = parser.GetRemainingBuffer();
+    auto deflater = WebSocketDeflater(1, 15, true);
+    auto inflater = WebSocketInflater(true);
+    auto echoSizes = std::vector<std::size_t>();
+    for(auto i = 0; i < 2; ++i) {
+      auto message = MakeUpdate(i);
+      auto payload = SharedBuffer();
+      deflater.Deflate(message.data(), message.size(), Store(payload));
+      REQUIRE(payload.GetSize() < 126);
+      auto frame = SharedBuffer();
+      frame.Append(std::uint8_t(0xC1));
+      frame.Append(static_cast<std::uint8_t>(0x80 | payload.GetSize()));
+      frame.Append(std::uint32_t(0));
+      frame.Append(payload);
+      channel.GetWriter().Write(frame);
+      auto code = std::uint8_t();
+      auto echo = ReadServerFrame(channel, pending, code);
+      REQUIRE(code == 0xC1);
+      echoSizes.push_back(echo.size());
+      auto decompressed = SharedBuffer();
+      inflater.Inflate(echo.data(), echo.size(), Store(decompressed));
+      inflater.Finish(Store(decompressed));
+      REQUIRE(ToString(decompressed) == message);
+    }
+    REQUIRE(echoSizes[1] < echoSizes[0]);
+    channel.GetConnection().Close();
+  }
+
+  TEST_CASE_FIXTURE(EchoFixture, "echo") {
+    auto client = WebSocketChannel<std::unique_ptr<TestClientChannel>>(
+      WebSocketConfig().SetUri(Uri("ws://localhost/")).SetDeflate(
+        WebSocketDeflateOptions()),
+      [&] (const Uri& uri) {
+        return std::make_unique<TestClientChannel>("client",
+          Ref(m_serverConnection));
+      });
+    client.GetConnection().Open();
+    auto large = std::string();
+    while(large.size() < 300000) {
+      large += MakeUpdate(static_cast<int>(large.size()));
+    }
+    auto messages = std::vector<std::string>{MakeUpdate(1), MakeUpdate(2),
+      large, MakeUpdate(3)};
+    for(auto& message : messages) {
+      client.GetWriter().Write(message.data(), message.size());
+      REQUIRE(ToString(client.GetSocket().Read()) == message);
+    }
+    client.GetConnection().Close();
+  }
+}
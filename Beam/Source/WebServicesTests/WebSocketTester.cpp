@@ -0,0 +1,315 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "Beam/IO/LocalClientChannel.hpp"
+#include "Beam/IO/LocalServerConnection.hpp"
+#include "Beam/IO/SharedBuffer.hpp"
+#include "Beam/Routines/RoutineHandler.hpp"
+#include "Beam/WebServices/HttpRequestParser.hpp"
+#include "Beam/WebServices/HttpServer.hpp"
+#include "Beam/WebServices/HttpServerPredicates.hpp"
+#include "Beam/WebServices/WebSocketChannel.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Routines;
+using namespace Beam::WebServices;
+
+namespace {
+  using TestServerConnection = LocalServerConnection<SharedBuffer>;
+  using TestClientChannel = LocalClientChannel<SharedBuffer>;
+  using TestWebSocketChannel =
+    WebSocketChannel<std::unique_ptr<TestClientChannel>>;
+
+  std::string ToString(const SharedBuffer& buffer) {
+    return std::string(buffer.GetData(), buffer.GetSize());
+  }
+
+  std::string MakePayload(std::size_t size) {
+    auto payload = std::string();
+    for(auto i = std::size_t(0); i < size; ++i) {
+      payload += static_cast<char>('a' + (i * 31) % 26);
+    }
+    return payload;
+  }
+
+  SharedBuffer MakeFrameHeader(std::uint8_t code, std::uint64_t size) {
+    auto header = SharedBuffer();
+    header.Append(code);
+    if(size <= 125) {
+      header.Append(static_cast<std::uint8_t>(size));
+    } else if(size <= 0xFFFF) {
+      header.Append(std::uint8_t(126));
+      header.Append(ToBigEndian(static_cast<std::uint16_t>(size)));
+    } else {
+      header.Append(std::uint8_t(127));
+      header.Append(ToBigEndian(size));
+    }
+    return header;
+  }
+
+  SharedBuffer MakeFrame(std::uint8_t code, const std::string& payload) {
+    auto frame = MakeFrameHeader(code, payload.size());
+    frame.Append(payload.data(), payload.size());
+    return frame;
+  }
+
+  std::unique_ptr<TestWebSocketChannel> MakeClient(
+      TestServerConnection& serverConnection) {
+    auto channel = std::make_unique<TestWebSocketChannel>(
+      WebSocketConfig().SetUri(Uri("ws://localhost/")),
+      [&] (const Uri& uri) {
+        return std::make_unique<TestClientChannel>("client",
+          Ref(serverConnection));
+      });
+    channel->GetConnection().Open();
+    return channel;
+  }
+
+  /** Accepts a WebSocket handshake on a raw Channel. */
+  std::unique_ptr<TestServerConnection::Channel> AcceptWebSocket(
+      TestServerConnection& serverConnection) {
+    auto channel = serverConnection.Accept();
+    auto parser = HttpRequestParser();
+    auto buffer = SharedBuffer();
+    auto request = parser.GetNextRequest();
+    while(!request.is_initialized()) {
+      channel->GetReader().Read(Store(buffer));
+      parser.Feed(buffer.GetData(), buffer.GetSize());
+      buffer.Reset();
+      request = parser.GetNextRequest();
+    }
+    auto key = *request->GetHeader("Sec-WebSocket-Key");
+    auto acceptToken = Base64Encode(BufferFromString<SharedBuffer>(
+      WebServices::Details::ComputeShaDigest(
+      key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11")));
+    channel->GetWriter().Write(BufferFromString<SharedBuffer>(
+      "HTTP/1.1 101 Switching Protocols\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Accept: " + acceptToken + "\r\n\r\n"));
+    return channel;
+  }
+
+  /** Reads a single masked frame sent by a client from a raw Channel. */
+  std::string ReadClientFrame(TestServerConnection::Channel& channel,
+      SharedBuffer& pending, std::uint8_t& code) {
+    while(true) {
+      auto header = reinterpret_cast<const unsigned char*>(pending.GetData());
+      if(pending.GetSize() >= 2) {
+        auto lengthCode = header[1] & 0x7F;
+        auto headerLength = std::size_t(2 + sizeof(std::uint32_t));
+        if(lengthCode == 126) {
+          headerLength += sizeof(std::uint16_t);
+        } else if(lengthCode == 127) {
+          headerLength += sizeof(std::uint64_t);
+        }
+        if(pending.GetSize() >= headerLength) {
+          auto payloadLength = std::size_t(lengthCode);
+          if(lengthCode == 126) {
+            auto length = std::uint16_t();
+            std::memcpy(&length, header + 2, sizeof(length));
+            payloadLength = FromBigEndian(length);
+          } else if(lengthCode == 127) {
+            auto length = std::uint64_t();
+            std::memcpy(&length, header + 2, sizeof(length));
+            payloadLength = static_cast<std::size_t>(FromBigEndian(length));
+          }
+          if(pending.GetSize() >= headerLength + payloadLength) {
+            code = header[0];
+            auto key = header + headerLength - sizeof(std::uint32_t);
+            auto payload = std::string(pending.GetData() + headerLength,
+              payloadLength);
+            for(auto i = std::size_t(0); i < payload.size(); ++i) {
+              payload[i] ^= key[i % sizeof(std::uint32_t)];
+            }
+            pending.ShrinkFront(headerLength + payloadLength);
+            return payload;
+          }
+        }
+      }
+      channel.GetReader().Read(Store(pending));
+    }
+  }
+
+  struct EchoFixture {
+    TestServerConnection m_serverConnection;
+    HttpServer<TestServerConnection*> m_server;
+    std::vector<std::unique_ptr<RoutineHandler>> m_routines;
+
+    EchoFixture()
+        : m_server(&m_serverConnection, std::vector<HttpRequestSlot>(),
+            MakeWebSocketSlots(), MakeOptions()) {
+      m_server.Open();
+    }
+
+    ~EchoFixture() {
+      m_server.Close();
+    }
+
+    std::vector<HttpServer<TestServerConnection*>::WebSocketSlot>
+        MakeWebSocketSlots() {
+      auto slots =
+        std::vector<HttpServer<TestServerConnection*>::WebSocketSlot>();
+      slots.emplace_back(MatchAny(HttpMethod::GET),
+        [this] (const HttpRequest& request, auto channel) {
+          auto echo = std::shared_ptr<
+            HttpServer<TestServerConnection*>::WebSocketChannel>(
+            std::move(channel));
+          m_routines.push_back(std::make_unique<RoutineHandler>(Spawn(
+            [=] {
+              try {
+                while(true) {
+                  auto buffer = SharedBuffer();
+                  echo->GetReader().Read(Store(buffer));
+                  echo->GetWriter().Write(buffer);
+                }
+              } catch(const std::exception&) {}
+            })));
+        });
+      return slots;
+    }
+
+    static HttpServerOptions MakeOptions() {
+      auto options = HttpServerOptions();
+      options.m_loggingEnabled = false;
+      return options;
+    }
+  };
+}
+
+TEST_SUITE("WebSocket") {
+  TEST_CASE("mask_payload") {
+    auto maskingKey = std::uint32_t(0x9A3C5E71);
+    auto key = reinterpret_cast<const unsigned char*>(&maskingKey);
+    for(auto size = std::size_t(0); size < 40; ++size) {
+      for(auto offset = std::size_t(0); offset < 4; ++offset) {
+        auto source = MakePayload(size);
+        auto expected = source;
+        for(auto i = std::size_t(0); i < size; ++i) {
+          expected[i] ^= key[(offset + i) % 4];
+        }
+        auto masked = std::string(size, '\0');
+        WebServices::Details::MaskWebSocketPayload(source.data(), &masked[0],
+          size, maskingKey, offset);
+        REQUIRE(masked == expected);
+        WebServices::Details::MaskWebSocketPayload(&masked[0], &masked[0],
+          size, maskingKey, offset);
+        REQUIRE(masked == source);
+      }
+    }
+  }
+
+  TEST_CASE("fragmented_and_control_frames") {
+    auto serverConnection = TestServerConnection();
+    serverConnection.Open();
+    const auto LARGE_PAYLOAD_SIZE = std::size_t(100000);
+    const auto PIECE_SIZE = LARGE_PAYLOAD_SIZE / 4;
+    auto largePayload = MakePayload(LARGE_PAYLOAD_SIZE);
+    auto pongCode = std::uint8_t();
+    auto pong = std::string();
+    auto closeCode = std::uint8_t();
+    auto close = std::string();
+    auto server = RoutineHandler(Spawn([&] {
+      auto channel = AcceptWebSocket(serverConnection);
+      auto pending = SharedBuffer();
+      channel->GetWriter().Write(MakeFrame(0x01, "hello "));
+      channel->GetWriter().Write(MakeFrame(0x89, "ping"));
+      channel->GetWriter().Write(MakeFrame(0x80, "world"));
+      pong = ReadClientFrame(*channel, pending, pongCode);
+      channel->GetWriter().Write(MakeFrameHeader(0x82, LARGE_PAYLOAD_SIZE));
+      for(auto i = std::size_t(0); i < LARGE_PAYLOAD_SIZE; i += PIECE_SIZE) {
+        channel->GetWriter().Write(BufferFromString<SharedBuffer>(
+          largePayload.substr(i, PIECE_SIZE)));
+      }
+      channel->GetWriter().Write(MakeFrame(0x88, "\x03\xE8"));
+      close = ReadClientFrame(*channel, pending, closeCode);
+    }));
+    auto client = MakeClient(serverConnection);
+    REQUIRE(ToString(client->GetSocket().Read()) == "hello world");
+    auto received = SharedBuffer();
+    auto reads = 0;
+    while(received.GetSize() < LARGE_PAYLOAD_SIZE) {
+      auto size = client->GetReader().Read(Store(received));
+      REQUIRE(size <= PIECE_SIZE);
+      ++reads;
+    }
+    REQUIRE(reads >= 4);
+    REQUIRE(ToString(received) == largePayload);
+    REQUIRE_THROWS_AS(client->GetReader().Read(Store(received)),
+      EndOfFileException);
+    server.Wait();
+    REQUIRE(pongCode == 0x8A);
+    REQUIRE(pong == "ping");
+    REQUIRE(closeCode == 0x88);
+    REQUIRE(close == "\x03\xE8");
+  }
+
+  TEST_CASE("empty_frames") {
+    auto serverConnection = TestServerConnection();
+    serverConnection.Open();
+    auto server = RoutineHandler(Spawn([&] {
+      auto channel = AcceptWebSocket(serverConnection);
+      channel->GetWriter().Write(MakeFrame(0x81, ""));
+      channel->GetWriter().Write(MakeFrame(0x01, "ab"));
+      channel->GetWriter().Write(MakeFrame(0x80, ""));
+      channel->GetWriter().Write(MakeFrame(0x81, "cd"));
+      channel->GetWriter().Write(MakeFrame(0x01, ""));
+      channel->GetWriter().Write(MakeFrame(0x80, ""));
+      channel->GetWriter().Write(MakeFrame(0x81, "ef"));
+    }));
+    auto client = MakeClient(serverConnection);
+    REQUIRE(ToString(client->GetSocket().Read()) == "");
+    REQUIRE(ToString(client->GetSocket().Read()) == "ab");
+    REQUIRE(ToString(client->GetSocket().Read()) == "cd");
+    auto received = SharedBuffer();
+    REQUIRE(client->GetReader().Read(Store(received)) == 0);
+    REQUIRE(client->GetReader().Read(Store(received)) == 2);
+    REQUIRE(ToString(received) == "ef");
+    server.Wait();
+  }
+
+  TEST_CASE("frame_lengths") {
+    auto serverConnection = TestServerConnection();
+    serverConnection.Open();
+    auto sizes = std::vector<std::size_t>{0, 125, 126, 65535, 65536, 200000};
+    auto payloads = std::vector<std::string>();
+    auto server = RoutineHandler(Spawn([&] {
+      auto channel = AcceptWebSocket(serverConnection);
+      auto pending = SharedBuffer();
+      for(auto i = std::size_t(0); i < sizes.size(); ++i) {
+        auto code = std::uint8_t();
+        payloads.push_back(ReadClientFrame(*channel, pending, code));
+      }
+    }));
+    auto client = MakeClient(serverConnection);
+    for(auto size : sizes) {
+      auto payload = MakePayload(size);
+      client->GetWriter().Write(payload.data(), payload.size());
+    }
+    server.Wait();
+    REQUIRE(payloads.size() == sizes.size());
+    for(auto i = std::size_t(0); i < sizes.size(); ++i) {
+      REQUIRE(payloads[i] == MakePayload(sizes[i]));
+    }
+  }
+
+  TEST_CASE_FIXTURE(EchoFixture, "echo") {
+    auto client = MakeClient(m_serverConnection);
+    auto expected = std::string();
+    for(auto size : {5, 126, 65536, 300000}) {
+      auto payload = MakePayload(size);
+      client->GetWriter().Write(payload.data(), payload.size());
+      expected += payload;
+    }
+    auto received = SharedBuffer();
+    while(received.GetSize() < expected.size()) {
+      client->GetReader().Read(Store(received));
+    }
+    REQUIRE(ToString(received) == expected);
+    client->GetConnection().Close();
+  }
+}